@@ -9,16 +9,21 @@
 /// 1. At event handling loop, call `imgui_handle_event` for each SDL event.
 /// 2. Before acquiring the swapchain, call `imgui_new_frame` to start a new ImGui frame.
 /// 3. Create UI elements...
-/// 4. Create a command buffer
-/// 5. Call `imgui_upload_data` on the command buffer to upload ImGui data to the GPU.
-/// 6. During the final render pass, call `imgui_draw_to_renderpass` to render ImGui elements into the
+/// 4. Call `imgui_end_frame` to end the ImGui frame and capture its draw data.
+/// 5. Create a command buffer
+/// 6. Call `imgui_upload_data` on the command buffer to upload the captured data to the GPU.
+/// 7. During the final render pass, call `imgui_draw_to_renderpass` to render the captured data into the
 /// swapchain.
 ///
+/// Captured draw data is independent of later ImGui frames, so a frame may be rendered after the next ones
+/// have begun, with the UI of the logic tick it was built in.
+///
 
 #pragma once
 
 #include <SDL3/SDL_events.h>
 #include <imgui.h>
+#include <memory>
 
 #include "gpu/command-buffer.hpp"
 #include "gpu/render-pass.hpp"
@@ -26,6 +31,36 @@
 
 namespace backend
 {
+	///
+	/// @brief Draw data of an ended ImGui frame, owning copies of its draw lists
+	/// @note Textures are not copied, the draw data references the live texture list of the ImGui context,
+	/// whose pending updates are applied by whichever captured frame is uploaded first
+	///
+	class ImguiDrawData
+	{
+	  public:
+
+		ImguiDrawData() = default;
+		~ImguiDrawData() noexcept;
+
+		ImguiDrawData(const ImguiDrawData&) = delete;
+		ImguiDrawData(ImguiDrawData&& other) noexcept;
+		ImguiDrawData& operator=(const ImguiDrawData&) = delete;
+		ImguiDrawData& operator=(ImguiDrawData&& other) noexcept;
+
+		// Copy the draw data of the current ImGui frame, call after `ImGui::Render`
+		static ImguiDrawData capture() noexcept;
+
+		// Draw data, empty if nothing was captured
+		ImDrawData* get() const noexcept { return draw_data.get(); }
+
+	  private:
+
+		std::unique_ptr<ImDrawData> draw_data;
+
+		void release() noexcept;
+	};
+
 	///
 	/// @brief Initialize ImGui context
 	///
@@ -52,18 +87,31 @@ namespace backend
 	///
 	void imgui_new_frame() noexcept;
 
+	///
+	/// @brief End the ImGui frame and capture its draw data
+	/// @note Call this function once the UI elements of the frame are created.
+	///
+	/// @return Draw data of the frame
+	///
+	ImguiDrawData imgui_end_frame() noexcept;
+
 	///
 	/// @brief Upload ImGui data to the GPU
 	/// @note Call this function on a command buffer before rendering ImGui elements.
 	///
-	void imgui_upload_data(const gpu::CommandBuffer& command_buffer) noexcept;
+	/// @param draw_data Draw data captured by `imgui_end_frame`
+	///
+	void imgui_upload_data(const gpu::CommandBuffer& command_buffer, const ImguiDrawData& draw_data) noexcept;
 
 	///
 	/// @brief Render ImGui draw data into a render pass
 	/// @note Generally called during the final render pass to render ImGui elements into the swapchain.
 	///
+	/// @param draw_data Draw data uploaded by `imgui_upload_data`
+	///
 	void imgui_draw_to_renderpass(
 		const gpu::CommandBuffer& command_buffer,
-		const gpu::RenderPass& render_pass
+		const gpu::RenderPass& render_pass,
+		const ImguiDrawData& draw_data
 	) noexcept;
 }
\ No newline at end of file
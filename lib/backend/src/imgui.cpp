@@ -122,17 +122,65 @@ namespace backend
 		ImGui::NewFrame();
 	}
 
-	void imgui_upload_data(const gpu::CommandBuffer& command_buffer) noexcept
+	ImguiDrawData::~ImguiDrawData() noexcept
+	{
+		release();
+	}
+
+	ImguiDrawData::ImguiDrawData(ImguiDrawData&& other) noexcept :
+		draw_data(std::move(other.draw_data))
+	{}
+
+	ImguiDrawData& ImguiDrawData::operator=(ImguiDrawData&& other) noexcept
+	{
+		if (this == &other) return *this;
+
+		release();
+		draw_data = std::move(other.draw_data);
+
+		return *this;
+	}
+
+	ImguiDrawData ImguiDrawData::capture() noexcept
+	{
+		const ImDrawData* const source = ImGui::GetDrawData();
+		if (source == nullptr || !source->Valid) return {};
+
+		// Draw lists are reused by the next frame, the copy keeps their output only
+		ImguiDrawData result;
+		result.draw_data = std::make_unique<ImDrawData>(*source);
+		for (auto& draw_list : result.draw_data->CmdLists) draw_list = draw_list->CloneOutput();
+
+		return result;
+	}
+
+	void ImguiDrawData::release() noexcept
+	{
+		if (draw_data == nullptr) return;
+
+		for (auto* const draw_list : draw_data->CmdLists) IM_DELETE(draw_list);
+		draw_data.reset();
+	}
+
+	ImguiDrawData imgui_end_frame() noexcept
 	{
 		ImGui::Render();
-		ImGui_ImplSDLGPU3_PrepareDrawData(ImGui::GetDrawData(), command_buffer);
+		return ImguiDrawData::capture();
+	}
+
+	void imgui_upload_data(const gpu::CommandBuffer& command_buffer, const ImguiDrawData& draw_data) noexcept
+	{
+		if (draw_data.get() == nullptr) return;
+		ImGui_ImplSDLGPU3_PrepareDrawData(draw_data.get(), command_buffer);
 	}
 
 	void imgui_draw_to_renderpass(
 		const gpu::CommandBuffer& command_buffer,
-		const gpu::RenderPass& render_pass
+		const gpu::RenderPass& render_pass,
+		const ImguiDrawData& draw_data
 	) noexcept
 	{
-		ImGui_ImplSDLGPU3_RenderDrawData(ImGui::GetDrawData(), command_buffer, render_pass);
+		if (draw_data.get() == nullptr) return;
+		ImGui_ImplSDLGPU3_RenderDrawData(draw_data.get(), command_buffer, render_pass);
 	}
 }
\ No newline at end of file
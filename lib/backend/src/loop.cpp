@@ -45,6 +45,7 @@ namespace backend
 
 		backend::imgui_new_frame();
 		should_continue &= (loop_fn == nullptr ? true : loop_fn());
+		const auto imgui_draw_data = backend::imgui_end_frame();
 
 		/* Acquire Swapchain */
 
@@ -57,7 +58,7 @@ namespace backend
 
 		/* Upload ImGui Data */
 
-		backend::imgui_upload_data(*command_buffer);
+		backend::imgui_upload_data(*command_buffer, imgui_draw_data);
 
 		/* Render Custom Logic */
 
@@ -73,8 +74,8 @@ namespace backend
 		const auto render_imgui_result = command_buffer->run_render_pass(
 			{&swapchain_info, 1},
 			{},
-			[&command_buffer](const gpu::RenderPass& render_pass) {
-				backend::imgui_draw_to_renderpass(*command_buffer, render_pass);
+			[&command_buffer, &imgui_draw_data](const gpu::RenderPass& render_pass) {
+				backend::imgui_draw_to_renderpass(*command_buffer, render_pass, imgui_draw_data);
 			}
 		);
 		if (!render_imgui_result) return render_imgui_result.error().forward("Render ImGui failed");
@@ -0,0 +1,101 @@
+///
+/// @file animation-clip.hpp
+/// @brief Provides compressed animation clips, with resampled, key-reduced and quantized tracks
+///
+
+#pragma once
+
+#include "detail/animation/channel-def.hpp"
+#include "gltf/node.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace gltf
+{
+	///
+	/// @brief Compressed animation clip, evaluating all of its tracks in one pass
+	/// @details
+	/// - Every channel is resampled at a fixed rate over the clip duration, then keys that linear
+	/// interpolation of their neighbours reproduces are removed, within a positional error bound.
+	/// - Rotations are quantized with smallest-three in 48 bits, translations and scales are range-reduced to
+	/// 16 bits per component. A key takes 6 bytes, plus a 2-byte frame index.
+	/// - The clip is cut into segments of `segment_frames` frames. Keys are reduced per segment, and the keys
+	/// of every track in a segment are stored back to back, so evaluating a pose reads one contiguous block.
+	///
+	class AnimationClip
+	{
+	  public:
+
+		struct Config
+		{
+			float sample_rate = 30.0f;         // Resampling rate in Hz
+			float max_position_error = 1e-3f;  // Error bound of points at the end of the joint chains
+			float min_reach = 0.1f;            // Reach assumed for nodes with nothing attached
+		};
+
+		///
+		/// @brief Compress animation channels into a clip
+		/// @details Errors are measured in the parent space of the animated node: translation errors
+		/// directly, rotation and scale errors as the displacement of a point at `node_reach` from the
+		/// node origin. The error at every resampled frame, quantization included, stays under
+		/// `config.max_position_error`, unless quantization alone exceeds it. Between frames, detail finer
+		/// than the sample rate is lost.
+		/// @note STEP channels keep their steps, but steps are moved onto the resampled frames
+		///
+		/// @param channels Channels of the animation, later channels override earlier ones on the same target
+		/// @param node_reach For every node, distance from its origin to the farthest point of its subtree at
+		/// rest, measured in its parent space
+		/// @param config Compression config
+		/// @return Compressed clip
+		///
+		static AnimationClip compress(
+			std::span<const std::unique_ptr<detail::animation::Channel>> channels,
+			std::span<const float> node_reach,
+			const Config& config
+		) noexcept;
+
+		///
+		/// @brief Apply the clip at the given time to node transform overrides
+		///
+		/// @param overrides Node transform overrides
+		/// @param time Absolute timestamp, clamped to the clip duration
+		///
+		void apply(std::span<Node::TransformOverride> overrides, float time) const noexcept;
+
+		///
+		/// @brief Get indices of all nodes animated by this clip
+		///
+		/// @return Node indices, may contain duplicates
+		///
+		std::vector<uint32_t> get_target_nodes() const noexcept;
+
+		// Get the memory used by tracks and keys, in bytes
+		size_t get_byte_size() const noexcept;
+
+	  private:
+
+		struct Track
+		{
+			uint32_t target_node;
+			detail::animation::TargetPath path;
+			bool step;
+			glm::vec3 range_min;   // Dequantization of translations and scales, unused for rotations
+			glm::vec3 range_step;  // Dequantization of translations and scales, unused for rotations
+		};
+
+		// Frames per segment, consecutive segments share their boundary frame
+		static constexpr uint32_t segment_frames = 64;
+
+		float start_time = 0;
+		float frame_rate = 0;  // Resampled frames per second, 0 for single-frame clips
+		uint32_t frame_count = 0;
+		uint32_t segment_count = 0;
+
+		std::vector<Track> tracks;
+		std::vector<uint32_t> segment_offsets;  // Offset of each segment in `keys`
+		std::vector<uint16_t> keys;             // Keys of every track, segment by segment
+	};
+}
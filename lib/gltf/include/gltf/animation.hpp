@@ -1,11 +1,13 @@
 #pragma once
 
 #include "detail/animation/channel-def.hpp"
+#include "gltf/animation-clip.hpp"
 #include "gltf/node.hpp"
 #include "util/error.hpp"
 
 #include <expected>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -42,6 +44,22 @@ namespace gltf
 		///
 		void apply(std::span<Node::TransformOverride> overrides, float time) const noexcept;
 
+		///
+		/// @brief Compress the channels into an `AnimationClip`, which replaces them from then on
+		/// @details The raw channels are released, see `AnimationClip::compress` for the error bound
+		///
+		/// @param node_reach Reach of every node of the model, see `AnimationClip::compress`
+		/// @param config Compression config
+		///
+		void compress(std::span<const float> node_reach, const AnimationClip::Config& config) noexcept;
+
+		///
+		/// @brief Get indices of all nodes animated by this animation
+		///
+		/// @return Node indices, may contain duplicates
+		///
+		std::vector<uint32_t> get_target_nodes() const noexcept;
+
 		// Name of the animation, can be none
 		std::optional<std::string> name;
 
@@ -49,6 +67,9 @@ namespace gltf
 
 		std::vector<std::unique_ptr<detail::animation::Channel>> channels;
 
+		// Compressed clip, replaces `channels` once set
+		std::optional<AnimationClip> clip;
+
 		Animation(
 			std::optional<std::string> name,
 			std::vector<std::unique_ptr<detail::animation::Channel>> channels
@@ -0,0 +1,77 @@
+///
+/// @file dedup.hpp
+/// @brief Provides content-hash deduplication of glTF images, meshes and samplers
+///
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tiny_gltf.h>
+#include <vector>
+
+namespace gltf
+{
+	// Summary of a deduplication pass
+	struct DedupSummary
+	{
+		uint32_t duplicates = 0;  // Number of elements collapsed into another
+		size_t saved_bytes = 0;   // Source bytes no longer processed or uploaded
+	};
+
+	///
+	/// @brief Deduplication result of a list of glTF elements
+	/// @details Every element maps to the first element with identical content. Canonical elements map to
+	/// themselves, so original indices stay valid and duplicates can simply be skipped when loading.
+	///
+	struct DedupMap
+	{
+		std::vector<uint32_t> remap;  // Canonical index of each element
+		DedupSummary summary;
+
+		bool is_canonical(uint32_t index) const noexcept { return remap[index] == index; }
+
+		///
+		/// @brief Get the index of each element in a list holding only canonical elements
+		/// @details Canonical elements keep their relative order, duplicates map to the compacted index of
+		/// their canonical element.
+		///
+		/// @return Compacted index of each element
+		///
+		std::vector<uint32_t> compact_remap() const noexcept;
+
+		// Get the indices of canonical elements in order, the source of each element of a compacted list
+		std::vector<uint32_t> canonical_indices() const noexcept;
+	};
+
+	///
+	/// @brief Find identical images
+	/// @details Images are hashed over decoded pixels and pixel format, and confirmed by comparing pixels.
+	/// Saved bytes count the decoded pixel data of duplicates.
+	///
+	/// @param model Tinygltf model
+	/// @return Deduplication map over `model.images`
+	///
+	DedupMap dedup_images(const tinygltf::Model& model) noexcept;
+
+	///
+	/// @brief Find meshes with identical primitives
+	/// @details
+	/// - Meshes are hashed over the content of every accessor their primitives read (not the accessor
+	/// indices), together with primitive mode, material and attribute names.
+	/// - Meshes with morph targets, sparse or invalid accessors are never merged.
+	/// - Saved bytes count the accessor data of duplicates.
+	///
+	/// @param model Tinygltf model
+	/// @return Deduplication map over `model.meshes`
+	///
+	DedupMap dedup_meshes(const tinygltf::Model& model) noexcept;
+
+	///
+	/// @brief Find samplers with identical descriptors (filters and wrap modes)
+	///
+	/// @param model Tinygltf model
+	/// @return Deduplication map over `model.samplers`
+	///
+	DedupMap dedup_samplers(const tinygltf::Model& model) noexcept;
+}
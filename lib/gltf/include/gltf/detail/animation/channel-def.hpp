@@ -3,9 +3,18 @@
 #include "gltf/node.hpp"
 
 #include <span>
+#include <utility>
 
 namespace gltf::detail::animation
 {
+	// Transform component animated by a channel
+	enum class TargetPath
+	{
+		Translation,
+		Rotation,
+		Scale
+	};
+
 	// General interface for animation channels
 	class Channel
 	{
@@ -20,5 +29,17 @@ namespace gltf::detail::animation
 		/// @param time Absolute timestamp
 		///
 		virtual void apply(std::span<Node::TransformOverride> overrides, float time) const noexcept = 0;
+
+		// Get index of the node animated by this channel
+		virtual uint32_t get_target_node() const noexcept = 0;
+
+		// Get the transform component animated by this channel
+		virtual TargetPath get_target_path() const noexcept = 0;
+
+		// Tell if the channel holds its value between keyframes (STEP interpolation)
+		virtual bool is_step() const noexcept = 0;
+
+		// Get timestamps of the first and last keyframes
+		virtual std::pair<float, float> get_time_range() const noexcept = 0;
 	};
 }
\ No newline at end of file
@@ -19,6 +19,14 @@ namespace gltf::detail::animation
 		{}
 
 		void apply(std::span<Node::TransformOverride> overrides, float time) const noexcept override;
+
+		uint32_t get_target_node() const noexcept override { return target_node; }
+
+		TargetPath get_target_path() const noexcept override { return TargetPath::Translation; }
+
+		bool is_step() const noexcept override { return sampler.get_interpolation() == Interpolation::Step; }
+
+		std::pair<float, float> get_time_range() const noexcept override { return sampler.get_time_range(); }
 	};
 
 	class RotationChannel : public Channel
@@ -35,6 +43,14 @@ namespace gltf::detail::animation
 		{}
 
 		void apply(std::span<Node::TransformOverride> overrides, float time) const noexcept override;
+
+		uint32_t get_target_node() const noexcept override { return target_node; }
+
+		TargetPath get_target_path() const noexcept override { return TargetPath::Rotation; }
+
+		bool is_step() const noexcept override { return sampler.get_interpolation() == Interpolation::Step; }
+
+		std::pair<float, float> get_time_range() const noexcept override { return sampler.get_time_range(); }
 	};
 
 	class ScaleChannel : public Channel
@@ -51,5 +67,13 @@ namespace gltf::detail::animation
 		{}
 
 		void apply(std::span<Node::TransformOverride> overrides, float time) const noexcept override;
+
+		uint32_t get_target_node() const noexcept override { return target_node; }
+
+		TargetPath get_target_path() const noexcept override { return TargetPath::Scale; }
+
+		bool is_step() const noexcept override { return sampler.get_interpolation() == Interpolation::Step; }
+
+		std::pair<float, float> get_time_range() const noexcept override { return sampler.get_time_range(); }
 	};
 }
\ No newline at end of file
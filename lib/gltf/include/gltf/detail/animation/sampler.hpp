@@ -70,6 +70,20 @@ namespace gltf::detail::animation
 
 		T operator[](float time) const noexcept;
 
+		// Get the interpolation method
+		Interpolation get_interpolation() const noexcept { return interpolation; }
+
+		// Get timestamps of the first and last keyframes
+		std::pair<float, float> get_time_range() const noexcept
+		{
+			return std::visit(
+				[](const auto& keyframe_vec) {
+					return std::make_pair(keyframe_vec.front().first, keyframe_vec.back().first);
+				},
+				keyframes
+			);
+		}
+
 		Sampler(const Sampler&) = delete;
 		Sampler(Sampler&&) = default;
 		Sampler& operator=(const Sampler&) = delete;
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "graphics/occlusion.hpp"
+
+#include <algorithm>
 #include <concepts>
 #include <cstdint>
 #include <glm/glm.hpp>
@@ -88,4 +91,81 @@ namespace gltf::detail::mesh
 
 		return {std::move(remapped_vertices), std::move(remapped_indices)};
 	}
-}
\ No newline at end of file
+
+	///
+	/// @brief Generate a simplified position-only mesh for software occlusion culling
+	/// @details Vertices are welded by position first, so attribute seams don't block simplification.
+	/// Mesh borders are locked, a simplified occluder must not grow past the silhouette of the original.
+	///
+	/// @param vertices Input vertex list
+	/// @param indices Input index list
+	/// @param max_triangles Maximum triangle count of the result
+	/// @param max_error Maximum simplification error, relative to the mesh extent
+	/// @return Occluder mesh, empty if the mesh can't be simplified within the limits
+	///
+	template <Vertex_type T>
+	graphics::OccluderMesh simplify_occluder(
+		const std::vector<T>& vertices,
+		const std::vector<uint32_t>& indices,
+		size_t max_triangles,
+		float max_error
+	) noexcept
+	{
+		if (vertices.empty() || indices.size() < 3) return {};
+
+		std::vector<glm::vec3> positions(vertices.size());
+		std::ranges::transform(vertices, positions.begin(), [](const T& vertex) { return vertex.position; });
+
+		std::vector<uint32_t> remap_table(positions.size());
+		const auto welded_count = meshopt_generateVertexRemap(
+			remap_table.data(),
+			indices.data(),
+			indices.size(),
+			positions.data(),
+			positions.size(),
+			sizeof(glm::vec3)
+		);
+
+		std::vector<glm::vec3> welded_positions(welded_count);
+		std::vector<uint32_t> welded_indices(indices.size());
+		meshopt_remapVertexBuffer(
+			welded_positions.data(),
+			positions.data(),
+			positions.size(),
+			sizeof(glm::vec3),
+			remap_table.data()
+		);
+		meshopt_remapIndexBuffer(welded_indices.data(), indices.data(), indices.size(), remap_table.data());
+
+		std::vector<uint32_t> simplified_indices(welded_indices.size());
+		const auto simplified_count = meshopt_simplify(
+			simplified_indices.data(),
+			welded_indices.data(),
+			welded_indices.size(),
+			&welded_positions[0].x,
+			welded_positions.size(),
+			sizeof(glm::vec3),
+			std::min(welded_indices.size(), max_triangles * 3),
+			max_error,
+			meshopt_SimplifyLockBorder,
+			nullptr
+		);
+
+		if (simplified_count == 0 || simplified_count > max_triangles * 3) return {};
+		simplified_indices.resize(simplified_count);
+
+		// Drop vertices no longer referenced
+		std::vector<glm::vec3> occluder_positions(welded_positions.size());
+		const auto used_count = meshopt_optimizeVertexFetch(
+			occluder_positions.data(),
+			simplified_indices.data(),
+			simplified_indices.size(),
+			welded_positions.data(),
+			welded_positions.size(),
+			sizeof(glm::vec3)
+		);
+		occluder_positions.resize(used_count);
+
+		return {.vertices = std::move(occluder_positions), .indices = std::move(simplified_indices)};
+	}
+}
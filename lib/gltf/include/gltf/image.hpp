@@ -7,8 +7,11 @@
 #pragma once
 
 #include "gpu/texture.hpp"
+#include "image/compress.hpp"
+#include "image/repr.hpp"
 #include <glm/glm.hpp>
 #include <tiny_gltf.h>
+#include <variant>
 
 namespace gltf
 {
@@ -18,6 +21,21 @@ namespace gltf
 		RGBA8_raw,  // Load 8bit and 16bit Image as-is
 		RGBA8_BC3,  // Compress to BC3 in addition to `RGBA8_raw`
 		RGBA8_BC7,  // Compress to BC7 in addition to `RGBA8_raw`
+		RGB8_BC1,   // Compress to BC1, alpha is dropped and sampled as 1
+		R8_BC4,     // Compress R channel to BC4, sampled as `(r, 0, 0, 1)`. Always linear
+		RG8_BC5,    // Compress R and G channels to BC5, sampled as `(r, g, 0, 1)`. Always linear
+	};
+
+	///
+	/// @brief Compress mode picked by `select_color_compress_mode`
+	///
+	struct ColorCompressSelection
+	{
+		ColorCompressMode mode;
+
+		// Base level compressed with `mode` while evaluating it, reused when creating the texture. Empty
+		// for modes that were not evaluated, i.e. the fallback mode.
+		std::variant<std::monostate, image::BCImage, image::BCImage4bpp> base_level = std::monostate();
 	};
 
 	// Compress mode for 2-channel normal map textures
@@ -30,9 +48,10 @@ namespace gltf
 
 	///
 	/// @brief Create a color texture from a glTF image
-	/// @details The process compresses and mipmaps the image using the given config at best effort. If
-	/// compression/mipmapping is not possible due to NPOT/Non-BC-Compatible dimensions, the
-	/// compression/mipmapping steps will be skipped.
+	/// @details The process compresses and mipmaps the image using the given config. Images of any size
+	/// get a mip chain, NPOT levels are filtered with a polyphase filter and levels that are not a multiple
+	/// of 4 are edge-padded before block compression. Block-compressed chains end before any dimension
+	/// drops below one 4x4 block, uncompressed chains go down to 1x1.
 	///
 	/// @param image Image data
 	/// @param compress_mode Compression mode
@@ -47,11 +66,87 @@ namespace gltf
 		const std::string& name
 	) noexcept;
 
+	///
+	/// @brief Create a color texture from an already decoded RGBA8 image
+	/// @details Same as the `tinygltf::Image` overload, for images synthesized on CPU (e.g. packed ORM)
+	///
+	/// @param image Image data
+	/// @param compress_mode Compression mode
+	/// @param srgb Whether to use sRGB format
+	/// @return Created GPU texture or error
+	///
+	std::expected<gpu::Texture, util::Error> create_color_texture_from_image(
+		SDL_GPUDevice* device,
+		const image::Image<image::Precision::U8, image::Format::RGBA>& image,
+		ColorCompressMode compress_mode,
+		bool srgb,
+		const std::string& name
+	) noexcept;
+
+	///
+	/// @brief Create a color texture from an already decoded RGBA8 image, with a selected compress mode
+	/// @details The base level encoded during selection is uploaded as is, only lower levels are compressed
+	///
+	/// @param image Image data, the one `selection` was made for
+	/// @param selection Compress mode selected by `select_color_compress_mode`
+	/// @param srgb Whether to use sRGB format, ignored by the always linear `R8_BC4` and `RG8_BC5`
+	/// @return Created GPU texture or error
+	///
+	std::expected<gpu::Texture, util::Error> create_color_texture_from_image(
+		SDL_GPUDevice* device,
+		const image::Image<image::Precision::U8, image::Format::RGBA>& image,
+		ColorCompressSelection selection,
+		bool srgb,
+		const std::string& name
+	) noexcept;
+
+	///
+	/// @brief Pick the cheapest compress mode for a color/linear image, given which channels are read
+	/// @details Candidates are tried from the cheapest, using the channel analysis of the image:
+	/// - `R8_BC4` (linear only) when alpha is unread or opaque, and either G and B are unread or the image
+	/// is grayscale. Shaders broadcast R of such textures to RGB, see `MaterialParams::Factor`.
+	/// - `RGB8_BC1` when alpha is unread or opaque.
+	/// - `RG8_BC5` (linear only) when alpha is unread or opaque, and B is unread or constantly 0. It has
+	/// the size of the fallback modes but keeps two channels at single-channel quality.
+	///
+	/// A candidate is picked only if the PSNR of its decoded base level over the read channels reaches
+	/// `min_psnr`. Falls back to `fallback_mode` otherwise, `RGBA8_raw` is never replaced.
+	///
+	/// @param image Image data
+	/// @param used_channels Channels read by shaders
+	/// @param srgb Whether the texture is sampled as sRGB, which BC4 and BC5 do not support
+	/// @param fallback_mode Compress mode used when no cheaper candidate qualifies
+	/// @param min_psnr Minimum PSNR in dB
+	/// @return Selected compress mode with its encoded base level, or error
+	///
+	std::expected<ColorCompressSelection, util::Error> select_color_compress_mode(
+		const image::Image<image::Precision::U8, image::Format::RGBA>& image,
+		glm::bvec4 used_channels,
+		bool srgb,
+		ColorCompressMode fallback_mode,
+		float min_psnr
+	) noexcept;
+
+	///
+	/// @brief Pack an occlusion and a metallic-roughness image into one ORM image
+	/// @details Output channels are R = occlusion, G = roughness, B = metallic and A = 255, so shaders can
+	/// fetch all three with one sample. Both images must have the same size.
+	///
+	/// @param occlusion Occlusion image, R channel is used
+	/// @param metallic_roughness Metallic-roughness image, G and B channels are used
+	/// @return Packed image, or error if extraction fails or sizes mismatch
+	///
+	std::expected<image::Image<image::Precision::U8, image::Format::RGBA>, util::Error> pack_orm_image(
+		const tinygltf::Image& occlusion,
+		const tinygltf::Image& metallic_roughness
+	) noexcept;
+
 	///
 	/// @brief Create a normal texture from a glTF image
-	/// @details The process compresses and mipmaps the image using the given config at best effort. If
-	/// compression/mipmapping is not possible due to NPOT/Non-BC-Compatible dimensions, the
-	/// compression/mipmapping steps will be skipped.
+	/// @details The process compresses and mipmaps the image using the given config. Images of any size
+	/// get a mip chain, NPOT levels are filtered with a polyphase filter and levels that are not a multiple
+	/// of 4 are edge-padded before block compression. Block-compressed chains end before any dimension
+	/// drops below one 4x4 block, uncompressed chains go down to 1x1.
 	///
 	/// @param image Image data
 	/// @param compress_mode Compression mode
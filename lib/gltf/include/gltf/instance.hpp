@@ -0,0 +1,120 @@
+///
+/// @file instance.hpp
+/// @brief Provides instance records for batched model evaluation, and the per-instance data of instanced
+/// drawcalls
+///
+
+#pragma once
+
+#include "gltf/animation.hpp"
+#include "gpu/buffer.hpp"
+#include "gpu/copy-pass.hpp"
+#include "graphics/util/buffer-pool.hpp"
+#include "util/error.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace gltf
+{
+	// One instance of a model, see `Model::generate_instanced_drawdata`
+	struct InstanceRecord
+	{
+		glm::mat4 model_transform = glm::mat4(1.0f);
+		std::span<const AnimationKey> animation;                       // Animation keys to apply
+		std::span<const std::pair<uint32_t, float>> emission_overrides;  // (node_index, multiplier)
+		std::span<const uint32_t> hidden_nodes;                          // Node indices to hide
+	};
+
+	///
+	/// @brief Per-instance data of an instanced drawcall
+	/// @details Matches the `Instance` struct of `instance.glsl`, in std430 layout
+	///
+	struct InstanceData
+	{
+		glm::mat4 transform;    // `Model->World` transform, unused for rigged primitives
+		uint32_t joint_offset;  // First joint of the skin in the joint palette, unused otherwise
+		uint32_t padding[3];
+	};
+
+	static_assert(sizeof(InstanceData) == 80, "InstanceData must match the std430 layout of `Instance`");
+
+	// Instances of a node sharing an emissive multiplier, drawn by one instanced drawcall per primitive
+	struct InstanceGroup
+	{
+		float emissive_multiplier;
+		uint32_t first;  // First instance in the instance index list
+		uint32_t count;
+	};
+
+	///
+	/// @brief Group the instances showing a node by emissive multiplier
+	/// @details Groups are in ascending multiplier order, and instances of a group in ascending index order.
+	/// Rigged nodes ignore emission overrides, as single drawcalls do, and form a single group.
+	///
+	/// @param visible Visibility of the node, one per instance
+	/// @param emission_values Emissive multiplier of the node, one per instance
+	/// @param rigged Whether the node is rigged
+	/// @param instance_indices Output, indices of the visible instances, group by group
+	/// @param groups Output, groups referencing `instance_indices`
+	///
+	void group_node_instances(
+		std::span<const uint8_t> visible,
+		std::span<const float> emission_values,
+		bool rigged,
+		std::vector<uint32_t>& instance_indices,
+		std::vector<InstanceGroup>& groups
+	) noexcept;
+
+	///
+	/// @brief Deferred Instance Resource
+	/// @details
+	/// - Holds the per-instance data of every instanced drawcall of a drawdata. The external renderer and
+	/// the drawdata unit share this resource
+	/// - Responsible for preparing and uploading the GPU buffer read by instanced pipelines
+	///
+	struct DeferredInstanceResource
+	{
+		std::vector<InstanceData> instances;
+
+		// Initialize at render time, see `prepare_gpu_buffers`
+		std::shared_ptr<gpu::TransferBuffer> upload_buffer = nullptr;
+
+		// Initialize at render time, see `prepare_gpu_buffers`
+		std::shared_ptr<gpu::Buffer> instance_buffer = nullptr;
+
+		explicit DeferredInstanceResource(std::vector<InstanceData> instances) :
+			instances(std::move(instances))
+		{}
+
+		///
+		/// @brief Acquire GPU buffers for the instance data, and copy it into the upload buffer
+		///
+		/// @param buffer_pool Buffer Pool
+		/// @param transfer_pool Transfer Buffer Pool
+		/// @return Void on success, or error on failure
+		///
+		std::expected<void, util::Error> prepare_gpu_buffers(
+			graphics::BufferPool& buffer_pool,
+			graphics::TransferBufferPool& transfer_pool
+		) noexcept;
+
+		///
+		/// @brief Upload GPU buffers
+		///
+		/// @param copy_pass Copy Pass
+		///
+		void upload_gpu_buffers(const gpu::CopyPass& copy_pass) noexcept;
+
+		// Size of the instance data in bytes
+		uint32_t get_buffer_size() const noexcept
+		{
+			return uint32_t(instances.size() * sizeof(InstanceData));
+		}
+	};
+}
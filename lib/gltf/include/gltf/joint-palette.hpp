@@ -0,0 +1,53 @@
+///
+/// @file joint-palette.hpp
+/// @brief Provides joint palette encodings for GPU skinning, and batch kernels writing them
+///
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <span>
+
+namespace gltf
+{
+	///
+	/// @brief Encoding of the joint matrices uploaded for skinning
+	/// @details Values match the `JOINT_PALETTE_*` constants of `joint-palette.glsl`
+	///
+	enum class JointPalette : uint32_t
+	{
+		Matrix = 0,          // Full `mat4`, 64 bytes per joint
+		Affine = 1,          // Upper 3 rows as `vec4`s, 48 bytes per joint, exact for affine joints
+		Dual_quaternion = 2  // Real and dual quaternions, 32 bytes per joint, rotation and uniform scale
+	};
+
+	///
+	/// @brief Get the size of one joint in a palette
+	///
+	/// @param palette Palette encoding
+	/// @return Size in bytes, a multiple of 16
+	///
+	size_t get_joint_palette_stride(JointPalette palette) noexcept;
+
+	///
+	/// @brief Compute `joint_world * inverse_bind` for every joint, and write it in the palette encoding
+	/// @details
+	/// - Matrix products run on AVX2, two result columns at a time, then are stored without any
+	/// intermediate buffer, so `output` can be a mapped transfer buffer.
+	/// - The dual quaternion encoding stores the uniform scale as the squared norm of the real part. Shear
+	/// and non-uniform scale are lost, the scale is averaged over the three axes.
+	///
+	/// @param palette Palette encoding
+	/// @param joint_world_matrices World matrix of each joint
+	/// @param inverse_bind_matrices Inverse bind matrix of each joint
+	/// @param output Output, at least `joint count * get_joint_palette_stride(palette)` bytes
+	///
+	void encode_joint_palette(
+		JointPalette palette,
+		std::span<const glm::mat4> joint_world_matrices,
+		std::span<const glm::mat4> inverse_bind_matrices,
+		std::span<std::byte> output
+	) noexcept;
+}
@@ -13,6 +13,7 @@
 #include <tiny_gltf.h>
 
 #include "gpu/sampler.hpp"
+#include "dedup.hpp"
 #include "gpu/texture.hpp"
 #include "image.hpp"
 #include "sampler.hpp"
@@ -55,6 +56,12 @@ namespace gltf
 			float normal_scale = 1.0f;
 			float alpha_cutoff = 1.0f;
 			float occlusion_strength = 1.0f;
+
+			// Occlusion is stored in R of the metallic-roughness texture (ORM layout), sample it once
+			bool orm_packed = false;
+
+			// Metallic-roughness texture holds grayscale data in R only (BC4), broadcast R to all channels
+			bool metallic_roughness_single_channel = false;
 		};
 
 		Factor factor = {};
@@ -66,6 +73,9 @@ namespace gltf
 	{
 		std::optional<uint32_t> base_color, metallic_roughness, normal, occlusion, emissive;
 
+		// Index to a packed ORM texture replacing `metallic_roughness` and `occlusion`, set by `MaterialList`
+		std::optional<uint32_t> orm_pack;
+
 		MaterialParams params;
 
 		///
@@ -81,6 +91,35 @@ namespace gltf
 		) noexcept;
 	};
 
+	// Source images and sampler of a packed ORM texture
+	struct OrmPackSource
+	{
+		uint32_t occlusion_image;
+		uint32_t metallic_roughness_image;
+		std::optional<uint32_t> sampler_index;
+
+		bool operator==(const OrmPackSource&) const noexcept = default;
+	};
+
+	///
+	/// @brief Find materials whose occlusion and metallic-roughness textures can share one ORM texture
+	/// @details Both textures must use the same UV set and sampler. Materials already sharing one image are
+	/// only flagged with `orm_packed`. Otherwise, if `merge` is set and both images have the same size, a
+	/// pack is planned and assigned to `orm_pack`. Materials with the same sources share one pack.
+	///
+	/// @param model Tinygltf model
+	/// @param textures Textures referenced by `materials`
+	/// @param materials Materials loaded from `model.materials`, in the same order
+	/// @param merge Whether to plan new packs
+	/// @return Sources of each planned pack, indexed by `MaterialIndexed::orm_pack`
+	///
+	std::vector<OrmPackSource> plan_orm_packs(
+		const tinygltf::Model& model,
+		std::span<const Texture> textures,
+		std::span<MaterialIndexed> materials,
+		bool merge
+	) noexcept;
+
 	// Material object, with textures stored as actual GPU texture bindings
 	struct MaterialGPU
 	{
@@ -111,10 +150,9 @@ namespace gltf
 			std::reference_wrapper<const MaterialGPU> default_material;
 
 			// Get material bind for a drawcall
-			FORCE_INLINE MaterialGPU operator[](std::optional<uint32_t> material_index) const noexcept
+			FORCE_INLINE const MaterialGPU& operator[](std::optional<uint32_t> material_index) const noexcept
 			{
-				return material_index.transform([this](uint32_t index) { return materials[index]; })
-					.value_or(default_material.get());
+				return material_index.has_value() ? materials[*material_index] : default_material.get();
 			}
 		};
 
@@ -147,6 +185,13 @@ namespace gltf
 		{
 			ColorCompressMode color_mode = ColorCompressMode::RGBA8_BC7;
 			NormalCompressMode normal_mode = NormalCompressMode::RGn_BC5;
+
+			// Pick cheaper BC1/BC4/BC5 per image from channel content, see `select_color_compress_mode`
+			bool auto_select_format = true;
+			float auto_select_min_psnr = 38.0f;  // Minimum PSNR for auto selected formats, in dB
+
+			// Merge separate occlusion and metallic-roughness textures into one ORM texture when possible
+			bool pack_orm = true;
 		};
 
 		///
@@ -174,6 +219,12 @@ namespace gltf
 		///
 		std::optional<std::unique_ptr<MaterialCache>> gen_material_cache() const noexcept;
 
+		// Get summary of image deduplication during load
+		DedupSummary get_image_dedup_summary() const noexcept { return image_dedup_summary; }
+
+		// Get summary of sampler deduplication during load
+		DedupSummary get_sampler_dedup_summary() const noexcept { return sampler_dedup_summary; }
+
 	  private:
 
 		struct ImageEntry
@@ -181,6 +232,9 @@ namespace gltf
 			std::optional<gpu::Texture> color_texture;
 			std::optional<gpu::Texture> linear_texture;
 			std::optional<gpu::Texture> normal_texture;
+
+			std::optional<ColorCompressMode> color_mode;   // Compress mode selected for `color_texture`
+			std::optional<ColorCompressMode> linear_mode;  // Compress mode selected for `linear_texture`
 		};
 
 		struct ImageRefCount
@@ -188,11 +242,25 @@ namespace gltf
 			uint32_t color_refcount = 0;   // Use count as SRGB color texture (RGB/RGBA)
 			uint32_t linear_refcount = 0;  // Use count as linear texture (RGB/RGBA)
 			uint32_t normal_refcount = 0;  // Use count as normal map (RG only)
+
+			glm::bvec4 color_channels = glm::bvec4(false);   // Channels read as color texture
+			glm::bvec4 linear_channels = glm::bvec4(false);  // Channels read as linear texture
 		};
 
-		static std::vector<ImageRefCount> compute_image_refcounts(const tinygltf::Model& model) noexcept;
+		// Occlusion and metallic-roughness images merged into one ORM texture
+		struct OrmPack
+		{
+			OrmPackSource source;
+
+			std::optional<gpu::Texture> texture;    // Uploaded packed texture, filled by `load_orm_packs`
+			std::optional<ColorCompressMode> mode;  // Compress mode selected for `texture`
+		};
+
+		// Count image usages through `textures` and `materials`, must be called after both are loaded
+		std::vector<ImageRefCount> compute_image_refcounts(const tinygltf::Model& model) const noexcept;
 
 		std::vector<ImageEntry> images;
+		std::vector<OrmPack> orm_packs;
 		std::vector<gpu::Sampler> samplers;
 
 		std::vector<Texture> textures;
@@ -203,6 +271,9 @@ namespace gltf
 
 		std::unique_ptr<gpu::Sampler> default_sampler;
 
+		DedupSummary image_dedup_summary;
+		DedupSummary sampler_dedup_summary;
+
 		/*===== Create =====*/
 
 		// Create default textures (fallback textures)
@@ -227,19 +298,38 @@ namespace gltf
 			const Load_progress_callback& progress_callback
 		) noexcept;
 
-		// Load all samplers from the model
-		std::expected<void, util::Error> load_samplers(
+		// Load all unique samplers from the model, returns the index into `samplers` of each model sampler
+		std::expected<std::vector<uint32_t>, util::Error> load_samplers(
 			SDL_GPUDevice* device,
 			const tinygltf::Model& model,
 			const SamplerConfig& sampler_config
 		) noexcept;
 
-		// Load all textures from the model
-		std::expected<void, util::Error> load_textures(const tinygltf::Model& model) noexcept;
+		// Load all textures from the model, pointing duplicated images and samplers to their canonical copy
+		std::expected<void, util::Error> load_textures(
+			const tinygltf::Model& model,
+			std::span<const uint32_t> image_remap,
+			std::span<const uint32_t> sampler_slots
+		) noexcept;
 
 		// Load all materials from the model
 		std::expected<void, util::Error> load_materials(const tinygltf::Model& model) noexcept;
 
+		// Worker thread for packing and uploading an ORM texture, returns the texture and its compress mode
+		static std::expected<std::pair<gpu::Texture, ColorCompressMode>, util::Error> load_orm_pack_thread(
+			SDL_GPUDevice* device,
+			const tinygltf::Image& occlusion,
+			const tinygltf::Image& metallic_roughness,
+			const ImageConfig& image_config
+		) noexcept;
+
+		// Pack and upload all planned ORM textures, concurrently
+		std::expected<void, util::Error> load_orm_packs(
+			SDL_GPUDevice* device,
+			const tinygltf::Model& model,
+			const ImageConfig& image_config
+		) noexcept;
+
 		/*===== Construct =====*/
 
 		MaterialList() = default;
@@ -267,6 +357,14 @@ namespace gltf
 		///
 		std::optional<MaterialGPU> gen_binding_info(std::optional<uint32_t> material_index) const noexcept;
 
+		///
+		/// @brief Get texture sampler binding of a packed ORM texture
+		///
+		/// @param pack_index Index to `orm_packs`
+		/// @return Texture sampler binding on success, or nullopt if the pack is not uploaded
+		///
+		std::optional<SDL_GPUTextureSamplerBinding> get_orm_binding(uint32_t pack_index) const noexcept;
+
 	  public:
 
 		MaterialList(const MaterialList&) = delete;
@@ -6,9 +6,12 @@
 #pragma once
 
 #include "gpu/buffer.hpp"
+#include "graphics/occlusion.hpp"
+#include "graphics/skin-bound.hpp"
 #include "util/inline.hpp"
 
 #include <glm/glm.hpp>
+#include <memory>
 #include <optional>
 #include <tiny_gltf.h>
 #include <vector>
@@ -120,6 +123,9 @@ namespace gltf
 		SDL_GPUBufferBinding shadow_index_buffer_binding;
 		uint32_t index_count;
 		bool rigged;
+
+		const graphics::OccluderMesh* occluder;  // Simplified occluder mesh, null if not an occluder
+		uint32_t geometry_index;                 // See `PrimitiveGPU::geometry_index`
 	};
 
 	// Primitive Mesh Data for GPU
@@ -136,6 +142,15 @@ namespace gltf
 		glm::vec3 position_min, position_max;
 		bool rigged;
 
+		// Simplified mesh for occlusion culling, null for rigged or overly complex primitives
+		std::unique_ptr<const graphics::OccluderMesh> occluder;
+
+		// Per-joint boxes for tight world bounds, empty for non-rigged primitives
+		graphics::SkinBound skin_bound;
+
+		// Index of the primitive in its model, stable across frames and runs unlike buffer addresses
+		uint32_t geometry_index = 0;
+
 		///
 		/// @brief Create a `Primitive_gpu` from a `Primitive`, uploading data to the GPU
 		///
@@ -170,7 +185,9 @@ namespace gltf
 				 .shadow_vertex_buffer_binding = {.buffer = shadow_vertex_buffer, .offset = 0},
 				 .shadow_index_buffer_binding = {.buffer = shadow_index_buffer, .offset = 0},
 				 .index_count = index_count,
-				 .rigged = rigged},
+				 .rigged = rigged,
+				 .occluder = occluder.get(),
+				 .geometry_index = geometry_index},
 				position_min,
 				position_max
 			};
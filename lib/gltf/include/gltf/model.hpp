@@ -6,14 +6,22 @@
 #pragma once
 
 #include "animation.hpp"
+#include "gltf/instance.hpp"
 #include "gltf/light.hpp"
 #include "gltf/skin.hpp"
+#include "graphics/bvh.hpp"
 #include "material.hpp"
 #include "mesh.hpp"
 #include "node.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <thread_pool/thread_pool.h>
 #include <unordered_map>
 #include <variant>
 
@@ -30,11 +38,19 @@ namespace gltf
 
 		float emissive_multiplier = 1.0f;
 
+		// Instanced drawcalls draw `instance_count` instances, whose data starts at `instance_offset` in
+		// `DeferredInstanceResource::instances`. Their transform is the identity and their joint offset is
+		// relative to one instance, the instance data holds the actual ones.
+		uint32_t instance_offset = 0;
+		uint32_t instance_count = 0;  // 0 for single drawcalls
+
 		FORCE_INLINE bool is_rigged() const noexcept
 		{
 			return std::holds_alternative<uint32_t>(transform_or_joint_matrix_offset);
 		}
 
+		FORCE_INLINE bool is_instanced() const noexcept { return instance_count > 0; }
+
 		FORCE_INLINE const glm::mat4& get_world_transform() const noexcept
 		{
 			return std::get<glm::mat4>(transform_or_joint_matrix_offset);
@@ -46,20 +62,363 @@ namespace gltf
 		}
 	};
 
+	///
+	/// @brief Handle to a drawcall in a `DrawcallList`
+	/// @details Lets renderer-side lists refer to drawcalls without copying them. A handle becomes stale
+	/// once the partition it points to is rebuilt, which `DrawcallList::resolve` detects by generation.
+	///
+	struct DrawcallHandle
+	{
+		enum class Partition : uint8_t
+		{
+			Static,  // Drawcalls of static nodes, kept across frames
+			Dynamic  // Drawcalls of animated or rigged nodes, rebuilt every frame
+		};
+
+		Partition partition;
+		uint32_t index;
+		uint32_t generation;
+	};
+
+	// A partition of drawcalls, immutable once published in a `DrawcallList`
+	struct DrawcallPartition
+	{
+		std::vector<PrimitiveDrawcall> drawcalls;
+		uint32_t generation = 0;  // Unique per build of a partition
+		graphics::Bvh bvh;        // Hierarchy over drawcall world bounds, only built for the static partition
+	};
+
+	// Drawcalls of a model for one frame, split into a static and a dynamic partition
+	struct DrawcallList
+	{
+		std::shared_ptr<const DrawcallPartition> static_partition;
+		std::shared_ptr<const DrawcallPartition> dynamic_partition;
+
+		///
+		/// @brief Resolve a drawcall handle
+		///
+		/// @param handle Drawcall handle
+		/// @return Pointer to the drawcall, or nullptr if the handle is stale or out of range
+		///
+		FORCE_INLINE const PrimitiveDrawcall* resolve(DrawcallHandle handle) const noexcept
+		{
+			const auto& partition = handle.partition == DrawcallHandle::Partition::Static
+				? static_partition
+				: dynamic_partition;
+
+			if (partition == nullptr || partition->generation != handle.generation) [[unlikely]]
+				return nullptr;
+			if (handle.index >= partition->drawcalls.size()) [[unlikely]]
+				return nullptr;
+
+			return &partition->drawcalls[handle.index];
+		}
+
+		///
+		/// @brief Visit every drawcall with its handle, static partition first
+		///
+		/// @param func Callable as `func(DrawcallHandle, const PrimitiveDrawcall&)`
+		///
+		void for_each(auto&& func) const noexcept { for_each_in_range(0, size(), func); }
+
+		///
+		/// @brief Visit drawcalls in `[begin, end)` of the order used by `for_each`
+		/// @note Used to split the list into chunks processed independently
+		///
+		/// @param begin First drawcall position
+		/// @param end Past-the-end drawcall position, clamped to `size()`
+		/// @param func Callable as `func(DrawcallHandle, const PrimitiveDrawcall&)`
+		///
+		void for_each_in_range(size_t begin, size_t end, auto&& func) const noexcept
+		{
+			using Kind = DrawcallHandle::Partition;
+
+			// Visit the part of a partition overlapping the range, return the partition size
+			const auto visit = [&](Kind kind, const DrawcallPartition* partition, size_t offset) {
+				if (partition == nullptr) return 0zu;
+
+				const size_t count = partition->drawcalls.size();
+				const size_t first = std::clamp(begin, offset, offset + count) - offset;
+				const size_t last = std::clamp(end, offset, offset + count) - offset;
+
+				for (const auto idx : std::views::iota(first, last))
+					func(
+						DrawcallHandle{
+							.partition = kind,
+							.index = uint32_t(idx),
+							.generation = partition->generation
+						},
+						partition->drawcalls[idx]
+					);
+
+				return count;
+			};
+
+			const size_t static_count = visit(Kind::Static, static_partition.get(), 0);
+			visit(Kind::Dynamic, dynamic_partition.get(), static_count);
+		}
+
+		///
+		/// @brief Find static drawcalls passing `graphics::box_in_frustum`, using the static hierarchy
+		///
+		/// @param planes Frustum planes
+		/// @param visible Output, resized to the static drawcall count, non-zero for visible drawcalls
+		/// @param scratch Resource for the traversal of the hierarchy, such as a `util::FrameArena` slot
+		/// owned by the calling thread
+		///
+		void cull_static(
+			std::span<const glm::vec4> planes,
+			std::pmr::vector<uint8_t>& visible,
+			std::pmr::memory_resource* scratch = std::pmr::get_default_resource()
+		) const noexcept;
+
+		// Total drawcall count
+		size_t size() const noexcept
+		{
+			return (static_partition ? static_partition->drawcalls.size() : 0)
+				+ (dynamic_partition ? dynamic_partition->drawcalls.size() : 0);
+		}
+	};
+
+	///
+	/// @brief Drawcall partitions of a model, kept from frame to frame
+	/// @details
+	/// - The static partition holds drawcalls of static nodes, it is only rebuilt when the model transform,
+	/// the node visibility or the emission values change.
+	/// - The dynamic partition is rebuilt every call. Partitions rebuilt every call rotate through
+	/// `frame_count` slots, so drawcall lists of the previous `frame_count - 1` calls stay valid.
+	/// - Storage is kept from call to call, calls with unchanged static inputs and drawcall counts do not
+	/// allocate once every slot has been filled.
+	///
+	class DrawcallCache
+	{
+	  public:
+
+		///
+		/// @brief Set the number of frames drawcall lists stay in flight
+		/// @note Partitions referenced by lists in flight are kept alive by them, new slots start empty
+		///
+		/// @param frame_count Number of slots, 2 for double buffering
+		///
+		void set_frame_count(uint32_t frame_count) noexcept;
+
+		///
+		/// @brief Update the partitions and get the drawcall list of a frame
+		///
+		/// @param model_transform Root model transform, the static partition is rebuilt when it changes
+		/// @param node_order Order nodes emit drawcalls in, within each partition
+		/// @param renderable_nodes If node is renderable, by node index
+		/// @param dynamic_nodes If node drawcalls change every frame, by node index
+		/// @param emission_overrides Overrides for emissive factors (node_index, multiplier)
+		/// @param hidden_nodes List of node indices to hide
+		/// @param append_node Callable as `append_node(node_index, emissive_multiplier, output)`, appending
+		/// the drawcalls of a node to `output`
+		/// @return Drawcall list, static partition first
+		///
+		DrawcallList update(
+			const glm::mat4& model_transform,
+			std::span<const uint32_t> node_order,
+			const std::vector<bool>& renderable_nodes,
+			const std::vector<bool>& dynamic_nodes,
+			std::span<const std::pair<uint32_t, float>> emission_overrides,
+			std::span<const uint32_t> hidden_nodes,
+			const auto& append_node
+		) noexcept
+		{
+			const bool static_valid =
+				resolve_inputs(model_transform, renderable_nodes, emission_overrides, hidden_nodes);
+
+			// Fill a partition with drawcalls of visible nodes matching `dynamic`, in node order
+			const auto fill_partition = [&](DrawcallPartition& partition, bool dynamic) {
+				partition.drawcalls.clear();
+				partition.generation = next_generation++;
+
+				for (const auto node_index : node_order)
+				{
+					if (!visible_nodes[node_index] || dynamic_nodes[node_index] != dynamic) continue;
+					append_node(node_index, emission_values[node_index], partition.drawcalls);
+				}
+			};
+
+			if (!static_valid)
+			{
+				// Previous partition may still be referenced by in-flight lists, always build a new one
+				auto partition = std::make_shared<DrawcallPartition>();
+				if (static_partition != nullptr)
+					partition->drawcalls.reserve(static_partition->drawcalls.size());
+
+				fill_partition(*partition, false);
+				publish_static_partition(std::move(partition), model_transform);
+			}
+
+			const auto& dynamic_partition = dynamic_partitions.advance(frame_count);
+			fill_partition(*dynamic_partition, true);
+
+			return {.static_partition = static_partition, .dynamic_partition = dynamic_partition};
+		}
+
+		///
+		/// @brief Get an empty partition for drawcalls rebuilt every call outside of `update`
+		/// @details Rotates through its own `frame_count` slots, and gets a new generation.
+		///
+		/// @return Partition to fill
+		///
+		const std::shared_ptr<DrawcallPartition>& next_instanced_partition() noexcept;
+
+	  private:
+
+		// Partitions rebuilt every call, one per frame slot so that lists in flight are never written
+		struct PartitionRing
+		{
+			std::vector<std::shared_ptr<DrawcallPartition>> partitions;
+			size_t next_slot = 0;
+
+			// Get the partition of the next frame slot, created on first use
+			const std::shared_ptr<DrawcallPartition>& advance(uint32_t frame_count) noexcept;
+		};
+
+		uint32_t frame_count = 2;
+		uint32_t next_generation = 0;
+
+		std::shared_ptr<DrawcallPartition> static_partition;
+		PartitionRing dynamic_partitions;
+		PartitionRing instanced_partitions;
+
+		// Inputs the static partition was built with, it is rebuilt when any of them changes
+		glm::mat4 static_model_transform = glm::mat4(1.0f);
+		std::vector<bool> static_visible_nodes;
+		std::vector<float> static_emission_values;
+
+		// Resolved inputs of the current call, kept to avoid reallocation
+		std::vector<bool> visible_nodes;
+		std::vector<float> emission_values;
+
+		// Resolve visibility and emission values, return if the static partition is still valid
+		bool resolve_inputs(
+			const glm::mat4& model_transform,
+			const std::vector<bool>& renderable_nodes,
+			std::span<const std::pair<uint32_t, float>> emission_overrides,
+			std::span<const uint32_t> hidden_nodes
+		) noexcept;
+
+		// Build the hierarchy of a filled static partition and keep it with the inputs it was built with
+		void publish_static_partition(
+			std::shared_ptr<DrawcallPartition> partition,
+			const glm::mat4& model_transform
+		) noexcept;
+	};
+
+	///
+	/// @brief Append the instanced drawcalls of a node, see `Model::generate_instanced_drawdata`
+	/// @details
+	/// - Instances showing the node are grouped by `group_node_instances`. Each group appends the data of
+	/// its instances to `instance_data`, then one drawcall per primitive drawing the whole group.
+	/// - Drawcalls copy `primitives`, with the emissive multiplier of the group and the union of the
+	/// primitive bounds of its instances. Rigged drawcalls keep their joint offset, relative to one
+	/// instance, others get the identity transform.
+	///
+	/// @param primitives Drawcalls of the node for one instance, their bound is ignored
+	/// @param visible Visibility of the node, one per instance
+	/// @param emission_values Emissive multiplier of the node, one per instance
+	/// @param primitive_bounds World bound of each primitive, one per instance, laid out primitive by
+	/// primitive
+	/// @param joint_count Joints per instance in the joint palette
+	/// @param get_world_matrix Callable as `get_world_matrix(instance_index)`, world matrix of the node
+	/// @param instance_indices Grouping scratch, see `group_node_instances`
+	/// @param groups Grouping scratch, see `group_node_instances`
+	/// @param instance_data Output, per-instance data is appended
+	/// @param output Output, instanced drawcalls are appended
+	///
+	void append_instanced_drawcalls(
+		std::span<const PrimitiveDrawcall> primitives,
+		std::span<const uint8_t> visible,
+		std::span<const float> emission_values,
+		std::span<const graphics::Aabb> primitive_bounds,
+		uint32_t joint_count,
+		const auto& get_world_matrix,
+		std::vector<uint32_t>& instance_indices,
+		std::vector<InstanceGroup>& groups,
+		std::vector<InstanceData>& instance_data,
+		std::vector<PrimitiveDrawcall>& output
+	) noexcept
+	{
+		if (primitives.empty()) return;
+
+		const size_t instance_count = visible.size();
+		const bool rigged = primitives.front().is_rigged();
+		group_node_instances(visible, emission_values, rigged, instance_indices, groups);
+
+		for (const auto& group : groups)
+		{
+			const auto group_instances = std::span(instance_indices).subspan(group.first, group.count);
+			const auto instance_offset = uint32_t(instance_data.size());
+
+			for (const uint32_t instance_index : group_instances)
+				instance_data.push_back(
+					rigged
+						? InstanceData{
+							  .transform = glm::mat4(1.0f),
+							  .joint_offset =
+								  instance_index * joint_count + primitives.front().get_joint_matrix_offset()
+						  }
+						: InstanceData{.transform = get_world_matrix(instance_index), .joint_offset = 0}
+				);
+
+			for (const auto [primitive_index, primitive] : std::views::enumerate(primitives))
+			{
+				const auto bounds = primitive_bounds.subspan(size_t(primitive_index) * instance_count);
+
+				auto world_min = glm::vec3(std::numeric_limits<float>::max());
+				auto world_max = glm::vec3(std::numeric_limits<float>::lowest());
+
+				for (const auto instance_index : group_instances)
+				{
+					world_min = glm::min(world_min, bounds[instance_index].min);
+					world_max = glm::max(world_max, bounds[instance_index].max);
+				}
+
+				auto& drawcall = output.emplace_back(primitive);
+				drawcall.world_position_min = world_min;
+				drawcall.world_position_max = world_max;
+				if (!rigged) drawcall.transform_or_joint_matrix_offset = glm::mat4(1.0f);
+				drawcall.emissive_multiplier = group.emissive_multiplier;
+				drawcall.instance_offset = instance_offset;
+				drawcall.instance_count = group.count;
+			}
+		}
+	}
+
 	struct Drawdata
 	{
 		// Drawcall list
-		std::vector<PrimitiveDrawcall> primitive_drawcalls;
+		DrawcallList primitive_drawcalls;
 
-		std::vector<glm::mat4> node_matrices;
+		// World matrix of every node, instance by instance for instanced drawdata
+		std::pmr::vector<glm::mat4> node_matrices;
 
 		// Joint matrices
 		std::shared_ptr<DeferredSkinningResource> deferred_skin_resource;
 
+		// Per-instance data, only for instanced drawdata
+		std::shared_ptr<DeferredInstanceResource> deferred_instance_resource;
+
 		// Material bind cache reference
 		MaterialCache::Ref material_cache;
 	};
 
+	// Content deduplication performed while loading a model
+	struct ModelDedupSummary
+	{
+		DedupSummary images;
+		DedupSummary samplers;
+		DedupSummary meshes;
+
+		size_t saved_bytes() const noexcept
+		{
+			return images.saved_bytes + samplers.saved_bytes + meshes.saved_bytes;
+		}
+	};
+
 	class Model
 	{
 	  private:
@@ -82,6 +441,22 @@ namespace gltf
 		size_t primitive_count;                               // Total primitive count
 		std::unique_ptr<MaterialCache> material_bind_cache;   // Material bind cache
 		std::unordered_map<std::string, uint32_t> animation_name_map;  // Map of animation name to index
+		ModelDedupSummary dedup_summary;                               // Deduplication during load
+		std::vector<bool> dynamic_nodes;  // Nodes under animated subtrees or with a skin
+
+		/*===== Drawcall Cache =====*/
+
+		DrawcallCache drawcall_cache;  // Drawcall partitions, reused across `generate_drawdata` calls
+
+		// Per-instance scratch of `generate_instanced_drawdata`, laid out node by node or slot by slot
+		struct InstanceScratch
+		{
+			std::vector<uint8_t> visible_nodes;
+			std::vector<float> emission_values;
+			std::vector<graphics::Aabb> slot_bounds;
+		};
+
+		InstanceScratch instance_scratch;
 
 	  public:
 
@@ -118,22 +493,60 @@ namespace gltf
 			const std::optional<std::reference_wrapper<std::atomic<LoadProgress>>>& progress = std::nullopt
 		) noexcept;
 
+		///
+		/// @brief Set the number of frames drawdata stays in flight
+		/// @details Partitions rebuilt every call are kept in `frame_count` slots, written in turn, so
+		/// drawdata of the previous `frame_count - 1` calls to each generate function stays valid. Match the
+		/// frame count of the `util::FrameArena` the drawdata is generated with.
+		///
+		/// @param frame_count Number of slots, 2 for double buffering
+		///
+		void set_frame_count(uint32_t frame_count) noexcept;
+
 		///
 		/// @brief Generate drawdata for the model
+		/// @details Drawcalls of static nodes are cached across calls, and only rebuilt when
+		/// `model_transform`, `hidden_nodes` or `emission_overrides` change. Drawcalls of animated subtrees
+		/// and rigged nodes are rebuilt every call, into the storage of the call `frame_count` calls ago.
 		/// @warning The life span of the returned drawdata is shorter than the life span of the model
 		///
 		/// @param model_transform Root model transform matrix
 		/// @param animation Animation keys to apply
 		/// @param emission_overrides Overrides for emissive factors (node_index, multiplier)
 		/// @param hidden_nodes List of node indices to hide
+		/// @param memory Resource for the per-frame node and joint matrices and scratch buffers, such as a
+		/// `util::FrameArena` slot outliving the drawdata
 		/// @return Drawdata, where drawcall's matrix denotes `Model->World` transform
 		///
 		Drawdata generate_drawdata(
 			const glm::mat4& model_transform,
 			std::span<const AnimationKey> animation,
 			std::span<const std::pair<uint32_t, float>> emission_overrides,
-			std::span<const uint32_t> hidden_nodes
-		) const noexcept;
+			std::span<const uint32_t> hidden_nodes,
+			std::pmr::memory_resource* memory = std::pmr::get_default_resource()
+		) noexcept;
+
+		///
+		/// @brief Generate drawdata for many instances of the model at once
+		/// @details
+		/// - Instances are evaluated in chunks, on `thread_pool` when given. Node matrices, visibility,
+		/// emission values and joint matrices of every instance are laid out instance by instance in shared
+		/// arrays, and the model data is only read.
+		/// - Every primitive of a node becomes one instanced drawcall for all instances showing the node
+		/// with the same emissive multiplier. Its bound is the union of the instance bounds.
+		/// - All drawcalls are in the dynamic partition, rebuilt every call into its own `frame_count` slots.
+		/// @note Each drawcall matches the drawcall `generate_drawdata` would produce for one of its
+		/// instances, except for its bound, transform and joint offset
+		/// @warning The life span of the returned drawdata is shorter than the life span of the model
+		///
+		/// @param instances Instance records
+		/// @param thread_pool Thread pool evaluating instances, or nullptr to evaluate on the calling thread
+		/// @return Drawdata, where `node_matrices` holds `node count` matrices per instance
+		///
+		Drawdata generate_instanced_drawdata(
+			std::span<const InstanceRecord> instances,
+			dp::thread_pool<>* thread_pool = nullptr
+		) noexcept;
 
 		///
 		/// @brief Get the list of animations
@@ -142,6 +555,13 @@ namespace gltf
 		///
 		std::span<const Animation> get_animations() const noexcept { return animations; }
 
+		///
+		/// @brief Get the summary of duplicated images, samplers and meshes collapsed during load
+		///
+		/// @return Deduplication summary, including saved source bytes
+		///
+		const ModelDedupSummary& get_dedup_summary() const noexcept { return dedup_summary; }
+
 		///
 		/// @brief Find a unique node by name
 		///
@@ -171,26 +591,60 @@ namespace gltf
 		// be called after `compute_topo_order()`.
 		void compute_renderable_nodes() noexcept;
 
+		// Compute which nodes have drawcalls that may change every frame, must be called after
+		// `compute_topo_order()`.
+		void compute_dynamic_nodes() noexcept;
+
+		// Compress all animations, measuring errors with the rest pose reach of nodes. Must be called after
+		// `compute_topo_order()`.
+		void compress_animations(const AnimationClip::Config& config) noexcept;
+
 		/*===== Render Stage =====*/
 
 		// Compute node transform overrides from animation keys
-		std::vector<Node::TransformOverride> compute_node_overrides(
-			std::span<const AnimationKey> animation
+		std::pmr::vector<Node::TransformOverride> compute_node_overrides(
+			std::span<const AnimationKey> animation,
+			std::pmr::memory_resource* memory
+		) const noexcept;
+
+		// Apply animation keys to node transform overrides
+		void apply_animation_keys(
+			std::span<const AnimationKey> animation,
+			std::span<Node::TransformOverride> node_overrides
 		) const noexcept;
 
 		// Compute world matrices for all nodes
-		std::vector<glm::mat4> compute_node_world_matrices(
+		std::pmr::vector<glm::mat4> compute_node_world_matrices(
 			const glm::mat4& model_transform,
-			std::span<const Node::TransformOverride> node_overrides
+			std::span<const Node::TransformOverride> node_overrides,
+			std::pmr::memory_resource* memory
 		) const noexcept;
 
-		// Generate drawcalls from world matrices
-		std::vector<PrimitiveDrawcall> compute_drawcalls(
-			const std::vector<glm::mat4>& node_world_matrices,
-			std::span<const std::pair<uint32_t, float>> emission_overrides,
-			std::span<const uint32_t> hidden_nodes
+		// Write world matrices of all nodes to `output`, sized to the node count
+		void write_node_world_matrices(
+			const glm::mat4& model_transform,
+			std::span<const Node::TransformOverride> node_overrides,
+			std::span<glm::mat4> output
+		) const noexcept;
+
+		// Append drawcalls of a node to `output`, `scratch` holds the joint matrices of rigged nodes
+		void append_node_drawcalls(
+			uint32_t node_index,
+			std::span<const glm::mat4> node_world_matrices,
+			float emissive_multiplier,
+			std::vector<PrimitiveDrawcall>& output,
+			std::pmr::memory_resource* scratch
 		) const noexcept;
 
+		// Generate drawcalls from world matrices, updating the drawcall cache
+		DrawcallList compute_drawcalls(
+			const glm::mat4& model_transform,
+			std::span<const glm::mat4> node_world_matrices,
+			std::span<const std::pair<uint32_t, float>> emission_overrides,
+			std::span<const uint32_t> hidden_nodes,
+			std::pmr::memory_resource* scratch
+		) noexcept;
+
 		Model(
 			MaterialList material_list,
 			std::vector<MeshGPU> meshes,
@@ -2,12 +2,14 @@
 
 #include "gpu/buffer.hpp"
 #include "gpu/copy-pass.hpp"
+#include "gltf/joint-palette.hpp"
 #include "graphics/util/buffer-pool.hpp"
 #include "util/error.hpp"
 #include "util/inline.hpp"
 
 #include <SDL3/SDL_gpu.h>
 #include <glm/glm.hpp>
+#include <memory_resource>
 #include <tiny_gltf.h>
 
 namespace gltf
@@ -30,8 +32,10 @@ namespace gltf
 
 		static std::expected<SkinList, util::Error> from_tinygltf(const tinygltf::Model& model) noexcept;
 
-		std::vector<glm::mat4> compute_joint_matrices(
-			const std::vector<glm::mat4>& node_world_matrices
+		// Gather the world matrix of every joint of every skin, in the order of `joints`
+		std::pmr::vector<glm::mat4> gather_joint_world_matrices(
+			std::span<const glm::mat4> node_world_matrices,
+			std::pmr::memory_resource* memory = std::pmr::get_default_resource()
 		) const noexcept;
 
 		FORCE_INLINE Skin operator[](size_t idx) const noexcept
@@ -54,7 +58,12 @@ namespace gltf
 	///
 	struct DeferredSkinningResource
 	{
-		std::vector<glm::mat4> joint_matrices_data;
+		// World matrix of every joint of every skin, repeated for every instance of instanced drawdata
+		std::pmr::vector<glm::mat4> joint_world_matrices;
+		std::span<const glm::mat4> inverse_bind_matrices;  // Of one instance, model-owned
+
+		// Encoding of `joint_matrices_buffer`, see `prepare_gpu_buffers`
+		JointPalette palette = JointPalette::Matrix;
 
 		// Initialize at render time, see `prepare_gpu_buffers`
 		std::shared_ptr<gpu::TransferBuffer> upload_buffer = nullptr;
@@ -65,21 +74,31 @@ namespace gltf
 		///
 		/// @brief Constructs a skinning resource with joint matrices data
 		///
-		/// @param joint_matrices_data Computed joint matrices data, see `Skin_list::compute_joint_matrices`
+		/// @param joint_world_matrices Joint world matrices, see `SkinList::gather_joint_world_matrices`,
+		/// a whole multiple of the inverse bind matrix count
+		/// @param inverse_bind_matrices Inverse bind matrices of the skin list, must outlive the resource
 		///
-		DeferredSkinningResource(std::vector<glm::mat4> joint_matrices_data) :
-			joint_matrices_data(std::move(joint_matrices_data))
+		DeferredSkinningResource(
+			std::pmr::vector<glm::mat4> joint_world_matrices,
+			std::span<const glm::mat4> inverse_bind_matrices
+		) :
+			joint_world_matrices(std::move(joint_world_matrices)),
+			inverse_bind_matrices(inverse_bind_matrices)
 		{}
 
 		///
-		/// @brief Acquire GPU buffers for skin computation
+		/// @brief Acquire GPU buffers for skin computation, and encode the joint matrices into the upload
+		/// buffer
 		///
 		/// @param buffer_pool Buffer Pool
+		/// @param transfer_pool Transfer Buffer Pool
+		/// @param palette Joint palette encoding, must match the one read by the skinning shaders
 		/// @return Void on success, or error on failure
 		///
 		std::expected<void, util::Error> prepare_gpu_buffers(
 			graphics::BufferPool& buffer_pool,
-			graphics::TransferBufferPool& transfer_pool
+			graphics::TransferBufferPool& transfer_pool,
+			JointPalette palette
 		) noexcept;
 
 		///
@@ -88,5 +107,11 @@ namespace gltf
 		/// @param copy_pass Copy Pass
 		///
 		void upload_gpu_buffers(const gpu::CopyPass& copy_pass) noexcept;
+
+		// Size of the encoded palette in bytes
+		uint32_t get_palette_size() const noexcept
+		{
+			return uint32_t(get_joint_palette_stride(palette) * joint_world_matrices.size());
+		}
 	};
 }
\ No newline at end of file
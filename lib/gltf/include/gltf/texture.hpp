@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <expected>
 #include <optional>
+#include <span>
 #include <tiny_gltf.h>
 
 namespace gltf
@@ -29,5 +30,15 @@ namespace gltf
 			const tinygltf::Model& model,
 			const tinygltf::Texture& texture
 		) noexcept;
+
+		///
+		/// @brief Point the texture at the canonical copy of its image and sampler
+		///
+		/// @param image_remap Image index of each model image, `DedupMap::remap` of the images
+		/// @param sampler_slots Loaded sampler index of each model sampler
+		/// @return Remapped texture
+		///
+		Texture remap(std::span<const uint32_t> image_remap, std::span<const uint32_t> sampler_slots)
+			const noexcept;
 	};
 };
@@ -0,0 +1,475 @@
+#include "gltf/animation-clip.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <glm/gtc/quaternion.hpp>
+#include <limits>
+#include <ranges>
+
+namespace gltf
+{
+	namespace
+	{
+		using detail::animation::TargetPath;
+		using QuantizedKey = std::array<uint16_t, 3>;
+
+		constexpr float range_levels = 65535.0f;           // 16-bit range-reduced components
+		constexpr float component_levels = 32767.0f;       // 15-bit smallest-three components
+		constexpr float component_range = 0.70710678118f;  // Bound of the three smallest components
+
+		QuantizedKey quantize(const glm::vec3& value, const glm::vec3& range_min, const glm::vec3& range_step)
+			noexcept
+		{
+			QuantizedKey key;
+
+			for (const auto axis : std::views::iota(0, 3))
+			{
+				const float level =
+					range_step[axis] > 0.0f ? (value[axis] - range_min[axis]) / range_step[axis] : 0.0f;
+				key[axis] = uint16_t(std::lround(std::clamp(level, 0.0f, range_levels)));
+			}
+
+			return key;
+		}
+
+		QuantizedKey quantize(const glm::quat& value) noexcept
+		{
+			const glm::quat rotation = glm::normalize(value);
+			const std::array<float, 4> components = {rotation.x, rotation.y, rotation.z, rotation.w};
+
+			const auto largest = std::ranges::distance(
+				components.begin(),
+				std::ranges::max_element(components, {}, [](float component) { return std::abs(component); })
+			);
+
+			// `q` and `-q` are the same rotation, flip so that the dropped component is positive
+			const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+			uint64_t bits = uint64_t(largest);
+			for (const auto idx : std::views::iota(0, 4))
+			{
+				if (idx == largest) continue;
+
+				const float component = components[idx] * sign / component_range;
+				const float normalized = std::clamp(component * 0.5f + 0.5f, 0.0f, 1.0f);
+				bits = (bits << 15) | uint64_t(std::lround(normalized * component_levels));
+			}
+
+			return {uint16_t(bits >> 32), uint16_t(bits >> 16), uint16_t(bits)};
+		}
+
+		glm::vec3 dequantize(
+			const uint16_t* key,
+			const glm::vec3& range_min,
+			const glm::vec3& range_step
+		) noexcept
+		{
+			return range_min + glm::vec3(key[0], key[1], key[2]) * range_step;
+		}
+
+		glm::quat dequantize(const uint16_t* key) noexcept
+		{
+			const uint64_t bits = (uint64_t(key[0]) << 32) | (uint64_t(key[1]) << 16) | uint64_t(key[2]);
+
+			const auto decode = [bits](int shift) {
+				const float normalized = float((bits >> shift) & 0x7FFF) * (2.0f / component_levels) - 1.0f;
+				return normalized * component_range;
+			};
+
+			// The three smallest components, in order, then the dropped one
+			const float a = decode(30), b = decode(15), c = decode(0);
+			const float largest = std::sqrt(std::max(1.0f - a * a - b * b - c * c, 0.0f));
+
+			switch (bits >> 45)
+			{
+			case 0:
+				return {c, largest, a, b};
+			case 1:
+				return {c, a, largest, b};
+			case 2:
+				return {c, a, b, largest};
+			default:
+				return {largest, a, b, c};
+			}
+		}
+
+		glm::vec3 interpolate(const glm::vec3& a, const glm::vec3& b, float alpha) noexcept
+		{
+			return glm::mix(a, b, alpha);
+		}
+
+		// Normalized lerp along the shorter arc, cheaper than slerp and accounted for by the error bound
+		glm::quat interpolate(const glm::quat& a, const glm::quat& b, float alpha) noexcept
+		{
+			const glm::quat b_aligned = glm::dot(a, b) < 0.0f ? -b : b;
+			return glm::normalize(a * (1.0f - alpha) + b_aligned * alpha);
+		}
+
+		// Displacement of a point at `reach` from the node origin, in the parent space
+		float position_error(
+			TargetPath path,
+			const glm::vec3& value,
+			const glm::vec3& reference,
+			float reach
+		) noexcept
+		{
+			const glm::vec3 difference = glm::abs(value - reference);
+
+			if (path == TargetPath::Translation) return glm::length(difference);
+
+			// Reach includes the rest scale, scale errors are relative to it
+			const float reference_scale =
+				std::max({std::abs(reference.x), std::abs(reference.y), std::abs(reference.z), 1e-6f});
+			return std::max({difference.x, difference.y, difference.z}) / reference_scale * reach;
+		}
+
+		float position_error(
+			[[maybe_unused]] TargetPath path,
+			const glm::quat& value,
+			const glm::quat& reference,
+			float reach
+		) noexcept
+		{
+			const glm::quat aligned = glm::dot(value, reference) < 0.0f ? -reference : reference;
+			const glm::vec4 value_vec = {value.x, value.y, value.z, value.w};
+			const glm::vec4 aligned_vec = {aligned.x, aligned.y, aligned.z, aligned.w};
+
+			// Rotation angle between the two, robust for small angles
+			const float angle =
+				4.0f * std::atan2(glm::length(value_vec - aligned_vec), glm::length(value_vec + aligned_vec));
+			return angle * reach;
+		}
+
+		// Quantized samples of a track, with the frames kept in each segment
+		struct EncodedTrack
+		{
+			glm::vec3 range_min = glm::vec3(0.0f);
+			glm::vec3 range_step = glm::vec3(0.0f);
+			std::vector<QuantizedKey> quantized;              // Every resampled frame
+			std::vector<std::vector<uint16_t>> segment_keys;  // Relative to the first frame of each segment
+		};
+
+		///
+		/// @brief Quantize a resampled track, then reduce its keys segment by segment
+		///
+		/// @param path Transform component of the track
+		/// @param step Whether the track holds values between keys
+		/// @param samples Resampled values
+		/// @param reach Reach of the target node
+		/// @param max_error Error bound
+		/// @param segment_frames Frames per segment, segments share their boundary frames
+		/// @return Encoded track
+		///
+		template <typename T>
+		EncodedTrack encode_track(
+			TargetPath path,
+			bool step,
+			std::span<const T> samples,
+			float reach,
+			float max_error,
+			uint32_t segment_frames
+		) noexcept
+		{
+			EncodedTrack encoded;
+
+			/* Quantize */
+
+			std::vector<T> decoded;
+			encoded.quantized.reserve(samples.size());
+			decoded.reserve(samples.size());
+
+			if constexpr (std::same_as<T, glm::vec3>)
+			{
+				glm::vec3 range_max(std::numeric_limits<float>::lowest());
+				encoded.range_min = glm::vec3(std::numeric_limits<float>::max());
+
+				for (const auto& sample : samples)
+				{
+					encoded.range_min = glm::min(encoded.range_min, sample);
+					range_max = glm::max(range_max, sample);
+				}
+
+				encoded.range_step = (range_max - encoded.range_min) / range_levels;
+
+				for (const auto& sample : samples)
+				{
+					const auto key = quantize(sample, encoded.range_min, encoded.range_step);
+					encoded.quantized.push_back(key);
+					decoded.push_back(dequantize(key.data(), encoded.range_min, encoded.range_step));
+				}
+			}
+			else
+			{
+				for (const auto& sample : samples)
+				{
+					const auto key = quantize(sample);
+					encoded.quantized.push_back(key);
+					decoded.push_back(dequantize(key.data()));
+				}
+			}
+
+			/* Reduce Keys */
+
+			// Tell if interpolating between keys `first` and `last` reproduces all frames in between
+			const auto segment_valid = [&](size_t first, size_t last) {
+				for (const auto frame : std::views::iota(first + 1, last))
+				{
+					const float alpha = step ? 0.0f : float(frame - first) / float(last - first);
+					const T value = interpolate(decoded[first], decoded[last], alpha);
+					if (position_error(path, value, samples[frame], reach) > max_error) return false;
+				}
+
+				return true;
+			};
+
+			const size_t last_frame = samples.size() - 1;
+
+			for (size_t segment_first = 0;; segment_first += segment_frames)
+			{
+				const size_t segment_last = std::min<size_t>(segment_first + segment_frames, last_frame);
+				std::vector<uint16_t> kept = {0};
+
+				const auto first_valid = [&](size_t frame) {
+					return position_error(path, decoded[segment_first], samples[frame], reach) <= max_error;
+				};
+				const bool constant =
+					std::ranges::all_of(std::views::iota(segment_first, segment_last + 1), first_valid);
+
+				for (size_t current = segment_first; !constant && current < segment_last;)
+				{
+					// Gallop to bracket the longest valid segment, then bisect
+					size_t good = current + 1, bad = segment_last + 1;
+
+					for (size_t stride = 2;; stride *= 2)
+					{
+						const size_t candidate = std::min(current + stride, segment_last);
+
+						if (!segment_valid(current, candidate))
+						{
+							bad = candidate;
+							break;
+						}
+
+						good = candidate;
+						if (candidate == segment_last) break;
+					}
+
+					while (bad - good > 1)
+					{
+						const size_t middle = (good + bad) / 2;
+
+						if (segment_valid(current, middle))
+							good = middle;
+						else
+							bad = middle;
+					}
+
+					kept.push_back(uint16_t(good - segment_first));
+					current = good;
+				}
+
+				encoded.segment_keys.push_back(std::move(kept));
+				if (segment_last == last_frame) break;
+			}
+
+			return encoded;
+		}
+	}
+
+	AnimationClip AnimationClip::compress(
+		std::span<const std::unique_ptr<detail::animation::Channel>> channels,
+		std::span<const float> node_reach,
+		const Config& config
+	) noexcept
+	{
+		AnimationClip clip;
+		if (channels.empty()) return clip;
+
+		/* Resampling Grid */
+
+		float end_time = std::numeric_limits<float>::lowest();
+		clip.start_time = std::numeric_limits<float>::max();
+
+		for (const auto& channel : channels)
+		{
+			const auto [first, last] = channel->get_time_range();
+			clip.start_time = std::min(clip.start_time, first);
+			end_time = std::max(end_time, last);
+		}
+
+		const float duration = end_time - clip.start_time;
+		clip.frame_count = uint32_t(std::ceil(duration * config.sample_rate)) + 1;
+		clip.frame_rate = clip.frame_count > 1 ? float(clip.frame_count - 1) / duration : 0.0f;
+		clip.segment_count = std::max((clip.frame_count - 1 + segment_frames - 1) / segment_frames, 1u);
+
+		const auto frame_time = [&clip](uint32_t frame) {
+			return clip.frame_count > 1 ? clip.start_time + float(frame) / clip.frame_rate : clip.start_time;
+		};
+
+		/* Encode Tracks */
+
+		// Evaluation goes through the channels themselves, so every interpolation mode is resampled alike
+		std::vector<Node::TransformOverride> scratch(node_reach.size());
+
+		// Stable order keeps later channels after earlier ones on the same target
+		std::vector<size_t> channel_order(std::from_range, std::views::iota(0zu, channels.size()));
+		std::ranges::stable_sort(channel_order, {}, [&channels](size_t idx) {
+			return channels[idx]->get_target_node();
+		});
+
+		std::vector<EncodedTrack> encoded_tracks;
+		encoded_tracks.reserve(channels.size());
+
+		for (const auto channel_idx : channel_order)
+		{
+			const auto& channel = *channels[channel_idx];
+			const uint32_t node = channel.get_target_node();
+			const auto path = channel.get_target_path();
+			const bool step = channel.is_step();
+			const float reach = std::max(node_reach[node], config.min_reach);
+
+			const auto sample = [&](auto member) {
+				return std::views::iota(0u, clip.frame_count)
+					| std::views::transform([&](uint32_t frame) {
+						   channel.apply(scratch, frame_time(frame));
+						   return *(scratch[node].*member);
+					   })
+					| std::ranges::to<std::vector>();
+			};
+
+			EncodedTrack encoded;
+
+			switch (path)
+			{
+			case TargetPath::Translation:
+			case TargetPath::Scale:
+			{
+				const auto samples = sample(
+					path == TargetPath::Translation ? &Node::TransformOverride::translation
+													: &Node::TransformOverride::scale
+				);
+				encoded = encode_track<glm::vec3>(
+					path,
+					step,
+					samples,
+					reach,
+					config.max_position_error,
+					segment_frames
+				);
+				break;
+			}
+			case TargetPath::Rotation:
+				encoded = encode_track<glm::quat>(
+					path,
+					step,
+					sample(&Node::TransformOverride::rotation),
+					reach,
+					config.max_position_error,
+					segment_frames
+				);
+				break;
+			}
+
+			clip.tracks.push_back({
+				.target_node = node,
+				.path = path,
+				.step = step,
+				.range_min = encoded.range_min,
+				.range_step = encoded.range_step
+			});
+			encoded_tracks.push_back(std::move(encoded));
+		}
+
+		/* Interleave Segments */
+
+		// Each segment holds, for every track: key count, frame indices, then quantized values
+		for (const auto segment : std::views::iota(0u, clip.segment_count))
+		{
+			clip.segment_offsets.push_back(uint32_t(clip.keys.size()));
+
+			for (const auto& encoded : encoded_tracks)
+			{
+				const auto& kept = encoded.segment_keys[segment];
+				const uint32_t segment_first = segment * segment_frames;
+
+				clip.keys.push_back(uint16_t(kept.size()));
+				clip.keys.append_range(kept);
+				for (const auto frame : kept)
+					clip.keys.append_range(encoded.quantized[segment_first + frame]);
+			}
+		}
+
+		clip.tracks.shrink_to_fit();
+		clip.keys.shrink_to_fit();
+
+		return clip;
+	}
+
+	void AnimationClip::apply(std::span<Node::TransformOverride> overrides, float time) const noexcept
+	{
+		if (tracks.empty()) return;
+
+		const float frame = std::clamp((time - start_time) * frame_rate, 0.0f, float(frame_count - 1));
+		const uint32_t segment = std::min(uint32_t(frame) / segment_frames, segment_count - 1);
+		const float local_frame = frame - float(segment * segment_frames);
+
+		// Walk the segment once, tracks are stored back to back
+		const uint16_t* cursor = keys.data() + segment_offsets[segment];
+
+		for (const auto& track : tracks)
+		{
+			/* Find Keys */
+
+			const uint32_t key_count = cursor[0];
+			const uint16_t* const frames = cursor + 1;
+			const uint16_t* const values = frames + key_count;
+			cursor = values + key_count * 3;
+
+			// Segments hold few keys, a linear scan beats a binary search
+			uint32_t lower = 0;
+			while (lower + 1 < key_count && float(frames[lower + 1]) <= local_frame) lower++;
+			const uint32_t upper = std::min(lower + 1, key_count - 1);
+
+			const float alpha = upper != lower && !track.step
+				? (local_frame - float(frames[lower])) / float(frames[upper] - frames[lower])
+				: 0.0f;
+
+			/* Decode */
+
+			switch (track.path)
+			{
+			case TargetPath::Translation:
+				overrides[track.target_node].translation = interpolate(
+					dequantize(values + lower * 3, track.range_min, track.range_step),
+					dequantize(values + upper * 3, track.range_min, track.range_step),
+					alpha
+				);
+				break;
+			case TargetPath::Rotation:
+				overrides[track.target_node].rotation =
+					interpolate(dequantize(values + lower * 3), dequantize(values + upper * 3), alpha);
+				break;
+			case TargetPath::Scale:
+				overrides[track.target_node].scale = interpolate(
+					dequantize(values + lower * 3, track.range_min, track.range_step),
+					dequantize(values + upper * 3, track.range_min, track.range_step),
+					alpha
+				);
+				break;
+			}
+		}
+	}
+
+	std::vector<uint32_t> AnimationClip::get_target_nodes() const noexcept
+	{
+		return tracks | std::views::transform(&Track::target_node) | std::ranges::to<std::vector>();
+	}
+
+	size_t AnimationClip::get_byte_size() const noexcept
+	{
+		return tracks.size() * sizeof(Track)
+			+ segment_offsets.size() * sizeof(uint32_t)
+			+ keys.size() * sizeof(uint16_t);
+	}
+}
@@ -2,6 +2,8 @@
 
 #include "gltf/detail/animation/channels.hpp"
 
+#include <ranges>
+
 namespace gltf
 {
 	static std::expected<std::unique_ptr<detail::animation::Channel>, util::Error> parse_channel(
@@ -76,8 +78,32 @@ namespace gltf
 		);
 	}
 
+	void Animation::compress(std::span<const float> node_reach, const AnimationClip::Config& config) noexcept
+	{
+		if (clip.has_value()) return;
+
+		clip = AnimationClip::compress(channels, node_reach, config);
+		channels.clear();
+		channels.shrink_to_fit();
+	}
+
+	std::vector<uint32_t> Animation::get_target_nodes() const noexcept
+	{
+		if (clip.has_value()) return clip->get_target_nodes();
+
+		return channels
+			| std::views::transform([](const auto& channel) { return channel->get_target_node(); })
+			| std::ranges::to<std::vector>();
+	}
+
 	void Animation::apply(std::span<Node::TransformOverride> overrides, float time) const noexcept
 	{
+		if (clip.has_value())
+		{
+			clip->apply(overrides, time);
+			return;
+		}
+
 		for (const auto& channel : channels) channel->apply(overrides, time);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,363 @@
+#include "gltf/dedup.hpp"
+
+#include "util/as-byte.hpp"
+#include "util/hash.hpp"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <utility>
+
+namespace gltf
+{
+	// Map every element to the first earlier element with the same key that `equal` confirms. Elements
+	// without a key are kept unique.
+	template <typename Key>
+	static DedupMap build_dedup_map(
+		const std::vector<std::optional<Key>>& keys,
+		const auto& equal,
+		const auto& element_bytes
+	) noexcept
+	{
+		DedupMap result{.remap = std::vector<uint32_t>(keys.size()), .summary = {}};
+		std::map<Key, std::vector<uint32_t>> candidates;
+
+		for (const auto [idx, key] : keys | std::views::enumerate)
+		{
+			const auto index = uint32_t(idx);
+			result.remap[index] = index;
+
+			if (!key.has_value()) continue;
+
+			auto& bucket = candidates[*key];
+			const auto found =
+				std::ranges::find_if(bucket, [&](uint32_t candidate) { return equal(candidate, index); });
+
+			if (found == bucket.end())
+			{
+				bucket.push_back(index);
+				continue;
+			}
+
+			result.remap[index] = *found;
+			result.summary.duplicates++;
+			result.summary.saved_bytes += element_bytes(index);
+		}
+
+		return result;
+	}
+
+	std::vector<uint32_t> DedupMap::compact_remap() const noexcept
+	{
+		std::vector<uint32_t> compact(remap.size());
+		uint32_t unique_count = 0;
+
+		// Canonical elements always precede their duplicates
+		for (const auto [index, canonical] : remap | std::views::enumerate)
+			compact[index] = canonical == uint32_t(index) ? unique_count++ : compact[canonical];
+
+		return compact;
+	}
+
+	std::vector<uint32_t> DedupMap::canonical_indices() const noexcept
+	{
+		return std::views::iota(0u, uint32_t(remap.size()))
+			| std::views::filter([this](uint32_t index) { return is_canonical(index); })
+			| std::ranges::to<std::vector>();
+	}
+
+	DedupMap dedup_images(const tinygltf::Model& model) noexcept
+	{
+		const auto keys =
+			model.images
+			| std::views::transform([](const tinygltf::Image& image) -> std::optional<uint64_t> {
+				  if (image.image.empty()) return std::nullopt;
+
+				  const auto format =
+					  std::array{image.width, image.height, image.component, image.bits, image.pixel_type};
+				  const uint64_t format_hash = util::hash_bytes(util::as_bytes(format));
+				  return util::hash_bytes(util::as_bytes(image.image), format_hash);
+			  })
+			| std::ranges::to<std::vector>();
+
+		// Confirm by full comparison, images are cheap to compare relative to decoding and compressing
+		const auto equal = [&model](uint32_t a, uint32_t b) {
+			const auto& image_a = model.images[a];
+			const auto& image_b = model.images[b];
+
+			return image_a.width == image_b.width
+				&& image_a.height == image_b.height
+				&& image_a.component == image_b.component
+				&& image_a.bits == image_b.bits
+				&& image_a.pixel_type == image_b.pixel_type
+				&& image_a.image == image_b.image;
+		};
+
+		return build_dedup_map(keys, equal, [&model](uint32_t index) {
+			return model.images[index].image.size();
+		});
+	}
+
+	namespace
+	{
+		struct ContentDigest
+		{
+			uint64_t hash;
+			size_t bytes;
+		};
+
+		// Bytes read by an accessor, elements are `element_size` bytes apart by `stride`
+		struct AccessorBytes
+		{
+			std::span<const std::byte> data;
+			size_t stride;
+			size_t element_size;
+			size_t count;
+			std::array<int, 3> layout;  // Component type, type and normalized flag
+
+			std::span<const std::byte> element(size_t index) const noexcept
+			{
+				return data.subspan(index * stride, element_size);
+			}
+
+			bool operator==(const AccessorBytes& other) const noexcept
+			{
+				if (layout != other.layout || count != other.count || element_size != other.element_size)
+					return false;
+
+				if (stride == element_size && other.stride == element_size)
+					return std::ranges::equal(data, other.data);
+
+				return std::ranges::all_of(std::views::iota(0zu, count), [&](size_t index) {
+					return std::ranges::equal(element(index), other.element(index));
+				});
+			}
+		};
+
+		// Resolves and hashes accessor content, memoized since duplicated meshes often share accessors
+		class AccessorContent
+		{
+			const tinygltf::Model& model;
+			std::vector<std::optional<std::optional<ContentDigest>>> cache;
+
+			std::optional<ContentDigest> compute(int accessor_index) const noexcept;
+
+		  public:
+
+			explicit AccessorContent(const tinygltf::Model& model) noexcept :
+				model(model),
+				cache(model.accessors.size())
+			{}
+
+			// Get bytes read by an accessor, or nullopt if it is sparse or invalid
+			std::optional<AccessorBytes> bytes(int accessor_index) const noexcept;
+
+			// Get digest of an accessor, or nullopt if it is sparse or invalid
+			std::optional<ContentDigest> digest(int accessor_index) noexcept
+			{
+				if (accessor_index < 0 || std::cmp_greater_equal(accessor_index, model.accessors.size()))
+					return std::nullopt;
+
+				auto& entry = cache[accessor_index];
+				if (!entry.has_value()) entry = compute(accessor_index);
+
+				return *entry;
+			}
+
+			// Compare the content of two accessors, sharing an accessor is trivially equal
+			bool equal(int accessor_a, int accessor_b) const noexcept
+			{
+				if (accessor_a == accessor_b) return true;
+
+				const auto bytes_a = bytes(accessor_a);
+				const auto bytes_b = bytes(accessor_b);
+				return bytes_a.has_value() && bytes_b.has_value() && *bytes_a == *bytes_b;
+			}
+		};
+
+		std::optional<AccessorBytes> AccessorContent::bytes(int accessor_index) const noexcept
+		{
+			if (accessor_index < 0 || std::cmp_greater_equal(accessor_index, model.accessors.size()))
+				return std::nullopt;
+
+			const auto& accessor = model.accessors[accessor_index];
+
+			if (accessor.sparse.isSparse) return std::nullopt;
+			if (accessor.bufferView < 0
+				|| std::cmp_greater_equal(accessor.bufferView, model.bufferViews.size()))
+				return std::nullopt;
+
+			const auto& buffer_view = model.bufferViews[accessor.bufferView];
+			if (buffer_view.buffer < 0 || std::cmp_greater_equal(buffer_view.buffer, model.buffers.size()))
+				return std::nullopt;
+
+			const auto& buffer = model.buffers[buffer_view.buffer];
+
+			const int component_size = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+			const int component_count = tinygltf::GetNumComponentsInType(accessor.type);
+			const int byte_stride = accessor.ByteStride(buffer_view);
+			if (component_size <= 0 || component_count <= 0 || byte_stride <= 0) return std::nullopt;
+
+			const size_t element_size = size_t(component_size) * size_t(component_count);
+			const size_t stride = size_t(byte_stride);
+			const size_t span_size = accessor.count == 0 ? 0 : stride * (accessor.count - 1) + element_size;
+
+			const size_t begin = buffer_view.byteOffset + accessor.byteOffset;
+			if (accessor.byteOffset + span_size > buffer_view.byteLength
+				|| begin + span_size > buffer.data.size())
+				return std::nullopt;
+
+			return AccessorBytes{
+				.data = std::as_bytes(std::span(buffer.data)).subspan(begin, span_size),
+				.stride = stride,
+				.element_size = element_size,
+				.count = accessor.count,
+				.layout = {accessor.componentType, accessor.type, int(accessor.normalized)}
+			};
+		}
+
+		std::optional<ContentDigest> AccessorContent::compute(int accessor_index) const noexcept
+		{
+			const auto accessor_bytes = bytes(accessor_index);
+			if (!accessor_bytes.has_value()) return std::nullopt;
+
+			const size_t count = accessor_bytes->count;
+
+			// Layout is part of the key, so equal bytes read as different types don't collide
+			const uint64_t seed = util::hash_bytes(util::as_bytes(accessor_bytes->layout), count);
+
+			if (accessor_bytes->stride == accessor_bytes->element_size)
+				return ContentDigest{
+					.hash = util::hash_bytes(accessor_bytes->data, seed),
+					.bytes = accessor_bytes->data.size()
+				};
+
+			// Gather interleaved elements, bytes between elements are not part of the content
+			std::vector<std::byte> packed;
+			packed.reserve(accessor_bytes->element_size * count);
+			for (const size_t element : std::views::iota(0zu, count))
+				packed.append_range(accessor_bytes->element(element));
+
+			return ContentDigest{.hash = util::hash_bytes(packed, seed), .bytes = packed.size()};
+		}
+
+		// Hash all primitives of a mesh, or nullopt if the mesh must stay unique
+		std::optional<ContentDigest> hash_mesh(const tinygltf::Mesh& mesh, AccessorContent& content) noexcept
+		{
+			ContentDigest digest{
+				.hash = util::hash_bytes(util::as_bytes(mesh.primitives.size())),
+				.bytes = 0
+			};
+
+			const auto add_accessor = [&content, &digest](int accessor_index) {
+				const auto accessor = content.digest(accessor_index);
+				if (!accessor.has_value()) return false;
+
+				digest.hash = util::hash_bytes(util::as_bytes(accessor->hash), digest.hash);
+				digest.bytes += accessor->bytes;
+				return true;
+			};
+
+			for (const auto& primitive : mesh.primitives)
+			{
+				if (!primitive.targets.empty()) return std::nullopt;
+
+				const auto header = std::array{
+					primitive.mode,
+					primitive.material,
+					primitive.indices >= 0 ? 1 : 0,
+					int(primitive.attributes.size())
+				};
+				digest.hash = util::hash_bytes(util::as_bytes(header), digest.hash);
+
+				if (primitive.indices >= 0 && !add_accessor(primitive.indices)) return std::nullopt;
+
+				// `attributes` is an ordered map, iteration order is stable
+				for (const auto& [name, accessor_index] : primitive.attributes)
+				{
+					digest.hash = util::hash_bytes(util::as_bytes(name), digest.hash);
+					if (!add_accessor(accessor_index)) return std::nullopt;
+				}
+			}
+
+			return digest;
+		}
+
+		// Compare two hashable meshes primitive by primitive, including every accessor byte they read
+		bool equal_mesh(
+			const tinygltf::Mesh& mesh_a,
+			const tinygltf::Mesh& mesh_b,
+			const AccessorContent& content
+		) noexcept
+		{
+			using Primitive = tinygltf::Primitive;
+
+			const auto equal_primitive = [&content](const Primitive& a, const Primitive& b) {
+				if (a.mode != b.mode || a.material != b.material) return false;
+				if ((a.indices >= 0) != (b.indices >= 0)) return false;
+				if (a.indices >= 0 && !content.equal(a.indices, b.indices)) return false;
+
+				return std::ranges::equal(
+					a.attributes,
+					b.attributes,
+					[&content](const auto& attribute_a, const auto& attribute_b) {
+						return attribute_a.first == attribute_b.first
+							&& content.equal(attribute_a.second, attribute_b.second);
+					}
+				);
+			};
+
+			return std::ranges::equal(mesh_a.primitives, mesh_b.primitives, equal_primitive);
+		}
+	}
+
+	DedupMap dedup_meshes(const tinygltf::Model& model) noexcept
+	{
+		AccessorContent content(model);
+
+		const auto digests =
+			model.meshes
+			| std::views::transform([&content](const tinygltf::Mesh& mesh) {
+				  return hash_mesh(mesh, content);
+			  })
+			| std::ranges::to<std::vector>();
+
+		const auto keys =
+			digests
+			| std::views::transform([](const std::optional<ContentDigest>& digest) {
+				  return digest.transform([](const ContentDigest& value) {
+					  return std::pair(value.hash, value.bytes);
+				  });
+			  })
+			| std::ranges::to<std::vector>();
+
+		// Confirm by full comparison of the accessor bytes, a hash match alone may be a collision
+		const auto equal = [&model, &content](uint32_t a, uint32_t b) {
+			return equal_mesh(model.meshes[a], model.meshes[b], content);
+		};
+
+		return build_dedup_map(keys, equal, [&digests](uint32_t index) { return digests[index]->bytes; });
+	}
+
+	DedupMap dedup_samplers(const tinygltf::Model& model) noexcept
+	{
+		using Descriptor = std::tuple<int, int, int, int>;
+
+		const auto keys =
+			model.samplers
+			| std::views::transform([](const tinygltf::Sampler& sampler) -> std::optional<Descriptor> {
+				  return Descriptor{sampler.minFilter, sampler.magFilter, sampler.wrapS, sampler.wrapT};
+			  })
+			| std::ranges::to<std::vector>();
+
+		return build_dedup_map(
+			keys,
+			[](uint32_t, uint32_t) { return true; },
+			[](uint32_t) { return 0zu; }
+		);
+	}
+}
@@ -1,16 +1,20 @@
 #include "gltf/image.hpp"
 
 #include "graphics/util/quick-create.hpp"
+#include "image/algo/analyze.hpp"
 #include "image/algo/mipmap.hpp"
 #include "image/compress.hpp"
 
-#include "gltf/detail/image/check.hpp"
 #include "gltf/detail/image/extract.hpp"
 
+#include <ranges>
+
 namespace gltf
 {
 	using namespace detail::image;
 
+	using Rgba8_image = image::Image<image::Precision::U8, image::Format::RGBA>;
+
 	static auto create_texture_from_mipmap_fn(
 		SDL_GPUDevice* device,
 		SDL_GPUTextureFormat format,
@@ -31,113 +35,56 @@ namespace gltf
 		};
 	}
 
-	template <typename T>
-	static std::function<std::expected<gpu::Texture, util::Error>(const image::ImageContainer<T>&)>
-	create_texture_from_image_fn(
-		SDL_GPUDevice* device,
-		SDL_GPUTextureFormat format,
-		const std::string& name
-	) noexcept
-	{
-		return [device, format, name](const image::ImageContainer<T>& image) {
-			return graphics::create_texture_from_image(
-				device,
-				gpu::Texture::Format{
-					.type = SDL_GPU_TEXTURETYPE_2D,
-					.format = format,
-					.usage = {.sampler = true}
-				},
-				image,
-				name
-			);
-		};
-	}
-
 	static std::expected<gpu::Texture, util::Error> create_color_uncompressed(
 		SDL_GPUDevice* device,
-		const tinygltf::Image& image,
+		const Rgba8_image& image,
 		bool srgb,
 		const std::string& name
 	) noexcept
 	{
-		return extract_u8_rgba(image)
-			.transform([](const auto& uncompressed_image) {
-				return image::generate_mipmap(uncompressed_image);
-			})
-			.and_then(create_texture_from_mipmap_fn(
-				device,
-				srgb ? SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
-				name
-			))
+		const auto format =
+			srgb ? SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+
+		return create_texture_from_mipmap_fn(device, format, name)(image::generate_mipmap(image))
 			.transform_error(util::Error::forward_fn());
 	}
 
-	static std::expected<gpu::Texture, util::Error> create_color_bc3(
+	template <typename Block>
+	using Compress_fn = std::expected<image::ImageContainer<Block>, util::Error> (*)(const Rgba8_image&);
+
+	// Compress a mip chain of the image, `base_level` replaces the compressed base level if present
+	template <typename Block>
+	static std::expected<gpu::Texture, util::Error> create_color_compressed(
 		SDL_GPUDevice* device,
-		const tinygltf::Image& image,
-		bool srgb,
+		const Rgba8_image& image,
+		Compress_fn<Block> compress,
+		std::optional<image::ImageContainer<Block>> base_level,
+		SDL_GPUTextureFormat format,
 		const std::string& name
 	) noexcept
 	{
-		const auto image_size = glm::u32vec2(uint32_t(image.width), uint32_t(image.height));
-		const auto format =
-			srgb ? SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM;
-
-		if (!image_size_multiple_of_block(image_size))
-		{
-			return create_color_uncompressed(device, image, srgb, name)
-				.transform_error(util::Error::forward_fn());
-		}
+		const auto mipmap = image::generate_mipmap(image, {4, 4});
+		const size_t first_level = base_level.has_value() ? 1 : 0;
 
-		if (!image_power_of_2(image_size))
-		{
-			return extract_u8_rgba(image)
-				.and_then(image::compress_to_bc3)
-				.and_then(create_texture_from_image_fn<image::CompressionBlock>(device, format, name))
-				.transform_error(util::Error::forward_fn());
-		}
+		auto compressed = image::CompressMipmap<glm::u8vec4, Block>(compress)(
+			std::span(mipmap).subspan(first_level)
+		);
+		if (!compressed) return compressed.error().forward("Compress mipmap failed");
+		if (base_level.has_value()) compressed->insert(compressed->begin(), std::move(*base_level));
 
-		return extract_u8_rgba(image)
-			.transform([](const auto& uncompressed_image) {
-				return image::generate_mipmap(uncompressed_image, {4, 4});
-			})
-			.and_then(image::CompressMipmap(image::compress_to_bc3))
-			.and_then(create_texture_from_mipmap_fn(device, format, name))
+		return create_texture_from_mipmap_fn(device, format, name)(*compressed)
 			.transform_error(util::Error::forward_fn());
 	}
 
-	static std::expected<gpu::Texture, util::Error> create_color_bc7(
-		SDL_GPUDevice* device,
-		const tinygltf::Image& image,
-		bool srgb,
-		const std::string& name
+	// Take the base level encoded during selection, if it has the block type of the selected mode
+	template <typename Block>
+	static std::optional<image::ImageContainer<Block>> take_base_level(ColorCompressSelection& selection
 	) noexcept
 	{
-		const auto image_size = glm::u32vec2(uint32_t(image.width), uint32_t(image.height));
-		const auto format =
-			srgb ? SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM;
+		auto* const base_level = std::get_if<image::ImageContainer<Block>>(&selection.base_level);
+		if (base_level == nullptr) return std::nullopt;
 
-		if (!image_size_multiple_of_block(image_size))  // No compress, no mipmaps
-		{
-			return create_color_uncompressed(device, image, srgb, name)
-				.transform_error(util::Error::forward_fn());
-		}
-
-		if (!image_power_of_2(image_size))
-		{
-			return extract_u8_rgba(image)
-				.and_then(image::compress_to_bc7)
-				.and_then(create_texture_from_image_fn<image::CompressionBlock>(device, format, name))
-				.transform_error(util::Error::forward_fn());
-		}
-
-		return extract_u8_rgba(image)
-			.transform([](const auto& uncompressed_image) {
-				return image::generate_mipmap(uncompressed_image, {4, 4});
-			})
-			.and_then(image::CompressMipmap(image::compress_to_bc7))
-			.and_then(create_texture_from_mipmap_fn(device, format, name))
-			.transform_error(util::Error::forward_fn());
+		return std::move(*base_level);
 	}
 
 	static std::expected<gpu::Texture, util::Error> create_normal_8bit(
@@ -147,58 +94,6 @@ namespace gltf
 		const std::string& name
 	) noexcept
 	{
-		const auto image_size = glm::u32vec2(uint32_t(image.width), uint32_t(image.height));
-
-		if (!image_size_multiple_of_block(image_size))
-		{
-			return extract_u8_rgba(image)
-				.transform([](const auto& img) {
-					return img.map([](const glm::u8vec4& pixel) -> glm::u8vec2 {
-						return {pixel.r, pixel.g};
-					});
-				})
-				.and_then(
-					create_texture_from_image_fn<glm::u8vec2>(device, SDL_GPU_TEXTUREFORMAT_R8G8_UNORM, name)
-				)
-				.transform_error(util::Error::forward_fn());
-		}
-
-		// Non Power-of-two textures are not compressed and mipmapped
-		if (!image_power_of_2(image_size))
-		{
-			if (compress)  // Compress, no mipmaps
-			{
-				return extract_u8_rgba(image)
-					.and_then(image::compress_to_bc5)
-					.and_then(
-						create_texture_from_image_fn<image::CompressionBlock>(
-							device,
-							SDL_GPU_TEXTUREFORMAT_BC5_RG_UNORM,
-							name
-						)
-					)
-					.transform_error(util::Error::forward_fn());
-			}
-			else  // No compress, no mipmaps
-			{
-				return extract_u8_rgba(image)
-					.transform([](const auto& img) {
-						return img.map([](const glm::u8vec4& pixel) -> glm::u8vec2 {
-							return {pixel.r, pixel.g};
-						});
-					})
-					.and_then(
-						create_texture_from_image_fn<glm::u8vec2>(
-							device,
-							SDL_GPU_TEXTUREFORMAT_R8G8_UNORM,
-							name
-						)
-					)
-					.transform_error(util::Error::forward_fn());
-			}
-		}
-
-		// Power-of-two textures can be compressed
 		if (compress)
 		{
 			return extract_u8_rgba(image)
@@ -228,67 +123,6 @@ namespace gltf
 		const std::string& name
 	) noexcept
 	{
-		const auto image_size = glm::u32vec2(uint32_t(image.width), uint32_t(image.height));
-
-		if (!image_size_multiple_of_block(image_size))
-		{
-			return extract_u16_rgba(image)
-				.transform([](const auto& image) {
-					return image.map([](const glm::u16vec4& pixel) -> glm::u16vec2 {
-						return {pixel.r, pixel.g};
-					});
-				})
-				.and_then(
-					create_texture_from_image_fn<glm::u16vec2>(
-						device,
-						SDL_GPU_TEXTUREFORMAT_R16G16_UNORM,
-						name
-					)
-				)
-				.transform_error(util::Error::forward_fn());
-		}
-
-		// Non Power-of-two textures
-		if (!image_power_of_2(image_size))
-		{
-			if (compress)  // Compress, no mipmaps
-			{
-				return extract_u16_rgba(image)
-					.transform([&](const auto& img) {
-						return img.map([](const glm::u16vec4& pixel) {
-							return glm::u8vec4(pixel / uint16_t(256));
-						});
-					})
-					.and_then(image::compress_to_bc5)
-					.and_then(
-						create_texture_from_image_fn<image::CompressionBlock>(
-							device,
-							SDL_GPU_TEXTUREFORMAT_BC5_RG_UNORM,
-							name
-						)
-					)
-					.transform_error(util::Error::forward_fn());
-			}
-			else  // No compress, no mipmaps
-			{
-				return extract_u16_rgba(image)
-					.transform([](const auto& image) {
-						return image.map([](const glm::u16vec4& pixel) -> glm::u16vec2 {
-							return {pixel.r, pixel.g};
-						});
-					})
-					.and_then(
-						create_texture_from_image_fn<glm::u16vec2>(
-							device,
-							SDL_GPU_TEXTUREFORMAT_R16G16_UNORM,
-							name
-						)
-					)
-					.transform_error(util::Error::forward_fn());
-			}
-		}
-
-		// Power-of-two textures can be compressed
 		if (compress)
 		{
 			return extract_u16_rgba(image)
@@ -323,19 +157,218 @@ namespace gltf
 		const std::string& name
 	) noexcept
 	{
-		switch (compress_mode)
+		const auto src_image = extract_u8_rgba(image);
+		if (!src_image) return src_image.error().forward("Extract image failed");
+
+		return create_color_texture_from_image(device, *src_image, compress_mode, srgb, name);
+	}
+
+	std::expected<gpu::Texture, util::Error> create_color_texture_from_image(
+		SDL_GPUDevice* device,
+		const Rgba8_image& image,
+		ColorCompressMode compress_mode,
+		bool srgb,
+		const std::string& name
+	) noexcept
+	{
+		return create_color_texture_from_image(
+			device,
+			image,
+			ColorCompressSelection{.mode = compress_mode},
+			srgb,
+			name
+		);
+	}
+
+	std::expected<gpu::Texture, util::Error> create_color_texture_from_image(
+		SDL_GPUDevice* device,
+		const Rgba8_image& image,
+		ColorCompressSelection selection,
+		bool srgb,
+		const std::string& name
+	) noexcept
+	{
+		switch (selection.mode)
 		{
 		case ColorCompressMode::RGBA8_raw:
 			return create_color_uncompressed(device, image, srgb, name);
 		case ColorCompressMode::RGBA8_BC3:
-			return create_color_bc3(device, image, srgb, name);
+			return create_color_compressed<image::CompressionBlock>(
+				device,
+				image,
+				image::compress_to_bc3,
+				take_base_level<image::CompressionBlock>(selection),
+				srgb ? SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM,
+				name
+			);
 		case ColorCompressMode::RGBA8_BC7:
-			return create_color_bc7(device, image, srgb, name);
+			return create_color_compressed<image::CompressionBlock>(
+				device,
+				image,
+				image::compress_to_bc7,
+				take_base_level<image::CompressionBlock>(selection),
+				srgb ? SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM,
+				name
+			);
+		case ColorCompressMode::RGB8_BC1:
+			return create_color_compressed<image::CompressionBlock4bpp>(
+				device,
+				image,
+				image::compress_to_bc1,
+				take_base_level<image::CompressionBlock4bpp>(selection),
+				srgb ? SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM,
+				name
+			);
+		case ColorCompressMode::R8_BC4:
+			return create_color_compressed<image::CompressionBlock4bpp>(
+				device,
+				image,
+				image::compress_to_bc4,
+				take_base_level<image::CompressionBlock4bpp>(selection),
+				SDL_GPU_TEXTUREFORMAT_BC4_R_UNORM,
+				name
+			);
+		case ColorCompressMode::RG8_BC5:
+			return create_color_compressed<image::CompressionBlock>(
+				device,
+				image,
+				image::compress_to_bc5,
+				take_base_level<image::CompressionBlock>(selection),
+				SDL_GPU_TEXTUREFORMAT_BC5_RG_UNORM,
+				name
+			);
 		}
 
 		std::unreachable();
 	}
 
+	std::expected<ColorCompressSelection, util::Error> select_color_compress_mode(
+		const Rgba8_image& src_image,
+		glm::bvec4 used_channels,
+		bool srgb,
+		ColorCompressMode fallback_mode,
+		float min_psnr
+	) noexcept
+	{
+		const auto fallback = ColorCompressSelection{.mode = fallback_mode};
+		if (fallback_mode == ColorCompressMode::RGBA8_raw) return fallback;
+
+		const auto analysis = image::analyze_channels(src_image);
+		const auto constant = analysis.constant();
+
+		// BC1/BC4/BC5 decode alpha as 255
+		const bool alpha_free = !used_channels.a || analysis.opaque();
+
+		// BC4 is sampled with R broadcast to RGB, exact for grayscale content or when G and B are unread
+		const bool single_channel = analysis.grayscale || (!used_channels.g && !used_channels.b);
+
+		// BC5 decodes B as 0
+		const bool blue_free = !used_channels.b || (constant.b && analysis.min_value.b == 0);
+
+		// Channels whose decoded value can differ from the source, alpha is exact whenever it is free
+		const glm::bvec4 compared_channels(used_channels.r, used_channels.g, used_channels.b, false);
+
+		// Encode the base level, keep it if the decoded image reaches `min_psnr` over the compared channels
+		const auto evaluate = [&src_image, min_psnr](
+								  ColorCompressMode mode,
+								  const auto& compress,
+								  const auto& decode,
+								  glm::bvec4 channels
+							  ) -> std::expected<std::optional<ColorCompressSelection>, util::Error> {
+			auto compressed = compress(src_image);
+			if (!compressed) return compressed.error().forward("Compress failed");
+
+			if (glm::any(channels))
+			{
+				const auto decoded = decode(*compressed);
+				if (!decoded) return decoded.error().forward("Decode failed");
+
+				const auto psnr = image::compute_psnr(src_image, *decoded, channels);
+				if (!psnr) return psnr.error().forward("Compute PSNR failed");
+
+				if (*psnr < min_psnr) return std::nullopt;
+			}
+
+			return ColorCompressSelection{.mode = mode, .base_level = std::move(*compressed)};
+		};
+
+		if (!srgb && alpha_free && single_channel)
+		{
+			// Decode as sampled by shaders, R broadcast to RGB
+			const auto decode_broadcast = [](const image::BCImage4bpp& compressed) {
+				return image::decode_bc4(compressed).transform([](Rgba8_image decoded) {
+					for (auto& pixel : decoded.pixels) pixel = glm::u8vec4(pixel.r, pixel.r, pixel.r, 255);
+					return decoded;
+				});
+			};
+
+			auto bc4 = evaluate(
+				ColorCompressMode::R8_BC4,
+				image::compress_to_bc4,
+				decode_broadcast,
+				compared_channels
+			);
+			if (!bc4) return bc4.error().forward("Evaluate BC4 failed");
+			if (bc4->has_value()) return std::move(**bc4);
+		}
+
+		if (alpha_free)
+		{
+			auto bc1 = evaluate(
+				ColorCompressMode::RGB8_BC1,
+				image::compress_to_bc1,
+				image::decode_bc1,
+				compared_channels
+			);
+			if (!bc1) return bc1.error().forward("Evaluate BC1 failed");
+			if (bc1->has_value()) return std::move(**bc1);
+		}
+
+		if (!srgb && alpha_free && blue_free)
+		{
+			auto bc5 = evaluate(
+				ColorCompressMode::RG8_BC5,
+				image::compress_to_bc5,
+				image::decode_bc5,
+				glm::bvec4(used_channels.r, used_channels.g, false, false)
+			);
+			if (!bc5) return bc5.error().forward("Evaluate BC5 failed");
+			if (bc5->has_value()) return std::move(**bc5);
+		}
+
+		return fallback;
+	}
+
+	std::expected<Rgba8_image, util::Error> pack_orm_image(
+		const tinygltf::Image& occlusion,
+		const tinygltf::Image& metallic_roughness
+	) noexcept
+	{
+		auto occlusion_image = extract_u8_rgba(occlusion);
+		if (!occlusion_image) return occlusion_image.error().forward("Extract occlusion image failed");
+
+		const auto metallic_roughness_image = extract_u8_rgba(metallic_roughness);
+		if (!metallic_roughness_image)
+			return metallic_roughness_image.error().forward("Extract metallic-roughness image failed");
+
+		if (occlusion_image->size != metallic_roughness_image->size)
+			return util::Error(
+				std::format(
+					"Image size mismatch: occlusion {}x{} vs metallic-roughness {}x{}",
+					occlusion_image->size.x,
+					occlusion_image->size.y,
+					metallic_roughness_image->size.x,
+					metallic_roughness_image->size.y
+				)
+			);
+
+		// Pack in place: R stays occlusion, G/B are taken from metallic-roughness
+		for (auto [dst, src] : std::views::zip(occlusion_image->pixels, metallic_roughness_image->pixels))
+			dst = glm::u8vec4(dst.r, src.g, src.b, 255);
+
+		return occlusion_image;
+	}
+
 	std::expected<gpu::Texture, util::Error> create_normal_texture_from_image(
 		SDL_GPUDevice* device,
 		const tinygltf::Image& image,
@@ -0,0 +1,90 @@
+#include "gltf/instance.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <ranges>
+
+namespace gltf
+{
+	std::expected<void, util::Error> DeferredInstanceResource::prepare_gpu_buffers(
+		graphics::BufferPool& buffer_pool,
+		graphics::TransferBufferPool& transfer_pool
+	) noexcept
+	{
+		if (upload_buffer || instance_buffer)
+			return util::Error("GPU buffers for instances already prepared");
+
+		const uint32_t buffer_size = get_buffer_size();
+
+		const auto upload_buffer_result =
+			transfer_pool.acquire_buffer(gpu::TransferBuffer::Usage::Upload, buffer_size);
+		if (!upload_buffer_result)
+			return upload_buffer_result.error().forward("Acquire transfer buffer for instances failed");
+
+		const auto buffer_result = buffer_pool.acquire_buffer({.graphic_storage_read = true}, buffer_size);
+		if (!buffer_result) return buffer_result.error().forward("Acquire buffer for instances failed");
+
+		upload_buffer = *upload_buffer_result;
+		instance_buffer = *buffer_result;
+
+		const auto transfer_result = upload_buffer->transfer(
+			[this, buffer_size](void* mapped_ptr) { std::memcpy(mapped_ptr, instances.data(), buffer_size); },
+			true
+		);
+		if (!transfer_result) return transfer_result.error().forward("Copy instance data failed");
+
+		return {};
+	}
+
+	void DeferredInstanceResource::upload_gpu_buffers(const gpu::CopyPass& copy_pass) noexcept
+	{
+		assert(upload_buffer != nullptr && instance_buffer != nullptr);
+
+		copy_pass.upload_to_buffer(*upload_buffer, 0, *instance_buffer, 0, get_buffer_size(), true);
+	}
+
+	void group_node_instances(
+		std::span<const uint8_t> visible,
+		std::span<const float> emission_values,
+		bool rigged,
+		std::vector<uint32_t>& instance_indices,
+		std::vector<InstanceGroup>& groups
+	) noexcept
+	{
+		assert(visible.size() == emission_values.size());
+
+		instance_indices.clear();
+		groups.clear();
+
+		for (const auto instance_index : std::views::iota(0u, uint32_t(visible.size())))
+			if (visible[instance_index] != 0) instance_indices.push_back(instance_index);
+
+		const auto multiplier = [emission_values, rigged](uint32_t instance_index) {
+			return rigged ? 1.0f : emission_values[instance_index];
+		};
+		const auto by_multiplier = [multiplier](uint32_t a, uint32_t b) {
+			return std::pair(multiplier(a), a) < std::pair(multiplier(b), b);
+		};
+
+		// Already sorted when every instance uses the same multiplier
+		if (!std::ranges::is_sorted(instance_indices, by_multiplier))
+			std::ranges::sort(instance_indices, by_multiplier);
+
+		const auto same_multiplier = [multiplier](uint32_t a, uint32_t b) {
+			return multiplier(a) == multiplier(b);
+		};
+
+		uint32_t first = 0;
+		for (const auto group : instance_indices | std::views::chunk_by(same_multiplier))
+		{
+			const auto count = uint32_t(std::ranges::distance(group));
+			groups.push_back({
+				.emissive_multiplier = multiplier(group.front()),
+				.first = first,
+				.count = count
+			});
+			first += count;
+		}
+	}
+}
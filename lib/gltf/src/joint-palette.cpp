@@ -0,0 +1,175 @@
+#include "gltf/joint-palette.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <glm/gtc/quaternion.hpp>
+#include <immintrin.h>
+#include <limits>
+#include <ranges>
+
+namespace gltf
+{
+	namespace
+	{
+#ifdef __AVX2__
+		// Columns of `a * b`, as the pairs (0, 1) and (2, 3)
+		std::array<__m256, 2> multiply_columns(const glm::mat4& a, const glm::mat4& b) noexcept
+		{
+			const float* const a_data = &a[0][0];
+			const float* const b_data = &b[0][0];
+
+			// Columns of `a`, repeated in both 128-bit lanes
+			const std::array<__m256, 4> a_columns = {
+				_mm256_broadcast_ps(reinterpret_cast<const __m128*>(a_data)),
+				_mm256_broadcast_ps(reinterpret_cast<const __m128*>(a_data + 4)),
+				_mm256_broadcast_ps(reinterpret_cast<const __m128*>(a_data + 8)),
+				_mm256_broadcast_ps(reinterpret_cast<const __m128*>(a_data + 12))
+			};
+
+			// Each lane holds a column of `b`, `a * column` is the sum of `a` columns scaled by its elements
+			const auto multiply_pair = [&a_columns](__m256 b_pair) {
+				__m256 result = _mm256_mul_ps(a_columns[0], _mm256_permute_ps(b_pair, 0x00));
+				result = _mm256_add_ps(result, _mm256_mul_ps(a_columns[1], _mm256_permute_ps(b_pair, 0x55)));
+				result = _mm256_add_ps(result, _mm256_mul_ps(a_columns[2], _mm256_permute_ps(b_pair, 0xAA)));
+				result = _mm256_add_ps(result, _mm256_mul_ps(a_columns[3], _mm256_permute_ps(b_pair, 0xFF)));
+				return result;
+			};
+
+			return {
+				multiply_pair(_mm256_loadu_ps(b_data)),
+				multiply_pair(_mm256_loadu_ps(b_data + 8))
+			};
+		}
+#endif
+
+		void write_matrix(std::byte* output, const glm::mat4& world, const glm::mat4& inverse_bind) noexcept
+		{
+#ifdef __AVX2__
+			const auto [columns_01, columns_23] = multiply_columns(world, inverse_bind);
+			_mm256_storeu_ps(reinterpret_cast<float*>(output), columns_01);
+			_mm256_storeu_ps(reinterpret_cast<float*>(output) + 8, columns_23);
+#else
+			const glm::mat4 joint_matrix = world * inverse_bind;
+			std::memcpy(output, &joint_matrix, sizeof(glm::mat4));
+#endif
+		}
+
+		void write_affine(std::byte* output, const glm::mat4& world, const glm::mat4& inverse_bind) noexcept
+		{
+#ifdef __AVX2__
+			const auto [columns_01, columns_23] = multiply_columns(world, inverse_bind);
+
+			__m128 column_0 = _mm256_castps256_ps128(columns_01);
+			__m128 column_1 = _mm256_extractf128_ps(columns_01, 1);
+			__m128 column_2 = _mm256_castps256_ps128(columns_23);
+			__m128 column_3 = _mm256_extractf128_ps(columns_23, 1);
+			_MM_TRANSPOSE4_PS(column_0, column_1, column_2, column_3);
+
+			// Columns now hold rows, the last row is dropped
+			float* const output_data = reinterpret_cast<float*>(output);
+			_mm_storeu_ps(output_data, column_0);
+			_mm_storeu_ps(output_data + 4, column_1);
+			_mm_storeu_ps(output_data + 8, column_2);
+#else
+			const glm::mat4 rows = glm::transpose(world * inverse_bind);
+			std::memcpy(output, &rows, sizeof(glm::vec4) * 3);
+#endif
+		}
+
+		void write_dual_quaternion(
+			std::byte* output,
+			const glm::mat4& world,
+			const glm::mat4& inverse_bind
+		) noexcept
+		{
+			glm::mat4 joint_matrix;
+
+#ifdef __AVX2__
+			const auto [columns_01, columns_23] = multiply_columns(world, inverse_bind);
+			_mm256_storeu_ps(&joint_matrix[0][0], columns_01);
+			_mm256_storeu_ps(&joint_matrix[2][0], columns_23);
+#else
+			joint_matrix = world * inverse_bind;
+#endif
+
+			const glm::mat3 linear = glm::mat3(joint_matrix);
+			const float scale = std::max(
+				(glm::length(linear[0]) + glm::length(linear[1]) + glm::length(linear[2])) / 3.0f,
+				std::numeric_limits<float>::min()
+			);
+
+			const glm::quat rotation = glm::normalize(glm::quat_cast(linear / scale));
+			const glm::vec3 translation = glm::vec3(joint_matrix[3]);
+			const glm::quat dual = glm::quat(0.0f, translation) * rotation * 0.5f;
+
+			// Scale is carried by the norm of the real part
+			const float norm = std::sqrt(scale);
+			const std::array<glm::vec4, 2> encoded = {
+				glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w) * norm,
+				glm::vec4(dual.x, dual.y, dual.z, dual.w) * norm
+			};
+			std::memcpy(output, encoded.data(), sizeof(encoded));
+		}
+
+		// Write every joint with a fixed writer, so it inlines into the loop
+		template <auto write_joint>
+		void encode_joints(
+			std::span<const glm::mat4> joint_world_matrices,
+			std::span<const glm::mat4> inverse_bind_matrices,
+			std::span<std::byte> output,
+			size_t stride
+		) noexcept
+		{
+			const size_t joint_count = std::min(joint_world_matrices.size(), inverse_bind_matrices.size());
+
+			for (const auto joint_idx : std::views::iota(0zu, joint_count))
+				write_joint(
+					output.data() + joint_idx * stride,
+					joint_world_matrices[joint_idx],
+					inverse_bind_matrices[joint_idx]
+				);
+		}
+	}
+
+	size_t get_joint_palette_stride(JointPalette palette) noexcept
+	{
+		switch (palette)
+		{
+		case JointPalette::Matrix:
+			return sizeof(glm::vec4) * 4;
+		case JointPalette::Affine:
+			return sizeof(glm::vec4) * 3;
+		case JointPalette::Dual_quaternion:
+			return sizeof(glm::vec4) * 2;
+		}
+
+		return sizeof(glm::vec4) * 4;
+	}
+
+	void encode_joint_palette(
+		JointPalette palette,
+		std::span<const glm::mat4> joint_world_matrices,
+		std::span<const glm::mat4> inverse_bind_matrices,
+		std::span<std::byte> output
+	) noexcept
+	{
+		const size_t stride = get_joint_palette_stride(palette);
+		assert(output.size() >= std::min(joint_world_matrices.size(), inverse_bind_matrices.size()) * stride);
+
+		switch (palette)
+		{
+		case JointPalette::Matrix:
+			encode_joints<write_matrix>(joint_world_matrices, inverse_bind_matrices, output, stride);
+			break;
+		case JointPalette::Affine:
+			encode_joints<write_affine>(joint_world_matrices, inverse_bind_matrices, output, stride);
+			break;
+		case JointPalette::Dual_quaternion:
+			encode_joints<write_dual_quaternion>(joint_world_matrices, inverse_bind_matrices, output, stride);
+			break;
+		}
+	}
+}
@@ -1,7 +1,9 @@
 #include "gltf/material.hpp"
+#include "gltf/detail/image/extract.hpp"
 #include "gltf/image.hpp"
 
 #include <format>
+#include <map>
 #include <ranges>
 #include <thread_pool/thread_pool.h>
 
@@ -150,34 +152,137 @@ namespace gltf
 		return mat;
 	}
 
+	std::vector<OrmPackSource> plan_orm_packs(
+		const tinygltf::Model& model,
+		std::span<const Texture> textures,
+		std::span<MaterialIndexed> materials,
+		bool merge
+	) noexcept
+	{
+		using Pack_key = std::tuple<uint32_t, uint32_t, std::optional<uint32_t>>;
+		std::map<Pack_key, uint32_t> pack_lookup;
+		std::vector<OrmPackSource> packs;
+
+		for (auto&& [material, tinygltf_material] : std::views::zip(materials, model.materials))
+		{
+			if (!material.occlusion.has_value() || !material.metallic_roughness.has_value()) continue;
+
+			// Both textures must be addressed by the same UV set and sampler
+			if (tinygltf_material.occlusionTexture.texCoord
+				!= tinygltf_material.pbrMetallicRoughness.metallicRoughnessTexture.texCoord)
+				continue;
+
+			const auto& occlusion_texture = textures[*material.occlusion];
+			const auto& metallic_roughness_texture = textures[*material.metallic_roughness];
+			if (occlusion_texture.sampler_index != metallic_roughness_texture.sampler_index) continue;
+
+			// Source asset already stores ORM in one image, no packing needed
+			if (occlusion_texture.image_index == metallic_roughness_texture.image_index)
+			{
+				material.params.factor.orm_packed = true;
+				continue;
+			}
+
+			if (!merge) continue;
+
+			const auto& occlusion_image = model.images[occlusion_texture.image_index];
+			const auto& metallic_roughness_image = model.images[metallic_roughness_texture.image_index];
+			if (occlusion_image.width != metallic_roughness_image.width
+				|| occlusion_image.height != metallic_roughness_image.height)
+				continue;
+
+			// Materials sharing the same sources share one pack
+			const auto [pack, inserted] = pack_lookup.try_emplace(
+				Pack_key{
+					occlusion_texture.image_index,
+					metallic_roughness_texture.image_index,
+					occlusion_texture.sampler_index
+				},
+				uint32_t(packs.size())
+			);
+
+			if (inserted)
+				packs.push_back(
+					OrmPackSource{
+						.occlusion_image = occlusion_texture.image_index,
+						.metallic_roughness_image = metallic_roughness_texture.image_index,
+						.sampler_index = occlusion_texture.sampler_index
+					}
+				);
+
+			material.orm_pack = pack->second;
+			material.params.factor.orm_packed = true;
+		}
+
+		return packs;
+	}
+
 	std::vector<MaterialList::ImageRefCount> MaterialList::compute_image_refcounts(
 		const tinygltf::Model& model
-	) noexcept
+	) const noexcept
 	{
 		std::vector<ImageRefCount> refcount_list(model.images.size());
 
-		const auto count_texture = [&model, &refcount_list](auto proj, const auto& texture_info) {
-			if (const auto index = texture_info.index;
-				index >= 0 && std::cmp_less(index, model.textures.size()))
-			{
-				if (const auto source = model.textures[index].source;
-					source >= 0 && std::cmp_less(source, model.images.size()))
+		// Image indices in `textures` are already validated and point to canonical (deduplicated) images
+		const auto get_source = [this](const auto& texture_info) -> std::optional<size_t> {
+			if (const auto index = texture_info.index; index >= 0 && std::cmp_less(index, textures.size()))
+				return size_t(textures[index].image_index);
+
+			return std::nullopt;
+		};
+
+		const auto count_texture = [&get_source, &refcount_list](auto proj, const auto& texture_info) {
+			if (const auto source = get_source(texture_info)) std::invoke(proj, refcount_list[*source])++;
+		};
+
+		// Record channels read by the G-buffer shaders
+		const auto mark_channels =
+			[&get_source, &refcount_list](auto proj, glm::bvec4 channels, const auto& texture_info) {
+				if (const auto source = get_source(texture_info))
 				{
-					std::invoke(proj, refcount_list[source])++;
+					auto& used_channels = std::invoke(proj, refcount_list[*source]);
+					used_channels = used_channels || channels;
 				}
-			}
-		};
+			};
 
-		for (const auto& material : model.materials)
+		for (const auto& [material, material_indexed] : std::views::zip(model.materials, materials))
 		{
-			count_texture(&ImageRefCount::color_refcount, material.pbrMetallicRoughness.baseColorTexture);
-			count_texture(
-				&ImageRefCount::linear_refcount,
-				material.pbrMetallicRoughness.metallicRoughnessTexture
-			);
-			count_texture(&ImageRefCount::linear_refcount, material.occlusionTexture);
+			const auto& pbr = material.pbrMetallicRoughness;
+			const bool alpha_used = material.alphaMode != "OPAQUE";
+
+			count_texture(&ImageRefCount::color_refcount, pbr.baseColorTexture);
 			count_texture(&ImageRefCount::color_refcount, material.emissiveTexture);
 			count_texture(&ImageRefCount::normal_refcount, material.normalTexture);
+
+			mark_channels(
+				&ImageRefCount::color_channels,
+				glm::bvec4(true, true, true, alpha_used),
+				pbr.baseColorTexture
+			);
+
+			// Packed ORM textures replace both sources, see `load_orm_packs`
+			if (!material_indexed.orm_pack.has_value())
+			{
+				count_texture(&ImageRefCount::linear_refcount, pbr.metallicRoughnessTexture);
+				count_texture(&ImageRefCount::linear_refcount, material.occlusionTexture);
+
+				mark_channels(
+					&ImageRefCount::linear_channels,
+					glm::bvec4(false, true, true, false),
+					pbr.metallicRoughnessTexture
+				);
+				mark_channels(
+					&ImageRefCount::linear_channels,
+					glm::bvec4(true, false, false, false),
+					material.occlusionTexture
+				);
+			}
+
+			mark_channels(
+				&ImageRefCount::color_channels,
+				glm::bvec4(true, true, true, false),
+				material.emissiveTexture
+			);
 		}
 
 		return refcount_list;
@@ -235,32 +340,60 @@ namespace gltf
 	{
 		ImageEntry entry;
 
-		if (refcount.color_refcount > 0)
-		{
-			auto color_texture = gltf::create_color_texture_from_image(
+		// Selection encodes the base level of the chosen mode, which the created texture reuses
+		const auto load_color = [device, &image, &image_config](
+									const auto& src_image,
+									glm::bvec4 used_channels,
+									bool srgb
+								) -> std::expected<std::pair<gpu::Texture, ColorCompressMode>, util::Error> {
+			auto selection =
+				image_config.auto_select_format
+					? gltf::select_color_compress_mode(
+						  src_image,
+						  used_channels,
+						  srgb,
+						  image_config.color_mode,
+						  image_config.auto_select_min_psnr
+					  )
+					: std::expected<ColorCompressSelection, util::Error>({.mode = image_config.color_mode});
+			if (!selection) return selection.error().forward("Select compress mode failed");
+
+			const auto mode = selection->mode;
+
+			auto texture = gltf::create_color_texture_from_image(
 				device,
-				image,
-				image_config.color_mode,
-				true,
+				src_image,
+				std::move(*selection),
+				srgb,
 				std::format("GLTF Image '{}'", image.name)
 			);
-			if (!color_texture) return color_texture.error().forward("Load color image failed");
+			if (!texture) return texture.error().forward("Create texture failed");
 
-			entry.color_texture = std::move(*color_texture);
-		}
+			return std::pair(std::move(*texture), mode);
+		};
 
-		if (refcount.linear_refcount > 0)
+		if (refcount.color_refcount > 0 || refcount.linear_refcount > 0)
 		{
-			auto linear_texture = gltf::create_color_texture_from_image(
-				device,
-				image,
-				image_config.color_mode,
-				false,
-				std::format("GLTF Image '{}'", image.name)
-			);
-			if (!linear_texture) return linear_texture.error().forward("Load linear image failed");
+			const auto src_image = detail::image::extract_u8_rgba(image);
+			if (!src_image) return src_image.error().forward("Extract image failed");
+
+			if (refcount.color_refcount > 0)
+			{
+				auto color = load_color(*src_image, refcount.color_channels, true);
+				if (!color) return color.error().forward("Load color image failed");
 
-			entry.linear_texture = std::move(*linear_texture);
+				entry.color_texture = std::move(color->first);
+				entry.color_mode = color->second;
+			}
+
+			if (refcount.linear_refcount > 0)
+			{
+				auto linear = load_color(*src_image, refcount.linear_channels, false);
+				if (!linear) return linear.error().forward("Load linear image failed");
+
+				entry.linear_texture = std::move(linear->first);
+				entry.linear_mode = linear->second;
+			}
 		}
 
 		if (refcount.normal_refcount > 0)
@@ -338,26 +471,109 @@ namespace gltf
 		return {};
 	}
 
-	std::expected<void, util::Error> MaterialList::load_samplers(
+	std::expected<std::pair<gpu::Texture, ColorCompressMode>, util::Error> MaterialList::load_orm_pack_thread(
+		SDL_GPUDevice* device,
+		const tinygltf::Image& occlusion,
+		const tinygltf::Image& metallic_roughness,
+		const ImageConfig& image_config
+	) noexcept
+	{
+		const auto packed_image = gltf::pack_orm_image(occlusion, metallic_roughness);
+		if (!packed_image) return packed_image.error().forward("Pack ORM image failed");
+
+		// Alpha is unused, RGB are all read by the G-buffer shaders
+		auto selection =
+			image_config.auto_select_format
+				? gltf::select_color_compress_mode(
+					  *packed_image,
+					  glm::bvec4(true, true, true, false),
+					  false,
+					  image_config.color_mode,
+					  image_config.auto_select_min_psnr
+				  )
+				: std::expected<ColorCompressSelection, util::Error>({.mode = image_config.color_mode});
+		if (!selection) return selection.error().forward("Select ORM compress mode failed");
+
+		const auto mode = selection->mode;
+
+		auto texture = gltf::create_color_texture_from_image(
+			device,
+			*packed_image,
+			std::move(*selection),
+			false,
+			std::format("GLTF ORM '{}' + '{}'", occlusion.name, metallic_roughness.name)
+		);
+		if (!texture) return texture.error().forward("Load ORM image failed");
+
+		return std::pair(std::move(*texture), mode);
+	}
+
+	std::expected<void, util::Error> MaterialList::load_orm_packs(
+		SDL_GPUDevice* device,
+		const tinygltf::Model& model,
+		const ImageConfig& image_config
+	) noexcept
+	{
+		if (orm_packs.empty()) return {};
+
+		dp::thread_pool thread_pool(std::thread::hardware_concurrency());
+
+		// Tasks reference `model` and `image_config`, both outlive the pool
+		auto result_futures =
+			orm_packs
+			| std::views::transform([&](const OrmPack& pack) {
+				  const auto& occlusion = model.images[pack.source.occlusion_image];
+				  const auto& metallic_roughness = model.images[pack.source.metallic_roughness_image];
+
+				  return thread_pool.enqueue([device, &occlusion, &metallic_roughness, &image_config]() {
+					  return load_orm_pack_thread(device, occlusion, metallic_roughness, image_config);
+				  });
+			  })
+			| std::ranges::to<std::vector>();
+
+		thread_pool.wait_for_tasks();
+
+		for (auto [pack, future] : std::views::zip(orm_packs, result_futures))
+		{
+			auto result = future.get();
+			if (!result) return result.error().forward("Load ORM pack failed");
+
+			pack.texture = std::move(result->first);
+			pack.mode = result->second;
+		}
+
+		return {};
+	}
+
+	std::expected<std::vector<uint32_t>, util::Error> MaterialList::load_samplers(
 		SDL_GPUDevice* device,
 		const tinygltf::Model& model,
 		const SamplerConfig& sampler_config
 	) noexcept
 	{
-		samplers.reserve(model.samplers.size());
+		const auto dedup = dedup_samplers(model);
+		sampler_dedup_summary = dedup.summary;
+
+		// Only canonical samplers are created, duplicates share the slot of their canonical sampler
+		const auto canonical_indices = dedup.canonical_indices();
+		samplers.reserve(canonical_indices.size());
 
-		for (const auto& tinygltf_sampler : model.samplers)
+		for (const auto index : canonical_indices)
 		{
-			auto sampler = gltf::create_sampler(device, tinygltf_sampler, sampler_config);
+			auto sampler = gltf::create_sampler(device, model.samplers[index], sampler_config);
 			if (!sampler) return sampler.error();
 
 			samplers.emplace_back(std::move(*sampler));
 		}
 
-		return {};
+		return dedup.compact_remap();
 	}
 
-	std::expected<void, util::Error> MaterialList::load_textures(const tinygltf::Model& model) noexcept
+	std::expected<void, util::Error> MaterialList::load_textures(
+		const tinygltf::Model& model,
+		std::span<const uint32_t> image_remap,
+		std::span<const uint32_t> sampler_slots
+	) noexcept
 	{
 		textures.reserve(model.textures.size());
 
@@ -366,7 +582,7 @@ namespace gltf
 			auto texture = gltf::Texture::from_tinygltf(model, tinygltf_texture);
 			if (!texture) return texture.error().forward(std::format("Load texture at index {} failed", idx));
 
-			textures.emplace_back(*texture);
+			textures.emplace_back(texture->remap(image_remap, sampler_slots));
 		}
 
 		return {};
@@ -433,18 +649,32 @@ namespace gltf
 		result = material_list.create_default_sampler(device);
 		if (!result) return result.error().forward("Create default sampler failed");
 
-		result = material_list.load_samplers(device, model, sampler_config);
-		if (!result) return result.error().forward("Load samplers failed");
+		const auto sampler_slots = material_list.load_samplers(device, model, sampler_config);
+		if (!sampler_slots) return sampler_slots.error().forward("Load samplers failed");
+
+		// Duplicated images are never referenced by textures, so they are skipped by `load_images`
+		const auto image_dedup = dedup_images(model);
+		material_list.image_dedup_summary = image_dedup.summary;
 
-		result = material_list.load_textures(model);
+		result = material_list.load_textures(model, image_dedup.remap, *sampler_slots);
 		if (!result) return result.error().forward("Load textures failed");
 
 		result = material_list.load_materials(model);
 		if (!result) return result.error().forward("Load materials failed");
 
+		material_list.orm_packs =
+			plan_orm_packs(model, material_list.textures, material_list.materials, image_config.pack_orm)
+			| std::views::transform([](const OrmPackSource& source) {
+				  return OrmPack{.source = source, .texture = std::nullopt, .mode = std::nullopt};
+			  })
+			| std::ranges::to<std::vector>();
+
 		result = material_list.load_images(device, model, image_config, progress_callback);
 		if (!result) return result.error().forward("Load images failed");
 
+		result = material_list.load_orm_packs(device, model, image_config);
+		if (!result) return result.error().forward("Load ORM packs failed");
+
 		return material_list;
 	}
 
@@ -457,6 +687,7 @@ namespace gltf
 		std::optional<uint32_t> normal_index = std::nullopt;
 		std::optional<uint32_t> occlusion_index = std::nullopt;
 		std::optional<uint32_t> emissive_index = std::nullopt;
+		std::optional<uint32_t> orm_pack_index = std::nullopt;
 
 		MaterialGPU bind;
 
@@ -471,6 +702,7 @@ namespace gltf
 			normal_index = material.normal;
 			occlusion_index = material.occlusion;
 			emissive_index = material.emissive;
+			orm_pack_index = material.orm_pack;
 
 			bind.params = material.params;
 		}
@@ -481,17 +713,36 @@ namespace gltf
 		bind.base_color = *base_color_binding;
 
 		auto metallic_roughness_binding =
-			get_texture_sampler_binding(default_white, metallic_roughness_index, &ImageEntry::linear_texture);
+			orm_pack_index.has_value()
+				? get_orm_binding(*orm_pack_index)
+				: get_texture_sampler_binding(
+					  default_white,
+					  metallic_roughness_index,
+					  &ImageEntry::linear_texture
+				  );
 		if (!metallic_roughness_binding) return std::nullopt;
 		bind.metallic_roughness = *metallic_roughness_binding;
 
+		// BC4 textures hold grayscale or R-only data, see `select_color_compress_mode`
+		const auto metallic_roughness_mode =
+			orm_pack_index.has_value()
+				? orm_packs[*orm_pack_index].mode
+				: metallic_roughness_index.and_then([this](uint32_t texture_index) {
+					  return images[textures[texture_index].image_index].linear_mode;
+				  });
+		bind.params.factor.metallic_roughness_single_channel =
+			metallic_roughness_mode == ColorCompressMode::R8_BC4;
+
 		auto normal_binding =
 			get_texture_sampler_binding(default_normal, normal_index, &ImageEntry::normal_texture);
 		if (!normal_binding) return std::nullopt;
 		bind.normal = *normal_binding;
 
+		// Packed ORM is bound to both slots, the occlusion slot is not sampled by shaders then
 		auto occlusion_binding =
-			get_texture_sampler_binding(default_white, occlusion_index, &ImageEntry::linear_texture);
+			orm_pack_index.has_value()
+				? get_orm_binding(*orm_pack_index)
+				: get_texture_sampler_binding(default_white, occlusion_index, &ImageEntry::linear_texture);
 		if (!occlusion_binding) return std::nullopt;
 		bind.occlusion = *occlusion_binding;
 
@@ -502,4 +753,25 @@ namespace gltf
 
 		return bind;
 	}
+
+	std::optional<SDL_GPUTextureSamplerBinding> MaterialList::get_orm_binding(
+		uint32_t pack_index
+	) const noexcept
+	{
+		if (std::cmp_greater_equal(pack_index, orm_packs.size())) [[unlikely]]
+			return std::nullopt;
+
+		const auto& pack = orm_packs[pack_index];
+		if (!pack.texture.has_value()) [[unlikely]]
+			return std::nullopt;
+
+		SDL_GPUSampler* const sampler =
+			pack.source.sampler_index
+				.transform([this](uint32_t sampler_index) -> SDL_GPUSampler* {
+					return samplers[sampler_index];
+				})
+				.value_or(*default_sampler);
+
+		return SDL_GPUTextureSamplerBinding{.texture = *pack.texture, .sampler = sampler};
+	}
 }
\ No newline at end of file
@@ -13,6 +13,10 @@ namespace gltf
 
 	static constexpr float vertex_eq_thres = 0.9999f;
 
+	// Occluder meshes are rasterized on the CPU every frame, keep them small and close to the original
+	static constexpr size_t occluder_max_triangles = 256;
+	static constexpr float occluder_max_error = 0.01f;
+
 	bool Vertex::operator==(const Vertex& other) const noexcept
 	{
 		const bool position_equal = position == other.position;
@@ -235,6 +239,17 @@ namespace gltf
 		if (!shadow_index_buffer)
 			return shadow_index_buffer.error().forward("Create position index buffer failed");
 
+		auto occluder_mesh = simplify_occluder(
+			primitive.shadow_vertices,
+			primitive.shadow_indices,
+			occluder_max_triangles,
+			occluder_max_error
+		);
+
+		std::unique_ptr<const graphics::OccluderMesh> occluder;
+		if (!occluder_mesh.indices.empty())
+			occluder = std::make_unique<const graphics::OccluderMesh>(std::move(occluder_mesh));
+
 		return PrimitiveGPU{
 			.index_count = static_cast<uint32_t>(primitive.indices.size()),
 
@@ -246,7 +261,8 @@ namespace gltf
 			.material = primitive.material,
 			.position_min = primitive.position_min,
 			.position_max = primitive.position_max,
-			.rigged = false
+			.rigged = false,
+			.occluder = std::move(occluder)
 		};
 	}
 
@@ -301,7 +317,19 @@ namespace gltf
 			.material = primitive.material,
 			.position_min = primitive.position_min,
 			.position_max = primitive.position_max,
-			.rigged = true
+			.rigged = true,
+			.occluder = nullptr,
+			.skin_bound = graphics::SkinBound::build(
+				primitive.vertices
+					| std::views::transform(&RiggedVertex::position)
+					| std::ranges::to<std::vector>(),
+				primitive.vertices
+					| std::views::transform(&RiggedVertex::joint_indices)
+					| std::ranges::to<std::vector>(),
+				primitive.vertices
+					| std::views::transform(&RiggedVertex::joint_weights)
+					| std::ranges::to<std::vector>()
+			)
 		};
 	}
 
@@ -66,6 +66,60 @@ namespace gltf
 		}
 	}
 
+	void Model::compute_dynamic_nodes() noexcept
+	{
+		dynamic_nodes.assign(nodes.size(), false);
+
+		for (const auto& animation : animations)
+			for (const auto target_node : animation.get_target_nodes()) dynamic_nodes[target_node] = true;
+
+		// Propagate to descendants, parents always precede children in topological order
+		for (const auto node_index : node_topo_order)
+		{
+			const auto parent = node_parents[node_index];
+			const bool parent_dynamic = parent.has_value() && dynamic_nodes[*parent];
+
+			dynamic_nodes[node_index] =
+				dynamic_nodes[node_index] || parent_dynamic || nodes[node_index].skin.has_value();
+		}
+	}
+
+	void Model::compress_animations(const AnimationClip::Config& config) noexcept
+	{
+		std::vector<float> node_reach(nodes.size(), 0.0f);
+
+		// Children precede their parents in reverse topological order
+		for (const auto node_index : node_topo_order | std::views::reverse)
+		{
+			const auto& node = nodes[node_index];
+
+			// Reach in the local space of the node
+			float local_reach = 0.0f;
+
+			if (node.mesh.has_value())
+				for (const auto& primitive : meshes[*node.mesh].primitives)
+				{
+					const glm::vec3 corner =
+						glm::max(glm::abs(primitive.position_min), glm::abs(primitive.position_max));
+					local_reach = std::max(local_reach, glm::length(corner));
+				}
+
+			for (const auto child : node.children) local_reach = std::max(local_reach, node_reach[child]);
+
+			// Move to the parent space through the rest transform
+			const glm::mat4 local_matrix = node.get_local_transform();
+			const float max_scale = std::max(
+				{glm::length(glm::vec3(local_matrix[0])),
+				 glm::length(glm::vec3(local_matrix[1])),
+				 glm::length(glm::vec3(local_matrix[2]))}
+			);
+
+			node_reach[node_index] = glm::length(glm::vec3(local_matrix[3])) + local_reach * max_scale;
+		}
+
+		for (auto& animation : animations) animation.compress(node_reach, config);
+	}
+
 	std::expected<void, util::Error> Model::compute_topo_order() noexcept
 	{
 		node_topo_order.reserve(nodes.size());
@@ -101,18 +155,22 @@ namespace gltf
 
 	namespace detail
 	{
+		// Load canonical meshes of `mesh_dedup`, indexed by `DedupMap::compact_remap`
 		static std::expected<std::vector<MeshGPU>, util::Error> load_meshes(
 			SDL_GPUDevice* device,
 			const tinygltf::Model& tinygltf_model,
+			const DedupMap& mesh_dedup,
 			const std::optional<std::reference_wrapper<std::atomic<Model::LoadProgress>>>& progress
 		) noexcept
 		{
+			const auto canonical_indices = mesh_dedup.canonical_indices();
+
 			std::mutex progress_mutex;
 			uint32_t progress_count = 0;
 			dp::thread_pool thread_pool(std::thread::hardware_concurrency());
 
 			const auto task =
-				[device, &progress, &progress_count, &progress_mutex, &tinygltf_model](
+				[device, &progress, &progress_count, &progress_mutex, &tinygltf_model, &canonical_indices](
 					const tinygltf::Mesh& tinygltf_mesh
 				) -> std::expected<MeshGPU, util::Error> {
 				auto mesh_cpu = Mesh::from_tinygltf(tinygltf_model, tinygltf_mesh);
@@ -128,7 +186,7 @@ namespace gltf
 					if (progress.has_value())
 						progress->get() = {
 							.stage = Model::LoadStage::Mesh,
-							.progress = float(progress_count) / tinygltf_model.meshes.size()
+							.progress = float(progress_count) / canonical_indices.size()
 						};
 				}
 
@@ -136,19 +194,22 @@ namespace gltf
 			};
 
 			std::vector<std::future<std::expected<MeshGPU, util::Error>>> mesh_futures =
-				tinygltf_model.meshes
-				| std::views::transform([&](const auto& tinygltf_mesh) {
-					  return thread_pool.enqueue(std::bind(task, tinygltf_mesh));
+				canonical_indices
+				| std::views::transform([&](uint32_t index) {
+					  return thread_pool.enqueue(std::bind(task, std::cref(tinygltf_model.meshes[index])));
 				  })
 				| std::ranges::to<std::vector>();
 
 			thread_pool.wait_for_tasks();
 
 			std::vector<MeshGPU> meshes;
-			for (auto [idx, future] : mesh_futures | std::views::enumerate)
+			meshes.reserve(mesh_futures.size());
+
+			for (const auto [future, index] : std::views::zip(mesh_futures, canonical_indices))
 			{
 				auto result = future.get();
-				if (!result) return result.error().forward(std::format("Load mesh failed at index {}", idx));
+				if (!result)
+					return result.error().forward(std::format("Load mesh failed at index {}", index));
 				meshes.emplace_back(std::move(*result));
 			}
 
@@ -214,9 +275,16 @@ namespace gltf
 
 		if (progress) progress->get() = {.stage = LoadStage::Mesh, .progress = 0};
 
-		auto mesh_result = detail::load_meshes(device, tinygltf_model, progress);
+		const auto mesh_dedup = dedup_meshes(tinygltf_model);
+
+		auto mesh_result = detail::load_meshes(device, tinygltf_model, mesh_dedup, progress);
 		if (!mesh_result) return mesh_result.error().forward("Load meshes failed");
 
+		// Point nodes at the canonical copy of duplicated meshes, in the compacted mesh list
+		const auto mesh_remap = mesh_dedup.compact_remap();
+		for (auto& node : nodes)
+			if (node.mesh.has_value()) node.mesh = mesh_remap[*node.mesh];
+
 		/* Load Materials */
 
 		if (progress) progress->get() = {.stage = LoadStage::Material, .progress = 0};
@@ -263,6 +331,12 @@ namespace gltf
 			std::move(lights)
 		);
 
+		model.dedup_summary = {
+			.images = model.material_list.get_image_dedup_summary(),
+			.samplers = model.material_list.get_sampler_dedup_summary(),
+			.meshes = mesh_dedup.summary
+		};
+
 		model.compute_node_parents();
 
 		auto topo_order_result = model.compute_topo_order();
@@ -270,6 +344,8 @@ namespace gltf
 			return topo_order_result.error().forward("Compute node topological order failed");
 
 		model.compute_renderable_nodes();
+		model.compute_dynamic_nodes();
+		model.compress_animations(AnimationClip::Config());
 
 		auto material_bind_cache_result = model.material_list.gen_material_cache();
 		if (!material_bind_cache_result) return util::Error("Generate material bind cache failed");
@@ -296,22 +372,37 @@ namespace gltf
 		lights(std::move(lights)),
 		primitive_count(
 			std::ranges::fold_left(
-				meshes | std::views::transform([](const MeshGPU& mesh) { return mesh.primitives.size(); }),
+				this->meshes
+					| std::views::transform([](const MeshGPU& mesh) { return mesh.primitives.size(); }),
 				0zu,
 				std::plus()
 			)
 		)
 	{
+		uint32_t geometry_index = 0;
+		for (auto& mesh : this->meshes)
+			for (auto& primitive : mesh.primitives) primitive.geometry_index = geometry_index++;
+
 		for (auto [idx, animation] : this->animations | std::views::enumerate)
 			if (animation.name.has_value()) animation_name_map[*animation.name] = idx;
 	}
 
-	std::vector<Node::TransformOverride> Model::compute_node_overrides(
-		std::span<const AnimationKey> animation
+	std::pmr::vector<Node::TransformOverride> Model::compute_node_overrides(
+		std::span<const AnimationKey> animation,
+		std::pmr::memory_resource* memory
 	) const noexcept
 	{
-		std::vector<Node::TransformOverride> node_overrides(nodes.size());
+		std::pmr::vector<Node::TransformOverride> node_overrides(nodes.size(), memory);
+		apply_animation_keys(animation, node_overrides);
 
+		return node_overrides;
+	}
+
+	void Model::apply_animation_keys(
+		std::span<const AnimationKey> animation,
+		std::span<Node::TransformOverride> node_overrides
+	) const noexcept
+	{
 		for (const auto& key : animation)
 		{
 			if (std::holds_alternative<uint32_t>(key.animation))
@@ -331,145 +422,442 @@ namespace gltf
 				animations[animation_index].apply(node_overrides, key.time);
 			}
 		}
-
-		return node_overrides;
 	}
 
-	std::vector<glm::mat4> Model::compute_node_world_matrices(
+	std::pmr::vector<glm::mat4> Model::compute_node_world_matrices(
 		const glm::mat4& model_transform,
-		std::span<const Node::TransformOverride> node_overrides
+		std::span<const Node::TransformOverride> node_overrides,
+		std::pmr::memory_resource* memory
 	) const noexcept
 	{
-		std::vector<glm::mat4> node_world_matrices(nodes.size(), glm::mat4(1.0f));
+		std::pmr::vector<glm::mat4> node_world_matrices(nodes.size(), glm::mat4(1.0f), memory);
+		write_node_world_matrices(model_transform, node_overrides, node_world_matrices);
+
+		return node_world_matrices;
+	}
 
+	void Model::write_node_world_matrices(
+		const glm::mat4& model_transform,
+		std::span<const Node::TransformOverride> node_overrides,
+		std::span<glm::mat4> output
+	) const noexcept
+	{
 		for (const auto node_index : node_topo_order)
 		{
 			const auto& node = nodes[node_index];
 
 			const auto parent_matrix =
 				node_parents[node_index]
-					.transform([&node_world_matrices](uint32_t parent_index) {
-						return std::cref(node_world_matrices[parent_index]);
-					})
+					.transform([&output](uint32_t parent_index) { return std::cref(output[parent_index]); })
 					.value_or(std::ref(model_transform));
 
-			node_world_matrices[node_index] =
-				parent_matrix.get() * node.get_local_transform(node_overrides[node_index]);
+			output[node_index] = parent_matrix.get() * node.get_local_transform(node_overrides[node_index]);
 		}
-
-		return node_world_matrices;
 	}
 
-	std::vector<PrimitiveDrawcall> Model::compute_drawcalls(
-		const std::vector<glm::mat4>& node_world_matrices,
-		std::span<const std::pair<uint32_t, float>> emission_overrides,
-		std::span<const uint32_t> hidden_nodes
+	void Model::append_node_drawcalls(
+		uint32_t node_index,
+		std::span<const glm::mat4> node_world_matrices,
+		float emissive_multiplier,
+		std::vector<PrimitiveDrawcall>& output,
+		std::pmr::memory_resource* scratch
 	) const noexcept
 	{
-		std::vector<PrimitiveDrawcall> drawdata_list;
-		drawdata_list.reserve(primitive_count);
+		const auto& node = nodes[node_index];
+		const glm::mat4& world_matrix = node_world_matrices[node_index];
 
-		auto renderable_nodes = this->renderable_nodes;
-		for (const auto hidden_node_index : hidden_nodes) renderable_nodes[hidden_node_index] = false;
+		if (!node.mesh.has_value()) return;
 
-		std::vector<float> emission_override_values(nodes.size(), 1.0f);
-		for (const auto& [material_index, emission_value] : emission_overrides)
-			emission_override_values[material_index] = emission_value;
+		const auto& mesh = meshes[node.mesh.value()];
 
-		for (const auto node_index : node_topo_order)
+		if (node.skin.has_value())  // Rigged
 		{
-			const auto& node = nodes[node_index];
-			const glm::mat4& world_matrix = node_world_matrices[node_index];
+			const auto [inverse_bind_matrices, joints, skin_offset] = skin_list[node.skin.value()];
 
-			if (!renderable_nodes[node_index] || !node.mesh.has_value()) continue;
+			std::pmr::vector<glm::mat4> joint_matrices(scratch);
+			joint_matrices.reserve(joints.size());
+			for (const auto [joint_index, inverse_bind] : std::views::zip(joints, inverse_bind_matrices))
+				joint_matrices.push_back(node_world_matrices[joint_index] * inverse_bind);
 
-			const auto& mesh = meshes[node.mesh.value()];
+			// Fallback for primitives without usable joint boxes, inflated by the primitive diagonal
+			auto joint_min = glm::vec3(std::numeric_limits<float>::max());
+			auto joint_max = glm::vec3(std::numeric_limits<float>::lowest());
 
-			if (node.skin.has_value())  // Rigged
+			for (const uint32_t joint_index : joints)
 			{
-				const auto [_, joints, skin_offset] = skin_list[node.skin.value()];
-
-				const auto node_positions =
-					joints
-					| std::views::transform([&node_world_matrices](uint32_t joint_index) {
-						  const auto& matrix = node_world_matrices[joint_index];
-						  const auto& col = matrix[3];
-						  return glm::vec3(col.x, col.y, col.z) / col.w;
-					  })
-					| std::ranges::to<std::vector>();
-
-				const auto world_min = std::ranges::fold_left(
-					node_positions,
-					glm::vec3(std::numeric_limits<float>::max()),
-					[](const glm::vec3& a, const glm::vec3& b) { return glm::min(a, b); }
-				);
+				const auto& col = node_world_matrices[joint_index][3];
+				const auto position = glm::vec3(col.x, col.y, col.z) / col.w;
 
-				const auto world_max = std::ranges::fold_left(
-					node_positions,
-					glm::vec3(std::numeric_limits<float>::lowest()),
-					[](const glm::vec3& a, const glm::vec3& b) { return glm::max(a, b); }
-				);
+				joint_min = glm::min(joint_min, position);
+				joint_max = glm::max(joint_max, position);
+			}
 
-				for (const auto& primitive : mesh.primitives)
-				{
-					const auto [gen_data, local_min, local_max] = primitive.gen_drawdata();
-					const float sphere_diameter = glm::distance(local_min, local_max);
+			for (const auto& primitive : mesh.primitives)
+			{
+				const auto [gen_data, local_min, local_max] = primitive.gen_drawdata();
+				const auto& skin_bound = primitive.skin_bound;
 
-					drawdata_list.emplace_back(
-						PrimitiveDrawcall{
-							.world_position_min = world_min - glm::vec3(sphere_diameter),
-							.world_position_max = world_max + glm::vec3(sphere_diameter),
-							.material_index = primitive.material,
-							.transform_or_joint_matrix_offset = skin_offset,
-							.primitive = gen_data,
-						}
-					);
-				}
+				const auto [world_min, world_max] = [&] {
+					if (!skin_bound.empty() && skin_bound.get_joint_count() <= joint_matrices.size())
+						return skin_bound.compute_world_bound(joint_matrices);
+
+					const float sphere_diameter = glm::distance(local_min, local_max);
+					return std::make_pair(joint_min - sphere_diameter, joint_max + sphere_diameter);
+				}();
+
+				output.emplace_back(
+					PrimitiveDrawcall{
+						.world_position_min = world_min,
+						.world_position_max = world_max,
+						.material_index = primitive.material,
+						.transform_or_joint_matrix_offset = skin_offset,
+						.primitive = gen_data,
+					}
+				);
 			}
-			else  // Not Rigged
+		}
+		else  // Not Rigged
+		{
+			for (const auto& primitive : mesh.primitives)
 			{
-
-				for (const auto& primitive : mesh.primitives)
-				{
-					const auto [gen_data, local_min, local_max] = primitive.gen_drawdata();
-					const auto [world_min, world_max] =
-						graphics::local_bound_to_world(local_min, local_max, world_matrix);
-
-					drawdata_list.emplace_back(
-						PrimitiveDrawcall{
-							.world_position_min = world_min,
-							.world_position_max = world_max,
-							.material_index = primitive.material,
-							.transform_or_joint_matrix_offset = world_matrix,
-							.primitive = gen_data,
-							.emissive_multiplier = emission_override_values[node_index],
-						}
-					);
-				}
+				const auto [gen_data, local_min, local_max] = primitive.gen_drawdata();
+				const auto [world_min, world_max] =
+					graphics::local_bound_to_world(local_min, local_max, world_matrix);
+
+				output.emplace_back(
+					PrimitiveDrawcall{
+						.world_position_min = world_min,
+						.world_position_max = world_max,
+						.material_index = primitive.material,
+						.transform_or_joint_matrix_offset = world_matrix,
+						.primitive = gen_data,
+						.emissive_multiplier = emissive_multiplier,
+					}
+				);
 			}
 		}
+	}
+
+	const std::shared_ptr<DrawcallPartition>& DrawcallCache::PartitionRing::advance(
+		uint32_t frame_count
+	) noexcept
+	{
+		if (partitions.size() != frame_count)
+		{
+			partitions.resize(frame_count);
+			next_slot = 0;
+		}
+
+		auto& partition = partitions[next_slot];
+		next_slot = (next_slot + 1) % frame_count;
 
-		return drawdata_list;
+		if (partition == nullptr) partition = std::make_shared<DrawcallPartition>();
+		return partition;
 	}
 
-	Drawdata Model::generate_drawdata(
+	void DrawcallCache::set_frame_count(uint32_t frame_count) noexcept
+	{
+		this->frame_count = std::max(frame_count, 1u);
+		dynamic_partitions = {};
+		instanced_partitions = {};
+	}
+
+	const std::shared_ptr<DrawcallPartition>& DrawcallCache::next_instanced_partition() noexcept
+	{
+		const auto& partition = instanced_partitions.advance(frame_count);
+		partition->drawcalls.clear();
+		partition->generation = next_generation++;
+		return partition;
+	}
+
+	bool DrawcallCache::resolve_inputs(
 		const glm::mat4& model_transform,
-		std::span<const AnimationKey> animation,
+		const std::vector<bool>& renderable_nodes,
 		std::span<const std::pair<uint32_t, float>> emission_overrides,
 		std::span<const uint32_t> hidden_nodes
+	) noexcept
+	{
+		visible_nodes.assign(renderable_nodes.begin(), renderable_nodes.end());
+		for (const auto hidden_node_index : hidden_nodes) visible_nodes[hidden_node_index] = false;
+
+		emission_values.assign(renderable_nodes.size(), 1.0f);
+		for (const auto& [node_index, emission_value] : emission_overrides)
+			emission_values[node_index] = emission_value;
+
+		return static_partition != nullptr
+			&& static_model_transform == model_transform
+			&& static_visible_nodes == visible_nodes
+			&& static_emission_values == emission_values;
+	}
+
+	void DrawcallCache::publish_static_partition(
+		std::shared_ptr<DrawcallPartition> partition,
+		const glm::mat4& model_transform
+	) noexcept
+	{
+		const auto bounds =
+			partition->drawcalls
+			| std::views::transform([](const PrimitiveDrawcall& drawcall) {
+				  return graphics::Aabb{
+					  .min = drawcall.world_position_min,
+					  .max = drawcall.world_position_max
+				  };
+			  })
+			| std::ranges::to<std::vector>();
+		partition->bvh = graphics::Bvh::build(bounds);
+
+		static_partition = std::move(partition);
+		static_model_transform = model_transform;
+		static_visible_nodes = visible_nodes;
+		static_emission_values = emission_values;
+	}
+
+	void Model::set_frame_count(uint32_t frame_count) noexcept
+	{
+		drawcall_cache.set_frame_count(frame_count);
+	}
+
+	DrawcallList Model::compute_drawcalls(
+		const glm::mat4& model_transform,
+		std::span<const glm::mat4> node_world_matrices,
+		std::span<const std::pair<uint32_t, float>> emission_overrides,
+		std::span<const uint32_t> hidden_nodes,
+		std::pmr::memory_resource* scratch
+	) noexcept
+	{
+		return drawcall_cache.update(
+			model_transform,
+			node_topo_order,
+			renderable_nodes,
+			dynamic_nodes,
+			emission_overrides,
+			hidden_nodes,
+			[this, node_world_matrices, scratch](
+				uint32_t node_index,
+				float emissive_multiplier,
+				std::vector<PrimitiveDrawcall>& output
+			) {
+				append_node_drawcalls(node_index, node_world_matrices, emissive_multiplier, output, scratch);
+			}
+		);
+	}
+
+	void DrawcallList::cull_static(
+		std::span<const glm::vec4> planes,
+		std::pmr::vector<uint8_t>& visible,
+		std::pmr::memory_resource* scratch
 	) const noexcept
 	{
-		const auto node_overrides = compute_node_overrides(animation);
-		auto node_world_matrices = compute_node_world_matrices(model_transform, node_overrides);
-		auto primitive_list = compute_drawcalls(node_world_matrices, emission_overrides, hidden_nodes);
-		auto joint_matrices = skin_list.compute_joint_matrices(node_world_matrices);
+		visible.clear();
+		if (static_partition == nullptr) return;
+
+		visible.resize(static_partition->drawcalls.size(), 0);
+
+		std::pmr::vector<uint32_t> visible_indices(scratch);
+		static_partition->bvh.query_frustum(planes, visible_indices);
+		for (const auto index : visible_indices) visible[index] = 1;
+	}
+
+	Drawdata Model::generate_drawdata(
+		const glm::mat4& model_transform,
+		std::span<const AnimationKey> animation,
+		std::span<const std::pair<uint32_t, float>> emission_overrides,
+		std::span<const uint32_t> hidden_nodes,
+		std::pmr::memory_resource* memory
+	) noexcept
+	{
+		const auto node_overrides = compute_node_overrides(animation, memory);
+		auto node_world_matrices = compute_node_world_matrices(model_transform, node_overrides, memory);
+		auto primitive_list =
+			compute_drawcalls(model_transform, node_world_matrices, emission_overrides, hidden_nodes, memory);
+		auto joint_world_matrices = skin_list.gather_joint_world_matrices(node_world_matrices, memory);
 
 		return {
 			.primitive_drawcalls = std::move(primitive_list),
 			.node_matrices = std::move(node_world_matrices),
-			.deferred_skin_resource = joint_matrices.empty()
+			.deferred_skin_resource = joint_world_matrices.empty()
+				? nullptr
+				: std::make_shared<DeferredSkinningResource>(
+					  std::move(joint_world_matrices),
+					  skin_list.inverse_bind_matrices
+				  ),
+			.material_cache = material_bind_cache->ref()
+		};
+	}
+
+	Drawdata Model::generate_instanced_drawdata(
+		std::span<const InstanceRecord> instances,
+		dp::thread_pool<>* thread_pool
+	) noexcept
+	{
+		// Instances evaluated by one task
+		constexpr size_t instance_chunk_size = 64;
+
+		const size_t instance_count = instances.size();
+		const size_t node_count = nodes.size();
+		const size_t joint_count = skin_list.joints.size();
+
+		/* Primitive Slots */
+
+		// (node_index, first_slot) of every renderable node with a mesh, a slot per primitive
+		std::vector<std::pair<uint32_t, size_t>> mesh_nodes;
+		size_t slot_count = 0;
+
+		for (const auto node_index : node_topo_order)
+		{
+			const auto& node = nodes[node_index];
+			if (!renderable_nodes[node_index] || !node.mesh.has_value()) continue;
+
+			mesh_nodes.emplace_back(node_index, slot_count);
+			slot_count += meshes[*node.mesh].primitives.size();
+		}
+
+		/* Evaluate Instances */
+
+		// Matrices are laid out instance by instance, as uploaded and returned
+		std::pmr::vector<glm::mat4> node_world_matrices(instance_count * node_count, glm::mat4(1.0f));
+		std::pmr::vector<glm::mat4> joint_world_matrices(instance_count * joint_count);
+
+		// State read by grouping is laid out node by node, or slot by slot, so groups read it in order. Every
+		// element is written below, the scratch is only resized.
+		auto& visible_nodes = instance_scratch.visible_nodes;
+		auto& emission_values = instance_scratch.emission_values;
+		auto& slot_bounds = instance_scratch.slot_bounds;
+		visible_nodes.resize(node_count * instance_count);
+		emission_values.resize(node_count * instance_count);
+		slot_bounds.resize(slot_count * instance_count);
+
+		const auto evaluate_instances = [&](size_t begin, size_t end) {
+			std::vector<Node::TransformOverride> node_overrides(node_count);
+			std::vector<PrimitiveDrawcall> drawcalls;
+			drawcalls.reserve(slot_count);
+
+			// Joint matrices of rigged nodes, recycled from node to node within the chunk
+			std::pmr::unsynchronized_pool_resource scratch;
+
+			for (const auto instance_index : std::views::iota(begin, end))
+			{
+				const auto& instance = instances[instance_index];
+				const auto world_matrices =
+					std::span(node_world_matrices).subspan(instance_index * node_count, node_count);
+
+				std::ranges::fill(node_overrides, Node::TransformOverride());
+				apply_animation_keys(instance.animation, node_overrides);
+				write_node_world_matrices(instance.model_transform, node_overrides, world_matrices);
+
+				std::ranges::transform(
+					skin_list.joints,
+					joint_world_matrices.begin() + ptrdiff_t(instance_index * joint_count),
+					[world_matrices](uint32_t joint_index) { return world_matrices[joint_index]; }
+				);
+
+				for (const auto node_index : std::views::iota(0zu, node_count))
+				{
+					const size_t state_index = node_index * instance_count + instance_index;
+					visible_nodes[state_index] = renderable_nodes[node_index];
+					emission_values[state_index] = 1.0f;
+				}
+
+				for (const auto hidden_node_index : instance.hidden_nodes)
+					visible_nodes[hidden_node_index * instance_count + instance_index] = 0;
+
+				for (const auto& [node_index, emission_value] : instance.emission_overrides)
+					emission_values[node_index * instance_count + instance_index] = emission_value;
+
+				// Bounds are computed exactly as for single drawcalls
+				drawcalls.clear();
+				for (const auto node_index : mesh_nodes | std::views::keys)
+					append_node_drawcalls(node_index, world_matrices, 1.0f, drawcalls, &scratch);
+
+				for (const auto [slot, drawcall] : std::views::enumerate(drawcalls))
+					slot_bounds[size_t(slot) * instance_count + instance_index] = {
+						.min = drawcall.world_position_min,
+						.max = drawcall.world_position_max
+					};
+			}
+		};
+
+		if (thread_pool == nullptr || instance_count <= instance_chunk_size)
+			evaluate_instances(0, instance_count);
+		else
+		{
+			const auto tasks =
+				std::views::iota(0zu, instance_count)
+				| std::views::stride(instance_chunk_size)
+				| std::views::transform([&](size_t begin) {
+					  const size_t end = std::min(begin + instance_chunk_size, instance_count);
+					  return thread_pool->enqueue([&evaluate_instances, begin, end] {
+						  evaluate_instances(begin, end);
+					  });
+				  })
+				| std::ranges::to<std::vector>();
+
+			for (const auto& task : tasks) task.wait();
+		}
+
+		/* Instanced Drawcalls */
+
+		using TransformOrJointMatrixOffset = decltype(PrimitiveDrawcall::transform_or_joint_matrix_offset);
+
+		const auto& instanced_partition = drawcall_cache.next_instanced_partition();
+		auto& partition = *instanced_partition;
+
+		std::vector<InstanceData> instance_data;
+		std::vector<uint32_t> node_instances;
+		std::vector<InstanceGroup> node_groups;
+		std::vector<PrimitiveDrawcall> node_primitives;
+
+		for (const auto [node_index, first_slot] : mesh_nodes)
+		{
+			const auto& node = nodes[node_index];
+			const auto& mesh = meshes[*node.mesh];
+			const auto skin =
+				node.skin.transform([this](uint32_t skin_index) { return skin_list[skin_index]; });
+
+			// Drawcalls of the node for one instance, bounds are per instance in `slot_bounds`
+			node_primitives.clear();
+			for (const auto& primitive : mesh.primitives)
+				node_primitives.push_back(
+					PrimitiveDrawcall{
+						.world_position_min = glm::vec3(0.0f),
+						.world_position_max = glm::vec3(0.0f),
+						.material_index = primitive.material,
+						.transform_or_joint_matrix_offset = skin.has_value()
+							? TransformOrJointMatrixOffset(skin->offset)
+							: TransformOrJointMatrixOffset(glm::mat4(1.0f)),
+						.primitive = std::get<0>(primitive.gen_drawdata())
+					}
+				);
+
+			append_instanced_drawcalls(
+				node_primitives,
+				std::span(visible_nodes).subspan(node_index * instance_count, instance_count),
+				std::span(emission_values).subspan(node_index * instance_count, instance_count),
+				std::span(slot_bounds).subspan(first_slot * instance_count),
+				uint32_t(joint_count),
+				[&, node_index](uint32_t instance_index) -> const glm::mat4& {
+					return node_world_matrices[instance_index * node_count + node_index];
+				},
+				node_instances,
+				node_groups,
+				instance_data,
+				partition.drawcalls
+			);
+		}
+
+		return {
+			.primitive_drawcalls =
+				{.static_partition = nullptr, .dynamic_partition = instanced_partition},
+			.node_matrices = std::move(node_world_matrices),
+			.deferred_skin_resource = joint_world_matrices.empty()
+				? nullptr
+				: std::make_shared<DeferredSkinningResource>(
+					  std::move(joint_world_matrices),
+					  skin_list.inverse_bind_matrices
+				  ),
+			.deferred_instance_resource = instance_data.empty()
 				? nullptr
-				: std::make_shared<DeferredSkinningResource>(std::move(joint_matrices)),
+				: std::make_shared<DeferredInstanceResource>(std::move(instance_data)),
 			.material_cache = material_bind_cache->ref()
 		};
 	}
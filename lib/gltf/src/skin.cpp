@@ -1,9 +1,9 @@
 #include "gltf/skin.hpp"
 #include "gltf/accessor.hpp"
-#include "util/as-byte.hpp"
 
 #include <SDL3/SDL_gpu.h>
 #include <algorithm>
+#include <ranges>
 
 namespace gltf
 {
@@ -71,49 +71,62 @@ namespace gltf
 		return skin_collection;
 	}
 
-	std::vector<glm::mat4> SkinList::compute_joint_matrices(
-		const std::vector<glm::mat4>& node_world_matrices
+	std::pmr::vector<glm::mat4> SkinList::gather_joint_world_matrices(
+		std::span<const glm::mat4> node_world_matrices,
+		std::pmr::memory_resource* memory
 	) const noexcept
 	{
-		std::vector<glm::mat4> joint_matrices;
-		joint_matrices.reserve(joints.size());
+		std::pmr::vector<glm::mat4> joint_world_matrices(memory);
+		joint_world_matrices.reserve(joints.size());
 
-		for (const auto [inverse_bind_matrix, joint_index] : std::views::zip(inverse_bind_matrices, joints))
-		{
-			const glm::mat4& node_world_matrix = node_world_matrices[joint_index];
-			joint_matrices.emplace_back(node_world_matrix * inverse_bind_matrix);
-		}
+		for (const auto joint_index : joints)
+			joint_world_matrices.push_back(node_world_matrices[joint_index]);
 
-		return joint_matrices;
+		return joint_world_matrices;
 	}
 
 	std::expected<void, util::Error> DeferredSkinningResource::prepare_gpu_buffers(
 		graphics::BufferPool& buffer_pool,
-		graphics::TransferBufferPool& transfer_pool
+		graphics::TransferBufferPool& transfer_pool,
+		JointPalette palette
 	) noexcept
 	{
 		if (upload_buffer || joint_matrices_buffer)
 			return util::Error("GPU buffers for skin computation already prepared");
 
-		const auto upload_buffer_result = transfer_pool.acquire_buffer(
-			gpu::TransferBuffer::Usage::Upload,
-			sizeof(glm::mat4) * joint_matrices_data.size()
-		);
+		this->palette = palette;
+		const uint32_t palette_size = get_palette_size();
+
+		const auto upload_buffer_result =
+			transfer_pool.acquire_buffer(gpu::TransferBuffer::Usage::Upload, palette_size);
 		if (!upload_buffer_result)
 			return upload_buffer_result.error().forward("Acquire transfer buffer for joint matrices failed");
 
-		const auto buffer_result = buffer_pool.acquire_buffer(
-			{.graphic_storage_read = true},
-			sizeof(glm::mat4) * joint_matrices_data.size()
-		);
+		const auto buffer_result = buffer_pool.acquire_buffer({.graphic_storage_read = true}, palette_size);
 		if (!buffer_result) return buffer_result.error().forward("Acquire buffer for joint matrices failed");
 
 		upload_buffer = *upload_buffer_result;
 		joint_matrices_buffer = *buffer_result;
 
-		if (const auto result = upload_buffer->upload_to_buffer(util::as_bytes(joint_matrices_data), true);
-			!result)
-			return result.error().forward("Upload node matrices to transfer buffer failed");
+		// Encode straight into the mapped transfer buffer, one skin list instance at a time
+		const auto transfer_result = upload_buffer->transfer(
+			[this, palette_size](void* mapped_ptr) {
+				const auto output = std::span(static_cast<std::byte*>(mapped_ptr), palette_size);
+				const size_t joint_count = inverse_bind_matrices.size();
+				const size_t instance_count = joint_world_matrices.size() / joint_count;
+				const size_t instance_size = joint_count * get_joint_palette_stride(this->palette);
+
+				for (const auto instance_index : std::views::iota(0zu, instance_count))
+					encode_joint_palette(
+						this->palette,
+						std::span(joint_world_matrices).subspan(instance_index * joint_count, joint_count),
+						inverse_bind_matrices,
+						output.subspan(instance_index * instance_size, instance_size)
+					);
+			},
+			true
+		);
+		if (!transfer_result) return transfer_result.error().forward("Encode joint palette failed");
 
 		return {};
 	}
@@ -122,13 +135,6 @@ namespace gltf
 	{
 		assert(upload_buffer != nullptr && joint_matrices_buffer != nullptr);
 
-		copy_pass.upload_to_buffer(
-			*upload_buffer,
-			0,
-			*joint_matrices_buffer,
-			0,
-			sizeof(glm::mat4) * joint_matrices_data.size(),
-			true
-		);
+		copy_pass.upload_to_buffer(*upload_buffer, 0, *joint_matrices_buffer, 0, get_palette_size(), true);
 	}
 }
\ No newline at end of file
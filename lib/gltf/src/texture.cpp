@@ -34,4 +34,14 @@ namespace gltf
 				: std::nullopt,
 		};
 	}
+
+	Texture Texture::remap(std::span<const uint32_t> image_remap, std::span<const uint32_t> sampler_slots)
+		const noexcept
+	{
+		return Texture{
+			.image_index = image_remap[image_index],
+			.sampler_index =
+				sampler_index.transform([sampler_slots](uint32_t index) { return sampler_slots[index]; }),
+		};
+	}
 }
\ No newline at end of file
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <variant>
+
+#include "buffer.hpp"
+#include "fence.hpp"
+#include "texture.hpp"
+
+namespace gpu
+{
+	///
+	/// @brief Defers the release of GPU resources until the submissions that may use them have completed
+	/// @details #### Usage:
+	/// - `release` resources no longer needed while recording a submission, they are tagged with it
+	/// - `submit` after submitting its command buffer, with the fence of the submission
+	/// - `collect` once per frame, resources of completed submissions are released within a budget
+	///
+	/// #### Completion:
+	/// Submissions complete in order, so a signaled fence completes every earlier submission, including
+	/// those submitted without fence.
+	///
+	/// @warning Not thread-safe
+	///
+	class DeletionQueue
+	{
+	  public:
+
+		// Poll the fence of a submission, `true` once signaled
+		using FencePoll = std::move_only_function<bool() const>;
+
+		// Release something else than a GPU resource, e.g. a slot of a pool still referenced by commands
+		using Deleter = std::move_only_function<void()>;
+
+		struct Stats
+		{
+			size_t pending_resources = 0;    // Resources waiting for their submission or for budget
+			uint64_t pending_bytes = 0;      // Memory of pending resources
+			size_t pending_submissions = 0;  // Submitted, not yet known to be completed
+			size_t released_resources = 0;   // Resources released by the last `collect`
+			uint64_t released_bytes = 0;     // Memory released by the last `collect`
+		};
+
+		///
+		/// @brief Create an empty deletion queue
+		///
+		/// @param release_budget Maximum resources released by one `collect`, 0 for unlimited
+		///
+		explicit DeletionQueue(size_t release_budget = 64) noexcept :
+			release_budget(release_budget)
+		{}
+
+		DeletionQueue(const DeletionQueue&) = delete;
+		DeletionQueue(DeletionQueue&&) = default;
+		DeletionQueue& operator=(const DeletionQueue&) = delete;
+		DeletionQueue& operator=(DeletionQueue&&) = default;
+		~DeletionQueue() noexcept = default;
+
+		///
+		/// @brief Defer the release of a resource after the submission being recorded
+		/// @note Empty resources, e.g. moved from, are ignored
+		///
+		/// @param resource Resource to release
+		/// @param bytes Memory size of the resource, for statistics
+		///
+		void release(Buffer resource, uint64_t bytes) noexcept;
+		void release(Texture resource, uint64_t bytes) noexcept;
+		void release(TransferBuffer resource, uint64_t bytes) noexcept;
+		void release(Deleter resource, uint64_t bytes) noexcept;
+
+		///
+		/// @brief End the submission being recorded, call after submitting its command buffer
+		///
+		/// @param fence Fence acquired when submitting
+		///
+		void submit(Fence fence) noexcept;
+
+		///
+		/// @brief End the submission being recorded, call after submitting its command buffer
+		///
+		/// @param poll Signal state of the submission, empty if submitted without fence
+		///
+		void submit(FencePoll poll) noexcept;
+
+		///
+		/// @brief Poll fences, then release resources of completed submissions in release order
+		/// @note Resources over budget are kept for the next call
+		///
+		void collect() noexcept;
+
+		///
+		/// @brief Release every resource without waiting
+		/// @warning Only call once the device is idle, e.g. after `SDL_WaitForGPUIdle`
+		///
+		void flush() noexcept;
+
+		// Get the index of the submission being recorded, resources released now are tagged with it
+		uint64_t get_recording_index() const noexcept { return recording_index; }
+
+		// Get the index of the last submission known to be completed, 0 if none
+		uint64_t get_completed_index() const noexcept { return completed_index; }
+
+		Stats get_stats() const noexcept;
+
+	  private:
+
+		struct Entry
+		{
+			uint64_t submission;
+			uint64_t bytes;
+			std::variant<Buffer, Texture, TransferBuffer, Deleter> resource;
+		};
+
+		struct Submission
+		{
+			uint64_t index;
+			FencePoll poll;  // Empty if submitted without fence
+		};
+
+		size_t release_budget;
+
+		// Submission indices start at 1, so that 0 means none completed
+		uint64_t recording_index = 1;
+		uint64_t completed_index = 0;
+
+		std::deque<Entry> entries;  // In release order, so in submission order
+		std::deque<Submission> submissions;
+		uint64_t pending_bytes = 0;
+
+		size_t last_released_resources = 0;
+		uint64_t last_released_bytes = 0;
+
+		void push(std::variant<Buffer, Texture, TransferBuffer, Deleter> resource, uint64_t bytes) noexcept;
+
+		// Release the oldest entry
+		void pop() noexcept;
+	};
+}
@@ -280,6 +280,15 @@ namespace gpu
 		///
 		void set_scissor(const SDL_Rect& scissor) const noexcept;
 
+		///
+		/// @brief Restricts rendering to the top-left corner of the targets, sets both viewport and scissor
+		/// @note Viewport and scissor are reset when a render pass begins, set the region after beginning
+		///
+		/// @param width Width of the region, in pixels
+		/// @param height Height of the region, in pixels
+		///
+		void set_region(uint32_t width, uint32_t height) const noexcept;
+
 		///
 		/// @brief Sets blend constants
 		///
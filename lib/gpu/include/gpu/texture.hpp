@@ -81,6 +81,22 @@ namespace gpu
 			/// @return `true` if supported, `false` otherwise
 			///
 			bool supported_on(SDL_GPUDevice* device) const noexcept;
+
+			///
+			/// @brief Get the memory size of a texture of this format
+			///
+			/// @param width Width of the texture
+			/// @param height Height of the texture
+			/// @param depth Depth or layer count of the texture (default is 1)
+			/// @param mip_levels Number of mip levels, each halving width and height (default is 1)
+			/// @return Size in bytes
+			///
+			uint64_t get_size(
+				uint32_t width,
+				uint32_t height,
+				uint32_t depth = 1,
+				uint32_t mip_levels = 1
+			) const noexcept;
 		};
 
 		///
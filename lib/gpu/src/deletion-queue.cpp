@@ -0,0 +1,111 @@
+#include "gpu/deletion-queue.hpp"
+
+#include <ranges>
+
+namespace gpu
+{
+	void DeletionQueue::push(
+		std::variant<Buffer, Texture, TransferBuffer, Deleter> resource,
+		uint64_t bytes
+	) noexcept
+	{
+		entries.push_back({.submission = recording_index, .bytes = bytes, .resource = std::move(resource)});
+		pending_bytes += bytes;
+	}
+
+	void DeletionQueue::pop() noexcept
+	{
+		auto& entry = entries.front();
+		if (auto* const deleter = std::get_if<Deleter>(&entry.resource)) (*deleter)();
+
+		pending_bytes -= entry.bytes;
+		entries.pop_front();
+	}
+
+	void DeletionQueue::release(Buffer resource, uint64_t bytes) noexcept
+	{
+		if (static_cast<SDL_GPUBuffer*>(resource) == nullptr) return;
+		push(std::move(resource), bytes);
+	}
+
+	void DeletionQueue::release(Texture resource, uint64_t bytes) noexcept
+	{
+		if (static_cast<SDL_GPUTexture*>(resource) == nullptr) return;
+		push(std::move(resource), bytes);
+	}
+
+	void DeletionQueue::release(TransferBuffer resource, uint64_t bytes) noexcept
+	{
+		if (static_cast<SDL_GPUTransferBuffer*>(resource) == nullptr) return;
+		push(std::move(resource), bytes);
+	}
+
+	void DeletionQueue::release(Deleter resource, uint64_t bytes) noexcept
+	{
+		if (!resource) return;
+		push(std::move(resource), bytes);
+	}
+
+	void DeletionQueue::submit(Fence fence) noexcept
+	{
+		submit([fence = std::move(fence)] { return fence.is_signaled(); });
+	}
+
+	void DeletionQueue::submit(FencePoll poll) noexcept
+	{
+		submissions.push_back({.index = recording_index, .poll = std::move(poll)});
+		recording_index++;
+	}
+
+	void DeletionQueue::collect() noexcept
+	{
+		/* Poll fences */
+
+		// Newest first, the first signaled fence completes every earlier submission
+		for (const auto& submission : submissions | std::views::reverse)
+		{
+			if (!submission.poll || !submission.poll()) continue;
+
+			completed_index = submission.index;
+			break;
+		}
+
+		while (!submissions.empty() && submissions.front().index <= completed_index) submissions.pop_front();
+
+		/* Release */
+
+		last_released_resources = 0;
+		last_released_bytes = 0;
+
+		while (!entries.empty() && entries.front().submission <= completed_index)
+		{
+			if (release_budget != 0 && last_released_resources >= release_budget) break;
+
+			last_released_resources++;
+			last_released_bytes += entries.front().bytes;
+
+			pop();
+		}
+	}
+
+	void DeletionQueue::flush() noexcept
+	{
+		last_released_resources = entries.size();
+		last_released_bytes = pending_bytes;
+
+		while (!entries.empty()) pop();
+		submissions.clear();
+		completed_index = recording_index - 1;
+	}
+
+	DeletionQueue::Stats DeletionQueue::get_stats() const noexcept
+	{
+		return {
+			.pending_resources = entries.size(),
+			.pending_bytes = pending_bytes,
+			.pending_submissions = submissions.size(),
+			.released_resources = last_released_resources,
+			.released_bytes = last_released_bytes
+		};
+	}
+}
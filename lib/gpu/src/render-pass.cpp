@@ -173,6 +173,19 @@ namespace gpu
 		SDL_SetGPUScissor(resource, &scissor);
 	}
 
+	void RenderPass::set_region(uint32_t width, uint32_t height) const noexcept
+	{
+		set_viewport({
+			.x = 0,
+			.y = 0,
+			.w = static_cast<float>(width),
+			.h = static_cast<float>(height),
+			.min_depth = 0.0f,
+			.max_depth = 1.0f
+		});
+		set_scissor({.x = 0, .y = 0, .w = static_cast<int>(width), .h = static_cast<int>(height)});
+	}
+
 	void RenderPass::set_stencil_reference(uint8_t reference) const noexcept
 	{
 		assert(resource != nullptr);
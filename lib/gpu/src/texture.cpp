@@ -1,6 +1,8 @@
 #include "gpu/texture.hpp"
 #include "gpu/util.hpp"
 #include <SDL3/SDL_gpu.h>
+#include <algorithm>
+#include <ranges>
 
 namespace gpu
 {
@@ -52,6 +54,26 @@ namespace gpu
 		};
 	}
 
+	uint64_t Texture::Format::get_size(
+		uint32_t width,
+		uint32_t height,
+		uint32_t depth,
+		uint32_t mip_levels
+	) const noexcept
+	{
+		uint64_t size = 0;
+
+		for (const auto level : std::views::iota(0u, mip_levels))
+			size += SDL_CalcGPUTextureFormatSize(
+				format,
+				std::max(width >> level, 1u),
+				std::max(height >> level, 1u),
+				depth
+			);
+
+		return size;
+	}
+
 	bool Texture::Format::supported_on(SDL_GPUDevice* device) const noexcept
 	{
 		assert(device != nullptr);
@@ -25,8 +25,9 @@ namespace graphics::aa
 		/// @brief Run antialising processor
 		///
 		/// @param source Input source texture, should have a size of `size`
-		/// @param target Target texture, should have a size of `size
-		/// @param size Size of the textures, in pixels
+		/// @param target Target texture, should be at least as large as `region`
+		/// @param size Size of the source texture, in pixels. Intermediate textures are allocated at it.
+		/// @param region Size of the processed region at the top-left corner of source and target, in pixels
 		/// @return `void` on success, or `util::Error` on failure
 		///
 		virtual std::expected<void, util::Error> run_antialiasing(
@@ -34,7 +35,8 @@ namespace graphics::aa
 			const gpu::CommandBuffer& command_buffer,
 			SDL_GPUTexture* source,
 			SDL_GPUTexture* target,
-			glm::u32vec2 size
+			glm::u32vec2 size,
+			glm::u32vec2 region
 		) noexcept = 0;
 	};
 
@@ -22,7 +22,8 @@ namespace graphics::aa
 			const gpu ::CommandBuffer& command_buffer,
 			SDL_GPUTexture* source,
 			SDL_GPUTexture* target,
-			glm ::u32vec2 size
+			glm ::u32vec2 size,
+			glm ::u32vec2 region
 		) noexcept override;
 
 		Empty(const Empty&) noexcept = delete;
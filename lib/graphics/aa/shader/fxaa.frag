@@ -2,6 +2,11 @@
 
 layout (set = 2, binding = 0) uniform sampler2D tex;
 
+// Size of the processed region at the top-left corner of the texture, neighbors are clamped into it
+layout (std140, set = 3, binding = 0) uniform Params
+{
+	uvec2 region_size;
+};
 
 layout (location = 0) out vec4 out_color;
 
@@ -17,6 +22,7 @@ const float[] search_step = float[](0.75, 1.5, 2, 4, 12);
 
 ivec2 fragcoord_int = ivec2(floor(gl_FragCoord.xy));
 vec2 texture_size = vec2(textureSize(tex, 0));
+ivec2 region_max = ivec2(region_size) - 1;
 
 // 计算亮度
 float luma(in vec3 color)
@@ -27,13 +33,14 @@ float luma(in vec3 color)
 // 获取颜色（浮点）
 vec3 get_color_float(vec2 offset)
 {
-	return textureLod(tex, (gl_FragCoord.xy + offset) / texture_size, 0.0).rgb;
+	const vec2 coord = clamp(gl_FragCoord.xy + offset, vec2(0.5), vec2(region_size) - 0.5);
+	return textureLod(tex, coord / texture_size, 0.0).rgb;
 }
 
 // 获取颜色（整数）
 vec3 get_color_int(ivec2 offset)
 {
-	return texelFetch(tex, fragcoord_int + offset, 0).rgb;
+	return texelFetch(tex, clamp(fragcoord_int + offset, ivec2(0), region_max), 0).rgb;
 }
 
 vec3 fxaa()
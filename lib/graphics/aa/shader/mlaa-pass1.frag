@@ -2,6 +2,12 @@
 
 layout (set = 2, binding = 0) uniform sampler2D color_tex;
 
+// Size of the processed region at the top-left corner of the texture, neighbors are clamped into it
+layout (std140, set = 3, binding = 0) uniform Params
+{
+	uvec2 region_size;
+};
+
 layout (location = 0) out vec2 out_color;
 
 /*==========*/
@@ -17,7 +23,7 @@ float luma(in vec3 color)
 	return dot(color, vec3(0.21, 0.72, 0.07));
 }
 
-#define get_color(offset) texelFetchOffset(color_tex, pixcoord, 0, offset).rgb
+#define get_color(offset) texelFetch(color_tex, clamp(pixcoord + offset, ivec2(0), ivec2(region_size) - 1), 0).rgb
 
 vec2 find_edge()
 {
@@ -7,7 +7,8 @@ namespace graphics::aa
 		const gpu::CommandBuffer& command_buffer,
 		SDL_GPUTexture* source,
 		SDL_GPUTexture* target,
-		glm::u32vec2 size
+		glm::u32vec2 size [[maybe_unused]],
+		glm::u32vec2 region
 	) noexcept
 	{
 		const auto blit_info = SDL_GPUBlitInfo{
@@ -18,8 +19,8 @@ namespace graphics::aa
 								  .layer_or_depth_plane = 0,
 								  .x = 0,
 								  .y = 0,
-								  .w = size.x,
-								  .h = size.y,
+								  .w = region.x,
+								  .h = region.y,
 								  },
 			.destination =
 				SDL_GPUBlitRegion{
@@ -28,8 +29,8 @@ namespace graphics::aa
 								  .layer_or_depth_plane = 0,
 								  .x = 0,
 								  .y = 0,
-								  .w = size.x,
-								  .h = size.y,
+								  .w = region.x,
+								  .h = region.y,
 								  },
 			.load_op = SDL_GPU_LOADOP_DONT_CARE,
 			.clear_color = {},
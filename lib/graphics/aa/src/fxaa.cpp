@@ -1,6 +1,8 @@
 #include "graphics/aa/fxaa.hpp"
 #include "asset/shader/fxaa.frag.hpp"
 
+#include "util/as-byte.hpp"
+
 #include <array>
 
 namespace graphics::aa
@@ -41,7 +43,7 @@ namespace graphics::aa
 				1,
 				0,
 				0,
-				0
+				1
 			)
 				.and_then(shader_to_pass);
 		if (!FullscreenPass) return FullscreenPass.error().forward("Create FXAA fullscreen pass failed");
@@ -57,13 +59,17 @@ namespace graphics::aa
 		const gpu::CommandBuffer& command_buffer,
 		SDL_GPUTexture* source,
 		SDL_GPUTexture* target,
-		glm::u32vec2 size [[maybe_unused]]
+		glm::u32vec2 size [[maybe_unused]],
+		glm::u32vec2 region
 	) noexcept
 	{
 		const auto texture_binding = std::to_array<SDL_GPUTextureSamplerBinding>({
 			{.texture = source, .sampler = sampler}
 		});
 
-		return fxaa_pass.render(command_buffer, target, texture_binding, std::nullopt, std::nullopt);
+		command_buffer.push_uniform_to_fragment(0, util::as_bytes(region));
+
+		return fxaa_pass
+			.render(command_buffer, target, texture_binding, std::nullopt, std::nullopt, region);
 	}
 }
\ No newline at end of file
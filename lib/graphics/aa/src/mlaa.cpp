@@ -5,6 +5,7 @@
 #include "asset/shader/mlaa-pass3.frag.hpp"
 
 #include "graphics/aa/detail/mlaa-ortho-lut.hpp"
+#include "util/as-byte.hpp"
 
 #include <array>
 
@@ -46,7 +47,7 @@ namespace graphics::aa
 			1,
 			0,
 			0,
-			0
+			1
 		);
 		auto pass1 = std::move(shader1).and_then([device](gpu::GraphicsShader shader) {
 			return FullscreenPass<true>::create(
@@ -130,7 +131,8 @@ namespace graphics::aa
 		const gpu::CommandBuffer& command_buffer,
 		SDL_GPUTexture* source,
 		SDL_GPUTexture* target,
-		glm::u32vec2 size
+		glm::u32vec2 size,
+		glm::u32vec2 region
 	) noexcept
 	{
 		if (const auto result = edge_texture.resize(device, size); !result)
@@ -153,20 +155,20 @@ namespace graphics::aa
 			{.texture = *blend_texture, .sampler = sampler}
 		});
 
-		if (const auto result =
-				pass1.render(command_buffer, *edge_texture, pass1_texture, std::nullopt, std::nullopt);
-			!result)
-			return result.error().forward("Run MLAA Pass 1 failed");
+		// Edge detection reads neighbors, clamped to the region
+		command_buffer.push_uniform_to_fragment(0, util::as_bytes(region));
+
+		const auto pass1_result =
+			pass1.render(command_buffer, *edge_texture, pass1_texture, std::nullopt, std::nullopt, region);
+		if (!pass1_result) return pass1_result.error().forward("Run MLAA Pass 1 failed");
 
-		if (const auto result =
-				pass2.render(command_buffer, *blend_texture, pass2_texture, std::nullopt, std::nullopt);
-			!result)
-			return result.error().forward("Run MLAA Pass 2 failed");
+		const auto pass2_result =
+			pass2.render(command_buffer, *blend_texture, pass2_texture, std::nullopt, std::nullopt, region);
+		if (!pass2_result) return pass2_result.error().forward("Run MLAA Pass 2 failed");
 
-		if (const auto result =
-				pass3.render(command_buffer, target, pass3_texture, std::nullopt, std::nullopt);
-			!result)
-			return result.error().forward("Run MLAA Pass 3 failed");
+		const auto pass3_result =
+			pass3.render(command_buffer, target, pass3_texture, std::nullopt, std::nullopt, region);
+		if (!pass3_result) return pass3_result.error().forward("Run MLAA Pass 3 failed");
 
 		return {};
 	}
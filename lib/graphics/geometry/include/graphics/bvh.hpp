@@ -0,0 +1,148 @@
+///
+/// @file bvh.hpp
+/// @brief Provides an 8-wide bounding volume hierarchy over AABBs, for hierarchical culling
+///
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace graphics
+{
+	///
+	/// @brief Axis-aligned bounding box
+	///
+	struct Aabb
+	{
+		glm::vec3 min;
+		glm::vec3 max;
+	};
+
+	///
+	/// @brief Bounding volume hierarchy with 8-wide nodes
+	/// @details
+	/// - Built top-down with binned SAH into a binary tree, then collapsed into 8-wide nodes by repeatedly
+	/// opening the child with the largest surface area.
+	/// - Nodes are stored in depth-first pre-order, a child always has a larger index than its parent.
+	/// - Primitives of every subtree are contiguous in the leaf order, so subtrees found fully inside a
+	/// query region are accepted without visiting them.
+	/// - Bounds can be refitted after primitives move, the topology is kept.
+	/// - Queries only read the hierarchy and can run concurrently.
+	///
+	class Bvh
+	{
+	  public:
+
+		static constexpr uint32_t node_width = 8;
+		static constexpr uint32_t leaf_child = std::numeric_limits<uint32_t>::max();
+
+		///
+		/// @brief Node with `node_width` child slots in SoA layout
+		/// @details A slot is unused if `count` is 0, a leaf if `child` is `leaf_child`, and refers to the
+		/// node at index `child` otherwise.
+		///
+		struct alignas(32) Node
+		{
+			std::array<float, node_width> min_x, min_y, min_z;
+			std::array<float, node_width> max_x, max_y, max_z;
+
+			std::array<uint32_t, node_width> child;  // Child node index, or `leaf_child`
+			std::array<uint32_t, node_width> first;  // First primitive of the slot subtree in leaf order
+			std::array<uint32_t, node_width> count;  // Primitive count of the slot subtree
+		};
+
+		struct BuildConfig
+		{
+			uint32_t bin_count = 16;     // SAH bins per axis
+			uint32_t max_leaf_size = 4;  // Maximum primitives in a leaf slot
+		};
+
+		Bvh() = default;
+
+		///
+		/// @brief Build a hierarchy over boxes with default configuration
+		///
+		/// @param boxes Primitive boxes, primitives are identified by their index in this span
+		/// @return Built hierarchy
+		///
+		static Bvh build(std::span<const Aabb> boxes) noexcept;
+
+		///
+		/// @brief Build a hierarchy over boxes
+		///
+		/// @param boxes Primitive boxes, primitives are identified by their index in this span
+		/// @param config Build configuration
+		/// @return Built hierarchy
+		///
+		static Bvh build(std::span<const Aabb> boxes, const BuildConfig& config) noexcept;
+
+		///
+		/// @brief Refit all bounds to new primitive boxes
+		///
+		/// @param boxes New primitive boxes, same count and order as on build
+		///
+		void refit(std::span<const Aabb> boxes) noexcept;
+
+		///
+		/// @brief Refit bounds of changed primitives and their ancestors only
+		/// @note Suited for animated subtrees, where few primitives move every frame
+		///
+		/// @param boxes New primitive boxes, same count and order as on build
+		/// @param changed Indices of primitives whose box changed
+		///
+		void refit(std::span<const Aabb> boxes, std::span<const uint32_t> changed) noexcept;
+
+		///
+		/// @brief Find primitives whose box passes `box_in_frustum`
+		///
+		/// @param planes Frustum planes, computed by `compute_frustum_planes()`. Can be a subset of planes.
+		/// @param result Output, indices of visible primitives are appended. The traversal stack is allocated
+		/// from its resource.
+		///
+		void query_frustum(
+			std::span<const glm::vec4> planes,
+			std::pmr::vector<uint32_t>& result
+		) const noexcept;
+
+		///
+		/// @brief Find primitives whose box overlaps a box, touching boxes overlap
+		///
+		/// @param box Query box
+		/// @param result Output, indices of overlapping primitives are appended. The traversal stack is
+		/// allocated from its resource.
+		///
+		void query_overlap(const Aabb& box, std::pmr::vector<uint32_t>& result) const noexcept;
+
+		// Number of primitives
+		size_t size() const noexcept { return primitive_indices.size(); }
+
+		// Whether the hierarchy holds no primitive
+		bool empty() const noexcept { return primitive_indices.empty(); }
+
+		// Nodes in depth-first pre-order, root first
+		std::span<const Node> get_nodes() const noexcept { return nodes; }
+
+	  private:
+
+		static constexpr uint32_t no_parent = std::numeric_limits<uint32_t>::max();
+
+		std::vector<Node> nodes;
+		std::vector<uint32_t> node_parents;        // Parent node index of each node
+		std::vector<uint32_t> primitive_indices;   // Primitive index of each leaf-order position
+		std::vector<Aabb> primitive_boxes;         // Primitive boxes in leaf order
+		std::vector<uint32_t> primitive_positions;  // Leaf-order position of each primitive
+		std::vector<uint32_t> primitive_nodes;      // Node holding the leaf slot of each primitive
+
+		// Recompute bounds of every slot of a node from primitives and child nodes
+		void refit_node(uint32_t node_index) noexcept;
+
+		// Append primitives of a slot subtree
+		void accept_slot(const Node& node, uint32_t slot, std::pmr::vector<uint32_t>& result) const noexcept;
+	};
+}
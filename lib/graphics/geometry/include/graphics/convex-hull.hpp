@@ -0,0 +1,82 @@
+///
+/// @file convex-hull.hpp
+/// @brief Provides convex hulls as reduced plane sets, with fast containment and frustum tests
+///
+
+#pragma once
+
+#include "util/error.hpp"
+
+#include <expected>
+#include <glm/glm.hpp>
+#include <span>
+#include <vector>
+
+namespace graphics
+{
+	///
+	/// @brief Convex hull of a point set, stored as planes and vertices for SIMD tests
+	/// @details
+	/// - The hull is built by quickhull, then coplanar hull triangles are merged into a single plane. A
+	/// convex mesh keeps one plane per flat face, regardless of its triangulation.
+	/// - Planes point outward, a point is inside if it lies strictly behind every plane.
+	/// - An AABB and a bounding sphere allow early outs before the plane and vertex tests.
+	///
+	class ConvexHull
+	{
+	  public:
+
+		///
+		/// @brief Build the convex hull of a point set
+		///
+		/// @param points Input points, usually mesh vertices
+		/// @return Convex hull, or error if the points are coplanar or too few
+		///
+		static std::expected<ConvexHull, util::Error> from_points(std::span<const glm::vec3> points) noexcept;
+
+		///
+		/// @brief Tell if a point is strictly inside the hull
+		///
+		/// @param point Point in hull space
+		/// @return True if the point is behind every plane
+		///
+		bool contains(const glm::vec3& point) const noexcept;
+
+		///
+		/// @brief Tell if the hull may be inside a frustum
+		/// @note Conservative: a hull outside the frustum near its corners can still pass
+		///
+		/// @param planes Frustum planes, computed by `compute_frustum_planes()`. Can be a subset of planes.
+		/// @param world_matrix Transform from hull space to the space of the planes
+		/// @return False if every hull vertex is outside a plane, true otherwise
+		///
+		bool in_frustum(std::span<const glm::vec4> planes, const glm::mat4& world_matrix) const noexcept;
+
+		// Number of planes after merging coplanar faces
+		size_t get_plane_count() const noexcept { return plane_count; }
+
+		// Number of hull vertices
+		size_t get_vertex_count() const noexcept { return vertex_count; }
+
+		glm::vec3 get_min() const noexcept { return min; }
+		glm::vec3 get_max() const noexcept { return max; }
+		glm::vec3 get_sphere_center() const noexcept { return sphere_center; }
+		float get_sphere_radius() const noexcept { return sphere_radius; }
+
+	  private:
+
+		// Planes as SoA, `dot(normal, p) + offset > 0` outside, padded to 8 planes that contain everything
+		std::vector<float> plane_x, plane_y, plane_z, plane_offset;
+		size_t plane_count = 0;
+
+		// Hull vertices as SoA, padded to 8 vertices by repeating the first one
+		std::vector<float> vertex_x, vertex_y, vertex_z;
+		size_t vertex_count = 0;
+
+		glm::vec3 min, max;
+		glm::vec3 sphere_center;
+		float sphere_radius;
+
+		ConvexHull() = default;
+	};
+}
@@ -0,0 +1,192 @@
+///
+/// @file light-cluster.hpp
+/// @brief Provides clustered light assignment, binning point and spot lights into view-space froxels
+///
+
+#pragma once
+
+#include "util/error.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <glm/glm.hpp>
+#include <span>
+#include <vector>
+
+namespace graphics
+{
+	///
+	/// @brief Point or spot light as seen by the cluster builder
+	///
+	struct ClusterLight
+	{
+		enum class Type : uint8_t
+		{
+			Point,
+			Spot
+		};
+
+		Type type;
+		glm::vec3 position;                     // World space
+		float range;                            // Influence radius, may be infinite
+		glm::vec3 direction = glm::vec3(0.0f);  // Spot light axis in world space, normalized
+		float outer_cone_angle = 0.0f;          // Spot light half angle, at most pi/2
+	};
+
+	///
+	/// @brief Froxel grid with per-cluster light lists
+	/// @details
+	/// - The camera frustum is split into `dimension.x` columns and `dimension.y` rows of equal NDC size,
+	/// row 0 at the top of the screen, and `dimension.z` depth slices exponentially spaced between `near`
+	/// and `far`. Slice 0 reaches down to the eye, fragments past `far` belong to no cluster.
+	/// - Clusters are indexed as `(slice * dimension.y + row) * dimension.x + column`. Each cluster owns the
+	/// range `[offset, offset + count)` of the global light index array, holding ascending light indices.
+	/// - Lights are first tested against the depth range of each slice, then against the side planes of
+	/// every column and row, 8 lights at a time. The plane tests are separable, so a froxel only tests the
+	/// lights passing both its column and row, against its bounding sphere. Spot lights are tested as cones.
+	/// - All tests are conservative, a cluster may list a light that doesn't reach it, never the opposite.
+	///
+	/// Typical use per frame:
+	/// 1. `begin` with the camera matrices and lights
+	/// 2. `build_slice` for every slice, possibly on multiple threads
+	/// 3. `finish` to merge the slices into the global arrays
+	///
+	class LightCluster
+	{
+	  public:
+
+		struct Config
+		{
+			glm::u32vec3 dimension = {16, 9, 24};  // Columns, rows and depth slices
+			float near = 0.1f;                     // View distance of the first slice boundary
+			float far = 100.0f;                    // View distance past which fragments aren't clustered
+		};
+
+		// Light list of one cluster, laid out for a std430 storage buffer
+		struct Range
+		{
+			uint32_t offset;
+			uint32_t count;
+		};
+
+		///
+		/// @brief Create an empty cluster grid
+		///
+		/// @param config Grid configuration
+		/// @return Cluster grid, or error if the configuration is invalid
+		///
+		static std::expected<LightCluster, util::Error> create(const Config& config) noexcept;
+
+		///
+		/// @brief Start a new frame, transforming the lights into view space
+		///
+		/// @param view_matrix Camera view matrix
+		/// @param proj_matrix Camera perspective projection matrix, reversed Z or not
+		/// @param lights Lights of the frame, indexed by the light index lists
+		///
+		void begin(
+			const glm::mat4& view_matrix,
+			const glm::mat4& proj_matrix,
+			std::span<const ClusterLight> lights
+		) noexcept;
+
+		///
+		/// @brief Assign lights to every cluster of a depth slice
+		/// @note Concurrent calls with different slices are safe
+		///
+		/// @param slice Depth slice, less than `dimension.z`
+		///
+		void build_slice(uint32_t slice) noexcept;
+
+		///
+		/// @brief Merge the light lists of all slices
+		/// @note Call after `build_slice` returned for every slice
+		///
+		void finish() noexcept;
+
+		///
+		/// @brief Run `begin`, `build_slice` over all slices and `finish` on the calling thread
+		///
+		void build(
+			const glm::mat4& view_matrix,
+			const glm::mat4& proj_matrix,
+			std::span<const ClusterLight> lights
+		) noexcept;
+
+		///
+		/// @brief Get the scale and bias mapping view distance to depth slice
+		/// @details `slice = floor(log(distance) * scale + bias)`, clamped to 0 below
+		///
+		/// @return Scale and bias
+		///
+		glm::vec2 get_slice_scale_bias() const noexcept;
+
+		// Light list of every cluster, valid after `finish`
+		std::span<const Range> get_ranges() const noexcept { return ranges; }
+
+		// Light indices referred to by the ranges, valid after `finish`
+		std::span<const uint32_t> get_light_indices() const noexcept { return light_indices; }
+
+		const Config& get_config() const noexcept { return config; }
+
+	  private:
+
+		// Side planes of a column or row through the eye, as slopes of view-space x or y over distance
+		struct Band
+		{
+			float low_slope, high_slope;
+			float low_scale, high_scale;  // Normalize plane distances, `1 / sqrt(1 + slope^2)`
+		};
+
+		// Lights in view space as SoA, distance along the view direction as `d`, padded to 8 lights
+		struct ViewLights
+		{
+			std::vector<float> x, y, d, radius;
+			std::vector<float> axis_x, axis_y, axis_d;
+			std::vector<float> cone_cos, cone_sin;
+			std::vector<float> back_range;  // Reach behind the apex, 0 for spot lights
+
+			void clear() noexcept;
+			void push_back(
+				const glm::vec3& position,
+				float radius,
+				const glm::vec3& axis,
+				float cone_cos,
+				float cone_sin,
+				float back_range
+			) noexcept;
+			void pad() noexcept;
+			size_t size() const noexcept { return x.size(); }
+		};
+
+		// Per depth slice state, reused across frames
+		struct SliceScratch
+		{
+			ViewLights lights;                  // Lights overlapping the slice depth range
+			std::vector<uint32_t> light_index;  // Global index of each slice light
+			std::vector<uint64_t> column_mask;  // Per column, bitset of slice lights
+			std::vector<uint64_t> row_mask;     // Per row, bitset of slice lights
+			std::vector<uint32_t> indices;      // Light lists of the slice clusters
+		};
+
+		Config config;
+
+		std::vector<Band> columns, rows;
+		std::vector<float> slice_bounds;  // View distance boundaries, `dimension.z + 1` values
+
+		ViewLights view_lights;
+		std::vector<SliceScratch> slice_scratch;
+
+		std::vector<Range> ranges;
+		std::vector<uint32_t> light_indices;
+
+		explicit LightCluster(const Config& config) noexcept;
+
+	  public:
+
+		LightCluster(const LightCluster&) = delete;
+		LightCluster(LightCluster&&) = default;
+		LightCluster& operator=(const LightCluster&) = delete;
+		LightCluster& operator=(LightCluster&&) = default;
+	};
+}
@@ -0,0 +1,120 @@
+///
+/// @file occlusion.hpp
+/// @brief Provides a software occlusion buffer, rasterizing occluders at low resolution on the CPU
+///
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace graphics
+{
+	///
+	/// @brief Simplified triangle mesh used as an occluder
+	///
+	struct OccluderMesh
+	{
+		std::vector<glm::vec3> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	///
+	/// @brief Low-resolution depth buffer for conservative occlusion culling
+	/// @details
+	/// - Uses reversed Z: larger depth is nearer, the buffer clears to 0 (infinitely far).
+	/// - Occluders are rasterized with 8-wide SIMD into a per-pixel depth buffer, storing the farthest
+	/// depth each triangle reaches inside the pixel. A per-tile minimum forms the second level.
+	/// - Boxes are tested against the tile level first, then against pixels of partially covered tiles.
+	/// - Triangles crossing the near plane are dropped, which can only make culling less aggressive.
+	/// - Coverage is sampled at pixel centers, so occluder silhouettes are exact to half a pixel only.
+	///
+	/// Typical use per frame:
+	/// 1. `begin` with the view-projection matrix
+	/// 2. `add_occluder` for each occluder
+	/// 3. `rasterize` over disjoint tile-row ranges, possibly on multiple threads
+	/// 4. `test_box` from any number of threads
+	///
+	class OcclusionBuffer
+	{
+	  public:
+
+		static constexpr uint32_t tile_size = 8;  // Tiles are `tile_size` x `tile_size` pixels
+
+		///
+		/// @brief Create an occlusion buffer
+		///
+		/// @param resolution Buffer resolution, rounded up to whole tiles
+		///
+		explicit OcclusionBuffer(glm::u32vec2 resolution) noexcept;
+
+		///
+		/// @brief Start a new frame, dropping all occluders
+		///
+		/// @param view_projection View-projection matrix with reversed Z
+		///
+		void begin(const glm::mat4& view_projection) noexcept;
+
+		///
+		/// @brief Transform and set up the triangles of an occluder
+		/// @note Not thread-safe, call before `rasterize`
+		///
+		/// @param mesh Occluder mesh
+		/// @param world_matrix Model transform matrix (Local to World)
+		///
+		void add_occluder(const OccluderMesh& mesh, const glm::mat4& world_matrix) noexcept;
+
+		///
+		/// @brief Clear and rasterize all occluders into a range of tile rows
+		/// @note Concurrent calls with disjoint ranges are safe
+		///
+		/// @param tile_row_begin First tile row
+		/// @param tile_row_end Past-the-end tile row, clamped to `get_tile_rows()`
+		///
+		void rasterize(uint32_t tile_row_begin, uint32_t tile_row_end) noexcept;
+
+		///
+		/// @brief Tell if a world-space AABB may be visible behind the rasterized occluders
+		/// @note Conservative up to occluder edge sampling. Thread-safe after `rasterize`.
+		///
+		/// @param box_min World space AABB minimum
+		/// @param box_max World space AABB maximum
+		/// @return False if the box is entirely hidden, true otherwise
+		///
+		bool test_box(const glm::vec3& box_min, const glm::vec3& box_max) const noexcept;
+
+		// Number of tile rows, the unit of `rasterize`
+		uint32_t get_tile_rows() const noexcept { return tile_count.y; }
+
+		// Number of triangles set up this frame
+		size_t get_triangle_count() const noexcept { return triangles.size(); }
+
+		// Buffer resolution in pixels
+		glm::u32vec2 get_resolution() const noexcept { return resolution; }
+
+	  private:
+
+		// Triangle in pixel space, ready for rasterization
+		struct Triangle
+		{
+			std::array<glm::vec3, 3> edges;  // Edge functions `a * x + b * y + c`, non-negative inside
+			glm::vec3 depth_plane;           // Depth as `a * x + b * y + c`
+			float depth_slack;               // Depth change from pixel center to its farthest corner
+			float depth_min;                 // Farthest vertex depth
+			glm::ivec2 bound_min;            // Pixel bounding box, inclusive
+			glm::ivec2 bound_max;
+		};
+
+		glm::u32vec2 resolution;
+		glm::u32vec2 tile_count;
+		glm::mat4 view_projection = glm::mat4(1.0f);
+
+		std::vector<float> depth;       // Per pixel, nearest occluder depth, row-major
+		std::vector<float> tile_depth;  // Per tile, farthest pixel depth
+		std::vector<Triangle> triangles;
+
+		void rasterize_triangle(const Triangle& triangle, int row_begin, int row_end) noexcept;
+	};
+}
@@ -0,0 +1,174 @@
+///
+/// @file portal.hpp
+/// @brief Provides cell-and-portal visibility, narrowing the view frustum through openings between cells
+///
+
+#pragma once
+
+#include "graphics/bvh.hpp"
+#include "util/error.hpp"
+
+#include <array>
+#include <cstdint>
+#include <expected>
+#include <glm/glm.hpp>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace graphics
+{
+	///
+	/// @brief Visible cells of a `PortalGraph` seen from one camera
+	/// @details Each view is a cell seen through a chain of portals, with the frustum narrowed by every
+	/// portal on the chain. A cell can be seen through several chains and thus have several views.
+	/// A default-constructed visibility is unrestricted and lets everything through.
+	///
+	struct PortalVisibility
+	{
+		struct View
+		{
+			uint32_t cell;
+			std::optional<Aabb> bounds;     // Cell bounds, empty for the outside cell
+			std::vector<glm::vec4> planes;  // Narrowed frustum, same convention as `compute_frustum_planes`
+		};
+
+		bool unrestricted = true;  // Visibility is unknown, e.g. the eye is outside every cell
+		bool has_outside_cell = false;
+
+		std::vector<View> views;
+		std::vector<Aabb> cell_bounds;       // Bounds of every bounded cell, visible or not
+		std::vector<uint8_t> visible_cells;  // Per cell, non-zero if the cell has a view
+
+		///
+		/// @brief Tell if a world-space AABB may be visible
+		/// @details A box is tested against views of the cells it overlaps. Boxes outside every bounded
+		/// cell belong to the outside cell, or are kept if the graph has none.
+		///
+		/// @param box_min World space AABB minimum
+		/// @param box_max World space AABB maximum
+		/// @return False if the box is hidden behind walls, true otherwise
+		///
+		bool test_box(const glm::vec3& box_min, const glm::vec3& box_max) const noexcept;
+
+		// Whether a cell is visible through any chain of portals
+		bool is_cell_visible(uint32_t cell) const noexcept
+		{
+			return unrestricted || (cell < visible_cells.size() && visible_cells[cell] != 0);
+		}
+	};
+
+	///
+	/// @brief Graph of cells connected by quad portals
+	/// @details
+	/// - A cell is an AABB, or the unbounded outside cell (at most one) holding everything not in another
+	/// cell.
+	/// - A portal is a planar quad between two cells, e.g. a doorway or a window, and can be closed.
+	/// - Visibility is found by recursively clipping the frustum through open portals, starting from the
+	/// cells holding the eye.
+	///
+	class PortalGraph
+	{
+	  public:
+
+		struct Cell
+		{
+			std::optional<Aabb> bounds;  // Empty for the outside cell
+		};
+
+		struct Portal
+		{
+			std::array<glm::vec3, 4> corners;  // Quad corners, in winding order
+			std::array<uint32_t, 2> cells;     // Cells on both sides
+		};
+
+		struct Config
+		{
+			uint32_t max_depth = 8;    // Maximum portals on a chain
+			uint32_t max_views = 64;   // Views beyond this count make the visibility unrestricted
+			float eye_margin = 0.05f;  // Portals closer to the eye are passed without narrowing
+		};
+
+		PortalGraph() = default;
+
+		///
+		/// @brief Create a portal graph, validating cell indices
+		///
+		/// @param cells Cells
+		/// @param portals Portals between cells
+		/// @return Portal graph, or error if a portal refers to a missing cell or several cells are unbounded
+		///
+		static std::expected<PortalGraph, util::Error> create(
+			std::vector<Cell> cells,
+			std::vector<Portal> portals
+		) noexcept;
+
+		///
+		/// @brief Compute visible cells with default configuration
+		///
+		/// @param eye_position Eye position in world space
+		/// @param view_projection View-projection matrix
+		/// @param portal_open Per portal, non-zero if open. Missing entries count as open.
+		/// @return Visibility, unrestricted if the eye is in no cell and there is no outside cell
+		///
+		PortalVisibility compute_visibility(
+			const glm::vec3& eye_position,
+			const glm::mat4& view_projection,
+			std::span<const uint8_t> portal_open
+		) const noexcept;
+
+		///
+		/// @brief Compute visible cells
+		///
+		/// @param eye_position Eye position in world space
+		/// @param view_projection View-projection matrix
+		/// @param portal_open Per portal, non-zero if open. Missing entries count as open.
+		/// @param config Traversal configuration
+		/// @return Visibility, unrestricted if the eye is in no cell and there is no outside cell
+		///
+		PortalVisibility compute_visibility(
+			const glm::vec3& eye_position,
+			const glm::mat4& view_projection,
+			std::span<const uint8_t> portal_open,
+			const Config& config
+		) const noexcept;
+
+		// Cells of the graph
+		std::span<const Cell> get_cells() const noexcept { return cells; }
+
+		// Portals of the graph
+		std::span<const Portal> get_portals() const noexcept { return portals; }
+
+	  private:
+
+		std::vector<Cell> cells;
+		std::vector<Portal> portals;
+		std::vector<std::vector<uint32_t>> cell_portals;  // Portal indices adjacent to each cell
+
+		PortalGraph(std::vector<Cell> cells, std::vector<Portal> portals) noexcept;
+	};
+
+	///
+	/// @brief Clip a convex polygon against planes, keeping the part where all planes are non-negative
+	///
+	/// @param polygon Convex polygon vertices, in winding order
+	/// @param planes Planes, same convention as `compute_frustum_planes`
+	/// @return Clipped polygon, fewer than 3 vertices if nothing is left
+	///
+	std::vector<glm::vec3> clip_polygon(
+		std::span<const glm::vec3> polygon,
+		std::span<const glm::vec4> planes
+	) noexcept;
+
+	///
+	/// @brief Build the frustum side planes from an eye through a convex polygon
+	///
+	/// @param eye_position Eye position
+	/// @param polygon Convex polygon vertices, in winding order, not containing the eye
+	/// @return One plane per non-degenerate polygon edge, facing the inside of the polygon
+	///
+	std::vector<glm::vec4> compute_portal_planes(
+		const glm::vec3& eye_position,
+		std::span<const glm::vec3> polygon
+	) noexcept;
+}
@@ -0,0 +1,203 @@
+///
+/// @file shadow-schedule.hpp
+/// @brief Provides shadow caster culling against visible receivers, and caching decisions of shadow cascades
+///
+
+#pragma once
+
+#include "graphics/smallest-bound.hpp"
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <limits>
+#include <vector>
+
+namespace graphics
+{
+	///
+	/// @brief Coarse light-space map of shadow receivers, for culling casters that can't shadow any of them
+	/// @details
+	/// - Light-space depth is the distance along the light view direction, larger depth is closer to the
+	/// light. A caster can only shadow points with a smaller depth than its own.
+	/// - Each cell of a grid over the cascade rectangle keeps the smallest depth any receiver reaches in it.
+	/// - A caster is kept if a cell under its light-space rectangle holds a receiver reaching below the
+	/// caster's largest depth, i.e. the caster extruded away from the light hits a receiver.
+	///
+	/// Typical use per frame:
+	/// 1. `begin` with the cascade's light-space bound
+	/// 2. `add_receiver` for each visible receiver
+	/// 3. `test_caster` from any number of threads
+	///
+	class ShadowReceiverMask
+	{
+	  public:
+
+		static constexpr uint32_t resolution = 64;  // Cells along each side of the cascade rectangle
+
+		ShadowReceiverMask() noexcept;
+
+		///
+		/// @brief Start a new frame, dropping all receivers
+		///
+		/// @param bound Light-space bound of the cascade
+		///
+		void begin(const SmallestBound& bound) noexcept;
+
+		///
+		/// @brief Add a receiver
+		/// @note Not thread-safe, call before `test_caster`
+		///
+		/// @param box_min World space AABB minimum
+		/// @param box_max World space AABB maximum
+		///
+		void add_receiver(const glm::vec3& box_min, const glm::vec3& box_max) noexcept;
+
+		///
+		/// @brief Tell if a caster may cast a shadow onto a receiver
+		/// @note Thread-safe after all receivers are added
+		///
+		/// @param box_min World space AABB minimum
+		/// @param box_max World space AABB maximum
+		/// @return False if the caster shadows no receiver, true otherwise
+		///
+		bool test_caster(const glm::vec3& box_min, const glm::vec3& box_max) const noexcept;
+
+		// Number of receivers added this frame
+		size_t get_receiver_count() const noexcept { return receiver_count; }
+
+	  private:
+
+		// Light-space box, xy in cells, z as depth
+		struct LightBox
+		{
+			glm::ivec2 cell_min;  // Inclusive
+			glm::ivec2 cell_max;  // Inclusive
+			float depth_min;
+			float depth_max;
+			bool inside;  // Overlaps the cascade rectangle
+		};
+
+		glm::mat4 view_matrix = glm::mat4(1.0f);
+		glm::vec2 rect_min = glm::vec2(0.0f);
+		glm::vec2 cell_scale = glm::vec2(0.0f);  // Cells per light-space unit
+
+		std::vector<float> cell_depth;  // Per cell, smallest receiver depth, row-major
+		size_t receiver_count = 0;
+
+		LightBox to_light_box(const glm::vec3& box_min, const glm::vec3& box_max) const noexcept;
+	};
+
+	///
+	/// @brief Projection and refresh decisions of one cached shadow cascade
+	/// @details
+	/// The shadow map of a cached cascade is composed of a static layer, holding static casters, and
+	/// dynamic casters drawn over a copy of it every refresh.
+	/// - The projection is a square around the bounding sphere of the cascade slice, with a margin and its
+	/// center snapped to whole texels. Its size doesn't depend on the camera orientation, and it is kept
+	/// while the slice stays inside, so small camera moves keep the static layer valid.
+	/// - The depth range is padded and kept while the casters stay inside it.
+	/// - The static layer is rebuilt when the projection is refit, the light direction moves past a
+	/// threshold, the static scene changes, or the casters leave the depth range.
+	/// - Otherwise dynamic casters are refreshed every `refresh_interval` frames, and the shadow map is
+	/// left untouched in between or when it holds no dynamic caster.
+	///
+	/// Typical use per frame:
+	/// 1. `fit` to get the bound used for culling
+	/// 2. `decide` with the depth range of the dynamic casters
+	/// 3. On `Action::Rebuild`, `commit_rebuild` with the depth range of all casters
+	/// 4. Render and sample with the fitted bound and `get_depth_range`
+	///
+	class ShadowCascadeCache
+	{
+	  public:
+
+		struct Config
+		{
+			float margin = 0.1f;                // Extra extent around the slice, relative to its radius
+			float shrink_ratio = 0.6f;          // Refit when the slice shrinks below this ratio of the bound
+			float direction_threshold = 5e-5f;  // Rebuild past this `1 - cos` of the direction change
+			float depth_margin = 0.1f;          // Extra depth range, relative to the caster depth range
+			uint32_t refresh_interval = 1;      // Frames between dynamic caster refreshes
+			uint32_t refresh_phase = 0;         // Frame offset of refreshes, spreads cascades over frames
+		};
+
+		enum class Action : uint8_t
+		{
+			Rebuild,  // Draw static casters into the static layer, then refresh
+			Refresh,  // Copy the static layer into the shadow map, then draw dynamic casters
+			Skip      // Keep the shadow map of a previous frame
+		};
+
+		// Depth range of casters, distance along the light view direction. Empty if `near > far`.
+		struct DepthRange
+		{
+			float near = std::numeric_limits<float>::max();
+			float far = std::numeric_limits<float>::lowest();
+		};
+
+		// Frame state given to `decide`
+		struct FrameInfo
+		{
+			DepthRange dynamic_range;   // Depth range of the dynamic casters
+			bool has_dynamic_casters;   // Whether any dynamic caster is drawn this frame
+			uint64_t static_signature;  // Changes whenever the static casters change
+			uint64_t frame_index;
+		};
+
+		///
+		/// @brief Fit the light-space bound of the cascade
+		///
+		/// @param slice_corners Corners of the camera frustum slice covered by the cascade, in world space
+		/// @param light_direction Light view direction
+		/// @param resolution Shadow map resolution, for texel snapping
+		/// @param config Cache configuration
+		/// @return Light-space bound, used for culling casters of this frame
+		///
+		SmallestBound fit(
+			const std::array<glm::vec3, 8>& slice_corners,
+			const glm::vec3& light_direction,
+			uint32_t resolution,
+			const Config& config
+		) noexcept;
+
+		///
+		/// @brief Decide how the cascade is updated this frame
+		/// @note Call once per frame after `fit`
+		///
+		/// @param frame Frame state
+		/// @param config Cache configuration
+		/// @return Update action
+		///
+		Action decide(const FrameInfo& frame, const Config& config) noexcept;
+
+		///
+		/// @brief Set the depth range of a rebuilt static layer
+		/// @note Call after `decide` returned `Action::Rebuild`
+		///
+		/// @param caster_range Depth range of all casters, static and dynamic
+		/// @param config Cache configuration
+		///
+		void commit_rebuild(const DepthRange& caster_range, const Config& config) noexcept;
+
+		///
+		/// @brief Drop the cached static layer, the next `decide` will rebuild
+		/// @note Call when a decided update didn't reach the GPU
+		///
+		void invalidate() noexcept { valid = false; }
+
+		// Depth range of the cached shadow map
+		DepthRange get_depth_range() const noexcept { return depth_range; }
+
+	  private:
+
+		bool valid = false;                // Static layer matches the bound, direction and signature
+		bool refit_pending = false;        // `fit` replaced the bound, the static layer is outdated
+		bool has_dynamic_content = false;  // Shadow map holds dynamic casters over the static layer
+
+		SmallestBound bound{};
+		glm::vec3 light_direction = glm::vec3(0.0f);
+		DepthRange depth_range = {.near = 0.0f, .far = 1.0f};
+		uint64_t static_signature = 0;
+	};
+}
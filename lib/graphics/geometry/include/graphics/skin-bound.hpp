@@ -0,0 +1,71 @@
+///
+/// @file skin-bound.hpp
+/// @brief Provides tight bounds of skinned meshes, from per-joint boxes precomputed at load time
+///
+
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace graphics
+{
+	///
+	/// @brief Per-joint boxes of a skinned mesh, transformed by the joint matrices to bound the posed mesh
+	/// @details
+	/// - Each joint owns the bind-pose box of the vertices it influences with a weight above
+	/// `weight_threshold`. A skinned vertex is a weighted average of its position transformed by each
+	/// influencing joint, so it stays inside the union of the transformed boxes.
+	/// - Only joints influencing at least one vertex are kept, as SoA center and half extent, padded to 8
+	/// joints by repeating the first one.
+	///
+	class SkinBound
+	{
+	  public:
+
+		// Influences of this weight or less are ignored, glTF pads unused joint slots with zero weights
+		static constexpr float weight_threshold = 0.0f;
+
+		///
+		/// @brief Compute the per-joint boxes of a skinned mesh
+		///
+		/// @param positions Bind-pose vertex positions
+		/// @param joint_indices Joint indices of each vertex, indexing the skin joints
+		/// @param joint_weights Joint weights of each vertex
+		/// @return Skin bound, empty if no vertex has any influence
+		///
+		static SkinBound build(
+			std::span<const glm::vec3> positions,
+			std::span<const glm::uvec4> joint_indices,
+			std::span<const glm::vec4> joint_weights
+		) noexcept;
+
+		///
+		/// @brief Compute the world AABB of the posed mesh
+		/// @note Joint matrices must be affine, and cover every joint index, see `get_joint_count()`
+		///
+		/// @param joint_matrices Joint matrices of the skin, `joint_world * inverse_bind`
+		/// @return World space AABB (min, max)
+		///
+		std::pair<glm::vec3, glm::vec3> compute_world_bound(
+			std::span<const glm::mat4> joint_matrices
+		) const noexcept;
+
+		// True if no joint influences any vertex
+		bool empty() const noexcept { return joint_count == 0; }
+
+		// Minimum number of joint matrices needed by `compute_world_bound`
+		uint32_t get_joint_count() const noexcept { return joint_count; }
+
+	  private:
+
+		std::vector<int32_t> joints;  // Influencing joint indices
+		std::vector<float> center_x, center_y, center_z;
+		std::vector<float> extent_x, extent_y, extent_z;
+
+		uint32_t joint_count = 0;  // Largest influencing joint index plus one
+	};
+}
@@ -11,6 +11,9 @@ namespace graphics
 		float left, right, top, bottom;
 	};
 
+	// Get a view matrix that looks in the direction of `view_dir`. Automatically chooses an up vector.
+	glm::mat4 get_light_view_matrix(const glm::vec3& view_dir) noexcept;
+
 	SmallestBound find_smallest_bound(
 		const std::array<glm::vec3, 8>& frustum_corners,
 		const glm::vec3& view_dir
@@ -0,0 +1,525 @@
+#include "graphics/bvh.hpp"
+#include "graphics/culling.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <ranges>
+
+namespace graphics
+{
+	namespace
+	{
+		Aabb empty_box() noexcept
+		{
+			return {
+				.min = glm::vec3(std::numeric_limits<float>::max()),
+				.max = glm::vec3(std::numeric_limits<float>::lowest())
+			};
+		}
+
+		Aabb merge_box(const Aabb& a, const Aabb& b) noexcept
+		{
+			return {.min = glm::min(a.min, b.min), .max = glm::max(a.max, b.max)};
+		}
+
+		float surface_area(const Aabb& box) noexcept
+		{
+			const glm::vec3 extent = glm::max(box.max - box.min, glm::vec3(0.0f));
+			return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+		}
+
+		bool box_overlap(const Aabb& a, const Aabb& b) noexcept
+		{
+			return glm::all(glm::lessThanEqual(a.min, b.max)) && glm::all(glm::lessThanEqual(b.min, a.max));
+		}
+
+		// Intermediate binary node, covers `[first, first + count)` of the leaf order
+		struct BinaryNode
+		{
+			Aabb bounds;
+			uint32_t first;
+			uint32_t count;
+			uint32_t left = 0;  // Left child, 0 for leaves since the root is never a child
+			uint32_t right = 0;
+
+			bool is_leaf() const noexcept { return left == 0; }
+		};
+
+		struct SplitResult
+		{
+			uint32_t axis;
+			uint32_t bin;  // Primitives in bins below go left
+			float origin;  // Centroid bound minimum along the axis
+			float scale;   // Bins per unit length along the axis
+			float cost;
+
+			// Same binning expression as `find_sah_split`, so no primitive changes side
+			bool is_left(const glm::vec3& centroid) const noexcept
+			{
+				return uint32_t((centroid[axis] - origin) * scale) < bin;
+			}
+		};
+
+		// Primitive data used during build, partitioned in place to keep accesses sequential
+		struct BuildPrimitive
+		{
+			Aabb box;
+			glm::vec3 centroid;
+			uint32_t index;
+		};
+
+		// Find the cheapest binned SAH split over all axes, return nothing if all centroids coincide
+		std::optional<SplitResult> find_sah_split(
+			std::span<const BuildPrimitive> primitives,
+			const Aabb& centroid_bounds,
+			uint32_t bin_count
+		) noexcept
+		{
+			struct Bin
+			{
+				Aabb bounds = empty_box();
+				uint32_t count = 0;
+			};
+
+			const glm::vec3 extent = centroid_bounds.max - centroid_bounds.min;
+			const glm::vec3 scale = glm::vec3(
+				extent.x > 0.0f ? float(bin_count) / extent.x : 0.0f,
+				extent.y > 0.0f ? float(bin_count) / extent.y : 0.0f,
+				extent.z > 0.0f ? float(bin_count) / extent.z : 0.0f
+			);
+
+			// Bin all axes in one pass over the primitives
+			std::array<std::vector<Bin>, 3> bins;
+			for (auto& axis_bins : bins) axis_bins.resize(bin_count);
+
+			for (const auto& primitive : primitives)
+			{
+				const glm::vec3 bin_pos = (primitive.centroid - centroid_bounds.min) * scale;
+
+				for (const uint32_t axis : std::views::iota(0u, 3u))
+				{
+					auto& bin = bins[axis][std::min(uint32_t(bin_pos[axis]), bin_count - 1)];
+					bin.bounds = merge_box(bin.bounds, primitive.box);
+					bin.count++;
+				}
+			}
+
+			std::vector<float> right_area(bin_count);
+			std::vector<uint32_t> right_count(bin_count);
+			std::optional<SplitResult> best;
+
+			for (const uint32_t axis : std::views::iota(0u, 3u))
+			{
+				if (extent[axis] <= 0.0f) continue;
+				const auto& axis_bins = bins[axis];
+
+				// Sweep from the right, then evaluate splits sweeping from the left
+				Aabb accumulated = empty_box();
+				uint32_t accumulated_count = 0;
+				for (const uint32_t bin_idx : std::views::iota(1u, bin_count) | std::views::reverse)
+				{
+					accumulated = merge_box(accumulated, axis_bins[bin_idx].bounds);
+					accumulated_count += axis_bins[bin_idx].count;
+					right_area[bin_idx] = surface_area(accumulated);
+					right_count[bin_idx] = accumulated_count;
+				}
+
+				accumulated = empty_box();
+				accumulated_count = 0;
+				for (const uint32_t bin_idx : std::views::iota(1u, bin_count))
+				{
+					accumulated = merge_box(accumulated, axis_bins[bin_idx - 1].bounds);
+					accumulated_count += axis_bins[bin_idx - 1].count;
+					if (accumulated_count == 0 || right_count[bin_idx] == 0) continue;
+
+					const float cost = surface_area(accumulated) * float(accumulated_count)
+						+ right_area[bin_idx] * float(right_count[bin_idx]);
+
+					if (!best.has_value() || cost < best->cost)
+						best = SplitResult{
+							.axis = axis,
+							.bin = bin_idx,
+							.origin = centroid_bounds.min[axis],
+							.scale = scale[axis],
+							.cost = cost
+						};
+				}
+			}
+
+			return best;
+		}
+
+		// Build a binary hierarchy, reordering `primitives` so that every node covers a contiguous range
+		std::vector<BinaryNode> build_binary(
+			std::span<BuildPrimitive> primitives,
+			const Bvh::BuildConfig& config
+		) noexcept
+		{
+			std::vector<BinaryNode> binary_nodes;
+			binary_nodes.reserve(primitives.size() * 2 / std::max(config.max_leaf_size, 1u) + 1);
+			binary_nodes.push_back({.bounds = empty_box(), .first = 0, .count = uint32_t(primitives.size())});
+
+			std::vector<uint32_t> stack = {0};
+			while (!stack.empty())
+			{
+				const uint32_t node_idx = stack.back();
+				stack.pop_back();
+
+				const uint32_t first = binary_nodes[node_idx].first;
+				const uint32_t count = binary_nodes[node_idx].count;
+				const auto range = primitives.subspan(first, count);
+
+				Aabb bounds = empty_box(), centroid_bounds = empty_box();
+				for (const auto& primitive : range)
+				{
+					bounds = merge_box(bounds, primitive.box);
+					centroid_bounds.min = glm::min(centroid_bounds.min, primitive.centroid);
+					centroid_bounds.max = glm::max(centroid_bounds.max, primitive.centroid);
+				}
+				binary_nodes[node_idx].bounds = bounds;
+
+				if (count <= config.max_leaf_size) continue;
+
+				// Split by SAH, fall back to a median split when all centroids coincide
+				const auto split = find_sah_split(range, centroid_bounds, std::max(config.bin_count, 2u));
+
+				uint32_t left_count = count / 2;
+				if (split.has_value())
+				{
+					const auto right_part = std::ranges::partition(range, [&split](const auto& primitive) {
+						return split->is_left(primitive.centroid);
+					});
+					left_count = uint32_t(right_part.begin() - range.begin());
+				}
+
+				if (left_count == 0 || left_count == count) left_count = count / 2;
+
+				const auto left_idx = uint32_t(binary_nodes.size());
+				binary_nodes.push_back({.bounds = empty_box(), .first = first, .count = left_count});
+				binary_nodes.push_back(
+					{.bounds = empty_box(), .first = first + left_count, .count = count - left_count}
+				);
+
+				binary_nodes[node_idx].left = left_idx;
+				binary_nodes[node_idx].right = left_idx + 1;
+
+				stack.push_back(left_idx + 1);
+				stack.push_back(left_idx);
+			}
+
+			return binary_nodes;
+		}
+
+		void set_slot_bounds(Bvh::Node& node, uint32_t slot, const Aabb& box) noexcept
+		{
+			node.min_x[slot] = box.min.x;
+			node.min_y[slot] = box.min.y;
+			node.min_z[slot] = box.min.z;
+			node.max_x[slot] = box.max.x;
+			node.max_y[slot] = box.max.y;
+			node.max_z[slot] = box.max.z;
+		}
+
+		Aabb get_slot_bounds(const Bvh::Node& node, uint32_t slot) noexcept
+		{
+			return {
+				.min = {node.min_x[slot], node.min_y[slot], node.min_z[slot]},
+				.max = {node.max_x[slot], node.max_y[slot], node.max_z[slot]}
+			};
+		}
+
+		Bvh::Node empty_node() noexcept
+		{
+			Bvh::Node node;
+
+			for (const uint32_t slot : std::views::iota(0u, Bvh::node_width))
+			{
+				set_slot_bounds(node, slot, empty_box());
+				node.child[slot] = Bvh::leaf_child;
+				node.first[slot] = 0;
+				node.count[slot] = 0;
+			}
+
+			return node;
+		}
+	}
+
+	Bvh Bvh::build(std::span<const Aabb> boxes) noexcept
+	{
+		return build(boxes, BuildConfig{});
+	}
+
+	Bvh Bvh::build(std::span<const Aabb> boxes, const BuildConfig& config) noexcept
+	{
+		Bvh bvh;
+		if (boxes.empty()) return bvh;
+
+		auto primitives =
+			boxes
+			| std::views::enumerate
+			| std::views::transform([](const auto& pair) {
+				  const auto& [index, box] = pair;
+				  return BuildPrimitive{
+					  .box = box,
+					  .centroid = (box.min + box.max) * 0.5f,
+					  .index = uint32_t(index)
+				  };
+			  })
+			| std::ranges::to<std::vector>();
+
+		const auto binary_nodes = build_binary(primitives, config);
+
+		bvh.primitive_indices =
+			primitives | std::views::transform(&BuildPrimitive::index) | std::ranges::to<std::vector>();
+		bvh.primitive_boxes =
+			primitives | std::views::transform(&BuildPrimitive::box) | std::ranges::to<std::vector>();
+
+		bvh.primitive_positions.resize(boxes.size());
+		for (const auto [position, index] : bvh.primitive_indices | std::views::enumerate)
+			bvh.primitive_positions[index] = uint32_t(position);
+
+		bvh.primitive_nodes.resize(boxes.size());
+
+		/* Collapse into wide nodes, emitted in depth-first pre-order */
+
+		struct Pending
+		{
+			uint32_t binary_index;
+			uint32_t parent;
+			uint32_t parent_slot;
+		};
+
+		std::vector<Pending> stack = {{.binary_index = 0, .parent = no_parent, .parent_slot = 0}};
+		std::vector<uint32_t> slots;
+
+		while (!stack.empty())
+		{
+			const auto pending = stack.back();
+			stack.pop_back();
+
+			const auto node_idx = uint32_t(bvh.nodes.size());
+			bvh.nodes.push_back(empty_node());
+			bvh.node_parents.push_back(pending.parent);
+			if (pending.parent != no_parent) bvh.nodes[pending.parent].child[pending.parent_slot] = node_idx;
+
+			// Open the interior slot with the largest surface area until all slots are used
+			slots.clear();
+			const auto& binary_node = binary_nodes[pending.binary_index];
+			if (binary_node.is_leaf())
+				slots.push_back(pending.binary_index);
+			else
+				slots.append_range(std::array{binary_node.left, binary_node.right});
+
+			while (slots.size() < node_width)
+			{
+				auto openable = slots | std::views::filter([&binary_nodes](uint32_t index) {
+									return !binary_nodes[index].is_leaf();
+								});
+				const auto largest = std::ranges::max_element(openable, {}, [&binary_nodes](uint32_t index) {
+					return surface_area(binary_nodes[index].bounds);
+				});
+				if (largest == openable.end()) break;
+
+				const auto opened = binary_nodes[*largest];
+				*largest = opened.left;
+				slots.push_back(opened.right);
+			}
+
+			auto& node = bvh.nodes[node_idx];
+			for (const auto [slot, binary_index] : slots | std::views::enumerate)
+			{
+				const auto& slot_node = binary_nodes[binary_index];
+
+				set_slot_bounds(node, uint32_t(slot), slot_node.bounds);
+				node.first[slot] = slot_node.first;
+				node.count[slot] = slot_node.count;
+
+				if (slot_node.is_leaf())
+					for (const uint32_t index :
+						 std::span(bvh.primitive_indices).subspan(slot_node.first, slot_node.count))
+						bvh.primitive_nodes[index] = node_idx;
+			}
+
+			// Push in reverse so that the first slot is emitted next
+			for (const auto [slot, binary_index] : slots | std::views::enumerate | std::views::reverse)
+				if (!binary_nodes[binary_index].is_leaf())
+					stack.push_back(
+						{.binary_index = binary_index, .parent = node_idx, .parent_slot = uint32_t(slot)}
+					);
+		}
+
+		return bvh;
+	}
+
+	void Bvh::refit_node(uint32_t node_index) noexcept
+	{
+		auto& node = nodes[node_index];
+
+		for (const uint32_t slot : std::views::iota(0u, node_width))
+		{
+			if (node.count[slot] == 0) continue;
+
+			Aabb bounds = empty_box();
+
+			if (node.child[slot] == leaf_child)
+			{
+				for (const auto& box : std::span(primitive_boxes).subspan(node.first[slot], node.count[slot]))
+					bounds = merge_box(bounds, box);
+			}
+			else
+			{
+				const auto& child = nodes[node.child[slot]];
+				for (const uint32_t child_slot : std::views::iota(0u, node_width))
+					if (child.count[child_slot] != 0)
+						bounds = merge_box(bounds, get_slot_bounds(child, child_slot));
+			}
+
+			set_slot_bounds(node, slot, bounds);
+		}
+	}
+
+	void Bvh::refit(std::span<const Aabb> boxes) noexcept
+	{
+		for (const auto [position, index] : primitive_indices | std::views::enumerate)
+			primitive_boxes[position] = boxes[index];
+
+		// Children come after their parent, refit in reverse order
+		for (const uint32_t node_idx : std::views::iota(0u, uint32_t(nodes.size())) | std::views::reverse)
+			refit_node(node_idx);
+	}
+
+	void Bvh::refit(std::span<const Aabb> boxes, std::span<const uint32_t> changed) noexcept
+	{
+		std::vector<uint32_t> dirty_nodes;
+		std::vector<bool> dirty(nodes.size(), false);
+
+		for (const uint32_t index : changed)
+		{
+			primitive_boxes[primitive_positions[index]] = boxes[index];
+
+			for (uint32_t node_idx = primitive_nodes[index]; node_idx != no_parent && !dirty[node_idx];
+				 node_idx = node_parents[node_idx])
+			{
+				dirty[node_idx] = true;
+				dirty_nodes.push_back(node_idx);
+			}
+		}
+
+		std::ranges::sort(dirty_nodes, std::greater{});
+		for (const uint32_t node_idx : dirty_nodes) refit_node(node_idx);
+	}
+
+	void Bvh::accept_slot(const Node& node, uint32_t slot, std::pmr::vector<uint32_t>& result) const noexcept
+	{
+		result.append_range(std::span(primitive_indices).subspan(node.first[slot], node.count[slot]));
+	}
+
+	void Bvh::query_frustum(
+		std::span<const glm::vec4> planes,
+		std::pmr::vector<uint32_t>& result
+	) const noexcept
+	{
+		if (nodes.empty()) return;
+
+		std::pmr::vector<uint32_t> stack({0}, result.get_allocator());
+		while (!stack.empty())
+		{
+			const auto& node = nodes[stack.back()];
+			stack.pop_back();
+
+			// Per slot: whether any plane rejects the box, and whether all planes contain it entirely
+			std::array<bool, node_width> outside, inside;
+			outside.fill(false);
+			inside.fill(true);
+
+			for (const auto& plane : planes)
+			{
+				// Pick positive and negative corners once per plane, so the lane loop is branchless
+				const auto& pos_x = plane.x >= 0 ? node.max_x : node.min_x;
+				const auto& pos_y = plane.y >= 0 ? node.max_y : node.min_y;
+				const auto& pos_z = plane.z >= 0 ? node.max_z : node.min_z;
+				const auto& neg_x = plane.x >= 0 ? node.min_x : node.max_x;
+				const auto& neg_y = plane.y >= 0 ? node.min_y : node.max_y;
+				const auto& neg_z = plane.z >= 0 ? node.min_z : node.max_z;
+
+				for (const uint32_t slot : std::views::iota(0u, node_width))
+				{
+					const float pos_dist =
+						plane.x * pos_x[slot] + plane.y * pos_y[slot] + plane.z * pos_z[slot] + plane.w;
+					const float neg_dist =
+						plane.x * neg_x[slot] + plane.y * neg_y[slot] + plane.z * neg_z[slot] + plane.w;
+
+					outside[slot] = outside[slot] || pos_dist < 0;
+					inside[slot] = inside[slot] && neg_dist >= 0;
+				}
+			}
+
+			for (const uint32_t slot : std::views::iota(0u, node_width))
+			{
+				if (node.count[slot] == 0 || outside[slot]) continue;
+
+				if (inside[slot])
+					accept_slot(node, slot, result);
+				else if (node.child[slot] != leaf_child)
+					stack.push_back(node.child[slot]);
+				else
+				{
+					for (const uint32_t position :
+						 std::views::iota(node.first[slot], node.first[slot] + node.count[slot]))
+					{
+						const auto& box = primitive_boxes[position];
+						if (box_in_frustum(box.min, box.max, planes))
+							result.push_back(primitive_indices[position]);
+					}
+				}
+			}
+		}
+	}
+
+	void Bvh::query_overlap(const Aabb& box, std::pmr::vector<uint32_t>& result) const noexcept
+	{
+		if (nodes.empty()) return;
+
+		std::pmr::vector<uint32_t> stack({0}, result.get_allocator());
+		while (!stack.empty())
+		{
+			const auto& node = nodes[stack.back()];
+			stack.pop_back();
+
+			std::array<bool, node_width> overlap, contained;
+			for (const uint32_t slot : std::views::iota(0u, node_width))
+			{
+				overlap[slot] = node.min_x[slot] <= box.max.x
+					&& node.min_y[slot] <= box.max.y
+					&& node.min_z[slot] <= box.max.z
+					&& node.max_x[slot] >= box.min.x
+					&& node.max_y[slot] >= box.min.y
+					&& node.max_z[slot] >= box.min.z;
+
+				contained[slot] = node.min_x[slot] >= box.min.x
+					&& node.min_y[slot] >= box.min.y
+					&& node.min_z[slot] >= box.min.z
+					&& node.max_x[slot] <= box.max.x
+					&& node.max_y[slot] <= box.max.y
+					&& node.max_z[slot] <= box.max.z;
+			}
+
+			for (const uint32_t slot : std::views::iota(0u, node_width))
+			{
+				if (node.count[slot] == 0 || !overlap[slot]) continue;
+
+				if (contained[slot])
+					accept_slot(node, slot, result);
+				else if (node.child[slot] != leaf_child)
+					stack.push_back(node.child[slot]);
+				else
+				{
+					for (const uint32_t position :
+						 std::views::iota(node.first[slot], node.first[slot] + node.count[slot]))
+						if (box_overlap(primitive_boxes[position], box))
+							result.push_back(primitive_indices[position]);
+				}
+			}
+		}
+	}
+}
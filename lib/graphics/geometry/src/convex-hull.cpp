@@ -0,0 +1,368 @@
+#include "graphics/convex-hull.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <format>
+#include <immintrin.h>
+#include <limits>
+#include <ranges>
+#include <set>
+
+namespace graphics
+{
+	namespace
+	{
+		// Hull triangle under construction, with the points still outside of it
+		struct Face
+		{
+			std::array<uint32_t, 3> vertices;
+			glm::vec3 normal;
+			float offset;
+			std::vector<uint32_t> outside;
+			bool alive = true;
+
+			float distance(const glm::vec3& point) const noexcept { return glm::dot(normal, point) + offset; }
+		};
+
+		Face make_face(std::span<const glm::vec3> points, uint32_t a, uint32_t b, uint32_t c) noexcept
+		{
+			const glm::vec3 normal = glm::normalize(glm::cross(points[b] - points[a], points[c] - points[a]));
+			return Face{.vertices = {a, b, c}, .normal = normal, .offset = -glm::dot(normal, points[a])};
+		}
+
+		// Move each point to the face it is farthest outside of, points inside every face are dropped
+		void assign_outside(
+			std::span<const glm::vec3> points,
+			std::span<const uint32_t> candidates,
+			std::span<Face> faces,
+			float epsilon
+		) noexcept
+		{
+			for (const auto point_idx : candidates)
+			{
+				Face* best_face = nullptr;
+				float best_distance = epsilon;
+
+				for (auto& face : faces)
+				{
+					if (!face.alive) continue;
+
+					const float distance = face.distance(points[point_idx]);
+					if (distance > best_distance)
+					{
+						best_distance = distance;
+						best_face = &face;
+					}
+				}
+
+				if (best_face != nullptr) best_face->outside.push_back(point_idx);
+			}
+		}
+
+		// Initial tetrahedron from extreme points, empty if the points are degenerate
+		std::vector<uint32_t> find_simplex(std::span<const glm::vec3> points, float epsilon) noexcept
+		{
+			std::array<uint32_t, 6> extremes{};
+			for (const auto [point_idx, point] : std::views::enumerate(points))
+				for (const auto axis : std::views::iota(0, 3))
+				{
+					uint32_t& low = extremes[axis * 2];
+					uint32_t& high = extremes[axis * 2 + 1];
+					if (point[axis] < points[low][axis]) low = uint32_t(point_idx);
+					if (point[axis] > points[high][axis]) high = uint32_t(point_idx);
+				}
+
+			// Farthest pair of extreme points
+			uint32_t a = extremes[0], b = extremes[1];
+			for (const auto [i, j] : std::views::cartesian_product(extremes, extremes))
+				if (glm::length(points[i] - points[j]) > glm::length(points[a] - points[b]))
+				{
+					a = i;
+					b = j;
+				}
+
+			if (glm::length(points[a] - points[b]) <= epsilon) return {};
+
+			// Farthest point from the line
+			const glm::vec3 line_dir = glm::normalize(points[b] - points[a]);
+			const auto line_distance = [&](uint32_t idx) {
+				const glm::vec3 offset = points[idx] - points[a];
+				return glm::length(offset - line_dir * glm::dot(offset, line_dir));
+			};
+
+			const auto indices = std::views::iota(0u, uint32_t(points.size()));
+			const uint32_t c = *std::ranges::max_element(indices, {}, line_distance);
+			if (line_distance(c) <= epsilon) return {};
+
+			// Farthest point from the plane
+			const Face base = make_face(points, a, b, c);
+			const auto plane_distance = [&](uint32_t idx) { return std::abs(base.distance(points[idx])); };
+
+			const uint32_t d = *std::ranges::max_element(indices, {}, plane_distance);
+			if (plane_distance(d) <= epsilon) return {};
+
+			return {a, b, c, d};
+		}
+	}
+
+	std::expected<ConvexHull, util::Error> ConvexHull::from_points(std::span<const glm::vec3> points) noexcept
+	{
+		if (points.size() < 4)
+			return util::Error(std::format("Convex hull needs at least 4 points, got {}", points.size()));
+
+		const auto [point_min, point_max] = std::ranges::fold_left(
+			points,
+			std::make_pair(glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX)),
+			[](const auto& acc, const glm::vec3& point) {
+				return std::make_pair(glm::min(acc.first, point), glm::max(acc.second, point));
+			}
+		);
+
+		// Distances below this are treated as coplanar
+		const float epsilon = std::max(glm::length(point_max - point_min), 1e-6f) * 1e-5f;
+
+		const auto simplex = find_simplex(points, epsilon);
+		if (simplex.empty()) return util::Error("Convex hull points are degenerate (coplanar or coincident)");
+
+		/* Quickhull */
+
+		std::vector<Face> faces;
+
+		for (const auto [skip_idx, opposite] : std::views::enumerate(simplex))
+		{
+			std::vector<uint32_t> corners;
+			for (const auto [idx, vertex] : std::views::enumerate(simplex))
+				if (idx != skip_idx) corners.push_back(vertex);
+
+			// Orient outward, away from the opposite vertex
+			auto face = make_face(points, corners[0], corners[1], corners[2]);
+			if (face.distance(points[opposite]) > 0)
+				face = make_face(points, corners[0], corners[2], corners[1]);
+
+			faces.push_back(std::move(face));
+		}
+
+		const auto remaining =
+			std::views::iota(0u, uint32_t(points.size()))
+			| std::views::filter([&simplex](uint32_t idx) { return !std::ranges::contains(simplex, idx); })
+			| std::ranges::to<std::vector>();
+		assign_outside(points, remaining, faces, epsilon);
+
+		// Every iteration adds a hull vertex, bounded for safety against numerical cycles
+		for (size_t iteration = 0; iteration < points.size() * 4; ++iteration)
+		{
+			const auto face_it = std::ranges::find_if(faces, [](const Face& face) {
+				return face.alive && !face.outside.empty();
+			});
+			if (face_it == faces.end()) break;
+
+			const uint32_t apex = *std::ranges::max_element(face_it->outside, {}, [&](uint32_t idx) {
+				return face_it->distance(points[idx]);
+			});
+
+			// Faces seen from the apex, and their edges
+			std::vector<size_t> visible;
+			std::set<std::pair<uint32_t, uint32_t>> visible_edges;
+
+			for (const auto [face_idx, face] : std::views::enumerate(faces))
+			{
+				if (!face.alive || !(face.distance(points[apex]) > epsilon)) continue;
+
+				visible.push_back(size_t(face_idx));
+				for (const auto edge_idx : std::views::iota(0, 3))
+					visible_edges.emplace(face.vertices[edge_idx], face.vertices[(edge_idx + 1) % 3]);
+			}
+
+			// Horizon edges border exactly one visible face, new faces keep their winding
+			std::vector<uint32_t> orphans;
+			for (const auto face_idx : visible)
+			{
+				faces[face_idx].alive = false;
+				orphans.append_range(faces[face_idx].outside);
+				faces[face_idx].outside.clear();
+			}
+
+			const size_t first_new_face = faces.size();
+			for (const auto& [from, to] : visible_edges)
+				if (!visible_edges.contains({to, from})) faces.push_back(make_face(points, from, to, apex));
+
+			std::erase(orphans, apex);
+			assign_outside(points, orphans, std::span(faces).subspan(first_new_face), epsilon);
+		}
+
+		/* Merge coplanar faces into planes */
+
+		ConvexHull hull;
+		std::vector<std::pair<glm::vec3, float>> planes;
+		std::set<uint32_t> hull_vertices;
+
+		for (const auto& face : faces)
+			if (face.alive) hull_vertices.insert(face.vertices.begin(), face.vertices.end());
+
+		for (const auto& face : faces)
+		{
+			if (!face.alive || !std::isfinite(face.normal.x)) continue;
+
+			// Slivers inside a flat region can get a flipped or tilted normal, the region's other faces
+			// already bound the hull there
+			const bool valid = std::ranges::all_of(hull_vertices, [&](uint32_t vertex_idx) {
+				return face.distance(points[vertex_idx]) <= epsilon * 10.0f;
+			});
+			if (!valid) continue;
+
+			const bool merged = std::ranges::any_of(planes, [&](const auto& plane) {
+				return glm::dot(plane.first, face.normal) > 1.0f - 1e-5f
+					&& std::abs(plane.second - face.offset) <= epsilon * 10.0f;
+			});
+			if (!merged) planes.emplace_back(face.normal, face.offset);
+		}
+
+		hull.plane_count = planes.size();
+		for (const auto& [normal, offset] : planes)
+		{
+			hull.plane_x.push_back(normal.x);
+			hull.plane_y.push_back(normal.y);
+			hull.plane_z.push_back(normal.z);
+			hull.plane_offset.push_back(offset);
+		}
+
+		while (hull.plane_x.size() % 8 != 0)
+		{
+			hull.plane_x.push_back(0.0f);
+			hull.plane_y.push_back(0.0f);
+			hull.plane_z.push_back(0.0f);
+			hull.plane_offset.push_back(-1.0f);
+		}
+
+		/* Vertices and bounds */
+
+		hull.vertex_count = hull_vertices.size();
+		hull.min = glm::vec3(std::numeric_limits<float>::max());
+		hull.max = glm::vec3(std::numeric_limits<float>::lowest());
+
+		for (const auto vertex_idx : hull_vertices)
+		{
+			const glm::vec3& vertex = points[vertex_idx];
+			hull.vertex_x.push_back(vertex.x);
+			hull.vertex_y.push_back(vertex.y);
+			hull.vertex_z.push_back(vertex.z);
+			hull.min = glm::min(hull.min, vertex);
+			hull.max = glm::max(hull.max, vertex);
+		}
+
+		while (hull.vertex_x.size() % 8 != 0)
+		{
+			hull.vertex_x.push_back(hull.vertex_x.front());
+			hull.vertex_y.push_back(hull.vertex_y.front());
+			hull.vertex_z.push_back(hull.vertex_z.front());
+		}
+
+		// Centered on the box, not minimal but tight enough for early outs
+		hull.sphere_center = (hull.min + hull.max) * 0.5f;
+		hull.sphere_radius = 0.0f;
+		for (const auto vertex_idx : hull_vertices)
+		{
+			const float distance = glm::length(points[vertex_idx] - hull.sphere_center);
+			hull.sphere_radius = std::max(hull.sphere_radius, distance);
+		}
+
+		return hull;
+	}
+
+	bool ConvexHull::contains(const glm::vec3& point) const noexcept
+	{
+		if (glm::any(glm::lessThan(point, min)) || glm::any(glm::greaterThan(point, max))) return false;
+
+		size_t plane_idx = 0;
+
+#ifdef __AVX2__
+		const __m256 point_x = _mm256_set1_ps(point.x);
+		const __m256 point_y = _mm256_set1_ps(point.y);
+		const __m256 point_z = _mm256_set1_ps(point.z);
+
+		for (; plane_idx < plane_x.size(); plane_idx += 8)
+		{
+			const __m256 distance = _mm256_add_ps(
+				_mm256_add_ps(
+					_mm256_mul_ps(_mm256_loadu_ps(plane_x.data() + plane_idx), point_x),
+					_mm256_mul_ps(_mm256_loadu_ps(plane_y.data() + plane_idx), point_y)
+				),
+				_mm256_add_ps(
+					_mm256_mul_ps(_mm256_loadu_ps(plane_z.data() + plane_idx), point_z),
+					_mm256_loadu_ps(plane_offset.data() + plane_idx)
+				)
+			);
+
+			const __m256 outside = _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ);
+			if (_mm256_movemask_ps(outside) != 0) return false;
+		}
+#endif
+
+		for (; plane_idx < plane_count; ++plane_idx)
+		{
+			const float distance = plane_x[plane_idx] * point.x
+				+ plane_y[plane_idx] * point.y
+				+ plane_z[plane_idx] * point.z
+				+ plane_offset[plane_idx];
+			if (distance >= 0.0f) return false;
+		}
+
+		return true;
+	}
+
+	bool ConvexHull::in_frustum(
+		std::span<const glm::vec4> planes,
+		const glm::mat4& world_matrix
+	) const noexcept
+	{
+		for (const auto& world_plane : planes)
+		{
+			// Plane in hull space, not normalized
+			const glm::vec4 plane = world_plane * world_matrix;
+			const float normal_length = glm::length(glm::vec3(plane));
+
+			const float center_distance = glm::dot(glm::vec3(plane), sphere_center) + plane.w;
+			if (center_distance >= sphere_radius * normal_length) continue;
+			if (center_distance < -sphere_radius * normal_length) return false;
+
+			// Outside if every vertex is outside this plane
+			bool any_inside = false;
+			size_t vertex_idx = 0;
+
+#ifdef __AVX2__
+			const __m256 normal_x = _mm256_set1_ps(plane.x);
+			const __m256 normal_y = _mm256_set1_ps(plane.y);
+			const __m256 normal_z = _mm256_set1_ps(plane.z);
+			const __m256 offset = _mm256_set1_ps(plane.w);
+
+			for (; vertex_idx < vertex_x.size() && !any_inside; vertex_idx += 8)
+			{
+				const __m256 distance = _mm256_add_ps(
+					_mm256_add_ps(
+						_mm256_mul_ps(_mm256_loadu_ps(vertex_x.data() + vertex_idx), normal_x),
+						_mm256_mul_ps(_mm256_loadu_ps(vertex_y.data() + vertex_idx), normal_y)
+					),
+					_mm256_add_ps(
+						_mm256_mul_ps(_mm256_loadu_ps(vertex_z.data() + vertex_idx), normal_z),
+						offset
+					)
+				);
+
+				const __m256 inside = _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ);
+				any_inside = _mm256_movemask_ps(inside) != 0;
+			}
+#endif
+
+			for (; vertex_idx < vertex_count && !any_inside; ++vertex_idx)
+			{
+				const glm::vec3 vertex = {vertex_x[vertex_idx], vertex_y[vertex_idx], vertex_z[vertex_idx]};
+				any_inside = glm::dot(glm::vec3(plane), vertex) + plane.w >= 0.0f;
+			}
+
+			if (!any_inside) return false;
+		}
+
+		return true;
+	}
+}
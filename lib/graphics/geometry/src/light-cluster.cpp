@@ -0,0 +1,420 @@
+#include "graphics/light-cluster.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <glm/gtc/constants.hpp>
+#include <immintrin.h>
+#include <limits>
+#include <ranges>
+
+namespace graphics
+{
+	namespace
+	{
+		// Bounding sphere of a froxel, in view-space xy and distance
+		struct Sphere
+		{
+			glm::vec3 center;
+			float radius;
+		};
+	}
+
+	void LightCluster::ViewLights::clear() noexcept
+	{
+		for (auto* array : {&x, &y, &d, &radius, &axis_x, &axis_y, &axis_d, &cone_cos, &cone_sin})
+			array->clear();
+		back_range.clear();
+	}
+
+	void LightCluster::ViewLights::push_back(
+		const glm::vec3& position,
+		float radius,
+		const glm::vec3& axis,
+		float cone_cos,
+		float cone_sin,
+		float back_range
+	) noexcept
+	{
+		x.push_back(position.x);
+		y.push_back(position.y);
+		d.push_back(position.z);
+		this->radius.push_back(radius);
+		axis_x.push_back(axis.x);
+		axis_y.push_back(axis.y);
+		axis_d.push_back(axis.z);
+		this->cone_cos.push_back(cone_cos);
+		this->cone_sin.push_back(cone_sin);
+		this->back_range.push_back(back_range);
+	}
+
+	void LightCluster::ViewLights::pad() noexcept
+	{
+		// Padding lights fail every plane test
+		while (size() % 8 != 0)
+		{
+			const float no_reach = -std::numeric_limits<float>::infinity();
+			push_back(glm::vec3(0.0f), no_reach, glm::vec3(0.0f), 1.0f, 0.0f, 0.0f);
+		}
+	}
+
+	LightCluster::LightCluster(const Config& config) noexcept :
+		config(config),
+		columns(config.dimension.x),
+		rows(config.dimension.y),
+		slice_bounds(config.dimension.z + 1),
+		slice_scratch(config.dimension.z),
+		ranges(size_t(config.dimension.x) * config.dimension.y * config.dimension.z, Range{0, 0})
+	{
+		// Slice 0 reaches down to the eye, the others are spaced exponentially between near and far
+		const float ratio = config.far / config.near;
+		const float last_boundary = float(config.dimension.z - 1);
+
+		slice_bounds[0] = 0.0f;
+		for (const auto boundary : std::views::iota(1u, config.dimension.z + 1))
+			slice_bounds[boundary] = config.near * std::pow(ratio, float(boundary - 1) / last_boundary);
+	}
+
+	std::expected<LightCluster, util::Error> LightCluster::create(const Config& config) noexcept
+	{
+		if (config.dimension.x == 0 || config.dimension.y == 0)
+			return util::Error(
+				std::format("Invalid cluster grid size {}x{}", config.dimension.x, config.dimension.y)
+			);
+
+		if (config.dimension.z < 2)
+			return util::Error(
+				std::format("Cluster grid needs at least 2 depth slices, got {}", config.dimension.z)
+			);
+
+		if (!(config.near > 0.0f) || !(config.far > config.near))
+			return util::Error(std::format("Invalid cluster depth range [{}, {}]", config.near, config.far));
+
+		return LightCluster(config);
+	}
+
+	void LightCluster::begin(
+		const glm::mat4& view_matrix,
+		const glm::mat4& proj_matrix,
+		std::span<const ClusterLight> lights
+	) noexcept
+	{
+		// Band of NDC [ndc_low, ndc_high], given `ndc = scale * coord / d - offset`
+		const auto make_band = [](float ndc_low, float ndc_high, float scale, float offset) {
+			const float slope_a = (ndc_low + offset) / scale;
+			const float slope_b = (ndc_high + offset) / scale;
+			const float low_slope = std::min(slope_a, slope_b);
+			const float high_slope = std::max(slope_a, slope_b);
+
+			return Band{
+				.low_slope = low_slope,
+				.high_slope = high_slope,
+				.low_scale = 1.0f / std::sqrt(1.0f + low_slope * low_slope),
+				.high_scale = 1.0f / std::sqrt(1.0f + high_slope * high_slope)
+			};
+		};
+
+		const float column_step = 2.0f / float(config.dimension.x);
+		for (const auto [column_idx, band] : std::views::enumerate(columns))
+		{
+			const float ndc_left = -1.0f + float(column_idx) * column_step;
+			band = make_band(ndc_left, ndc_left + column_step, proj_matrix[0][0], proj_matrix[2][0]);
+		}
+
+		// Row 0 at the top of the screen
+		const float row_step = 2.0f / float(config.dimension.y);
+		for (const auto [row_idx, band] : std::views::enumerate(rows))
+		{
+			const float ndc_top = 1.0f - float(row_idx) * row_step;
+			band = make_band(ndc_top - row_step, ndc_top, proj_matrix[1][1], proj_matrix[2][1]);
+		}
+
+		view_lights.clear();
+		for (const auto& light : lights)
+		{
+			// View space looks down -Z, distance is stored positive
+			const glm::vec3 view_position = glm::vec3(view_matrix * glm::vec4(light.position, 1.0f));
+			const glm::vec3 position = {view_position.x, view_position.y, -view_position.z};
+
+			if (light.type == ClusterLight::Type::Point)
+			{
+				// Half angle of pi with no reach limit behind the apex, only the sphere test remains
+				const float back_range = std::numeric_limits<float>::infinity();
+				view_lights.push_back(position, light.range, glm::vec3(0.0f), -1.0f, 0.0f, back_range);
+				continue;
+			}
+
+			const glm::vec3 view_axis = glm::normalize(glm::mat3(view_matrix) * light.direction);
+			const glm::vec3 axis = {view_axis.x, view_axis.y, -view_axis.z};
+			const float cone_angle = std::clamp(light.outer_cone_angle, 0.0f, glm::half_pi<float>());
+
+			const float cone_cos = std::cos(cone_angle);
+			const float cone_sin = std::sin(cone_angle);
+			view_lights.push_back(position, light.range, axis, cone_cos, cone_sin, 0.0f);
+		}
+	}
+
+	void LightCluster::build_slice(uint32_t slice) noexcept
+	{
+		auto& scratch = slice_scratch[slice];
+		auto& lights = scratch.lights;
+
+		const float slice_near = slice_bounds[slice];
+		const float slice_far = slice_bounds[slice + 1];
+
+		/* Lights overlapping the slice depth range */
+
+		lights.clear();
+		scratch.light_index.clear();
+
+		for (const auto light_idx : std::views::iota(0zu, view_lights.size()))
+		{
+			const float d = view_lights.d[light_idx];
+			const float radius = view_lights.radius[light_idx];
+			if (d + radius <= slice_near || d - radius >= slice_far) continue;
+
+			lights.push_back(
+				{view_lights.x[light_idx], view_lights.y[light_idx], d},
+				radius,
+				{view_lights.axis_x[light_idx], view_lights.axis_y[light_idx], view_lights.axis_d[light_idx]},
+				view_lights.cone_cos[light_idx],
+				view_lights.cone_sin[light_idx],
+				view_lights.back_range[light_idx]
+			);
+			scratch.light_index.push_back(uint32_t(light_idx));
+		}
+
+		const size_t light_count = lights.size();
+		lights.pad();
+
+		[[maybe_unused]] const size_t padded_count = lights.size();
+		const size_t word_count = (light_count + 63) / 64;
+
+		/* Column and row plane tests, 8 lights at a time */
+
+		const auto test_bands = [&](std::span<const Band> bands,
+									const std::vector<float>& coord,
+									std::vector<uint64_t>& masks) {
+			masks.assign(bands.size() * word_count, 0);
+
+			for (const auto [band_idx, band] : std::views::enumerate(bands))
+			{
+				uint64_t* const mask = masks.data() + size_t(band_idx) * word_count;
+				size_t light_idx = 0;
+
+#ifdef __AVX2__
+				const __m256 low_slope = _mm256_set1_ps(band.low_slope);
+				const __m256 high_slope = _mm256_set1_ps(band.high_slope);
+				const __m256 low_scale = _mm256_set1_ps(band.low_scale);
+				const __m256 high_scale = _mm256_set1_ps(band.high_scale);
+				const __m256 zero = _mm256_setzero_ps();
+
+				for (; light_idx < padded_count; light_idx += 8)
+				{
+					const __m256 c = _mm256_loadu_ps(coord.data() + light_idx);
+					const __m256 d = _mm256_loadu_ps(lights.d.data() + light_idx);
+					const __m256 radius = _mm256_loadu_ps(lights.radius.data() + light_idx);
+					const __m256 neg_radius = _mm256_sub_ps(zero, radius);
+
+					const __m256 low_dist =
+						_mm256_mul_ps(_mm256_sub_ps(c, _mm256_mul_ps(low_slope, d)), low_scale);
+					const __m256 high_dist =
+						_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(high_slope, d), c), high_scale);
+
+					const __m256 pass = _mm256_and_ps(
+						_mm256_cmp_ps(low_dist, neg_radius, _CMP_GE_OQ),
+						_mm256_cmp_ps(high_dist, neg_radius, _CMP_GE_OQ)
+					);
+
+					const auto bits = uint64_t(_mm256_movemask_ps(pass));
+					mask[light_idx / 64] |= bits << (light_idx % 64);
+				}
+#endif
+
+				for (; light_idx < light_count; ++light_idx)
+				{
+					const float c = coord[light_idx];
+					const float d = lights.d[light_idx];
+					const float neg_radius = -lights.radius[light_idx];
+
+					if ((c - band.low_slope * d) * band.low_scale >= neg_radius
+						&& (band.high_slope * d - c) * band.high_scale >= neg_radius)
+						mask[light_idx / 64] |= uint64_t(1) << (light_idx % 64);
+				}
+			}
+		};
+
+		test_bands(columns, lights.x, scratch.column_mask);
+		test_bands(rows, lights.y, scratch.row_mask);
+
+		/* Per froxel, sphere and cone tests of the lights passing both plane tests */
+
+		// Bounding sphere of a froxel, from its 8 corners
+		const auto get_froxel_sphere = [slice_near, slice_far](const Band& column, const Band& row) {
+			std::array<glm::vec3, 8> corners;
+			for (const auto [corner_idx, corner] : std::views::enumerate(corners))
+			{
+				const float d = (corner_idx & 4) != 0 ? slice_far : slice_near;
+				const float x_slope = (corner_idx & 1) != 0 ? column.high_slope : column.low_slope;
+				const float y_slope = (corner_idx & 2) != 0 ? row.high_slope : row.low_slope;
+				corner = {x_slope * d, y_slope * d, d};
+			}
+
+			const glm::vec3 center = std::ranges::fold_left(corners, glm::vec3(0.0f), std::plus{}) / 8.0f;
+			const auto distance_to_center = [&center](const glm::vec3& p) { return glm::length(p - center); };
+
+			return Sphere{
+				.center = center,
+				.radius = std::ranges::max(corners | std::views::transform(distance_to_center))
+			};
+		};
+
+		// Cone test of one light, the SIMD path below computes the same
+		[[maybe_unused]] const auto light_reaches = [&lights](size_t light_idx, const Sphere& sphere) {
+			const glm::vec3 position = {lights.x[light_idx], lights.y[light_idx], lights.d[light_idx]};
+			const glm::vec3 axis =
+				{lights.axis_x[light_idx], lights.axis_y[light_idx], lights.axis_d[light_idx]};
+			const glm::vec3 to_center = sphere.center - position;
+
+			const float length_sqr = glm::dot(to_center, to_center);
+			const float reach = sphere.radius + lights.radius[light_idx];
+			const float axial = glm::dot(to_center, axis);
+			const float radial = std::sqrt(std::max(length_sqr - axial * axial, 0.0f));
+			const float cone_distance =
+				lights.cone_cos[light_idx] * radial - axial * lights.cone_sin[light_idx];
+
+			return length_sqr <= reach * reach
+				&& cone_distance <= sphere.radius
+				&& axial >= -sphere.radius - lights.back_range[light_idx];
+		};
+
+#ifdef __AVX2__
+		// Cone test of 8 lights starting at `base`, returns a lane mask
+		const auto group_reaches = [&lights](size_t base, const Sphere& sphere) {
+			const auto load = [base](const std::vector<float>& array) {
+				return _mm256_loadu_ps(array.data() + base);
+			};
+
+			const __m256 sphere_radius = _mm256_set1_ps(sphere.radius);
+			const __m256 to_x = _mm256_sub_ps(_mm256_set1_ps(sphere.center.x), load(lights.x));
+			const __m256 to_y = _mm256_sub_ps(_mm256_set1_ps(sphere.center.y), load(lights.y));
+			const __m256 to_d = _mm256_sub_ps(_mm256_set1_ps(sphere.center.z), load(lights.d));
+
+			const __m256 length_sqr = _mm256_add_ps(
+				_mm256_add_ps(_mm256_mul_ps(to_x, to_x), _mm256_mul_ps(to_y, to_y)),
+				_mm256_mul_ps(to_d, to_d)
+			);
+			const __m256 reach = _mm256_add_ps(sphere_radius, load(lights.radius));
+			const __m256 axial = _mm256_add_ps(
+				_mm256_add_ps(
+					_mm256_mul_ps(to_x, load(lights.axis_x)),
+					_mm256_mul_ps(to_y, load(lights.axis_y))
+				),
+				_mm256_mul_ps(to_d, load(lights.axis_d))
+			);
+
+			const __m256 radial_sqr = _mm256_sub_ps(length_sqr, _mm256_mul_ps(axial, axial));
+			const __m256 radial = _mm256_sqrt_ps(_mm256_max_ps(radial_sqr, _mm256_setzero_ps()));
+			const __m256 cone_distance = _mm256_sub_ps(
+				_mm256_mul_ps(load(lights.cone_cos), radial),
+				_mm256_mul_ps(axial, load(lights.cone_sin))
+			);
+			const __m256 back_limit =
+				_mm256_sub_ps(_mm256_sub_ps(_mm256_setzero_ps(), sphere_radius), load(lights.back_range));
+
+			const __m256 in_sphere = _mm256_cmp_ps(length_sqr, _mm256_mul_ps(reach, reach), _CMP_LE_OQ);
+			const __m256 in_cone = _mm256_cmp_ps(cone_distance, sphere_radius, _CMP_LE_OQ);
+			const __m256 in_front = _mm256_cmp_ps(axial, back_limit, _CMP_GE_OQ);
+
+			return uint32_t(_mm256_movemask_ps(_mm256_and_ps(_mm256_and_ps(in_sphere, in_cone), in_front)));
+		};
+#endif
+
+		scratch.indices.clear();
+
+		for (const auto [row_idx, row] : std::views::enumerate(rows))
+			for (const auto [column_idx, column] : std::views::enumerate(columns))
+			{
+				const auto sphere = get_froxel_sphere(column, row);
+				const auto* const column_mask = scratch.column_mask.data() + size_t(column_idx) * word_count;
+				const auto* const row_mask = scratch.row_mask.data() + size_t(row_idx) * word_count;
+				const size_t offset = scratch.indices.size();
+
+				for (const auto word_idx : std::views::iota(0zu, word_count))
+				{
+					const uint64_t candidates = column_mask[word_idx] & row_mask[word_idx];
+					if (candidates == 0) continue;
+
+#ifdef __AVX2__
+					// 8 lights per byte of the candidate bitset
+					for (const auto byte_idx : std::views::iota(0zu, 8zu))
+					{
+						const auto byte_candidates = uint32_t(candidates >> (byte_idx * 8)) & 0xFF;
+						if (byte_candidates == 0) continue;
+
+						const size_t base = word_idx * 64 + byte_idx * 8;
+						const uint32_t lanes = group_reaches(base, sphere) & byte_candidates;
+
+						for (uint32_t remaining = lanes; remaining != 0; remaining &= remaining - 1)
+						{
+							const size_t light_idx = base + std::countr_zero(remaining);
+							scratch.indices.push_back(scratch.light_index[light_idx]);
+						}
+					}
+#else
+					for (uint64_t remaining = candidates; remaining != 0; remaining &= remaining - 1)
+					{
+						const size_t light_idx = word_idx * 64 + std::countr_zero(remaining);
+						if (light_reaches(light_idx, sphere))
+							scratch.indices.push_back(scratch.light_index[light_idx]);
+					}
+#endif
+				}
+
+				const size_t cluster_row = size_t(slice) * config.dimension.y + size_t(row_idx);
+				const size_t cluster_idx = cluster_row * config.dimension.x + size_t(column_idx);
+				ranges[cluster_idx] = {
+					.offset = uint32_t(offset),
+					.count = uint32_t(scratch.indices.size() - offset)
+				};
+			}
+	}
+
+	void LightCluster::finish() noexcept
+	{
+		const size_t slice_cluster_count = size_t(config.dimension.x) * config.dimension.y;
+
+		light_indices.clear();
+
+		// Slice-local offsets become offsets into the global array
+		for (const auto [slice, scratch] : std::views::enumerate(slice_scratch))
+		{
+			const auto base = uint32_t(light_indices.size());
+			light_indices.append_range(scratch.indices);
+
+			const auto slice_ranges =
+				std::span(ranges).subspan(size_t(slice) * slice_cluster_count, slice_cluster_count);
+			for (auto& range : slice_ranges) range.offset += base;
+		}
+	}
+
+	void LightCluster::build(
+		const glm::mat4& view_matrix,
+		const glm::mat4& proj_matrix,
+		std::span<const ClusterLight> lights
+	) noexcept
+	{
+		begin(view_matrix, proj_matrix, lights);
+		for (const auto slice : std::views::iota(0u, config.dimension.z)) build_slice(slice);
+		finish();
+	}
+
+	glm::vec2 LightCluster::get_slice_scale_bias() const noexcept
+	{
+		// Slice 1 starts at `near`, the last one ends at `far`
+		const float scale = float(config.dimension.z - 1) / std::log(config.far / config.near);
+		return {scale, 1.0f - std::log(config.near) * scale};
+	}
+}
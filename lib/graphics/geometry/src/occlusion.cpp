@@ -0,0 +1,276 @@
+#include "graphics/occlusion.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+#include <limits>
+#include <ranges>
+
+namespace graphics
+{
+	namespace
+	{
+		// Minimum clip-space W of a vertex in front of the camera
+		constexpr float min_clip_w = 1e-4f;
+
+		// Whether a clip-space vertex lies strictly in front of the near plane (reversed Z)
+		bool in_front_of_near(const glm::vec4& clip) noexcept
+		{
+			return clip.w > min_clip_w && clip.z <= clip.w;
+		}
+	}
+
+	OcclusionBuffer::OcclusionBuffer(glm::u32vec2 resolution) noexcept :
+		resolution((glm::max(resolution, glm::u32vec2(1)) + tile_size - 1u) / tile_size * tile_size),
+		tile_count(this->resolution / tile_size),
+		depth(this->resolution.x * this->resolution.y, 0.0f),
+		tile_depth(tile_count.x * tile_count.y, 0.0f)
+	{}
+
+	void OcclusionBuffer::begin(const glm::mat4& view_projection) noexcept
+	{
+		this->view_projection = view_projection;
+		triangles.clear();
+	}
+
+	void OcclusionBuffer::add_occluder(const OccluderMesh& mesh, const glm::mat4& world_matrix) noexcept
+	{
+		const glm::mat4 transform = view_projection * world_matrix;
+		const glm::vec2 screen_size = glm::vec2(resolution);
+
+		// Clip space to pixel space, Y points down
+		const auto to_screen = [screen_size](const glm::vec4& clip) -> glm::vec3 {
+			const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+			return {(ndc.x * 0.5f + 0.5f) * screen_size.x, (0.5f - ndc.y * 0.5f) * screen_size.y, ndc.z};
+		};
+
+		for (const auto triangle_indices : mesh.indices | std::views::chunk(3))
+		{
+			if (triangle_indices.size() != 3) break;
+
+			std::array<glm::vec4, 3> clip;
+			for (const auto [i, index] : std::views::enumerate(triangle_indices))
+				clip[i] = transform * glm::vec4(mesh.vertices[index], 1.0f);
+
+			// Dropping a triangle only loses occlusion, clipping is not worth it at this resolution
+			if (!std::ranges::all_of(clip, in_front_of_near)) continue;
+
+			std::array<glm::vec3, 3> vertices = {to_screen(clip[0]), to_screen(clip[1]), to_screen(clip[2])};
+
+			float area = (vertices[1].x - vertices[0].x) * (vertices[2].y - vertices[0].y)
+					   - (vertices[2].x - vertices[0].x) * (vertices[1].y - vertices[0].y);
+
+			// Occluders are two-sided, flip clockwise triangles
+			if (area < 0)
+			{
+				std::swap(vertices[1], vertices[2]);
+				area = -area;
+			}
+
+			if (area < 1e-6f) continue;
+
+			const glm::vec2 vertex_min = glm::min(glm::min(vertices[0], vertices[1]), vertices[2]);
+			const glm::vec2 vertex_max = glm::max(glm::max(vertices[0], vertices[1]), vertices[2]);
+
+			// Pixels whose center lies inside the vertex bounds
+			const glm::ivec2 bound_min = glm::max(glm::ivec2(glm::ceil(vertex_min - 0.5f)), glm::ivec2(0));
+			const glm::ivec2 bound_max =
+				glm::min(glm::ivec2(glm::floor(vertex_max - 0.5f)), glm::ivec2(resolution) - 1);
+
+			if (bound_min.x > bound_max.x || bound_min.y > bound_max.y) continue;
+
+			Triangle triangle;
+
+			for (const auto i : std::views::iota(0zu, 3zu))
+			{
+				const glm::vec3& from = vertices[i];
+				const glm::vec3& to = vertices[(i + 1) % 3];
+
+				const float a = from.y - to.y;
+				const float b = to.x - from.x;
+				triangle.edges[i] = {a, b, -(a * from.x + b * from.y)};
+			}
+
+			const glm::vec3 d1 = vertices[1] - vertices[0];
+			const glm::vec3 d2 = vertices[2] - vertices[0];
+			const float depth_a = (d1.z * d2.y - d2.z * d1.y) / area;
+			const float depth_b = (d2.z * d1.x - d1.z * d2.x) / area;
+
+			const float depth_c = vertices[0].z - depth_a * vertices[0].x - depth_b * vertices[0].y;
+
+			triangle.depth_plane = {depth_a, depth_b, depth_c};
+			triangle.depth_slack = 0.5f * (std::abs(depth_a) + std::abs(depth_b));
+			triangle.depth_min = std::min({vertices[0].z, vertices[1].z, vertices[2].z});
+			triangle.bound_min = bound_min;
+			triangle.bound_max = bound_max;
+
+			triangles.push_back(triangle);
+		}
+	}
+
+	void OcclusionBuffer::rasterize(uint32_t tile_row_begin, uint32_t tile_row_end) noexcept
+	{
+		tile_row_end = std::min(tile_row_end, tile_count.y);
+		if (tile_row_begin >= tile_row_end) return;
+
+		const int row_begin = int(tile_row_begin * tile_size);
+		const int row_end = int(tile_row_end * tile_size);
+
+		std::fill(depth.begin() + row_begin * resolution.x, depth.begin() + row_end * resolution.x, 0.0f);
+
+		for (const auto& triangle : triangles)
+		{
+			if (triangle.bound_max.y < row_begin || triangle.bound_min.y >= row_end) continue;
+			rasterize_triangle(triangle, row_begin, row_end);
+		}
+
+		// Farthest depth of each tile
+		for (const auto [tile_y, tile_x] : std::views::cartesian_product(
+				 std::views::iota(tile_row_begin, tile_row_end),
+				 std::views::iota(0u, tile_count.x)
+			 ))
+		{
+			float tile_min = 1.0f;
+
+			for (const auto y : std::views::iota(tile_y * tile_size, (tile_y + 1) * tile_size))
+			{
+				const float* row = depth.data() + y * resolution.x + tile_x * tile_size;
+				tile_min = std::min(tile_min, *std::min_element(row, row + tile_size));
+			}
+
+			tile_depth[tile_y * tile_count.x + tile_x] = tile_min;
+		}
+	}
+
+	void OcclusionBuffer::rasterize_triangle(const Triangle& triangle, int row_begin, int row_end) noexcept
+	{
+		const int y_begin = std::max(triangle.bound_min.y, row_begin);
+		const int y_end = std::min(triangle.bound_max.y + 1, row_end);
+
+		// Start on a multiple of 8, the buffer width is a multiple of 8 so no lane runs out of the row
+		const int x_begin = triangle.bound_min.x & ~7;
+		const int x_end = triangle.bound_max.x + 1;
+
+		const auto& [e0, e1, e2] = triangle.edges;
+		const glm::vec3& plane = triangle.depth_plane;
+
+		for (int y = y_begin; y < y_end; ++y)
+		{
+			const float sample_y = float(y) + 0.5f;
+			float* row = depth.data() + y * int(resolution.x);
+
+			// Row constant terms
+			const float r0 = e0.y * sample_y + e0.z;
+			const float r1 = e1.y * sample_y + e1.z;
+			const float r2 = e2.y * sample_y + e2.z;
+			const float rz = plane.y * sample_y + plane.z - triangle.depth_slack;
+
+			int x = x_begin;
+
+#ifdef __AVX2__
+			const __m256 lane_offset = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+			const __m256 edge_a0 = _mm256_set1_ps(e0.x), edge_r0 = _mm256_set1_ps(r0);
+			const __m256 edge_a1 = _mm256_set1_ps(e1.x), edge_r1 = _mm256_set1_ps(r1);
+			const __m256 edge_a2 = _mm256_set1_ps(e2.x), edge_r2 = _mm256_set1_ps(r2);
+			const __m256 depth_a = _mm256_set1_ps(plane.x), depth_r = _mm256_set1_ps(rz);
+			const __m256 depth_min = _mm256_set1_ps(triangle.depth_min);
+
+			for (; x < x_end; x += 8)
+			{
+				const __m256 sample_x = _mm256_add_ps(_mm256_set1_ps(float(x)), lane_offset);
+
+				const __m256 w0 = _mm256_add_ps(_mm256_mul_ps(edge_a0, sample_x), edge_r0);
+				const __m256 w1 = _mm256_add_ps(_mm256_mul_ps(edge_a1, sample_x), edge_r1);
+				const __m256 w2 = _mm256_add_ps(_mm256_mul_ps(edge_a2, sample_x), edge_r2);
+
+				// Sign bit of the OR is set where any edge function is negative
+				const __m256 outside = _mm256_or_ps(_mm256_or_ps(w0, w1), w2);
+				if (_mm256_movemask_ps(outside) == 0xFF) continue;
+
+				const __m256 plane_z = _mm256_add_ps(_mm256_mul_ps(depth_a, sample_x), depth_r);
+				const __m256 z = _mm256_max_ps(plane_z, depth_min);
+
+				const __m256 old_depth = _mm256_loadu_ps(row + x);
+				const __m256 new_depth = _mm256_blendv_ps(_mm256_max_ps(old_depth, z), old_depth, outside);
+				_mm256_storeu_ps(row + x, new_depth);
+			}
+#endif
+
+			for (; x < x_end; ++x)
+			{
+				const float sample_x = float(x) + 0.5f;
+
+				if (e0.x * sample_x + r0 < 0 || e1.x * sample_x + r1 < 0) continue;
+				if (e2.x * sample_x + r2 < 0) continue;
+
+				const float z = std::max(plane.x * sample_x + rz, triangle.depth_min);
+				row[x] = std::max(row[x], z);
+			}
+		}
+	}
+
+	bool OcclusionBuffer::test_box(const glm::vec3& box_min, const glm::vec3& box_max) const noexcept
+	{
+		if (triangles.empty()) return true;
+
+		glm::vec2 screen_min(std::numeric_limits<float>::max());
+		glm::vec2 screen_max(std::numeric_limits<float>::lowest());
+		float box_depth = 0.0f;
+
+		for (const auto corner_index : std::views::iota(0u, 8u))
+		{
+			const glm::vec3 corner = {
+				(corner_index & 1) != 0 ? box_max.x : box_min.x,
+				(corner_index & 2) != 0 ? box_max.y : box_min.y,
+				(corner_index & 4) != 0 ? box_max.z : box_min.z
+			};
+
+			const glm::vec4 clip = view_projection * glm::vec4(corner, 1.0f);
+
+			// Box reaches the camera, can't be tested in screen space
+			if (!in_front_of_near(clip)) return true;
+
+			const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+			const glm::vec2 screen = {ndc.x * 0.5f + 0.5f, 0.5f - ndc.y * 0.5f};
+
+			screen_min = glm::min(screen_min, screen);
+			screen_max = glm::max(screen_max, screen);
+			box_depth = std::max(box_depth, ndc.z);
+		}
+
+		// Pixels touched by the screen rectangle
+		const glm::vec2 screen_size = glm::vec2(resolution);
+		const glm::ivec2 pixel_min =
+			glm::max(glm::ivec2(glm::floor(screen_min * screen_size)), glm::ivec2(0));
+		const glm::ivec2 pixel_max =
+			glm::min(glm::ivec2(glm::floor(screen_max * screen_size)), glm::ivec2(resolution) - 1);
+
+		// Off screen, leave it to frustum culling
+		if (pixel_min.x > pixel_max.x || pixel_min.y > pixel_max.y) return true;
+
+		const glm::ivec2 tile_min = pixel_min / int(tile_size);
+		const glm::ivec2 tile_max = pixel_max / int(tile_size);
+
+		for (const auto [tile_y, tile_x] : std::views::cartesian_product(
+				 std::views::iota(tile_min.y, tile_max.y + 1),
+				 std::views::iota(tile_min.x, tile_max.x + 1)
+			 ))
+		{
+			// Whole tile covered by nearer occluders
+			if (box_depth < tile_depth[tile_y * tile_count.x + tile_x]) continue;
+
+			const glm::ivec2 tile_origin = glm::ivec2(tile_x, tile_y) * int(tile_size);
+			const glm::ivec2 range_min = glm::max(pixel_min, tile_origin);
+			const glm::ivec2 range_max = glm::min(pixel_max, tile_origin + int(tile_size) - 1);
+
+			for (const auto y : std::views::iota(range_min.y, range_max.y + 1))
+			{
+				const float* row = depth.data() + y * resolution.x;
+				for (const auto x : std::views::iota(range_min.x, range_max.x + 1))
+					if (box_depth >= row[x]) return true;
+			}
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,292 @@
+#include "graphics/portal.hpp"
+#include "graphics/culling.hpp"
+
+#include <algorithm>
+#include <format>
+#include <ranges>
+
+namespace graphics
+{
+	namespace
+	{
+		// Whether two boxes overlap, touching boxes overlap
+		bool box_overlaps(const Aabb& box, const glm::vec3& box_min, const glm::vec3& box_max) noexcept
+		{
+			return glm::all(glm::lessThanEqual(box.min, box_max))
+				&& glm::all(glm::lessThanEqual(box_min, box.max));
+		}
+
+		// Whether a box is entirely inside another
+		bool box_contains(const Aabb& outer, const glm::vec3& box_min, const glm::vec3& box_max) noexcept
+		{
+			return glm::all(glm::lessThanEqual(outer.min, box_min))
+				&& glm::all(glm::lessThanEqual(box_max, outer.max));
+		}
+
+		float plane_distance(const glm::vec4& plane, const glm::vec3& point) noexcept
+		{
+			return glm::dot(glm::vec3(plane), point) + plane.w;
+		}
+	}
+
+	bool PortalVisibility::test_box(const glm::vec3& box_min, const glm::vec3& box_max) const noexcept
+	{
+		if (unrestricted) return true;
+
+		const bool in_bounded_cell = std::ranges::any_of(cell_bounds, [&](const Aabb& bounds) {
+			return box_contains(bounds, box_min, box_max);
+		});
+
+		for (const auto& view : views)
+		{
+			// The outside cell holds boxes not entirely inside a bounded cell
+			const bool in_cell = view.bounds.has_value()
+				? box_overlaps(*view.bounds, box_min, box_max)
+				: !in_bounded_cell;
+
+			if (in_cell && box_in_frustum(box_min, box_max, view.planes)) return true;
+		}
+
+		// Without an outside cell, boxes reaching out of the cells are in unknown space
+		return !has_outside_cell && !in_bounded_cell;
+	}
+
+	PortalGraph::PortalGraph(std::vector<Cell> cells, std::vector<Portal> portals) noexcept :
+		cells(std::move(cells)),
+		portals(std::move(portals)),
+		cell_portals(this->cells.size())
+	{
+		for (const auto [portal_index, portal] : std::views::enumerate(this->portals))
+			for (const auto cell : portal.cells) cell_portals[cell].push_back(uint32_t(portal_index));
+	}
+
+	std::expected<PortalGraph, util::Error> PortalGraph::create(
+		std::vector<Cell> cells,
+		std::vector<Portal> portals
+	) noexcept
+	{
+		const auto outside_count = std::ranges::count_if(cells, [](const Cell& cell) {
+			return !cell.bounds.has_value();
+		});
+		if (outside_count > 1)
+			return util::Error(std::format("{} unbounded cells, at most one is allowed", outside_count));
+
+		for (const auto [portal_index, portal] : std::views::enumerate(portals))
+		{
+			const auto [cell_a, cell_b] = portal.cells;
+
+			if (cell_a >= cells.size() || cell_b >= cells.size())
+				return util::Error(
+					std::format(
+						"Portal {} connects cells {} and {}, only {} cells exist",
+						portal_index,
+						cell_a,
+						cell_b,
+						cells.size()
+					)
+				);
+
+			if (cell_a == cell_b)
+				return util::Error(std::format("Portal {} connects cell {} to itself", portal_index, cell_a));
+		}
+
+		return PortalGraph(std::move(cells), std::move(portals));
+	}
+
+	PortalVisibility PortalGraph::compute_visibility(
+		const glm::vec3& eye_position,
+		const glm::mat4& view_projection,
+		std::span<const uint8_t> portal_open
+	) const noexcept
+	{
+		return compute_visibility(eye_position, view_projection, portal_open, Config());
+	}
+
+	PortalVisibility PortalGraph::compute_visibility(
+		const glm::vec3& eye_position,
+		const glm::mat4& view_projection,
+		std::span<const uint8_t> portal_open,
+		const Config& config
+	) const noexcept
+	{
+		const auto camera_planes = compute_frustum_planes(view_projection);
+
+		// Cells holding the eye, the outside cell if there is none
+		const auto contains_eye = [this, &eye_position](uint32_t cell) {
+			const auto& bounds = cells[cell].bounds;
+			return bounds.has_value() && box_contains(*bounds, eye_position, eye_position);
+		};
+
+		auto start_cells = std::views::iota(0u, uint32_t(cells.size()))
+			| std::views::filter(contains_eye)
+			| std::ranges::to<std::vector>();
+
+		const auto outside_cell = std::ranges::find_if(cells, [](const Cell& cell) {
+			return !cell.bounds.has_value();
+		});
+
+		if (start_cells.empty() && outside_cell != cells.end())
+			start_cells.push_back(uint32_t(outside_cell - cells.begin()));
+
+		if (start_cells.empty()) return {};
+
+		PortalVisibility visibility{
+			.unrestricted = false,
+			.has_outside_cell = outside_cell != cells.end(),
+			.views = {},
+			.cell_bounds = cells
+				| std::views::filter([](const Cell& cell) { return cell.bounds.has_value(); })
+				| std::views::transform([](const Cell& cell) { return *cell.bounds; })
+				| std::ranges::to<std::vector>(),
+			.visible_cells = std::vector<uint8_t>(cells.size(), 0)
+		};
+
+		// A cell reached through a chain of portals
+		struct Step
+		{
+			uint32_t cell;
+			std::optional<uint32_t> from_portal;
+			uint32_t depth;
+			std::vector<glm::vec4> planes;
+		};
+
+		std::vector<Step> stack;
+		for (const auto cell : start_cells)
+			stack.push_back(
+				Step{
+					.cell = cell,
+					.from_portal = std::nullopt,
+					.depth = 0,
+					.planes = std::vector<glm::vec4>(camera_planes.begin(), camera_planes.end())
+				}
+			);
+
+		while (!stack.empty())
+		{
+			// Too many chains, narrowing no longer pays off
+			if (visibility.views.size() >= config.max_views) return {};
+
+			auto step = std::move(stack.back());
+			stack.pop_back();
+
+			for (const auto portal_index : cell_portals[step.cell])
+			{
+				if (step.depth >= config.max_depth) break;
+				if (step.from_portal == portal_index) continue;
+				if (portal_index < portal_open.size() && portal_open[portal_index] == 0) continue;
+
+				const auto& portal = portals[portal_index];
+				const auto next_cell = portal.cells[0] == step.cell ? portal.cells[1] : portal.cells[0];
+
+				const auto& corners = portal.corners;
+				const glm::vec3 normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+				const float normal_length = glm::length(normal);
+				if (normal_length <= 0.0f) continue;
+
+				// Eye in the portal opening, clipping would degenerate
+				if (std::abs(glm::dot(normal, eye_position - corners[0])) / normal_length < config.eye_margin)
+				{
+					stack.push_back(
+						Step{
+							.cell = next_cell,
+							.from_portal = portal_index,
+							.depth = step.depth + 1,
+							.planes = step.planes
+						}
+					);
+					continue;
+				}
+
+				const auto clipped = clip_polygon(corners, step.planes);
+				if (clipped.size() < 3) continue;
+
+				auto planes = compute_portal_planes(eye_position, clipped);
+				planes.append_range(camera_planes);
+
+				stack.push_back(
+					Step{
+						.cell = next_cell,
+						.from_portal = portal_index,
+						.depth = step.depth + 1,
+						.planes = std::move(planes)
+					}
+				);
+			}
+
+			visibility.visible_cells[step.cell] = 1;
+			visibility.views.push_back(
+				PortalVisibility::View{
+					.cell = step.cell,
+					.bounds = cells[step.cell].bounds,
+					.planes = std::move(step.planes)
+				}
+			);
+		}
+
+		return visibility;
+	}
+
+	std::vector<glm::vec3> clip_polygon(
+		std::span<const glm::vec3> polygon,
+		std::span<const glm::vec4> planes
+	) noexcept
+	{
+		std::vector<glm::vec3> result(polygon.begin(), polygon.end());
+		std::vector<glm::vec3> clipped;
+
+		// Sutherland-Hodgman, one plane at a time
+		for (const auto& plane : planes)
+		{
+			if (result.size() < 3) break;
+
+			clipped.clear();
+
+			for (const auto [idx, from] : std::views::enumerate(result))
+			{
+				const auto& to = result[(size_t(idx) + 1) % result.size()];
+				const float from_distance = plane_distance(plane, from);
+				const float to_distance = plane_distance(plane, to);
+
+				if (from_distance >= 0) clipped.push_back(from);
+				if ((from_distance >= 0) != (to_distance >= 0))
+					clipped.push_back(from + (to - from) * (from_distance / (from_distance - to_distance)));
+			}
+
+			std::swap(result, clipped);
+		}
+
+		if (result.size() < 3) result.clear();
+		return result;
+	}
+
+	std::vector<glm::vec4> compute_portal_planes(
+		const glm::vec3& eye_position,
+		std::span<const glm::vec3> polygon
+	) noexcept
+	{
+		if (polygon.empty()) return {};
+
+		const glm::vec3 centroid =
+			std::ranges::fold_left(polygon, glm::vec3(0.0f), std::plus{}) / float(polygon.size());
+
+		std::vector<glm::vec4> planes;
+		planes.reserve(polygon.size());
+
+		for (const auto [idx, from] : std::views::enumerate(polygon))
+		{
+			const auto& to = polygon[(size_t(idx) + 1) % polygon.size()];
+
+			const glm::vec3 normal = glm::cross(from - eye_position, to - eye_position);
+			const float length = glm::length(normal);
+			if (length < 1e-8f) continue;
+
+			glm::vec4 plane(normal / length, 0.0f);
+			plane.w = -glm::dot(glm::vec3(plane), eye_position);
+			if (plane_distance(plane, centroid) < 0) plane = -plane;
+
+			planes.push_back(plane);
+		}
+
+		return planes;
+	}
+}
@@ -0,0 +1,185 @@
+#include "graphics/shadow-schedule.hpp"
+#include "graphics/corner.hpp"
+
+#include <algorithm>
+#include <ranges>
+
+namespace graphics
+{
+	ShadowReceiverMask::ShadowReceiverMask() noexcept :
+		cell_depth(resolution * resolution, std::numeric_limits<float>::max())
+	{}
+
+	void ShadowReceiverMask::begin(const SmallestBound& bound) noexcept
+	{
+		view_matrix = bound.view_matrix;
+		rect_min = {bound.left, bound.top};
+
+		const glm::vec2 rect_max = {bound.right, bound.bottom};
+		const glm::vec2 rect_size = glm::max(rect_max - rect_min, glm::vec2(1e-6f));
+		cell_scale = float(resolution) / rect_size;
+
+		std::ranges::fill(cell_depth, std::numeric_limits<float>::max());
+		receiver_count = 0;
+	}
+
+	ShadowReceiverMask::LightBox ShadowReceiverMask::to_light_box(
+		const glm::vec3& box_min,
+		const glm::vec3& box_max
+	) const noexcept
+	{
+		const auto corners = transform_corner_points(get_corner_points(box_min, box_max), view_matrix);
+
+		glm::vec2 cell_min(std::numeric_limits<float>::max());
+		glm::vec2 cell_max(std::numeric_limits<float>::lowest());
+		float depth_min = std::numeric_limits<float>::max();
+		float depth_max = std::numeric_limits<float>::lowest();
+
+		for (const auto& corner : corners)
+		{
+			const glm::vec2 cell = (glm::vec2(corner) - rect_min) * cell_scale;
+			cell_min = glm::min(cell_min, cell);
+			cell_max = glm::max(cell_max, cell);
+
+			// View space looks down -Z
+			depth_min = std::min(depth_min, -corner.z);
+			depth_max = std::max(depth_max, -corner.z);
+		}
+
+		const int last_cell = int(resolution) - 1;
+
+		return LightBox{
+			.cell_min = glm::clamp(glm::ivec2(glm::floor(cell_min)), 0, last_cell),
+			.cell_max = glm::clamp(glm::ivec2(glm::floor(cell_max)), 0, last_cell),
+			.depth_min = depth_min,
+			.depth_max = depth_max,
+			.inside = glm::all(glm::greaterThanEqual(cell_max, glm::vec2(0.0f)))
+				&& glm::all(glm::lessThan(cell_min, glm::vec2(float(resolution))))
+		};
+	}
+
+	void ShadowReceiverMask::add_receiver(const glm::vec3& box_min, const glm::vec3& box_max) noexcept
+	{
+		const auto light_box = to_light_box(box_min, box_max);
+		if (!light_box.inside) return;
+
+		for (const auto [y, x] : std::views::cartesian_product(
+				 std::views::iota(light_box.cell_min.y, light_box.cell_max.y + 1),
+				 std::views::iota(light_box.cell_min.x, light_box.cell_max.x + 1)
+			 ))
+		{
+			float& depth = cell_depth[y * resolution + x];
+			depth = std::min(depth, light_box.depth_min);
+		}
+
+		receiver_count++;
+	}
+
+	bool ShadowReceiverMask::test_caster(const glm::vec3& box_min, const glm::vec3& box_max) const noexcept
+	{
+		const auto light_box = to_light_box(box_min, box_max);
+		if (!light_box.inside) return false;
+
+		for (const auto y : std::views::iota(light_box.cell_min.y, light_box.cell_max.y + 1))
+		{
+			const float* row = cell_depth.data() + y * resolution;
+			for (const auto x : std::views::iota(light_box.cell_min.x, light_box.cell_max.x + 1))
+				if (row[x] <= light_box.depth_max) return true;
+		}
+
+		return false;
+	}
+
+	SmallestBound ShadowCascadeCache::fit(
+		const std::array<glm::vec3, 8>& slice_corners,
+		const glm::vec3& light_direction,
+		uint32_t resolution,
+		const Config& config
+	) noexcept
+	{
+		// Bounding sphere of the slice, its radius doesn't change with the camera orientation
+		const glm::vec3 center = std::ranges::fold_left(slice_corners, glm::vec3(0.0f), std::plus{}) / 8.0f;
+		const auto distance_to_center = [&center](const glm::vec3& p) { return glm::length(p - center); };
+		const float radius = std::ranges::max(slice_corners | std::views::transform(distance_to_center));
+
+		const bool same_direction = valid
+			&& 1.0f - glm::dot(glm::normalize(light_direction), glm::normalize(this->light_direction))
+				   <= config.direction_threshold;
+
+		// Keep the current bound while the slice stays inside and doesn't shrink too much
+		if (same_direction)
+		{
+			const glm::vec2 light_center = glm::vec2(bound.view_matrix * glm::vec4(center, 1.0f));
+			const float bound_size = bound.right - bound.left;
+
+			const glm::vec2 bound_min = {bound.left, bound.top};
+			const glm::vec2 bound_max = {bound.right, bound.bottom};
+			const bool inside = glm::all(glm::greaterThanEqual(light_center - radius, bound_min))
+				&& glm::all(glm::lessThanEqual(light_center + radius, bound_max));
+
+			if (inside && 2.0f * radius >= config.shrink_ratio * bound_size) return bound;
+		}
+
+		const glm::mat4 view_matrix = get_light_view_matrix(light_direction);
+		const glm::vec2 light_center = glm::vec2(view_matrix * glm::vec4(center, 1.0f));
+
+		// Snap the center to whole texels, so refits keep the texel grid in place
+		const float size = glm::max(2.0f * radius * (1.0f + config.margin), 1e-3f);
+		const float texel_size = size / float(std::max(resolution, 1u));
+		const glm::vec2 snapped_center = glm::round(light_center / texel_size) * texel_size;
+
+		bound = SmallestBound{
+			.view_matrix = view_matrix,
+			.left = snapped_center.x - size * 0.5f,
+			.right = snapped_center.x + size * 0.5f,
+			.top = snapped_center.y - size * 0.5f,
+			.bottom = snapped_center.y + size * 0.5f
+		};
+		this->light_direction = light_direction;
+		refit_pending = true;
+
+		return bound;
+	}
+
+	ShadowCascadeCache::Action ShadowCascadeCache::decide(
+		const FrameInfo& frame,
+		const Config& config
+	) noexcept
+	{
+		const auto& dynamic_range = frame.dynamic_range;
+		const bool depth_covered = dynamic_range.near > dynamic_range.far
+			|| (dynamic_range.near >= depth_range.near && dynamic_range.far <= depth_range.far);
+
+		if (!valid || refit_pending || !depth_covered || frame.static_signature != static_signature)
+		{
+			valid = true;
+			refit_pending = false;
+			has_dynamic_content = frame.has_dynamic_casters;
+			static_signature = frame.static_signature;
+
+			return Action::Rebuild;
+		}
+
+		// Staggered refresh, the shadow map keeps dynamic casters of the last refresh in between
+		const uint64_t refresh_frame = frame.frame_index + config.refresh_phase;
+		if (config.refresh_interval > 1 && refresh_frame % config.refresh_interval != 0) return Action::Skip;
+
+		// Shadow map already equals the static layer
+		if (!frame.has_dynamic_casters && !has_dynamic_content) return Action::Skip;
+
+		has_dynamic_content = frame.has_dynamic_casters;
+		return Action::Refresh;
+	}
+
+	void ShadowCascadeCache::commit_rebuild(const DepthRange& caster_range, const Config& config) noexcept
+	{
+		if (caster_range.near > caster_range.far)
+		{
+			depth_range = {.near = 0.0f, .far = 1.0f};
+			return;
+		}
+
+		const float padding = std::max(caster_range.far - caster_range.near, 1e-2f) * config.depth_margin;
+		depth_range = {.near = caster_range.near - padding, .far = caster_range.far + padding};
+	}
+}
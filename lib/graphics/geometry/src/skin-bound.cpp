@@ -0,0 +1,166 @@
+#include "graphics/skin-bound.hpp"
+
+#include <algorithm>
+#include <array>
+#include <immintrin.h>
+#include <limits>
+#include <ranges>
+
+namespace graphics
+{
+	SkinBound SkinBound::build(
+		std::span<const glm::vec3> positions,
+		std::span<const glm::uvec4> joint_indices,
+		std::span<const glm::vec4> joint_weights
+	) noexcept
+	{
+		std::vector<glm::vec3> joint_min, joint_max;
+
+		for (const auto [position, indices, weights] :
+			 std::views::zip(positions, joint_indices, joint_weights))
+			for (const auto slot : std::views::iota(0, 4))
+			{
+				if (!(weights[slot] > weight_threshold)) continue;
+
+				const uint32_t joint = indices[slot];
+				if (joint >= joint_min.size())
+				{
+					joint_min.resize(joint + 1, glm::vec3(std::numeric_limits<float>::max()));
+					joint_max.resize(joint + 1, glm::vec3(std::numeric_limits<float>::lowest()));
+				}
+
+				joint_min[joint] = glm::min(joint_min[joint], position);
+				joint_max[joint] = glm::max(joint_max[joint], position);
+			}
+
+		SkinBound bound;
+		bound.joint_count = uint32_t(joint_min.size());
+
+		for (const auto [joint, min, max] : std::views::zip(std::views::iota(0), joint_min, joint_max))
+		{
+			if (min.x > max.x) continue;  // No influenced vertex
+
+			const glm::vec3 center = (min + max) * 0.5f;
+			const glm::vec3 extent = (max - min) * 0.5f;
+
+			bound.joints.push_back(joint);
+			bound.center_x.push_back(center.x);
+			bound.center_y.push_back(center.y);
+			bound.center_z.push_back(center.z);
+			bound.extent_x.push_back(extent.x);
+			bound.extent_y.push_back(extent.y);
+			bound.extent_z.push_back(extent.z);
+		}
+
+		// Repeated joints don't change the union
+		while (!bound.joints.empty() && bound.joints.size() % 8 != 0)
+		{
+			bound.joints.push_back(bound.joints.front());
+			bound.center_x.push_back(bound.center_x.front());
+			bound.center_y.push_back(bound.center_y.front());
+			bound.center_z.push_back(bound.center_z.front());
+			bound.extent_x.push_back(bound.extent_x.front());
+			bound.extent_y.push_back(bound.extent_y.front());
+			bound.extent_z.push_back(bound.extent_z.front());
+		}
+
+		return bound;
+	}
+
+	std::pair<glm::vec3, glm::vec3> SkinBound::compute_world_bound(
+		std::span<const glm::mat4> joint_matrices
+	) const noexcept
+	{
+		glm::vec3 world_min(std::numeric_limits<float>::max());
+		glm::vec3 world_max(std::numeric_limits<float>::lowest());
+
+		size_t joint_idx = 0;
+
+#ifdef __AVX2__
+		// Column-major offsets of the upper 3x4 part of a matrix, `[column][row]`
+		static constexpr std::array<std::array<int, 3>, 4> element_offset = {
+			{{0, 1, 2}, {4, 5, 6}, {8, 9, 10}, {12, 13, 14}}
+		};
+
+		const float* const matrix_base = reinterpret_cast<const float*>(joint_matrices.data());
+		const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+
+		std::array<__m256, 3> batch_min, batch_max;
+		batch_min.fill(_mm256_set1_ps(std::numeric_limits<float>::max()));
+		batch_max.fill(_mm256_set1_ps(std::numeric_limits<float>::lowest()));
+
+		for (; joint_idx < joints.size(); joint_idx += 8)
+		{
+			const __m256i matrix_index = _mm256_slli_epi32(
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(joints.data() + joint_idx)),
+				4
+			);
+
+			const auto load_element = [&](int column, int row) {
+				const __m256i index =
+					_mm256_add_epi32(matrix_index, _mm256_set1_epi32(element_offset[column][row]));
+				return _mm256_i32gather_ps(matrix_base, index, sizeof(float));
+			};
+
+			const std::array<__m256, 3> center = {
+				_mm256_loadu_ps(center_x.data() + joint_idx),
+				_mm256_loadu_ps(center_y.data() + joint_idx),
+				_mm256_loadu_ps(center_z.data() + joint_idx)
+			};
+			const std::array<__m256, 3> extent = {
+				_mm256_loadu_ps(extent_x.data() + joint_idx),
+				_mm256_loadu_ps(extent_y.data() + joint_idx),
+				_mm256_loadu_ps(extent_z.data() + joint_idx)
+			};
+
+			for (const auto row : std::views::iota(0, 3))
+			{
+				__m256 world_center = load_element(3, row);
+				__m256 world_extent = _mm256_setzero_ps();
+
+				for (const auto column : std::views::iota(0, 3))
+				{
+					const __m256 element = load_element(column, row);
+					world_center = _mm256_add_ps(world_center, _mm256_mul_ps(element, center[column]));
+					world_extent = _mm256_add_ps(
+						world_extent,
+						_mm256_mul_ps(_mm256_andnot_ps(sign_mask, element), extent[column])
+					);
+				}
+
+				batch_min[row] = _mm256_min_ps(batch_min[row], _mm256_sub_ps(world_center, world_extent));
+				batch_max[row] = _mm256_max_ps(batch_max[row], _mm256_add_ps(world_center, world_extent));
+			}
+		}
+
+		for (const auto row : std::views::iota(0, 3))
+		{
+			alignas(32) std::array<float, 8> lane_min, lane_max;
+			_mm256_store_ps(lane_min.data(), batch_min[row]);
+			_mm256_store_ps(lane_max.data(), batch_max[row]);
+
+			world_min[row] = std::ranges::min(lane_min);
+			world_max[row] = std::ranges::max(lane_max);
+		}
+#endif
+
+		for (; joint_idx < joints.size(); ++joint_idx)
+		{
+			const glm::mat4& matrix = joint_matrices[joints[joint_idx]];
+			const glm::vec3 center = {center_x[joint_idx], center_y[joint_idx], center_z[joint_idx]};
+			const glm::vec3 extent = {extent_x[joint_idx], extent_y[joint_idx], extent_z[joint_idx]};
+
+			// Box of the transformed box, through the absolute linear part
+			const glm::mat3 linear = glm::mat3(matrix);
+			const glm::mat3 abs_linear = {glm::abs(linear[0]), glm::abs(linear[1]), glm::abs(linear[2])};
+
+			const glm::vec3 world_center = linear * center + glm::vec3(matrix[3]);
+			const glm::vec3 world_extent = abs_linear * extent;
+
+			world_min = glm::min(world_min, world_center - world_extent);
+			world_max = glm::max(world_max, world_center + world_extent);
+		}
+
+		return {world_min, world_max};
+	}
+}
@@ -7,8 +7,7 @@
 
 namespace graphics
 {
-	// Get a view matrix that looks in the direction of `view_dir`. Automatically chooses an up vector.
-	static glm::mat4 get_view_matrix(const glm::vec3& view_dir) noexcept
+	glm::mat4 get_light_view_matrix(const glm::vec3& view_dir) noexcept
 	{
 		if (glm::abs(glm::dot(glm::normalize(view_dir), glm::vec3(0.0f, 1.0f, 0.0f))) > 0.999f)
 			return glm::lookAt(glm::vec3(0.0f), view_dir, glm::vec3(1.0f, 0.0f, 0.0f));
@@ -94,7 +93,7 @@ namespace graphics
 	) noexcept
 	{
 		/* Find Convex Hull */
-		const auto view_matrix = get_view_matrix(view_dir);
+		const auto view_matrix = get_light_view_matrix(view_dir);
 		const auto projected_points = project_points_to_2d(frustum_corners, view_matrix);
 		auto sorted_points = sort_angle(projected_points);
 		const auto convex_hull = calc_convex_hull(std::move(sorted_points));
@@ -2,6 +2,7 @@
 
 #include <SDL3/SDL_gpu.h>
 #include <gpu/buffer.hpp>
+#include <gpu/deletion-queue.hpp>
 #include <map>
 #include <memory>
 #include <vector>
@@ -54,10 +55,13 @@ namespace graphics
 
 		///
 		/// @brief Recycle unused buffers from the pool to free memory
-		/// @note Should be called after all `acquire_buffer` in a frame
+		/// @note Should be called after all `acquire_buffer` in a frame. Unused buffers may still be read by
+		/// the previous submission, so they are released through the deletion queue.
 		/// @warning Not thread-safe
 		///
-		void gc() noexcept;
+		/// @param deletion_queue Deletion queue releasing the buffers
+		///
+		void gc(gpu::DeletionQueue& deletion_queue) noexcept;
 
 		BufferPool(const BufferPool&) = delete;
 		BufferPool(BufferPool&&) = default;
@@ -111,10 +115,13 @@ namespace graphics
 
 		///
 		/// @brief Recycle unused buffers from the pool to free memory
-		/// @note Should be called after all `acquire_buffer` in a frame
+		/// @note Should be called after all `acquire_buffer` in a frame. Unused buffers may still be read by
+		/// the previous submission, so they are released through the deletion queue.
 		/// @warning Not thread-safe
 		///
-		void gc() noexcept;
+		/// @param deletion_queue Deletion queue releasing the buffers
+		///
+		void gc(gpu::DeletionQueue& deletion_queue) noexcept;
 
 		TransferBufferPool(const TransferBufferPool&) = delete;
 		TransferBufferPool(TransferBufferPool&&) = default;
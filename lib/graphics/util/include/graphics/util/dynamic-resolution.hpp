@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace graphics
+{
+	///
+	/// @brief Adjusts the render scale so that frame times stay within a budget
+	/// @details
+	/// - Frame times are smoothed by an exponential moving average
+	/// - The error is zero inside the band `[target * (1 - headroom), target]`, relative to the target
+	/// outside. The band absorbs the cost change of one scale step, so a load between two steps settles on
+	/// the lower one instead of oscillating.
+	/// - A PID in velocity form, `Δu = kp * Δe + ki * e + kd * Δ²e`, moves a continuous scale. Each change
+	/// is limited to `max_change`, and the scale is clamped to the bounds, which also stops integral windup.
+	/// - The output scale is the continuous scale quantized to multiples of `scale_step`. It only changes
+	/// once the continuous scale is `hysteresis` steps past the midpoint to the next step, so targets are
+	/// not resized back and forth around a step boundary.
+	/// - The output only steps up if the frame time, predicted proportional to the pixel count, fits the
+	/// budget minus half the band. A load whose step cost exceeds the band then holds the lower step
+	/// instead of alternating.
+	///
+	/// #### Usage:
+	/// ```cpp
+	/// const float scale = controller.update(frame_time);
+	/// const auto render_size = DynamicResolution::scale_size(full_size, scale);
+	/// ```
+	///
+	class DynamicResolution
+	{
+	  public:
+
+		struct Config
+		{
+			float target_frame_time = 1.0f / 60.0f;  // Frame time budget, in seconds
+			float headroom = 0.15f;                  // Width of the dead band under the budget, relative
+			float min_scale = 0.5f;                  // Lowest render scale, per axis
+			float max_scale = 1.0f;                  // Highest render scale, per axis
+			float scale_step = 0.05f;                // Output scales are multiples of it
+			float hysteresis = 0.25f;                // Steps past the midpoint before the output changes
+			float kp = 0.1f;                         // Gain on the error change
+			float ki = 0.08f;                        // Gain on the error, the main term
+			float kd = 0.02f;                        // Gain on the error acceleration
+			float max_change = 0.05f;                // Largest change of the continuous scale per frame
+			float smoothing = 0.3f;                  // Weight of a new frame time in the average
+		};
+
+		struct Stats
+		{
+			float filtered_frame_time = 0.0f;  // Smoothed frame time, in seconds
+			float error = 0.0f;                // Last error, positive with headroom
+			float raw_scale = 1.0f;            // Continuous scale, before quantization
+			float scale = 1.0f;                // Quantized output scale
+			uint64_t scale_changes = 0;        // Output scale changes, since creation or reset
+		};
+
+		explicit DynamicResolution(const Config& config) noexcept;
+
+		///
+		/// @brief Feed the time of the last frame and get the scale of the next one
+		///
+		/// @param frame_time Time of the last frame, in seconds. Non-positive values are ignored.
+		/// @return Quantized render scale
+		///
+		float update(float frame_time) noexcept;
+
+		// Go back to the highest scale and drop the controller state
+		void reset() noexcept;
+
+		// Get the quantized render scale
+		float get_scale() const noexcept { return stats.scale; }
+
+		Stats get_stats() const noexcept { return stats; }
+
+		const Config& get_config() const noexcept { return config; }
+
+		///
+		/// @brief Scale a size, rounding to the nearest pixel
+		///
+		/// @param size Full size
+		/// @param scale Render scale, per axis
+		/// @return Scaled size, at least 1 pixel per axis
+		///
+		static glm::u32vec2 scale_size(glm::u32vec2 size, float scale) noexcept;
+
+	  private:
+
+		Config config;
+		Stats stats;
+
+		bool has_frame_time = false;
+		float prev_error = 0.0f;
+		float prev_prev_error = 0.0f;
+
+		float quantize(float scale) const noexcept;
+	};
+}
@@ -140,13 +140,15 @@ namespace graphics
 		/// @param samplers Sampler bindings, can be empty
 		/// @param storage_textures Storage texture bindings, can be empty
 		/// @param storage_buffers Storage buffer bindings, can be empty
+		/// @param region Rendered region at the top-left corner of the target, the whole target if empty
 		///
 		std::expected<void, util::Error> render(
 			const gpu::CommandBuffer& command_buffer,
 			SDL_GPUTexture* target_texture,
 			std::optional<std::span<const SDL_GPUTextureSamplerBinding>> samplers,
 			std::optional<std::span<SDL_GPUTexture* const>> storage_textures,
-			std::optional<std::span<SDL_GPUBuffer* const>> storage_buffers
+			std::optional<std::span<SDL_GPUBuffer* const>> storage_buffers,
+			std::optional<glm::u32vec2> region = std::nullopt
 		) const noexcept;
 
 	  private:
@@ -0,0 +1,348 @@
+#pragma once
+
+#include "gpu/buffer.hpp"
+#include "gpu/texture.hpp"
+#include "graphics/util/texture-pool.hpp"
+#include "util/error.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <functional>
+#include <glm/glm.hpp>
+#include <ranges>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace graphics
+{
+	///
+	/// @brief Declarative graph of the passes of a frame
+	/// @details #### Usage:
+	/// - Declare resources with `create_*`, transient within the frame, or `import_*`, outliving the frame
+	/// - Declare passes in submission order with `add_pass`, with the resources they read and write
+	/// - `compile` orders and culls passes, then plans the memory of transient resources
+	/// - `execute` runs the passes kept by a compiled graph
+	///
+	/// #### Versions:
+	/// Every write produces a new version of a resource, returned as a new handle. Readers of a version
+	/// run after its writer and before the next write, so a pass sequence is ordered by its data flow.
+	///
+	/// #### Culling:
+	/// Passes are kept when they have side effects, write a preserved imported resource, or write a version
+	/// read by a kept pass. Other passes are culled with the transient resources only they use.
+	///
+	/// #### Aliasing:
+	/// Compatible transient resources whose lifetimes, spans of positions in the compiled order, do not
+	/// overlap share one allocation. Textures differing only by usage are compatible, their allocation
+	/// has every usage.
+	///
+	/// @note Declaring and compiling is pure CPU work, allocations are planned but not created. Texture
+	/// allocations are created and bound to their resources by `TransientTextures`.
+	///
+	class RenderGraph
+	{
+	  public:
+
+		struct TextureDesc
+		{
+			gpu::Texture::Format format;
+			glm::u32vec2 size;
+			uint32_t layers = 1;
+			uint32_t mip_levels = 1;
+
+			// Identical type, format, size, layers and mip levels, required to share an allocation
+			bool compatible_with(const TextureDesc& other) const noexcept;
+
+			// Get the description of an allocation shared with a compatible texture, with both usages
+			TextureDesc merged_with(const TextureDesc& other) const noexcept;
+
+			// Get the memory size of every layer and mip level in bytes
+			uint64_t get_bytes() const noexcept;
+		};
+
+		struct BufferDesc
+		{
+			gpu::Buffer::Usage usage;
+			uint32_t size;
+
+			// Identical usage and size, required to share an allocation
+			bool compatible_with(const BufferDesc& other) const noexcept;
+		};
+
+		// Versioned handle to a resource, each write returns the handle of a new version
+		struct Handle
+		{
+			uint32_t resource = UINT32_MAX;
+			uint32_t version = 0;
+
+			bool is_valid() const noexcept { return resource != UINT32_MAX; }
+		};
+
+		// Run the commands of a pass
+		using Execute = std::function<std::expected<void, util::Error>()>;
+
+		///
+		/// @brief Declares the resources used by a pass
+		/// @note References the graph, which must outlive it
+		///
+		class PassBuilder
+		{
+		  public:
+
+			// Declare that the pass reads a version of a resource
+			void read(Handle handle) noexcept;
+
+			///
+			/// @brief Declare that the pass writes a resource, keeping or replacing its content
+			///
+			/// @param handle Latest version of the resource
+			/// @return Handle of the version written by the pass
+			///
+			Handle write(Handle handle) noexcept;
+
+			// Keep the pass even if none of its outputs are used, e.g. presenting or reading back
+			void side_effect() noexcept;
+
+		  private:
+
+			RenderGraph& graph;
+			uint32_t pass;
+
+			PassBuilder(RenderGraph& graph, uint32_t pass) noexcept :
+				graph(graph),
+				pass(pass)
+			{}
+
+			friend class RenderGraph;
+		};
+
+		// Span of positions in the compiled order where a resource is used, inclusive
+		struct Lifetime
+		{
+			uint32_t first = UINT32_MAX;
+			uint32_t last = 0;
+
+			bool overlaps(const Lifetime& other) const noexcept
+			{
+				return first <= other.last && other.first <= last;
+			}
+		};
+
+		struct Stats
+		{
+			uint32_t passes = 0;               // Passes kept
+			uint32_t culled_passes = 0;        // Passes culled
+			uint32_t transient_resources = 0;  // Transient resources used by kept passes
+			uint32_t allocations = 0;          // Allocations backing them
+			uint64_t transient_bytes = 0;      // Memory of transient resources without aliasing
+			uint64_t allocated_bytes = 0;      // Memory of transient resources with aliasing
+		};
+
+		struct Compiled
+		{
+			std::vector<uint32_t> order;       // Kept passes in execution order
+			std::vector<uint8_t> culled;       // Per pass, 1 if culled
+			std::vector<Lifetime> lifetimes;   // Per resource, empty span if unused
+			std::vector<uint32_t> allocation;  // Per resource, `no_allocation` for imported or unused ones
+			Stats stats;
+
+			// Per allocation, a description covering every resource aliased to it
+			std::vector<std::variant<TextureDesc, BufferDesc>> allocations;
+		};
+
+		static constexpr uint32_t no_allocation = UINT32_MAX;
+
+		RenderGraph() = default;
+
+		RenderGraph(const RenderGraph&) = delete;
+		RenderGraph(RenderGraph&&) = default;
+		RenderGraph& operator=(const RenderGraph&) = delete;
+		RenderGraph& operator=(RenderGraph&&) = default;
+
+		// Declare a transient texture, its first write must not read previous content
+		Handle create_texture(std::string name, const TextureDesc& desc) noexcept;
+
+		// Declare a transient buffer, its first write must not read previous content
+		Handle create_buffer(std::string name, const BufferDesc& desc) noexcept;
+
+		///
+		/// @brief Declare a texture outliving the frame
+		///
+		/// @param name Name of the texture
+		/// @param desc Description of the texture
+		/// @param preserve Keep passes writing it, e.g. for the swapchain. History read back by the next
+		/// frame only is not preserved, so its writers are culled along with its readers.
+		/// @return Handle of the content at the start of the frame
+		///
+		Handle import_texture(std::string name, const TextureDesc& desc, bool preserve) noexcept;
+
+		// Declare a buffer outliving the frame, see `import_texture`
+		Handle import_buffer(std::string name, const BufferDesc& desc, bool preserve) noexcept;
+
+		///
+		/// @brief Declare a pass, after every pass it depends on
+		///
+		/// @param name Name of the pass
+		/// @param execute Commands of the pass, optional when only compiling
+		/// @return Builder declaring the resources used by the pass
+		///
+		PassBuilder add_pass(std::string name, Execute execute = {}) noexcept;
+
+		///
+		/// @brief Order and cull passes, then plan transient allocations
+		///
+		/// @return Compiled graph, or error on invalid declarations
+		///
+		std::expected<Compiled, util::Error> compile() const noexcept;
+
+		///
+		/// @brief Execute the kept passes in compiled order
+		///
+		/// @param compiled Result of `compile` on this graph
+		/// @return Void on success, or the error of the first failing pass
+		///
+		std::expected<void, util::Error> execute(const Compiled& compiled) const noexcept;
+
+		///
+		/// @brief Describe the graph in GraphViz DOT format
+		/// @details Passes are boxes numbered in execution order, culled ones dashed. Resources are ellipses,
+		/// imported ones doubled, transient ones labeled with their allocation.
+		///
+		/// @param compiled Result of `compile` on this graph
+		/// @return DOT source
+		///
+		std::string to_graphviz(const Compiled& compiled) const noexcept;
+
+	  private:
+
+		struct Resource
+		{
+			std::string name;
+			std::variant<TextureDesc, BufferDesc> desc;
+			bool imported;
+			bool preserve;
+			uint32_t version_count = 1;  // Version 0 is the content at the start of the frame
+		};
+
+		struct Pass
+		{
+			std::string name;
+			Execute execute;
+			std::vector<Handle> reads;
+			std::vector<Handle> writes;  // Versions produced by the pass
+			bool side_effect = false;
+		};
+
+		std::vector<Resource> resources;
+		std::vector<Pass> passes;
+
+		// First declaration error, reported by `compile`
+		std::string declaration_error;
+	};
+
+	///
+	/// @brief Textures backing the transient texture allocations of a compiled graph
+	/// @details `realize` returns the textures of the previous graph to the pool, then acquires one texture
+	/// per texture allocation of the new graph. Transient textures aliased by the graph get the same texture,
+	/// and identical frames reuse the textures of the previous one. Buffer allocations are not realized.
+	///
+	/// @tparam Pool Pool the textures are acquired from, see `BasicTexturePool`
+	///
+	template <typename Pool>
+	class BasicTransientTextures
+	{
+	  public:
+
+		using Texture = typename Pool::Texture;
+
+		///
+		/// @brief Acquire the textures of a compiled graph, releasing those of the previous one
+		/// @note Released textures may be reacquired right away, the previous submission may still use them
+		/// but later submissions are ordered after it
+		///
+		/// @param pool Pool the textures are acquired from and returned to
+		/// @param compiled Compiled graph, resources are looked up with its handles until the next call
+		/// @return Void on success, or error if acquiring a texture failed
+		///
+		std::expected<void, util::Error> realize(Pool& pool, const RenderGraph::Compiled& compiled) noexcept
+		{
+			release(pool);
+
+			// Per allocation, index of its texture
+			std::vector<uint32_t> allocation_texture(
+				compiled.allocations.size(),
+				RenderGraph::no_allocation
+			);
+
+			for (const auto [allocation_idx, desc] : compiled.allocations | std::views::enumerate)
+			{
+				const auto* texture_desc = std::get_if<RenderGraph::TextureDesc>(&desc);
+				if (texture_desc == nullptr) continue;
+
+				// Pooled textures have a single layer
+				if (texture_desc->layers != 1)
+					return util::Error(std::format("Transient texture {} is layered", allocation_idx));
+
+				auto texture = pool.acquire(
+					texture_desc->format,
+					texture_desc->size,
+					texture_desc->mip_levels,
+					std::format("Transient Texture {}", allocation_idx)
+				);
+				if (!texture) return texture.error().forward("Acquire transient texture failed");
+
+				allocation_texture[allocation_idx] = uint32_t(textures.size());
+				textures.push_back({.desc = *texture_desc, .texture = std::move(*texture)});
+			}
+
+			resource_texture.assign(compiled.allocation.size(), RenderGraph::no_allocation);
+			for (const auto [resource_idx, allocation_idx] : compiled.allocation | std::views::enumerate)
+				if (allocation_idx != RenderGraph::no_allocation)
+					resource_texture[resource_idx] = allocation_texture[allocation_idx];
+
+			return {};
+		}
+
+		///
+		/// @brief Get the texture bound to a transient texture of the realized graph
+		///
+		/// @param handle Any version of the resource
+		/// @return Texture, or null for imported, unused and buffer resources
+		///
+		const Texture* get(RenderGraph::Handle handle) const noexcept
+		{
+			if (handle.resource >= resource_texture.size()) return nullptr;
+
+			const auto texture_idx = resource_texture[handle.resource];
+			return texture_idx == RenderGraph::no_allocation ? nullptr : &textures[texture_idx].texture;
+		}
+
+		// Return every texture to the pool, resources are unbound
+		void release(Pool& pool) noexcept
+		{
+			for (auto& [desc, texture] : textures)
+				pool.release(std::move(texture), desc.format, desc.size, desc.mip_levels);
+
+			textures.clear();
+			resource_texture.clear();
+		}
+
+		// Get the number of textures, one per texture allocation of the realized graph
+		size_t get_texture_count() const noexcept { return textures.size(); }
+
+	  private:
+
+		struct Allocation
+		{
+			RenderGraph::TextureDesc desc;
+			Texture texture;
+		};
+
+		std::vector<Allocation> textures;
+		std::vector<uint32_t> resource_texture;  // Per resource, index in `textures` or `no_allocation`
+	};
+
+	using TransientTextures = BasicTransientTextures<TexturePool>;
+}
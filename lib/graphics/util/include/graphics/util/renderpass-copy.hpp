@@ -31,12 +31,14 @@ namespace graphics
 		/// @param command_buffer Command buffer
 		/// @param src Source texture
 		/// @param dst Destination texture
+		/// @param region Size of the region copied, at the top-left corner. The whole destination if empty.
 		/// @return Result
 		///
 		std::expected<void, util::Error> copy(
 			const gpu::CommandBuffer& command_buffer,
 			SDL_GPUTexture* src,
-			SDL_GPUTexture* dst
+			SDL_GPUTexture* dst,
+			std::optional<glm::u32vec2> region = std::nullopt
 		) const noexcept;
 
 	  private:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gpu/texture.hpp"
+#include "graphics/util/texture-pool.hpp"
 
 #include "util/error.hpp"
 #include <glm/glm.hpp>
@@ -37,8 +38,14 @@ namespace graphics
 		/// @brief Resize the texture
 		///
 		/// @param size New size
+		/// @param pool Pool the texture is acquired from and returned to, created and released immediately
+		/// if null
 		///
-		std::expected<void, util::Error> resize(SDL_GPUDevice* device, glm::u32vec2 size) noexcept;
+		std::expected<void, util::Error> resize(
+			SDL_GPUDevice* device,
+			glm::u32vec2 size,
+			TexturePool* pool = nullptr
+		) noexcept;
 
 		///
 		/// @brief Get the size of the texture
@@ -97,10 +104,13 @@ namespace graphics
 		/// @note This invalidates any previously obtained texture pointers
 		///
 		/// @param size New size
+		/// @param pool Pool the textures are acquired from and returned to, created and released immediately
+		/// if null
 		///
 		std::expected<void, util::Error> resize_and_cycle(
 			SDL_GPUDevice* device,
-			glm::u32vec2 new_size
+			glm::u32vec2 new_size,
+			TexturePool* pool = nullptr
 		) noexcept;
 
 		///
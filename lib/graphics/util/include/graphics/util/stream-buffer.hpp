@@ -0,0 +1,80 @@
+#pragma once
+
+#include "gpu/buffer.hpp"
+#include "gpu/copy-pass.hpp"
+
+#include "util/error.hpp"
+#include <memory>
+#include <span>
+#include <string>
+
+namespace graphics
+{
+	///
+	/// @brief GPU buffer whose content is rewritten every frame
+	/// @details #### Usage:
+	/// - Write the data of the frame with `update`, buffers grow to the next power of two when needed
+	/// - Record the upload with `upload` in a copy pass, before any pass reading the buffer
+	/// - Use `operator*` to get the GPU buffer, valid until the next growth
+	/// @note Both buffers are written in cycle mode, SDL keeps a ring of backing memory for the frames still
+	/// in flight, so the buffers are never reallocated at a steady size
+	///
+	class StreamBuffer
+	{
+	  public:
+
+		StreamBuffer(const StreamBuffer&) = delete;
+		StreamBuffer& operator=(const StreamBuffer&) = delete;
+		StreamBuffer(StreamBuffer&&) = default;
+		StreamBuffer& operator=(StreamBuffer&&) = default;
+
+		///
+		/// @brief Create a stream buffer, buffers are created on the first update
+		///
+		/// @param usage Usage of the GPU buffer
+		/// @param name Name of the GPU buffer
+		/// @param min_capacity Minimum capacity in bytes, must be greater than 0
+		///
+		StreamBuffer(gpu::Buffer::Usage usage, std::string name, uint32_t min_capacity = 4096) noexcept :
+			usage(usage),
+			name(std::move(name)),
+			min_capacity(min_capacity)
+		{}
+
+		~StreamBuffer() = default;
+
+		///
+		/// @brief Copy the data of the frame into the transfer buffer, growing both buffers if needed
+		///
+		/// @param data Data of the frame, may be empty
+		/// @return Void on success, or error on failure
+		///
+		std::expected<void, util::Error> update(
+			SDL_GPUDevice* device,
+			std::span<const std::byte> data
+		) noexcept;
+
+		///
+		/// @brief Upload the data of the last update to the GPU buffer
+		///
+		/// @param copy_pass Copy pass
+		///
+		void upload(const gpu::CopyPass& copy_pass) const noexcept;
+
+		// Get the capacity of the buffers in bytes
+		uint32_t get_capacity() const noexcept { return capacity; }
+
+		const gpu::Buffer& operator*() const noexcept;
+
+	  private:
+
+		gpu::Buffer::Usage usage;
+		std::string name;
+		uint32_t min_capacity;
+
+		uint32_t capacity = 0;
+		uint32_t size = 0;  // Size of the data of the last update
+		std::unique_ptr<gpu::Buffer> buffer;
+		std::unique_ptr<gpu::TransferBuffer> upload_buffer;
+	};
+}
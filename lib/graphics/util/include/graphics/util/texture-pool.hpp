@@ -0,0 +1,357 @@
+#pragma once
+
+#include <SDL3/SDL_gpu.h>
+#include <algorithm>
+#include <expected>
+#include <gpu/deletion-queue.hpp>
+#include <gpu/texture.hpp>
+#include <glm/glm.hpp>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace graphics
+{
+	///
+	/// @brief Creates, names and releases the SDL GPU textures of a `TexturePool`
+	/// @details A pool device provides `Texture`, `create`, `set_name`, `is_empty` and `release`, so that the
+	/// reuse and eviction decisions of the pool can be driven by a mock device.
+	///
+	class TextureDevice
+	{
+	  public:
+
+		using Texture = gpu::Texture;
+
+		TextureDevice(SDL_GPUDevice* device) noexcept :
+			device(device)
+		{}
+
+		std::expected<gpu::Texture, util::Error> create(
+			const gpu::Texture::Format& format,
+			glm::u32vec2 size,
+			uint32_t mip_levels,
+			const std::string& name
+		) const noexcept;
+
+		void set_name(const gpu::Texture& texture, const std::string& name) const noexcept;
+
+		static bool is_empty(const gpu::Texture& texture) noexcept;
+
+		// Release an evicted texture once the submissions that may use it have completed
+		static void release(
+			gpu::DeletionQueue& deletion_queue,
+			gpu::Texture texture,
+			uint64_t bytes
+		) noexcept;
+
+	  private:
+
+		SDL_GPUDevice* device;
+	};
+
+	///
+	/// @brief Pool of render target textures, reused by format, usage, mip levels and size bucket
+	/// @details #### Usage:
+	/// - `acquire` a texture when a target is created or resized, `release` the texture it replaces
+	/// - `collect` once per frame, idle textures are evicted into the deletion queue
+	///
+	/// #### Reuse:
+	/// Sizes are rounded up to a multiple of `Config::size_granularity`, the bucket, which is the size of the
+	/// allocation. Acquiring reuses the most recently released idle texture of the same key.
+	///
+	/// #### Eviction:
+	/// Idle textures unused for `Config::max_idle_frames` are evicted. While the memory of live and idle
+	/// textures exceeds `Config::budget_bytes`, the least recently released idle texture is evicted too.
+	/// Live textures are never evicted, the budget can be exceeded by them alone.
+	///
+	/// @warning Not thread-safe
+	///
+	/// @tparam Device Device creating and releasing the textures, see `TextureDevice`
+	///
+	template <typename Device>
+	class BasicTexturePool
+	{
+	  public:
+
+		struct Config
+		{
+			uint32_t size_granularity = 1;         // Allocation sizes are multiples of it, 1 for exact sizes
+			uint64_t budget_bytes = 512ull << 20;  // Memory of live and idle textures before evicting
+			uint32_t max_idle_frames = 300;        // Idle textures unused for longer are evicted
+		};
+
+		struct Stats
+		{
+			size_t live_textures = 0;  // Acquired and not released
+			size_t idle_textures = 0;  // Released and kept for reuse
+			uint64_t live_bytes = 0;   // Memory of live textures
+			uint64_t idle_bytes = 0;   // Memory of idle textures
+			size_t hits = 0;           // Acquisitions reusing an idle texture, since creation
+			size_t misses = 0;         // Acquisitions creating a texture, since creation
+			size_t evictions = 0;      // Idle textures evicted, since creation
+		};
+
+		using Texture = typename Device::Texture;
+
+		BasicTexturePool(Device device, const Config& config) noexcept :
+			device(std::move(device)),
+			config(config)
+		{}
+
+		///
+		/// @brief Get the size bucket of a requested size, the size of its allocation
+		///
+		/// @param size Requested size
+		/// @return Size rounded up to a multiple of the granularity
+		///
+		glm::u32vec2 get_bucket(glm::u32vec2 size) const noexcept
+		{
+			const uint32_t granularity = std::max(config.size_granularity, 1u);
+			return (size + granularity - 1u) / granularity * granularity;
+		}
+
+		///
+		/// @brief Acquire a texture, reusing an idle one if possible
+		///
+		/// @param format Format and usage of the texture
+		/// @param size Requested size, the texture has the size of its bucket
+		/// @param mip_levels Mip level count
+		/// @param name Debug name of the texture, also applied to reused textures
+		/// @return Texture, or error if creating failed
+		///
+		std::expected<Texture, util::Error> acquire(
+			const gpu::Texture::Format& format,
+			glm::u32vec2 size,
+			uint32_t mip_levels,
+			const std::string& name
+		) noexcept
+		{
+			const auto key = make_key(format, size, mip_levels);
+			const uint64_t bytes = format.get_size(key.width, key.height, 1, mip_levels);
+
+			/* Search for idle texture */
+
+			auto find_it = idle_pool.find(key);
+			if (find_it != idle_pool.end() && !find_it->second.empty())  // Pool hit
+			{
+				auto texture = std::move(find_it->second.back().texture);
+				find_it->second.pop_back();
+				if (find_it->second.empty()) idle_pool.erase(find_it);
+
+				device.set_name(texture, name);
+
+				stats.hits++;
+				stats.idle_textures--;
+				stats.idle_bytes -= bytes;
+				stats.live_textures++;
+				stats.live_bytes += bytes;
+
+				return texture;
+			}
+
+			/* Create new texture */
+
+			auto texture_result = device.create(format, {key.width, key.height}, mip_levels, name);
+			if (!texture_result) return texture_result.error().forward("Create pooled texture failed");
+
+			stats.misses++;
+			stats.live_textures++;
+			stats.live_bytes += bytes;
+
+			return std::move(*texture_result);
+		}
+
+		///
+		/// @brief Return a texture acquired from the pool, keeping it for reuse
+		/// @note Idle textures are reused from the next `acquire`, the previous submission may still use them
+		/// but later submissions are ordered after it
+		///
+		/// @param texture Texture, ignored if empty
+		/// @param format Format and usage given to `acquire`
+		/// @param size Size given to `acquire`
+		/// @param mip_levels Mip level count given to `acquire`
+		///
+		void release(
+			Texture texture,
+			const gpu::Texture::Format& format,
+			glm::u32vec2 size,
+			uint32_t mip_levels
+		) noexcept
+		{
+			if (Device::is_empty(texture)) return;
+
+			const auto key = make_key(format, size, mip_levels);
+			const uint64_t bytes = format.get_size(key.width, key.height, 1, mip_levels);
+
+			idle_pool[key].push_back(
+				{.released_frame = frame, .bytes = bytes, .texture = std::move(texture)}
+			);
+
+			stats.live_textures--;
+			stats.live_bytes -= bytes;
+			stats.idle_textures++;
+			stats.idle_bytes += bytes;
+		}
+
+		///
+		/// @brief End the frame, evicting idle textures unused for too long or over budget
+		///
+		/// @param deletion_queue Deletion queue releasing evicted textures
+		///
+		void collect(gpu::DeletionQueue& deletion_queue) noexcept
+		{
+			/* Expired idle textures */
+
+			const auto expired = [this](const IdleTexture& idle) {
+				return frame - idle.released_frame >= config.max_idle_frames;
+			};
+
+			for (auto it = idle_pool.begin(); it != idle_pool.end();)
+			{
+				auto& idle_list = it->second;
+
+				// Idle lists are in release order, expired textures come first
+				const auto first_kept = std::ranges::find_if_not(idle_list, expired);
+				for (auto& idle : std::ranges::subrange(idle_list.begin(), first_kept))
+				{
+					stats.evictions++;
+					stats.idle_textures--;
+					stats.idle_bytes -= idle.bytes;
+					Device::release(deletion_queue, std::move(idle.texture), idle.bytes);
+				}
+
+				idle_list.erase(idle_list.begin(), first_kept);
+				it = idle_list.empty() ? idle_pool.erase(it) : std::next(it);
+			}
+
+			/* Over budget, least recently released first */
+
+			while (stats.live_bytes + stats.idle_bytes > config.budget_bytes)
+				if (!evict_oldest(deletion_queue)) break;
+
+			frame++;
+		}
+
+		Stats get_stats() const noexcept { return stats; }
+
+		BasicTexturePool(const BasicTexturePool&) = delete;
+		BasicTexturePool(BasicTexturePool&&) = default;
+		BasicTexturePool& operator=(const BasicTexturePool&) = delete;
+		BasicTexturePool& operator=(BasicTexturePool&&) = default;
+
+	  private:
+
+		struct PoolKey
+		{
+			SDL_GPUTextureType type;
+			SDL_GPUTextureFormat format;
+			SDL_GPUTextureUsageFlags usage;
+			uint32_t mip_levels;
+			uint32_t width;
+			uint32_t height;
+
+			auto operator<=>(const PoolKey&) const = default;
+			bool operator==(const PoolKey&) const = default;
+		};
+
+		struct IdleTexture
+		{
+			uint64_t released_frame;
+			uint64_t bytes;
+			Texture texture;
+		};
+
+		Device device;
+		Config config;
+
+		// Per key, idle textures in release order, the most recent last
+		std::map<PoolKey, std::vector<IdleTexture>> idle_pool;
+
+		uint64_t frame = 0;
+		Stats stats;
+
+		PoolKey make_key(const gpu::Texture::Format& format, glm::u32vec2 size, uint32_t mip_levels)
+			const noexcept
+		{
+			const auto bucket = get_bucket(size);
+
+			return {
+				.type = format.type,
+				.format = format.format,
+				.usage = format.usage,
+				.mip_levels = mip_levels,
+				.width = bucket.x,
+				.height = bucket.y
+			};
+		}
+
+		// Evict the least recently released idle texture, `false` if none
+		bool evict_oldest(gpu::DeletionQueue& deletion_queue) noexcept
+		{
+			// Idle lists are in release order, their fronts hold the candidates
+			const auto oldest = std::ranges::min_element(idle_pool, {}, [](const auto& entry) {
+				return entry.second.front().released_frame;
+			});
+			if (oldest == idle_pool.end()) return false;
+
+			auto& idle_list = oldest->second;
+			auto& idle = idle_list.front();
+
+			stats.evictions++;
+			stats.idle_textures--;
+			stats.idle_bytes -= idle.bytes;
+			Device::release(deletion_queue, std::move(idle.texture), idle.bytes);
+
+			idle_list.erase(idle_list.begin());
+			if (idle_list.empty()) idle_pool.erase(oldest);
+
+			return true;
+		}
+	};
+
+	using TexturePool = BasicTexturePool<TextureDevice>;
+
+	///
+	/// @brief Delays target resizes until the requested size is stable
+	/// @details While the requested size keeps changing, e.g. during an interactive window resize, the
+	/// committed size is kept and targets stay allocated. A size requested for `stable_frames` consecutive
+	/// frames is committed, the first requested size is committed immediately.
+	///
+	class ResizeHysteresis
+	{
+	  public:
+
+		///
+		/// @brief Create a hysteresis with no committed size
+		///
+		/// @param stable_frames Consecutive frames a new size is requested before it is committed
+		///
+		explicit ResizeHysteresis(uint32_t stable_frames) noexcept :
+			stable_frames(stable_frames)
+		{}
+
+		///
+		/// @brief Update with the size requested for this frame
+		///
+		/// @param requested Requested size, usually the swapchain size
+		/// @return Committed size, which targets should have this frame
+		///
+		glm::u32vec2 update(glm::u32vec2 requested) noexcept;
+
+		// Get the committed size, zero before the first update
+		glm::u32vec2 get_size() const noexcept { return committed; }
+
+		// Check if a requested size differs from the committed one and waits to be stable
+		bool is_pending() const noexcept { return pending_frames > 0; }
+
+	  private:
+
+		uint32_t stable_frames;
+
+		glm::u32vec2 committed = {0, 0};
+		glm::u32vec2 pending = {0, 0};
+		uint32_t pending_frames = 0;
+	};
+}
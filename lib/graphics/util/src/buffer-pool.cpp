@@ -36,8 +36,12 @@ namespace graphics
 		return in_use_buffers.back().second;
 	}
 
-	void BufferPool::gc() noexcept
+	void BufferPool::gc(gpu::DeletionQueue& deletion_queue) noexcept
 	{
+		for (auto& [key, buffers] : backup_pool)
+			for (auto& buffer : buffers)
+				if (buffer.use_count() == 1) deletion_queue.release(std::move(*buffer), key.size);
+
 		backup_pool.clear();
 	}
 
@@ -75,8 +79,12 @@ namespace graphics
 		return in_use_buffers.back().second;
 	}
 
-	void TransferBufferPool::gc() noexcept
+	void TransferBufferPool::gc(gpu::DeletionQueue& deletion_queue) noexcept
 	{
+		for (auto& [key, buffers] : backup_pool)
+			for (auto& buffer : buffers)
+				if (buffer.use_count() == 1) deletion_queue.release(std::move(*buffer), key.size);
+
 		backup_pool.clear();
 	}
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "graphics/util/dynamic-resolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace graphics
+{
+	DynamicResolution::DynamicResolution(const Config& config) noexcept :
+		config(config)
+	{
+		reset();
+	}
+
+	float DynamicResolution::quantize(float scale) const noexcept
+	{
+		const float stepped = std::round(scale / config.scale_step) * config.scale_step;
+		return std::clamp(stepped, config.min_scale, config.max_scale);
+	}
+
+	float DynamicResolution::update(float frame_time) noexcept
+	{
+		if (!(frame_time > 0.0f)) return stats.scale;
+
+		/* Filter */
+
+		stats.filtered_frame_time = has_frame_time
+			? std::lerp(stats.filtered_frame_time, frame_time, config.smoothing)
+			: frame_time;
+		has_frame_time = true;
+
+		/* Error */
+
+		const float band_low = config.target_frame_time * (1.0f - config.headroom);
+		const float error = [&] {
+			if (stats.filtered_frame_time > config.target_frame_time)
+				return (config.target_frame_time - stats.filtered_frame_time) / config.target_frame_time;
+			if (stats.filtered_frame_time < band_low)
+				return (band_low - stats.filtered_frame_time) / config.target_frame_time;
+			return 0.0f;
+		}();
+
+		/* PID, velocity form */
+
+		const float delta = config.kp * (error - prev_error)
+			+ config.ki * error
+			+ config.kd * (error - 2.0f * prev_error + prev_prev_error);
+
+		prev_prev_error = prev_error;
+		prev_error = error;
+		stats.error = error;
+
+		stats.raw_scale = std::clamp(
+			stats.raw_scale + std::clamp(delta, -config.max_change, config.max_change),
+			config.min_scale,
+			config.max_scale
+		);
+
+		/* Quantize with hysteresis */
+
+		const float threshold = config.scale_step * (0.5f + config.hysteresis);
+		const bool at_bound = stats.raw_scale == config.min_scale || stats.raw_scale == config.max_scale;
+
+		if (std::abs(stats.raw_scale - stats.scale) >= threshold || at_bound)
+		{
+			const float scale = quantize(stats.raw_scale);
+
+			// Frame time predicted proportional to the pixel count, an upper bound when part of it isn't.
+			// Compared with half the band as margin, so that noise alone can't trigger a step up.
+			const float ratio = scale / stats.scale;
+			const float predicted_frame_time = stats.filtered_frame_time * ratio * ratio;
+			const float step_up_limit = config.target_frame_time * (1.0f - 0.5f * config.headroom);
+
+			if (scale > stats.scale && predicted_frame_time > step_up_limit)
+			{
+				// Would go over budget, hold the continuous scale at the threshold instead of winding up
+				stats.raw_scale = std::min(stats.raw_scale, stats.scale + threshold);
+			}
+			else if (scale != stats.scale)
+			{
+				stats.scale = scale;
+				stats.scale_changes++;
+			}
+		}
+
+		return stats.scale;
+	}
+
+	void DynamicResolution::reset() noexcept
+	{
+		const float scale = quantize(config.max_scale);
+
+		stats = {.raw_scale = scale, .scale = scale};
+		has_frame_time = false;
+		prev_error = 0.0f;
+		prev_prev_error = 0.0f;
+	}
+
+	glm::u32vec2 DynamicResolution::scale_size(glm::u32vec2 size, float scale) noexcept
+	{
+		const glm::vec2 scaled = glm::round(glm::vec2(size) * scale);
+		return glm::max(glm::u32vec2(scaled), glm::u32vec2(1));
+	}
+}
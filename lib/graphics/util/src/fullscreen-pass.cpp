@@ -271,7 +271,8 @@ namespace graphics
 		SDL_GPUTexture* target_texture,
 		std::optional<std::span<const SDL_GPUTextureSamplerBinding>> samplers,
 		std::optional<std::span<SDL_GPUTexture* const>> storage_textures,
-		std::optional<std::span<SDL_GPUBuffer* const>> storage_buffers
+		std::optional<std::span<SDL_GPUBuffer* const>> storage_buffers,
+		std::optional<glm::u32vec2> region
 	) const noexcept
 	{
 		const auto color_target_info = std::to_array<SDL_GPUColorTargetInfo>({
@@ -298,6 +299,7 @@ namespace graphics
 			color_target_info,
 			std::nullopt,
 			[&, this](const gpu::RenderPass& render_pass) {
+				if (region.has_value()) render_pass.set_region(region->x, region->y);
 				base_pass.render_to_renderpass(render_pass, samplers, storage_textures, storage_buffers);
 			}
 		);
@@ -42,11 +42,13 @@ namespace graphics
 		auto transfer_buffer = gpu::TransferBuffer::create_from_data(device, image.pixels);
 		if (!transfer_buffer) return transfer_buffer.error().forward("Create transfer buffer failed");
 
+		// Zero pitch means tightly packed, which also covers block-compressed images whose size is not a
+		// multiple of the block size
 		const SDL_GPUTextureTransferInfo transfer_info{
 			.transfer_buffer = *transfer_buffer,
 			.offset = 0,
-			.pixels_per_row = image.size.x,
-			.rows_per_layer = image.size.y
+			.pixels_per_row = 0,
+			.rows_per_layer = 0
 		};
 
 		const SDL_GPUTextureRegion texture_region{
@@ -96,15 +98,14 @@ namespace graphics
 			if (!buffer) return buffer.error().forward("Create transfer buffer failed");
 
 		const auto transfer_infos =
-			mipmap_chain
-			| std::views::enumerate
-			| std::views::transform([&](const auto& indexed_image) {
-				  const auto& [mip_level, image] = indexed_image;
+			transfer_buffers
+			| std::views::transform([](const auto& transfer_buffer) {
+				  // Tightly packed, see `create_texture_from_image_internal`
 				  return SDL_GPUTextureTransferInfo{
-					  .transfer_buffer = *transfer_buffers[mip_level],
+					  .transfer_buffer = *transfer_buffer,
 					  .offset = 0,
-					  .pixels_per_row = image.size.x,
-					  .rows_per_layer = image.size.y
+					  .pixels_per_row = 0,
+					  .rows_per_layer = 0
 				  };
 			  })
 			| std::ranges::to<std::vector>();
@@ -0,0 +1,458 @@
+#include "graphics/util/render-graph.hpp"
+
+#include <algorithm>
+#include <format>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <ranges>
+
+namespace graphics
+{
+	namespace
+	{
+		constexpr uint32_t no_pass = UINT32_MAX;
+
+		std::string escape(const std::string& name) noexcept
+		{
+			std::string result;
+			result.reserve(name.size());
+
+			for (const char c : name)
+			{
+				if (c == '"' || c == '\\') result.push_back('\\');
+				result.push_back(c);
+			}
+
+			return result;
+		}
+	}
+
+	bool RenderGraph::TextureDesc::compatible_with(const TextureDesc& other) const noexcept
+	{
+		return format.type == other.format.type
+			&& format.format == other.format.format
+			&& size == other.size
+			&& layers == other.layers
+			&& mip_levels == other.mip_levels;
+	}
+
+	RenderGraph::TextureDesc RenderGraph::TextureDesc::merged_with(const TextureDesc& other) const noexcept
+	{
+		TextureDesc merged = *this;
+		auto& usage = merged.format.usage;
+		const auto& other_usage = other.format.usage;
+
+		usage.sampler = usage.sampler || other_usage.sampler;
+		usage.color_target = usage.color_target || other_usage.color_target;
+		usage.depth_stencil_target = usage.depth_stencil_target || other_usage.depth_stencil_target;
+		usage.graphic_storage_read = usage.graphic_storage_read || other_usage.graphic_storage_read;
+		usage.compute_storage_read = usage.compute_storage_read || other_usage.compute_storage_read;
+		usage.compute_storage_write = usage.compute_storage_write || other_usage.compute_storage_write;
+		usage.compute_storage_simultaneous_read_write =
+			usage.compute_storage_simultaneous_read_write
+			|| other_usage.compute_storage_simultaneous_read_write;
+
+		return merged;
+	}
+
+	uint64_t RenderGraph::TextureDesc::get_bytes() const noexcept
+	{
+		return format.get_size(size.x, size.y, layers, mip_levels);
+	}
+
+	bool RenderGraph::BufferDesc::compatible_with(const BufferDesc& other) const noexcept
+	{
+		return usage == other.usage && size == other.size;
+	}
+
+	void RenderGraph::PassBuilder::read(Handle handle) noexcept
+	{
+		graph.passes[pass].reads.push_back(handle);
+	}
+
+	RenderGraph::Handle RenderGraph::PassBuilder::write(Handle handle) noexcept
+	{
+		if (!handle.is_valid() || handle.resource >= graph.resources.size())
+		{
+			if (graph.declaration_error.empty())
+				graph.declaration_error =
+					std::format("Pass '{}' writes an invalid handle", graph.passes[pass].name);
+			return {};
+		}
+
+		auto& resource = graph.resources[handle.resource];
+
+		// Writing an older version would fork the content of the resource
+		if (handle.version + 1 != resource.version_count && graph.declaration_error.empty())
+			graph.declaration_error = std::format(
+				"Pass '{}' writes version {} of '{}', latest is {}",
+				graph.passes[pass].name,
+				handle.version,
+				resource.name,
+				resource.version_count - 1
+			);
+
+		const Handle written = {.resource = handle.resource, .version = resource.version_count++};
+		graph.passes[pass].writes.push_back(written);
+
+		return written;
+	}
+
+	void RenderGraph::PassBuilder::side_effect() noexcept
+	{
+		graph.passes[pass].side_effect = true;
+	}
+
+	RenderGraph::Handle RenderGraph::create_texture(std::string name, const TextureDesc& desc) noexcept
+	{
+		resources.push_back({.name = std::move(name), .desc = desc, .imported = false, .preserve = false});
+		return {.resource = uint32_t(resources.size() - 1), .version = 0};
+	}
+
+	RenderGraph::Handle RenderGraph::create_buffer(std::string name, const BufferDesc& desc) noexcept
+	{
+		resources.push_back({.name = std::move(name), .desc = desc, .imported = false, .preserve = false});
+		return {.resource = uint32_t(resources.size() - 1), .version = 0};
+	}
+
+	RenderGraph::Handle RenderGraph::import_texture(
+		std::string name,
+		const TextureDesc& desc,
+		bool preserve
+	) noexcept
+	{
+		resources.push_back({.name = std::move(name), .desc = desc, .imported = true, .preserve = preserve});
+		return {.resource = uint32_t(resources.size() - 1), .version = 0};
+	}
+
+	RenderGraph::Handle RenderGraph::import_buffer(
+		std::string name,
+		const BufferDesc& desc,
+		bool preserve
+	) noexcept
+	{
+		resources.push_back({.name = std::move(name), .desc = desc, .imported = true, .preserve = preserve});
+		return {.resource = uint32_t(resources.size() - 1), .version = 0};
+	}
+
+	RenderGraph::PassBuilder RenderGraph::add_pass(std::string name, Execute execute) noexcept
+	{
+		passes.push_back({.name = std::move(name), .execute = std::move(execute), .reads = {}, .writes = {}});
+		return {*this, uint32_t(passes.size() - 1)};
+	}
+
+	std::expected<RenderGraph::Compiled, util::Error> RenderGraph::compile() const noexcept
+	{
+		if (!declaration_error.empty()) return util::Error(declaration_error);
+
+		/* Versions */
+
+		// Versions of every resource are flattened, starting at `version_base[resource]`
+		std::vector<uint32_t> version_base(resources.size() + 1, 0);
+		for (const auto [idx, resource] : resources | std::views::enumerate)
+			version_base[idx + 1] = version_base[idx] + resource.version_count;
+
+		const auto flat = [&version_base](Handle handle) {
+			return version_base[handle.resource] + handle.version;
+		};
+
+		std::vector<uint32_t> writer(version_base.back(), no_pass);
+		std::vector<std::vector<uint32_t>> readers(version_base.back());
+
+		for (const auto [pass_idx, pass] : passes | std::views::enumerate)
+		{
+			for (const auto& handle : pass.writes) writer[flat(handle)] = uint32_t(pass_idx);
+
+			for (const auto& handle : pass.reads)
+			{
+				if (!handle.is_valid()
+					|| handle.resource >= resources.size()
+					|| handle.version >= resources[handle.resource].version_count)
+					return util::Error(std::format("Pass '{}' reads an invalid handle", pass.name));
+
+				readers[flat(handle)].push_back(uint32_t(pass_idx));
+			}
+		}
+
+		for (const auto [pass_idx, pass] : passes | std::views::enumerate)
+			for (const auto& handle : pass.reads)
+			{
+				const auto& resource = resources[handle.resource];
+				if (!resource.imported && writer[flat(handle)] == no_pass)
+					return util::Error(
+						std::format("Pass '{}' reads '{}' before it is written", pass.name, resource.name)
+					);
+			}
+
+		// Passes producing what a pass consumes, writers of its reads and of the versions it overwrites
+		const auto for_each_producer = [&](const Pass& pass, const auto& func) {
+			for (const auto& handle : pass.reads)
+				if (const auto producer = writer[flat(handle)]; producer != no_pass) func(producer);
+
+			for (const auto& handle : pass.writes)
+				if (const auto producer = writer[flat(handle) - 1]; producer != no_pass) func(producer);
+		};
+
+		/* Culling */
+
+		std::vector<uint8_t> kept(passes.size(), 0);
+		std::vector<uint32_t> worklist;
+
+		for (const auto [pass_idx, pass] : passes | std::views::enumerate)
+		{
+			const bool writes_preserved = std::ranges::any_of(pass.writes, [this](Handle handle) {
+				return resources[handle.resource].preserve;
+			});
+
+			if (pass.side_effect || writes_preserved)
+			{
+				kept[pass_idx] = 1;
+				worklist.push_back(uint32_t(pass_idx));
+			}
+		}
+
+		while (!worklist.empty())
+		{
+			const auto pass_idx = worklist.back();
+			worklist.pop_back();
+
+			for_each_producer(passes[pass_idx], [&](uint32_t producer) {
+				if (kept[producer] != 0) return;
+				kept[producer] = 1;
+				worklist.push_back(producer);
+			});
+		}
+
+		/* Ordering */
+
+		std::vector<std::vector<uint32_t>> successors(passes.size());
+		std::vector<uint32_t> in_degree(passes.size(), 0);
+
+		const auto add_edge = [&](uint32_t from, uint32_t to) {
+			if (from == to || kept[from] == 0 || kept[to] == 0) return;
+			successors[from].push_back(to);
+			in_degree[to]++;
+		};
+
+		for (const auto [pass_idx, pass] : passes | std::views::enumerate)
+		{
+			if (kept[pass_idx] == 0) continue;
+
+			// Read after write, and write after write
+			for_each_producer(pass, [&](uint32_t producer) { add_edge(producer, uint32_t(pass_idx)); });
+
+			// Write after read: readers of the overwritten version run first
+			for (const auto& handle : pass.writes)
+				for (const auto reader : readers[flat(handle) - 1]) add_edge(reader, uint32_t(pass_idx));
+		}
+
+		// Kahn's algorithm, ready passes are taken in declaration order
+		std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<>> ready;
+		for (const auto pass_idx : std::views::iota(0u, uint32_t(passes.size())))
+			if (kept[pass_idx] != 0 && in_degree[pass_idx] == 0) ready.push(pass_idx);
+
+		Compiled compiled;
+
+		while (!ready.empty())
+		{
+			const auto pass_idx = ready.top();
+			ready.pop();
+			compiled.order.push_back(pass_idx);
+
+			for (const auto successor : successors[pass_idx])
+				if (--in_degree[successor] == 0) ready.push(successor);
+		}
+
+		const auto kept_count = uint32_t(std::ranges::count(kept, 1));
+		if (compiled.order.size() != kept_count) return util::Error("Render graph has a dependency cycle");
+
+		compiled.culled.resize(passes.size());
+		std::ranges::transform(kept, compiled.culled.begin(), [](uint8_t k) { return uint8_t(k == 0); });
+
+		/* Lifetimes */
+
+		compiled.lifetimes.resize(resources.size());
+
+		for (const auto [position, pass_idx] : compiled.order | std::views::enumerate)
+		{
+			const auto& pass = passes[pass_idx];
+
+			const auto use = [&compiled, position](Handle handle) {
+				auto& lifetime = compiled.lifetimes[handle.resource];
+				lifetime.first = std::min(lifetime.first, uint32_t(position));
+				lifetime.last = std::max(lifetime.last, uint32_t(position));
+			};
+
+			std::ranges::for_each(pass.reads, use);
+			std::ranges::for_each(pass.writes, use);
+		}
+
+		/* Aliasing */
+
+		using Desc = std::variant<TextureDesc, BufferDesc>;
+
+		const auto compatible = [](const Desc& a, const Desc& b) {
+			if (a.index() != b.index()) return false;
+
+			if (const auto* texture = std::get_if<TextureDesc>(&a))
+				return texture->compatible_with(std::get<TextureDesc>(b));
+			return std::get<BufferDesc>(a).compatible_with(std::get<BufferDesc>(b));
+		};
+
+		const auto get_bytes = [](const Desc& desc) -> uint64_t {
+			if (const auto* texture = std::get_if<TextureDesc>(&desc)) return texture->get_bytes();
+			return std::get<BufferDesc>(desc).size;
+		};
+
+		std::vector<uint32_t> transients;
+		for (const auto resource_idx : std::views::iota(0u, uint32_t(resources.size())))
+			if (!resources[resource_idx].imported && compiled.lifetimes[resource_idx].first != UINT32_MAX)
+				transients.push_back(resource_idx);
+
+		std::ranges::stable_sort(transients, {}, [&compiled](uint32_t resource) {
+			return compiled.lifetimes[resource].first;
+		});
+
+		// Per allocation, last position in use
+		std::vector<uint32_t> allocation_last;
+		compiled.allocation.assign(resources.size(), no_allocation);
+
+		// Taking resources by first use, any free compatible allocation keeps the allocation count minimal
+		for (const auto resource_idx : transients)
+		{
+			const auto& lifetime = compiled.lifetimes[resource_idx];
+			const auto& desc = resources[resource_idx].desc;
+
+			uint32_t allocation_idx = 0;
+			while (allocation_idx < compiled.allocations.size()
+				   && (allocation_last[allocation_idx] >= lifetime.first
+					   || !compatible(compiled.allocations[allocation_idx], desc)))
+				allocation_idx++;
+
+			if (allocation_idx == compiled.allocations.size())
+			{
+				compiled.allocations.push_back(desc);
+				allocation_last.push_back(lifetime.last);
+			}
+			else
+			{
+				auto& allocation_desc = compiled.allocations[allocation_idx];
+				if (auto* texture = std::get_if<TextureDesc>(&allocation_desc))
+					*texture = texture->merged_with(std::get<TextureDesc>(desc));
+
+				allocation_last[allocation_idx] = lifetime.last;
+			}
+
+			compiled.allocation[resource_idx] = allocation_idx;
+		}
+
+		compiled.stats = {
+			.passes = kept_count,
+			.culled_passes = uint32_t(passes.size()) - kept_count,
+			.transient_resources = uint32_t(transients.size()),
+			.allocations = uint32_t(compiled.allocations.size()),
+			.transient_bytes = std::transform_reduce(
+				transients.begin(),
+				transients.end(),
+				uint64_t(0),
+				std::plus{},
+				[this, &get_bytes](uint32_t resource) { return get_bytes(resources[resource].desc); }
+			),
+			.allocated_bytes = std::transform_reduce(
+				compiled.allocations.begin(),
+				compiled.allocations.end(),
+				uint64_t(0),
+				std::plus{},
+				get_bytes
+			)
+		};
+
+		return compiled;
+	}
+
+	std::expected<void, util::Error> RenderGraph::execute(const Compiled& compiled) const noexcept
+	{
+		for (const auto pass_idx : compiled.order)
+		{
+			const auto& pass = passes[pass_idx];
+			if (!pass.execute) continue;
+
+			if (const auto result = pass.execute(); !result)
+				return result.error().forward(std::format("Execute pass '{}' failed", pass.name));
+		}
+
+		return {};
+	}
+
+	std::string RenderGraph::to_graphviz(const Compiled& compiled) const noexcept
+	{
+		std::string dot = "digraph RenderGraph {\n\trankdir=LR;\n\tnode [fontname=\"Helvetica\"];\n";
+
+		std::vector<uint32_t> position(passes.size(), no_pass);
+		for (const auto [pos, pass_idx] : compiled.order | std::views::enumerate)
+			position[pass_idx] = uint32_t(pos);
+
+		for (const auto [pass_idx, pass] : passes | std::views::enumerate)
+		{
+			if (position[pass_idx] == no_pass)
+				dot += std::format(
+					"\tp{} [shape=box, style=dashed, color=gray, label=\"{} (culled)\"];\n",
+					pass_idx,
+					escape(pass.name)
+				);
+			else
+				dot += std::format(
+					"\tp{} [shape=box, label=\"{}: {}\"];\n",
+					pass_idx,
+					position[pass_idx],
+					escape(pass.name)
+				);
+		}
+
+		for (const auto [resource_idx, resource] : resources | std::views::enumerate)
+		{
+			std::string label = escape(resource.name);
+
+			if (const auto* texture = std::get_if<TextureDesc>(&resource.desc))
+				label += std::format("\\n{}x{}", texture->size.x, texture->size.y);
+			else
+				label += std::format("\\n{} bytes", std::get<BufferDesc>(resource.desc).size);
+
+			if (compiled.allocation[resource_idx] != no_allocation)
+				label += std::format("\\nallocation #{}", compiled.allocation[resource_idx]);
+
+			const bool unused = compiled.lifetimes[resource_idx].first == UINT32_MAX;
+
+			dot += std::format(
+				"\tr{} [shape=ellipse, peripheries={}{}, label=\"{}\"];\n",
+				resource_idx,
+				resource.imported ? 2 : 1,
+				unused ? ", style=dashed, color=gray" : "",
+				label
+			);
+		}
+
+		for (const auto [pass_idx, pass] : passes | std::views::enumerate)
+		{
+			for (const auto& handle : pass.reads)
+				dot += std::format(
+					"\tr{} -> p{} [label=\"v{}\"];\n",
+					handle.resource,
+					pass_idx,
+					handle.version
+				);
+
+			for (const auto& handle : pass.writes)
+				dot += std::format(
+					"\tp{} -> r{} [label=\"v{}\"];\n",
+					pass_idx,
+					handle.resource,
+					handle.version
+				);
+		}
+
+		dot += "}\n";
+		return dot;
+	}
+}
@@ -73,14 +73,20 @@ namespace graphics
 	std::expected<void, util::Error> RenderpassCopy::copy(
 		const gpu::CommandBuffer& command_buffer,
 		SDL_GPUTexture* src,
-		SDL_GPUTexture* dst
+		SDL_GPUTexture* dst,
+		std::optional<glm::u32vec2> region
 	) const noexcept
 	{
 		command_buffer.push_debug_group("Copy texture via Renderpass_copy");
 		const SDL_GPUTextureSamplerBinding sampler_binding{.texture = src, .sampler = sampler};
-		auto result =
-			copy_pass
-				.render(command_buffer, dst, std::to_array({sampler_binding}), std::nullopt, std::nullopt);
+		auto result = copy_pass.render(
+			command_buffer,
+			dst,
+			std::to_array({sampler_binding}),
+			std::nullopt,
+			std::nullopt,
+			region
+		);
 		command_buffer.pop_debug_group();
 		return result;
 	}
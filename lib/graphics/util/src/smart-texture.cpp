@@ -12,16 +12,24 @@ namespace graphics
 
 	std::expected<void, util::Error> AutoTexture::resize(
 		SDL_GPUDevice* device,
-		glm::u32vec2 new_size
+		glm::u32vec2 new_size,
+		TexturePool* pool
 	) noexcept
 	{
 		if (texture != nullptr && size == new_size) return {};
 		if (new_size.x == 0 || new_size.y == 0) return util::Error("Invalid texture size");
 		if (!format.supported_on(device)) return util::Error("Texture format not supported on device");
 
+		if (texture != nullptr && pool != nullptr)
+		{
+			pool->release(std::move(*texture), format, size, mip_levels);
+			texture.reset();
+		}
+
 		size = new_size;
-		auto create_texture_result =
-			gpu::Texture::create(device, format.create(size.x, size.y, 1, mip_levels), name);
+		auto create_texture_result = pool != nullptr
+			? pool->acquire(format, size, mip_levels, name)
+			: gpu::Texture::create(device, format.create(size.x, size.y, 1, mip_levels), name);
 		if (!create_texture_result) return create_texture_result.error().forward("Resize failed");
 
 		texture = std::make_unique<gpu::Texture>(std::move(create_texture_result.value()));
@@ -42,7 +50,8 @@ namespace graphics
 
 	std::expected<void, util::Error> CycleTexture::resize_and_cycle(
 		SDL_GPUDevice* device,
-		glm::u32vec2 new_size
+		glm::u32vec2 new_size,
+		TexturePool* pool
 	) noexcept
 	{
 		if (new_size == size && !texture_pool.empty())
@@ -57,16 +66,18 @@ namespace graphics
 		if (new_size.x == 0 || new_size.y == 0) return util::Error("Invalid texture size");
 		if (!format.supported_on(device)) return util::Error("Texture format not supported on device");
 
+		if (pool != nullptr)
+			for (auto& texture : texture_pool) pool->release(std::move(*texture), format, size, mip_levels);
+
 		texture_pool.clear();
 		size = new_size;
 
 		for (const auto idx : std::views::iota(0zu, extra_pool_size + 2))
 		{
-			auto create_texture_result = gpu::Texture::create(
-				device,
-				format.create(size.x, size.y, 1, mip_levels),
-				std::format("{} [Index {}]", name, idx)
-			);
+			const auto texture_name = std::format("{} [Index {}]", name, idx);
+			auto create_texture_result = pool != nullptr
+				? pool->acquire(format, size, mip_levels, texture_name)
+				: gpu::Texture::create(device, format.create(size.x, size.y, 1, mip_levels), texture_name);
 			if (!create_texture_result)
 				return create_texture_result.error().forward("Create new texture failed");
 
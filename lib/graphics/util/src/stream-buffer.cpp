@@ -0,0 +1,61 @@
+#include "graphics/util/stream-buffer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+namespace graphics
+{
+	std::expected<void, util::Error> StreamBuffer::update(
+		SDL_GPUDevice* device,
+		std::span<const std::byte> data
+	) noexcept
+	{
+		if (data.size() > UINT32_MAX / 2) return util::Error("Stream buffer data too large");
+
+		const auto data_size = uint32_t(data.size());
+
+		if (buffer == nullptr || data_size > capacity)
+		{
+			const uint32_t new_capacity = std::max(std::bit_ceil(data_size), min_capacity);
+
+			auto buffer_result = gpu::Buffer::create(device, usage, new_capacity, name);
+			if (!buffer_result) return buffer_result.error().forward("Create stream buffer failed");
+
+			auto upload_buffer_result =
+				gpu::TransferBuffer::create(device, gpu::TransferBuffer::Usage::Upload, new_capacity);
+			if (!upload_buffer_result)
+				return upload_buffer_result.error().forward("Create stream transfer buffer failed");
+
+			buffer = std::make_unique<gpu::Buffer>(std::move(*buffer_result));
+			upload_buffer = std::make_unique<gpu::TransferBuffer>(std::move(*upload_buffer_result));
+			capacity = new_capacity;
+		}
+
+		size = data_size;
+		if (size == 0) return {};
+
+		const auto transfer_result = upload_buffer->transfer(
+			[data](void* mapped_ptr) { std::memcpy(mapped_ptr, data.data(), data.size()); },
+			true
+		);
+		if (!transfer_result) return transfer_result.error().forward("Copy stream data failed");
+
+		return {};
+	}
+
+	void StreamBuffer::upload(const gpu::CopyPass& copy_pass) const noexcept
+	{
+		if (size == 0) return;
+
+		assert(buffer != nullptr && upload_buffer != nullptr);
+		copy_pass.upload_to_buffer(*upload_buffer, 0, *buffer, 0, size, true);
+	}
+
+	const gpu::Buffer& StreamBuffer::operator*() const noexcept
+	{
+		assert(buffer != nullptr && "Stream buffer not initialized. Call update() first.");
+		return *buffer;
+	}
+}
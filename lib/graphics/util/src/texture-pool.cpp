@@ -0,0 +1,59 @@
+#include "graphics/util/texture-pool.hpp"
+
+namespace graphics
+{
+	std::expected<gpu::Texture, util::Error> TextureDevice::create(
+		const gpu::Texture::Format& format,
+		glm::u32vec2 size,
+		uint32_t mip_levels,
+		const std::string& name
+	) const noexcept
+	{
+		return gpu::Texture::create(device, format.create(size.x, size.y, 1, mip_levels), name);
+	}
+
+	void TextureDevice::set_name(const gpu::Texture& texture, const std::string& name) const noexcept
+	{
+		SDL_SetGPUTextureName(device, texture, name.c_str());
+	}
+
+	bool TextureDevice::is_empty(const gpu::Texture& texture) noexcept
+	{
+		return static_cast<SDL_GPUTexture*>(texture) == nullptr;
+	}
+
+	void TextureDevice::release(
+		gpu::DeletionQueue& deletion_queue,
+		gpu::Texture texture,
+		uint64_t bytes
+	) noexcept
+	{
+		deletion_queue.release(std::move(texture), bytes);
+	}
+
+	glm::u32vec2 ResizeHysteresis::update(glm::u32vec2 requested) noexcept
+	{
+		if (committed == glm::u32vec2(0) || requested == committed)
+		{
+			committed = requested;
+			pending_frames = 0;
+			return committed;
+		}
+
+		if (pending_frames == 0 || requested != pending)
+		{
+			pending = requested;
+			pending_frames = 0;
+		}
+
+		pending_frames++;
+
+		if (pending_frames >= stable_frames)
+		{
+			committed = requested;
+			pending_frames = 0;
+		}
+
+		return committed;
+	}
+}
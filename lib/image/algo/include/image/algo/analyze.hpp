@@ -0,0 +1,52 @@
+///
+/// @file analyze.hpp
+/// @brief Provides functions to analyze image content and measure image quality
+///
+
+#pragma once
+
+#include "image/repr.hpp"
+#include "util/error.hpp"
+
+#include <expected>
+
+namespace image
+{
+	///
+	/// @brief Channel statistics of an RGBA8 image
+	///
+	struct ChannelAnalysis
+	{
+		glm::u8vec4 min_value = glm::u8vec4(255);  // Per-channel minimum
+		glm::u8vec4 max_value = glm::u8vec4(0);    // Per-channel maximum
+		bool grayscale = true;                     // R, G and B are equal on every pixel
+
+		// Whether each channel holds a single value across the image, i.e. carries no information
+		glm::bvec4 constant() const noexcept { return glm::equal(min_value, max_value); }
+
+		// Whether alpha is 255 on every pixel
+		bool opaque() const noexcept { return min_value.a == 255; }
+	};
+
+	///
+	/// @brief Scan an RGBA8 image for channel ranges and grayscale content
+	///
+	/// @param image Input image
+	/// @return Channel analysis
+	///
+	ChannelAnalysis analyze_channels(const Image<Precision::U8, Format::RGBA>& image) noexcept;
+
+	///
+	/// @brief Compute PSNR between two RGBA8 images over selected channels
+	///
+	/// @param reference Reference image
+	/// @param test Image to measure
+	/// @param channels Channels to include
+	/// @return PSNR in dB, infinity if identical; or error if sizes mismatch or no channel is selected
+	///
+	std::expected<float, util::Error> compute_psnr(
+		const Image<Precision::U8, Format::RGBA>& reference,
+		const Image<Precision::U8, Format::RGBA>& test,
+		glm::bvec4 channels
+	) noexcept;
+}
@@ -0,0 +1,175 @@
+///
+/// @file downsample.hpp
+/// @brief Provides downsampling kernels for images: SIMD 2x2 box filter, and polyphase filter for odd sizes
+///
+
+#pragma once
+
+#include "image/repr.hpp"
+
+#include <array>
+#include <concepts>
+#include <limits>
+
+namespace image
+{
+	///
+	/// @brief Pixel types with a specialized downsample kernel
+	/// @details U8, U16 and F32 components, with 1 to 4 channels
+	///
+	template <typename T>
+	concept Downsample_pixel = detail::GLM_type<T>
+		&& (std::same_as<typename T::value_type, uint8_t>
+			|| std::same_as<typename T::value_type, uint16_t>
+			|| std::same_as<typename T::value_type, float>)
+		&& (sizeof(T) / sizeof(typename T::value_type) <= 4);
+
+	///
+	/// @brief Shrink the image to half size by averaging 2x2 pixel blocks, using SIMD kernels
+	/// @details
+	/// - Output is bit-exact with `ImageContainer::shrink_half`, including rounding and the size of
+	/// odd-dimension images (`floor(size / 2)`, last row/column dropped).
+	/// - 1/2/4-channel images use SSE2 kernels (AVX2 when available); 3-channel images and row tails
+	/// use a tight scalar loop.
+	///
+	/// @note Instantiated for all `Downsample_pixel` types in downsample.cpp
+	///
+	/// @tparam T Pixel Type
+	/// @param image Input image
+	/// @return Shrunk Image
+	///
+	template <Downsample_pixel T>
+	ImageContainer<T> downsample_half(const ImageContainer<T>& image) noexcept;
+
+	///
+	/// @brief Shrink an RGBA8 image to half size, converting to YCbCrA on the fly
+	/// @details Equivalent to converting every pixel with `colorspace::rgba_to_ycbcr_alpha(pixel / 255)`
+	/// and then calling `shrink_half`, without materializing the full-size float image.
+	///
+	/// @param image Input RGBA8 image
+	/// @return Shrunk YCbCrA image
+	///
+	ImageContainer<glm::vec4> downsample_half_to_ycbcr(const Image<Precision::U8, Format::RGBA>& image
+	) noexcept;
+
+	///
+	/// @brief Get size of the next mip level
+	/// @details Each dimension becomes `max(floor(size / 2), 1)`, matching how GPUs size mip levels
+	///
+	/// @param size Size of current level
+	/// @return Size of next level
+	///
+	inline glm::u32vec2 next_mip_size(glm::u32vec2 size) noexcept
+	{
+		return glm::max(size / 2u, glm::u32vec2(1));
+	}
+
+	///
+	/// @brief Filter taps of one output sample when halving a dimension
+	///
+	struct PolyphaseTaps
+	{
+		uint32_t first;                // Index of the first source sample
+		uint32_t count;                // Number of taps, 1 to 3
+		std::array<float, 3> weights;  // Weight of each tap, sums to one
+	};
+
+	///
+	/// @brief Compute filter taps for halving a dimension
+	/// @details
+	/// - Even sizes use a 2-tap box filter.
+	/// - Odd sizes `2n + 1` use a 3-tap polyphase filter, output `i` reads source samples `2i` to `2i + 2`
+	/// with weights `(n - i, n, i + 1) / (2n + 1)`, so every source sample contributes equally.
+	/// - A size of 1 passes through.
+	///
+	/// @param src_size Source dimension size
+	/// @return Taps for each of the `max(src_size / 2, 1)` output samples
+	///
+	std::vector<PolyphaseTaps> polyphase_taps(uint32_t src_size) noexcept;
+
+	///
+	/// @brief Shrink the image to the next mip level size with a separable polyphase filter
+	/// @details Works for any size, see `polyphase_taps`. Integer components are rounded to nearest.
+	/// @note Slower than `downsample_half`, prefer `downsample_mip_level` which picks the right kernel.
+	///
+	/// @tparam T Pixel Type
+	/// @param image Input image
+	/// @return Shrunk image, sized `next_mip_size(image.size)`
+	///
+	template <typename T>
+		requires detail::GLM_type<T>
+	ImageContainer<T> downsample_half_polyphase(const ImageContainer<T>& image) noexcept
+	{
+		using Comp = typename T::value_type;
+		constexpr glm::length_t len = sizeof(T) / sizeof(Comp);
+		using Float_t = glm::vec<len, float>;
+
+		const glm::u32vec2 new_size = next_mip_size(image.size);
+		const auto taps_x = polyphase_taps(image.size.x);
+		const auto taps_y = polyphase_taps(image.size.y);
+
+		// Horizontal pass, new_size.x * image.size.y
+		std::vector<Float_t> horizontal(size_t(new_size.x) * image.size.y);
+		for (const auto [y, x] : std::views::cartesian_product(
+				 std::views::iota(0u, image.size.y),
+				 std::views::iota(0u, new_size.x)
+			 ))
+		{
+			const auto& taps = taps_x[x];
+
+			Float_t sum(0.0f);
+			for (const uint32_t tap : std::views::iota(0u, taps.count))
+				sum += Float_t(image[taps.first + tap, y]) * taps.weights[tap];
+
+			horizontal[size_t(y) * new_size.x + x] = sum;
+		}
+
+		// Vertical pass
+		ImageContainer<T> result{
+			.size = new_size,
+			.pixels = std::vector<T>(size_t(new_size.x) * new_size.y)
+		};
+
+		for (const auto [y, x] : std::views::cartesian_product(
+				 std::views::iota(0u, new_size.y),
+				 std::views::iota(0u, new_size.x)
+			 ))
+		{
+			const auto& taps = taps_y[y];
+
+			Float_t sum(0.0f);
+			for (const uint32_t tap : std::views::iota(0u, taps.count))
+				sum += horizontal[size_t(taps.first + tap) * new_size.x + x] * taps.weights[tap];
+
+			if constexpr (std::is_integral_v<Comp>)
+			{
+				constexpr auto max_value = float(std::numeric_limits<Comp>::max());
+				result[x, y] = T(glm::clamp(glm::round(sum), Float_t(0.0f), Float_t(max_value)));
+			}
+			else
+				result[x, y] = T(sum);
+		}
+
+		return result;
+	}
+
+	///
+	/// @brief Shrink the image to the next mip level, for any image size
+	/// @details Uses the 2x2 box filter when both dimensions are even, otherwise the polyphase filter.
+	///
+	/// @tparam T Pixel Type
+	/// @param image Input image
+	/// @return Shrunk image, sized `next_mip_size(image.size)`
+	///
+	template <typename T>
+		requires detail::GLM_type<T>
+	ImageContainer<T> downsample_mip_level(const ImageContainer<T>& image) noexcept
+	{
+		if (image.size.x % 2 != 0 || image.size.y % 2 != 0) return downsample_half_polyphase(image);
+
+		if constexpr (Downsample_pixel<T>)
+			return downsample_half(image);
+		else
+			return image.shrink_half();
+	}
+}
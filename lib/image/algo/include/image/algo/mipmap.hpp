@@ -5,12 +5,15 @@
 
 #pragma once
 
+#include "image/algo/downsample.hpp"
 #include "image/repr.hpp"
 
 namespace image
 {
 	///
 	/// @brief Calculate number of mipmap levels for given image size and minimum size
+	/// @details Works for any size. Each level is sized `next_mip_size` of the previous one, the chain ends
+	/// at 1x1 or before any dimension drops below `min_size`.
 	///
 	/// @param size Image Size
 	/// @param min_size Minimum Image Size
@@ -33,6 +36,7 @@ namespace image
 
 	///
 	/// @brief Generate mipmap chain from base image
+	/// @details Supports any size, odd dimensions are filtered with the polyphase filter
 	///
 	/// @tparam T Pixel Type
 	/// @param base_image Base Image
@@ -50,7 +54,7 @@ namespace image
 		std::vector<ImageContainer<T>> mipmap_chain(levels);
 		mipmap_chain[0] = base_image;
 
-		for (auto [in, out] : mipmap_chain | std::views::adjacent<2>) out = in.shrink_half();
+		for (auto [in, out] : mipmap_chain | std::views::adjacent<2>) out = downsample_mip_level(in);
 
 		return mipmap_chain;
 	}
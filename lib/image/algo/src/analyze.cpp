@@ -0,0 +1,56 @@
+#include "image/algo/analyze.hpp"
+
+#include <cmath>
+#include <format>
+#include <limits>
+
+namespace image
+{
+	ChannelAnalysis analyze_channels(const Image<Precision::U8, Format::RGBA>& image) noexcept
+	{
+		ChannelAnalysis analysis;
+
+		for (const auto& pixel : image.pixels)
+		{
+			analysis.min_value = glm::min(analysis.min_value, pixel);
+			analysis.max_value = glm::max(analysis.max_value, pixel);
+			analysis.grayscale = analysis.grayscale && pixel.r == pixel.g && pixel.g == pixel.b;
+		}
+
+		return analysis;
+	}
+
+	std::expected<float, util::Error> compute_psnr(
+		const Image<Precision::U8, Format::RGBA>& reference,
+		const Image<Precision::U8, Format::RGBA>& test,
+		glm::bvec4 channels
+	) noexcept
+	{
+		if (reference.size != test.size || reference.pixels.size() != test.pixels.size())
+			return util::Error(
+				std::format(
+					"Image size mismatch: {}x{} vs {}x{}",
+					reference.size.x,
+					reference.size.y,
+					test.size.x,
+					test.size.y
+				)
+			);
+
+		const glm::dvec4 mask(channels);
+		const double channel_count = mask.r + mask.g + mask.b + mask.a;
+		if (channel_count == 0 || reference.pixels.empty()) return util::Error("No sample to compare");
+
+		double squared_error = 0.0;
+		for (const auto [ref_pixel, test_pixel] : std::views::zip(reference.pixels, test.pixels))
+		{
+			const glm::dvec4 diff = (glm::dvec4(ref_pixel) - glm::dvec4(test_pixel)) * mask;
+			squared_error += glm::dot(diff, diff);
+		}
+
+		const double mse = squared_error / (channel_count * double(reference.pixels.size()));
+		if (mse == 0.0) return std::numeric_limits<float>::infinity();
+
+		return float(10.0 * std::log10(255.0 * 255.0 / mse));
+	}
+}
@@ -0,0 +1,524 @@
+#include "image/algo/downsample.hpp"
+#include "image/algo/colorspace.hpp"
+
+#include <immintrin.h>
+
+namespace image
+{
+	namespace
+	{
+		/* Scalar */
+
+		// Scalar kernel for output pixels [begin, end) of one row, same arithmetic as `shrink_half`
+		template <typename Comp, size_t N>
+		void downsample_row_scalar(
+			const Comp* row0,
+			const Comp* row1,
+			Comp* dst,
+			size_t begin,
+			size_t end
+		) noexcept
+		{
+			using Widened_comp = typename detail::ComponentWiden<Comp>::type;
+
+			for (size_t x = begin; x < end; ++x)
+				for (size_t c = 0; c < N; ++c)
+				{
+					const size_t i = x * 2 * N + c;
+					dst[x * N + c] = Comp(
+						(Widened_comp(row0[i])
+						 + Widened_comp(row0[i + N])
+						 + Widened_comp(row1[i])
+						 + Widened_comp(row1[i + N]))
+						/ Widened_comp(4)
+					);
+				}
+		}
+
+		/* U8 */
+
+		// Reduce 16 bytes of each row into 8 u16 output components: (a + b + c + d) >> 2
+		template <size_t N>
+		__m128i reduce_u8(__m128i r0, __m128i r1) noexcept;
+
+		template <int Imm>
+		__m128i shuffle_epi32x2(__m128i a, __m128i b) noexcept
+		{
+			return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), Imm));
+		}
+
+		template <>
+		__m128i reduce_u8<1>(__m128i r0, __m128i r1) noexcept
+		{
+			// Even and odd bytes zero-extend into u16 lanes directly
+			const __m128i mask = _mm_set1_epi16(0x00FF);
+			const __m128i sum0 = _mm_add_epi16(_mm_and_si128(r0, mask), _mm_srli_epi16(r0, 8));
+			const __m128i sum1 = _mm_add_epi16(_mm_and_si128(r1, mask), _mm_srli_epi16(r1, 8));
+			return _mm_srli_epi16(_mm_add_epi16(sum0, sum1), 2);
+		}
+
+		template <>
+		__m128i reduce_u8<2>(__m128i r0, __m128i r1) noexcept
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero));
+			const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero));
+			const __m128i even = shuffle_epi32x2<_MM_SHUFFLE(2, 0, 2, 0)>(lo, hi);
+			const __m128i odd = shuffle_epi32x2<_MM_SHUFFLE(3, 1, 3, 1)>(lo, hi);
+			return _mm_srli_epi16(_mm_add_epi16(even, odd), 2);
+		}
+
+		template <>
+		__m128i reduce_u8<4>(__m128i r0, __m128i r1) noexcept
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero));
+			const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero));
+			const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+			return _mm_srli_epi16(sum, 2);
+		}
+
+#ifdef __AVX2__
+		// AVX2 version of `reduce_u8`, operates on each 128-bit lane independently
+		template <size_t N>
+		__m256i reduce_u8_avx2(__m256i r0, __m256i r1) noexcept;
+
+		template <>
+		__m256i reduce_u8_avx2<1>(__m256i r0, __m256i r1) noexcept
+		{
+			const __m256i mask = _mm256_set1_epi16(0x00FF);
+			const __m256i sum0 = _mm256_add_epi16(_mm256_and_si256(r0, mask), _mm256_srli_epi16(r0, 8));
+			const __m256i sum1 = _mm256_add_epi16(_mm256_and_si256(r1, mask), _mm256_srli_epi16(r1, 8));
+			return _mm256_srli_epi16(_mm256_add_epi16(sum0, sum1), 2);
+		}
+
+		template <>
+		__m256i reduce_u8_avx2<2>(__m256i r0, __m256i r1) noexcept
+		{
+			const __m256i zero = _mm256_setzero_si256();
+			const __m256i lo =
+				_mm256_add_epi16(_mm256_unpacklo_epi8(r0, zero), _mm256_unpacklo_epi8(r1, zero));
+			const __m256i hi =
+				_mm256_add_epi16(_mm256_unpackhi_epi8(r0, zero), _mm256_unpackhi_epi8(r1, zero));
+			const __m256i even = _mm256_castps_si256(_mm256_shuffle_ps(
+				_mm256_castsi256_ps(lo),
+				_mm256_castsi256_ps(hi),
+				_MM_SHUFFLE(2, 0, 2, 0)
+			));
+			const __m256i odd = _mm256_castps_si256(_mm256_shuffle_ps(
+				_mm256_castsi256_ps(lo),
+				_mm256_castsi256_ps(hi),
+				_MM_SHUFFLE(3, 1, 3, 1)
+			));
+			return _mm256_srli_epi16(_mm256_add_epi16(even, odd), 2);
+		}
+
+		template <>
+		__m256i reduce_u8_avx2<4>(__m256i r0, __m256i r1) noexcept
+		{
+			const __m256i zero = _mm256_setzero_si256();
+			const __m256i lo =
+				_mm256_add_epi16(_mm256_unpacklo_epi8(r0, zero), _mm256_unpacklo_epi8(r1, zero));
+			const __m256i hi =
+				_mm256_add_epi16(_mm256_unpackhi_epi8(r0, zero), _mm256_unpackhi_epi8(r1, zero));
+			const __m256i sum =
+				_mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), _mm256_unpackhi_epi64(lo, hi));
+			return _mm256_srli_epi16(sum, 2);
+		}
+#endif
+
+		// Returns number of output pixels processed
+		template <size_t N>
+		size_t downsample_row_u8(
+			const uint8_t* row0,
+			const uint8_t* row1,
+			uint8_t* dst,
+			size_t width
+		) noexcept
+		{
+			// Each iteration consumes 32 bytes per row and produces 16 bytes
+			constexpr size_t step = 16 / N;
+			size_t x = 0;
+
+#ifdef __AVX2__
+			for (; x + step * 2 <= width; x += step * 2)
+			{
+				const uint8_t* src0 = row0 + x * 2 * N;
+				const uint8_t* src1 = row1 + x * 2 * N;
+
+				const __m256i a = reduce_u8_avx2<N>(
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src0)),
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src1))
+				);
+				const __m256i b = reduce_u8_avx2<N>(
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src0 + 32)),
+					_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src1 + 32))
+				);
+
+				// Pack works per 128-bit lane, restore order afterwards
+				const __m256i packed =
+					_mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * N), packed);
+			}
+#endif
+
+			for (; x + step <= width; x += step)
+			{
+				const uint8_t* src0 = row0 + x * 2 * N;
+				const uint8_t* src1 = row1 + x * 2 * N;
+
+				const __m128i a = reduce_u8<N>(
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(src0)),
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(src1))
+				);
+				const __m128i b = reduce_u8<N>(
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(src0 + 16)),
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(src1 + 16))
+				);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * N), _mm_packus_epi16(a, b));
+			}
+
+			return x;
+		}
+
+		/* U16 */
+
+		// Reduce 8 u16 of each row into 4 u32 output components: (a + b + c + d) >> 2
+		template <size_t N>
+		__m128i reduce_u16(__m128i r0, __m128i r1) noexcept;
+
+		template <>
+		__m128i reduce_u16<1>(__m128i r0, __m128i r1) noexcept
+		{
+			const __m128i mask = _mm_set1_epi32(0x0000FFFF);
+			const __m128i sum0 = _mm_add_epi32(_mm_and_si128(r0, mask), _mm_srli_epi32(r0, 16));
+			const __m128i sum1 = _mm_add_epi32(_mm_and_si128(r1, mask), _mm_srli_epi32(r1, 16));
+			return _mm_srli_epi32(_mm_add_epi32(sum0, sum1), 2);
+		}
+
+		template <>
+		__m128i reduce_u16<2>(__m128i r0, __m128i r1) noexcept
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i lo = _mm_add_epi32(_mm_unpacklo_epi16(r0, zero), _mm_unpacklo_epi16(r1, zero));
+			const __m128i hi = _mm_add_epi32(_mm_unpackhi_epi16(r0, zero), _mm_unpackhi_epi16(r1, zero));
+			const __m128i sum = _mm_add_epi32(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+			return _mm_srli_epi32(sum, 2);
+		}
+
+		template <>
+		__m128i reduce_u16<4>(__m128i r0, __m128i r1) noexcept
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i lo = _mm_add_epi32(_mm_unpacklo_epi16(r0, zero), _mm_unpacklo_epi16(r1, zero));
+			const __m128i hi = _mm_add_epi32(_mm_unpackhi_epi16(r0, zero), _mm_unpackhi_epi16(r1, zero));
+			return _mm_srli_epi32(_mm_add_epi32(lo, hi), 2);
+		}
+
+		// Pack u32 values in [0, 65535] into u16, SSE2 only has signed saturation for 32-bit lanes
+		__m128i pack_u32_to_u16(__m128i a, __m128i b) noexcept
+		{
+			const __m128i bias32 = _mm_set1_epi32(0x8000);
+			const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+			const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(a, bias32), _mm_sub_epi32(b, bias32));
+			return _mm_xor_si128(packed, bias16);
+		}
+
+		// Returns number of output pixels processed
+		template <size_t N>
+		size_t downsample_row_u16(
+			const uint16_t* row0,
+			const uint16_t* row1,
+			uint16_t* dst,
+			size_t width
+		) noexcept
+		{
+			// Each iteration consumes 16 components per row and produces 8
+			constexpr size_t step = 8 / N;
+			size_t x = 0;
+
+			for (; x + step <= width; x += step)
+			{
+				const uint16_t* src0 = row0 + x * 2 * N;
+				const uint16_t* src1 = row1 + x * 2 * N;
+
+				const __m128i a = reduce_u16<N>(
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(src0)),
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(src1))
+				);
+				const __m128i b = reduce_u16<N>(
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(src0 + 8)),
+					_mm_loadu_si128(reinterpret_cast<const __m128i*>(src1 + 8))
+				);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * N), pack_u32_to_u16(a, b));
+			}
+
+			return x;
+		}
+
+		/* F32 */
+
+		// Average of a 2x2 quad, keeps the `((a + b) + c) + d` order of `shrink_half` so results are
+		// bit-exact. Multiplying by 0.25 is exact, and identical to dividing by 4.
+		FORCE_INLINE __m128 average_quad(__m128 a, __m128 b, __m128 c, __m128 d) noexcept
+		{
+			return _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(a, b), c), d), _mm_set1_ps(0.25f));
+		}
+
+		// Returns number of output pixels processed
+		template <size_t N>
+		size_t downsample_row_f32(const float* row0, const float* row1, float* dst, size_t width) noexcept
+		{
+			// Each iteration consumes 8 floats per row and produces 4
+			constexpr size_t step = 4 / N;
+			size_t x = 0;
+
+#ifdef __AVX2__
+			if constexpr (N == 4)
+			{
+				const __m256 quarter = _mm256_set1_ps(0.25f);
+
+				for (; x + 2 <= width; x += 2)
+				{
+					const float* src0 = row0 + x * 8;
+					const float* src1 = row1 + x * 8;
+
+					const __m256 r00 = _mm256_loadu_ps(src0), r01 = _mm256_loadu_ps(src0 + 8);
+					const __m256 r10 = _mm256_loadu_ps(src1), r11 = _mm256_loadu_ps(src1 + 8);
+
+					const __m256 a = _mm256_permute2f128_ps(r00, r01, 0x20);
+					const __m256 b = _mm256_permute2f128_ps(r00, r01, 0x31);
+					const __m256 c = _mm256_permute2f128_ps(r10, r11, 0x20);
+					const __m256 d = _mm256_permute2f128_ps(r10, r11, 0x31);
+
+					const __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(a, b), c), d);
+					_mm256_storeu_ps(dst + x * 4, _mm256_mul_ps(sum, quarter));
+				}
+			}
+#endif
+
+			for (; x + step <= width; x += step)
+			{
+				const float* src0 = row0 + x * 2 * N;
+				const float* src1 = row1 + x * 2 * N;
+
+				const __m128 r00 = _mm_loadu_ps(src0), r01 = _mm_loadu_ps(src0 + 4);
+				const __m128 r10 = _mm_loadu_ps(src1), r11 = _mm_loadu_ps(src1 + 4);
+
+				__m128 result;
+
+				if constexpr (N == 1)
+					result = average_quad(
+						_mm_shuffle_ps(r00, r01, _MM_SHUFFLE(2, 0, 2, 0)),
+						_mm_shuffle_ps(r00, r01, _MM_SHUFFLE(3, 1, 3, 1)),
+						_mm_shuffle_ps(r10, r11, _MM_SHUFFLE(2, 0, 2, 0)),
+						_mm_shuffle_ps(r10, r11, _MM_SHUFFLE(3, 1, 3, 1))
+					);
+				else if constexpr (N == 2)
+					result = average_quad(
+						_mm_shuffle_ps(r00, r01, _MM_SHUFFLE(1, 0, 1, 0)),
+						_mm_shuffle_ps(r00, r01, _MM_SHUFFLE(3, 2, 3, 2)),
+						_mm_shuffle_ps(r10, r11, _MM_SHUFFLE(1, 0, 1, 0)),
+						_mm_shuffle_ps(r10, r11, _MM_SHUFFLE(3, 2, 3, 2))
+					);
+				else
+					result = average_quad(r00, r01, r10, r11);
+
+				_mm_storeu_ps(dst + x * N, result);
+			}
+
+			return x;
+		}
+
+		// Returns number of output pixels processed by SIMD kernels, the remaining are left to scalar kernel
+		template <typename Comp, size_t N>
+		size_t downsample_row_simd(const Comp* row0, const Comp* row1, Comp* dst, size_t width) noexcept
+		{
+			// Interleaved 3-channel pixels don't map onto register lanes, leave them to the scalar kernel
+			if constexpr (N == 3)
+				return 0;
+			else if constexpr (std::same_as<Comp, uint8_t>)
+				return downsample_row_u8<N>(row0, row1, dst, width);
+			else if constexpr (std::same_as<Comp, uint16_t>)
+				return downsample_row_u16<N>(row0, row1, dst, width);
+			else
+				return downsample_row_f32<N>(row0, row1, dst, width);
+		}
+
+		/* RGBA8 -> YCbCrA */
+
+		// 4 pixels in planar form
+		struct PlanarX4
+		{
+			__m128 c0, c1, c2, c3;
+		};
+
+		// Convert 4 RGBA8 pixels to planar YCbCrA, same arithmetic as
+		// `colorspace::rgba_to_ycbcr_alpha(glm::vec4(pixel) / 255.0f)`
+		PlanarX4 rgba8_to_ycbcr_x4(const glm::u8vec4* pixels) noexcept
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+			const __m128i lo = _mm_unpacklo_epi8(raw, zero);
+			const __m128i hi = _mm_unpackhi_epi8(raw, zero);
+
+			const __m128 denom = _mm_set1_ps(255.0f);
+			// Each holds one RGBA pixel, becomes planar R/G/B/A after transposing
+			__m128 r = _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), denom);
+			__m128 g = _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), denom);
+			__m128 b = _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), denom);
+			__m128 a = _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), denom);
+			_MM_TRANSPOSE4_PS(r, g, b, a);
+
+			// Same evaluation order as glm's `mat3 * vec3`
+			const auto& m = colorspace::rgb_to_ycbcr_matrix;
+			const auto matrix_row = [&](int row, float offset) {
+				const __m128 x = _mm_mul_ps(_mm_set1_ps(m[0][row]), r);
+				const __m128 y = _mm_mul_ps(_mm_set1_ps(m[1][row]), g);
+				const __m128 z = _mm_mul_ps(_mm_set1_ps(m[2][row]), b);
+				return _mm_add_ps(_mm_add_ps(_mm_add_ps(x, y), z), _mm_set1_ps(offset));
+			};
+
+			return {.c0 = matrix_row(0, 0.0f), .c1 = matrix_row(1, 0.5f), .c2 = matrix_row(2, 0.5f), .c3 = a};
+		}
+
+		// Average horizontal pairs of `top` and `bottom`, output in lane 0 and 1
+		FORCE_INLINE __m128 average_quad_planar(__m128 top, __m128 bottom) noexcept
+		{
+			return average_quad(
+				_mm_shuffle_ps(top, top, _MM_SHUFFLE(2, 0, 2, 0)),
+				_mm_shuffle_ps(top, top, _MM_SHUFFLE(3, 1, 3, 1)),
+				_mm_shuffle_ps(bottom, bottom, _MM_SHUFFLE(2, 0, 2, 0)),
+				_mm_shuffle_ps(bottom, bottom, _MM_SHUFFLE(3, 1, 3, 1))
+			);
+		}
+
+		glm::vec4 rgba8_to_ycbcr(const glm::u8vec4& pixel) noexcept
+		{
+			return colorspace::rgba_to_ycbcr_alpha(glm::vec4(pixel) / 255.0f);
+		}
+	}
+
+	template <Downsample_pixel T>
+	ImageContainer<T> downsample_half(const ImageContainer<T>& image) noexcept
+	{
+		using Comp = typename T::value_type;
+		constexpr size_t channels = sizeof(T) / sizeof(Comp);
+
+		const glm::u32vec2 new_size = image.size / 2u;
+		ImageContainer<T> result{
+			.size = new_size,
+			.pixels = std::vector<T>(size_t(new_size.x) * new_size.y)
+		};
+
+		const auto* const src = reinterpret_cast<const Comp*>(image.pixels.data());
+		auto* const dst = reinterpret_cast<Comp*>(result.pixels.data());
+		const size_t src_stride = size_t(image.size.x) * channels;
+		const size_t dst_stride = size_t(new_size.x) * channels;
+
+		for (const size_t y : std::views::iota(0zu, size_t(new_size.y)))
+		{
+			const Comp* row0 = src + (y * 2) * src_stride;
+			const Comp* row1 = row0 + src_stride;
+			Comp* out = dst + y * dst_stride;
+
+			const size_t simd_end = downsample_row_simd<Comp, channels>(row0, row1, out, new_size.x);
+			downsample_row_scalar<Comp, channels>(row0, row1, out, simd_end, new_size.x);
+		}
+
+		return result;
+	}
+
+	std::vector<PolyphaseTaps> polyphase_taps(uint32_t src_size) noexcept
+	{
+		if (src_size <= 1) return {PolyphaseTaps{.first = 0, .count = 1, .weights = {1.0f, 0.0f, 0.0f}}};
+
+		const uint32_t dst_size = src_size / 2;
+
+		if (src_size % 2 == 0)
+			return std::views::iota(0u, dst_size)
+				| std::views::transform([](uint32_t i) {
+					   return PolyphaseTaps{.first = i * 2, .count = 2, .weights = {0.5f, 0.5f, 0.0f}};
+				   })
+				| std::ranges::to<std::vector>();
+
+		const auto n = float(dst_size);
+		const auto denom = float(src_size);
+
+		return std::views::iota(0u, dst_size)
+			| std::views::transform([n, denom](uint32_t i) {
+				   return PolyphaseTaps{
+					   .first = i * 2,
+					   .count = 3,
+					   .weights = {(n - float(i)) / denom, n / denom, (float(i) + 1.0f) / denom}
+				   };
+			   })
+			| std::ranges::to<std::vector>();
+	}
+
+	ImageContainer<glm::vec4> downsample_half_to_ycbcr(const Image<Precision::U8, Format::RGBA>& image
+	) noexcept
+	{
+		const glm::u32vec2 new_size = image.size / 2u;
+		ImageContainer<glm::vec4> result{
+			.size = new_size,
+			.pixels = std::vector<glm::vec4>(size_t(new_size.x) * new_size.y)
+		};
+
+		for (const size_t y : std::views::iota(0zu, size_t(new_size.y)))
+		{
+			const glm::u8vec4* row0 = image.pixels.data() + (y * 2) * image.size.x;
+			const glm::u8vec4* row1 = row0 + image.size.x;
+			glm::vec4* out = result.pixels.data() + y * new_size.x;
+
+			size_t x = 0;
+
+			// 4 input pixels per row -> 2 output pixels
+			for (; x + 2 <= new_size.x; x += 2)
+			{
+				const auto top = rgba8_to_ycbcr_x4(row0 + x * 2);
+				const auto bottom = rgba8_to_ycbcr_x4(row1 + x * 2);
+
+				__m128 p0 = average_quad_planar(top.c0, bottom.c0);
+				__m128 p1 = average_quad_planar(top.c1, bottom.c1);
+				__m128 p2 = average_quad_planar(top.c2, bottom.c2);
+				__m128 p3 = average_quad_planar(top.c3, bottom.c3);
+				_MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+				_mm_storeu_ps(&out[x].x, p0);
+				_mm_storeu_ps(&out[x + 1].x, p1);
+			}
+
+			for (; x < new_size.x; ++x)
+				out[x] = (rgba8_to_ycbcr(row0[x * 2 + 0])
+						  + rgba8_to_ycbcr(row0[x * 2 + 1])
+						  + rgba8_to_ycbcr(row1[x * 2 + 0])
+						  + rgba8_to_ycbcr(row1[x * 2 + 1]))
+					/ 4.0f;
+		}
+
+		return result;
+	}
+
+#define INSTANTIATE_DOWNSAMPLE(Comp)                                                                         \
+	template ImageContainer<glm::vec<1, Comp>> downsample_half(                                              \
+		const ImageContainer<glm::vec<1, Comp>>&                                                             \
+	) noexcept;                                                                                              \
+	template ImageContainer<glm::vec<2, Comp>> downsample_half(                                              \
+		const ImageContainer<glm::vec<2, Comp>>&                                                             \
+	) noexcept;                                                                                              \
+	template ImageContainer<glm::vec<3, Comp>> downsample_half(                                              \
+		const ImageContainer<glm::vec<3, Comp>>&                                                             \
+	) noexcept;                                                                                              \
+	template ImageContainer<glm::vec<4, Comp>> downsample_half(                                              \
+		const ImageContainer<glm::vec<4, Comp>>&                                                             \
+	) noexcept;
+
+	INSTANTIATE_DOWNSAMPLE(uint8_t)
+	INSTANTIATE_DOWNSAMPLE(uint16_t)
+	INSTANTIATE_DOWNSAMPLE(float)
+
+#undef INSTANTIATE_DOWNSAMPLE
+}
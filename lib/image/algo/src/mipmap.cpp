@@ -1,5 +1,6 @@
 #include "image/algo/mipmap.hpp"
 #include "image/algo/colorspace.hpp"
+#include "image/algo/downsample.hpp"
 
 #include <ranges>
 
@@ -9,10 +10,12 @@ namespace image
 	{
 		if (size.x < min_size.x || size.y < min_size.y) return 1;
 
-		for (size_t level = 0;; ++level)
+		for (size_t level = 1;; ++level)
 		{
-			size = glm::floor(glm::vec2(size) / 2.0f);
-			if (size.x < min_size.x || size.y < min_size.y) return level + 1;
+			if (size == glm::u32vec2(1)) return level;
+
+			size = next_mip_size(size);
+			if (size.x < min_size.x || size.y < min_size.y) return level;
 		}
 	}
 
@@ -21,27 +24,41 @@ namespace image
 		glm::u32vec2 min_size
 	) noexcept
 	{
+		const auto to_rgba8 = [](const glm::vec4& pixel) {
+			return glm::u8vec4(
+				glm::clamp(
+					colorspace::ycbcr_alpha_to_rgba(pixel) * 255.0f,
+					glm::vec4(0.0f),
+					glm::vec4(255.0f)
+				)
+			);
+		};
+
 		const size_t levels = calc_mipmap_levels(base_image.size, min_size);
 
-		std::vector<ImageContainer<glm::vec4>> mipmap_chain(levels);
-		mipmap_chain[0] = base_image.map([](const glm::u8vec4& pixel) {
-			return colorspace::rgba_to_ycbcr_alpha(glm::vec4(pixel) / 255.0f);
-		});
-
-		for (auto [in, out] : mipmap_chain | std::views::adjacent<2>) out = in.shrink_half();
-
-		return mipmap_chain
-			| std::views::transform([](const auto& image) {
-				   return image.map([](const glm::vec4& pixel) {
-					   return glm::u8vec4(
-						   glm::clamp(
-							   colorspace::ycbcr_alpha_to_rgba(pixel) * 255.0f,
-							   glm::vec4(0.0f),
-							   glm::vec4(255.0f)
-						   )
-					   );
-				   });
-			   })
-			| std::ranges::to<std::vector<Image<Precision::U8, Format::RGBA>>>();
+		std::vector<Image<Precision::U8, Format::RGBA>> mipmap_chain;
+		mipmap_chain.reserve(levels);
+
+		// Base level round-trips through YCbCr per pixel, no full-size float copy is made
+		mipmap_chain.push_back(base_image.map([&to_rgba8](const glm::u8vec4& pixel) {
+			return to_rgba8(colorspace::rgba_to_ycbcr_alpha(glm::vec4(pixel) / 255.0f));
+		}));
+		if (levels == 1) return mipmap_chain;
+
+		// Lower levels are filtered in YCbCr, only the previous level is kept in float
+		auto ycbcr_level = (base_image.size.x % 2 == 0 && base_image.size.y % 2 == 0)
+			? downsample_half_to_ycbcr(base_image)
+			: downsample_half_polyphase(base_image.map([](const glm::u8vec4& pixel) {
+				  return colorspace::rgba_to_ycbcr_alpha(glm::vec4(pixel) / 255.0f);
+			  }));
+		mipmap_chain.push_back(ycbcr_level.map(to_rgba8));
+
+		for (size_t level = 2; level < levels; ++level)
+		{
+			ycbcr_level = downsample_mip_level(ycbcr_level);
+			mipmap_chain.push_back(ycbcr_level.map(to_rgba8));
+		}
+
+		return mipmap_chain;
 	}
 }
\ No newline at end of file
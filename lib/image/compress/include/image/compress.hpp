@@ -19,23 +19,63 @@ namespace image
 		std::array<uint8_t, 16> block;
 	};
 
+	///
+	/// @brief BC block for 4 bits per pixel formats (BC1, BC4)
+	///
+	struct CompressionBlock4bpp
+	{
+		std::array<uint8_t, 8> block;
+	};
+
+	///
+	/// @brief Block compressed image
+	/// @note `size` holds the size in pixels, `pixels` holds `ceil(size / 4)` blocks
+	///
 	using BCImage = ImageContainer<CompressionBlock>;
 
+	///
+	/// @brief Block compressed image with 4 bits per pixel, see `BCImage`
+	///
+	using BCImage4bpp = ImageContainer<CompressionBlock4bpp>;
+
+	///
+	/// @brief Compress a raw image into BC1 format, alpha channel is discarded
+	///
+	/// @param src_image Source image in RGBA8 format. Sizes not a multiple of 4x4 are padded by
+	/// replicating edge pixels.
+	/// @return Compressed BC1 image, or error on failure
+	///
+	std::expected<BCImage4bpp, util::Error> compress_to_bc1(
+		const Image<Precision::U8, Format::RGBA>& src_image
+	) noexcept;
+
 	///
 	/// @brief Compress a raw image into BC3 format
 	///
-	/// @param src_image Source image in RGBA8 format. Size must be a multiple of 4x4.
+	/// @param src_image Source image in RGBA8 format. Sizes not a multiple of 4x4 are padded by
+	/// replicating edge pixels.
 	/// @return Compressed BC3 image, or error on failure
 	///
 	std::expected<BCImage, util::Error> compress_to_bc3(
 		const Image<Precision::U8, Format::RGBA>& src_image
 	) noexcept;
 
+	///
+	/// @brief Compress a raw image into BC4 format
+	///
+	/// @param src_image Source image in RGBA8 format. Sizes not a multiple of 4x4 are padded by
+	/// replicating edge pixels. Only R channel is preserved and compressed
+	/// @return Compressed BC4 image, or error on failure
+	///
+	std::expected<BCImage4bpp, util::Error> compress_to_bc4(
+		const Image<Precision::U8, Format::RGBA>& src_image
+	) noexcept;
+
 	///
 	/// @brief Compress a raw image into BC5 format.
 	///
-	/// @param src_image Source image in RGBA8 format. Size must be a multiple of 4x4. Only R and G channels
-	/// are preserved and compressed
+	/// @param src_image Source image in RGBA8 format. Sizes not a multiple of 4x4 are padded by
+	/// replicating edge pixels. Only R and G channels are preserved and compressed
 	/// @return Compressed BC5 image, or error on failure
 	///
 	std::expected<BCImage, util::Error> compress_to_bc5(
@@ -45,13 +85,52 @@ namespace image
 	///
 	/// @brief Compress a raw image into BC7 format
 	///
-	/// @param src_image Source image in RGBA8 format. Size must be a multiple of 4x4.
+	/// @param src_image Source image in RGBA8 format. Sizes not a multiple of 4x4 are padded by
+	/// replicating edge pixels.
 	/// @return Compressed BC7 image, or error on failure
 	///
 	std::expected<BCImage, util::Error> compress_to_bc7(
 		const Image<Precision::U8, Format::RGBA>& src_image
 	) noexcept;
 
+	///
+	/// @brief Decode a BC1 image back to RGBA8, for quality checks
+	///
+	/// @param src_image BC1 image
+	/// @return Decoded image, alpha is always 255; or error if block count mismatches image size
+	///
+	std::expected<Image<Precision::U8, Format::RGBA>, util::Error> decode_bc1(const BCImage4bpp& src_image
+	) noexcept;
+
+	///
+	/// @brief Decode a BC3 image back to RGBA8, for quality checks
+	///
+	/// @param src_image BC3 image
+	/// @return Decoded image, or error if block count mismatches image size
+	///
+	std::expected<Image<Precision::U8, Format::RGBA>, util::Error> decode_bc3(const BCImage& src_image
+	) noexcept;
+
+	///
+	/// @brief Decode a BC4 image back to RGBA8, for quality checks
+	///
+	/// @param src_image BC4 image
+	/// @return Decoded image with data in R, as sampled on GPU: `(r, 0, 0, 255)`; or error if block count
+	/// mismatches image size
+	///
+	std::expected<Image<Precision::U8, Format::RGBA>, util::Error> decode_bc4(const BCImage4bpp& src_image
+	) noexcept;
+
+	///
+	/// @brief Decode a BC5 image back to RGBA8, for quality checks
+	///
+	/// @param src_image BC5 image
+	/// @return Decoded image with data in RG, as sampled on GPU: `(r, g, 0, 255)`; or error if block count
+	/// mismatches image size
+	///
+	std::expected<Image<Precision::U8, Format::RGBA>, util::Error> decode_bc5(const BCImage& src_image
+	) noexcept;
+
 	///
 	/// @brief Mipmap compressing funtor
 	///
@@ -11,7 +11,7 @@ namespace image
 	using RGBA_pixel_type = Pixel_t<Precision::U8, Format::RGBA>;
 	using Block_pixel_array_8bpp = std::array<std::array<RGBA_pixel_type, 4>, 4>;
 
-	// Extract a 4x4 block from source image
+	// Extract a 4x4 block from source image, pixels outside the image replicate the nearest edge pixel
 	static Block_pixel_array_8bpp extract_block(
 		const ImageContainer<RGBA_pixel_type>& src,
 		uint32_t block_x,
@@ -20,26 +20,41 @@ namespace image
 	{
 		Block_pixel_array_8bpp block_pixels;
 
+		const uint32_t x0 = block_x * 4, y0 = block_y * 4;
+
+		// Fast path, block fully inside the image
+		if (x0 + 4 <= src.size.x && y0 + 4 <= src.size.y)
+		{
+			for (const auto [idx, row] : std::views::enumerate(block_pixels))
+				std::ranges::copy(std::span(&src[x0, y0 + idx], 4), row.begin());
+
+			return block_pixels;
+		}
+
 		for (const auto [idx, row] : std::views::enumerate(block_pixels))
-			std::ranges::copy(std::span(&src[block_x * 4, block_y * 4 + idx], 4), row.begin());
+		{
+			const uint32_t y = std::min(y0 + uint32_t(idx), src.size.y - 1);
+			for (const auto [col, pixel] : std::views::enumerate(row))
+				pixel = src[std::min(x0 + uint32_t(col), src.size.x - 1), y];
+		}
 
 		return block_pixels;
 	}
 
 	// Iterate over all 4x4 blocks in the source
-	template <typename Func>
-		requires(std::invocable<Func, const Block_pixel_array_8bpp&, CompressionBlock&>)
+	template <typename Block, typename Func>
+		requires(std::invocable<Func, const Block_pixel_array_8bpp&, Block&>)
 	static void iterate_over_blocks(
 		const ImageContainer<RGBA_pixel_type>& src,
-		ImageContainer<CompressionBlock>& dst,
+		ImageContainer<Block>& dst,
 		Func&& compress_block_func
 	) noexcept
 	{
 		for (const auto [output, block_coord] : std::views::zip(
 				 dst.pixels,
 				 std::views::cartesian_product(
-					 std::views::iota(0u, src.size.y / 4),
-					 std::views::iota(0u, src.size.x / 4)
+					 std::views::iota(0u, (src.size.y + 3) / 4),
+					 std::views::iota(0u, (src.size.x + 3) / 4)
 				 )
 			 ))
 		{
@@ -51,23 +66,102 @@ namespace image
 	}
 
 	// Generate destination image container
-	static std::expected<BCImage, util::Error> generate_dst_image(
+	template <typename Block = CompressionBlock>
+	static std::expected<ImageContainer<Block>, util::Error> generate_dst_image(
 		const ImageContainer<RGBA_pixel_type>& src
 	) noexcept
 	{
-		if (src.size.x % 4 != 0 || src.size.y % 4 != 0)
-			return util::Error(
-				std::format("Source image size {}x{} is not a multiple of 4x4", src.size.x, src.size.y)
-			);
+		if (src.size.x == 0 || src.size.y == 0)
+			return util::Error(std::format("Source image size {}x{} is empty", src.size.x, src.size.y));
 
 		if (uint64_t(src.size.x) * uint64_t(src.size.y) > (1ull << 32))
 			return util::Error(std::format("Source image size {}x{} is too large", src.size.x, src.size.y));
 
-		BCImage dst_image{
+		ImageContainer<Block> dst_image{
+			.size = src.size,
+			.pixels = std::vector<Block>(((src.size.x + 3) / 4) * ((src.size.y + 3) / 4))
+		};
+
+		return dst_image;
+	}
+
+	// Decode all 4x4 blocks of a BC image, padded pixels are dropped
+	template <typename Block, typename Func>
+		requires(std::invocable<Func, const Block&, Block_pixel_array_8bpp&>)
+	static std::expected<Image<Precision::U8, Format::RGBA>, util::Error> decode_blocks(
+		const ImageContainer<Block>& src,
+		Func&& decode_block_func
+	) noexcept
+	{
+		const glm::u32vec2 block_count = (src.size + 3u) / 4u;
+		if (src.pixels.size() != size_t(block_count.x) * block_count.y)
+			return util::Error(
+				std::format(
+					"Block count {} mismatches image size {}x{}",
+					src.pixels.size(),
+					src.size.x,
+					src.size.y
+				)
+			);
+
+		Image<Precision::U8, Format::RGBA> dst_image{
 			.size = src.size,
-			.pixels = std::vector<CompressionBlock>((src.size.x / 4) * (src.size.y / 4))
+			.pixels = std::vector<RGBA_pixel_type>(size_t(src.size.x) * src.size.y)
 		};
 
+		for (const auto [block, block_coord] : std::views::zip(
+				 src.pixels,
+				 std::views::cartesian_product(
+					 std::views::iota(0u, block_count.y),
+					 std::views::iota(0u, block_count.x)
+				 )
+			 ))
+		{
+			const auto [block_y, block_x] = block_coord;
+
+			Block_pixel_array_8bpp block_pixels;
+			for (auto& row : block_pixels) row.fill(RGBA_pixel_type(0, 0, 0, 255));
+
+			decode_block_func(block, block_pixels);
+
+			for (const auto [y, x] :
+				 std::views::cartesian_product(std::views::iota(0u, 4u), std::views::iota(0u, 4u)))
+			{
+				const glm::u32vec2 coord(block_x * 4 + x, block_y * 4 + y);
+				if (coord.x < src.size.x && coord.y < src.size.y)
+					dst_image[coord.x, coord.y] = block_pixels[y][x];
+			}
+		}
+
+		return dst_image;
+	}
+
+	std::expected<BCImage4bpp, util::Error> compress_to_bc1(
+		const Image<Precision::U8, Format::RGBA>& src_image
+	) noexcept
+	{
+		static std::once_flag rgbcx_init_flag;
+
+		auto dst_image = generate_dst_image<CompressionBlock4bpp>(src_image);
+		if (!dst_image) return dst_image.error();
+
+		std::call_once(rgbcx_init_flag, [] { rgbcx::init(); });
+
+		iterate_over_blocks(
+			src_image,
+			*dst_image,
+			[](const Block_pixel_array_8bpp& block_pixels, CompressionBlock4bpp& output) {
+				// 3-color blocks decode black texels as transparent, which breaks opaque sampling
+				rgbcx::encode_bc1(
+					10,
+					reinterpret_cast<uint8_t*>(output.block.data()),
+					reinterpret_cast<const uint8_t*>(block_pixels.data()),
+					false,
+					false
+				);
+			}
+		);
+
 		return dst_image;
 	}
 
@@ -94,6 +188,27 @@ namespace image
 		return dst_image;
 	}
 
+	std::expected<BCImage4bpp, util::Error> compress_to_bc4(
+		const Image<Precision::U8, Format::RGBA>& src_image
+	) noexcept
+	{
+		auto dst_image = generate_dst_image<CompressionBlock4bpp>(src_image);
+		if (!dst_image) return dst_image.error();
+
+		iterate_over_blocks(
+			src_image,
+			*dst_image,
+			[](const Block_pixel_array_8bpp& block_pixels, CompressionBlock4bpp& output) {
+				rgbcx::encode_bc4(
+					reinterpret_cast<uint8_t*>(output.block.data()),
+					reinterpret_cast<const uint8_t*>(block_pixels.data())
+				);
+			}
+		);
+
+		return dst_image;
+	}
+
 	std::expected<BCImage, util::Error> compress_to_bc5(
 		const Image<Precision::U8, Format::RGBA>& src_image
 	) noexcept
@@ -144,4 +259,48 @@ namespace image
 
 		return dst_image;
 	}
+
+	std::expected<Image<Precision::U8, Format::RGBA>, util::Error> decode_bc1(const BCImage4bpp& src_image
+	) noexcept
+	{
+		return decode_blocks(
+			src_image,
+			[](const CompressionBlock4bpp& block, Block_pixel_array_8bpp& block_pixels) {
+				rgbcx::unpack_bc1(block.block.data(), block_pixels.data(), true);
+			}
+		);
+	}
+
+	std::expected<Image<Precision::U8, Format::RGBA>, util::Error> decode_bc3(const BCImage& src_image
+	) noexcept
+	{
+		return decode_blocks(
+			src_image,
+			[](const CompressionBlock& block, Block_pixel_array_8bpp& block_pixels) {
+				rgbcx::unpack_bc3(block.block.data(), block_pixels.data());
+			}
+		);
+	}
+
+	std::expected<Image<Precision::U8, Format::RGBA>, util::Error> decode_bc4(const BCImage4bpp& src_image
+	) noexcept
+	{
+		return decode_blocks(
+			src_image,
+			[](const CompressionBlock4bpp& block, Block_pixel_array_8bpp& block_pixels) {
+				rgbcx::unpack_bc4(block.block.data(), reinterpret_cast<uint8_t*>(block_pixels.data()));
+			}
+		);
+	}
+
+	std::expected<Image<Precision::U8, Format::RGBA>, util::Error> decode_bc5(const BCImage& src_image
+	) noexcept
+	{
+		return decode_blocks(
+			src_image,
+			[](const CompressionBlock& block, Block_pixel_array_8bpp& block_pixels) {
+				rgbcx::unpack_bc5(block.block.data(), block_pixels.data());
+			}
+		);
+	}
 }
\ No newline at end of file
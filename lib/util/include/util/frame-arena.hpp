@@ -0,0 +1,108 @@
+///
+/// @file frame-arena.hpp
+/// @brief Provides a frame-scoped linear allocator, usable by `std::pmr` containers
+///
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace util
+{
+	///
+	/// @brief Linear allocator whose memory is reclaimed as a whole, a few frames after allocation
+	/// @details
+	/// - Memory is split into `frame_count` slots. `begin_frame` moves to the next slot and releases
+	/// everything allocated in it, so memory of the previous `frame_count - 1` frames stays valid.
+	/// - Allocations bump a pointer, `deallocate` does not reclaim memory.
+	/// - Allocations not fitting the slot fall back to the upstream resource, and are released with the slot.
+	/// - In poison mode, released memory is filled with `poison_byte` to expose use-after-release.
+	/// @warning Not thread-safe. The arena and the resource of a slot must only be used by one thread at
+	/// a time, parallel tasks allocate from their own resource and hand the results over once joined.
+	/// Debug builds assert on concurrent allocations from a slot.
+	///
+	class FrameArena
+	{
+	  public:
+
+		static constexpr std::byte poison_byte{0xCD};
+
+		struct Config
+		{
+			size_t capacity_per_frame = 4 * 1024 * 1024;  // Bytes preallocated per slot
+			uint32_t frame_count = 2;                     // Number of slots, 2 for double buffering
+#ifdef NDEBUG
+			bool poison = false;  // Fill released memory with `poison_byte`
+#else
+			bool poison = true;  // Fill released memory with `poison_byte`
+#endif
+		};
+
+		struct Stats
+		{
+			size_t used_bytes = 0;            // Bytes allocated in the current frame, including overflow
+			size_t overflow_bytes = 0;        // Bytes served by upstream in the current frame
+			size_t overflow_count = 0;        // Allocations served by upstream in the current frame
+			size_t high_water_bytes = 0;      // Largest `used_bytes` of any frame so far
+			size_t overflow_frame_count = 0;  // Number of frames that overflowed so far
+		};
+
+		///
+		/// @brief Create a frame arena with default configuration
+		///
+		FrameArena() noexcept;
+
+		///
+		/// @brief Create a frame arena
+		///
+		/// @param config Arena configuration
+		/// @param upstream Resource for overflow allocations
+		///
+		explicit FrameArena(
+			const Config& config,
+			std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()
+		) noexcept;
+
+		///
+		/// @brief Start a new frame, releasing memory allocated `frame_count` frames ago
+		/// @warning Containers allocated from that frame must have been destroyed or abandoned before.
+		///
+		void begin_frame() noexcept;
+
+		///
+		/// @brief Get the memory resource of the current frame
+		/// @note The pointer stays valid for the life span of the arena, but memory allocated through it is
+		/// only valid for `frame_count` calls to `begin_frame`.
+		///
+		std::pmr::memory_resource* resource() const noexcept;
+
+		///
+		/// @brief Get allocation statistics
+		///
+		/// @return Statistics of the current frame and since creation
+		///
+		Stats get_stats() const noexcept;
+
+	  private:
+
+		class Slot;
+
+		std::vector<std::unique_ptr<Slot>> slots;
+		size_t current_slot = 0;
+
+		size_t high_water_bytes = 0;
+		size_t overflow_frame_count = 0;
+
+	  public:
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena(FrameArena&&) noexcept;
+		FrameArena& operator=(const FrameArena&) = delete;
+		FrameArena& operator=(FrameArena&&) noexcept;
+		~FrameArena() noexcept;
+	};
+}
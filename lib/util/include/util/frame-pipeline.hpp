@@ -0,0 +1,149 @@
+///
+/// @file frame-pipeline.hpp
+/// @brief Provides a two-stage frame pipeline, running one stage of every frame on a worker thread
+///
+
+#pragma once
+
+#include "util/spsc-queue.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <thread>
+
+namespace util
+{
+	///
+	/// @brief Runs a stage of every frame on a worker thread, up to `frames_ahead` frames ahead of the caller
+	/// @details
+	/// - The caller pushes the input of frame N, the worker runs the stage on it while the caller consumes
+	/// the output of frame N - `frames_ahead`, popped in push order
+	/// - Inputs and outputs are handed over through bounded lock-free queues, no frame is dropped
+	/// - With `frames_ahead == 0` the pipeline is serial, `push` runs the stage on the calling thread
+	///
+	/// #### Usage:
+	/// ```cpp
+	/// pipeline.push(std::move(input));
+	/// if (pipeline.get_frames_in_flight() > pipeline.get_frames_ahead()) consume(*pipeline.pop());
+	/// ```
+	///
+	/// @warning `push` and `pop` must be called from the same thread
+	///
+	/// @tparam Input Input of the stage, moved to the worker
+	/// @tparam Output Output of the stage, moved back to the caller
+	///
+	template <typename Input, typename Output>
+	class FramePipeline
+	{
+	  public:
+
+		using Stage = std::move_only_function<Output(Input)>;
+
+		struct Stats
+		{
+			size_t frames = 0;          // Frames pushed
+			size_t consumer_waits = 0;  // `pop` calls that waited for the stage to finish
+		};
+
+		///
+		/// @brief Create a pipeline, starting its worker unless serial
+		///
+		/// @param stage Stage run on every input, on the worker thread
+		/// @param frames_ahead Frames the stage may run ahead of the caller, 0 for serial
+		///
+		FramePipeline(Stage stage, size_t frames_ahead) noexcept :
+			stage(std::move(stage)),
+			frames_ahead(frames_ahead),
+			inputs(frames_ahead + 1),
+			outputs(frames_ahead + 1)
+		{
+			if (frames_ahead > 0) worker = std::jthread([this] { run(); });
+		}
+
+		FramePipeline(const FramePipeline&) = delete;
+		FramePipeline(FramePipeline&&) = delete;
+		FramePipeline& operator=(const FramePipeline&) = delete;
+		FramePipeline& operator=(FramePipeline&&) = delete;
+
+		// Stop the worker once its current frame is done, outputs not popped are discarded
+		~FramePipeline() noexcept
+		{
+			inputs.close();
+			outputs.close();
+		}
+
+		///
+		/// @brief Hand the input of a new frame to the stage
+		/// @warning At most `frames_ahead + 1` frames may be in flight after the call, pop before pushing
+		///
+		/// @param input Input of the frame
+		///
+		void push(Input input) noexcept
+		{
+			assert(frames_in_flight <= frames_ahead && "Frame pipeline full, pop before pushing");
+
+			frames_in_flight++;
+			frames++;
+
+			if (frames_ahead == 0)
+			{
+				outputs.try_push(stage(std::move(input)));
+				return;
+			}
+
+			// Never full, at most `frames_ahead + 1` frames are in flight
+			inputs.try_push(std::move(input));
+		}
+
+		///
+		/// @brief Get the output of the oldest frame in flight, waiting for the stage to finish it
+		///
+		/// @return Output, or `std::nullopt` if no frame is in flight
+		///
+		std::optional<Output> pop() noexcept
+		{
+			if (frames_in_flight == 0) return std::nullopt;
+
+			auto output = outputs.try_pop();
+			if (!output)
+			{
+				consumer_waits++;
+				output = outputs.pop();
+			}
+
+			frames_in_flight--;
+			return output;
+		}
+
+		// Get the count of frames pushed and not yet popped
+		size_t get_frames_in_flight() const noexcept { return frames_in_flight; }
+
+		size_t get_frames_ahead() const noexcept { return frames_ahead; }
+
+		Stats get_stats() const noexcept { return {.frames = frames, .consumer_waits = consumer_waits}; }
+
+	  private:
+
+		Stage stage;
+		const size_t frames_ahead;
+
+		SpscQueue<Input> inputs;
+		SpscQueue<Output> outputs;
+
+		// Accessed by the calling thread only
+		size_t frames_in_flight = 0;
+		size_t frames = 0;
+		size_t consumer_waits = 0;
+
+		// Declared last, joined before the queues are destroyed
+		std::jthread worker;
+
+		void run() noexcept
+		{
+			while (auto input = inputs.pop())
+				if (!outputs.push(stage(std::move(*input)))) return;
+		}
+	};
+}
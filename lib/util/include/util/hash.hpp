@@ -0,0 +1,24 @@
+///
+/// @file hash.hpp
+/// @brief Provides a fast non-cryptographic hash for content deduplication
+///
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace util
+{
+	///
+	/// @brief Hash a byte span with the 64-bit xxHash algorithm (XXH64)
+	/// @details Output matches the reference XXH64 implementation. Chain calls by passing the previous
+	/// hash as `seed` to hash several spans together.
+	///
+	/// @param data Bytes to hash
+	/// @param seed Hash seed
+	/// @return 64-bit hash
+	///
+	uint64_t hash_bytes(std::span<const std::byte> data, uint64_t seed = 0) noexcept;
+}
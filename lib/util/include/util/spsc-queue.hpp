@@ -0,0 +1,156 @@
+///
+/// @file spsc-queue.hpp
+/// @brief Provides a bounded lock-free queue between one producer thread and one consumer thread
+///
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace util
+{
+	///
+	/// @brief Bounded lock-free FIFO queue, for one producer thread and one consumer thread
+	/// @details
+	/// - `try_push` and `try_pop` never block, `push` and `pop` wait on an atomic when full or empty
+	/// - `close` wakes both sides, `push` then fails and `pop` drains the remaining elements
+	/// - Elements are moved in and out, storage is allocated once at creation
+	///
+	/// @tparam T Element type, must be move constructible
+	///
+	template <typename T>
+	class SpscQueue
+	{
+	  public:
+
+		///
+		/// @brief Create an empty queue
+		///
+		/// @param capacity Maximum element count, at least 1
+		///
+		explicit SpscQueue(size_t capacity) noexcept :
+			capacity(std::max(capacity, 1zu)),
+			slots(std::make_unique<std::optional<T>[]>(this->capacity))
+		{}
+
+		SpscQueue(const SpscQueue&) = delete;
+		SpscQueue(SpscQueue&&) = delete;
+		SpscQueue& operator=(const SpscQueue&) = delete;
+		SpscQueue& operator=(SpscQueue&&) = delete;
+
+		///
+		/// @brief Push an element if there is room, producer only
+		///
+		/// @param value Element, only moved from on success
+		/// @return `true` if pushed, `false` if full
+		///
+		bool try_push(T&& value) noexcept
+		{
+			const size_t tail_value = tail.load(std::memory_order_relaxed);
+			if (tail_value - head.load(std::memory_order_acquire) == capacity) return false;
+
+			slots[tail_value % capacity].emplace(std::move(value));
+			tail.store(tail_value + 1, std::memory_order_release);
+			notify();
+
+			return true;
+		}
+
+		///
+		/// @brief Pop the oldest element if any, consumer only
+		///
+		/// @return Element, or `std::nullopt` if empty
+		///
+		std::optional<T> try_pop() noexcept
+		{
+			const size_t head_value = head.load(std::memory_order_relaxed);
+			if (head_value == tail.load(std::memory_order_acquire)) return std::nullopt;
+
+			auto& slot = slots[head_value % capacity];
+			std::optional<T> value = std::move(slot);
+			slot.reset();
+
+			head.store(head_value + 1, std::memory_order_release);
+			notify();
+
+			return value;
+		}
+
+		///
+		/// @brief Push an element, waiting for room, producer only
+		///
+		/// @param value Element, only moved from on success
+		/// @return `true` if pushed, `false` if the queue was closed
+		///
+		bool push(T&& value) noexcept
+		{
+			while (true)
+			{
+				// Observed before checking, so that a change in between ends the wait
+				const uint32_t observed = events.load(std::memory_order_acquire);
+
+				if (closed.load(std::memory_order_acquire)) return false;
+				if (try_push(std::move(value))) return true;
+
+				events.wait(observed, std::memory_order_acquire);
+			}
+		}
+
+		///
+		/// @brief Pop the oldest element, waiting for one, consumer only
+		///
+		/// @return Element, or `std::nullopt` once the queue is closed and empty
+		///
+		std::optional<T> pop() noexcept
+		{
+			while (true)
+			{
+				const uint32_t observed = events.load(std::memory_order_acquire);
+
+				if (auto value = try_pop()) return value;
+				if (closed.load(std::memory_order_acquire)) return std::nullopt;
+
+				events.wait(observed, std::memory_order_acquire);
+			}
+		}
+
+		// Close the queue and wake waiting threads, callable from either side
+		void close() noexcept
+		{
+			closed.store(true, std::memory_order_release);
+			notify();
+		}
+
+		// Get the element count, exact only when called from the producer or consumer while the other is idle
+		size_t size() const noexcept
+		{
+			return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+		}
+
+		size_t get_capacity() const noexcept { return capacity; }
+
+	  private:
+
+		const size_t capacity;
+		std::unique_ptr<std::optional<T>[]> slots;
+
+		// Monotonic positions, on separate cache lines as each is written by one side only
+		alignas(64) std::atomic<size_t> head = 0;  // Written by the consumer
+		alignas(64) std::atomic<size_t> tail = 0;  // Written by the producer
+
+		// Incremented on every change, waited on by blocking calls
+		alignas(64) std::atomic<uint32_t> events = 0;
+		std::atomic<bool> closed = false;
+
+		void notify() noexcept
+		{
+			events.fetch_add(1, std::memory_order_release);
+			events.notify_all();
+		}
+	};
+}
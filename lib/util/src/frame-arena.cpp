@@ -0,0 +1,166 @@
+#include "util/frame-arena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+namespace util
+{
+	// Linear memory resource of a single frame
+	class FrameArena::Slot final : public std::pmr::memory_resource
+	{
+		struct OverflowBlock
+		{
+			void* ptr;
+			size_t bytes;
+			size_t alignment;
+		};
+
+		std::unique_ptr<std::byte[]> buffer;
+		size_t capacity;
+		size_t offset = 0;
+
+		std::pmr::memory_resource* upstream;
+		std::vector<OverflowBlock> overflow_blocks;
+		size_t overflow_bytes = 0;
+
+		bool poison;
+
+#ifndef NDEBUG
+		// Set while an allocation is in progress, to catch allocations racing from several threads
+		std::atomic_flag allocating;
+
+		struct AllocationGuard
+		{
+			std::atomic_flag& flag;
+
+			explicit AllocationGuard(std::atomic_flag& flag) noexcept :
+				flag(flag)
+			{
+				[[maybe_unused]] const bool racing = flag.test_and_set(std::memory_order_acquire);
+				assert(!racing && "Frame arena slot allocated from several threads at once");
+			}
+
+			~AllocationGuard() noexcept { flag.clear(std::memory_order_release); }
+		};
+#endif
+
+	  public:
+
+		Slot(size_t capacity, std::pmr::memory_resource* upstream, bool poison) noexcept :
+			buffer(std::make_unique_for_overwrite<std::byte[]>(capacity)),
+			capacity(capacity),
+			upstream(upstream),
+			poison(poison)
+		{}
+
+		Slot(const Slot&) = delete;
+		Slot& operator=(const Slot&) = delete;
+
+		~Slot() noexcept override { reset(); }
+
+		// Release all memory of the slot
+		void reset() noexcept
+		{
+			if (poison) std::memset(buffer.get(), std::to_integer<int>(poison_byte), offset);
+
+			for (const auto& block : overflow_blocks)
+			{
+				if (poison) std::memset(block.ptr, std::to_integer<int>(poison_byte), block.bytes);
+				upstream->deallocate(block.ptr, block.bytes, block.alignment);
+			}
+
+			offset = 0;
+			overflow_blocks.clear();
+			overflow_bytes = 0;
+		}
+
+		size_t get_used_bytes() const noexcept { return offset + overflow_bytes; }
+		size_t get_overflow_bytes() const noexcept { return overflow_bytes; }
+		size_t get_overflow_count() const noexcept { return overflow_blocks.size(); }
+
+	  protected:
+
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+#ifndef NDEBUG
+			const AllocationGuard guard(allocating);
+#endif
+
+			const auto base = std::bit_cast<uintptr_t>(buffer.get());
+			const uintptr_t aligned = (base + offset + alignment - 1) & ~uintptr_t(alignment - 1);
+			const size_t end = aligned - base + bytes;
+
+			if (end <= capacity) [[likely]]
+			{
+				offset = end;
+				return std::bit_cast<void*>(aligned);
+			}
+
+			// Overflow, served by upstream and kept until the slot is reset
+			void* const ptr = upstream->allocate(bytes, alignment);
+			overflow_blocks.push_back({.ptr = ptr, .bytes = bytes, .alignment = alignment});
+			overflow_bytes += bytes;
+
+			return ptr;
+		}
+
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment [[maybe_unused]]) override
+		{
+			// Memory is reclaimed on reset, only poison released blocks early
+			if (poison) std::memset(ptr, std::to_integer<int>(poison_byte), bytes);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+	};
+
+	FrameArena::FrameArena() noexcept :
+		FrameArena(Config{})
+	{}
+
+	FrameArena::FrameArena(const Config& config, std::pmr::memory_resource* upstream) noexcept
+	{
+		const auto frame_count = std::max(config.frame_count, 1u);
+
+		slots.reserve(frame_count);
+		for (uint32_t i = 0; i < frame_count; i++)
+			slots.emplace_back(std::make_unique<Slot>(config.capacity_per_frame, upstream, config.poison));
+	}
+
+	FrameArena::FrameArena(FrameArena&&) noexcept = default;
+	FrameArena& FrameArena::operator=(FrameArena&&) noexcept = default;
+	FrameArena::~FrameArena() noexcept = default;
+
+	void FrameArena::begin_frame() noexcept
+	{
+		const auto& finished = *slots[current_slot];
+		high_water_bytes = std::max(high_water_bytes, finished.get_used_bytes());
+		if (finished.get_overflow_count() > 0) overflow_frame_count++;
+
+		current_slot = (current_slot + 1) % slots.size();
+		slots[current_slot]->reset();
+	}
+
+	std::pmr::memory_resource* FrameArena::resource() const noexcept
+	{
+		return slots[current_slot].get();
+	}
+
+	FrameArena::Stats FrameArena::get_stats() const noexcept
+	{
+		const auto& slot = *slots[current_slot];
+
+		return {
+			.used_bytes = slot.get_used_bytes(),
+			.overflow_bytes = slot.get_overflow_bytes(),
+			.overflow_count = slot.get_overflow_count(),
+			.high_water_bytes = std::max(high_water_bytes, slot.get_used_bytes()),
+			.overflow_frame_count = overflow_frame_count
+		};
+	}
+}
@@ -0,0 +1,100 @@
+#include "util/hash.hpp"
+
+#include <bit>
+#include <cstring>
+
+namespace util
+{
+	static constexpr uint64_t prime64_1 = 0x9E3779B185EBCA87ull;
+	static constexpr uint64_t prime64_2 = 0xC2B2AE3D27D4EB4Full;
+	static constexpr uint64_t prime64_3 = 0x165667B19E3779F9ull;
+	static constexpr uint64_t prime64_4 = 0x85EBCA77C2B2AE63ull;
+	static constexpr uint64_t prime64_5 = 0x27D4EB2F165667C5ull;
+
+	// Unaligned little-endian read
+	template <typename T>
+	static T read_le(const std::byte* ptr) noexcept
+	{
+		T value;
+		std::memcpy(&value, ptr, sizeof(T));
+		if constexpr (std::endian::native == std::endian::big) value = std::byteswap(value);
+		return value;
+	}
+
+	static uint64_t round(uint64_t acc, uint64_t input) noexcept
+	{
+		acc += input * prime64_2;
+		acc = std::rotl(acc, 31);
+		return acc * prime64_1;
+	}
+
+	static uint64_t merge_round(uint64_t acc, uint64_t value) noexcept
+	{
+		acc ^= round(0, value);
+		return acc * prime64_1 + prime64_4;
+	}
+
+	uint64_t hash_bytes(std::span<const std::byte> data, uint64_t seed) noexcept
+	{
+		const std::byte* ptr = data.data();
+		const std::byte* const end = ptr + data.size();
+
+		uint64_t hash;
+
+		if (data.size() >= 32)
+		{
+			uint64_t v1 = seed + prime64_1 + prime64_2;
+			uint64_t v2 = seed + prime64_2;
+			uint64_t v3 = seed;
+			uint64_t v4 = seed - prime64_1;
+
+			// Four independent lanes over 32-byte stripes
+			for (; end - ptr >= 32; ptr += 32)
+			{
+				v1 = round(v1, read_le<uint64_t>(ptr));
+				v2 = round(v2, read_le<uint64_t>(ptr + 8));
+				v3 = round(v3, read_le<uint64_t>(ptr + 16));
+				v4 = round(v4, read_le<uint64_t>(ptr + 24));
+			}
+
+			hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+			hash = merge_round(hash, v1);
+			hash = merge_round(hash, v2);
+			hash = merge_round(hash, v3);
+			hash = merge_round(hash, v4);
+		}
+		else
+			hash = seed + prime64_5;
+
+		hash += data.size();
+
+		// Tail
+		for (; end - ptr >= 8; ptr += 8)
+		{
+			hash ^= round(0, read_le<uint64_t>(ptr));
+			hash = std::rotl(hash, 27) * prime64_1 + prime64_4;
+		}
+
+		if (end - ptr >= 4)
+		{
+			hash ^= uint64_t(read_le<uint32_t>(ptr)) * prime64_1;
+			hash = std::rotl(hash, 23) * prime64_2 + prime64_3;
+			ptr += 4;
+		}
+
+		for (; ptr < end; ptr++)
+		{
+			hash ^= uint64_t(*ptr) * prime64_5;
+			hash = std::rotl(hash, 11) * prime64_1;
+		}
+
+		// Avalanche
+		hash ^= hash >> 33;
+		hash *= prime64_2;
+		hash ^= hash >> 29;
+		hash *= prime64_3;
+		hash ^= hash >> 32;
+
+		return hash;
+	}
+}
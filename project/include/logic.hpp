@@ -8,8 +8,10 @@
 #include "logic/furniture-controller.hpp"
 #include "logic/light-controller.hpp"
 #include "logic/time-controller.hpp"
+#include "logic/visibility-controller.hpp"
 #include "render/drawdata/light.hpp"
 #include "render/param.hpp"
+#include "util/frame-arena.hpp"
 
 #include <glm/glm.hpp>
 #include <glm/trigonometric.hpp>
@@ -22,19 +24,25 @@ class Logic
 	{
 		render::Params params;
 		gltf::Drawdata main_drawdata;
-		std::vector<render::drawdata::Light> light_drawdata_list;
+		std::pmr::vector<render::drawdata::Light> light_drawdata_list;
 	};
 
 	///
 	/// @brief Create Logic instance
 	///
 	/// @param context SDL backend context
+	/// @param frames_ahead Frames the renderer prepares ahead of the rendered one, see `render::Renderer`
 	/// @return Logic instance or error
 	///
-	static std::expected<Logic, util::Error> create(const backend::SDLcontext& context) noexcept;
+	static std::expected<Logic, util::Error> create(
+		const backend::SDLcontext& context,
+		uint32_t frames_ahead
+	) noexcept;
 
 	///
 	/// @brief Execute per-frame logic and produce render output
+	/// @note Per-frame arrays of the output live in the logic frame arena, and stay valid until the
+	/// output of `frames_ahead + 1` later calls has been produced
 	///
 	/// @param context SDL backend context
 	/// @return Render output including render params and drawdata
@@ -47,6 +55,9 @@ class Logic
 
 	gltf::Model model;
 
+	// Node, joint and light arrays of the output, kept until the renderer is done with the frame
+	util::FrameArena frame_arena;
+
 	const uint32_t ceiling_node_index;
 
 	/* Controllers & States */
@@ -83,6 +94,7 @@ class Logic
 	logic::LightController light_controller;
 	logic::FurnitureController furniture_controller;
 	logic::Environment environment;
+	logic::VisibilityController visibility_controller;
 
 	std::optional<FireAlarm> fire_alarm = std::nullopt;
 	ViewMode view_mode = ViewMode::Walk;
@@ -159,18 +171,25 @@ class Logic
 		logic::LightController light_controller,
 		logic::FurnitureController furniture_controller,
 		logic::Environment environment,
+		logic::VisibilityController visibility_controller,
 		std::string device_name,
 		std::string driver_name,
-		uint32_t ceiling_node_index
+		uint32_t ceiling_node_index,
+		uint32_t frames_ahead
 	) :
 		model(std::move(model)),
+		frame_arena({.capacity_per_frame = 1024 * 1024, .frame_count = frames_ahead + 2}),
 		ceiling_node_index(ceiling_node_index),
 		light_controller(std::move(light_controller)),
 		furniture_controller(std::move(furniture_controller)),
 		environment(std::move(environment)),
+		visibility_controller(std::move(visibility_controller)),
 		device_name(std::move(device_name)),
 		driver_name(std::move(driver_name))
-	{}
+	{
+		// Drawdata lives as long as the frame arena memory it is generated with
+		this->model.set_frame_count(frames_ahead + 2);
+	}
 
   public:
 
@@ -41,6 +41,14 @@ namespace logic
 		///
 		void handle_fire_event(Area fire_area) noexcept;
 
+		///
+		/// @brief Tell if a furniture item is opened, even partially.
+		///
+		/// @param animation_name Animation name of the furniture item.
+		/// @return True if opened or if no item has this animation, false if fully closed.
+		///
+		bool is_opened(const std::string& animation_name) const noexcept;
+
 	  private:
 
 		struct Config
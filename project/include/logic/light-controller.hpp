@@ -4,10 +4,12 @@
 #include "gltf/model.hpp"
 #include "render/drawdata/light.hpp"
 #include "render/light-volume.hpp"
+#include "render/param.hpp"
 
 #include <expected>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <string>
 
 namespace logic
@@ -55,12 +57,16 @@ namespace logic
 		std::vector<std::pair<uint32_t, float>> get_emission_overrides() const noexcept;
 
 		///
-		/// @brief Get light drawdata from enabled light groups
+		/// @brief Get light drawdata from enabled light groups, dropping volumes outside the camera frustum
 		/// @param drawdata Main drawdata for node matrices
+		/// @param camera_matrices Camera matrices for frustum culling
+		/// @param memory Resource of the returned list
 		/// @return List of light drawdata
 		///
-		std::vector<render::drawdata::Light> get_light_drawdata(
-			const gltf::Drawdata& drawdata
+		std::pmr::vector<render::drawdata::Light> get_light_drawdata(
+			const gltf::Drawdata& drawdata,
+			const render::CameraMatrices& camera_matrices,
+			std::pmr::memory_resource* memory = std::pmr::get_default_resource()
 		) const noexcept;
 
 		///
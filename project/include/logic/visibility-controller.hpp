@@ -0,0 +1,78 @@
+#pragma once
+
+#include "area.hpp"
+#include "furniture-controller.hpp"
+#include "graphics/portal.hpp"
+#include "render/param.hpp"
+#include "util/error.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace logic
+{
+	///
+	/// @brief Room-level visibility, built from the areas of the house and the openings between them.
+	/// @details Cells and portals are read from `portal-table.json`:
+	/// - `cells`: `{"area", "min", "max"}` per area, in world space. An area without bounds (usually
+	/// `Exterior`) holds everything outside the other cells.
+	/// - `portals`: `{"areas": [a, b], "corners": [4 points], "door"}`, where the optional `door` is the
+	/// animation name of a door. The portal is closed while that door is fully closed.
+	///
+	/// An empty table disables room culling.
+	///
+	class VisibilityController
+	{
+	  public:
+
+		///
+		/// @brief Create visibility controller from the portal table asset.
+		///
+		/// @return Visibility controller, or error if the table is missing or invalid.
+		///
+		static std::expected<VisibilityController, util::Error> create() noexcept;
+
+		///
+		/// @brief Compute areas visible from a camera.
+		///
+		/// @param camera_matrices Current camera matrices
+		/// @param furniture_controller Furniture controller, for door states
+		/// @return Portal visibility, unrestricted if no cell is configured or the eye is in no cell
+		///
+		graphics::PortalVisibility compute(
+			const render::CameraMatrices& camera_matrices,
+			const FurnitureController& furniture_controller
+		) const noexcept;
+
+		///
+		/// @brief Get the area of each cell, in cell order of the portal graph.
+		///
+		/// @return Cell areas
+		///
+		std::span<const Area> get_cell_areas() const noexcept { return cell_areas; }
+
+	  private:
+
+		graphics::PortalGraph portal_graph;
+		std::vector<Area> cell_areas;
+		std::vector<std::optional<std::string>> portal_doors;  // Door animation name of each portal
+
+		VisibilityController(
+			graphics::PortalGraph portal_graph,
+			std::vector<Area> cell_areas,
+			std::vector<std::optional<std::string>> portal_doors
+		) :
+			portal_graph(std::move(portal_graph)),
+			cell_areas(std::move(cell_areas)),
+			portal_doors(std::move(portal_doors))
+		{}
+
+	  public:
+
+		VisibilityController(const VisibilityController&) = delete;
+		VisibilityController(VisibilityController&&) = default;
+		VisibilityController& operator=(const VisibilityController&) = delete;
+		VisibilityController& operator=(VisibilityController&&) = default;
+	};
+}
@@ -95,7 +95,10 @@ static std::expected<gltf::Model, util::Error> create_scene_from_model(
 	return gltf_result;
 }
 
-std::expected<Logic, util::Error> Logic::create(const backend::SDLcontext& context) noexcept
+std::expected<Logic, util::Error> Logic::create(
+	const backend::SDLcontext& context,
+	uint32_t frames_ahead
+) noexcept
 {
 	auto model = create_scene_from_model(context);
 	if (!model) return model.error().forward("Load 3D model failed");
@@ -110,6 +113,10 @@ std::expected<Logic, util::Error> Logic::create(const backend::SDLcontext& conte
 	auto environment = logic::Environment::create(*model);
 	if (!environment) return environment.error().forward("Create environment failed");
 
+	auto visibility_controller = logic::VisibilityController::create();
+	if (!visibility_controller)
+		return visibility_controller.error().forward("Create visibility controller failed");
+
 	const auto prop = SDL_GetGPUDeviceProperties(context.device);
 	if (prop == 0) return util::Error("Get SDL GPU device properties failed");
 
@@ -129,9 +136,11 @@ std::expected<Logic, util::Error> Logic::create(const backend::SDLcontext& conte
 		std::move(*light_controller),
 		std::move(*furniture_controller),
 		std::move(*environment),
+		std::move(*visibility_controller),
 		device_name,
 		std::format("{} ({})", driver_name, driver_version),
-		*ceiling_node_index
+		*ceiling_node_index,
+		frames_ahead
 	);
 }
 
@@ -331,15 +340,27 @@ Logic::RenderOutput Logic::update(const backend::SDLcontext& context) noexcept
 	std::vector<uint32_t> hidden_nodes;
 	if (view_mode == ViewMode::Cross_section) hidden_nodes.push_back(ceiling_node_index);
 
-	auto main_drawdata =
-		model.generate_drawdata(glm::mat4(1.0f), animation_keys, emission_overrides, hidden_nodes);
+	auto main_drawdata = model.generate_drawdata(
+		glm::mat4(1.0f),
+		animation_keys,
+		emission_overrides,
+		hidden_nodes,
+		frame_arena.resource()
+	);
 
-	auto light_drawdata_list = light_controller.get_light_drawdata(main_drawdata);
+	auto light_drawdata_list =
+		light_controller.get_light_drawdata(main_drawdata, camera_matrices, frame_arena.resource());
+
+	// The cross-section camera looks into the rooms through the hidden ceiling, not through portals
+	auto portal_visibility = view_mode == ViewMode::Cross_section
+		? graphics::PortalVisibility()
+		: visibility_controller.compute(camera_matrices, furniture_controller);
 
 	const render::Params params{
 		.camera = camera_matrices,
 		.primary_light = view_mode == ViewMode::Cross_section ? cross_section_light : primary_light_param,
-		.ambient = ambient_light_param
+		.ambient = ambient_light_param,
+		.portal_visibility = std::move(portal_visibility)
 	};
 
 	return {
@@ -351,6 +372,8 @@ Logic::RenderOutput Logic::update(const backend::SDLcontext& context) noexcept
 
 Logic::RenderOutput Logic::logic(const backend::SDLcontext& context) noexcept
 {
+	frame_arena.begin_frame();
+
 	auto render_results = update(context);
 	render_ui(render_results.main_drawdata.node_matrices, render_results.params.camera);
 	return render_results;
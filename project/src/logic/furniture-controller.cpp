@@ -1,6 +1,7 @@
 #include "logic/furniture-controller.hpp"
 #include "ui/capsule.hpp"
 
+#include <algorithm>
 #include <glm/glm.hpp>
 #include <imgui.h>
 #include <ranges>
@@ -216,4 +217,14 @@ namespace logic
 				!furniture.config.fire_area.has_value() || furniture.config.fire_area.value() != fire_area;
 		}
 	}
+
+	bool FurnitureController::is_opened(const std::string& animation_name) const noexcept
+	{
+		const auto furniture = std::ranges::find_if(furniture_states, [&animation_name](const State& state) {
+			return state.config.animation_name == animation_name;
+		});
+
+		if (furniture == furniture_states.end()) return true;
+		return furniture->current_time > 0.0f;
+	}
 }
\ No newline at end of file
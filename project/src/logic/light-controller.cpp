@@ -1,6 +1,7 @@
 #include "logic/light-controller.hpp"
 
 #include "asset/light-volume.hpp"
+#include "graphics/culling.hpp"
 #include "render/light-volume.hpp"
 #include "ui/capsule.hpp"
 #include "util/asset.hpp"
@@ -226,10 +227,15 @@ namespace logic
 		return emission_overrides;
 	}
 
-	std::vector<render::drawdata::Light> LightController::get_light_drawdata(
-		const gltf::Drawdata& drawdata
+	std::pmr::vector<render::drawdata::Light> LightController::get_light_drawdata(
+		const gltf::Drawdata& drawdata,
+		const render::CameraMatrices& camera_matrices,
+		std::pmr::memory_resource* memory
 	) const noexcept
 	{
+		const auto camera_frustum =
+			graphics::compute_frustum_planes(camera_matrices.proj_matrix * camera_matrices.view_matrix);
+
 		return light_groups
 			| std::views::values
 			| std::views::filter(&logic::LightGroup::enabled)
@@ -243,7 +249,10 @@ namespace logic
 					   light.volume
 				   );
 			   })
-			| std::ranges::to<std::vector>();
+			| std::views::filter([&camera_frustum](const render::drawdata::Light& light) {
+				   return light.volume->hull.in_frustum(camera_frustum, light.volume_transform);
+			   })
+			| std::ranges::to<std::pmr::vector<render::drawdata::Light>>(memory);
 	}
 
 	void LightController::handle_fire_event() noexcept
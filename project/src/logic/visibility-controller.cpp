@@ -0,0 +1,170 @@
+#include "logic/visibility-controller.hpp"
+
+#include "asset/portal.hpp"
+#include "util/asset.hpp"
+#include "zip/zip.hpp"
+
+#include <nlohmann/json.hpp>
+#include <ranges>
+
+namespace logic
+{
+	// Area identifiers used in the portal table
+	static const std::map<std::string, Area> area_ids = {
+		{"Living_room",   Area::Living_room  },
+		{"Toilet",        Area::Toilet       },
+		{"Kitchen",       Area::Kitchen      },
+		{"Large_bedroom", Area::Large_bedroom},
+		{"Small_bedroom", Area::Small_bedroom},
+		{"Exterior",      Area::Exterior     },
+	};
+
+	static std::expected<nlohmann::json, util::Error> load_json() noexcept
+	{
+		const auto json_text =
+			util::get_asset(resource_asset::portal, "portal-table.json")
+				.and_then(zip::Decompress())
+				.transform([](std::vector<std::byte> data) {
+					return std::string(reinterpret_cast<const char*>(data.data()), data.size());
+				});
+		if (!json_text) return json_text.error().forward("Can't find portal table config");
+
+		try
+		{
+			nlohmann::json json = nlohmann::json::parse(*json_text);
+			if (!json.is_object()) return util::Error("Portal table JSON is not an object");
+			return json;
+		}
+		catch (const nlohmann::json::parse_error& e)
+		{
+			return util::Error(std::format("Parse portal table JSON failed: {}", e.what()));
+		}
+	}
+
+	static glm::vec3 get_vec3(const nlohmann::json& json)
+	{
+		return {json.at(0).get<float>(), json.at(1).get<float>(), json.at(2).get<float>()};
+	}
+
+	std::expected<VisibilityController, util::Error> VisibilityController::create() noexcept
+	{
+		auto json_result = load_json();
+		if (!json_result) return json_result.error().forward("Load portal table failed");
+		const auto json = std::move(*json_result);
+
+		if (!json.contains("cells") || !json["cells"].is_array())
+			return util::Error("Portal table has no 'cells' array");
+		if (!json.contains("portals") || !json["portals"].is_array())
+			return util::Error("Portal table has no 'portals' array");
+
+		try
+		{
+			std::vector<graphics::PortalGraph::Cell> cells;
+			std::vector<Area> cell_areas;
+			std::map<Area, uint32_t> area_cells;
+
+			for (const auto& [idx_str, value] : json["cells"].items())
+			{
+				if (!value.is_object() || !value.contains("area"))
+					return util::Error(std::format("Cell index {} has no area", idx_str));
+
+				const auto area_name = value["area"].get<std::string>();
+				const auto area_it = area_ids.find(area_name);
+				if (area_it == area_ids.end())
+					return util::Error(std::format("Unknown area '{}' in cell index {}", area_name, idx_str));
+
+				if (area_cells.contains(area_it->second))
+					return util::Error(std::format("Area '{}' has more than one cell", area_name));
+
+				// Cells without bounds hold everything outside the other cells
+				std::optional<graphics::Aabb> bounds;
+				if (value.contains("min") || value.contains("max"))
+					bounds = graphics::Aabb{
+						.min = get_vec3(value.at("min")),
+						.max = get_vec3(value.at("max"))
+					};
+
+				area_cells.emplace(area_it->second, uint32_t(cells.size()));
+				cells.push_back({.bounds = bounds});
+				cell_areas.push_back(area_it->second);
+			}
+
+			std::vector<graphics::PortalGraph::Portal> portals;
+			std::vector<std::optional<std::string>> portal_doors;
+
+			for (const auto& [idx_str, value] : json["portals"].items())
+			{
+				if (!value.is_object() || !value.contains("areas") || !value.contains("corners"))
+					return util::Error(std::format("Portal index {} is missing required fields", idx_str));
+
+				const auto& areas = value["areas"];
+				const auto& corners = value["corners"];
+				if (!areas.is_array() || areas.size() != 2)
+					return util::Error(std::format("Portal index {} doesn't connect two areas", idx_str));
+				if (!corners.is_array() || corners.size() != 4)
+					return util::Error(std::format("Portal index {} doesn't have 4 corners", idx_str));
+
+				graphics::PortalGraph::Portal portal;
+
+				for (const auto [side, area_json] : std::views::enumerate(areas))
+				{
+					const auto area_name = area_json.get<std::string>();
+					const auto area_it = area_ids.find(area_name);
+					if (area_it == area_ids.end() || !area_cells.contains(area_it->second))
+						return util::Error(
+							std::format(
+								"Portal index {} refers to area '{}' without cell",
+								idx_str,
+								area_name
+							)
+						);
+
+					portal.cells[side] = area_cells.at(area_it->second);
+				}
+
+				for (const auto [corner_idx, corner_json] : std::views::enumerate(corners))
+					portal.corners[corner_idx] = get_vec3(corner_json);
+
+				portals.push_back(portal);
+				portal_doors.push_back(
+					value.contains("door") ? std::optional(value["door"].get<std::string>()) : std::nullopt
+				);
+			}
+
+			auto portal_graph = graphics::PortalGraph::create(std::move(cells), std::move(portals));
+			if (!portal_graph) return portal_graph.error().forward("Create portal graph failed");
+
+			return VisibilityController(
+				std::move(*portal_graph),
+				std::move(cell_areas),
+				std::move(portal_doors)
+			);
+		}
+		catch (const nlohmann::json::exception& e)
+		{
+			return util::Error(std::format("Parse portal table JSON failed: {}", e.what()));
+		}
+	}
+
+	graphics::PortalVisibility VisibilityController::compute(
+		const render::CameraMatrices& camera_matrices,
+		const FurnitureController& furniture_controller
+	) const noexcept
+	{
+		if (portal_graph.get_cells().empty()) return {};
+
+		// A portal behind a door is closed only while the door is fully closed
+		const auto is_open = [&furniture_controller](const std::optional<std::string>& door) -> uint8_t {
+			return !door.has_value() || furniture_controller.is_opened(*door);
+		};
+
+		const auto portal_open =
+			portal_doors | std::views::transform(is_open) | std::ranges::to<std::vector>();
+
+		return portal_graph.compute_visibility(
+			camera_matrices.eye_position,
+			camera_matrices.proj_matrix * camera_matrices.view_matrix,
+			portal_open
+		);
+	}
+}
@@ -11,14 +11,18 @@
 #include "backend/sdl.hpp"
 #include "logic.hpp"
 #include "render.hpp"
+#include "util/frame-pipeline.hpp"
 #include "util/unwrap.hpp"
 
+// Frames prepared on the worker thread ahead of the rendered one, 0 to prepare and render serially
+static constexpr uint32_t FRAMES_AHEAD = 1;
+
 static void main_logic(const backend::SDLcontext& sdl_context)
 {
 	auto render_resource =
 		backend::display_until_task_done(
 			sdl_context,
-			std::async(std::launch::async, render::Renderer::create, std::ref(sdl_context)),
+			std::async(std::launch::async, render::Renderer::create, std::ref(sdl_context), FRAMES_AHEAD),
 			[] {
 				ImGui::Text("创建渲染管线...");
 				ImGui::ProgressBar(-ImGui::GetTime(), ImVec2(300.0f, 0.0f));
@@ -26,7 +30,19 @@ static void main_logic(const backend::SDLcontext& sdl_context)
 		)
 		| util::unwrap("Create render resource failed");
 
-	auto logic = Logic::create(sdl_context) | util::unwrap("Create logic failed");
+	auto logic = Logic::create(sdl_context, FRAMES_AHEAD) | util::unwrap("Create logic failed");
+
+	// Culls, sorts and batches frame N + 1 while frame N is recorded and submitted
+	util::FramePipeline<
+		std::unique_ptr<const render::FrameSnapshot>,
+		std::expected<render::Renderer::PreparedFrame, util::Error>
+	>
+		prepare_pipeline(
+			[&render_resource](std::unique_ptr<const render::FrameSnapshot> snapshot) {
+				return render_resource.prepare(std::move(snapshot));
+			},
+			FRAMES_AHEAD
+		);
 
 	/* Main loop */
 
@@ -53,15 +69,26 @@ static void main_logic(const backend::SDLcontext& sdl_context)
 		backend::imgui_new_frame();
 		auto [params, main_drawdata, primary_point_lights] = logic.logic(sdl_context);
 
-		std::vector<gltf::Drawdata> drawdata_list;
-		drawdata_list.emplace_back(std::move(main_drawdata));
+		auto snapshot = std::make_unique<render::FrameSnapshot>(render::FrameSnapshot{
+			.lights = std::move(primary_point_lights),
+			.params = std::move(params),
+			.ui = backend::imgui_end_frame()
+		});
+		snapshot->models.emplace_back(std::move(main_drawdata));
 
 		/*===== Render =====*/
 
-		const render::Drawdata drawdata = {.models = drawdata_list, .lights = primary_point_lights};
+		prepare_pipeline.push(std::move(snapshot));
 
-		render_resource.render(sdl_context, drawdata, params) | util::unwrap("Render frame failed");
+		// The pipeline is filling up, nothing to render yet, the UI stays with its snapshot
+		if (prepare_pipeline.get_frames_in_flight() <= FRAMES_AHEAD) continue;
+
+		auto prepared = *prepare_pipeline.pop() | util::unwrap("Prepare frame failed");
+		render_resource.render(sdl_context, std::move(prepared)) | util::unwrap("Render frame failed");
 	}
+
+	// Resources pending in the deletion queue are released with the renderer, wait for them to be unused
+	SDL_WaitForGPUIdle(sdl_context.device);
 }
 
 int main()
@@ -1,35 +1,187 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <expected>
 #include <glm/fwd.hpp>
 #include <glm/glm.hpp>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <thread_pool/thread_pool.h>
+#include <vector>
 
+#include "backend/imgui.hpp"
 #include "gltf/model.hpp"
+#include "gpu/deletion-queue.hpp"
+#include "graphics/light-cluster.hpp"
+#include "graphics/occlusion.hpp"
+#include "graphics/shadow-schedule.hpp"
+#include "graphics/util/dynamic-resolution.hpp"
+#include "graphics/util/render-graph.hpp"
+#include "graphics/util/stream-buffer.hpp"
+#include "graphics/util/texture-pool.hpp"
+#include "render/const-params.hpp"
+#include "render/drawdata/indirect.hpp"
 #include "render/drawdata/light.hpp"
+#include "render/drawdata/object.hpp"
+#include "render/drawdata/shadow.hpp"
 #include "render/param.hpp"
 #include "render/pipeline.hpp"
 #include "render/target.hpp"
+#include "util/frame-arena.hpp"
 
 namespace render
 {
-	struct Drawdata
+	// Immutable inputs of a frame, handed from the logic to `Renderer::prepare`. Per-frame arrays may live in
+	// a frame arena of the logic, which must outlive the snapshot. The UI is captured in the same logic tick,
+	// so it is drawn with the frame it was built for however many frames are prepared ahead.
+	struct FrameSnapshot
 	{
-		std::span<const gltf::Drawdata> models;
-		std::span<const drawdata::Light> lights;
+		std::vector<gltf::Drawdata> models;
+		std::pmr::vector<drawdata::Light> lights;
+		Params params;
+		backend::ImguiDrawData ui;
 	};
 
 	class Renderer
 	{
 	  public:
 
-		static std::expected<Renderer, util::Error> create(const backend::SDLcontext& sdl_context) noexcept;
+		///
+		/// @brief Drawdata of a frame culled, sorted and batched by `prepare`, consumed by `render`
+		/// @note Owns the snapshot it was prepared from, drawdata reference it by address
+		///
+		struct PreparedFrame
+		{
+			std::unique_ptr<const FrameSnapshot> snapshot;
 
+			drawdata::Gbuffer gbuffer_drawdata;
+			drawdata::Shadow shadow_drawdata;
+			drawdata::ObjectData object_data;
+			drawdata::IndirectDraws indirect_draws;
+
+			uint64_t shadow_cache_epoch;  // Epoch of the shadow cache decisions, see `render`
+
+			drawdata::Shadow::Stats shadow_stats;
+			drawdata::IndirectDraws::Stats draw_stats;
+			util::FrameArena::Stats frame_arena_stats;
+		};
+
+		///
+		/// @brief Create a renderer
+		///
+		/// @param sdl_context SDL backend context
+		/// @param frames_ahead Frames prepared ahead of the rendered one, 0 when preparing serially
+		/// @return Renderer, or error
+		///
+		static std::expected<Renderer, util::Error> create(
+			const backend::SDLcontext& sdl_context,
+			uint32_t frames_ahead
+		) noexcept;
+
+		///
+		/// @brief Cull, sort and batch the drawdata of a frame, CPU work only
+		/// @details Can run on another thread while `render` consumes earlier frames. Calls to `prepare` must
+		/// not overlap, and at most `frames_ahead` prepared frames may wait for `render`.
+		///
+		/// @param snapshot Inputs of the frame
+		/// @return Prepared frame, or error
+		///
+		std::expected<PreparedFrame, util::Error> prepare(
+			std::unique_ptr<const FrameSnapshot> snapshot
+		) noexcept;
+
+		///
+		/// @brief Upload, record and submit a prepared frame
+		/// @note A frame without swapchain texture is dropped, along with frames prepared before it was, as
+		/// their cached shadow levels rely on updates of the dropped frame
+		///
+		/// @param sdl_context SDL backend context
+		/// @param prepared Frame prepared by `prepare`, in preparation order
+		/// @return Void on success, or error
+		///
 		std::expected<void, util::Error> render(
 			const backend::SDLcontext& sdl_context,
-			Drawdata drawdata,
-			const Params& params
+			PreparedFrame prepared
 		) noexcept;
 
+		///
+		/// @brief Get allocation statistics of the per-frame drawdata arena, as of the last rendered frame
+		///
+		/// @return Arena statistics
+		///
+		util::FrameArena::Stats get_frame_arena_stats() const noexcept { return frame_arena_stats; }
+
+		///
+		/// @brief Get shadow culling and caching decisions of the last rendered frame
+		///
+		/// @return Shadow statistics
+		///
+		drawdata::Shadow::Stats get_shadow_stats() const noexcept { return shadow_stats; }
+
+		///
+		/// @brief Get drawcall batching counters of the last rendered frame, G-buffer and shadow together
+		///
+		/// @return Draw statistics
+		///
+		drawdata::IndirectDraws::Stats get_draw_stats() const noexcept { return draw_stats; }
+
+		///
+		/// @brief Get culling and transient memory counters of the last frame graph
+		///
+		/// @return Frame graph statistics
+		///
+		graphics::RenderGraph::Stats get_frame_graph_stats() const noexcept { return frame_graph_stats; }
+
+		// Capture the frame graph of the next rendered frame in GraphViz DOT format
+		void request_frame_graph_dump() noexcept { frame_graph_dump_requested = true; }
+
+		// Get the last captured frame graph, empty until one is requested and rendered
+		const std::string& get_frame_graph_dump() const noexcept { return frame_graph_dump; }
+
+		///
+		/// @brief Get pending and released GPU resources of the deletion queue, as of the last submission
+		///
+		/// @return Deletion queue statistics
+		///
+		gpu::DeletionQueue::Stats get_deletion_queue_stats() const noexcept
+		{
+			return deletion_queue.get_stats();
+		}
+
+		///
+		/// @brief Get live and idle render target textures of the target pool, as of the last submission
+		///
+		/// @return Target pool statistics
+		///
+		graphics::TexturePool::Stats get_target_pool_stats() const noexcept
+		{
+			return target_pool.get_stats();
+		}
+
+		///
+		/// @brief Get the render scale and frame time state of the dynamic resolution controller
+		///
+		/// @return Dynamic resolution statistics, scale 1 while disabled
+		///
+		graphics::DynamicResolution::Stats get_dynamic_resolution_stats() const noexcept
+		{
+			return dynamic_resolution.get_stats();
+		}
+
+		///
+		/// @brief Get the light clusters of the last frame
+		/// @note Only built when `FunctionMask::light_clustering` is set. Light indices refer to the point
+		/// and spot lights of the frame, in drawdata order.
+		///
+		/// @return Light cluster grid
+		///
+		const graphics::LightCluster& get_light_cluster() const noexcept { return light_cluster; }
+
 	  private:
 
 		Pipeline pipeline;
@@ -38,32 +190,117 @@ namespace render
 		graphics::BufferPool buffer_pool;
 		graphics::TransferBufferPool transfer_buffer_pool;
 
-		std::expected<std::tuple<drawdata::Gbuffer, drawdata::Shadow>, util::Error> prepare_drawdata(
+		// Releases pooled buffers and evicted targets once the submissions using them have completed
+		gpu::DeletionQueue deletion_queue;
+
+		// Render target textures, kept for reuse when targets are resized back to a previous size
+		graphics::TexturePool target_pool;
+
+		// Transient targets of the last frame graph, aliased textures share one texture of the target pool
+		graphics::TransientTextures transient_textures;
+
+		// Delays target resizes while the swapchain size keeps changing
+		graphics::ResizeHysteresis target_size_hysteresis;
+
+		// Scales the render size to keep frame times within budget, see `FunctionMask::dynamic_resolution`
+		graphics::DynamicResolution dynamic_resolution;
+		std::optional<std::chrono::steady_clock::time_point> last_frame_start;
+
+		glm::u32vec2 history_target_size = {0, 0};  // Target size of the last rendered frame
+		glm::u32vec2 history_render_size = {0, 0};  // Render size of the last rendered frame
+
+		// Object data of the frame, read by G-buffer and shadow drawcalls through their draw id
+		graphics::StreamBuffer object_buffer;
+
+		// Draw ids and indirect draw commands of the frame, see `drawdata::IndirectDraws`
+		graphics::StreamBuffer draw_id_buffer;
+		graphics::StreamBuffer indirect_buffer;
+
+		// Backs drawdata containers, which are rebuilt every frame
+		util::FrameArena frame_arena;
+
+		// Workers for drawdata culling and sorting, boxed to keep the renderer movable
+		std::unique_ptr<dp::thread_pool<>> prepare_thread_pool;
+
+		// Software depth buffer of large static occluders, tested before G-buffer drawcalls are added
+		graphics::OcclusionBuffer occlusion_buffer;
+
+		// Per CSM level, static layer state and visible receivers of the frame
+		std::array<graphics::ShadowCascadeCache, 3> shadow_caches;
+		std::array<graphics::ShadowReceiverMask, 3> shadow_receiver_masks;
+
+		// Incremented by `render` when a frame is dropped, `prepare` then invalidates the shadow caches.
+		// Boxed to keep the renderer movable.
+		std::unique_ptr<std::atomic<uint64_t>> shadow_cache_epoch;
+		uint64_t prepared_shadow_cache_epoch = 0;  // Epoch last seen by `prepare`
+
+		// Statistics of the last rendered frame, written by `render` only
+		util::FrameArena::Stats frame_arena_stats;
+		drawdata::Shadow::Stats shadow_stats;
+		drawdata::IndirectDraws::Stats draw_stats;
+
+		graphics::RenderGraph::Stats frame_graph_stats;
+		bool frame_graph_dump_requested = false;
+		std::string frame_graph_dump;
+
+		// View-space froxel grid with the point and spot lights reaching each froxel
+		graphics::LightCluster light_cluster;
+
+		uint64_t frame_index = 0;
+
+		using PreparedDrawdata = std::tuple<
+			drawdata::Gbuffer,
+			drawdata::Shadow,
+			drawdata::ObjectData,
+			drawdata::IndirectDraws
+		>;
+
+		std::expected<PreparedDrawdata, util::Error> prepare_drawdata(
 			std::span<const gltf::Drawdata> drawdata_list,
 			const Params& params
 		) noexcept;
 
+		void prepare_light_cluster(
+			std::span<const drawdata::Light> lights,
+			const CameraMatrices& camera
+		) noexcept;
+
+		// Prepare joint palette and instance buffers of every drawdata
+		std::expected<void, util::Error> prepare_skinning_buffers(
+			std::span<const gltf::Drawdata> drawdata_list,
+			gltf::JointPalette joint_palette
+		) noexcept;
+
 		std::expected<void, util::Error> copy_resources(
 			const gpu::CommandBuffer& command_buffer,
-			std::span<const gltf::Drawdata> drawdata_list
+			std::span<const gltf::Drawdata> drawdata_list,
+			const backend::ImguiDrawData& ui
 		) const noexcept;
 
 		std::expected<void, util::Error> render_gbuffer(
 			const gpu::CommandBuffer& command_buffer,
 			const drawdata::Gbuffer& gbuffer_drawdata,
-			const Params& params
+			const drawdata::IndirectDraws& indirect_draws,
+			const Params& params,
+			glm::u32vec2 render_size
 		) const noexcept;
 
+		// Get the buffers of the frame read by glTF pipelines, valid after their update
+		pipeline::GltfFrameBuffers get_gltf_frame_buffers() const noexcept;
+
 		std::expected<void, util::Error> render_ao(
 			const gpu::CommandBuffer& command_buffer,
-			const Params& params
+			const Params& params,
+			glm::u32vec2 render_size,
+			glm::u32vec2 prev_render_size,
+			bool history_valid
 		) const noexcept;
 
 		std::expected<void, util::Error> render_lighting(
 			const gpu::CommandBuffer& command_buffer,
 			const drawdata::Shadow& shadow_drawdata,
 			const Params& params,
-			glm::u32vec2 swapchain_size
+			glm::u32vec2 render_size
 		) const noexcept;
 
 		std::expected<void, util::Error> render_lights(
@@ -72,50 +309,132 @@ namespace render
 			const target::LightBuffer& light_buffer_target,
 			std::span<const drawdata::Light> lights,
 			const Params& params,
-			glm::u32vec2 swapchain_size
+			glm::u32vec2 render_size
 		) const noexcept;
 
 		std::expected<void, util::Error> render_ssgi(
 			const gpu::CommandBuffer& command_buffer,
 			const drawdata::Gbuffer& gbuffer_drawdata,
 			const Params& params,
-			glm::u32vec2 swapchain_size
+			glm::u32vec2 render_size,
+			glm::u32vec2 prev_render_size,
+			bool history_valid
 		) const noexcept;
 
 		std::expected<void, util::Error> compute_auto_exposure(
 			const gpu::CommandBuffer& command_buffer,
-			glm::u32vec2 swapchain_size
+			glm::u32vec2 render_size
 		) const noexcept;
 
 		std::expected<void, util::Error> render_bloom(
 			const gpu::CommandBuffer& command_buffer,
 			const Params& params,
-			glm::u32vec2 swapchain_size
+			glm::u32vec2 render_size
 		) const noexcept;
 
 		std::expected<void, util::Error> render_composite(
 			SDL_GPUDevice* device,
 			const gpu::CommandBuffer& command_buffer,
 			const Params& params,
+			glm::u32vec2 target_size,
+			glm::u32vec2 render_size,
 			glm::u32vec2 swapchain_size,
 			SDL_GPUTexture* swapchain
 		) noexcept;
 
 		std::expected<void, util::Error> render_imgui(
 			const gpu::CommandBuffer& command_buffer,
+			const backend::ImguiDrawData& ui,
 			SDL_GPUTexture* swapchain
 		) const noexcept;
 
+		// Submit the frame, then release resources of completed submissions
+		std::expected<void, util::Error> submit(gpu::CommandBuffer command_buffer) noexcept;
+
+		// Inputs of the passes of a frame, referenced by the frame graph until executed
+		struct FrameInputs
+		{
+			SDL_GPUDevice* device;
+			const gpu::CommandBuffer& command_buffer;
+			const drawdata::Gbuffer& gbuffer_drawdata;
+			const drawdata::Shadow& shadow_drawdata;
+			const drawdata::IndirectDraws& indirect_draws;
+			std::span<const drawdata::Light> lights;
+			const Params& params;
+			const backend::ImguiDrawData& ui;
+			glm::u32vec2 target_size;       // Size of the render targets, the size bucket of the full size
+			glm::u32vec2 render_size;       // Rendered region at the top-left corner of the targets
+			bool history_valid;             // Targets were not reallocated since the previous frame
+			glm::u32vec2 prev_render_size;  // Region rendered by the previous frame, in the history textures
+			glm::u32vec2 swapchain_size;
+			SDL_GPUTexture* swapchain;
+		};
+
+		// Transient targets declared by the frame graph, bound to the targets once it is compiled
+		struct FrameTransients
+		{
+			graphics::RenderGraph::Handle depth;
+			graphics::RenderGraph::Handle albedo;
+			graphics::RenderGraph::Handle lighting_info;
+			graphics::RenderGraph::Handle ssgi_blurred_diffuse;
+			graphics::RenderGraph::Handle ssgi_radiance;
+			graphics::RenderGraph::Handle bloom_filter;
+			std::array<graphics::RenderGraph::Handle, target::Bloom::downsample_mip_count> bloom_downsample;
+			std::array<graphics::RenderGraph::Handle, target::Bloom::upsample_mip_count> bloom_upsample;
+			graphics::RenderGraph::Handle composite;
+		};
+
+		struct FrameGraph
+		{
+			graphics::RenderGraph graph;
+			FrameTransients transients;
+		};
+
+		///
+		/// @brief Declare the passes of a frame and the targets they use
+		/// @note Call after resizing targets, descriptions of imported targets are read from their current
+		/// size
+		///
+		/// @param frame Inputs of the frame, must outlive the execution of the graph
+		/// @return Frame graph, with the handles of its transient targets
+		///
+		FrameGraph build_frame_graph(const FrameInputs& frame) noexcept;
+
+		// Bind the realized transient textures of a frame graph to the targets, null for culled ones
+		void bind_transient_textures(const FrameTransients& transients) noexcept;
+
 		Renderer(
 			Pipeline pipeline,
 			Target target,
 			graphics::BufferPool buffer_pool,
-			graphics::TransferBufferPool transfer_buffer_pool
+			graphics::TransferBufferPool transfer_buffer_pool,
+			graphics::TexturePool target_pool,
+			graphics::LightCluster light_cluster,
+			uint32_t frames_ahead
 		) :
 			pipeline(std::move(pipeline)),
 			target(std::move(target)),
 			buffer_pool(std::move(buffer_pool)),
-			transfer_buffer_pool(std::move(transfer_buffer_pool))
+			transfer_buffer_pool(std::move(transfer_buffer_pool)),
+			target_pool(std::move(target_pool)),
+			target_size_hysteresis(TARGET_RESIZE_STABLE_FRAMES),
+			dynamic_resolution({
+				.target_frame_time = DYNAMIC_RESOLUTION_TARGET_FRAME_TIME,
+				.min_scale = DYNAMIC_RESOLUTION_MIN_SCALE,
+				.max_scale = 1.0f,
+				.scale_step = DYNAMIC_RESOLUTION_SCALE_STEP
+			}),
+			object_buffer({.graphic_storage_read = true}, "Object Data Buffer"),
+			draw_id_buffer({.vertex = true}, "Draw ID Buffer"),
+			indirect_buffer({.indirect = true}, "Indirect Draw Buffer"),
+			// Drawdata of the frames waiting for `render` and of the one rendered stay valid
+			frame_arena({.frame_count = frames_ahead + 2}),
+			prepare_thread_pool(
+				std::make_unique<dp::thread_pool<>>(std::max(std::thread::hardware_concurrency(), 2u) - 1)
+			),
+			occlusion_buffer({OCCLUSION_RES_X, OCCLUSION_RES_Y}),
+			shadow_cache_epoch(std::make_unique<std::atomic<uint64_t>>(0)),
+			light_cluster(std::move(light_cluster))
 		{}
 
 	  public:
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
 namespace render
@@ -10,10 +12,39 @@ namespace render
 	constexpr uint32_t SHADOW_LEVEL_RES_1 = 1536;
 	constexpr uint32_t SHADOW_LEVEL_RES_2 = 1024;
 
+	// Frames between dynamic caster refreshes of each cached CSM level, and their frame offsets
+	constexpr std::array<uint32_t, 3> SHADOW_LEVEL_REFRESH_INTERVAL = {1, 2, 4};
+	constexpr std::array<uint32_t, 3> SHADOW_LEVEL_REFRESH_PHASE = {0, 0, 1};
+
 	constexpr float EXPOSURE_MIN = 1e-2;
 	constexpr float EXPOSURE_MAX = 500.0f;
 	constexpr float EXPOSURE_EYE_ADAPTATION_RATE = 1.5f;
 
 	constexpr float BLOOM_START_THRES = 2.0f;
 	constexpr float BLOOM_END_THRES = 10.0f;
+
+	constexpr uint32_t TARGET_RESIZE_STABLE_FRAMES = 10;   // Frames a new size must persist to resize
+	constexpr uint64_t TARGET_POOL_BUDGET = 768ull << 20;  // Memory of live and idle render targets
+	constexpr uint32_t TARGET_POOL_MAX_IDLE_FRAMES = 600;  // Idle render targets unused for longer are freed
+	constexpr uint32_t TARGET_POOL_SIZE_GRANULARITY = 64;  // Render targets are allocated at multiples of it
+
+	constexpr float DYNAMIC_RESOLUTION_TARGET_FRAME_TIME = 1.0f / 60.0f;  // Frame time budget, in seconds
+	constexpr float DYNAMIC_RESOLUTION_MIN_SCALE = 0.5f;                 // Lowest render scale, per axis
+	constexpr float DYNAMIC_RESOLUTION_SCALE_STEP = 0.05f;               // Render scales are multiples of it
+
+	constexpr size_t PREPARE_CHUNK_SIZE = 512;          // Drawcalls culled per task
+	constexpr size_t PREPARE_PARALLEL_THRESHOLD = 2048;  // Fewer drawcalls are culled on the calling thread
+
+	constexpr uint32_t OCCLUSION_RES_X = 320;
+	constexpr uint32_t OCCLUSION_RES_Y = 192;
+	constexpr uint32_t OCCLUSION_BAND_TILE_ROWS = 4;     // Tile rows rasterized per task
+	constexpr size_t OCCLUSION_MAX_OCCLUDERS = 96;       // Largest occluders rasterized per frame
+	constexpr float OCCLUSION_MIN_OCCLUDER_SIZE = 0.1f;  // Minimum occluder extent over distance
+
+	constexpr uint32_t LIGHT_CLUSTER_X = 16;
+	constexpr uint32_t LIGHT_CLUSTER_Y = 9;
+	constexpr uint32_t LIGHT_CLUSTER_Z = 24;
+	constexpr float LIGHT_CLUSTER_NEAR = 0.5f;                // View distance of the first slice boundary
+	constexpr float LIGHT_CLUSTER_FAR = 100.0f;               // View distance past which nothing is clustered
+	constexpr size_t LIGHT_CLUSTER_PARALLEL_THRESHOLD = 256;  // Fewer lights run on the calling thread
 }
\ No newline at end of file
@@ -2,6 +2,13 @@
 
 #include "gltf/material.hpp"
 #include "gltf/model.hpp"
+#include "graphics/bvh.hpp"
+#include "graphics/occlusion.hpp"
+#include "graphics/portal.hpp"
+
+#include <map>
+#include <memory_resource>
+#include <vector>
 
 namespace render::drawdata
 {
@@ -9,19 +16,44 @@ namespace render::drawdata
 	{
 		struct Drawcall
 		{
-			gltf::PrimitiveDrawcall drawcall;
+			gltf::DrawcallHandle drawcall;  // Resolved with `Resource::drawcalls`
 			size_t resource_set_index;
 			float max_z;
+			uint32_t draw_id = 0;  // Index in the object data of the frame, see `ObjectData::assign`
 		};
 
 		struct Resource
 		{
 			gltf::MaterialCache::Ref material_cache;
 			std::shared_ptr<gltf::DeferredSkinningResource> deferred_skinning_resource;
+			std::shared_ptr<gltf::DeferredInstanceResource> deferred_instance_resource;
+			gltf::DrawcallList drawcalls;
+			std::pmr::vector<uint8_t> static_visible;  // From `DrawcallList::cull_static`
+		};
+
+		// Occluder candidate, from a visible opaque static drawcall
+		struct Occluder
+		{
+			const graphics::OccluderMesh* mesh;
+			glm::mat4 transform;
+			float size;  // Extent over distance to the eye, larger occludes more
+		};
+
+		using DrawcallBins = std::pmr::map<std::pair<gltf::PipelineMode, bool>, std::pmr::vector<Drawcall>>;
+
+		///
+		/// @brief Culling result of a drawcall range
+		/// @details Produced by `cull` independently of other ranges, then combined with `merge`
+		///
+		struct Partial
+		{
+			DrawcallBins drawcalls;
+			float min_z = 1;
 		};
 
-		std::map<std::pair<gltf::PipelineMode, bool>, std::vector<Drawcall>> drawcalls;
-		std::vector<Resource> resource_sets;
+		// Allocated from the memory resource given at construction, usually the renderer's frame arena
+		DrawcallBins drawcalls;
+		std::pmr::vector<Resource> resource_sets;
 
 		glm::mat4 camera_matrix;
 		glm::vec3 eye_position;
@@ -31,12 +63,24 @@ namespace render::drawdata
 		float min_z = 1;      // Minimum Z value
 		float near_distance;  // Distance from eye to near plane
 
+		// Optional, drawcalls in cells not seen through portals are culled
+		const graphics::PortalVisibility* portal_visibility = nullptr;
+
+		// Optional, drawcalls hidden behind its occluders are culled. Must be rasterized before `cull`.
+		const graphics::OcclusionBuffer* occlusion_buffer = nullptr;
+
 		///
 		/// @brief Create drawdata with camera matrix
 		///
 		/// @param camera_matrix Camera matrix
+		/// @param eye_position Eye position in world space
+		/// @param memory Memory resource for drawcall containers
 		///
-		Gbuffer(const glm::mat4& camera_matrix, const glm::vec3& eye_position) noexcept;
+		Gbuffer(
+			const glm::mat4& camera_matrix,
+			const glm::vec3& eye_position,
+			std::pmr::memory_resource* memory = std::pmr::get_default_resource()
+		) noexcept;
 
 		///
 		/// @brief Add glTF drawdata
@@ -45,6 +89,58 @@ namespace render::drawdata
 		///
 		void append(const gltf::Drawdata& drawdata) noexcept;
 
+		///
+		/// @brief Register resources of a glTF drawdata, without culling its drawcalls
+		///
+		/// @param drawdata glTF drawdata
+		/// @return Resource set index, used by `cull`
+		///
+		size_t add_resource_set(const gltf::Drawdata& drawdata) noexcept;
+
+		///
+		/// @brief Cull drawcalls in `[begin, end)` of a glTF drawdata into a partial result
+		/// @note Does not modify the drawdata, concurrent calls with distinct `partial` are safe
+		///
+		/// @param drawdata glTF drawdata
+		/// @param resource_set_index Index returned by `add_resource_set` for this drawdata
+		/// @param begin First drawcall position
+		/// @param end Past-the-end drawcall position
+		/// @param partial Output partial result
+		///
+		void cull(
+			const gltf::Drawdata& drawdata,
+			size_t resource_set_index,
+			size_t begin,
+			size_t end,
+			Partial& partial
+		) const noexcept;
+
+		///
+		/// @brief Select the largest occluders among visible static drawcalls
+		/// @note Call after `add_resource_set` for every drawdata
+		///
+		/// @param max_count Maximum number of occluders
+		/// @param min_size Minimum extent over distance of an occluder
+		/// @return Occluders, largest first
+		///
+		std::vector<Occluder> select_occluders(size_t max_count, float min_size) const noexcept;
+
+		///
+		/// @brief Append a partial result
+		/// @note Merging partials in range order yields the same drawcall order as `append`
+		///
+		/// @param partial Partial result
+		///
+		void merge(const Partial& partial) noexcept;
+
+		///
+		/// @brief Collect world bounds of the drawcalls kept by culling, e.g. as shadow receivers
+		/// @note Call after merging every partial result
+		///
+		/// @return World-space bounds, in drawcall bin order
+		///
+		std::vector<graphics::Aabb> collect_visible_bounds() const noexcept;
+
 		///
 		/// @brief Get maximum z depth
 		///
@@ -64,5 +160,16 @@ namespace render::drawdata
 		///
 		///
 		void sort() noexcept;
+
+	  private:
+
+		void cull_into(
+			const gltf::Drawdata& drawdata,
+			size_t resource_set_index,
+			size_t begin,
+			size_t end,
+			DrawcallBins& bins,
+			float& bins_min_z
+		) const noexcept;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "render/drawdata/gbuffer.hpp"
+#include "render/drawdata/shadow.hpp"
+
+#include <SDL3/SDL_gpu.h>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace render::drawdata
+{
+	///
+	/// @brief Draw commands of the glTF drawcalls of a frame, batched for indirect drawing
+	/// @details
+	/// - Runs of consecutive drawcalls in a bin sharing material, skin and geometry buffers form a batch,
+	/// drawn with one `SDL_DrawGPUIndexedPrimitivesIndirect`
+	/// - Consecutive drawcalls of a batch with the same index range are merged into one command, as instances
+	/// - Draw ids are read per instance from the draw id stream, starting at `first_instance` of a command
+	/// - Batches of a single command are drawn directly, as are instanced drawcalls, which keep their own
+	/// batch without commands
+	/// @note Every primitive owns its geometry buffers, so drawcalls only batch with drawcalls of the same
+	/// primitive, and are drawn directly otherwise
+	///
+	class IndirectDraws
+	{
+	  public:
+
+		struct Batch
+		{
+			uint32_t first_drawcall;  // Position in the bin, the state of this drawcall applies to the batch
+			uint32_t first_command;   // Position in `get_commands()`
+			uint32_t command_count;   // 0 for instanced drawcalls, drawn with their draw id
+		};
+
+		// Drawcall as seen by the batching, see `add`
+		struct Draw
+		{
+			const void* material;       // Material bound for the drawcall
+			size_t resource_set_index;  // Skin and instance resources bound for the drawcall
+			SDL_GPUBufferBinding vertex_buffer;
+			SDL_GPUBufferBinding index_buffer;
+			uint32_t index_count;
+			uint32_t first_index;
+			int32_t vertex_offset;
+			uint32_t draw_id;
+			bool instanced;
+		};
+
+		struct Stats
+		{
+			size_t drawcalls = 0;       // Drawcalls added, stale ones excluded
+			size_t commands = 0;        // Commands after merging
+			size_t direct_draws = 0;    // Batches drawn directly
+			size_t indirect_draws = 0;  // Batches drawn indirectly
+		};
+
+		///
+		/// @brief Create empty draw commands
+		///
+		/// @param memory Memory resource for commands and batches, usually the renderer's frame arena
+		///
+		explicit IndirectDraws(
+			std::pmr::memory_resource* memory = std::pmr::get_default_resource()
+		) noexcept :
+			commands(memory),
+			draw_ids(memory),
+			batches(memory),
+			bin_ranges(memory)
+		{}
+
+		///
+		/// @brief Batch every bin of a G-buffer drawdata
+		/// @note Call after `ObjectData::assign`
+		///
+		/// @param drawdata G-buffer drawdata
+		///
+		void build(const Gbuffer& drawdata) noexcept;
+
+		///
+		/// @brief Batch every bin of a shadow drawdata, static layers included
+		/// @note Call after `ObjectData::assign`
+		///
+		/// @param drawdata Shadow drawdata
+		///
+		void build(const Shadow& drawdata) noexcept;
+
+		///
+		/// @brief Start the batches of a bin, ending the previous one
+		///
+		/// @param bin Address identifying the bin, used by `get_batches`
+		///
+		void begin_bin(const void* bin) noexcept;
+
+		///
+		/// @brief Add the next drawcall of the current bin
+		///
+		/// @param position Position of the drawcall in the bin
+		/// @param draw Drawcall state and geometry
+		///
+		void add(uint32_t position, const Draw& draw) noexcept;
+
+		// End the current bin
+		void end_bin() noexcept;
+
+		///
+		/// @brief Get the batches of a bin, in drawing order
+		/// @note Bins are identified by address, drawdata may be moved after `build` but not copied
+		///
+		/// @param bin Drawcalls of the bin given to `build`
+		/// @return Batches, empty if the bin was not built
+		///
+		template <typename T>
+		std::span<const Batch> get_batches(const std::pmr::vector<T>& bin) const noexcept
+		{
+			return get_batches(static_cast<const void*>(&bin));
+		}
+
+		// Get commands of every batch, to be uploaded as indirect buffer
+		std::span<const SDL_GPUIndexedIndirectDrawCommand> get_commands() const noexcept { return commands; }
+
+		// Get the draw id of every instance of every command, to be uploaded as per-instance vertex buffer
+		std::span<const uint32_t> get_draw_ids() const noexcept { return draw_ids; }
+
+		// Count drawcalls and draws of every bin
+		Stats get_stats() const noexcept;
+
+	  private:
+
+		std::pmr::vector<SDL_GPUIndexedIndirectDrawCommand> commands;
+		std::pmr::vector<uint32_t> draw_ids;
+		std::pmr::vector<Batch> batches;
+		std::pmr::unordered_map<const void*, std::pair<uint32_t, uint32_t>> bin_ranges;  // (first, count)
+
+		const void* current_bin = nullptr;
+		uint32_t current_bin_first = 0;
+		std::optional<Draw> last_draw;
+		size_t drawcall_count = 0;
+
+		std::span<const Batch> get_batches(const void* bin) const noexcept;
+	};
+}
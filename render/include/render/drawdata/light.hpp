@@ -1,10 +1,12 @@
 #pragma once
 
 #include "gltf/light.hpp"
+#include "graphics/light-cluster.hpp"
 #include "render/light-volume.hpp"
 
 #include <SDL3/SDL_gpu.h>
 #include <memory>
+#include <optional>
 
 namespace render::drawdata
 {
@@ -23,5 +25,12 @@ namespace render::drawdata
 			const gltf::Light& light,
 			std::shared_ptr<const LightVolume> volume
 		) noexcept;
+
+		///
+		/// @brief Get the light as seen by the light cluster builder
+		///
+		/// @return Point or spot light in world space, or `std::nullopt` for directional lights
+		///
+		std::optional<graphics::ClusterLight> to_cluster_light() const noexcept;
 	};
 }
\ No newline at end of file
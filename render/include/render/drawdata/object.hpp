@@ -0,0 +1,90 @@
+#pragma once
+
+#include "gltf/model.hpp"
+#include "render/drawdata/gbuffer.hpp"
+#include "render/drawdata/shadow.hpp"
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory_resource>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace render::drawdata
+{
+	///
+	/// @brief Per-object data of the drawcalls of a frame, read by glTF pipelines from one storage buffer
+	/// @details
+	/// - Drawcalls only push their draw id, the index of their entry, instead of transforms and per-object
+	/// parameters
+	/// - G-buffer and shadow drawcalls resolving to the same glTF drawcall share one entry
+	/// - Pure CPU data, uploaded by the renderer
+	///
+	class ObjectData
+	{
+	  public:
+
+		///
+		/// @brief Data of one drawcall
+		/// @details Matches the `Object` struct of `object.glsl`, in std430 layout
+		///
+		struct Entry
+		{
+			glm::mat4 model;            // `Model->World` transform, identity if rigged or instanced
+			glm::mat3x4 normal;         // Inverse transpose of `model`, columns padded like a std430 `mat3`
+			uint32_t joint_offset;      // First joint of the skin in the joint palette, if rigged
+			uint32_t instance_offset;   // First instance in the instance data, if instanced
+			float emissive_multiplier;  // Multiplier of the emissive color
+			uint32_t material_index;    // Index in the material cache, `no_material` for the default one
+
+			static Entry from(const gltf::PrimitiveDrawcall& drawcall) noexcept;
+		};
+
+		static_assert(sizeof(Entry) == 128, "Entry must match the std430 layout of `Object`");
+
+		static constexpr uint32_t no_material = UINT32_MAX;
+
+		///
+		/// @brief Create empty object data
+		///
+		/// @param memory Memory resource for entries, usually the renderer's frame arena
+		///
+		explicit ObjectData(std::pmr::memory_resource* memory = std::pmr::get_default_resource()) noexcept :
+			entries(memory),
+			draw_ids(memory)
+		{}
+
+		///
+		/// @brief Add the entry of a drawcall, or find the one added before
+		///
+		/// @param drawcall glTF drawcall, identified by its address
+		/// @return Draw id of the drawcall
+		///
+		uint32_t add(const gltf::PrimitiveDrawcall& drawcall) noexcept;
+
+		///
+		/// @brief Assign a draw id to every drawcall of a G-buffer drawdata
+		/// @note Call after merging every partial result. Stale drawcalls are skipped, as when drawn.
+		///
+		/// @param drawdata G-buffer drawdata
+		///
+		void assign(Gbuffer& drawdata) noexcept;
+
+		///
+		/// @brief Assign a draw id to every drawcall of a shadow drawdata, static layers included
+		/// @note Call after merging every partial result. Stale drawcalls are skipped, as when drawn.
+		///
+		/// @param drawdata Shadow drawdata
+		///
+		void assign(Shadow& drawdata) noexcept;
+
+		// Get entries in draw id order
+		std::span<const Entry> get_entries() const noexcept { return entries; }
+
+	  private:
+
+		std::pmr::vector<Entry> entries;
+		std::pmr::unordered_map<const gltf::PrimitiveDrawcall*, uint32_t> draw_ids;
+	};
+}
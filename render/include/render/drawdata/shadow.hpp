@@ -2,29 +2,66 @@
 
 #include "gltf/material.hpp"
 #include "gltf/model.hpp"
+#include "graphics/shadow-schedule.hpp"
 #include "graphics/smallest-bound.hpp"
 
+#include <map>
+#include <memory_resource>
+#include <vector>
+
 namespace render::drawdata
 {
 	struct Shadow
 	{
 		struct Drawcall
 		{
-			gltf::PrimitiveDrawcall drawcall;
+			gltf::DrawcallHandle drawcall;  // Resolved with `Resource::drawcalls`
 			size_t resource_set_index;
 			float min_z;
+			uint32_t draw_id = 0;  // Index in the object data of the frame, see `ObjectData::assign`
+
+			// Primitive of the drawcall in its model, drawcalls sharing it are sorted together to be batched
+			uint32_t geometry_index = 0;
 		};
 
 		struct Resource
 		{
 			gltf::MaterialCache::Ref material_cache;
 			std::shared_ptr<gltf::DeferredSkinningResource> deferred_skinning_resource;
+			std::shared_ptr<gltf::DeferredInstanceResource> deferred_instance_resource;
+			gltf::DrawcallList drawcalls;
+			std::pmr::vector<uint8_t> static_visible;  // From `DrawcallList::cull_static`
+		};
+
+		using DrawcallBins = std::pmr::map<std::pair<gltf::PipelineMode, bool>, std::pmr::vector<Drawcall>>;
+		using Action = graphics::ShadowCascadeCache::Action;
+
+		// Decision counters of a frame
+		struct Stats
+		{
+			std::array<uint32_t, 3> actions = {};  // Cached levels per action, indexed by `Action`
+			uint32_t uncached_levels = 0;          // Levels drawn entirely every frame
+			size_t casters = 0;                    // Casters drawn, over all levels and layers
+			size_t receiver_culled = 0;            // Casters dropped for shadowing no visible receiver
 		};
 
 		struct ShadowLevelData
 		{
-			std::map<std::pair<gltf::PipelineMode, bool>, std::vector<Drawcall>> drawcalls;
-			std::vector<Resource> resource_sets;
+			///
+			/// @brief Culling result of a drawcall range
+			/// @details Produced by `cull` independently of other ranges, then combined with `merge`
+			///
+			struct Partial
+			{
+				DrawcallBins drawcalls;
+				float near = std::numeric_limits<float>::max();
+				float far = std::numeric_limits<float>::lowest();
+				size_t receiver_culled = 0;
+			};
+
+			DrawcallBins drawcalls;         // Drawn into the shadow map, only dynamic casters if cached
+			DrawcallBins static_drawcalls;  // Drawn into the static layer, only filled by `merge_static`
+			std::pmr::vector<Resource> resource_sets;
 
 			graphics::SmallestBound smallest_bound;
 			std::array<glm::vec4, 4> frustum_planes;
@@ -32,11 +69,65 @@ namespace render::drawdata
 			float near = std::numeric_limits<float>::max();
 			float far = std::numeric_limits<float>::lowest();
 
+			// Static casters are kept in a static layer, see `graphics::ShadowCascadeCache`
+			bool cached = false;
+			Action action = Action::Rebuild;  // Update of a cached level, set by the renderer
+
+			// Optional, casters shadowing no receiver are culled. Static casters of cached levels are kept.
+			const graphics::ShadowReceiverMask* receiver_mask = nullptr;
+			size_t receiver_culled = 0;
+
+			explicit ShadowLevelData(std::pmr::memory_resource* memory) noexcept :
+				drawcalls(memory),
+				static_drawcalls(memory),
+				resource_sets(memory)
+			{}
+
 			void append(const gltf::Drawdata& drawdata) noexcept;
 
+			// Register resources of a glTF drawdata, return the resource set index used by `cull`
+			size_t add_resource_set(const gltf::Drawdata& drawdata) noexcept;
+
+			// Cull drawcalls in `[begin, end)`, concurrent calls with distinct `partial` are safe
+			void cull(
+				const gltf::Drawdata& drawdata,
+				size_t resource_set_index,
+				size_t begin,
+				size_t end,
+				Partial& partial
+			) const noexcept;
+
+			// Append a partial result, merging in range order yields the same order as `append`
+			void merge(const Partial& partial) noexcept;
+
+			// Cull static casters of a cached level, when its static layer is rebuilt. Only touches storage
+			// reserved by `add_resource_set`, so levels can be culled concurrently with distinct `partial`.
+			void cull_static(
+				const gltf::Drawdata& drawdata,
+				size_t resource_set_index,
+				Partial& partial
+			) noexcept;
+
+			// Append a partial result of `cull_static` to `static_drawcalls`
+			void merge_static(const Partial& partial) noexcept;
+
+			// Set the light-space bound and the frustum planes derived from it
+			void set_bound(const graphics::SmallestBound& bound) noexcept;
+
 			glm::mat4 get_vp_matrix() const noexcept;
 
 			void sort() noexcept;
+
+		  private:
+
+			void cull_into(
+				const gltf::Drawdata& drawdata,
+				size_t resource_set_index,
+				size_t begin,
+				size_t end,
+				bool static_layer,
+				Partial& partial
+			) const noexcept;
 		};
 
 		std::array<ShadowLevelData, 3> csm_levels;
@@ -48,11 +139,39 @@ namespace render::drawdata
 		/// @param light_direction Light direction
 		/// @param min_z Minimum Z in view space
 		/// @param linear_blend_ratio Linear blend ratio for CSM levels
+		/// @param memory Memory resource for drawcall containers
 		///
 		Shadow(
 			const glm::mat4& camera_matrix,
 			const glm::vec3& light_direction,
 			float min_z,
+			float linear_blend_ratio,
+			std::pmr::memory_resource* memory = std::pmr::get_default_resource()
+		) noexcept;
+
+		///
+		/// @brief Create a drawdata for cached shadow rendering
+		/// @note Levels are marked cached, their actions are set by the renderer after culling
+		///
+		/// @param bounds Light-space bound of each CSM level, from `graphics::ShadowCascadeCache::fit`
+		/// @param memory Memory resource for drawcall containers
+		///
+		Shadow(
+			const std::array<graphics::SmallestBound, 3>& bounds,
+			std::pmr::memory_resource* memory = std::pmr::get_default_resource()
+		) noexcept;
+
+		///
+		/// @brief Compute the camera frustum slice covered by each CSM level
+		///
+		/// @param camera_matrix Camera matrix
+		/// @param min_z Minimum Z in view space
+		/// @param linear_blend_ratio Linear blend ratio for CSM levels
+		/// @return World-space corners of each slice
+		///
+		static std::array<std::array<glm::vec3, 8>, 3> compute_slice_corners(
+			const glm::mat4& camera_matrix,
+			float min_z,
 			float linear_blend_ratio
 		) noexcept;
 
@@ -76,5 +195,12 @@ namespace render::drawdata
 		///
 		///
 		void sort() noexcept;
+
+		///
+		/// @brief Count the decisions of this frame
+		///
+		/// @return Decision counters
+		///
+		Stats get_stats() const noexcept;
 	};
 }
\ No newline at end of file
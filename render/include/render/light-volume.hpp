@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gpu/buffer.hpp"
+#include "graphics/convex-hull.hpp"
 #include <glm/glm.hpp>
 #include <wavefront.hpp>
 
@@ -13,8 +14,7 @@ namespace render
 
 		glm::vec3 min, max;  // min/max of position, local space
 
-		std::vector<glm::vec3> tri_positions;
-		std::vector<glm::vec3> tri_normals;
+		graphics::ConvexHull hull;  // Local space, precomputed for containment and culling tests
 
 		static std::expected<LightVolume, util::Error> from_model(
 			SDL_GPUDevice* device,
@@ -24,6 +24,7 @@ namespace render
 
 		///
 		/// @brief Calculate whether camera is inside the volume
+		/// @note Tests against the convex hull, a concave volume is treated as its hull
 		///
 		/// @param local_eye_position Eye position in local space
 		/// @return `true` if camera is inside the volume
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "gltf/joint-palette.hpp"
+#include "graphics/portal.hpp"
+
 #include <glm/glm.hpp>
 
 namespace render
@@ -56,11 +59,20 @@ namespace render
 	{
 		bool ssgi = true;
 		bool use_bloom_mask = true;
+		bool occlusion_culling = true;
+		bool shadow_caching = true;
+		bool light_clustering = false;
+
+		// Scale the render size to keep frame times under `DYNAMIC_RESOLUTION_TARGET_FRAME_TIME`. Targets
+		// keep the full size, passes render into the scaled region of them. Frame times are capped by vsync,
+		// headroom under the refresh interval can't be measured then.
+		bool dynamic_resolution = false;
 	};
 
 	struct Params
 	{
 		AntialiasMode aa_mode = AntialiasMode::MLAA;
+		gltf::JointPalette joint_palette = gltf::JointPalette::Affine;
 		CameraMatrices camera;
 		PrimaryLightParams primary_light;
 		AmbientParams ambient = {};
@@ -68,5 +80,6 @@ namespace render
 		ShadowParams shadow = {};
 		SkyParams sky = {};
 		FunctionMask function_mask = {};
+		graphics::PortalVisibility portal_visibility = {};  // Unrestricted by default
 	};
 }
\ No newline at end of file
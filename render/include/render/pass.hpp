@@ -7,6 +7,8 @@
 #include "render/target/light.hpp"
 #include "render/target/shadow.hpp"
 
+#include <glm/glm.hpp>
+
 namespace render
 {
 	///
@@ -25,12 +27,14 @@ namespace render
 	/// @param command_buffer Command Buffer
 	/// @param gbuffer G-buffer Target
 	/// @param light_buffer Light Buffer Target
+	/// @param region Rendered region at the top-left corner of the targets
 	/// @return Acquired Render Pass
 	///
 	std::expected<gpu::RenderPass, util::Error> acquire_gbuffer_pass(
 		const gpu::CommandBuffer& command_buffer,
 		const target::Gbuffer& gbuffer,
-		const target::LightBuffer& light_buffer
+		const target::LightBuffer& light_buffer,
+		glm::u32vec2 region
 	) noexcept;
 
 	///
@@ -43,12 +47,14 @@ namespace render
 	///
 	/// @param command_buffer Command Buffer
 	/// @param light_buffer Light Buffer Target
+	/// @param region Rendered region at the top-left corner of the targets
 	/// @return Acquired Render Pass
 	///
 	std::expected<gpu::RenderPass, util::Error> acquire_lighting_pass(
 		const gpu::CommandBuffer& command_buffer,
 		const target::LightBuffer& light_buffer,
-		const target::Gbuffer& gbuffer
+		const target::Gbuffer& gbuffer,
+		glm::u32vec2 region
 	) noexcept;
 
 	///
@@ -57,16 +63,21 @@ namespace render
 	/// @details
 	/// #### Layout
 	/// Depth-Stencil Attachment:
-	/// 1. Depth Texture, from Shadow Target
+	/// 1. Depth Texture or Static Layer Texture, from Shadow Target
 	///
 	/// @param command_buffer Command Buffer
 	/// @param shadow_target Shadow Target
+	/// @param level CSM level index
+	/// @param layer Layer to render into
+	/// @param clear Clear the layer, otherwise draw over its content
 	/// @return Acquired Render Pass
 	///
 	std::expected<gpu::RenderPass, util::Error> acquire_shadow_pass(
 		const gpu::CommandBuffer& command_buffer,
 		const target::Shadow& shadow_target,
-		size_t level
+		size_t level,
+		target::Shadow::Layer layer = target::Shadow::Layer::Map,
+		bool clear = true
 	) noexcept;
 
 	///
@@ -79,11 +90,13 @@ namespace render
 	///
 	/// @param command_buffer Command Buffer
 	/// @param ao_target AO Target
+	/// @param region Rendered region at the top-left corner of the half-resolution AO texture
 	/// @return Acquired Render Pass
 	///
 	std::expected<gpu::RenderPass, util::Error> acquire_ao_pass(
 		const gpu::CommandBuffer& command_buffer,
-		const target::AO& ao_target
+		const target::AO& ao_target,
+		glm::u32vec2 region
 	) noexcept;
 
 	///
@@ -47,6 +47,7 @@ namespace render::pipeline
 			SDL_GPUTexture* source,
 			SDL_GPUTexture* target,
 			glm::u32vec2 size,
+			glm::u32vec2 region,
 			AntialiasMode mode
 		) noexcept;
 	};
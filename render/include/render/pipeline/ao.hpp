@@ -22,6 +22,8 @@ namespace render::pipeline
 			glm::mat4 prev_camera_mat;
 			float radius;
 			float blend_alpha;
+			glm::vec2 render_size;       // Full-resolution region at the top-left corner of the targets
+			glm::vec2 prev_render_size;  // Region of the previous frame, in the history textures
 		};
 
 		static std::expected<AO, util::Error> create(SDL_GPUDevice* device) noexcept;
@@ -45,6 +47,8 @@ namespace render::pipeline
 			alignas(4) float random_seed;
 			alignas(4) float radius;
 			alignas(4) float blend_alpha;
+			alignas(8) glm::vec2 render_size;
+			alignas(8) glm::vec2 prev_render_size;
 
 			static UniformParams from(const Params& params) noexcept;
 		};
@@ -45,12 +45,21 @@ namespace render::pipeline
 			{}
 		};
 
+		struct BlurParam
+		{
+			glm::u32vec2 region_size;  // Rendered region of the mip, at its top-left corner
+		};
+
 		struct AddParam
 		{
 			float attenuation;
+			alignas(8) glm::u32vec2 region_size;  // Rendered region of the upsampled mip
+			glm::u32vec2 prev_region_size;        // Rendered region of the smaller mip added to it
 
-			AddParam(const Param& param) :
-				attenuation(param.attenuation)
+			AddParam(const Param& param, glm::u32vec2 region_size, glm::u32vec2 prev_region_size) :
+				attenuation(param.attenuation),
+				region_size(region_size),
+				prev_region_size(prev_region_size)
 			{}
 		};
 
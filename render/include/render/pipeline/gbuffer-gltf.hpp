@@ -7,6 +7,7 @@
 #include "gpu/graphics-pipeline.hpp"
 #include "gpu/render-pass.hpp"
 #include "render/drawdata/gbuffer.hpp"
+#include "render/drawdata/indirect.hpp"
 #include "render/pipeline/gltf-pipeline.hpp"
 
 #include <expected>
@@ -15,8 +16,13 @@ namespace render::pipeline
 {
 	class GbufferGLTF
 	{
+		using PipelineMap = std::map<std::pair<gltf::PipelineMode, bool>, std::unique_ptr<PipelineGLTF>>;
+
 		// (Pipeline Mode, Rigged) -> Pipeline Instance
-		std::map<std::pair<gltf::PipelineMode, bool>, std::unique_ptr<PipelineGLTF>> pipelines;
+		PipelineMap pipelines;
+
+		// (Pipeline Mode, Rigged) -> Pipeline Instance, for instanced drawcalls
+		PipelineMap instanced_pipelines;
 
 		struct alignas(64) Frag_param
 		{
@@ -27,21 +33,15 @@ namespace render::pipeline
 			alignas(4) float normal_scale;
 			alignas(4) float alpha_cutoff;
 			alignas(4) float occlusion_strength;
+			alignas(4) uint32_t orm_packed;
+			alignas(4) uint32_t metallic_roughness_single_channel;
 
 			static Frag_param from(const gltf::MaterialParams::Factor& factor) noexcept;
 		};
 
-		struct PerObjectParam
-		{
-			alignas(4) float emissive_multiplier;
-
-			static PerObjectParam from(const gltf::PrimitiveDrawcall& drawcall) noexcept;
-		};
-
-		GbufferGLTF(
-			std::map<std::pair<gltf::PipelineMode, bool>, std::unique_ptr<PipelineGLTF>> pipelines
-		) noexcept :
-			pipelines(std::move(pipelines))
+		GbufferGLTF(PipelineMap pipelines, PipelineMap instanced_pipelines) noexcept :
+			pipelines(std::move(pipelines)),
+			instanced_pipelines(std::move(instanced_pipelines))
 		{}
 
 		class PipelineNormal : public PipelineGLTF
@@ -64,7 +64,8 @@ namespace render::pipeline
 			void bind(
 				const gpu::CommandBuffer& command_buffer,
 				const gpu::RenderPass& render_pass,
-				const glm::mat4& camera_matrix
+				const glm::mat4& camera_matrix,
+				const gpu::Buffer& object_buffer
 			) const noexcept override;
 
 			void set_material(
@@ -74,14 +75,31 @@ namespace render::pipeline
 			) const noexcept override;
 
 			void set_skin(
+				const gpu::CommandBuffer& command_buffer,
 				const gpu::RenderPass& render_pass,
 				const gltf::DeferredSkinningResource& skinning_resource
 			) const noexcept override;
 
+			void set_instances(
+				const gpu::CommandBuffer& command_buffer,
+				const gpu::RenderPass& render_pass,
+				const gltf::DeferredInstanceResource& instance_resource
+			) const noexcept override;
+
 			void draw(
 				const gpu::CommandBuffer& command_buffer,
 				const gpu::RenderPass& render_pass,
-				const gltf::PrimitiveDrawcall& drawcall
+				const gltf::PrimitiveDrawcall& drawcall,
+				uint32_t draw_id
+			) const noexcept override;
+
+			void draw_commands(
+				const gpu::CommandBuffer& command_buffer,
+				const gpu::RenderPass& render_pass,
+				const gltf::PrimitiveDrawcall& drawcall,
+				std::span<const SDL_GPUIndexedIndirectDrawCommand> commands,
+				uint32_t first_command,
+				const GltfFrameBuffers& buffers
 			) const noexcept override;
 		};
 
@@ -105,7 +123,8 @@ namespace render::pipeline
 			void bind(
 				const gpu::CommandBuffer& command_buffer,
 				const gpu::RenderPass& render_pass,
-				const glm::mat4& camera_matrix
+				const glm::mat4& camera_matrix,
+				const gpu::Buffer& object_buffer
 			) const noexcept override;
 
 			void set_material(
@@ -115,14 +134,31 @@ namespace render::pipeline
 			) const noexcept override;
 
 			void set_skin(
+				const gpu::CommandBuffer& command_buffer,
 				const gpu::RenderPass& render_pass,
 				const gltf::DeferredSkinningResource& skinning_resource
 			) const noexcept override;
 
+			void set_instances(
+				const gpu::CommandBuffer& command_buffer,
+				const gpu::RenderPass& render_pass,
+				const gltf::DeferredInstanceResource& instance_resource
+			) const noexcept override;
+
 			void draw(
 				const gpu::CommandBuffer& command_buffer,
 				const gpu::RenderPass& render_pass,
-				const gltf::PrimitiveDrawcall& drawcall
+				const gltf::PrimitiveDrawcall& drawcall,
+				uint32_t draw_id
+			) const noexcept override;
+
+			void draw_commands(
+				const gpu::CommandBuffer& command_buffer,
+				const gpu::RenderPass& render_pass,
+				const gltf::PrimitiveDrawcall& drawcall,
+				std::span<const SDL_GPUIndexedIndirectDrawCommand> commands,
+				uint32_t first_command,
+				const GltfFrameBuffers& buffers
 			) const noexcept override;
 		};
 
@@ -135,10 +171,21 @@ namespace render::pipeline
 
 		static std::expected<GbufferGLTF, util::Error> create(SDL_GPUDevice* device) noexcept;
 
+		///
+		/// @brief Render G-buffer drawcalls
+		///
+		/// @param command_buffer Command buffer
+		/// @param gbuffer_pass G-buffer render pass
+		/// @param drawdata G-buffer drawdata, with draw ids assigned
+		/// @param indirect_draws Draw commands of the frame, built from `drawdata`
+		/// @param buffers Buffers of the frame
+		///
 		void render(
 			const gpu::CommandBuffer& command_buffer,
 			const gpu::RenderPass& gbuffer_pass,
-			const drawdata::Gbuffer& drawdata
+			const drawdata::Gbuffer& drawdata,
+			const drawdata::IndirectDraws& indirect_draws,
+			const GltfFrameBuffers& buffers
 		) const noexcept;
 	};
 }
\ No newline at end of file
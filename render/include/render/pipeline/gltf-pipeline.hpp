@@ -1,13 +1,62 @@
 #pragma once
 
+#include "gltf/instance.hpp"
 #include "gltf/material.hpp"
 #include "gltf/model.hpp"
 #include "gltf/skin.hpp"
+#include "gpu/buffer.hpp"
 #include "gpu/command-buffer.hpp"
 #include "gpu/render-pass.hpp"
 
+#include <SDL3/SDL_gpu.h>
+#include <span>
+
 namespace render::pipeline
 {
+	// Buffers of the frame read by glTF pipelines
+	struct GltfFrameBuffers
+	{
+		const gpu::Buffer& objects;   // Object data, see `drawdata::ObjectData`
+		const gpu::Buffer& draw_ids;  // Draw id stream, see `drawdata::IndirectDraws`
+		const gpu::Buffer& commands;  // Indirect draw commands, see `drawdata::IndirectDraws`
+	};
+
+	///
+	/// @brief Get the vertex buffer description of the draw id stream, at buffer slot 1
+	/// @details Single drawcalls read their draw id per instance, so that the instances of one command,
+	/// started at its `first_instance`, draw different drawcalls
+	///
+	/// @return Vertex buffer description
+	///
+	SDL_GPUVertexBufferDescription get_draw_id_buffer_desc() noexcept;
+
+	///
+	/// @brief Get the vertex attribute of the draw id, read from the draw id stream
+	///
+	/// @param location Location of `in_draw_id` in the vertex shader, after the vertex attributes
+	/// @return Vertex attribute
+	///
+	SDL_GPUVertexAttribute get_draw_id_attribute(uint32_t location) noexcept;
+
+	///
+	/// @brief Draw a batch of commands sharing one geometry, for implementations of `draw_commands`
+	///
+	/// @param render_pass Render pass
+	/// @param vertex_buffer Vertex buffer of the geometry
+	/// @param index_buffer Index buffer of the geometry, 32-bit indices
+	/// @param commands Commands of the batch
+	/// @param first_command Position of the first command in the command buffer
+	/// @param buffers Buffers of the frame
+	///
+	void draw_gltf_commands(
+		const gpu::RenderPass& render_pass,
+		const SDL_GPUBufferBinding& vertex_buffer,
+		const SDL_GPUBufferBinding& index_buffer,
+		std::span<const SDL_GPUIndexedIndirectDrawCommand> commands,
+		uint32_t first_command,
+		const GltfFrameBuffers& buffers
+	) noexcept;
+
 	///
 	/// @brief Interface for Gbuffer glTF pipelines
 	///
@@ -24,11 +73,13 @@ namespace render::pipeline
 		/// @param command_buffer Command buffer
 		/// @param render_pass Render pass
 		/// @param camera_matrix Camera matrix
+		/// @param object_buffer Object data of the frame, see `drawdata::ObjectData`
 		///
 		virtual void bind(
 			const gpu::CommandBuffer& command_buffer,
 			const gpu::RenderPass& render_pass,
-			const glm::mat4& camera_matrix
+			const glm::mat4& camera_matrix,
+			const gpu::Buffer& object_buffer
 		) const noexcept = 0;
 
 		///
@@ -45,27 +96,69 @@ namespace render::pipeline
 		) const noexcept = 0;
 
 		///
-		/// @brief Set a skinning resource for the pipeline
+		/// @brief Set a skinning resource for the pipeline, with its joint palette encoding
 		///
+		/// @param command_buffer Command buffer
 		/// @param render_pass Render pass
 		/// @param skinning_resource Skinning resource
 		///
 		virtual void set_skin(
+			const gpu::CommandBuffer& command_buffer,
 			const gpu::RenderPass& render_pass,
 			const gltf::DeferredSkinningResource& skinning_resource
 		) const noexcept = 0;
 
 		///
-		/// @brief Draw the primitive drawcall
+		/// @brief Set the per-instance data read by instanced drawcalls
+		/// @note Only called on pipelines created for instanced drawcalls
+		///
+		/// @param command_buffer Command buffer
+		/// @param render_pass Render pass
+		/// @param instance_resource Instance resource
+		///
+		virtual void set_instances(
+			const gpu::CommandBuffer& command_buffer,
+			const gpu::RenderPass& render_pass,
+			const gltf::DeferredInstanceResource& instance_resource
+		) const noexcept = 0;
+
+		///
+		/// @brief Draw an instanced primitive drawcall with all of its instances
+		/// @details Transforms and per-object parameters are read from the object data at `draw_id`
+		/// @note Only called on pipelines created for instanced drawcalls
 		///
 		/// @param command_buffer Command buffer
 		/// @param render_pass Render pass
 		/// @param drawcall Primitive drawcall
+		/// @param draw_id Index of the drawcall in the object data
 		///
 		virtual void draw(
 			const gpu::CommandBuffer& command_buffer,
 			const gpu::RenderPass& render_pass,
-			const gltf::PrimitiveDrawcall& drawcall
+			const gltf::PrimitiveDrawcall& drawcall,
+			uint32_t draw_id
+		) const noexcept = 0;
+
+		///
+		/// @brief Draw a batch of single drawcalls sharing the geometry of `drawcall`
+		/// @details Draw ids are read per instance from the draw id stream. A batch of one command is drawn
+		/// directly, larger ones with one indirect draw.
+		/// @note Only called on pipelines created for single drawcalls
+		///
+		/// @param command_buffer Command buffer
+		/// @param render_pass Render pass
+		/// @param drawcall First drawcall of the batch
+		/// @param commands Commands of the batch
+		/// @param first_command Position of the first command in the command buffer
+		/// @param buffers Buffers of the frame
+		///
+		virtual void draw_commands(
+			const gpu::CommandBuffer& command_buffer,
+			const gpu::RenderPass& render_pass,
+			const gltf::PrimitiveDrawcall& drawcall,
+			std::span<const SDL_GPUIndexedIndirectDrawCommand> commands,
+			uint32_t first_command,
+			const GltfFrameBuffers& buffers
 		) const noexcept = 0;
 	};
 }
\ No newline at end of file
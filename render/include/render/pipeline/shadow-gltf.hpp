@@ -5,6 +5,7 @@
 #include "gpu/command-buffer.hpp"
 #include "gpu/graphics-pipeline.hpp"
 #include "gpu/render-pass.hpp"
+#include "render/drawdata/indirect.hpp"
 #include "render/drawdata/shadow.hpp"
 #include "render/pipeline/gltf-pipeline.hpp"
 #include "render/target/shadow.hpp"
@@ -13,13 +14,17 @@ namespace render::pipeline
 {
 	class ShadowGLTF
 	{
+		using PipelineMap = std::map<std::pair<gltf::PipelineMode, bool>, std::unique_ptr<PipelineGLTF>>;
+
 		// (Pipeline Mode, Rigged) -> Pipeline Instance
-		std::map<std::pair<gltf::PipelineMode, bool>, std::unique_ptr<PipelineGLTF>> pipelines;
+		PipelineMap pipelines;
+
+		// (Pipeline Mode, Rigged) -> Pipeline Instance, for instanced drawcalls
+		PipelineMap instanced_pipelines;
 
-		ShadowGLTF(
-			std::map<std::pair<gltf::PipelineMode, bool>, std::unique_ptr<PipelineGLTF>> pipelines
-		) noexcept :
-			pipelines(std::move(pipelines))
+		ShadowGLTF(PipelineMap pipelines, PipelineMap instanced_pipelines) noexcept :
+			pipelines(std::move(pipelines)),
+			instanced_pipelines(std::move(instanced_pipelines))
 		{}
 
 		struct FragParam
@@ -48,7 +53,8 @@ namespace render::pipeline
 			void bind(
 				const gpu::CommandBuffer& command_buffer,
 				const gpu::RenderPass& render_pass,
-				const glm::mat4& camera_matrix
+				const glm::mat4& camera_matrix,
+				const gpu::Buffer& object_buffer
 			) const noexcept override;
 
 			void set_material(
@@ -58,14 +64,31 @@ namespace render::pipeline
 			) const noexcept override;
 
 			void set_skin(
+				const gpu::CommandBuffer& command_buffer,
 				const gpu::RenderPass& render_pass,
 				const gltf::DeferredSkinningResource& skinning_resource
 			) const noexcept override;
 
+			void set_instances(
+				const gpu::CommandBuffer& command_buffer,
+				const gpu::RenderPass& render_pass,
+				const gltf::DeferredInstanceResource& instance_resource
+			) const noexcept override;
+
 			void draw(
 				const gpu::CommandBuffer& command_buffer,
 				const gpu::RenderPass& render_pass,
-				const gltf::PrimitiveDrawcall& drawcall
+				const gltf::PrimitiveDrawcall& drawcall,
+				uint32_t draw_id
+			) const noexcept override;
+
+			void draw_commands(
+				const gpu::CommandBuffer& command_buffer,
+				const gpu::RenderPass& render_pass,
+				const gltf::PrimitiveDrawcall& drawcall,
+				std::span<const SDL_GPUIndexedIndirectDrawCommand> commands,
+				uint32_t first_command,
+				const GltfFrameBuffers& buffers
 			) const noexcept override;
 		};
 
@@ -89,7 +112,8 @@ namespace render::pipeline
 			void bind(
 				const gpu::CommandBuffer& command_buffer,
 				const gpu::RenderPass& render_pass,
-				const glm::mat4& camera_matrix
+				const glm::mat4& camera_matrix,
+				const gpu::Buffer& object_buffer
 			) const noexcept override;
 
 			void set_material(
@@ -99,14 +123,31 @@ namespace render::pipeline
 			) const noexcept override;
 
 			void set_skin(
+				const gpu::CommandBuffer& command_buffer,
 				const gpu::RenderPass& render_pass,
 				const gltf::DeferredSkinningResource& skinning_resource
 			) const noexcept override;
 
+			void set_instances(
+				const gpu::CommandBuffer& command_buffer,
+				const gpu::RenderPass& render_pass,
+				const gltf::DeferredInstanceResource& instance_resource
+			) const noexcept override;
+
 			void draw(
 				const gpu::CommandBuffer& command_buffer,
 				const gpu::RenderPass& render_pass,
-				const gltf::PrimitiveDrawcall& drawcall
+				const gltf::PrimitiveDrawcall& drawcall,
+				uint32_t draw_id
+			) const noexcept override;
+
+			void draw_commands(
+				const gpu::CommandBuffer& command_buffer,
+				const gpu::RenderPass& render_pass,
+				const gltf::PrimitiveDrawcall& drawcall,
+				std::span<const SDL_GPUIndexedIndirectDrawCommand> commands,
+				uint32_t first_command,
+				const GltfFrameBuffers& buffers
 			) const noexcept override;
 		};
 
@@ -119,10 +160,46 @@ namespace render::pipeline
 
 		static std::expected<ShadowGLTF, util::Error> create(SDL_GPUDevice* device) noexcept;
 
+		///
+		/// @brief Render shadow maps of every CSM level
+		/// @details Uncached levels are drawn entirely. Cached levels follow their action: the static
+		/// layer is redrawn on rebuild, then copied into the shadow map with dynamic casters drawn over it.
+		/// Skipped levels keep the shadow map of a previous frame.
+		///
+		/// @param command_buffer Command buffer
+		/// @param shadow_target Shadow target
+		/// @param drawdata Shadow drawdata, with draw ids assigned
+		/// @param indirect_draws Draw commands of the frame, built from `drawdata`
+		/// @param buffers Buffers of the frame
+		///
 		std::expected<void, util::Error> render(
 			const gpu::CommandBuffer& command_buffer,
 			const target::Shadow& shadow_target,
-			const drawdata::Shadow& drawdata
+			const drawdata::Shadow& drawdata,
+			const drawdata::IndirectDraws& indirect_draws,
+			const GltfFrameBuffers& buffers
+		) const noexcept;
+
+	  private:
+
+		void render_drawcalls(
+			const gpu::CommandBuffer& command_buffer,
+			const gpu::RenderPass& shadow_pass,
+			const drawdata::Shadow::ShadowLevelData& level_data,
+			const drawdata::Shadow::DrawcallBins& drawcall_bins,
+			const drawdata::IndirectDraws& indirect_draws,
+			const GltfFrameBuffers& buffers
+		) const noexcept;
+
+		std::expected<void, util::Error> render_layer(
+			const gpu::CommandBuffer& command_buffer,
+			const target::Shadow& shadow_target,
+			const drawdata::Shadow::ShadowLevelData& level_data,
+			size_t level,
+			target::Shadow::Layer layer,
+			bool clear,
+			const drawdata::IndirectDraws& indirect_draws,
+			const GltfFrameBuffers& buffers
 		) const noexcept;
 	};
 }
\ No newline at end of file
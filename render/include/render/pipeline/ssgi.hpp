@@ -27,10 +27,16 @@ namespace render::pipeline
 			glm::mat4 prev_view_proj_mat;  // Previous frame view-projection matrix
 			float max_scene_distance;      // farthest viewable distance in the scene
 			float distance_attenuation;    // attenuation factor for distance
+			bool history_valid;            // Previous frame textures are kept, targets weren't reallocated
+			glm::u32vec2 prev_resolution;  // Region of the previous frame, in the history textures
 		};
 
 		static std::expected<SSGI, util::Error> create(SDL_GPUDevice* device) noexcept;
 
+		///
+		/// @brief Trace indirect radiance into the full resolution radiance texture of the SSGI target
+		/// @note Call `render_radiance_add` to add it to the light buffer
+		///
 		std::expected<void, util::Error> render(
 			const gpu::CommandBuffer& command_buffer,
 			const target::LightBuffer& light_buffer,
@@ -40,6 +46,14 @@ namespace render::pipeline
 			glm::u32vec2 resolution
 		) const noexcept;
 
+		// Add the radiance traced by `render` to the light buffer
+		std::expected<void, util::Error> render_radiance_add(
+			const gpu::CommandBuffer& command_buffer,
+			const target::LightBuffer& light_buffer,
+			const target::SSGI& ssgi_target,
+			glm::u32vec2 resolution
+		) const noexcept;
+
 	  private:
 
 		struct InitialTemporalParam
@@ -60,6 +74,8 @@ namespace render::pipeline
 			float near_plane;
 			float max_scene_distance;    // farthest viewable distance in the scene
 			float distance_attenuation;  // attenuation factor for distance
+			uint32_t history_valid;      // Reproject previous frame reservoirs if non-zero
+			alignas(8) glm::uvec2 prev_resolution;
 
 			static InitialTemporalParam from_param(const Param& param, const glm::uvec2& resolution) noexcept;
 		};
@@ -78,7 +94,9 @@ namespace render::pipeline
 			glm::uvec2 full_resolution;
 			glm::vec2 near_plane_span;
 			float near_plane;
-			glm::ivec2 time_noise;
+			alignas(8) glm::ivec2 time_noise;  // Aligned like std140, glm vectors are only 4-byte aligned
+			uint32_t history_valid;            // Reuse previous frame reservoirs if non-zero
+			alignas(8) glm::uvec2 prev_resolution;
 
 			static SpatialReuseParam from_param(const Param& param, const glm::uvec2& resolution) noexcept;
 		};
@@ -92,6 +110,8 @@ namespace render::pipeline
 			glm::uvec2 comp_resolution;
 			glm::uvec2 full_resolution;
 			float blend_factor;
+			uint32_t history_valid;  // Blend with previous frame radiance if non-zero
+			alignas(8) glm::uvec2 prev_resolution;
 
 			static RadianceCompositeParam from_param(const Param& param, glm::u32vec2 resolution) noexcept;
 		};
@@ -165,13 +185,6 @@ namespace render::pipeline
 			glm::u32vec2 resolution
 		) const noexcept;
 
-		std::expected<void, util::Error> render_radiance_add(
-			const gpu::CommandBuffer& command_buffer,
-			const target::LightBuffer& light_buffer,
-			const target::SSGI& ssgi_target,
-			glm::u32vec2 resolution
-		) const noexcept;
-
 		SSGI(
 			gpu::ComputePipeline ssgi_pipeline,
 			gpu::ComputePipeline spatial_reuse_pipeline,
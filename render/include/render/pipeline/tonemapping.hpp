@@ -21,6 +21,7 @@ namespace render::pipeline
 			float exposure = 1.0f;
 			float bloom_strength = 1.0f;
 			bool use_bloom_mask;
+			alignas(8) glm::u32vec2 render_size;  // Rendered region at the top-left corner of the targets
 		};
 
 		static std::expected<Tonemapping, util::Error> create(
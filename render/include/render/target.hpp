@@ -22,11 +22,17 @@ namespace render
 		target::Bloom bloom_target;
 		target::SSGI ssgi_target;
 
-		static std::expected<Target, util::Error> create(SDL_GPUDevice* device) noexcept;
+		static std::expected<Target, util::Error> create(
+			SDL_GPUDevice* device,
+			SDL_GPUTextureFormat swapchain_format
+		) noexcept;
 
+		// Resize or cycle every target to the target size, textures are acquired from and returned to pool.
+		// Passes render into the top-left region of the targets, sized by the render size.
 		std::expected<void, util::Error> resize_or_cycle(
 			SDL_GPUDevice* device,
-			glm::u32vec2 swapchain_size
+			graphics::TexturePool& pool,
+			glm::u32vec2 target_size
 		) noexcept;
 	};
 }
\ No newline at end of file
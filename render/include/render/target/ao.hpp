@@ -18,6 +18,10 @@ namespace render::target
 		graphics::CycleTexture halfres_ao_texture{ao_format, "AO Texture"};  // Ambient Occlusion Texture
 
 		// Resize all textures
-		std::expected<void, util::Error> cycle(SDL_GPUDevice* device, glm::u32vec2 size) noexcept;
+		std::expected<void, util::Error> cycle(
+			SDL_GPUDevice* device,
+			graphics::TexturePool& pool,
+			glm::u32vec2 size
+		) noexcept;
 	};
 }
\ No newline at end of file
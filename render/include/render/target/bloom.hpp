@@ -1,12 +1,17 @@
 #pragma once
 
+#include <array>
 #include <glm/glm.hpp>
-#include <memory>
 
 #include "gpu/texture.hpp"
 
 namespace render::target
 {
+	///
+	/// @brief Bloom render targets
+	/// @details Every texture is transient, bound to the frame graph allocations of the frame. The filter
+	/// texture has the target size, mip N of both chains is half the size of mip N - 1.
+	///
 	class Bloom
 	{
 	  public:
@@ -27,13 +32,21 @@ namespace render::target
 
 		Bloom() = default;
 
+		using DownsampleChain = std::array<const gpu::Texture*, downsample_mip_count>;
+		using UpsampleChain = std::array<const gpu::Texture*, upsample_mip_count>;
+
 		///
-		/// @brief Resize bloom textures
+		/// @brief Bind the textures of the frame
 		///
-		/// @param size Top level texture size
-		/// @return Resize results
+		/// @param filter_texture Filter texture, with `downsample_mip_count` mip levels
+		/// @param downsample_chain Downsample chain, from the largest mip
+		/// @param upsample_chain Upsample chain, from the largest mip
 		///
-		std::expected<void, util::Error> resize(SDL_GPUDevice* device, glm::u32vec2 size) noexcept;
+		void bind(
+			const gpu::Texture* filter_texture,
+			const DownsampleChain& downsample_chain,
+			const UpsampleChain& upsample_chain
+		) noexcept;
 
 		///
 		/// @brief Get downsample chain
@@ -60,9 +73,9 @@ namespace render::target
 
 	  private:
 
-		glm::u32vec2 size = {0, 0};
-		std::unique_ptr<gpu::Texture> filter_texture;
-		std::vector<gpu::Texture> downsample_chain, upsample_chain;
+		const gpu::Texture* filter_texture = nullptr;
+		DownsampleChain downsample_chain = {};
+		UpsampleChain upsample_chain = {};
 
 	  public:
 
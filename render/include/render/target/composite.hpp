@@ -19,9 +19,31 @@ namespace render::target
 			.usage = {.sampler = true, .color_target = true}
 		};
 
-		graphics::AutoTexture composite_texture{composite_format, "Composite Texture"};  // Composite Texture
+		// Transient, bound to the frame graph allocation of the frame
+		const gpu::Texture* composite_texture = nullptr;
 
-		// Resize all textures
-		std::expected<void, util::Error> resize(SDL_GPUDevice* device, glm::u32vec2 size) noexcept;
+		// Anti-aliased image in the swapchain format, blitted to the swapchain when the render size differs
+		graphics::AutoTexture upscale_texture;
+
+		///
+		/// @brief Create the composite target, textures are allocated on resize
+		///
+		/// @param swapchain_format Format of the swapchain, which the upscale texture is blitted to
+		///
+		explicit Composite(SDL_GPUTextureFormat swapchain_format) noexcept :
+			upscale_texture(
+				{.type = SDL_GPU_TEXTURETYPE_2D,
+				 .format = swapchain_format,
+				 .usage = {.sampler = true, .color_target = true}},
+				"Upscale Texture"
+			)
+		{}
+
+		// Resize the upscale texture, only needed when rendering below the swapchain size
+		std::expected<void, util::Error> resize_upscale(
+			SDL_GPUDevice* device,
+			graphics::TexturePool& pool,
+			glm::u32vec2 size
+		) noexcept;
 	};
 }
\ No newline at end of file
@@ -52,7 +52,10 @@ namespace render::target
 
 		/* Textures */
 
-		graphics::AutoTexture depth_texture{depth_format, "Gbuffer Depth Texture"};  // Depth Texture
+		// Transient textures, bound to the frame graph allocations of the frame
+		const gpu::Texture* depth_texture = nullptr;          // Depth Texture
+		const gpu::Texture* albedo_texture = nullptr;         // Albedo Texture
+		const gpu::Texture* lighting_info_texture = nullptr;  // Lighting Info Texture
 
 		graphics::CycleTexture depth_value_texture{
 			depth_value_format,
@@ -60,16 +63,13 @@ namespace render::target
 			hiz_mip_levels
 		};  // Depth Value Texture
 
-		graphics::AutoTexture albedo_texture{albedo_format, "Gbuffer Albedo Texture"};  // Albedo Texture
-
-		graphics::AutoTexture lighting_info_texture{
-			lighting_info_format,
-			"Gbuffer Lighting Info Texture"
-		};  // Lighting Info Texture
-
 		/* Functions */
 
-		// Resize all textures
-		std::expected<void, util::Error> cycle(SDL_GPUDevice* device, glm::u32vec2 size) noexcept;
+		// Resize and cycle the depth value texture
+		std::expected<void, util::Error> cycle(
+			SDL_GPUDevice* device,
+			graphics::TexturePool& pool,
+			glm::u32vec2 size
+		) noexcept;
 	};
 }
\ No newline at end of file
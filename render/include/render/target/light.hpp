@@ -31,6 +31,10 @@ namespace render::target
 		};  // Light Buffer Texture
 
 		// Resize the render target
-		std::expected<void, util::Error> cycle(SDL_GPUDevice* device, glm::u32vec2 size) noexcept;
+		std::expected<void, util::Error> cycle(
+			SDL_GPUDevice* device,
+			graphics::TexturePool& pool,
+			glm::u32vec2 size
+		) noexcept;
 	};
 }
\ No newline at end of file
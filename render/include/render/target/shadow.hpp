@@ -12,6 +12,10 @@ namespace render::target
 	/// Format: `D32@FLOAT`
 	/// - `D32`: 32-bit Floating Point Depth
 	///
+	/// #### Static Layer Texture
+	/// Format: same as Depth Texture
+	/// - Static casters of a cached CSM level, copied into the depth texture before dynamic casters
+	///
 	struct Shadow
 	{
 		/* Formats */
@@ -29,6 +33,27 @@ namespace render::target
 		graphics::AutoTexture depth_texture_level1{depth_format, "Shadowmap Level 1 Texture"};
 		graphics::AutoTexture depth_texture_level2{depth_format, "Shadowmap Level 2 Texture"};
 
+		/* Textures (CSM static layers) */
+
+		graphics::AutoTexture static_texture_level0{depth_format, "Shadowmap Level 0 Static Texture"};
+		graphics::AutoTexture static_texture_level1{depth_format, "Shadowmap Level 1 Static Texture"};
+		graphics::AutoTexture static_texture_level2{depth_format, "Shadowmap Level 2 Static Texture"};
+
+		enum class Layer
+		{
+			Map,    // Sampled shadow map
+			Static  // Static layer of a cached level
+		};
+
+		///
+		/// @brief Get the texture of a CSM level
+		///
+		/// @param level CSM level index
+		/// @param layer Layer of the level
+		/// @return Texture, or nullptr if the level doesn't exist
+		///
+		const graphics::AutoTexture* get_texture(size_t level, Layer layer) const noexcept;
+
 		/* Resize */
 
 		std::expected<void, util::Error> resize(SDL_GPUDevice* device) noexcept;
@@ -99,21 +99,20 @@ namespace render::target
 		graphics::CycleTexture diffuse_texture{radiance_texture_format, "SSGI Diffuse Texture"};
 		graphics::CycleTexture specular_texture{radiance_texture_format, "SSGI Specular Texture"};
 
-		graphics::AutoTexture blurred_diffuse_texture{
-			radiance_texture_format,
-			"SSGI Blurred Diffuse Texture"
-		};
-
-		graphics::AutoTexture fullres_radiance_texture{
-			radiance_texture_format,
-			"SSGI Fullres Radiance Texture"
-		};
+		// Transient textures, bound to the frame graph allocations of the frame
+		const gpu::Texture* blurred_diffuse_texture = nullptr;
+		const gpu::Texture* fullres_radiance_texture = nullptr;
 
 		///
 		/// @brief Resize SSGI render targets
 		///
+		/// @param pool Pool the textures are acquired from and returned to
 		/// @param size Swapchain size
 		///
-		std::expected<void, util::Error> resize(SDL_GPUDevice* device, glm::u32vec2 size) noexcept;
+		std::expected<void, util::Error> resize(
+			SDL_GPUDevice* device,
+			graphics::TexturePool& pool,
+			glm::u32vec2 size
+		) noexcept;
 	};
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include "../common/gbuffer-storage.glsl"
 #include "../common/ndc-uv-conv.glsl"
+#include "../common/render-region.glsl"
 
 layout(location = 0) in vec2 uv;
 layout(location = 1) in vec2 ndc;
@@ -26,6 +27,8 @@ layout(std140, set = 3, binding = 0) uniform Params
     float random_seed;
     float radius;
     float blend_alpha;
+    vec2 render_size; // Size of the rendered region, at the top-left corner of the targets
+    vec2 prev_render_size; // Region rendered by the previous frame, in the previous depth and AO textures
 };
 
 const uint SAMPLE_COUNT = 3;
@@ -33,8 +36,8 @@ const uint RAY_COUNT = 4;
 const float PI = 3.14159265359;
 
 ivec2 fragcoord = ivec2(floor(gl_FragCoord.xy));
-ivec2 ao_render_size = textureSize(prev_ao_tex, 0);
-ivec2 depth_render_size = textureSize(depth_tex, 0);
+vec2 prev_ao_render_size = floor((prev_render_size + 1.0) / 2.0); // Region of the previous AO texture
+vec2 depth_texture_size = vec2(textureSize(depth_tex, 0));
 
 float noise_function(in vec2 xy, in float seed)
 {
@@ -50,15 +53,17 @@ vec3 homo_transform(mat4 mat, vec3 vec)
 
 vec3 get_view_normal()
 {
-    const vec2 little_offset = 0.5 / vec2(depth_render_size);
-    vec3 world_normal = unpack_normal(textureLod(light_info_tex, uv - little_offset, 0).r);
+    const vec2 little_offset = 0.5 / render_size;
+    const vec2 light_info_uv = region_to_texture_uv(uv - little_offset, render_size, depth_texture_size);
+    vec3 world_normal = unpack_normal(textureLod(light_info_tex, light_info_uv, 0).r);
     vec4 view_normal = view_mat * vec4(world_normal, 0.0);
     return view_normal.xyz;
 }
 
 void main()
 {
-    const float depth = textureLod(depth_tex, uv, 0).r;
+    const vec2 depth_uv = region_to_texture_uv(uv, render_size, depth_texture_size);
+    const float depth = textureLod(depth_tex, depth_uv, 0).r;
     if (depth == 0.0) discard;
 
     const vec3 world_pos = homo_transform(camera_mat_inv, vec3(ndc, depth));
@@ -67,7 +72,7 @@ void main()
 
     const vec3 offseted_world_pos = homo_transform(
             camera_mat_inv,
-            vec3(ndc + vec2(radius) / vec2(depth_render_size), depth)
+            vec3(ndc + vec2(radius) / render_size, depth)
         );
     const float clamp_distance = distance(world_pos, offseted_world_pos);
 
@@ -77,7 +82,7 @@ void main()
     {
         const float jittered_phi = phi + noise_function(uv * vec2(156.213, 481.53), random_seed + phi);
         const vec2 sample_direction = vec2(cos(jittered_phi), sin(jittered_phi));
-        const vec2 sample_step = sample_direction * radius / depth_render_size / SAMPLE_COUNT;
+        const vec2 sample_step = sample_direction * radius / render_size / SAMPLE_COUNT;
 
         vec2 sample_ndc = ndc;
         float max_cos_angle = 0;
@@ -89,7 +94,8 @@ void main()
             
             if (any(greaterThan(abs(sample_ndc), vec2(1.0)))) break;
 
-            const float sample_depth = textureLod(depth_tex, ndc_to_uv(sample_ndc), 0.0).r;
+            const vec2 sample_uv = region_to_texture_uv(ndc_to_uv(sample_ndc), render_size, depth_texture_size);
+            const float sample_depth = textureLod(depth_tex, sample_uv, 0.0).r;
             if (sample_depth == 0.0) continue;
 
             const vec3 sample_view_pos = homo_transform(proj_mat_inv, vec3(sample_ndc, sample_depth));
@@ -120,10 +126,14 @@ void main()
         if (all(lessThanEqual(abs(prev_ndc.xy), vec2(1.0))))
         {
             vec2 prev_uv = ndc_to_uv(prev_ndc.xy);
-            float prev_depth = textureLod(prev_depth_tex, prev_uv, 0.0).r;
+            const vec2 prev_depth_uv =
+                region_to_texture_uv(prev_uv, prev_render_size, vec2(textureSize(prev_depth_tex, 0)));
+            float prev_depth = textureLod(prev_depth_tex, prev_depth_uv, 0.0).r;
             if (distance(prev_depth, prev_ndc.z) / prev_depth < 0.00001)
             {
-                float prev_ao = textureLod(prev_ao_tex, prev_uv, 0.0).r;
+                const vec2 prev_ao_uv =
+                    region_to_texture_uv(prev_uv, prev_ao_render_size, vec2(textureSize(prev_ao_tex, 0)));
+                float prev_ao = textureLod(prev_ao_tex, prev_ao_uv, 0.0).r;
                 occlusion_sum = mix(prev_ao, occlusion_sum, blend_alpha);
             }
         }
@@ -0,0 +1,13 @@
+#ifndef _INSTANCE_GLSL_
+#define _INSTANCE_GLSL_
+
+// Per-instance data of instanced drawcalls, matching `gltf::InstanceData`
+// The including shader declares the instances as `Instance instances[]` in a storage buffer
+
+struct Instance
+{
+    mat4 transform;     // Model->World transform, unused for rigged primitives
+    uint joint_offset;  // First joint of the skin in the joint palette, unused for non-rigged primitives
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef _JOINT_PALETTE_GLSL_
+#define _JOINT_PALETTE_GLSL_
+
+// Joint palette decoding, matching `gltf::JointPalette`
+// The including shader declares the palette as `vec4 joint_palette[]` in a storage buffer
+
+precision highp float;
+
+const uint JOINT_PALETTE_MATRIX = 0;
+const uint JOINT_PALETTE_AFFINE = 1;
+const uint JOINT_PALETTE_DUAL_QUATERNION = 2;
+
+// Full matrices, 4 vec4 per joint
+mat4 blend_joint_matrices(uint offset, uvec4 joints, vec4 weights)
+{
+    mat4 skin_matrix = mat4(0.0);
+
+    for (int i = 0; i < 4; i++)
+    {
+        uint base = (joints[i] + offset) * 4;
+        mat4 joint_matrix = mat4(
+                joint_palette[base],
+                joint_palette[base + 1],
+                joint_palette[base + 2],
+                joint_palette[base + 3]
+            );
+
+        skin_matrix += joint_matrix * weights[i];
+    }
+
+    return skin_matrix;
+}
+
+// Upper 3 rows of the matrices, 3 vec4 per joint
+mat4 blend_joint_affine(uint offset, uvec4 joints, vec4 weights)
+{
+    vec4 row0 = vec4(0.0);
+    vec4 row1 = vec4(0.0);
+    vec4 row2 = vec4(0.0);
+
+    for (int i = 0; i < 4; i++)
+    {
+        uint base = (joints[i] + offset) * 3;
+        row0 += joint_palette[base] * weights[i];
+        row1 += joint_palette[base + 1] * weights[i];
+        row2 += joint_palette[base + 2] * weights[i];
+    }
+
+    return transpose(mat4(row0, row1, row2, vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
+// Real and dual quaternions, 2 vec4 per joint, the squared norm of the real part is the joint scale
+mat4 blend_joint_dual_quaternions(uint offset, uvec4 joints, vec4 weights)
+{
+    vec4 real_sum = vec4(0.0);
+    vec4 dual_sum = vec4(0.0);
+    float scale = 0.0;
+    vec4 first_real = vec4(0.0, 0.0, 0.0, 1.0);
+
+    for (int i = 0; i < 4; i++)
+    {
+        uint base = (joints[i] + offset) * 2;
+        vec4 real = joint_palette[base];
+        vec4 dual = joint_palette[base + 1];
+
+        float joint_scale = max(dot(real, real), 1e-20);
+        float inv_norm = inversesqrt(joint_scale);
+        real *= inv_norm;
+        dual *= inv_norm;
+
+        // Blend along the shortest arc, relative to the first joint
+        if (i == 0) first_real = real;
+        float weight = dot(real, first_real) < 0.0 ? -weights[i] : weights[i];
+
+        real_sum += real * weight;
+        dual_sum += dual * weight;
+        scale += joint_scale * weights[i];
+    }
+
+    float inv_length = 1.0 / length(real_sum);
+    real_sum *= inv_length;
+    dual_sum *= inv_length;
+
+    vec3 r = real_sum.xyz;
+    float w = real_sum.w;
+
+    mat3 rotation = mat3(
+            1.0 - 2.0 * (r.y * r.y + r.z * r.z), 2.0 * (r.x * r.y + w * r.z), 2.0 * (r.x * r.z - w * r.y),
+            2.0 * (r.x * r.y - w * r.z), 1.0 - 2.0 * (r.x * r.x + r.z * r.z), 2.0 * (r.y * r.z + w * r.x),
+            2.0 * (r.x * r.z + w * r.y), 2.0 * (r.y * r.z - w * r.x), 1.0 - 2.0 * (r.x * r.x + r.y * r.y)
+        );
+    vec3 translation = 2.0 * (w * dual_sum.xyz - dual_sum.w * r + cross(r, dual_sum.xyz));
+
+    mat3 linear = rotation * scale;
+    return mat4(vec4(linear[0], 0.0), vec4(linear[1], 0.0), vec4(linear[2], 0.0), vec4(translation, 1.0));
+}
+
+// Skinning matrix of a vertex, `offset` is the first joint of the skin
+mat4 compute_skin_matrix(uint palette, uint offset, uvec4 joints, vec4 weights)
+{
+    if (palette == JOINT_PALETTE_DUAL_QUATERNION)
+        return blend_joint_dual_quaternions(offset, joints, weights);
+    if (palette == JOINT_PALETTE_AFFINE)
+        return blend_joint_affine(offset, joints, weights);
+    return blend_joint_matrices(offset, joints, weights);
+}
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef _OBJECT_GLSL_
+#define _OBJECT_GLSL_
+
+// Per-object data of glTF drawcalls, matching `render::drawdata::ObjectData::Entry`
+// The including shader declares the objects as `Object objects[]` in a storage buffer, indexed by draw id
+
+struct Object
+{
+    mat4 model;                 // Model->World transform, identity for rigged and instanced drawcalls
+    mat3 normal;                // Inverse transpose of the model transform
+    uint joint_offset;          // First joint of the skin in the joint palette, rigged drawcalls only
+    uint instance_offset;       // First instance in the instance data, instanced drawcalls only
+    float emissive_multiplier;
+    uint material_index;
+};
+
+#endif
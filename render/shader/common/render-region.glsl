@@ -0,0 +1,13 @@
+#ifndef _RENDER_REGION_GLSL_
+#define _RENDER_REGION_GLSL_
+
+precision highp float;
+
+// Targets are allocated at a bucketed size and rendered in their top-left `region_size` corner. Maps a UV
+// relative to the region to a UV of the whole texture, clamped to the texel centers inside the region.
+vec2 region_to_texture_uv(vec2 uv, vec2 region_size, vec2 texture_size)
+{
+    return clamp(uv * region_size, vec2(0.5), region_size - 0.5) / texture_size;
+}
+
+#endif
@@ -0,0 +1,59 @@
+// G-Buffer Vertex Shader, instanced
+
+#version 460
+
+#extension GL_GOOGLE_include_directive : enable
+
+#include "../common/instance.glsl"
+#include "../common/object.glsl"
+
+layout(location = 0) in vec3 in_pos;
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec3 in_tangent;
+layout(location = 3) in vec2 in_uv;
+
+layout(location = 0) out vec2 out_uv;
+layout(location = 1) out vec3 out_normal;
+layout(location = 2) out vec3 out_tangent;
+layout(location = 3) out vec3 out_bitangent;
+layout(location = 4) flat out float out_emissive_multiplier;
+
+layout(std430, set = 0, binding = 0) readonly buffer Objects
+{
+    Object objects[];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer Instances
+{
+    Instance instances[];
+};
+
+layout(std140, set = 1, binding = 0) uniform Transform
+{
+    mat4 VP;
+} transform;
+
+layout(std140, set = 1, binding = 1) uniform Draw_param
+{
+    uint draw_id;
+} draw_params;
+
+void main()
+{
+    Object object = objects[draw_params.draw_id];
+    mat4 M = instances[object.instance_offset + gl_InstanceIndex].transform;
+
+    out_uv = in_uv;
+    out_emissive_multiplier = object.emissive_multiplier;
+
+    out_normal = (M * vec4(in_normal, 0.0f)).xyz;
+    out_normal = normalize(out_normal);
+
+    out_tangent = (M * vec4(in_tangent, 0.0f)).xyz;
+    out_tangent = normalize(out_tangent);
+
+    out_bitangent = cross(out_normal, out_tangent);
+    out_tangent = cross(out_bitangent, out_normal);
+
+    gl_Position = transform.VP * M * vec4(in_pos, 1.0f);
+}
@@ -0,0 +1,79 @@
+// G-Buffer Vertex Shader, rigged and instanced
+
+#version 460
+
+#extension GL_GOOGLE_include_directive : enable
+
+layout(location = 0) in vec3 in_pos;
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec3 in_tangent;
+layout(location = 3) in vec2 in_uv;
+layout(location = 4) in uvec4 in_joint_indices;
+layout(location = 5) in vec4 in_joint_weights;
+
+layout(location = 0) out vec2 out_uv;
+layout(location = 1) out vec3 out_normal;
+layout(location = 2) out vec3 out_tangent;
+layout(location = 3) out vec3 out_bitangent;
+layout(location = 4) flat out float out_emissive_multiplier;
+
+#include "../common/instance.glsl"
+#include "../common/object.glsl"
+
+layout(std430, set = 0, binding = 0) readonly buffer Objects
+{
+    Object objects[];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer Joints
+{
+    vec4 joint_palette[];
+};
+
+#include "../common/joint-palette.glsl"
+
+layout(std430, set = 0, binding = 2) readonly buffer Instances
+{
+    Instance instances[];
+};
+
+layout(std140, set = 1, binding = 0) uniform Transform
+{
+    mat4 VP;
+} transform;
+
+layout(std140, set = 1, binding = 1) uniform Draw_param
+{
+    uint draw_id;
+} draw_params;
+
+layout(std140, set = 1, binding = 2) uniform Palette_param
+{
+    uint palette;
+} palette_params;
+
+void main()
+{
+    Object object = objects[draw_params.draw_id];
+
+    out_uv = in_uv;
+    out_emissive_multiplier = object.emissive_multiplier;
+
+    mat4 skin_matrix = compute_skin_matrix(
+            palette_params.palette,
+            instances[object.instance_offset + gl_InstanceIndex].joint_offset,
+            in_joint_indices,
+            in_joint_weights
+        );
+
+    out_normal = (skin_matrix * vec4(in_normal, 0.0f)).xyz;
+    out_normal = normalize(out_normal);
+
+    out_tangent = (skin_matrix * vec4(in_tangent, 0.0f)).xyz;
+    out_tangent = normalize(out_tangent);
+
+    out_bitangent = cross(out_normal, out_tangent);
+    out_tangent = cross(out_bitangent, out_normal);
+
+    gl_Position = transform.VP * skin_matrix * vec4(in_pos, 1.0f);
+}
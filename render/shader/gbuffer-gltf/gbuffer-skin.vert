@@ -2,47 +2,59 @@
 
 #version 460
 
+#extension GL_GOOGLE_include_directive : enable
+
 layout(location = 0) in vec3 in_pos;
 layout(location = 1) in vec3 in_normal;
 layout(location = 2) in vec3 in_tangent;
 layout(location = 3) in vec2 in_uv;
 layout(location = 4) in uvec4 in_joint_indices;
 layout(location = 5) in vec4 in_joint_weights;
+layout(location = 6) in uint in_draw_id;  // Per instance, from the draw id stream
 
 layout(location = 0) out vec2 out_uv;
 layout(location = 1) out vec3 out_normal;
 layout(location = 2) out vec3 out_tangent;
 layout(location = 3) out vec3 out_bitangent;
+layout(location = 4) flat out float out_emissive_multiplier;
+
+#include "../common/object.glsl"
+
+layout(std430, set = 0, binding = 0) readonly buffer Objects
+{
+    Object objects[];
+};
 
-layout(std140, set = 0, binding = 0) readonly buffer Joints
+layout(std430, set = 0, binding = 1) readonly buffer Joints
 {
-    mat4 joint_matrices[];
+    vec4 joint_palette[];
 };
 
+#include "../common/joint-palette.glsl"
+
 layout(std140, set = 1, binding = 0) uniform Transform
 {
     mat4 VP;
 } transform;
 
-layout(std140, set = 1, binding = 1) uniform Joint_param
+layout(std140, set = 1, binding = 2) uniform Palette_param
 {
-    uint offset;
-} joint_params;
+    uint palette;
+} palette_params;
 
 void main()
 {
-    out_uv = in_uv;
+    Object object = objects[in_draw_id];
 
-    mat4 joint_matrix_0 = joint_matrices[in_joint_indices.x + joint_params.offset];
-    mat4 joint_matrix_1 = joint_matrices[in_joint_indices.y + joint_params.offset];
-    mat4 joint_matrix_2 = joint_matrices[in_joint_indices.z + joint_params.offset];
-    mat4 joint_matrix_3 = joint_matrices[in_joint_indices.w + joint_params.offset];
+    out_uv = in_uv;
+    out_emissive_multiplier = object.emissive_multiplier;
 
-    mat4 skin_matrix =
-        joint_matrix_0 * in_joint_weights.x +
-            joint_matrix_1 * in_joint_weights.y +
-            joint_matrix_2 * in_joint_weights.z +
-            joint_matrix_3 * in_joint_weights.w;
+    mat4 skin_matrix = compute_skin_matrix(
+            palette_params.palette,
+            object.joint_offset,
+            in_joint_indices,
+            in_joint_weights
+        );
 
     out_normal = (skin_matrix * vec4(in_normal, 0.0f)).xyz;
     out_normal = normalize(out_normal);
@@ -11,6 +11,7 @@ layout(location = 0) in vec2 in_uv;
 layout(location = 1) in vec3 in_normal;
 layout(location = 2) in vec3 in_tangent;
 layout(location = 3) in vec3 in_bitangent;
+layout(location = 4) flat in float in_emissive_multiplier;
 
 layout(location = 0) out vec4 out_albedo;
 layout(location = 1) out uvec2 out_light_info;
@@ -31,12 +32,8 @@ layout(std140, set = 3, binding = 0) uniform Material
     float normal_scale;
     float alpha_cutoff;
     float occlusion_strength;
-};
-
-
-layout(std140, set = 3, binding = 1) uniform Perobject
-{
-    float emissive_multiplier;
+    uint orm_packed; // Occlusion stored in R of metalness_roughness_tex
+    uint metallic_roughness_single_channel; // metalness_roughness_tex is grayscale, stored in R only
 };
 
 
@@ -46,8 +43,10 @@ void main()
 
     vec4 albedo_tex_sample = texture(albedo_tex, in_uv);
     vec2 normal_tex_sample = texture(normal_tex, in_uv).xy;
-    vec2 metalness_roughness_tex_sample = texture(metalness_roughness_tex, in_uv).bg;
-    float occlusion_tex_sample = texture(occlusion_tex, in_uv).r;
+    vec3 orm_tex_sample = texture(metalness_roughness_tex, in_uv).rgb;
+    if (metallic_roughness_single_channel != 0u) orm_tex_sample = orm_tex_sample.rrr;
+    vec2 metalness_roughness_tex_sample = orm_tex_sample.bg;
+    float occlusion_tex_sample = orm_packed != 0u ? orm_tex_sample.r : texture(occlusion_tex, in_uv).r;
     vec3 emissive_tex_sample = texture(emissive_tex, in_uv).rgb;
 
     /* Albedo */
@@ -81,6 +80,6 @@ void main()
 
     /* Emissive */
 
-    vec3 emissive = emissive_tex_sample * emissive_factor * emissive_multiplier;
+    vec3 emissive = emissive_tex_sample * emissive_factor * in_emissive_multiplier;
     out_light_buffer = vec4(emissive, smoothstep(0.0, 1.0, dot(emissive, vec3(0.2, 0.7, 0.1)) * 3));
 }
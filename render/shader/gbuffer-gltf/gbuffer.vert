@@ -2,38 +2,47 @@
 
 #version 460
 
+#extension GL_GOOGLE_include_directive : enable
+
+#include "../common/object.glsl"
+
 layout(location = 0) in vec3 in_pos;
 layout(location = 1) in vec3 in_normal;
 layout(location = 2) in vec3 in_tangent;
 layout(location = 3) in vec2 in_uv;
+layout(location = 4) in uint in_draw_id;  // Per instance, from the draw id stream
 
 layout(location = 0) out vec2 out_uv;
 layout(location = 1) out vec3 out_normal;
 layout(location = 2) out vec3 out_tangent;
 layout(location = 3) out vec3 out_bitangent;
+layout(location = 4) flat out float out_emissive_multiplier;
+
+layout(std430, set = 0, binding = 0) readonly buffer Objects
+{
+    Object objects[];
+};
 
 layout(std140, set = 1, binding = 0) uniform Transform
 {
     mat4 VP;
 } transform;
 
-layout(std140, set = 1, binding = 1) uniform Model
-{
-    mat4 M;
-} model;
-
 void main()
 {
+    Object object = objects[in_draw_id];
+
     out_uv = in_uv;
+    out_emissive_multiplier = object.emissive_multiplier;
 
-    out_normal = (model.M * vec4(in_normal, 0.0f)).xyz;
+    out_normal = object.normal * in_normal;
     out_normal = normalize(out_normal);
 
-    out_tangent = (model.M * vec4(in_tangent, 0.0f)).xyz;
+    out_tangent = mat3(object.model) * in_tangent;
     out_tangent = normalize(out_tangent);
 
     out_bitangent = cross(out_normal, out_tangent);
     out_tangent = cross(out_bitangent, out_normal);
 
-    gl_Position = transform.VP * model.M * vec4(in_pos, 1.0f);
+    gl_Position = transform.VP * object.model * vec4(in_pos, 1.0f);
 }
@@ -21,9 +21,11 @@ layout(std140, set = 3, binding = 0) uniform Param
 
 void main()
 {
-    const vec4 albedo_tex_sample = textureLod(albedo_tex, uv, 0);
-    const uvec2 lighting_info_tex_sample = textureLod(lighting_info_tex, uv, 0).rg;
-    const float ao_tex_sample = textureLod(ao_tex, uv, 0.0).r;
+    // Targets are larger than the rendered region, G-buffer and half-res AO texels are fetched directly
+    const ivec2 coord = ivec2(gl_FragCoord.xy);
+    const vec4 albedo_tex_sample = texelFetch(albedo_tex, coord, 0);
+    const uvec2 lighting_info_tex_sample = texelFetch(lighting_info_tex, coord, 0).rg;
+    const float ao_tex_sample = texelFetch(ao_tex, coord / 2, 0).r;
 
     const GBufferLighting lighting = unpack_gbuffer_lighting(lighting_info_tex_sample);
 
@@ -63,12 +63,14 @@ void main()
 {
     /* Fetch Texture */
 
-    uvec2 light_info_tex_sample = textureLod(light_info_tex, uv, 0).rg;
-    float depth = textureLod(depth_tex, uv, 0).r;
+    // Targets are larger than the rendered region, texels are fetched directly
+    const ivec2 coord = ivec2(gl_FragCoord.xy);
+    uvec2 light_info_tex_sample = texelFetch(light_info_tex, coord, 0).rg;
+    float depth = texelFetch(depth_tex, coord, 0).r;
 
     /* Get Albedo */
 
-    vec3 albedo = textureLod(albedo_tex, uv, 0).rgb;
+    vec3 albedo = texelFetch(albedo_tex, coord, 0).rgb;
 
     /* Unpack */
 
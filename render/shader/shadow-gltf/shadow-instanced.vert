@@ -0,0 +1,38 @@
+// Shadow Vertex Shader, instanced
+
+#version 460
+
+#extension GL_GOOGLE_include_directive : enable
+
+#include "../common/instance.glsl"
+#include "../common/object.glsl"
+
+layout(location = 0) in vec3 in_pos;
+
+layout(std430, set = 0, binding = 0) readonly buffer Objects
+{
+    Object objects[];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer Instances
+{
+    Instance instances[];
+};
+
+layout(std140, set = 1, binding = 0) uniform Camera
+{
+    mat4 VP;
+} camera;
+
+layout(std140, set = 1, binding = 1) uniform Draw_param
+{
+    uint draw_id;
+} draw_params;
+
+void main()
+{
+    uint instance_offset = objects[draw_params.draw_id].instance_offset;
+    mat4 M = instances[instance_offset + gl_InstanceIndex].transform;
+
+    gl_Position = camera.VP * M * vec4(in_pos, 1.0f);
+}
@@ -2,24 +2,29 @@
 
 #version 460
 
+#extension GL_GOOGLE_include_directive : enable
+
+#include "../common/object.glsl"
+
 layout(location = 0) in vec3 in_pos;
 layout(location = 1) in vec2 in_uv;
+layout(location = 2) in uint in_draw_id;  // Per instance, from the draw id stream
 
 layout(location = 0) out vec2 out_uv;
 
+layout(std430, set = 0, binding = 0) readonly buffer Objects
+{
+    Object objects[];
+};
+
 layout(std140, set = 1, binding = 0) uniform Camera
 {
     mat4 VP;
 } camera;
 
-layout(std140, set = 1, binding = 1) uniform Transform
-{
-    mat4 M;
-} transform;
-
 void main()
 {
     out_uv = in_uv;
 
-    gl_Position = camera.VP * transform.M * vec4(in_pos, 1.0f);
+    gl_Position = camera.VP * objects[in_draw_id].model * vec4(in_pos, 1.0f);
 }
@@ -0,0 +1,58 @@
+// Shadow Vertex Shader, rigged and instanced
+
+#version 460
+
+#extension GL_GOOGLE_include_directive : enable
+
+layout(location = 0) in vec3 in_pos;
+layout(location = 1) in uvec4 in_joint_indices;
+layout(location = 2) in vec4 in_joint_weights;
+
+#include "../common/instance.glsl"
+#include "../common/object.glsl"
+
+layout(std430, set = 0, binding = 0) readonly buffer Objects
+{
+    Object objects[];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer Joints
+{
+    vec4 joint_palette[];
+};
+
+#include "../common/joint-palette.glsl"
+
+layout(std430, set = 0, binding = 2) readonly buffer Instances
+{
+    Instance instances[];
+};
+
+layout(std140, set = 1, binding = 0) uniform Camera
+{
+    mat4 VP;
+} camera;
+
+layout(std140, set = 1, binding = 1) uniform Draw_param
+{
+    uint draw_id;
+} draw_params;
+
+layout(std140, set = 1, binding = 2) uniform Palette_param
+{
+    uint palette;
+} palette_params;
+
+void main()
+{
+    uint instance_offset = objects[draw_params.draw_id].instance_offset;
+
+    mat4 skin_matrix = compute_skin_matrix(
+            palette_params.palette,
+            instances[instance_offset + gl_InstanceIndex].joint_offset,
+            in_joint_indices,
+            in_joint_weights
+        );
+
+    gl_Position = camera.VP * skin_matrix * vec4(in_pos, 1.0f);
+}
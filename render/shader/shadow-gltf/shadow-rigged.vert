@@ -2,37 +2,45 @@
 
 #version 460
 
+#extension GL_GOOGLE_include_directive : enable
+
 layout(location = 0) in vec3 in_pos;
 layout(location = 1) in uvec4 in_joint_indices;
 layout(location = 2) in vec4 in_joint_weights;
+layout(location = 3) in uint in_draw_id;  // Per instance, from the draw id stream
+
+#include "../common/object.glsl"
+
+layout(std430, set = 0, binding = 0) readonly buffer Objects
+{
+    Object objects[];
+};
 
-layout(std430, set = 0, binding = 0) readonly buffer Joints
+layout(std430, set = 0, binding = 1) readonly buffer Joints
 {
-    mat4 joint_matrices[];
+    vec4 joint_palette[];
 };
 
+#include "../common/joint-palette.glsl"
+
 layout(std140, set = 1, binding = 0) uniform Camera
 {
     mat4 VP;
 } camera;
 
-layout(std140, set = 1, binding = 1) uniform Joint_param
+layout(std140, set = 1, binding = 2) uniform Palette_param
 {
-    uint offset;
-} joint_params;
+    uint palette;
+} palette_params;
 
 void main()
 {
-    mat4 joint_matrix_0 = joint_matrices[in_joint_indices.x + joint_params.offset];
-    mat4 joint_matrix_1 = joint_matrices[in_joint_indices.y + joint_params.offset];
-    mat4 joint_matrix_2 = joint_matrices[in_joint_indices.z + joint_params.offset];
-    mat4 joint_matrix_3 = joint_matrices[in_joint_indices.w + joint_params.offset];
-
-    mat4 skin_matrix =
-        joint_matrix_0 * in_joint_weights.x +
-            joint_matrix_1 * in_joint_weights.y +
-            joint_matrix_2 * in_joint_weights.z +
-            joint_matrix_3 * in_joint_weights.w;
+    mat4 skin_matrix = compute_skin_matrix(
+            palette_params.palette,
+            objects[in_draw_id].joint_offset,
+            in_joint_indices,
+            in_joint_weights
+        );
 
     gl_Position = camera.VP * skin_matrix * vec4(in_pos, 1.0f);
 }
@@ -9,5 +9,6 @@ layout(set = 2, binding = 0) uniform sampler2D curr_radiance_tex;
 
 void main()
 {
-    out_radiance = textureLod(curr_radiance_tex, uv, 0);
+    // Same size as the light buffer, which is larger than the rendered region
+    out_radiance = texelFetch(curr_radiance_tex, ivec2(gl_FragCoord.xy), 0);
 }
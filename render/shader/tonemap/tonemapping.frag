@@ -4,6 +4,7 @@
 
 #extension GL_GOOGLE_include_directive : enable
 #include "agx.glsl"
+#include "../common/render-region.glsl"
 
 layout(location = 0) in vec2 uv;
 layout(location = 1) in vec2 ndc;
@@ -24,6 +25,8 @@ layout(std140, set = 3, binding = 0) uniform Parameter
 {
     float exposure;
     float bloom_strength;
+    uint use_bloom_mask; // Selects the mask texture on the CPU side
+    uvec2 render_size; // Size of the rendered region, at the top-left corner of the targets
 };
 
 const uint dither_pattern[4] = uint[4](0, 2, 3, 1);
@@ -32,8 +35,11 @@ void main()
 {
     float exposure_mult_adjusted = exposure_mult * exposure;
 
-    vec3 base_brightness = textureLod(light_buffer_tex, uv, 0).rgb * exposure_mult_adjusted;
-    vec3 bloom_brightness = textureLod(bloom_tex, uv, 0).rgb 
+    // Bloom's first upsample mip has half the size of the light buffer, and so does its region
+    const vec2 bloom_uv = region_to_texture_uv(uv, vec2(render_size / 2), vec2(textureSize(bloom_tex, 0)));
+
+    vec3 base_brightness = texelFetch(light_buffer_tex, ivec2(gl_FragCoord.xy), 0).rgb * exposure_mult_adjusted;
+    vec3 bloom_brightness = textureLod(bloom_tex, bloom_uv, 0).rgb 
         * mix(vec3(1.0), vec3(1.5), textureLod(bloom_mask_tex, uv, 0).rgb) 
         * bloom_strength;
 
@@ -7,7 +7,13 @@
 
 namespace render::drawdata
 {
-	Gbuffer::Gbuffer(const glm::mat4& camera_matrix, const glm::vec3& eye_position) noexcept :
+	Gbuffer::Gbuffer(
+		const glm::mat4& camera_matrix,
+		const glm::vec3& eye_position,
+		std::pmr::memory_resource* memory
+	) noexcept :
+		drawcalls(memory),
+		resource_sets(memory),
 		camera_matrix(camera_matrix),
 		eye_position(eye_position)
 	{
@@ -21,25 +27,112 @@ namespace render::drawdata
 	}
 
 	void Gbuffer::append(const gltf::Drawdata& drawdata) noexcept
+	{
+		const auto resource_set_index = add_resource_set(drawdata);
+		cull_into(drawdata, resource_set_index, 0, drawdata.primitive_drawcalls.size(), drawcalls, min_z);
+	}
+
+	size_t Gbuffer::add_resource_set(const gltf::Drawdata& drawdata) noexcept
 	{
 		const auto current_resource_set_idx = resource_sets.size();
-		resource_sets.emplace_back(
+		auto& resource = resource_sets.emplace_back(
 			Resource{
 				.material_cache = drawdata.material_cache,
-				.deferred_skinning_resource = drawdata.deferred_skin_resource
+				.deferred_skinning_resource = drawdata.deferred_skin_resource,
+				.deferred_instance_resource = drawdata.deferred_instance_resource,
+				.drawcalls = drawdata.primitive_drawcalls,
+				.static_visible = std::pmr::vector<uint8_t>(resource_sets.get_allocator())
 			}
 		);
 
-		auto visible_nonrigged_drawcalls =
-			drawdata.primitive_drawcalls | std::views::filter([this](const auto& drawcall) -> bool {
-				return graphics::box_in_frustum(
-					drawcall.world_position_min,
-					drawcall.world_position_max,
-					frustum_planes
+		// Static drawcalls are culled hierarchically here, `cull` only reads the result
+		drawdata.primitive_drawcalls.cull_static(
+			frustum_planes,
+			resource.static_visible,
+			resource_sets.get_allocator().resource()
+		);
+
+		return current_resource_set_idx;
+	}
+
+	void Gbuffer::cull(
+		const gltf::Drawdata& drawdata,
+		size_t resource_set_index,
+		size_t begin,
+		size_t end,
+		Partial& partial
+	) const noexcept
+	{
+		cull_into(drawdata, resource_set_index, begin, end, partial.drawcalls, partial.min_z);
+	}
+
+	std::vector<Gbuffer::Occluder> Gbuffer::select_occluders(size_t max_count, float min_size) const noexcept
+	{
+		std::vector<Occluder> occluders;
+
+		for (const auto& resource : resource_sets)
+		{
+			const auto& partition = resource.drawcalls.static_partition;
+			if (partition == nullptr) continue;
+
+			for (const auto [idx, drawcall] : std::views::enumerate(partition->drawcalls))
+			{
+				if (resource.static_visible[idx] == 0 || drawcall.primitive.occluder == nullptr) continue;
+
+				// Masked and blended surfaces have holes
+				const auto& pipeline_mode = resource.material_cache[drawcall.material_index].params.pipeline;
+				if (pipeline_mode.alpha_mode != gltf::AlphaMode::Opaque) continue;
+
+				const auto center = (drawcall.world_position_min + drawcall.world_position_max) * 0.5f;
+				const float extent = glm::distance(drawcall.world_position_min, drawcall.world_position_max);
+				const float distance = std::max(glm::distance(center, eye_position), near_distance);
+
+				const float size = extent / distance;
+				if (size < min_size) continue;
+
+				if (portal_visibility != nullptr
+					&& !portal_visibility->test_box(drawcall.world_position_min, drawcall.world_position_max))
+					continue;
+
+				occluders.push_back(
+					Occluder{
+						.mesh = drawcall.primitive.occluder,
+						.transform = drawcall.get_world_transform(),
+						.size = size
+					}
 				);
-			});
+			}
+		}
+
+		if (occluders.size() > max_count)
+		{
+			const auto nth = occluders.begin() + ptrdiff_t(max_count);
+			std::ranges::nth_element(occluders, nth, std::greater{}, &Occluder::size);
+			occluders.resize(max_count);
+		}
+
+		std::ranges::sort(occluders, std::greater{}, &Occluder::size);
+
+		return occluders;
+	}
+
+	void Gbuffer::merge(const Partial& partial) noexcept
+	{
+		for (const auto& [key, partial_drawcalls] : partial.drawcalls)
+			drawcalls[key].append_range(partial_drawcalls);
 
-		/* Process Non-rigged Drawcalls */
+		min_z = std::min(min_z, partial.min_z);
+	}
+
+	void Gbuffer::cull_into(
+		const gltf::Drawdata& drawdata,
+		size_t resource_set_index,
+		size_t begin,
+		size_t end,
+		DrawcallBins& bins,
+		float& bins_min_z
+	) const noexcept
+	{
 
 		const auto point_in_range = [this](const glm::vec3& p) {
 			const auto eye_to_p = p - eye_position;
@@ -52,29 +145,51 @@ namespace render::drawdata
 			return glm::vec3(homo) / homo.w;
 		};
 
-		for (const auto& drawcall : visible_nonrigged_drawcalls)
-		{
-			const auto& pipeline_mode = drawdata.material_cache[drawcall.material_index].params.pipeline;
-			auto& target = drawcalls[std::pair(pipeline_mode, drawcall.is_rigged())];
+		const auto& static_visible = resource_sets[resource_set_index].static_visible;
+
+		const auto cull_drawcall = [&](gltf::DrawcallHandle handle, const gltf::PrimitiveDrawcall& drawcall) {
+			const bool visible = handle.partition == gltf::DrawcallHandle::Partition::Static
+				? static_visible[handle.index] != 0
+				: graphics::box_in_frustum(
+					  drawcall.world_position_min,
+					  drawcall.world_position_max,
+					  frustum_planes
+				  );
+			if (!visible) return;
+
+			if (portal_visibility != nullptr
+				&& !portal_visibility->test_box(drawcall.world_position_min, drawcall.world_position_max))
+				return;
 
-			const auto [local_min_z, local_max_z] = std::ranges::minmax(
+			if (occlusion_buffer != nullptr
+				&& !occlusion_buffer->test_box(drawcall.world_position_min, drawcall.world_position_max))
+				return;
+
+			auto clip_corners =
 				graphics::get_corner_points(drawcall.world_position_min, drawcall.world_position_max)
-					| std::views::filter(point_in_range)
-					| std::views::transform(clip_to_world),
-				{},
-				&glm::vec3::z
-			);
-			min_z = std::min(local_min_z.z, min_z);
+				| std::views::filter(point_in_range)
+				| std::views::transform(clip_to_world);
+
+			// Boxes entirely in front of the near plane are clipped away, and have no depth range
+			if (clip_corners.empty()) return;
+
+			const auto& pipeline_mode = drawdata.material_cache[drawcall.material_index].params.pipeline;
+			auto& target = bins[std::pair(pipeline_mode, drawcall.is_rigged())];
+
+			const auto [local_min_z, local_max_z] = std::ranges::minmax(clip_corners, {}, &glm::vec3::z);
+			bins_min_z = std::min(local_min_z.z, bins_min_z);
 
 			if (target.empty()) target.reserve(1024);
 			target.emplace_back(
 				Drawcall{
-					.drawcall = drawcall,
-					.resource_set_index = current_resource_set_idx,
+					.drawcall = handle,
+					.resource_set_index = resource_set_index,
 					.max_z = local_max_z.z
 				}
 			);
-		}
+		};
+
+		drawdata.primitive_drawcalls.for_each_in_range(begin, end, cull_drawcall);
 	}
 
 	void Gbuffer::sort() noexcept
@@ -83,6 +198,24 @@ namespace render::drawdata
 			std::ranges::sort(drawcalls_vec, std::greater{}, &Drawcall::max_z);
 	}
 
+	std::vector<graphics::Aabb> Gbuffer::collect_visible_bounds() const noexcept
+	{
+		std::vector<graphics::Aabb> bounds;
+
+		for (const auto& drawcall_vec : drawcalls | std::views::values)
+			for (const auto& entry : drawcall_vec)
+			{
+				const auto& resource_set = resource_sets[entry.resource_set_index];
+				const auto* const drawcall = resource_set.drawcalls.resolve(entry.drawcall);
+				if (drawcall == nullptr) [[unlikely]]
+					continue;
+
+				bounds.push_back({.min = drawcall->world_position_min, .max = drawcall->world_position_max});
+			}
+
+		return bounds;
+	}
+
 	float Gbuffer::get_min_z() const noexcept
 	{
 		return glm::clamp(min_z, 0.0f, 0.9999f);
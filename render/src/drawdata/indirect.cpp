@@ -0,0 +1,164 @@
+#include "render/drawdata/indirect.hpp"
+
+#include <cassert>
+#include <ranges>
+
+namespace render::drawdata
+{
+	namespace
+	{
+		// Batch the drawcalls of every bin, stale drawcalls are skipped
+		void build_bins(
+			IndirectDraws& indirect_draws,
+			const auto& bins,
+			const auto& resource_sets,
+			bool shadow
+		) noexcept
+		{
+			for (const auto& drawcalls : bins | std::views::values)
+			{
+				indirect_draws.begin_bin(&drawcalls);
+
+				for (const auto [position, entry] : drawcalls | std::views::enumerate)
+				{
+					const auto& resource_set = resource_sets[entry.resource_set_index];
+					const auto* const drawcall = resource_set.drawcalls.resolve(entry.drawcall);
+					if (drawcall == nullptr) [[unlikely]]
+						continue;
+
+					const auto& primitive = drawcall->primitive;
+
+					indirect_draws.add(
+						uint32_t(position),
+						{
+							.material = &resource_set.material_cache[drawcall->material_index],
+							.resource_set_index = entry.resource_set_index,
+							.vertex_buffer = shadow ? primitive.shadow_vertex_buffer_binding
+													: primitive.vertex_buffer_binding,
+							.index_buffer = shadow ? primitive.shadow_index_buffer_binding
+												   : primitive.index_buffer_binding,
+							.index_count = primitive.index_count,
+							.first_index = 0,
+							.vertex_offset = 0,
+							.draw_id = entry.draw_id,
+							.instanced = drawcall->is_instanced()
+						}
+					);
+				}
+
+				indirect_draws.end_bin();
+			}
+		}
+
+		bool same_binding(const SDL_GPUBufferBinding& a, const SDL_GPUBufferBinding& b) noexcept
+		{
+			return a.buffer == b.buffer && a.offset == b.offset;
+		}
+
+		// Drawcalls of one batch share every bound state
+		bool same_batch(const IndirectDraws::Draw& a, const IndirectDraws::Draw& b) noexcept
+		{
+			return a.material == b.material
+				&& a.resource_set_index == b.resource_set_index
+				&& same_binding(a.vertex_buffer, b.vertex_buffer)
+				&& same_binding(a.index_buffer, b.index_buffer);
+		}
+	}
+
+	void IndirectDraws::build(const Gbuffer& drawdata) noexcept
+	{
+		build_bins(*this, drawdata.drawcalls, drawdata.resource_sets, false);
+	}
+
+	void IndirectDraws::build(const Shadow& drawdata) noexcept
+	{
+		for (const auto& level : drawdata.csm_levels)
+		{
+			build_bins(*this, level.drawcalls, level.resource_sets, true);
+			build_bins(*this, level.static_drawcalls, level.resource_sets, true);
+		}
+	}
+
+	void IndirectDraws::begin_bin(const void* bin) noexcept
+	{
+		end_bin();
+
+		current_bin = bin;
+		current_bin_first = uint32_t(batches.size());
+	}
+
+	void IndirectDraws::add(uint32_t position, const Draw& draw) noexcept
+	{
+		assert(current_bin != nullptr && "No bin started, call begin_bin() first");
+
+		drawcall_count++;
+
+		// Instanced drawcalls read their draw id from a uniform, they can't share a command
+		if (draw.instanced)
+		{
+			batches.push_back({.first_drawcall = position, .first_command = 0, .command_count = 0});
+			last_draw.reset();
+			return;
+		}
+
+		if (!last_draw.has_value() || !same_batch(*last_draw, draw))
+			batches.push_back(
+				{.first_drawcall = position, .first_command = uint32_t(commands.size()), .command_count = 0}
+			);
+
+		auto& batch = batches.back();
+		const bool same_range = batch.command_count > 0
+			&& commands.back().num_indices == draw.index_count
+			&& commands.back().first_index == draw.first_index
+			&& commands.back().vertex_offset == draw.vertex_offset;
+
+		// Draw ids of a command are contiguous in the stream, so a repeated range is one more instance
+		if (same_range)
+			commands.back().num_instances++;
+		else
+		{
+			commands.push_back({
+				.num_indices = draw.index_count,
+				.num_instances = 1,
+				.first_index = draw.first_index,
+				.vertex_offset = draw.vertex_offset,
+				.first_instance = uint32_t(draw_ids.size())
+			});
+			batch.command_count++;
+		}
+
+		draw_ids.push_back(draw.draw_id);
+		last_draw = draw;
+	}
+
+	void IndirectDraws::end_bin() noexcept
+	{
+		if (current_bin == nullptr) return;
+
+		bin_ranges[current_bin] = {current_bin_first, uint32_t(batches.size()) - current_bin_first};
+		current_bin = nullptr;
+		last_draw.reset();
+	}
+
+	IndirectDraws::Stats IndirectDraws::get_stats() const noexcept
+	{
+		Stats stats{.drawcalls = drawcall_count, .commands = commands.size()};
+
+		for (const auto& batch : batches)
+			if (batch.command_count > 1)
+				stats.indirect_draws++;
+			else
+				stats.direct_draws++;
+
+		return stats;
+	}
+
+	std::span<const IndirectDraws::Batch> IndirectDraws::get_batches(const void* bin) const noexcept
+	{
+		const auto it = bin_ranges.find(bin);
+		if (it == bin_ranges.end()) return {};
+
+		const auto [first, count] = it->second;
+		return std::span(batches).subspan(first, count);
+	}
+}
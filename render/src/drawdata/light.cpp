@@ -1,5 +1,7 @@
 #include "render/drawdata/light.hpp"
 
+#include <limits>
+
 namespace render::drawdata
 {
 	Light Light::from(
@@ -16,4 +18,34 @@ namespace render::drawdata
 			.volume = std::move(volume)
 		};
 	}
+
+	std::optional<graphics::ClusterLight> Light::to_cluster_light() const noexcept
+	{
+		// Undefined range means infinite range in glTF
+		const float range = light.range > 0.0f ? light.range : std::numeric_limits<float>::infinity();
+		const glm::vec3 position = glm::vec3(node_transform[3]);
+
+		switch (light.type)
+		{
+		case gltf::Light::Type::Point:
+			return graphics::ClusterLight{
+				.type = graphics::ClusterLight::Type::Point,
+				.position = position,
+				.range = range
+			};
+
+		case gltf::Light::Type::Spot:
+			// Spot lights point down the local -Z axis
+			return graphics::ClusterLight{
+				.type = graphics::ClusterLight::Type::Spot,
+				.position = position,
+				.range = range,
+				.direction = -glm::normalize(glm::vec3(node_transform[2])),
+				.outer_cone_angle = light.outer_cone_angle
+			};
+
+		default:
+			return std::nullopt;
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "render/drawdata/object.hpp"
+
+#include <ranges>
+
+namespace render::drawdata
+{
+	namespace
+	{
+		// Assign draw ids to the drawcalls of every bin, stale drawcalls are left untouched
+		void assign_bins(ObjectData& object_data, auto& bins, const auto& resource_sets) noexcept
+		{
+			for (auto& drawcalls : bins | std::views::values)
+				for (auto& entry : drawcalls)
+				{
+					const auto& resource_set = resource_sets[entry.resource_set_index];
+					const auto* const drawcall = resource_set.drawcalls.resolve(entry.drawcall);
+					if (drawcall == nullptr) [[unlikely]]
+						continue;
+
+					entry.draw_id = object_data.add(*drawcall);
+				}
+		}
+	}
+
+	ObjectData::Entry ObjectData::Entry::from(const gltf::PrimitiveDrawcall& drawcall) noexcept
+	{
+		const bool rigged = drawcall.is_rigged();
+		const glm::mat4 model = rigged ? glm::mat4(1.0f) : drawcall.get_world_transform();
+		const glm::mat3 normal = glm::transpose(glm::inverse(glm::mat3(model)));
+
+		return Entry{
+			.model = model,
+			.normal = glm::mat3x4(glm::mat4(normal)),
+			.joint_offset = rigged ? drawcall.get_joint_matrix_offset() : 0,
+			.instance_offset = drawcall.instance_offset,
+			.emissive_multiplier = drawcall.emissive_multiplier,
+			.material_index = drawcall.material_index.value_or(no_material)
+		};
+	}
+
+	uint32_t ObjectData::add(const gltf::PrimitiveDrawcall& drawcall) noexcept
+	{
+		const auto [it, inserted] = draw_ids.try_emplace(&drawcall, uint32_t(entries.size()));
+		if (inserted) entries.push_back(Entry::from(drawcall));
+
+		return it->second;
+	}
+
+	void ObjectData::assign(Gbuffer& drawdata) noexcept
+	{
+		assign_bins(*this, drawdata.drawcalls, drawdata.resource_sets);
+	}
+
+	void ObjectData::assign(Shadow& drawdata) noexcept
+	{
+		for (auto& level : drawdata.csm_levels)
+		{
+			assign_bins(*this, level.drawcalls, level.resource_sets);
+			assign_bins(*this, level.static_drawcalls, level.resource_sets);
+		}
+	}
+}
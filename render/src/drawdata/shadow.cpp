@@ -4,7 +4,9 @@
 #include "graphics/smallest-bound.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <ranges>
+#include <tuple>
 
 namespace render::drawdata
 {
@@ -14,9 +16,8 @@ namespace render::drawdata
 		return glm::vec3(homo) / homo.w;
 	}
 
-	Shadow::Shadow(
+	std::array<std::array<glm::vec3, 8>, 3> Shadow::compute_slice_corners(
 		const glm::mat4& camera_matrix,
-		const glm::vec3& light_direction,
 		float min_z,
 		float linear_blend_ratio
 	) noexcept
@@ -41,60 +42,183 @@ namespace render::drawdata
 
 		const std::array<float, 4> z_series = {1.0f, split1_z, split2_z, min_z};
 
-		for (auto [level, z_pair] : std::views::zip(csm_levels, z_series | std::views::adjacent<2>))
+		std::array<std::array<glm::vec3, 8>, 3> slice_corners;
+
+		for (auto [corners, z_pair] : std::views::zip(slice_corners, z_series | std::views::adjacent<2>))
 		{
 			const auto [z_near, z_far] = z_pair;
 
-			const auto corners = graphics::transform_corner_points(
+			corners = graphics::transform_corner_points(
 				graphics::get_corner_points({-1, -1, z_far}, {1, 1, z_near}),
 				camera_mat_inv
 			);
+		}
 
-			level.smallest_bound = graphics::find_smallest_bound(corners, light_direction);
-
-			const auto temp_vp_matrix =
-				glm::ortho(
-					level.smallest_bound.left,
-					level.smallest_bound.right,
-					level.smallest_bound.bottom,
-					level.smallest_bound.top,
-					0.0f,
-					1.0f
-				)
-				* level.smallest_bound.view_matrix;
-
-			std::ranges::copy(
-				graphics::compute_frustum_planes(temp_vp_matrix) | std::views::take(4),
-				level.frustum_planes.begin()
-			);
+		return slice_corners;
+	}
+
+	Shadow::Shadow(
+		const glm::mat4& camera_matrix,
+		const glm::vec3& light_direction,
+		float min_z,
+		float linear_blend_ratio,
+		std::pmr::memory_resource* memory
+	) noexcept :
+		csm_levels{ShadowLevelData(memory), ShadowLevelData(memory), ShadowLevelData(memory)}
+	{
+		const auto slice_corners = compute_slice_corners(camera_matrix, min_z, linear_blend_ratio);
+
+		for (auto [level, corners] : std::views::zip(csm_levels, slice_corners))
+			level.set_bound(graphics::find_smallest_bound(corners, light_direction));
+	}
+
+	Shadow::Shadow(
+		const std::array<graphics::SmallestBound, 3>& bounds,
+		std::pmr::memory_resource* memory
+	) noexcept :
+		csm_levels{ShadowLevelData(memory), ShadowLevelData(memory), ShadowLevelData(memory)}
+	{
+		for (auto [level, bound] : std::views::zip(csm_levels, bounds))
+		{
+			level.set_bound(bound);
+			level.cached = true;
 		}
 	}
 
+	void Shadow::ShadowLevelData::set_bound(const graphics::SmallestBound& bound) noexcept
+	{
+		smallest_bound = bound;
+
+		const auto temp_vp_matrix =
+			glm::ortho(bound.left, bound.right, bound.bottom, bound.top, 0.0f, 1.0f) * bound.view_matrix;
+
+		std::ranges::copy(
+			graphics::compute_frustum_planes(temp_vp_matrix) | std::views::take(4),
+			frustum_planes.begin()
+		);
+	}
+
 	void Shadow::ShadowLevelData::append(const gltf::Drawdata& drawdata) noexcept
+	{
+		const auto resource_set_index = add_resource_set(drawdata);
+
+		Partial partial;
+		cull_into(drawdata, resource_set_index, 0, drawdata.primitive_drawcalls.size(), false, partial);
+		merge(partial);
+	}
+
+	void Shadow::ShadowLevelData::cull_static(
+		const gltf::Drawdata& drawdata,
+		size_t resource_set_index,
+		Partial& partial
+	) noexcept
+	{
+		// Fits in the capacity reserved by `add_resource_set`, the frame memory is not touched. The traversal
+		// allocates from the memory of `partial`, owned by the calling thread.
+		auto& resource = resource_sets[resource_set_index];
+		drawdata.primitive_drawcalls.cull_static(
+			frustum_planes,
+			resource.static_visible,
+			partial.drawcalls.get_allocator().resource()
+		);
+
+		cull_into(drawdata, resource_set_index, 0, drawdata.primitive_drawcalls.size(), true, partial);
+	}
+
+	void Shadow::ShadowLevelData::merge_static(const Partial& partial) noexcept
+	{
+		for (const auto& [key, partial_drawcalls] : partial.drawcalls)
+			static_drawcalls[key].append_range(partial_drawcalls);
+
+		near = std::min(near, partial.near);
+		far = std::max(far, partial.far);
+	}
+
+	size_t Shadow::ShadowLevelData::add_resource_set(const gltf::Drawdata& drawdata) noexcept
 	{
 		const auto current_resource_set_idx = resource_sets.size();
-		resource_sets.emplace_back(
+		auto& resource = resource_sets.emplace_back(
 			Resource{
 				.material_cache = drawdata.material_cache,
-				.deferred_skinning_resource = drawdata.deferred_skin_resource
+				.deferred_skinning_resource = drawdata.deferred_skin_resource,
+				.deferred_instance_resource = drawdata.deferred_instance_resource,
+				.drawcalls = drawdata.primitive_drawcalls,
+				.static_visible = std::pmr::vector<uint8_t>(resource_sets.get_allocator())
 			}
 		);
 
-		auto visible_drawcalls =
-			drawdata.primitive_drawcalls | std::views::filter([this](const auto& drawcall) -> bool {
-				return graphics::box_in_frustum(
-					drawcall.world_position_min,
-					drawcall.world_position_max,
-					frustum_planes
-				);
-			});
+		// Static drawcalls are culled hierarchically here, `cull` only reads the result. Cached levels cull
+		// them in `cull_static`, only when the static layer is rebuilt, possibly on another thread.
+		if (!cached)
+			drawdata.primitive_drawcalls.cull_static(
+				frustum_planes,
+				resource.static_visible,
+				resource_sets.get_allocator().resource()
+			);
+		else if (const auto& static_partition = drawdata.primitive_drawcalls.static_partition)
+			resource.static_visible.reserve(static_partition->drawcalls.size());
 
-		/* Process Non-rigged Drawcalls */
+		return current_resource_set_idx;
+	}
+
+	void Shadow::ShadowLevelData::cull(
+		const gltf::Drawdata& drawdata,
+		size_t resource_set_index,
+		size_t begin,
+		size_t end,
+		Partial& partial
+	) const noexcept
+	{
+		cull_into(drawdata, resource_set_index, begin, end, false, partial);
+	}
+
+	void Shadow::ShadowLevelData::merge(const Partial& partial) noexcept
+	{
+		for (const auto& [key, partial_drawcalls] : partial.drawcalls)
+			drawcalls[key].append_range(partial_drawcalls);
+
+		near = std::min(near, partial.near);
+		far = std::max(far, partial.far);
+		receiver_culled += partial.receiver_culled;
+	}
+
+	void Shadow::ShadowLevelData::cull_into(
+		const gltf::Drawdata& drawdata,
+		size_t resource_set_index,
+		size_t begin,
+		size_t end,
+		bool static_layer,
+		Partial& partial
+	) const noexcept
+	{
+		const auto& static_visible = resource_sets[resource_set_index].static_visible;
+
+		const auto cull_drawcall = [&](gltf::DrawcallHandle handle, const gltf::PrimitiveDrawcall& drawcall) {
+			const bool is_static = handle.partition == gltf::DrawcallHandle::Partition::Static;
+
+			// Cached levels draw static and dynamic casters in separate layers
+			if (cached ? is_static != static_layer : static_layer) return;
+
+			const bool visible = is_static
+				? static_visible[handle.index] != 0
+				: graphics::box_in_frustum(
+					  drawcall.world_position_min,
+					  drawcall.world_position_max,
+					  frustum_planes
+				  );
+			if (!visible) return;
+
+			// The static layer outlives the receivers of this frame
+			if (!static_layer
+				&& receiver_mask != nullptr
+				&& !receiver_mask->test_caster(drawcall.world_position_min, drawcall.world_position_max))
+			{
+				partial.receiver_culled++;
+				return;
+			}
 
-		for (const auto& drawcall : visible_drawcalls)
-		{
 			const auto& pipeline_mode = drawdata.material_cache[drawcall.material_index].params.pipeline;
-			auto& target = drawcalls[std::pair(pipeline_mode, drawcall.is_rigged())];
+			auto& target = partial.drawcalls[std::pair(pipeline_mode, drawcall.is_rigged())];
 
 			const auto corners_world =
 				graphics::get_corner_points(drawcall.world_position_min, drawcall.world_position_max);
@@ -102,19 +226,22 @@ namespace render::drawdata
 				graphics::transform_corner_points(corners_world, smallest_bound.view_matrix);
 
 			const auto [min_z, max_z] = std::ranges::minmax(corners_light_view, {}, &glm::vec3::z);
-			near = std::min(near, -max_z.z);
-			far = std::max(far, -min_z.z);
+			partial.near = std::min(partial.near, -max_z.z);
+			partial.far = std::max(partial.far, -min_z.z);
 
 			if (target.empty()) target.reserve(1024);
 
 			target.emplace_back(
 				Drawcall{
-					.drawcall = drawcall,
-					.resource_set_index = current_resource_set_idx,
-					.min_z = -min_z.z
+					.drawcall = handle,
+					.resource_set_index = resource_set_index,
+					.min_z = -min_z.z,
+					.geometry_index = drawcall.primitive.geometry_index
 				}
 			);
-		}
+		};
+
+		drawdata.primitive_drawcalls.for_each_in_range(begin, end, cull_drawcall);
 	}
 
 	glm::mat4 Shadow::ShadowLevelData::get_vp_matrix() const noexcept
@@ -133,8 +260,17 @@ namespace render::drawdata
 
 	void Shadow::ShadowLevelData::sort() noexcept
 	{
+		// Shadow fragments are cheap, so drawcalls are grouped by geometry to be batched, near to far within.
+		// Geometry is keyed by model and primitive index, so the order does not depend on buffer addresses.
+		const auto sort_key = [](const Drawcall& drawcall) {
+			return std::tuple(drawcall.resource_set_index, drawcall.geometry_index, drawcall.min_z);
+		};
+
 		for (auto& drawcall_vec : drawcalls | std::views::values)
-			std::ranges::sort(drawcall_vec, {}, &Drawcall::min_z);
+			std::ranges::sort(drawcall_vec, {}, sort_key);
+
+		for (auto& drawcall_vec : static_drawcalls | std::views::values)
+			std::ranges::sort(drawcall_vec, {}, sort_key);
 	}
 
 	void Shadow::append(const gltf::Drawdata& drawdata) noexcept
@@ -151,4 +287,33 @@ namespace render::drawdata
 	{
 		return csm_levels[level].get_vp_matrix();
 	}
+
+	Shadow::Stats Shadow::get_stats() const noexcept
+	{
+		Stats stats;
+
+		const auto count_drawcalls = [](const DrawcallBins& bins) {
+			return std::ranges::fold_left(
+				bins | std::views::values | std::views::transform([](const auto& vec) { return vec.size(); }),
+				0zu,
+				std::plus{}
+			);
+		};
+
+		for (const auto& level : csm_levels)
+		{
+			if (level.cached)
+				stats.actions[size_t(level.action)]++;
+			else
+				stats.uncached_levels++;
+
+			stats.receiver_culled += level.receiver_culled;
+
+			// Skipped levels keep the shadow map of a previous frame
+			if (!level.cached || level.action != Action::Skip)
+				stats.casters += count_drawcalls(level.drawcalls) + count_drawcalls(level.static_drawcalls);
+		}
+
+		return stats;
+	}
 }
\ No newline at end of file
@@ -35,43 +35,20 @@ namespace render
 		);
 		if (!vertex_buffer) return vertex_buffer.error().forward("Create light volume vertex buffer failed");
 
-		auto tri_positions = position_data | std::views::stride(3) | std::ranges::to<std::vector>();
-		auto tri_normals =
-			position_data
-			| std::views::chunk(3)
-			| std::views::transform([](const auto& tri_pos) {
-				  const glm::vec3 edge1 = tri_pos[1] - tri_pos[0];
-				  const glm::vec3 edge2 = tri_pos[2] - tri_pos[0];
-				  return glm::normalize(glm::cross(edge1, edge2));
-			  })
-			| std::ranges::to<std::vector>();
+		auto hull = graphics::ConvexHull::from_points(position_data);
+		if (!hull) return hull.error().forward("Build light volume convex hull failed");
 
 		return LightVolume{
 			.vertex_buffer = std::move(*vertex_buffer),
 			.vertex_count = static_cast<uint32_t>(position_data.size()),
 			.min = min,
 			.max = max,
-			.tri_positions = std::move(tri_positions),
-			.tri_normals = std::move(tri_normals)
+			.hull = std::move(*hull)
 		};
 	}
 
 	bool LightVolume::camera_inside(glm::vec3 local_eye_position) const noexcept
 	{
-		if (glm::any(glm::lessThan(local_eye_position, min))
-			|| glm::any(glm::greaterThan(local_eye_position, max)))
-			return false;
-
-		return std::ranges::all_of(
-			std::views::zip_transform(
-				[local_eye_position](auto tri_pos, auto tri_normal) {
-					const glm::vec3 to_eye = local_eye_position - tri_pos;
-					return glm::dot(tri_normal, to_eye) < 0.0f;
-				},
-				tri_positions,
-				tri_normals
-			),
-			[](bool v) { return v; }
-		);
+		return hull.contains(local_eye_position);
 	}
 }
\ No newline at end of file
@@ -9,7 +9,8 @@ namespace render
 	std::expected<gpu::RenderPass, util::Error> acquire_gbuffer_pass(
 		const gpu::CommandBuffer& command_buffer,
 		const target::Gbuffer& gbuffer,
-		const target::LightBuffer& light_buffer
+		const target::LightBuffer& light_buffer,
+		glm::u32vec2 region
 	) noexcept
 	{
 		const auto albedo_target_info = SDL_GPUColorTargetInfo{
@@ -75,13 +76,17 @@ namespace render
 
 		const std::array color_targets = {albedo_target_info, lighting_info_target_info, light_target_info};
 
-		return command_buffer.begin_render_pass(color_targets, depth_stencil_target_info);
+		auto render_pass = command_buffer.begin_render_pass(color_targets, depth_stencil_target_info);
+		if (render_pass) render_pass->set_region(region.x, region.y);
+
+		return render_pass;
 	}
 
 	std::expected<gpu::RenderPass, util::Error> acquire_lighting_pass(
 		const gpu::CommandBuffer& command_buffer,
 		const target::LightBuffer& light_buffer,
-		const target::Gbuffer& gbuffer
+		const target::Gbuffer& gbuffer,
+		glm::u32vec2 region
 	) noexcept
 	{
 		const auto light_target_info = SDL_GPUColorTargetInfo{
@@ -115,39 +120,32 @@ namespace render
 			.layer = 0
 		};
 
-		return command_buffer.begin_render_pass(color_targets, depth_stencil_target_info);
+		auto render_pass = command_buffer.begin_render_pass(color_targets, depth_stencil_target_info);
+		if (render_pass) render_pass->set_region(region.x, region.y);
+
+		return render_pass;
 	}
 
 	std::expected<gpu::RenderPass, util::Error> acquire_shadow_pass(
 		const gpu::CommandBuffer& command_buffer,
 		const target::Shadow& shadow_target,
-		size_t level
+		size_t level,
+		target::Shadow::Layer layer,
+		bool clear
 	) noexcept
 	{
-		SDL_GPUTexture* depth_texture;
-		switch (level)
-		{
-		case 0:
-			depth_texture = *shadow_target.depth_texture_level0;
-			break;
-		case 1:
-			depth_texture = *shadow_target.depth_texture_level1;
-			break;
-		case 2:
-			depth_texture = *shadow_target.depth_texture_level2;
-			break;
-		default:
-			return util::Error("Invalid CSM level index");
-		}
+		const auto* depth_texture = shadow_target.get_texture(level, layer);
+		if (depth_texture == nullptr) return util::Error("Invalid CSM level index");
 
+		// Drawing over existing content must not cycle the texture
 		const auto depth_stencil_target_info = SDL_GPUDepthStencilTargetInfo{
-			.texture = depth_texture,
+			.texture = **depth_texture,
 			.clear_depth = 0.0f,
-			.load_op = SDL_GPU_LOADOP_CLEAR,
+			.load_op = clear ? SDL_GPU_LOADOP_CLEAR : SDL_GPU_LOADOP_LOAD,
 			.store_op = SDL_GPU_STOREOP_STORE,
 			.stencil_load_op = SDL_GPU_LOADOP_DONT_CARE,
 			.stencil_store_op = SDL_GPU_STOREOP_DONT_CARE,
-			.cycle = true,
+			.cycle = clear,
 			.clear_stencil = 0,
 			.mip_level = 0,
 			.layer = 0
@@ -158,7 +156,8 @@ namespace render
 
 	std::expected<gpu::RenderPass, util::Error> acquire_ao_pass(
 		const gpu::CommandBuffer& command_buffer,
-		const target::AO& ao_target
+		const target::AO& ao_target,
+		glm::u32vec2 region
 	) noexcept
 	{
 		const auto ao_target_info = SDL_GPUColorTargetInfo{
@@ -179,7 +178,10 @@ namespace render
 
 		const std::array color_targets = {ao_target_info};
 
-		return command_buffer.begin_render_pass(color_targets, std::nullopt);
+		auto render_pass = command_buffer.begin_render_pass(color_targets, std::nullopt);
+		if (render_pass) render_pass->set_region(region.x, region.y);
+
+		return render_pass;
 	}
 
 	std::expected<gpu::RenderPass, util::Error> acquire_swapchain_pass(
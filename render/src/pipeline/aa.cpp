@@ -31,6 +31,7 @@ namespace render::pipeline
 		SDL_GPUTexture* source,
 		SDL_GPUTexture* target,
 		glm::u32vec2 size,
+		glm::u32vec2 region,
 		AntialiasMode mode
 	) noexcept
 	{
@@ -39,13 +40,13 @@ namespace render::pipeline
 			switch (mode)
 			{
 			case AntialiasMode::None:
-				return empty_processor.run_antialiasing(device, command_buffer, source, target, size);
+				return empty_processor.run_antialiasing(device, command_buffer, source, target, size, region);
 			case AntialiasMode::FXAA:
-				return fxaa_processor.run_antialiasing(device, command_buffer, source, target, size);
+				return fxaa_processor.run_antialiasing(device, command_buffer, source, target, size, region);
 			case AntialiasMode::MLAA:
-				return mlaa_processor.run_antialiasing(device, command_buffer, source, target, size);
+				return mlaa_processor.run_antialiasing(device, command_buffer, source, target, size, region);
 			case AntialiasMode::SMAA:
-				return smaa_processor.run_antialiasing(device, command_buffer, source, target, size);
+				return smaa_processor.run_antialiasing(device, command_buffer, source, target, size, region);
 			default:
 				return util::Error("Unknown antialiasing mode");
 			}
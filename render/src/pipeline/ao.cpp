@@ -22,7 +22,9 @@ namespace render::pipeline
 			.prev_camera_mat = params.prev_camera_mat,
 			.random_seed = random_seed,
 			.radius = params.radius,
-			.blend_alpha = params.blend_alpha
+			.blend_alpha = params.blend_alpha,
+			.render_size = params.render_size,
+			.prev_render_size = params.prev_render_size
 		};
 	}
 
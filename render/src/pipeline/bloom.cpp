@@ -45,7 +45,7 @@ namespace render::pipeline
 			.num_readwrite_storage_textures = 1,
 			.num_readonly_storage_buffers = 0,
 			.num_readwrite_storage_buffers = 0,
-			.num_uniform_buffers = 0,
+			.num_uniform_buffers = 1,
 			.threadcount_x = 16,
 			.threadcount_y = 16,
 			.threadcount_z = 1
@@ -211,6 +211,9 @@ namespace render::pipeline
 
 		const auto workgroup_count = (image_size + 15u) / 16u;
 
+		const BlurParam blur_param = {.region_size = image_size};
+		command_buffer.push_uniform_to_compute(0, util::as_bytes(blur_param));
+
 		return command_buffer.run_compute_pass(
 			std::to_array({output_binding}),
 			{},
@@ -324,7 +327,9 @@ namespace render::pipeline
 		const auto upsample_dst_size = calculate_mip_size(swapchain_size, upsample_mip_level + 1);
 		const bool is_last_mip = (upsample_mip_level + 1) == target::Bloom::upsample_mip_count;
 
-		const AddParam add_param(param);
+		// Mips are larger than their rendered regions, samples of the smaller mip are clamped into its region
+		const auto prev_region_size = calculate_mip_size(swapchain_size, upsample_mip_level + 2);
+		const AddParam add_param(param, upsample_dst_size, prev_region_size);
 		command_buffer.push_uniform_to_compute(0, util::as_bytes(add_param));
 
 		const auto prev_upsample_binding =
@@ -1,5 +1,7 @@
 #include "render/pipeline/gbuffer-gltf.hpp"
+#include "asset/shader/gbuffer-instanced.vert.hpp"
 #include "asset/shader/gbuffer-mask.frag.hpp"
+#include "asset/shader/gbuffer-skin-instanced.vert.hpp"
 #include "asset/shader/gbuffer-skin.vert.hpp"
 #include "asset/shader/gbuffer.frag.hpp"
 #include "asset/shader/gbuffer.vert.hpp"
@@ -11,8 +13,12 @@
 #include "util/as-byte.hpp"
 
 #include <SDL3/SDL_gpu.h>
+#include <algorithm>
+#include <cassert>
 #include <expected>
+#include <optional>
 #include <ranges>
+#include <vector>
 
 namespace render::pipeline
 {
@@ -185,7 +191,9 @@ namespace render::pipeline
 			.roughness_factor = factor.roughness_mult,
 			.normal_scale = factor.normal_scale,
 			.alpha_cutoff = factor.alpha_cutoff,
-			.occlusion_strength = factor.occlusion_strength
+			.occlusion_strength = factor.occlusion_strength,
+			.orm_packed = factor.orm_packed ? 1u : 0u,
+			.metallic_roughness_single_channel = factor.metallic_roughness_single_channel ? 1u : 0u
 		};
 	}
 
@@ -199,8 +207,8 @@ namespace render::pipeline
 			gpu::GraphicsShader::Stage::Vertex,
 			0,
 			0,
-			0,
-			2
+			1,
+			1
 		);
 	}
 
@@ -214,11 +222,41 @@ namespace render::pipeline
 			gpu::GraphicsShader::Stage::Vertex,
 			0,
 			0,
-			1,
+			2,
+			3
+		);
+	}
+
+	static std::expected<gpu::GraphicsShader, util::Error> create_vertex_instanced_shader(
+		SDL_GPUDevice* device
+	) noexcept
+	{
+		return gpu::GraphicsShader::create(
+			device,
+			shader_asset::gbuffer_instanced_vert,
+			gpu::GraphicsShader::Stage::Vertex,
+			0,
+			0,
+			2,
 			2
 		);
 	}
 
+	static std::expected<gpu::GraphicsShader, util::Error> create_vertex_rigged_instanced_shader(
+		SDL_GPUDevice* device
+	) noexcept
+	{
+		return gpu::GraphicsShader::create(
+			device,
+			shader_asset::gbuffer_skin_instanced_vert,
+			gpu::GraphicsShader::Stage::Vertex,
+			0,
+			0,
+			3,
+			3
+		);
+	}
+
 	static std::expected<gpu::GraphicsShader, util::Error> create_fragment_shader(
 		SDL_GPUDevice* device
 	) noexcept
@@ -230,7 +268,7 @@ namespace render::pipeline
 			5,
 			0,
 			0,
-			2
+			1
 		);
 	}
 
@@ -245,18 +283,18 @@ namespace render::pipeline
 			5,
 			0,
 			0,
-			2
+			1
 		);
 	}
 
 	static std::expected<gpu::GraphicsPipeline, util::Error> create_pipeline(
 		SDL_GPUDevice* device,
-		const gpu::GraphicsShader& vertex,
-		const gpu::GraphicsShader& vertex_rigged,
+		const gpu::GraphicsShader& vertex_shader,
 		const gpu::GraphicsShader& fragment,
 		const gpu::GraphicsShader& fragment_mask,
 		gltf::PipelineMode mode,
-		bool rigged
+		bool rigged,
+		bool instanced
 	) noexcept
 	{
 		SDL_GPURasterizerState rasterizer_state;
@@ -272,7 +310,19 @@ namespace render::pipeline
 		const gpu::GraphicsShader& fragment_shader =
 			(mode.alpha_mode == gltf::AlphaMode::Opaque) ? fragment : fragment_mask;
 
-		const gpu::GraphicsShader& vertex_shader = rigged ? vertex_rigged : vertex;
+		std::vector<SDL_GPUVertexAttribute> attributes = rigged
+			? std::vector(vertex_rigged_attributes.begin(), vertex_rigged_attributes.end())
+			: std::vector(vertex_attributes.begin(), vertex_attributes.end());
+		std::vector<SDL_GPUVertexBufferDescription> buffer_descs = rigged
+			? std::vector(vertex_buffer_rigged_descs.begin(), vertex_buffer_rigged_descs.end())
+			: std::vector(vertex_buffer_descs.begin(), vertex_buffer_descs.end());
+
+		// Single drawcalls read their draw id from the draw id stream
+		if (!instanced)
+		{
+			attributes.push_back(get_draw_id_attribute(uint32_t(attributes.size())));
+			buffer_descs.push_back(get_draw_id_buffer_desc());
+		}
 
 		return gpu::GraphicsPipeline::create(
 			device,
@@ -281,12 +331,16 @@ namespace render::pipeline
 			SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
 			SDL_GPU_SAMPLECOUNT_1,
 			rasterizer_state,
-			rigged ? std::span<const SDL_GPUVertexAttribute>(vertex_rigged_attributes)
-				   : std::span<const SDL_GPUVertexAttribute>(vertex_attributes),
-			rigged ? vertex_buffer_rigged_descs : vertex_buffer_descs,
+			attributes,
+			buffer_descs,
 			color_target_descs,
 			get_depth_stencil_state(mode.double_sided),
-			std::format("Gbuffer Gltf Pipeline (mode: {}, rigged: {})", mode.to_string(), rigged)
+			std::format(
+				"Gbuffer Gltf Pipeline (mode: {}, rigged: {}, instanced: {})",
+				mode.to_string(),
+				rigged,
+				instanced
+			)
 		);
 	}
 
@@ -299,6 +353,16 @@ namespace render::pipeline
 		if (!vertex_rigged_shader)
 			return vertex_rigged_shader.error().forward("Create vertex rigged shader failed");
 
+		auto vertex_instanced_shader = create_vertex_instanced_shader(device);
+		if (!vertex_instanced_shader)
+			return vertex_instanced_shader.error().forward("Create vertex instanced shader failed");
+
+		auto vertex_rigged_instanced_shader = create_vertex_rigged_instanced_shader(device);
+		if (!vertex_rigged_instanced_shader)
+			return vertex_rigged_instanced_shader.error().forward(
+				"Create vertex rigged instanced shader failed"
+			);
+
 		auto fragment_shader = create_fragment_shader(device);
 		if (!fragment_shader) return fragment_shader.error().forward("Create fragment shader failed");
 
@@ -306,71 +370,85 @@ namespace render::pipeline
 		if (!fragment_mask_shader)
 			return fragment_mask_shader.error().forward("Create fragment mask shader failed");
 
-		std::map<std::pair<gltf::PipelineMode, bool>, std::unique_ptr<PipelineGLTF>> pipeline_result;
+		PipelineMap pipeline_result;
+		PipelineMap instanced_pipeline_result;
 
-		for (const auto [alpha_mode, double_sided, rigged] : std::views::cartesian_product(
+		for (const auto [alpha_mode, double_sided, rigged, instanced] : std::views::cartesian_product(
 				 std::array{gltf::AlphaMode::Opaque, gltf::AlphaMode::Mask, gltf::AlphaMode::Blend},
 				 std::array{false, true},
+				 std::array{false, true},
 				 std::array{false, true}
 			 ))
 		{
 			const auto pipeline_cfg =
 				gltf::PipelineMode{.alpha_mode = alpha_mode, .double_sided = double_sided};
 
+			const auto& vertex = instanced
+				? (rigged ? *vertex_rigged_instanced_shader : *vertex_instanced_shader)
+				: (rigged ? *vertex_rigged_shader : *vertex_shader);
+
 			auto pipeline = create_pipeline(
 				device,
-				*vertex_shader,
-				*vertex_rigged_shader,
+				vertex,
 				*fragment_shader,
 				*fragment_mask_shader,
 				pipeline_cfg,
-				rigged
+				rigged,
+				instanced
 			);
 
 			if (!pipeline)
 				return pipeline.error().forward(
 					std::format(
-						"Create graphics pipeline failed (alpha_mode: {}, double_sided: {}, rigged: {})",
+						"Create graphics pipeline failed (alpha_mode: {}, double_sided: {}, rigged: {}, "
+						"instanced: {})",
 						static_cast<int>(alpha_mode),
 						double_sided,
-						rigged
+						rigged,
+						instanced
 					)
 				);
 
+			auto& target = instanced ? instanced_pipeline_result : pipeline_result;
+
 			if (rigged)
-				pipeline_result.emplace(
+				target.emplace(
 					std::pair(pipeline_cfg, rigged),
 					std::make_unique<PipelineRigged>(pipeline_cfg, std::move(*pipeline))
 				);
 			else
-				pipeline_result.emplace(
+				target.emplace(
 					std::pair(pipeline_cfg, rigged),
 					std::make_unique<PipelineNormal>(pipeline_cfg, std::move(*pipeline))
 				);
 		}
 
-		return GbufferGLTF(std::move(pipeline_result));
+		return GbufferGLTF(std::move(pipeline_result), std::move(instanced_pipeline_result));
 	}
 
 	void GbufferGLTF::PipelineNormal::bind(
 		const gpu::CommandBuffer& command_buffer [[maybe_unused]],
 		const gpu::RenderPass& render_pass,
-		const glm::mat4& camera_matrix
+		const glm::mat4& camera_matrix,
+		const gpu::Buffer& object_buffer
 	) const noexcept
 	{
 		render_pass.bind_pipeline(pipeline);
 		command_buffer.push_uniform_to_vertex(0, util::as_bytes(camera_matrix));
+		render_pass.bind_vertex_storage_buffers(0, object_buffer);
 		render_pass.set_stencil_reference(0x01);
 	}
 
 	void GbufferGLTF::PipelineRigged::bind(
 		const gpu::CommandBuffer& command_buffer [[maybe_unused]],
 		const gpu::RenderPass& render_pass,
-		const glm::mat4& camera_matrix
+		const glm::mat4& camera_matrix,
+		const gpu::Buffer& object_buffer
 	) const noexcept
 	{
 		render_pass.bind_pipeline(pipeline);
 		command_buffer.push_uniform_to_vertex(0, util::as_bytes(camera_matrix));
+		render_pass.bind_vertex_storage_buffers(0, object_buffer);
 		render_pass.set_stencil_reference(0x01);
 	}
 
@@ -413,6 +491,7 @@ namespace render::pipeline
 	}
 
 	void GbufferGLTF::PipelineNormal::set_skin(
+		const gpu::CommandBuffer& command_buffer [[maybe_unused]],
 		const gpu::RenderPass& render_pass [[maybe_unused]],
 		const gltf::DeferredSkinningResource& skinning_resource [[maybe_unused]]
 	) const noexcept
@@ -421,82 +500,190 @@ namespace render::pipeline
 	}
 
 	void GbufferGLTF::PipelineRigged::set_skin(
-		const gpu::RenderPass& render_pass [[maybe_unused]],
-		const gltf::DeferredSkinningResource& skinning_resource [[maybe_unused]]
+		const gpu::CommandBuffer& command_buffer,
+		const gpu::RenderPass& render_pass,
+		const gltf::DeferredSkinningResource& skinning_resource
+	) const noexcept
+	{
+		// Object data is bound at slot 0
+		command_buffer.push_uniform_to_vertex(2, util::as_bytes(skinning_resource.palette));
+		render_pass.bind_vertex_storage_buffers(1, *skinning_resource.joint_matrices_buffer);
+	}
+
+	void GbufferGLTF::PipelineNormal::set_instances(
+		const gpu::CommandBuffer& command_buffer [[maybe_unused]],
+		const gpu::RenderPass& render_pass,
+		const gltf::DeferredInstanceResource& instance_resource
 	) const noexcept
 	{
-		render_pass.bind_vertex_storage_buffers(0, *skinning_resource.joint_matrices_buffer);
+		// Object data is bound at slot 0
+		render_pass.bind_vertex_storage_buffers(1, *instance_resource.instance_buffer);
+	}
+
+	void GbufferGLTF::PipelineRigged::set_instances(
+		const gpu::CommandBuffer& command_buffer [[maybe_unused]],
+		const gpu::RenderPass& render_pass,
+		const gltf::DeferredInstanceResource& instance_resource
+	) const noexcept
+	{
+		// Object data and joint palette are bound at slots 0 and 1
+		render_pass.bind_vertex_storage_buffers(2, *instance_resource.instance_buffer);
 	}
 
 	void GbufferGLTF::PipelineNormal::draw(
 		const gpu::CommandBuffer& command_buffer,
 		const gpu::RenderPass& render_pass,
-		const gltf::PrimitiveDrawcall& drawcall
+		const gltf::PrimitiveDrawcall& drawcall,
+		uint32_t draw_id
 	) const noexcept
 	{
-		const auto per_object_param = PerObjectParam::from(drawcall);
-		command_buffer.push_uniform_to_fragment(1, util::as_bytes(per_object_param));
-		const auto transform = drawcall.get_world_transform();
-		command_buffer.push_uniform_to_vertex(1, util::as_bytes(transform));
+		command_buffer.push_uniform_to_vertex(1, util::as_bytes(draw_id));
 
 		render_pass.bind_vertex_buffers(0, drawcall.primitive.vertex_buffer_binding);
 		render_pass
 			.bind_index_buffer(drawcall.primitive.index_buffer_binding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
-		render_pass.draw_indexed(drawcall.primitive.index_count, 0, 1, 0, 0);
+		render_pass.draw_indexed(drawcall.primitive.index_count, 0, drawcall.instance_count, 0, 0);
+	}
+
+	void GbufferGLTF::PipelineNormal::draw_commands(
+		const gpu::CommandBuffer& command_buffer [[maybe_unused]],
+		const gpu::RenderPass& render_pass,
+		const gltf::PrimitiveDrawcall& drawcall,
+		std::span<const SDL_GPUIndexedIndirectDrawCommand> commands,
+		uint32_t first_command,
+		const GltfFrameBuffers& buffers
+	) const noexcept
+	{
+		draw_gltf_commands(
+			render_pass,
+			drawcall.primitive.vertex_buffer_binding,
+			drawcall.primitive.index_buffer_binding,
+			commands,
+			first_command,
+			buffers
+		);
 	}
 
 	void GbufferGLTF::PipelineRigged::draw(
 		const gpu::CommandBuffer& command_buffer,
 		const gpu::RenderPass& render_pass,
-		const gltf::PrimitiveDrawcall& drawcall
+		const gltf::PrimitiveDrawcall& drawcall,
+		uint32_t draw_id
 	) const noexcept
 	{
-		const auto per_object_param = PerObjectParam::from(drawcall);
-		command_buffer.push_uniform_to_fragment(1, util::as_bytes(per_object_param));
-		command_buffer.push_uniform_to_vertex(1, util::as_bytes(drawcall.get_joint_matrix_offset()));
+		command_buffer.push_uniform_to_vertex(1, util::as_bytes(draw_id));
 
 		render_pass.bind_vertex_buffers(0, drawcall.primitive.vertex_buffer_binding);
 		render_pass
 			.bind_index_buffer(drawcall.primitive.index_buffer_binding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
-		render_pass.draw_indexed(drawcall.primitive.index_count, 0, 1, 0, 0);
+		render_pass.draw_indexed(drawcall.primitive.index_count, 0, drawcall.instance_count, 0, 0);
+	}
+
+	void GbufferGLTF::PipelineRigged::draw_commands(
+		const gpu::CommandBuffer& command_buffer [[maybe_unused]],
+		const gpu::RenderPass& render_pass,
+		const gltf::PrimitiveDrawcall& drawcall,
+		std::span<const SDL_GPUIndexedIndirectDrawCommand> commands,
+		uint32_t first_command,
+		const GltfFrameBuffers& buffers
+	) const noexcept
+	{
+		draw_gltf_commands(
+			render_pass,
+			drawcall.primitive.vertex_buffer_binding,
+			drawcall.primitive.index_buffer_binding,
+			commands,
+			first_command,
+			buffers
+		);
 	}
 
 	void GbufferGLTF::render(
 		const gpu::CommandBuffer& command_buffer,
 		const gpu::RenderPass& gbuffer_pass,
-		const drawdata::Gbuffer& drawdata
+		const drawdata::Gbuffer& drawdata,
+		const drawdata::IndirectDraws& indirect_draws,
+		const GltfFrameBuffers& buffers
 	) const noexcept
 	{
+		const auto commands = indirect_draws.get_commands();
+
 		command_buffer.push_debug_group("Gbuffer Pass");
 		for (const auto& [pipeline_cfg, drawcalls] : drawdata.drawcalls)
 		{
-			const auto& draw_pipeline = pipelines.at(pipeline_cfg);
+			// Instanced and single drawcalls share bins, pipelines are switched between them
+			const PipelineGLTF* draw_pipeline = nullptr;
 
-			draw_pipeline->bind(command_buffer, gbuffer_pass, drawdata.camera_matrix);
+			// Bound state, only rebound when it changes between consecutive batches
+			const gltf::MaterialGPU* bound_material = nullptr;
+			std::optional<size_t> bound_resource_set;
 
-			for (const auto& [drawcall, set_idx, _] : drawcalls)
+			for (const auto& batch : indirect_draws.get_batches(drawcalls))
 			{
-				const auto& resource_set = drawdata.resource_sets[set_idx];
-
-				draw_pipeline->set_material(
-					command_buffer,
-					gbuffer_pass,
-					resource_set.material_cache[drawcall.material_index]
-				);
-
-				if (resource_set.deferred_skinning_resource != nullptr)
-					draw_pipeline->set_skin(gbuffer_pass, *resource_set.deferred_skinning_resource);
-
-				draw_pipeline->draw(command_buffer, gbuffer_pass, drawcall);
+				const auto& entry = drawcalls[batch.first_drawcall];
+				const auto& resource_set = drawdata.resource_sets[entry.resource_set_index];
+
+				// Stale drawcalls were skipped when building batches
+				const auto* const drawcall = resource_set.drawcalls.resolve(entry.drawcall);
+				assert(drawcall != nullptr);
+
+				const bool instanced = drawcall->is_instanced();
+				const auto* const pipeline =
+					(instanced ? instanced_pipelines : pipelines).at(pipeline_cfg).get();
+
+				if (pipeline != draw_pipeline)
+				{
+					draw_pipeline = pipeline;
+					draw_pipeline->bind(
+						command_buffer,
+						gbuffer_pass,
+						drawdata.camera_matrix,
+						buffers.objects
+					);
+
+					bound_material = nullptr;
+					bound_resource_set.reset();
+				}
+
+				const auto& material = resource_set.material_cache[drawcall->material_index];
+				if (&material != bound_material)
+				{
+					bound_material = &material;
+					draw_pipeline->set_material(command_buffer, gbuffer_pass, material);
+				}
+
+				if (bound_resource_set != entry.resource_set_index)
+				{
+					bound_resource_set = entry.resource_set_index;
+
+					if (resource_set.deferred_skinning_resource != nullptr)
+						draw_pipeline->set_skin(
+							command_buffer,
+							gbuffer_pass,
+							*resource_set.deferred_skinning_resource
+						);
+
+					if (instanced)
+						draw_pipeline->set_instances(
+							command_buffer,
+							gbuffer_pass,
+							*resource_set.deferred_instance_resource
+						);
+				}
+
+				if (batch.command_count == 0)
+					draw_pipeline->draw(command_buffer, gbuffer_pass, *drawcall, entry.draw_id);
+				else
+					draw_pipeline->draw_commands(
+						command_buffer,
+						gbuffer_pass,
+						*drawcall,
+						commands.subspan(batch.first_command, batch.command_count),
+						batch.first_command,
+						buffers
+					);
 			}
 		}
 		command_buffer.pop_debug_group();
 	}
-
-	GbufferGLTF::PerObjectParam GbufferGLTF::PerObjectParam::from(
-		const gltf::PrimitiveDrawcall& drawcall
-	) noexcept
-	{
-		return PerObjectParam{.emissive_multiplier = drawcall.emissive_multiplier};
-	}
 }
\ No newline at end of file
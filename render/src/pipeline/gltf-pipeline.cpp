@@ -0,0 +1,65 @@
+#include "render/pipeline/gltf-pipeline.hpp"
+
+#include <cassert>
+
+namespace render::pipeline
+{
+	SDL_GPUVertexBufferDescription get_draw_id_buffer_desc() noexcept
+	{
+		return {
+			.slot = 1,
+			.pitch = sizeof(uint32_t),
+			.input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+			.instance_step_rate = 0
+		};
+	}
+
+	SDL_GPUVertexAttribute get_draw_id_attribute(uint32_t location) noexcept
+	{
+		return {
+			.location = location,
+			.buffer_slot = 1,
+			.format = SDL_GPU_VERTEXELEMENTFORMAT_UINT,
+			.offset = 0
+		};
+	}
+
+	void draw_gltf_commands(
+		const gpu::RenderPass& render_pass,
+		const SDL_GPUBufferBinding& vertex_buffer,
+		const SDL_GPUBufferBinding& index_buffer,
+		std::span<const SDL_GPUIndexedIndirectDrawCommand> commands,
+		uint32_t first_command,
+		const GltfFrameBuffers& buffers
+	) noexcept
+	{
+		assert(!commands.empty());
+
+		render_pass.bind_vertex_buffers(
+			0,
+			vertex_buffer,
+			SDL_GPUBufferBinding{.buffer = buffers.draw_ids, .offset = 0}
+		);
+		render_pass.bind_index_buffer(index_buffer, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+
+		// A single command is drawn directly, saving the indirect buffer read
+		if (commands.size() == 1)
+		{
+			const auto& command = commands.front();
+			render_pass.draw_indexed(
+				command.num_indices,
+				command.first_index,
+				command.num_instances,
+				command.first_instance,
+				command.vertex_offset
+			);
+			return;
+		}
+
+		render_pass.draw_indexed_indirect(
+			buffers.commands,
+			uint32_t(commands.size()),
+			uint32_t(first_command * sizeof(SDL_GPUIndexedIndirectDrawCommand))
+		);
+	}
+}
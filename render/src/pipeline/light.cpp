@@ -354,6 +354,7 @@ namespace render::pipeline
 			command_buffer,
 			gbuffer_target,
 			[&, this](const gpu::RenderPass& render_pass) noexcept {
+				render_pass.set_region(param.screen_size.x, param.screen_size.y);
 				render_pass.bind_pipeline(depth_test_pipeline);
 				render_pass.set_stencil_reference(0x01);
 
@@ -392,6 +393,7 @@ namespace render::pipeline
 			gbuffer_target,
 			light_buffer_target,
 			[&, this](const gpu::RenderPass& render_pass) noexcept {
+				render_pass.set_region(param.screen_size.x, param.screen_size.y);
 				render_pass.set_stencil_reference(0x01);
 
 				for (const auto& drawcall : visible_drawdata)
@@ -1,9 +1,13 @@
 #include "render/pipeline/shadow-gltf.hpp"
 #include "render/pass.hpp"
 
+#include "asset/shader/shadow-instanced.vert.hpp"
+#include "asset/shader/shadow-mask-instanced.vert.hpp"
+#include "asset/shader/shadow-mask-rigged-instanced.vert.hpp"
 #include "asset/shader/shadow-mask-rigged.vert.hpp"
 #include "asset/shader/shadow-mask.frag.hpp"
 #include "asset/shader/shadow-mask.vert.hpp"
+#include "asset/shader/shadow-rigged-instanced.vert.hpp"
 #include "asset/shader/shadow-rigged.vert.hpp"
 #include "asset/shader/shadow.frag.hpp"
 #include "asset/shader/shadow.vert.hpp"
@@ -16,8 +20,12 @@
 #include "util/as-byte.hpp"
 
 #include <SDL3/SDL_gpu.h>
+#include <algorithm>
+#include <cassert>
+#include <optional>
 #include <ranges>
 #include <span>
+#include <vector>
 
 namespace render::pipeline
 {
@@ -107,6 +115,10 @@ namespace render::pipeline
 			gpu::GraphicsShader vertex_mask;
 			gpu::GraphicsShader vertex_rigged;
 			gpu::GraphicsShader vertex_rigged_mask;
+			gpu::GraphicsShader vertex_instanced;
+			gpu::GraphicsShader vertex_mask_instanced;
+			gpu::GraphicsShader vertex_rigged_instanced;
+			gpu::GraphicsShader vertex_rigged_mask_instanced;
 			gpu::GraphicsShader fragment;
 			gpu::GraphicsShader fragment_mask;
 
@@ -121,8 +133,8 @@ namespace render::pipeline
 				gpu::GraphicsShader::Stage::Vertex,
 				0,
 				0,
-				0,
-				2
+				1,
+				1
 			);
 
 			auto vertex_mask_shader = gpu::GraphicsShader::create(
@@ -131,8 +143,8 @@ namespace render::pipeline
 				gpu::GraphicsShader::Stage::Vertex,
 				0,
 				0,
-				0,
-				2
+				1,
+				1
 			);
 
 			auto vertex_rigged_shader = gpu::GraphicsShader::create(
@@ -141,8 +153,8 @@ namespace render::pipeline
 				gpu::GraphicsShader::Stage::Vertex,
 				0,
 				0,
-				1,
-				2
+				2,
+				3
 			);
 
 			auto vertex_rigged_mask_shader = gpu::GraphicsShader::create(
@@ -151,10 +163,50 @@ namespace render::pipeline
 				gpu::GraphicsShader::Stage::Vertex,
 				0,
 				0,
-				1,
+				2,
+				3
+			);
+
+			auto vertex_instanced_shader = gpu::GraphicsShader::create(
+				device,
+				shader_asset::shadow_instanced_vert,
+				gpu::GraphicsShader::Stage::Vertex,
+				0,
+				0,
+				2,
+				2
+			);
+
+			auto vertex_mask_instanced_shader = gpu::GraphicsShader::create(
+				device,
+				shader_asset::shadow_mask_instanced_vert,
+				gpu::GraphicsShader::Stage::Vertex,
+				0,
+				0,
+				2,
 				2
 			);
 
+			auto vertex_rigged_instanced_shader = gpu::GraphicsShader::create(
+				device,
+				shader_asset::shadow_rigged_instanced_vert,
+				gpu::GraphicsShader::Stage::Vertex,
+				0,
+				0,
+				3,
+				3
+			);
+
+			auto vertex_rigged_mask_instanced_shader = gpu::GraphicsShader::create(
+				device,
+				shader_asset::shadow_mask_rigged_instanced_vert,
+				gpu::GraphicsShader::Stage::Vertex,
+				0,
+				0,
+				3,
+				3
+			);
+
 			auto fragment_shader = gpu::GraphicsShader::create(
 				device,
 				shader_asset::shadow_frag,
@@ -178,6 +230,22 @@ namespace render::pipeline
 			if (!vertex_shader) return vertex_shader.error().forward("Create Shadow vertex shader failed");
 			if (!vertex_mask_shader)
 				return vertex_mask_shader.error().forward("Create Shadow Mask vertex shader failed");
+			if (!vertex_instanced_shader)
+				return vertex_instanced_shader.error().forward(
+					"Create Shadow instanced vertex shader failed"
+				);
+			if (!vertex_mask_instanced_shader)
+				return vertex_mask_instanced_shader.error().forward(
+					"Create Shadow Mask instanced vertex shader failed"
+				);
+			if (!vertex_rigged_instanced_shader)
+				return vertex_rigged_instanced_shader.error().forward(
+					"Create Shadow rigged instanced vertex shader failed"
+				);
+			if (!vertex_rigged_mask_instanced_shader)
+				return vertex_rigged_mask_instanced_shader.error().forward(
+					"Create Shadow Mask rigged instanced vertex shader failed"
+				);
 			if (!fragment_shader)
 				return fragment_shader.error().forward("Create Shadow fragment shader failed");
 			if (!fragment_mask_shader)
@@ -188,6 +256,10 @@ namespace render::pipeline
 				.vertex_mask = std::move(*vertex_mask_shader),
 				.vertex_rigged = std::move(*vertex_rigged_shader),
 				.vertex_rigged_mask = std::move(*vertex_rigged_mask_shader),
+				.vertex_instanced = std::move(*vertex_instanced_shader),
+				.vertex_mask_instanced = std::move(*vertex_mask_instanced_shader),
+				.vertex_rigged_instanced = std::move(*vertex_rigged_instanced_shader),
+				.vertex_rigged_mask_instanced = std::move(*vertex_rigged_mask_instanced_shader),
 				.fragment = std::move(*fragment_shader),
 				.fragment_mask = std::move(*fragment_mask_shader)
 			};
@@ -197,7 +269,8 @@ namespace render::pipeline
 			SDL_GPUDevice* device,
 			const Shaders& shaders,
 			gltf::PipelineMode mode,
-			bool rigged
+			bool rigged,
+			bool instanced
 		) noexcept
 		{
 			SDL_GPURasterizerState rasterizer_state;
@@ -227,10 +300,32 @@ namespace render::pipeline
 					{{true, true},   {masked_rigged_vertex_attributes, shaders.vertex_rigged_mask}},
             };
 
+			// (rigged, masked) -> instanced vertex shader
+			const std::map<std::tuple<bool, bool>, std::reference_wrapper<const gpu::GraphicsShader>>
+				instanced_vertex_shader_map = {
+					{{false, false}, shaders.vertex_instanced            },
+					{{false, true},  shaders.vertex_mask_instanced       },
+					{{true, false},  shaders.vertex_rigged_instanced     },
+					{{true, true},   shaders.vertex_rigged_mask_instanced},
+            };
+
 			const auto& fragment_shader = masked ? shaders.fragment_mask : shaders.fragment;
-			const auto& [used_vertex_attributes, vertex_shader] = vertex_attribute_map.at({rigged, masked});
+			const auto& [used_vertex_attributes, single_vertex_shader] =
+				vertex_attribute_map.at({rigged, masked});
+			const auto& vertex_shader =
+				instanced ? instanced_vertex_shader_map.at({rigged, masked}) : single_vertex_shader;
 			const auto& used_vertex_buffer_descs = rigged ? vertex_buffer_rigged_descs : vertex_buffer_descs;
 
+			std::vector attributes(used_vertex_attributes.begin(), used_vertex_attributes.end());
+			std::vector buffer_descs(used_vertex_buffer_descs.begin(), used_vertex_buffer_descs.end());
+
+			// Single drawcalls read their draw id from the draw id stream
+			if (!instanced)
+			{
+				attributes.push_back(get_draw_id_attribute(uint32_t(attributes.size())));
+				buffer_descs.push_back(get_draw_id_buffer_desc());
+			}
+
 			return gpu::GraphicsPipeline::create(
 				device,
 				vertex_shader,
@@ -238,11 +333,16 @@ namespace render::pipeline
 				SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
 				SDL_GPU_SAMPLECOUNT_1,
 				rasterizer_state,
-				used_vertex_attributes,
-				used_vertex_buffer_descs,
+				attributes,
+				buffer_descs,
 				{},
 				depth_stencil_state,
-				std::format("Shadow Gltf Pipeline (mode: {}, rigged: {})", mode.to_string(), rigged)
+				std::format(
+					"Shadow Gltf Pipeline (mode: {}, rigged: {}, instanced: {})",
+					mode.to_string(),
+					rigged,
+					instanced
+				)
 			);
 		}
 	}
@@ -252,62 +352,72 @@ namespace render::pipeline
 		auto shaders = Shaders::create(device);
 		if (!shaders) return shaders.error().forward("Create Shadow shaders failed");
 
-		std::map<std::pair<gltf::PipelineMode, bool>, std::unique_ptr<PipelineGLTF>> pipeline_result;
+		PipelineMap pipeline_result;
+		PipelineMap instanced_pipeline_result;
 
-		for (const auto [alpha_mode, double_sided, rigged] : std::views::cartesian_product(
+		for (const auto [alpha_mode, double_sided, rigged, instanced] : std::views::cartesian_product(
 				 std::array{gltf::AlphaMode::Opaque, gltf::AlphaMode::Mask, gltf::AlphaMode::Blend},
 				 std::array{false, true},
+				 std::array{false, true},
 				 std::array{false, true}
 			 ))
 		{
 			const auto pipeline_cfg =
 				gltf::PipelineMode{.alpha_mode = alpha_mode, .double_sided = double_sided};
 
-			auto pipeline = create_pipeline(device, *shaders, pipeline_cfg, rigged);
+			auto pipeline = create_pipeline(device, *shaders, pipeline_cfg, rigged, instanced);
 
 			if (!pipeline)
 				return pipeline.error().forward(
 					std::format(
-						"Create graphics pipeline failed (alpha_mode: {}, double_sided: {}, rigged: {})",
+						"Create graphics pipeline failed (alpha_mode: {}, double_sided: {}, rigged: {}, "
+						"instanced: {})",
 						static_cast<int>(alpha_mode),
 						double_sided,
-						rigged
+						rigged,
+						instanced
 					)
 				);
 
+			auto& target = instanced ? instanced_pipeline_result : pipeline_result;
+
 			if (rigged)
-				pipeline_result.emplace(
+				target.emplace(
 					std::pair(pipeline_cfg, rigged),
 					std::make_unique<PipelineRigged>(pipeline_cfg, std::move(*pipeline))
 				);
 			else
-				pipeline_result.emplace(
+				target.emplace(
 					std::pair(pipeline_cfg, rigged),
 					std::make_unique<PipelineNormal>(pipeline_cfg, std::move(*pipeline))
 				);
 		}
 
-		return ShadowGLTF(std::move(pipeline_result));
+		return ShadowGLTF(std::move(pipeline_result), std::move(instanced_pipeline_result));
 	}
 
 	void ShadowGLTF::PipelineNormal::bind(
 		const gpu::CommandBuffer& command_buffer,
 		const gpu::RenderPass& render_pass,
-		const glm::mat4& camera_matrix
+		const glm::mat4& camera_matrix,
+		const gpu::Buffer& object_buffer
 	) const noexcept
 	{
 		render_pass.bind_pipeline(pipeline);
 		command_buffer.push_uniform_to_vertex(0, util::as_bytes(camera_matrix));
+		render_pass.bind_vertex_storage_buffers(0, object_buffer);
 	}
 
 	void ShadowGLTF::PipelineRigged::bind(
 		const gpu::CommandBuffer& command_buffer,
 		const gpu::RenderPass& render_pass,
-		const glm::mat4& camera_matrix
+		const glm::mat4& camera_matrix,
+		const gpu::Buffer& object_buffer
 	) const noexcept
 	{
 		render_pass.bind_pipeline(pipeline);
 		command_buffer.push_uniform_to_vertex(0, util::as_bytes(camera_matrix));
+		render_pass.bind_vertex_storage_buffers(0, object_buffer);
 	}
 
 	void ShadowGLTF::PipelineNormal::set_material(
@@ -349,6 +459,7 @@ namespace render::pipeline
 	}
 
 	void ShadowGLTF::PipelineNormal::set_skin(
+		const gpu::CommandBuffer& command_buffer [[maybe_unused]],
 		const gpu::RenderPass& render_pass [[maybe_unused]],
 		const gltf::DeferredSkinningResource& skinning_resource [[maybe_unused]]
 	) const noexcept
@@ -357,87 +468,301 @@ namespace render::pipeline
 	}
 
 	void ShadowGLTF::PipelineRigged::set_skin(
+		const gpu::CommandBuffer& command_buffer,
 		const gpu::RenderPass& render_pass,
 		const gltf::DeferredSkinningResource& skinning_resource
 	) const noexcept
 	{
-		render_pass.bind_vertex_storage_buffers(0, *skinning_resource.joint_matrices_buffer);
+		// Object data is bound at slot 0
+		command_buffer.push_uniform_to_vertex(2, util::as_bytes(skinning_resource.palette));
+		render_pass.bind_vertex_storage_buffers(1, *skinning_resource.joint_matrices_buffer);
+	}
+
+	void ShadowGLTF::PipelineNormal::set_instances(
+		const gpu::CommandBuffer& command_buffer [[maybe_unused]],
+		const gpu::RenderPass& render_pass,
+		const gltf::DeferredInstanceResource& instance_resource
+	) const noexcept
+	{
+		// Object data is bound at slot 0
+		render_pass.bind_vertex_storage_buffers(1, *instance_resource.instance_buffer);
+	}
+
+	void ShadowGLTF::PipelineRigged::set_instances(
+		const gpu::CommandBuffer& command_buffer [[maybe_unused]],
+		const gpu::RenderPass& render_pass,
+		const gltf::DeferredInstanceResource& instance_resource
+	) const noexcept
+	{
+		// Object data and joint palette are bound at slots 0 and 1
+		render_pass.bind_vertex_storage_buffers(2, *instance_resource.instance_buffer);
 	}
 
 	void ShadowGLTF::PipelineNormal::draw(
 		const gpu::CommandBuffer& command_buffer,
 		const gpu::RenderPass& render_pass,
-		const gltf::PrimitiveDrawcall& drawcall
+		const gltf::PrimitiveDrawcall& drawcall,
+		uint32_t draw_id
 	) const noexcept
 	{
-		const auto world_transform = drawcall.get_world_transform();
+		command_buffer.push_uniform_to_vertex(1, util::as_bytes(draw_id));
 
-		command_buffer.push_uniform_to_vertex(1, util::as_bytes(world_transform));
 		render_pass.bind_vertex_buffers(0, drawcall.primitive.shadow_vertex_buffer_binding);
 		render_pass.bind_index_buffer(
 			drawcall.primitive.shadow_index_buffer_binding,
 			SDL_GPU_INDEXELEMENTSIZE_32BIT
 		);
-		render_pass.draw_indexed(drawcall.primitive.index_count, 0, 1, 0, 0);
+		render_pass.draw_indexed(drawcall.primitive.index_count, 0, drawcall.instance_count, 0, 0);
+	}
+
+	void ShadowGLTF::PipelineNormal::draw_commands(
+		const gpu::CommandBuffer& command_buffer [[maybe_unused]],
+		const gpu::RenderPass& render_pass,
+		const gltf::PrimitiveDrawcall& drawcall,
+		std::span<const SDL_GPUIndexedIndirectDrawCommand> commands,
+		uint32_t first_command,
+		const GltfFrameBuffers& buffers
+	) const noexcept
+	{
+		draw_gltf_commands(
+			render_pass,
+			drawcall.primitive.shadow_vertex_buffer_binding,
+			drawcall.primitive.shadow_index_buffer_binding,
+			commands,
+			first_command,
+			buffers
+		);
 	}
 
 	void ShadowGLTF::PipelineRigged::draw(
 		const gpu::CommandBuffer& command_buffer,
 		const gpu::RenderPass& render_pass,
-		const gltf::PrimitiveDrawcall& drawcall
+		const gltf::PrimitiveDrawcall& drawcall,
+		uint32_t draw_id
 	) const noexcept
 	{
-		command_buffer.push_uniform_to_vertex(1, util::as_bytes(drawcall.get_joint_matrix_offset()));
+		command_buffer.push_uniform_to_vertex(1, util::as_bytes(draw_id));
 
 		render_pass.bind_vertex_buffers(0, drawcall.primitive.shadow_vertex_buffer_binding);
 		render_pass.bind_index_buffer(
 			drawcall.primitive.shadow_index_buffer_binding,
 			SDL_GPU_INDEXELEMENTSIZE_32BIT
 		);
-		render_pass.draw_indexed(drawcall.primitive.index_count, 0, 1, 0, 0);
+		render_pass.draw_indexed(drawcall.primitive.index_count, 0, drawcall.instance_count, 0, 0);
 	}
 
-	std::expected<void, util::Error> ShadowGLTF::render(
+	void ShadowGLTF::PipelineRigged::draw_commands(
+		const gpu::CommandBuffer& command_buffer [[maybe_unused]],
+		const gpu::RenderPass& render_pass,
+		const gltf::PrimitiveDrawcall& drawcall,
+		std::span<const SDL_GPUIndexedIndirectDrawCommand> commands,
+		uint32_t first_command,
+		const GltfFrameBuffers& buffers
+	) const noexcept
+	{
+		draw_gltf_commands(
+			render_pass,
+			drawcall.primitive.shadow_vertex_buffer_binding,
+			drawcall.primitive.shadow_index_buffer_binding,
+			commands,
+			first_command,
+			buffers
+		);
+	}
+
+	void ShadowGLTF::render_drawcalls(
 		const gpu::CommandBuffer& command_buffer,
-		const target::Shadow& shadow_target,
-		const drawdata::Shadow& drawdata
+		const gpu::RenderPass& shadow_pass,
+		const drawdata::Shadow::ShadowLevelData& level_data,
+		const drawdata::Shadow::DrawcallBins& drawcall_bins,
+		const drawdata::IndirectDraws& indirect_draws,
+		const GltfFrameBuffers& buffers
 	) const noexcept
 	{
-		command_buffer.push_debug_group("Shadow Pass");
-		for (const auto [level, level_data] : drawdata.csm_levels | std::views::enumerate)
+		const auto vp_matrix = level_data.get_vp_matrix();
+		const auto commands = indirect_draws.get_commands();
+
+		for (const auto& [pipeline_cfg, drawcalls] : drawcall_bins)
 		{
-			auto shadow_pass_result = acquire_shadow_pass(command_buffer, shadow_target, level);
-			if (!shadow_pass_result)
-				return shadow_pass_result.error().forward("Acquire shadow render pass failed");
-			auto shadow_pass = std::move(*shadow_pass_result);
+			// Instanced and single drawcalls share bins, pipelines are switched between them
+			const PipelineGLTF* draw_pipeline = nullptr;
 
-			for (const auto& [pipeline_cfg, drawcalls] : level_data.drawcalls)
+			// Bound state, only rebound when it changes between consecutive batches
+			const gltf::MaterialGPU* bound_material = nullptr;
+			std::optional<size_t> bound_resource_set;
+
+			for (const auto& batch : indirect_draws.get_batches(drawcalls))
 			{
-				const auto& draw_pipeline = pipelines.at(pipeline_cfg);
+				const auto& entry = drawcalls[batch.first_drawcall];
+				const auto& resource_set = level_data.resource_sets[entry.resource_set_index];
+
+				// Stale drawcalls were skipped when building batches
+				const auto* const drawcall = resource_set.drawcalls.resolve(entry.drawcall);
+				assert(drawcall != nullptr);
 
-				draw_pipeline->bind(command_buffer, shadow_pass, level_data.get_vp_matrix());
+				const bool instanced = drawcall->is_instanced();
+				const auto* const pipeline =
+					(instanced ? instanced_pipelines : pipelines).at(pipeline_cfg).get();
 
-				for (const auto& [drawcall, set_idx, _] : drawcalls)
+				if (pipeline != draw_pipeline)
 				{
-					const auto& resource_set = level_data.resource_sets[set_idx];
+					draw_pipeline = pipeline;
+					draw_pipeline->bind(command_buffer, shadow_pass, vp_matrix, buffers.objects);
 
-					draw_pipeline->set_material(
+					bound_material = nullptr;
+					bound_resource_set.reset();
+				}
+
+				const auto& material = resource_set.material_cache[drawcall->material_index];
+				if (&material != bound_material)
+				{
+					bound_material = &material;
+					draw_pipeline->set_material(command_buffer, shadow_pass, material);
+				}
+
+				if (bound_resource_set != entry.resource_set_index)
+				{
+					bound_resource_set = entry.resource_set_index;
+
+					if (resource_set.deferred_skinning_resource != nullptr)
+						draw_pipeline->set_skin(
+							command_buffer,
+							shadow_pass,
+							*resource_set.deferred_skinning_resource
+						);
+
+					if (instanced)
+						draw_pipeline->set_instances(
+							command_buffer,
+							shadow_pass,
+							*resource_set.deferred_instance_resource
+						);
+				}
+
+				if (batch.command_count == 0)
+					draw_pipeline->draw(command_buffer, shadow_pass, *drawcall, entry.draw_id);
+				else
+					draw_pipeline->draw_commands(
 						command_buffer,
 						shadow_pass,
-						resource_set.material_cache[drawcall.material_index]
+						*drawcall,
+						commands.subspan(batch.first_command, batch.command_count),
+						batch.first_command,
+						buffers
 					);
+			}
+		}
+	}
 
-					if (resource_set.deferred_skinning_resource != nullptr)
-						draw_pipeline->set_skin(shadow_pass, *resource_set.deferred_skinning_resource);
+	std::expected<void, util::Error> ShadowGLTF::render_layer(
+		const gpu::CommandBuffer& command_buffer,
+		const target::Shadow& shadow_target,
+		const drawdata::Shadow::ShadowLevelData& level_data,
+		size_t level,
+		target::Shadow::Layer layer,
+		bool clear,
+		const drawdata::IndirectDraws& indirect_draws,
+		const GltfFrameBuffers& buffers
+	) const noexcept
+	{
+		auto shadow_pass_result = acquire_shadow_pass(command_buffer, shadow_target, level, layer, clear);
+		if (!shadow_pass_result)
+			return shadow_pass_result.error().forward("Acquire shadow render pass failed");
+		auto shadow_pass = std::move(*shadow_pass_result);
+
+		const auto& drawcall_bins =
+			layer == target::Shadow::Layer::Static ? level_data.static_drawcalls : level_data.drawcalls;
+		render_drawcalls(
+			command_buffer,
+			shadow_pass,
+			level_data,
+			drawcall_bins,
+			indirect_draws,
+			buffers
+		);
 
-					draw_pipeline->draw(command_buffer, shadow_pass, drawcall);
-				}
+		shadow_pass.end();
+		return {};
+	}
+
+	std::expected<void, util::Error> ShadowGLTF::render(
+		const gpu::CommandBuffer& command_buffer,
+		const target::Shadow& shadow_target,
+		const drawdata::Shadow& drawdata,
+		const drawdata::IndirectDraws& indirect_draws,
+		const GltfFrameBuffers& buffers
+	) const noexcept
+	{
+		using Action = drawdata::Shadow::Action;
+		using Layer = target::Shadow::Layer;
+
+		command_buffer.push_debug_group("Shadow Pass");
+		for (const auto [level, level_data] : drawdata.csm_levels | std::views::enumerate)
+		{
+			if (!level_data.cached)
+			{
+				const auto result = render_layer(
+					command_buffer,
+					shadow_target,
+					level_data,
+					level,
+					Layer::Map,
+					true,
+					indirect_draws,
+					buffers
+				);
+				if (!result) return result.error().forward("Render shadow level failed");
+				continue;
 			}
 
-			shadow_pass.end();
+			if (level_data.action == Action::Skip) continue;
+
+			if (level_data.action == Action::Rebuild)
+			{
+				const auto result = render_layer(
+					command_buffer,
+					shadow_target,
+					level_data,
+					level,
+					Layer::Static,
+					true,
+					indirect_draws,
+					buffers
+				);
+				if (!result) return result.error().forward("Render shadow static layer failed");
+			}
+
+			// Restore the static layer, then draw dynamic casters over it
+			const auto& static_texture = *shadow_target.get_texture(level, Layer::Static);
+			const auto& map_texture = *shadow_target.get_texture(level, Layer::Map);
+			const auto size = static_texture.get_size();
+
+			const auto copy_result = command_buffer.run_copy_pass([&](const gpu::CopyPass& copy_pass) {
+				copy_pass.copy_texture_to_texture(
+					{.texture = *static_texture, .mip_level = 0, .layer = 0, .x = 0, .y = 0, .z = 0},
+					{.texture = *map_texture, .mip_level = 0, .layer = 0, .x = 0, .y = 0, .z = 0},
+					size.x,
+					size.y,
+					1,
+					true
+				);
+			});
+			if (!copy_result) return copy_result.error().forward("Copy shadow static layer failed");
+
+			const auto result = render_layer(
+				command_buffer,
+				shadow_target,
+				level_data,
+				level,
+				Layer::Map,
+				false,
+				indirect_draws,
+				buffers
+			);
+			if (!result) return result.error().forward("Render shadow dynamic casters failed");
 		}
 		command_buffer.pop_debug_group();
 
 		return {};
 	}
-}
\ No newline at end of file
+}
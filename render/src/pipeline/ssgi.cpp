@@ -59,7 +59,9 @@ namespace render::pipeline
 			.near_plane_span = near_plane_span,
 			.near_plane = -near_plane_center_view.z,
 			.max_scene_distance = param.max_scene_distance,
-			.distance_attenuation = param.distance_attenuation
+			.distance_attenuation = param.distance_attenuation,
+			.history_valid = param.history_valid ? 1u : 0u,
+			.prev_resolution = param.prev_resolution
 		};
 	}
 
@@ -99,7 +101,9 @@ namespace render::pipeline
 			.full_resolution = resolution,
 			.near_plane_span = near_plane_span,
 			.near_plane = -near_plane_center_view.z,
-			.time_noise = time_noise
+			.time_noise = time_noise,
+			.history_valid = param.history_valid ? 1u : 0u,
+			.prev_resolution = param.prev_resolution
 		};
 	}
 
@@ -115,7 +119,9 @@ namespace render::pipeline
 			.inv_view_mat = glm::inverse(param.view_mat),
 			.comp_resolution = (resolution + 1u) / 2u,
 			.full_resolution = resolution,
-			.blend_factor = 0.03
+			.blend_factor = 0.03,
+			.history_valid = param.history_valid ? 1u : 0u,
+			.prev_resolution = param.prev_resolution
 		};
 	}
 
@@ -365,10 +371,6 @@ namespace render::pipeline
 		if (!radiance_upsample_result)
 			return radiance_upsample_result.error().forward("Run SSGI radiance upsample failed");
 
-		const auto radiance_add_result =
-			this->render_radiance_add(command_buffer, light_buffer, ssgi_target, resolution);
-		if (!radiance_add_result) return radiance_add_result.error().forward("Run SSGI radiance add failed");
-
 		command_buffer.pop_debug_group();
 
 		return {};
@@ -710,7 +712,7 @@ namespace render::pipeline
 		const gpu::CommandBuffer& command_buffer,
 		const target::LightBuffer& light_buffer,
 		const target::SSGI& ssgi_target,
-		glm::u32vec2 resolution [[maybe_unused]]
+		glm::u32vec2 resolution
 	) const noexcept
 	{
 		command_buffer.push_debug_group("Radiance Add Pass");
@@ -719,7 +721,8 @@ namespace render::pipeline
 			light_buffer.light_texture.current(),
 			std::array{ssgi_target.fullres_radiance_texture->bind_with_sampler(linear_sampler)},
 			{},
-			{}
+			{},
+			resolution
 		);
 		command_buffer.pop_debug_group();
 		return std::move(result).transform_error(util::Error::forward_fn("Radiance add pass failed"));
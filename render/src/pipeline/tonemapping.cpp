@@ -116,12 +116,18 @@ namespace render::pipeline
 		command_buffer.push_uniform_to_fragment(0, util::as_bytes(param));
 
 		command_buffer.push_debug_group("Tonemapping Pass");
-		auto result =
-			FullscreenPass
-				.render(command_buffer, target_texture, sampler_texture_arr, std::nullopt, storage_buffer_arr)
-				.transform_error(util::Error::forward_fn("Render tonemapping pass failed"));
+		const auto render_result = FullscreenPass.render(
+			command_buffer,
+			target_texture,
+			sampler_texture_arr,
+			std::nullopt,
+			storage_buffer_arr,
+			param.render_size
+		);
 		command_buffer.pop_debug_group();
 
-		return result;
+		if (!render_result) return render_result.error().forward("Render tonemapping pass failed");
+
+		return {};
 	}
 }
\ No newline at end of file
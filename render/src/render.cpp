@@ -2,6 +2,7 @@
 #include "backend/imgui.hpp"
 #include "render/const-params.hpp"
 #include "render/drawdata/gbuffer.hpp"
+#include "render/drawdata/object.hpp"
 #include "render/drawdata/shadow.hpp"
 #include "render/pass.hpp"
 #include "render/pipeline/ambient-light.hpp"
@@ -12,106 +13,534 @@
 #include "render/pipeline/tonemapping.hpp"
 #include "util/error.hpp"
 
+#include <algorithm>
+#include <array>
+#include <format>
+#include <future>
 #include <ranges>
 
 namespace render
 {
-	std::expected<Renderer, util::Error> Renderer::create(const backend::SDLcontext& sdl_context) noexcept
+	std::expected<Renderer, util::Error> Renderer::create(
+		const backend::SDLcontext& sdl_context,
+		uint32_t frames_ahead
+	) noexcept
 	{
 		auto pipeline = Pipeline::create(sdl_context);
 		if (!pipeline) return pipeline.error().forward("Create pipeline failed");
 
-		auto target = Target::create(sdl_context.device);
+		auto target = Target::create(sdl_context.device, sdl_context.get_swapchain_texture_format());
 		if (!target) return target.error().forward("Create target failed");
 
+		auto light_cluster = graphics::LightCluster::create({
+			.dimension = {LIGHT_CLUSTER_X, LIGHT_CLUSTER_Y, LIGHT_CLUSTER_Z},
+			.near = LIGHT_CLUSTER_NEAR,
+			.far = LIGHT_CLUSTER_FAR
+		});
+		if (!light_cluster) return light_cluster.error().forward("Create light cluster failed");
+
 		return Renderer(
 			std::move(*pipeline),
 			std::move(*target),
 			graphics::BufferPool(sdl_context.device),
-			graphics::TransferBufferPool(sdl_context.device)
+			graphics::TransferBufferPool(sdl_context.device),
+			graphics::TexturePool(
+				sdl_context.device,
+				{.size_granularity = TARGET_POOL_SIZE_GRANULARITY,
+				 .budget_bytes = TARGET_POOL_BUDGET,
+				 .max_idle_frames = TARGET_POOL_MAX_IDLE_FRAMES}
+			),
+			std::move(*light_cluster),
+			frames_ahead
 		);
 	}
 
-	std::expected<std::tuple<drawdata::Gbuffer, drawdata::Shadow>, util::Error> Renderer::prepare_drawdata(
+	namespace
+	{
+		// Contiguous drawcall range of a drawdata, processed by a single task
+		struct PrepareChunk
+		{
+			size_t drawdata_index;
+			size_t begin;
+			size_t end;
+		};
+
+		// Split drawcalls of every drawdata into chunks, in drawdata and drawcall order
+		std::vector<PrepareChunk> split_prepare_chunks(std::span<const gltf::Drawdata> drawdata_list) noexcept
+		{
+			std::vector<PrepareChunk> chunks;
+
+			for (const auto [drawdata_idx, drawdata] : drawdata_list | std::views::enumerate)
+			{
+				const size_t count = drawdata.primitive_drawcalls.size();
+
+				for (size_t begin = 0; begin < count; begin += PREPARE_CHUNK_SIZE)
+					chunks.push_back(
+						PrepareChunk{
+							.drawdata_index = size_t(drawdata_idx),
+							.begin = begin,
+							.end = std::min(begin + PREPARE_CHUNK_SIZE, count)
+						}
+					);
+			}
+
+			return chunks;
+		}
+
+		// Changes whenever the static partition of a drawdata is rebuilt
+		uint64_t compute_static_signature(std::span<const gltf::Drawdata> drawdata_list) noexcept
+		{
+			uint64_t signature = drawdata_list.size();
+
+			for (const auto& drawdata : drawdata_list)
+			{
+				const auto& partition = drawdata.primitive_drawcalls.static_partition;
+				const uint64_t generation = partition != nullptr ? partition->generation + 1ull : 0ull;
+				signature = (signature * 1099511628211ull) ^ generation;
+			}
+
+			return signature;
+		}
+
+		graphics::ShadowCascadeCache::Config get_shadow_cache_config(size_t level) noexcept
+		{
+			return {
+				.refresh_interval = SHADOW_LEVEL_REFRESH_INTERVAL[level],
+				.refresh_phase = SHADOW_LEVEL_REFRESH_PHASE[level]
+			};
+		}
+	}
+
+	std::expected<Renderer::PreparedDrawdata, util::Error> Renderer::prepare_drawdata(
 		std::span<const gltf::Drawdata> drawdata_list,
 		const Params& params
 	) noexcept
 	{
-		auto deferred_resources = drawdata_list
-			| std::views::transform(&gltf::Drawdata::deferred_skin_resource)
-			| std::views::filter([](const auto& res) { return res != nullptr; });
-
 		const auto camera_matrix = params.camera.proj_matrix * params.camera.view_matrix;
 
-		drawdata::Gbuffer gbuffer_drawdata(camera_matrix, params.camera.eye_position);
-		for (const auto& drawdata : drawdata_list) gbuffer_drawdata.append(drawdata);
+		// Releases drawdata of two frames ago, the previous frame's drawdata stays valid
+		frame_arena.begin_frame();
 
-		drawdata::Shadow shadow_drawdata(
-			camera_matrix,
-			params.primary_light.direction,
-			gbuffer_drawdata.get_min_z(),
-			params.shadow.csm_linear_blend
+		const auto chunks = split_prepare_chunks(drawdata_list);
+		const size_t drawcall_count = std::ranges::fold_left(
+			drawdata_list | std::views::transform([](const auto& drawdata) {
+				return drawdata.primitive_drawcalls.size();
+			}),
+			0zu,
+			std::plus{}
 		);
-		for (const auto& drawdata : drawdata_list) shadow_drawdata.append(drawdata);
 
-		gbuffer_drawdata.sort();
-		shadow_drawdata.sort();
+		// Small scenes run every task on the calling thread, the results are identical
+		const bool parallel = drawcall_count >= PREPARE_PARALLEL_THRESHOLD;
+		std::vector<std::future<void>> pending_tasks;
+
+		const auto dispatch = [this, parallel, &pending_tasks](auto task) {
+			if (parallel)
+				pending_tasks.push_back(prepare_thread_pool->enqueue(std::move(task)));
+			else
+				task();
+		};
+
+		const auto wait_tasks = [&pending_tasks] {
+			for (auto& task : pending_tasks) task.wait();
+			pending_tasks.clear();
+		};
+
+		/* G-buffer culling */
+
+		drawdata::Gbuffer gbuffer_drawdata(camera_matrix, params.camera.eye_position, frame_arena.resource());
+		gbuffer_drawdata.portal_visibility = &params.portal_visibility;
+
+		const auto gbuffer_resource_sets =
+			drawdata_list
+			| std::views::transform([&gbuffer_drawdata](const auto& drawdata) {
+				  return gbuffer_drawdata.add_resource_set(drawdata);
+			  })
+			| std::ranges::to<std::vector>();
+
+		// Occluders are picked from the frustum-culled static drawcalls, then rasterized in bands
+		if (params.function_mask.occlusion_culling)
+		{
+			occlusion_buffer.begin(camera_matrix);
+
+			const auto occluders =
+				gbuffer_drawdata.select_occluders(OCCLUSION_MAX_OCCLUDERS, OCCLUSION_MIN_OCCLUDER_SIZE);
+			for (const auto& occluder : occluders)
+				occlusion_buffer.add_occluder(*occluder.mesh, occluder.transform);
+
+			const auto band_rows = std::views::iota(0u, occlusion_buffer.get_tile_rows())
+								 | std::views::stride(OCCLUSION_BAND_TILE_ROWS);
+			for (const auto row : band_rows)
+				dispatch([this, row] { occlusion_buffer.rasterize(row, row + OCCLUSION_BAND_TILE_ROWS); });
+
+			wait_tasks();
+			gbuffer_drawdata.occlusion_buffer = &occlusion_buffer;
+		}
+
+		std::vector<drawdata::Gbuffer::Partial> gbuffer_partials(chunks.size());
+		for (const auto chunk_idx : std::views::iota(0zu, chunks.size()))
+			dispatch([&, chunk_idx] {
+				const auto& chunk = chunks[chunk_idx];
+				gbuffer_drawdata.cull(
+					drawdata_list[chunk.drawdata_index],
+					gbuffer_resource_sets[chunk.drawdata_index],
+					chunk.begin,
+					chunk.end,
+					gbuffer_partials[chunk_idx]
+				);
+			});
+
+		wait_tasks();
+
+		// Merging in chunk order reproduces the serial drawcall order
+		for (const auto& partial : gbuffer_partials) gbuffer_drawdata.merge(partial);
+
+		/* Shadow culling, overlapped with G-buffer sorting */
+
+		// Visible drawcalls receive shadows, casters reaching none of them are culled
+		const auto receivers = gbuffer_drawdata.collect_visible_bounds();
+		const float shadow_min_z = gbuffer_drawdata.get_min_z();
+
+		dispatch([&gbuffer_drawdata] { gbuffer_drawdata.sort(); });
+
+		// Cached levels use bounds kept across frames, see `graphics::ShadowCascadeCache`
+		const auto create_shadow_drawdata = [&] {
+			if (!params.function_mask.shadow_caching)
+			{
+				for (auto& cache : shadow_caches) cache.invalidate();
+
+				return drawdata::Shadow(
+					camera_matrix,
+					params.primary_light.direction,
+					shadow_min_z,
+					params.shadow.csm_linear_blend,
+					frame_arena.resource()
+				);
+			}
+
+			constexpr std::array resolutions = {SHADOW_LEVEL_RES_0, SHADOW_LEVEL_RES_1, SHADOW_LEVEL_RES_2};
+			const auto slice_corners = drawdata::Shadow::compute_slice_corners(
+				camera_matrix,
+				shadow_min_z,
+				params.shadow.csm_linear_blend
+			);
+
+			std::array<graphics::SmallestBound, 3> bounds;
+			for (const auto level_idx : std::views::iota(0zu, bounds.size()))
+				bounds[level_idx] = shadow_caches[level_idx].fit(
+					slice_corners[level_idx],
+					params.primary_light.direction,
+					resolutions[level_idx],
+					get_shadow_cache_config(level_idx)
+				);
+
+			return drawdata::Shadow(bounds, frame_arena.resource());
+		};
+
+		auto shadow_drawdata = create_shadow_drawdata();
+		auto& csm_levels = shadow_drawdata.csm_levels;
+
+		for (const auto level_idx : std::views::iota(0zu, csm_levels.size()))
+		{
+			auto& receiver_mask = shadow_receiver_masks[level_idx];
+			csm_levels[level_idx].receiver_mask = &receiver_mask;
+
+			dispatch([&receiver_mask, &receivers, bound = csm_levels[level_idx].smallest_bound] {
+				receiver_mask.begin(bound);
+				for (const auto& receiver : receivers) receiver_mask.add_receiver(receiver.min, receiver.max);
+			});
+		}
+
+		// Indexed by `level * drawdata_list.size() + drawdata index`
+		const auto shadow_resource_sets =
+			std::views::cartesian_product(csm_levels, drawdata_list)
+			| std::views::transform([](const auto& pair) {
+				  auto& [level, drawdata] = pair;
+				  return level.add_resource_set(drawdata);
+			  })
+			| std::ranges::to<std::vector>();
+
+		// Receiver masks are read by culling
+		wait_tasks();
+
+		// Indexed by `level * chunks.size() + chunk index`
+		using ShadowPartial = drawdata::Shadow::ShadowLevelData::Partial;
+		std::vector<ShadowPartial> shadow_partials(csm_levels.size() * chunks.size());
+
+		for (const auto [level_idx, chunk_idx] : std::views::cartesian_product(
+				 std::views::iota(0zu, csm_levels.size()),
+				 std::views::iota(0zu, chunks.size())
+			 ))
+			dispatch([&, level_idx, chunk_idx] {
+				const auto& chunk = chunks[chunk_idx];
+				csm_levels[level_idx].cull(
+					drawdata_list[chunk.drawdata_index],
+					shadow_resource_sets[level_idx * drawdata_list.size() + chunk.drawdata_index],
+					chunk.begin,
+					chunk.end,
+					shadow_partials[level_idx * chunks.size() + chunk_idx]
+				);
+			});
+
+		wait_tasks();
+
+		/* Cached levels decide their update, outdated static layers are culled again */
+
+		const uint64_t static_signature = compute_static_signature(drawdata_list);
+
+		// Static casters of rebuilt levels, culled in parallel outside the frame arena and merged afterwards
+		std::vector<ShadowPartial> static_partials(csm_levels.size());
+
+		for (const auto level_idx : std::views::iota(0zu, csm_levels.size()))
+		{
+			auto& level = csm_levels[level_idx];
+
+			const auto level_partials =
+				std::span(shadow_partials).subspan(level_idx * chunks.size(), chunks.size());
+			for (const auto& partial : level_partials) level.merge(partial);
+
+			if (!level.cached) continue;
+
+			// Only dynamic casters are culled so far
+			level.action = shadow_caches[level_idx].decide(
+				{
+					.dynamic_range = {.near = level.near, .far = level.far},
+					.has_dynamic_casters = !level.drawcalls.empty(),
+					.static_signature = static_signature,
+					.frame_index = frame_index
+				},
+				get_shadow_cache_config(level_idx)
+			);
+
+			if (level.action == drawdata::Shadow::Action::Rebuild)
+				dispatch([&, level_idx] {
+					for (const auto [drawdata_idx, drawdata] : drawdata_list | std::views::enumerate)
+						csm_levels[level_idx].cull_static(
+							drawdata,
+							shadow_resource_sets[level_idx * drawdata_list.size() + size_t(drawdata_idx)],
+							static_partials[level_idx]
+						);
+				});
+		}
+
+		wait_tasks();
+
+		for (const auto [level, partial] : std::views::zip(csm_levels, static_partials))
+			if (level.cached && level.action == drawdata::Shadow::Action::Rebuild)
+				level.merge_static(partial);
+
+		/* Shadow sorting, one task per cascade */
+
+		for (const auto level_idx : std::views::iota(0zu, csm_levels.size()))
+		{
+			auto& level = csm_levels[level_idx];
+
+			// Cached levels render with the depth range of their static layer
+			if (level.cached)
+			{
+				auto& cache = shadow_caches[level_idx];
+				const auto config = get_shadow_cache_config(level_idx);
+
+				if (level.action == drawdata::Shadow::Action::Rebuild)
+					cache.commit_rebuild({.near = level.near, .far = level.far}, config);
+
+				const auto depth_range = cache.get_depth_range();
+				level.near = depth_range.near;
+				level.far = depth_range.far;
+			}
+
+			dispatch([&level] { level.sort(); });
+		}
+
+		wait_tasks();
+
+		/* Object data, shared by G-buffer and shadow drawcalls */
+
+		drawdata::ObjectData object_data(frame_arena.resource());
+		object_data.assign(gbuffer_drawdata);
+		object_data.assign(shadow_drawdata);
+
+		/* Draw batches, after draw ids are assigned */
+
+		drawdata::IndirectDraws indirect_draws(frame_arena.resource());
+		indirect_draws.build(gbuffer_drawdata);
+		indirect_draws.build(shadow_drawdata);
+
+		frame_index++;
+
+		return std::make_tuple(
+			std::move(gbuffer_drawdata),
+			std::move(shadow_drawdata),
+			std::move(object_data),
+			std::move(indirect_draws)
+		);
+	}
+
+	std::expected<Renderer::PreparedFrame, util::Error> Renderer::prepare(
+		std::unique_ptr<const FrameSnapshot> snapshot
+	) noexcept
+	{
+		// A frame was dropped since the last call, the shadow updates it decided never happened
+		const uint64_t epoch = shadow_cache_epoch->load(std::memory_order_acquire);
+		if (epoch != prepared_shadow_cache_epoch)
+		{
+			for (auto& cache : shadow_caches) cache.invalidate();
+			prepared_shadow_cache_epoch = epoch;
+		}
+
+		auto prepare_result = prepare_drawdata(snapshot->models, snapshot->params);
+		if (!prepare_result) return prepare_result.error().forward("Prepare drawdata failed");
+		auto& [gbuffer_drawdata, shadow_drawdata, object_data, indirect_draws] = *prepare_result;
+
+		const auto frame_shadow_stats = shadow_drawdata.get_stats();
+		const auto frame_draw_stats = indirect_draws.get_stats();
+
+		return PreparedFrame{
+			.snapshot = std::move(snapshot),
+			.gbuffer_drawdata = std::move(gbuffer_drawdata),
+			.shadow_drawdata = std::move(shadow_drawdata),
+			.object_data = std::move(object_data),
+			.indirect_draws = std::move(indirect_draws),
+			.shadow_cache_epoch = epoch,
+			.shadow_stats = frame_shadow_stats,
+			.draw_stats = frame_draw_stats,
+			.frame_arena_stats = frame_arena.get_stats()
+		};
+	}
+
+	void Renderer::prepare_light_cluster(
+		std::span<const drawdata::Light> lights,
+		const CameraMatrices& camera
+	) noexcept
+	{
+		const auto cluster_lights =
+			lights
+			| std::views::transform(&drawdata::Light::to_cluster_light)
+			| std::views::filter([](const auto& light) { return light.has_value(); })
+			| std::views::transform([](const auto& light) { return *light; })
+			| std::ranges::to<std::vector>();
+
+		light_cluster.begin(camera.view_matrix, camera.proj_matrix, cluster_lights);
+
+		const uint32_t slice_count = light_cluster.get_config().dimension.z;
+
+		// Depth slices are independent, few lights are clustered on the calling thread
+		if (cluster_lights.size() >= LIGHT_CLUSTER_PARALLEL_THRESHOLD)
+		{
+			const auto tasks =
+				std::views::iota(0u, slice_count)
+				| std::views::transform([this](uint32_t slice) {
+					  const auto task = [this, slice] { light_cluster.build_slice(slice); };
+					  return prepare_thread_pool->enqueue(task);
+				  })
+				| std::ranges::to<std::vector>();
+
+			for (const auto& task : tasks) task.wait();
+		}
+		else
+			for (const auto slice : std::views::iota(0u, slice_count)) light_cluster.build_slice(slice);
+
+		light_cluster.finish();
+	}
+
+	std::expected<void, util::Error> Renderer::prepare_skinning_buffers(
+		std::span<const gltf::Drawdata> drawdata_list,
+		gltf::JointPalette joint_palette
+	) noexcept
+	{
+		auto deferred_resources = drawdata_list
+			| std::views::transform(&gltf::Drawdata::deferred_skin_resource)
+			| std::views::filter([](const auto& res) { return res != nullptr; });
+		auto instance_resources = drawdata_list
+			| std::views::transform(&gltf::Drawdata::deferred_instance_resource)
+			| std::views::filter([](const auto& res) { return res != nullptr; });
 
 		transfer_buffer_pool.cycle();
 		buffer_pool.cycle();
 
 		for (const auto& deferred_data : deferred_resources)
 		{
-			const auto prepare_result = deferred_data->prepare_gpu_buffers(buffer_pool, transfer_buffer_pool);
+			const auto prepare_result =
+				deferred_data->prepare_gpu_buffers(buffer_pool, transfer_buffer_pool, joint_palette);
 			if (!prepare_result) return prepare_result.error().forward("Prepare skinning buffers failed");
 		}
 
-		transfer_buffer_pool.gc();
-		buffer_pool.gc();
+		for (const auto& instance_data : instance_resources)
+		{
+			const auto prepare_result = instance_data->prepare_gpu_buffers(buffer_pool, transfer_buffer_pool);
+			if (!prepare_result) return prepare_result.error().forward("Prepare instance buffers failed");
+		}
+
+		transfer_buffer_pool.gc(deletion_queue);
+		buffer_pool.gc(deletion_queue);
 
-		return std::make_tuple(std::move(gbuffer_drawdata), std::move(shadow_drawdata));
+		return {};
 	}
 
 	std::expected<void, util::Error> Renderer::render_gbuffer(
 		const gpu::CommandBuffer& command_buffer,
 		const drawdata::Gbuffer& gbuffer_drawdata,
-		const Params& params [[maybe_unused]]
+		const drawdata::IndirectDraws& indirect_draws,
+		const Params& params [[maybe_unused]],
+		glm::u32vec2 render_size
 	) const noexcept
 	{
-		auto gbuffer_pass =
-			acquire_gbuffer_pass(command_buffer, target.gbuffer_target, target.light_buffer_target);
+		auto gbuffer_pass = acquire_gbuffer_pass(
+			command_buffer,
+			target.gbuffer_target,
+			target.light_buffer_target,
+			render_size
+		);
 		if (!gbuffer_pass) return gbuffer_pass.error().forward("Acquire gbuffer pass failed");
 		{
-			pipeline.gbuffer_gltf.render(command_buffer, *gbuffer_pass, gbuffer_drawdata);
+			pipeline.gbuffer_gltf.render(
+				command_buffer,
+				*gbuffer_pass,
+				gbuffer_drawdata,
+				indirect_draws,
+				get_gltf_frame_buffers()
+			);
 		}
 		gbuffer_pass->end();
 
 		const auto copy_depth_result = pipeline.depth_to_color_copier.copy(
 			command_buffer,
 			*target.gbuffer_target.depth_texture,
-			target.gbuffer_target.depth_value_texture.current()
+			target.gbuffer_target.depth_value_texture.current(),
+			render_size
 		);
 		if (!copy_depth_result) return copy_depth_result.error().forward("Copy depth to color failed");
 
 		return {};
 	}
 
+	pipeline::GltfFrameBuffers Renderer::get_gltf_frame_buffers() const noexcept
+	{
+		return {.objects = *object_buffer, .draw_ids = *draw_id_buffer, .commands = *indirect_buffer};
+	}
+
 	std::expected<void, util::Error> Renderer::copy_resources(
 		const gpu::CommandBuffer& command_buffer,
-		std::span<const gltf::Drawdata> drawdata_list
+		std::span<const gltf::Drawdata> drawdata_list,
+		const backend::ImguiDrawData& ui
 	) const noexcept
 	{
 		auto deferred_resources = drawdata_list
 			| std::views::transform(&gltf::Drawdata::deferred_skin_resource)
 			| std::views::filter([](const auto& res) { return res != nullptr; });
+		auto instance_resources = drawdata_list
+			| std::views::transform(&gltf::Drawdata::deferred_instance_resource)
+			| std::views::filter([](const auto& res) { return res != nullptr; });
 
-		backend::imgui_upload_data(command_buffer);
+		backend::imgui_upload_data(command_buffer, ui);
 
-		const auto copy_deferred_result =
-			command_buffer.run_copy_pass([&deferred_resources](const gpu::CopyPass& copy_pass) {
-				for (const auto& deferred_data : deferred_resources)
-					deferred_data->upload_gpu_buffers(copy_pass);
-			});
+		const auto copy_deferred_result = command_buffer.run_copy_pass([&](const gpu::CopyPass& copy_pass) {
+			for (const auto& deferred_data : deferred_resources) deferred_data->upload_gpu_buffers(copy_pass);
+			for (const auto& instance_data : instance_resources) instance_data->upload_gpu_buffers(copy_pass);
+			object_buffer.upload(copy_pass);
+			draw_id_buffer.upload(copy_pass);
+			indirect_buffer.upload(copy_pass);
+		});
 		if (!copy_deferred_result)
 			return copy_deferred_result.error().forward("Copy deferred skinning buffers failed");
 
@@ -120,7 +549,10 @@ namespace render
 
 	std::expected<void, util::Error> Renderer::render_ao(
 		const gpu::CommandBuffer& command_buffer,
-		const Params& params
+		const Params& params,
+		glm::u32vec2 render_size,
+		glm::u32vec2 prev_render_size,
+		bool history_valid
 	) const noexcept
 	{
 		const auto camera_matrix = params.camera.proj_matrix * params.camera.view_matrix;
@@ -131,10 +563,14 @@ namespace render
 			.proj_mat_inv = glm::inverse(params.camera.proj_matrix),
 			.prev_camera_mat = params.camera.prev_view_proj_matrix,
 			.radius = params.ambient.ao_radius,
-			.blend_alpha = params.ambient.ao_blend_ratio
+			// Without history, the reprojected AO of recreated targets is discarded
+			.blend_alpha = history_valid ? params.ambient.ao_blend_ratio : 1.0f,
+			.render_size = glm::vec2(render_size),
+			.prev_render_size = glm::vec2(prev_render_size)
 		};
 
-		auto ao_pass = acquire_ao_pass(command_buffer, target.ao_target);
+		// Half-resolution AO covers the rounded-up half of the render region
+		auto ao_pass = acquire_ao_pass(command_buffer, target.ao_target, (render_size + 1u) / 2u);
 		if (!ao_pass) return ao_pass.error().forward("Acquire AO pass failed");
 		pipeline.ao.render(command_buffer, *ao_pass, target.ao_target, target.gbuffer_target, ao_params);
 		ao_pass->end();
@@ -145,7 +581,7 @@ namespace render
 		const gpu::CommandBuffer& command_buffer,
 		const drawdata::Shadow& shadow_drawdata,
 		const Params& params,
-		glm::u32vec2 swapchain_size
+		glm::u32vec2 render_size
 	) const noexcept
 	{
 		const pipeline::Directional_light::Params dirlight_params = {
@@ -165,15 +601,19 @@ namespace render
 
 		const pipeline::SkyPreetham::Params sky_params = {
 			.camera_mat_inv = glm::inverse(params.camera.proj_matrix * params.camera.view_matrix),
-			.screen_size = swapchain_size,
+			.screen_size = render_size,
 			.eye_position = params.camera.eye_position,
 			.sun_direction = params.primary_light.direction,
 			.sun_intensity = params.primary_light.intensity * params.sky.brightness_mult / REF_LUMINANCE,
 			.turbidity = params.sky.turbidity
 		};
 
-		auto lighting_pass =
-			acquire_lighting_pass(command_buffer, target.light_buffer_target, target.gbuffer_target);
+		auto lighting_pass = acquire_lighting_pass(
+			command_buffer,
+			target.light_buffer_target,
+			target.gbuffer_target,
+			render_size
+		);
 		if (!lighting_pass) return lighting_pass.error().forward("Acquire lighting pass failed");
 
 		pipeline.directional_light.render(
@@ -204,13 +644,13 @@ namespace render
 		const target::LightBuffer& light_buffer_target,
 		std::span<const drawdata::Light> lights,
 		const Params& params,
-		glm::u32vec2 swapchain_size
+		glm::u32vec2 render_size
 	) const noexcept
 	{
 		const pipeline::Light::Param point_light_param = {
 			.camera_view_projection = params.camera.proj_matrix * params.camera.view_matrix,
 			.eye_position = params.camera.eye_position,
-			.screen_size = swapchain_size
+			.screen_size = render_size
 		};
 
 		const auto render_result =
@@ -225,7 +665,9 @@ namespace render
 		const gpu::CommandBuffer& command_buffer,
 		const drawdata::Gbuffer& gbuffer_drawdata,
 		const Params& params,
-		glm::u32vec2 swapchain_size
+		glm::u32vec2 render_size,
+		glm::u32vec2 prev_render_size,
+		bool history_valid
 	) const noexcept
 	{
 		const pipeline::SSGI::Param ssgi_params = {
@@ -233,7 +675,9 @@ namespace render
 			.view_mat = params.camera.view_matrix,
 			.prev_view_proj_mat = params.camera.prev_view_proj_matrix,
 			.max_scene_distance = gbuffer_drawdata.get_max_distance(),
-			.distance_attenuation = 0.0
+			.distance_attenuation = 0.0,
+			.history_valid = history_valid,
+			.prev_resolution = prev_render_size
 		};
 
 		const auto ssgi_result = pipeline.ssgi.render(
@@ -242,7 +686,7 @@ namespace render
 			target.gbuffer_target,
 			target.ssgi_target,
 			ssgi_params,
-			swapchain_size
+			render_size
 		);
 		if (!ssgi_result) return ssgi_result.error().forward("Render SSGI failed");
 
@@ -251,7 +695,7 @@ namespace render
 
 	std::expected<void, util::Error> Renderer::compute_auto_exposure(
 		const gpu::CommandBuffer& command_buffer,
-		glm::u32vec2 swapchain_size
+		glm::u32vec2 render_size
 	) const noexcept
 	{
 		const pipeline::AutoExposure::Params auto_exposure_params = {
@@ -266,7 +710,7 @@ namespace render
 			target.auto_exposure_target,
 			target.light_buffer_target,
 			auto_exposure_params,
-			swapchain_size
+			render_size
 		);
 		if (!auto_exposure_result)
 			return auto_exposure_result.error().forward("Compute auto exposure failed");
@@ -277,7 +721,7 @@ namespace render
 	std::expected<void, util::Error> Renderer::render_bloom(
 		const gpu::CommandBuffer& command_buffer,
 		const Params& params,
-		glm::u32vec2 swapchain_size
+		glm::u32vec2 render_size
 	) const noexcept
 	{
 		const pipeline::Bloom::Param bloom_render_params = {
@@ -291,7 +735,7 @@ namespace render
 			target.bloom_target,
 			target.auto_exposure_target,
 			bloom_render_params,
-			swapchain_size
+			render_size
 		);
 		if (!bloom_result) return bloom_result.error().forward("Render bloom failed");
 
@@ -302,13 +746,16 @@ namespace render
 		SDL_GPUDevice* device,
 		const gpu::CommandBuffer& command_buffer,
 		const Params& params,
+		glm::u32vec2 target_size,
+		glm::u32vec2 render_size,
 		glm::u32vec2 swapchain_size,
 		SDL_GPUTexture* swapchain
 	) noexcept
 	{
 		const pipeline::Tonemapping::Param tonemapping_params = {
 			.bloom_strength = params.bloom.bloom_strength,
-			.use_bloom_mask = params.function_mask.use_bloom_mask
+			.use_bloom_mask = params.function_mask.use_bloom_mask,
+			.render_size = render_size
 		};
 
 		const auto tonemapping_result = pipeline.tonemapping.render(
@@ -321,45 +768,406 @@ namespace render
 		);
 		if (!tonemapping_result) return tonemapping_result.error().forward("Render tonemapping failed");
 
+		// The render region differs from the swapchain while it is being resized, or with dynamic resolution.
+		// The region is antialiased into the upscale texture, then scaled to the swapchain.
+		const bool upscale = render_size != swapchain_size;
+
+		if (upscale)
+		{
+			const auto resize_result =
+				target.composite_target.resize_upscale(device, target_pool, target_size);
+			if (!resize_result) return resize_result.error().forward("Resize upscale texture failed");
+		}
+
+		SDL_GPUTexture* const aa_output = upscale ? *target.composite_target.upscale_texture : swapchain;
+
 		const auto aa_result = pipeline.aa_module.run(
 			device,
 			command_buffer,
 			*target.composite_target.composite_texture,
-			swapchain,
-			swapchain_size,
+			aa_output,
+			target_size,
+			render_size,
 			params.aa_mode
 		);
 		if (!aa_result) return aa_result.error().forward("Run antialiasing failed");
 
+		if (upscale)
+		{
+			const SDL_GPUBlitInfo blit_info = {
+				.source = {.texture = aa_output, .w = render_size.x, .h = render_size.y},
+				.destination = {.texture = swapchain, .w = swapchain_size.x, .h = swapchain_size.y},
+				.load_op = SDL_GPU_LOADOP_DONT_CARE,
+				.filter = SDL_GPU_FILTER_LINEAR
+			};
+
+			command_buffer.blit_texture(blit_info);
+		}
+
 		return {};
 	}
 
 	std::expected<void, util::Error> Renderer::render_imgui(
 		const gpu::CommandBuffer& command_buffer,
+		const backend::ImguiDrawData& ui,
 		SDL_GPUTexture* swapchain
 	) const noexcept
 	{
 		auto swapchain_pass = acquire_swapchain_pass(command_buffer, swapchain, false);
 		if (!swapchain_pass) return swapchain_pass.error().forward("Acquire swapchain pass failed");
 		{
-			backend::imgui_draw_to_renderpass(command_buffer, *swapchain_pass);
+			backend::imgui_draw_to_renderpass(command_buffer, *swapchain_pass, ui);
 		}
 		swapchain_pass->end();
 
 		return {};
 	}
 
+	Renderer::FrameGraph Renderer::build_frame_graph(const FrameInputs& frame) noexcept
+	{
+		using Desc = graphics::RenderGraph::TextureDesc;
+
+		graphics::RenderGraph graph;
+		FrameTransients transients;
+
+		// Graph textures are described by their allocation, passes render into the top-left region
+		const auto full_size = frame.target_size;
+		const auto half_size = (full_size + 1u) / 2u;
+
+		/* Targets outliving the frame, history textures are read back by the next frame */
+
+		auto depth_value = graph.import_texture(
+			"Depth Value",
+			{.format = target::Gbuffer::depth_value_format,
+			 .size = full_size,
+			 .mip_levels = target::Gbuffer::hiz_mip_levels},
+			false
+		);
+		auto light_buffer = graph.import_texture(
+			"Light Buffer",
+			{.format = target::LightBuffer::light_buffer_format, .size = full_size},
+			false
+		);
+		auto ao = graph.import_texture(
+			"AO",
+			{.format = target::AO::ao_format, .size = target.ao_target.halfres_ao_texture.get_size()},
+			false
+		);
+		auto ssgi_history = graph.import_texture(
+			"SSGI Reservoirs",
+			{.format = target::SSGI::reservoir_texture1_format, .size = half_size},
+			false
+		);
+		auto exposure = graph.import_buffer(
+			"Exposure",
+			{.usage = {.compute_storage_read = true, .compute_storage_write = true},
+			 .size = sizeof(float) * 2},
+			false
+		);
+
+		// Static layers are cached across frames, so shadow maps are imported too
+		const std::array shadow_sizes = {SHADOW_LEVEL_RES_0, SHADOW_LEVEL_RES_1, SHADOW_LEVEL_RES_2};
+		std::array<graphics::RenderGraph::Handle, 3> shadow_maps;
+		for (const auto [level, size] : shadow_sizes | std::views::enumerate)
+			shadow_maps[level] = graph.import_texture(
+				std::format("Shadow Map Level {}", level),
+				{.format = target::Shadow::depth_format, .size = glm::u32vec2(size)},
+				false
+			);
+
+		// Format is chosen by the window
+		auto swapchain = graph.import_texture(
+			"Swapchain",
+			{.format = {SDL_GPU_TEXTURETYPE_2D, SDL_GPU_TEXTUREFORMAT_INVALID, {.color_target = true}},
+			 .size = full_size},
+			true
+		);
+
+		/* Transient targets, backed by the allocations of the compiled graph */
+
+		auto depth = transients.depth =
+			graph.create_texture("Depth", {.format = target::Gbuffer::depth_format, .size = full_size});
+		auto albedo = transients.albedo =
+			graph.create_texture("Albedo", {.format = target::Gbuffer::albedo_format, .size = full_size});
+		auto lighting_info = transients.lighting_info = graph.create_texture(
+			"Lighting Info",
+			{.format = target::Gbuffer::lighting_info_format, .size = full_size}
+		);
+		auto ssgi_diffuse = transients.ssgi_blurred_diffuse = graph.create_texture(
+			"SSGI Blurred Diffuse",
+			{.format = target::SSGI::radiance_texture_format, .size = half_size}
+		);
+		auto ssgi_radiance = transients.ssgi_radiance = graph.create_texture(
+			"SSGI Radiance",
+			{.format = target::SSGI::radiance_texture_format, .size = full_size}
+		);
+		auto bloom_filter = transients.bloom_filter = graph.create_texture(
+			"Bloom Filter",
+			{.format = target::Bloom::format,
+			 .size = full_size,
+			 .mip_levels = target::Bloom::downsample_mip_count}
+		);
+		auto composite = transients.composite = graph.create_texture(
+			"Composite",
+			{.format = target::Composite::composite_format, .size = full_size}
+		);
+
+		// Bloom mip chains, mip N of both chains is sized like the downsample mip N
+		std::vector<graphics::RenderGraph::Handle> bloom_chain;
+		auto bloom_mip_size = full_size / 2u;
+		for (const auto mip : std::views::iota(0zu, target::Bloom::downsample_mip_count))
+		{
+			const Desc desc = {.format = target::Bloom::format, .size = bloom_mip_size};
+
+			transients.bloom_downsample[mip] =
+				graph.create_texture(std::format("Bloom Downsample {}", mip), desc);
+			bloom_chain.push_back(transients.bloom_downsample[mip]);
+
+			if (mip < target::Bloom::upsample_mip_count)
+			{
+				transients.bloom_upsample[mip] =
+					graph.create_texture(std::format("Bloom Upsample {}", mip), desc);
+				bloom_chain.push_back(transients.bloom_upsample[mip]);
+			}
+
+			bloom_mip_size /= 2u;
+		}
+
+		/* Passes */
+
+		{
+			auto pass = graph.add_pass("G-buffer", [this, &frame] {
+				return render_gbuffer(
+					frame.command_buffer,
+					frame.gbuffer_drawdata,
+					frame.indirect_draws,
+					frame.params,
+					frame.render_size
+				);
+			});
+			depth = pass.write(depth);
+			albedo = pass.write(albedo);
+			lighting_info = pass.write(lighting_info);
+			depth_value = pass.write(depth_value);
+			light_buffer = pass.write(light_buffer);
+		}
+
+		{
+			auto pass = graph.add_pass("Hi-Z", [this, &frame] {
+				return pipeline.hiz_generator
+					.generate(frame.command_buffer, target.gbuffer_target, frame.render_size);
+			});
+			depth_value = pass.write(depth_value);
+		}
+
+		{
+			auto pass = graph.add_pass("Shadow", [this, &frame] {
+				return pipeline.shadow_gltf.render(
+					frame.command_buffer,
+					target.shadow_target,
+					frame.shadow_drawdata,
+					frame.indirect_draws,
+					get_gltf_frame_buffers()
+				);
+			});
+			for (auto& shadow_map : shadow_maps) shadow_map = pass.write(shadow_map);
+		}
+
+		{
+			auto pass = graph.add_pass("AO", [this, &frame] {
+				return render_ao(
+					frame.command_buffer,
+					frame.params,
+					frame.render_size,
+					frame.prev_render_size,
+					frame.history_valid
+				);
+			});
+			pass.read(depth_value);
+			pass.read(lighting_info);
+			ao = pass.write(ao);
+		}
+
+		{
+			auto pass = graph.add_pass("Lighting", [this, &frame] {
+				return render_lighting(
+					frame.command_buffer,
+					frame.shadow_drawdata,
+					frame.params,
+					frame.render_size
+				);
+			});
+			pass.read(albedo);
+			pass.read(lighting_info);
+			pass.read(depth_value);
+			pass.read(ao);
+			for (const auto& shadow_map : shadow_maps) pass.read(shadow_map);
+			depth = pass.write(depth);
+			light_buffer = pass.write(light_buffer);
+		}
+
+		{
+			auto pass = graph.add_pass("Lights", [this, &frame] {
+				return render_lights(
+					frame.command_buffer,
+					target.gbuffer_target,
+					target.light_buffer_target,
+					frame.lights,
+					frame.params,
+					frame.render_size
+				);
+			});
+			pass.read(albedo);
+			pass.read(lighting_info);
+			pass.read(depth_value);
+			light_buffer = pass.write(light_buffer);
+		}
+
+		// Only "SSGI Add" depends on the frame setting, tracing is culled along with it
+		{
+			auto pass = graph.add_pass("SSGI", [this, &frame] {
+				return render_ssgi(
+					frame.command_buffer,
+					frame.gbuffer_drawdata,
+					frame.params,
+					frame.render_size,
+					frame.prev_render_size,
+					frame.history_valid
+				);
+			});
+			pass.read(light_buffer);
+			pass.read(albedo);
+			pass.read(lighting_info);
+			pass.read(depth_value);
+			ssgi_history = pass.write(ssgi_history);
+			ssgi_diffuse = pass.write(ssgi_diffuse);
+			ssgi_radiance = pass.write(ssgi_radiance);
+		}
+
+		if (frame.params.function_mask.ssgi)
+		{
+			auto pass = graph.add_pass("SSGI Add", [this, &frame] {
+				return pipeline.ssgi.render_radiance_add(
+					frame.command_buffer,
+					target.light_buffer_target,
+					target.ssgi_target,
+					frame.render_size
+				);
+			});
+			pass.read(ssgi_radiance);
+			light_buffer = pass.write(light_buffer);
+		}
+
+		{
+			auto pass = graph.add_pass("Auto Exposure", [this, &frame] {
+				return compute_auto_exposure(frame.command_buffer, frame.render_size);
+			});
+			pass.read(light_buffer);
+			exposure = pass.write(exposure);
+		}
+
+		{
+			auto pass = graph.add_pass("Bloom", [this, &frame] {
+				return render_bloom(frame.command_buffer, frame.params, frame.render_size);
+			});
+			pass.read(light_buffer);
+			pass.read(exposure);
+			bloom_filter = pass.write(bloom_filter);
+			for (auto& mip : bloom_chain) mip = pass.write(mip);
+		}
+
+		{
+			auto pass = graph.add_pass("Composite", [this, &frame] {
+				return render_composite(
+					frame.device,
+					frame.command_buffer,
+					frame.params,
+					frame.target_size,
+					frame.render_size,
+					frame.swapchain_size,
+					frame.swapchain
+				);
+			});
+			pass.read(light_buffer);
+			pass.read(exposure);
+			for (const auto& mip : bloom_chain) pass.read(mip);
+			composite = pass.write(composite);
+			swapchain = pass.write(swapchain);
+		}
+
+		{
+			auto pass = graph.add_pass("ImGui", [this, &frame] {
+				return render_imgui(frame.command_buffer, frame.ui, frame.swapchain);
+			});
+			swapchain = pass.write(swapchain);
+		}
+
+		return {.graph = std::move(graph), .transients = transients};
+	}
+
+	void Renderer::bind_transient_textures(const FrameTransients& transients) noexcept
+	{
+		const auto get = [this](graphics::RenderGraph::Handle handle) {
+			return transient_textures.get(handle);
+		};
+
+		target.gbuffer_target.depth_texture = get(transients.depth);
+		target.gbuffer_target.albedo_texture = get(transients.albedo);
+		target.gbuffer_target.lighting_info_texture = get(transients.lighting_info);
+		target.ssgi_target.blurred_diffuse_texture = get(transients.ssgi_blurred_diffuse);
+		target.ssgi_target.fullres_radiance_texture = get(transients.ssgi_radiance);
+		target.composite_target.composite_texture = get(transients.composite);
+
+		target::Bloom::DownsampleChain downsample_chain;
+		target::Bloom::UpsampleChain upsample_chain;
+		std::ranges::transform(transients.bloom_downsample, downsample_chain.begin(), get);
+		std::ranges::transform(transients.bloom_upsample, upsample_chain.begin(), get);
+		target.bloom_target.bind(get(transients.bloom_filter), downsample_chain, upsample_chain);
+	}
+
 	std::expected<void, util::Error> Renderer::render(
 		const backend::SDLcontext& sdl_context,
-		Drawdata drawdata,
-		const Params& params
+		PreparedFrame prepared
 	) noexcept
 	{
+		const auto& [models, lights, params, ui] = *prepared.snapshot;
+		const auto& gbuffer_drawdata = prepared.gbuffer_drawdata;
+		const auto& shadow_drawdata = prepared.shadow_drawdata;
+		const auto& object_data = prepared.object_data;
+		const auto& indirect_draws = prepared.indirect_draws;
+
+		// CPU interval between frames, includes waiting for the GPU when it is the bottleneck
+		const auto frame_start = std::chrono::steady_clock::now();
+		const float frame_time = last_frame_start.has_value()
+			? std::chrono::duration<float>(frame_start - *last_frame_start).count()
+			: 0.0f;
+		last_frame_start = frame_start;
+
+		frame_arena_stats = prepared.frame_arena_stats;
+		shadow_stats = prepared.shadow_stats;
+		draw_stats = prepared.draw_stats;
+
+		// Prepared before a dropped frame, cached shadow levels would reuse updates that never happened
+		if (prepared.shadow_cache_epoch != shadow_cache_epoch->load(std::memory_order_relaxed)) return {};
+
 		/* Preparation */
 
-		auto prepare_result = prepare_drawdata(drawdata.models, params);
-		if (!prepare_result) return prepare_result.error().forward("Prepare drawdata failed");
-		const auto [gbuffer_drawdata, shadow_drawdata] = std::move(*prepare_result);
+		const auto skinning_result = prepare_skinning_buffers(models, params.joint_palette);
+		if (!skinning_result) return skinning_result.error().forward("Prepare skinning failed");
+
+		const auto object_result =
+			object_buffer.update(sdl_context.device, std::as_bytes(object_data.get_entries()));
+		if (!object_result) return object_result.error().forward("Update object data failed");
+
+		const auto draw_id_result =
+			draw_id_buffer.update(sdl_context.device, std::as_bytes(indirect_draws.get_draw_ids()));
+		if (!draw_id_result) return draw_id_result.error().forward("Update draw ids failed");
+
+		const auto indirect_result =
+			indirect_buffer.update(sdl_context.device, std::as_bytes(indirect_draws.get_commands()));
+		if (!indirect_result) return indirect_result.error().forward("Update indirect draw commands failed");
+
+		if (params.function_mask.light_clustering) prepare_light_cluster(lights, params.camera);
 
 		/* Acquire Command Buffer */
 
@@ -376,75 +1184,97 @@ namespace render
 
 		if (swapchain_texture == nullptr)
 		{
-			if (const auto result = command_buffer->submit(); !result)
-				return result.error().forward("Submit command buffer failed");
+			// Decided shadow updates are dropped with the frame, caches are invalidated by the next `prepare`
+			shadow_cache_epoch->fetch_add(1, std::memory_order_release);
 
-			return {};
+			return submit(std::move(*command_buffer));
 		}
 
 		/* Resize */
 
-		if (const auto result = target.resize_or_cycle(sdl_context.device, swapchain_size); !result)
+		// Targets follow the swapchain once its size is stable, until then the image is scaled in composite
+		const glm::u32vec2 full_size = target_size_hysteresis.update(swapchain_size);
+
+		if (params.function_mask.dynamic_resolution)
+			dynamic_resolution.update(frame_time);
+		else
+			dynamic_resolution.reset();
+
+		// Region rendered at the top-left corner of the targets, scaled to the swapchain in composite
+		const glm::u32vec2 render_size =
+			graphics::DynamicResolution::scale_size(full_size, dynamic_resolution.get_scale());
+
+		// Targets are allocated at the size bucket of the full size, the largest render size. Scale changes
+		// only move the viewport of the passes, targets are never reallocated by dynamic resolution.
+		const glm::u32vec2 target_size = target_pool.get_bucket(full_size);
+
+		// History survives render size changes within the same targets, it is reprojected from the region of
+		// the previous frame. Only reallocated targets lose it.
+		const bool history_valid = target_size == history_target_size;
+		const glm::u32vec2 prev_render_size = history_valid ? history_render_size : render_size;
+		history_target_size = target_size;
+		history_render_size = render_size;
+
+		if (const auto result = target.resize_or_cycle(sdl_context.device, target_pool, target_size); !result)
 			return result.error().forward("Resize or cycle render targets failed");
 
 		/* Copy */
 
-		const auto copy_result = copy_resources(*command_buffer, drawdata.models);
+		const auto copy_result = copy_resources(*command_buffer, models, ui);
 		if (!copy_result) return copy_result.error().forward("Copy resources failed");
 
 		/* Render */
 
-		const auto gbuffer_result = render_gbuffer(*command_buffer, gbuffer_drawdata, params);
-		if (!gbuffer_result) return gbuffer_result.error().forward("Render G-buffer failed");
-
-		const auto hiz_result =
-			pipeline.hiz_generator.generate(*command_buffer, target.gbuffer_target, swapchain_size);
-		if (!hiz_result) return hiz_result.error().forward("Generate Hi-Z failed");
-
-		const auto shadow_result =
-			pipeline.shadow_gltf.render(*command_buffer, target.shadow_target, shadow_drawdata);
-		if (!shadow_result) return shadow_result.error().forward("Render shadow failed");
-
-		const auto ao_result = render_ao(*command_buffer, params);
-		if (!ao_result) return ao_result.error().forward("Render AO failed");
+		const FrameInputs frame = {
+			.device = sdl_context.device,
+			.command_buffer = *command_buffer,
+			.gbuffer_drawdata = gbuffer_drawdata,
+			.shadow_drawdata = shadow_drawdata,
+			.indirect_draws = indirect_draws,
+			.lights = lights,
+			.params = params,
+			.ui = ui,
+			.target_size = target_size,
+			.render_size = render_size,
+			.history_valid = history_valid,
+			.prev_render_size = prev_render_size,
+			.swapchain_size = swapchain_size,
+			.swapchain = swapchain_texture
+		};
 
-		const auto lighting_result =
-			render_lighting(*command_buffer, shadow_drawdata, params, swapchain_size);
-		if (!lighting_result) return lighting_result.error().forward("Render lighting failed");
+		const auto frame_graph = build_frame_graph(frame);
 
-		const auto primary_lights_result = render_lights(
-			*command_buffer,
-			target.gbuffer_target,
-			target.light_buffer_target,
-			drawdata.lights,
-			params,
-			swapchain_size
-		);
-		if (!primary_lights_result)
-			return primary_lights_result.error().forward("Render primary lights failed");
+		const auto compiled_graph = frame_graph.graph.compile();
+		if (!compiled_graph) return compiled_graph.error().forward("Compile frame graph failed");
+		frame_graph_stats = compiled_graph->stats;
 
-		if (params.function_mask.ssgi)
+		if (frame_graph_dump_requested)
 		{
-			const auto ssgi_result = render_ssgi(*command_buffer, gbuffer_drawdata, params, swapchain_size);
-			if (!ssgi_result) return ssgi_result.error().forward("Render SSGI failed");
+			frame_graph_dump = frame_graph.graph.to_graphviz(*compiled_graph);
+			frame_graph_dump_requested = false;
 		}
 
-		const auto auto_exposure_result = compute_auto_exposure(*command_buffer, swapchain_size);
-		if (!auto_exposure_result)
-			return auto_exposure_result.error().forward("Compute auto exposure failed");
+		// Transient targets used by kept passes share the textures of their allocations
+		if (const auto result = transient_textures.realize(target_pool, *compiled_graph); !result)
+			return result.error().forward("Realize transient textures failed");
+		bind_transient_textures(frame_graph.transients);
 
-		const auto bloom_result = render_bloom(*command_buffer, params, swapchain_size);
-		if (!bloom_result) return bloom_result.error().forward("Render bloom failed");
+		if (const auto result = frame_graph.graph.execute(*compiled_graph); !result)
+			return result.error().forward("Execute frame graph failed");
 
-		const auto composite_result =
-			render_composite(sdl_context.device, *command_buffer, params, swapchain_size, swapchain_texture);
-		if (!composite_result) return composite_result.error().forward("Render composite failed");
+		return submit(std::move(*command_buffer));
+	}
+
+	std::expected<void, util::Error> Renderer::submit(gpu::CommandBuffer command_buffer) noexcept
+	{
+		auto fence = command_buffer.submit_and_acquire_fence();
+		if (!fence) return fence.error().forward("Submit command buffer failed");
 
-		const auto imgui_result = render_imgui(*command_buffer, swapchain_texture);
-		if (!imgui_result) return imgui_result.error().forward("Render ImGui failed");
+		// Evicted targets go through the deletion queue, the submitted frame may still use them
+		target_pool.collect(deletion_queue);
 
-		const auto submit_result = command_buffer->submit();
-		if (!submit_result) return submit_result.error().forward("Submit command buffer failed");
+		deletion_queue.submit(std::move(*fence));
+		deletion_queue.collect();
 
 		return {};
 	}
@@ -3,9 +3,13 @@
 
 namespace render::target
 {
-	std::expected<void, util::Error> AO::cycle(SDL_GPUDevice* device, glm::u32vec2 size) noexcept
+	std::expected<void, util::Error> AO::cycle(
+		SDL_GPUDevice* device,
+		graphics::TexturePool& pool,
+		glm::u32vec2 size
+	) noexcept
 	{
-		if (auto result = halfres_ao_texture.resize_and_cycle(device, size / 2u); !result)
+		if (auto result = halfres_ao_texture.resize_and_cycle(device, size / 2u, &pool); !result)
 			return result.error().forward("Resize AO texture failed");
 		return {};
 	}
@@ -2,10 +2,14 @@
 
 namespace render::target
 {
-	std::expected<void, util::Error> Composite::resize(SDL_GPUDevice* device, glm::u32vec2 size) noexcept
+	std::expected<void, util::Error> Composite::resize_upscale(
+		SDL_GPUDevice* device,
+		graphics::TexturePool& pool,
+		glm::u32vec2 size
+	) noexcept
 	{
-		auto result = composite_texture.resize(device, size);
-		if (!result) return result.error().forward("Resize composite texture failed");
+		auto result = upscale_texture.resize(device, size, &pool);
+		if (!result) return result.error().forward("Resize upscale texture failed");
 
 		return {};
 	}
@@ -2,9 +2,13 @@
 
 namespace render::target
 {
-	std::expected<void, util::Error> LightBuffer::cycle(SDL_GPUDevice* device, glm::u32vec2 size) noexcept
+	std::expected<void, util::Error> LightBuffer::cycle(
+		SDL_GPUDevice* device,
+		graphics::TexturePool& pool,
+		glm::u32vec2 size
+	) noexcept
 	{
-		if (auto result = light_texture.resize_and_cycle(device, size); !result)
+		if (auto result = light_texture.resize_and_cycle(device, size, &pool); !result)
 			return result.error().forward("Resize light buffer texture failed");
 
 		return {};
@@ -1,6 +1,8 @@
 #include "render/target/shadow.hpp"
 #include "render/const-params.hpp"
 
+#include <array>
+
 namespace render::target
 {
 	std::expected<void, util::Error> Shadow::resize(SDL_GPUDevice* device) noexcept
@@ -14,6 +16,33 @@ namespace render::target
 		if (auto result = depth_texture_level2.resize(device, glm::u32vec2(SHADOW_LEVEL_RES_2)); !result)
 			return result.error().forward("Resize Shadow depth texture level 2 failed");
 
+		if (auto result = static_texture_level0.resize(device, glm::u32vec2(SHADOW_LEVEL_RES_0)); !result)
+			return result.error().forward("Resize Shadow static texture level 0 failed");
+
+		if (auto result = static_texture_level1.resize(device, glm::u32vec2(SHADOW_LEVEL_RES_1)); !result)
+			return result.error().forward("Resize Shadow static texture level 1 failed");
+
+		if (auto result = static_texture_level2.resize(device, glm::u32vec2(SHADOW_LEVEL_RES_2)); !result)
+			return result.error().forward("Resize Shadow static texture level 2 failed");
+
 		return {};
 	}
+
+	const graphics::AutoTexture* Shadow::get_texture(size_t level, Layer layer) const noexcept
+	{
+		const std::array<const graphics::AutoTexture*, 3> map_textures = {
+			&depth_texture_level0,
+			&depth_texture_level1,
+			&depth_texture_level2
+		};
+
+		const std::array<const graphics::AutoTexture*, 3> static_textures = {
+			&static_texture_level0,
+			&static_texture_level1,
+			&static_texture_level2
+		};
+
+		if (level >= map_textures.size()) return nullptr;
+		return layer == Layer::Map ? map_textures[level] : static_textures[level];
+	}
 }
\ No newline at end of file
@@ -0,0 +1,199 @@
+// Memory and evaluation time of `gltf::AnimationClip` against its source channels, on clips up to 5 minutes
+
+#include "gltf/animation-clip.hpp"
+#include "test/bench.hpp"
+
+#include <format>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{149};
+	std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+
+	using gltf::detail::animation::TargetPath;
+
+	constexpr uint32_t joint_count = 60;
+	constexpr float source_rate = 60.0f;
+
+	// Linear keyframes sampled like `Sampler`, its constructors being reserved to the glTF loader
+	template <typename T>
+	class KeyframeChannel : public gltf::detail::animation::Channel
+	{
+		uint32_t target_node;
+		TargetPath path;
+		std::vector<std::pair<float, T>> keyframes;
+
+	  public:
+
+		KeyframeChannel(uint32_t target_node, TargetPath path, std::vector<std::pair<float, T>> keyframes) :
+			target_node(target_node),
+			path(path),
+			keyframes(std::move(keyframes))
+		{}
+
+		T operator[](float time) const noexcept
+		{
+			const auto upper = std::ranges::upper_bound(keyframes, time, {}, &std::pair<float, T>::first);
+			if (upper == keyframes.begin()) return upper->second;
+			if (upper == keyframes.end()) return std::prev(upper)->second;
+
+			const auto lower = std::prev(upper);
+			const float t = (time - lower->first) / (upper->first - lower->first);
+			if constexpr (std::is_same_v<T, glm::quat>)
+				return glm::slerp(lower->second, upper->second, t);
+			else
+				return glm::mix(lower->second, upper->second, t);
+		}
+
+		void apply(std::span<gltf::Node::TransformOverride> overrides, float time) const noexcept override
+		{
+			if constexpr (std::is_same_v<T, glm::quat>)
+				overrides[target_node].rotation = (*this)[time];
+			else if (path == TargetPath::Translation)
+				overrides[target_node].translation = (*this)[time];
+			else
+				overrides[target_node].scale = (*this)[time];
+		}
+
+		uint32_t get_target_node() const noexcept override { return target_node; }
+		TargetPath get_target_path() const noexcept override { return path; }
+		bool is_step() const noexcept override { return false; }
+
+		std::pair<float, float> get_time_range() const noexcept override
+		{
+			return {keyframes.front().first, keyframes.back().first};
+		}
+
+		size_t get_byte_size() const noexcept { return keyframes.size() * sizeof(keyframes[0]); }
+	};
+
+	using Channels = std::vector<std::unique_ptr<gltf::detail::animation::Channel>>;
+
+	// Keys at `source_rate` over `[0, duration]`, adding their size to `source_bytes`
+	template <typename T, typename F>
+	void add_channel(
+		Channels& channels,
+		size_t& source_bytes,
+		uint32_t node,
+		TargetPath path,
+		float duration,
+		F&& function
+	) noexcept
+	{
+		std::vector<std::pair<float, T>> keyframes;
+		for (int key = 0; key <= int(duration * source_rate); key++)
+		{
+			const float time = float(key) / source_rate;
+			keyframes.emplace_back(time, function(time));
+		}
+
+		auto channel = std::make_unique<KeyframeChannel<T>>(node, path, std::move(keyframes));
+		source_bytes += channel->get_byte_size();
+		channels.push_back(std::move(channel));
+	}
+
+	///
+	/// @brief Looping locomotion of a character, as baked by a DCC tool
+	/// @details Every joint rotates, every fifth joint translates and one joint scales, with periods
+	/// between 0.5 and 2 seconds.
+	///
+	Channels make_locomotion(float duration, size_t& source_bytes) noexcept
+	{
+		Channels channels;
+		source_bytes = 0;
+
+		for (uint32_t joint = 0; joint < joint_count; joint++)
+		{
+			const glm::vec3 axis = glm::vec3(unit(generator), unit(generator), unit(generator)) - 0.5f;
+			const float amplitude = 0.2f + unit(generator) * 0.6f;
+			const float frequency = 3.1f + unit(generator) * 9.4f;
+			const float phase = unit(generator) * 6.2832f;
+
+			add_channel<glm::quat>(
+				channels,
+				source_bytes,
+				joint,
+				TargetPath::Rotation,
+				duration,
+				[=](float time) {
+					const float angle = amplitude * std::sin(frequency * time + phase);
+					return glm::quat(std::cos(angle / 2), glm::normalize(axis) * std::sin(angle / 2));
+				}
+			);
+
+			if (joint % 5 == 0)
+				add_channel<glm::vec3>(
+					channels,
+					source_bytes,
+					joint,
+					TargetPath::Translation,
+					duration,
+					[=](float time) {
+						return glm::vec3(std::sin(time * frequency), 0.2f * std::cos(time * frequency), 0.1f);
+					}
+				);
+
+			if (joint == 3)
+				add_channel<glm::vec3>(
+					channels,
+					source_bytes,
+					joint,
+					TargetPath::Scale,
+					duration,
+					[](float time) { return glm::vec3(1.0f + 0.2f * std::sin(time * 4.0f)); }
+				);
+		}
+
+		return channels;
+	}
+}
+
+int main()
+{
+	// Joints of a humanoid, reaching 0.1 to 0.5 units
+	const auto reach = std::views::iota(0u, joint_count)
+					 | std::views::transform([](uint32_t joint) { return 0.1f + float(joint % 5) * 0.1f; })
+					 | std::ranges::to<std::vector>();
+
+	std::vector<gltf::Node::TransformOverride> overrides(joint_count);
+
+	for (const float duration : {10.0f, 60.0f, 300.0f})
+	{
+		size_t source_bytes;
+		const auto channels = make_locomotion(duration, source_bytes);
+
+		test::bench(std::format("compress, {}s clip", duration), 4, [&] {
+			test::keep(gltf::AnimationClip::compress(channels, reach, {}).get_byte_size());
+		});
+
+		const auto clip = gltf::AnimationClip::compress(channels, reach, {});
+
+		// Playback at 60 fps, wrapping around the clip
+		float time = 0.0f;
+		const auto advance = [&time, duration] {
+			time += 1.0f / 60.0f;
+			if (time > duration) time -= duration;
+			return time;
+		};
+
+		test::bench(std::format("source channels, {}s clip", duration), 100000, [&] {
+			const float current_time = advance();
+			for (const auto& channel : channels) channel->apply(overrides, current_time);
+			test::keep(overrides[0]);
+		});
+
+		test::bench(std::format("compressed clip, {}s clip", duration), 100000, [&] {
+			clip.apply(overrides, advance());
+			test::keep(overrides[0]);
+		});
+
+		std::println(
+			"{} channels, {} KiB source, {} KiB compressed, {:.1f}x smaller",
+			channels.size(),
+			source_bytes / 1024,
+			clip.get_byte_size() / 1024,
+			double(source_bytes) / double(clip.get_byte_size())
+		);
+	}
+}
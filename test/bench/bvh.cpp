@@ -0,0 +1,104 @@
+// Build, refit and frustum query of `graphics::Bvh` against linear culling, from 1k to 1M boxes
+
+#include "graphics/bvh.hpp"
+#include "graphics/culling.hpp"
+#include "test/bench.hpp"
+
+#include <cmath>
+#include <format>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{127};
+
+	// Boxes at a constant density, the scene grows with the count while the frustum doesn't
+	std::vector<graphics::Aabb> random_boxes(size_t count) noexcept
+	{
+		const float half_extent = 10.0f * std::cbrt(float(count));
+		std::uniform_real_distribution<float> coordinate{-half_extent, half_extent};
+		std::uniform_real_distribution<float> extent{0.1f, 2.0f};
+
+		std::vector<graphics::Aabb> boxes;
+		boxes.reserve(count);
+		for (size_t index = 0; index < count; index++)
+		{
+			const glm::vec3 center = {coordinate(generator), coordinate(generator), coordinate(generator)};
+			const glm::vec3 half_size = {extent(generator), extent(generator), extent(generator)};
+			boxes.push_back({.min = center - half_size, .max = center + half_size});
+		}
+
+		return boxes;
+	}
+
+	// Move every box by a small random offset, like an animated scene
+	void jitter(std::span<graphics::Aabb> boxes, std::span<const uint32_t> indices) noexcept
+	{
+		std::uniform_real_distribution<float> offset{-0.5f, 0.5f};
+		for (const auto index : indices)
+		{
+			const glm::vec3 delta = {offset(generator), offset(generator), offset(generator)};
+			boxes[index].min += delta;
+			boxes[index].max += delta;
+		}
+	}
+}
+
+int main()
+{
+	// Camera at the origin looking towards -Z, with a 150 unit far plane
+	const auto planes = graphics::compute_frustum_planes(
+		glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 150.0f)
+		* glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f))
+	);
+
+	for (const size_t count : {1000zu, 10000zu, 100000zu, 1000000zu})
+	{
+		auto boxes = random_boxes(count);
+		const size_t build_iterations = std::max(100000 / count, 1zu);
+		const size_t query_iterations = std::max(10000000 / count, 4zu);
+
+		test::bench(std::format("build, {} boxes", count), build_iterations, [&] {
+			test::keep(graphics::Bvh::build(boxes).get_nodes().size());
+		});
+
+		auto bvh = graphics::Bvh::build(boxes);
+
+		// Full refit of every box, and partial refit of 1% of them
+		const auto all_indices = std::views::iota(0u, uint32_t(count)) | std::ranges::to<std::vector>();
+		const auto changed_indices = all_indices | std::views::stride(100) | std::ranges::to<std::vector>();
+
+		jitter(boxes, all_indices);
+		test::bench(std::format("refit all, {} boxes", count), query_iterations, [&] { bvh.refit(boxes); });
+
+		jitter(boxes, changed_indices);
+		test::bench(std::format("refit 1%, {} boxes", count), query_iterations, [&] {
+			bvh.refit(boxes, changed_indices);
+		});
+
+		// Same visible set from both, the result vectors keep their capacity across iterations
+		std::pmr::vector<uint32_t> bvh_visible;
+		test::bench(std::format("query_frustum, {} boxes", count), query_iterations, [&] {
+			bvh_visible.clear();
+			bvh.query_frustum(planes, bvh_visible);
+			test::keep(bvh_visible.size());
+		});
+
+		std::vector<uint32_t> linear_visible;
+		test::bench(std::format("linear box_in_frustum, {} boxes", count), query_iterations, [&] {
+			linear_visible.clear();
+			for (const auto [index, box] : boxes | std::views::enumerate)
+				if (graphics::box_in_frustum(box.min, box.max, planes))
+					linear_visible.push_back(uint32_t(index));
+			test::keep(linear_visible.size());
+		});
+
+		std::println(
+			"{} of {} boxes visible, {} by linear culling",
+			bvh_visible.size(),
+			count,
+			linear_visible.size()
+		);
+	}
+}
@@ -0,0 +1,49 @@
+// SIMD 2x2 downsample kernels against the scalar `ImageContainer::shrink_half`
+
+#include "image/algo/downsample.hpp"
+#include "test/bench.hpp"
+
+#include <format>
+#include <random>
+
+namespace
+{
+	template <typename T>
+	image::ImageContainer<T> random_image(glm::u32vec2 size) noexcept
+	{
+		using Comp = typename T::value_type;
+		constexpr glm::length_t len = sizeof(T) / sizeof(Comp);
+
+		std::mt19937 generator{1};
+		image::ImageContainer<T> result{.size = size, .pixels = std::vector<T>(size_t(size.x) * size.y)};
+
+		for (auto& pixel : result.pixels)
+			for (glm::length_t channel = 0; channel < len; channel++)
+				pixel[channel] = Comp(generator() % 256);
+
+		return result;
+	}
+
+	template <typename T>
+	void bench_pixel(std::string_view pixel_name) noexcept
+	{
+		const glm::u32vec2 size = {2048, 2048};
+		const auto source = random_image<T>(size);
+
+		test::bench(std::format("{} 2048x2048 scalar", pixel_name), 4, [&] {
+			test::keep(source.shrink_half());
+		});
+		test::bench(std::format("{} 2048x2048 simd", pixel_name), 4, [&] {
+			test::keep(image::downsample_half(source));
+		});
+	}
+}
+
+int main()
+{
+	bench_pixel<glm::vec<1, uint8_t>>("u8x1");
+	bench_pixel<glm::u8vec4>("u8x4");
+	bench_pixel<glm::vec<2, uint16_t>>("u16x2");
+	bench_pixel<glm::vec<4, uint16_t>>("u16x4");
+	bench_pixel<glm::vec4>("f32x4");
+}
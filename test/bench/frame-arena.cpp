@@ -0,0 +1,62 @@
+// Per-frame containers allocated from `util::FrameArena` against the default heap resource
+
+#include "test/bench.hpp"
+#include "util/frame-arena.hpp"
+
+#include <glm/glm.hpp>
+#include <map>
+
+namespace
+{
+	// Containers of one simulated frame: many short lists of matrices and indices, like drawdata
+	size_t build_frame(std::pmr::memory_resource* memory) noexcept
+	{
+		size_t total = 0;
+
+		for (uint32_t object = 0; object < 256; object++)
+		{
+			std::pmr::vector<glm::mat4> matrices(memory);
+			std::pmr::vector<uint32_t> indices(memory);
+
+			for (uint32_t node = 0; node < 48; node++)
+			{
+				matrices.push_back(glm::mat4(float(node)));
+				indices.push_back(object * 48 + node);
+			}
+
+			total += matrices.size() + indices.size();
+		}
+
+		return total;
+	}
+
+	// Node-based containers of one simulated frame, one small allocation per element
+	size_t build_frame_nodes(std::pmr::memory_resource* memory) noexcept
+	{
+		std::pmr::map<uint32_t, float> lookup(memory);
+		for (uint32_t key = 0; key < 8192; key++) lookup.emplace(key * 2654435761u, float(key));
+
+		return lookup.size();
+	}
+}
+
+int main()
+{
+	test::bench("frame containers, heap", 200, [] {
+		test::keep(build_frame(std::pmr::get_default_resource()));
+	});
+
+	util::FrameArena arena({.capacity_per_frame = 16 * 1024 * 1024, .frame_count = 2, .poison = false});
+	test::bench("frame containers, frame arena", 200, [&arena] {
+		arena.begin_frame();
+		test::keep(build_frame(arena.resource()));
+	});
+
+	test::bench("frame map, heap", 200, [] {
+		test::keep(build_frame_nodes(std::pmr::get_default_resource()));
+	});
+	test::bench("frame map, frame arena", 200, [&arena] {
+		arena.begin_frame();
+		test::keep(build_frame_nodes(arena.resource()));
+	});
+}
@@ -0,0 +1,215 @@
+// Drawcalls of many instances of a model, one drawcall list per instance against instanced drawcalls
+
+#include "gltf/model.hpp"
+#include "test/bench.hpp"
+
+#include <format>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{109};
+
+	constexpr uint32_t node_count = 48;
+	constexpr uint32_t joint_count = 24;
+
+	using TransformOrJointMatrixOffset = decltype(gltf::PrimitiveDrawcall::transform_or_joint_matrix_offset);
+
+	// Node hierarchy standing in for a model, a fifth of the nodes animated and a tenth rigged
+	struct SyntheticModel
+	{
+		std::vector<uint32_t> node_order;
+		std::vector<bool> renderable_nodes;
+		std::vector<bool> dynamic_nodes;
+		std::vector<bool> rigged_nodes;
+		std::vector<uint32_t> primitive_counts;
+
+		SyntheticModel() noexcept
+		{
+			std::bernoulli_distribution rigged{0.1};
+			std::bernoulli_distribution animated{0.2};
+
+			node_order = std::views::iota(0u, node_count) | std::ranges::to<std::vector>();
+			for (uint32_t node = 0; node < node_count; node++)
+			{
+				const bool node_rigged = rigged(generator);
+				renderable_nodes.push_back(true);
+				rigged_nodes.push_back(node_rigged);
+				dynamic_nodes.push_back(node_rigged || animated(generator));
+				primitive_counts.push_back(1 + generator() % 3);
+			}
+		}
+
+		glm::mat4 get_world_matrix(const glm::mat4& model_transform, uint32_t node_index) const noexcept
+		{
+			return glm::translate(model_transform, glm::vec3(float(node_index), 0.0f, 0.0f));
+		}
+
+		void append(
+			const glm::mat4& model_transform,
+			uint32_t node_index,
+			float emissive_multiplier,
+			std::vector<gltf::PrimitiveDrawcall>& output
+		) const noexcept
+		{
+			const bool rigged = rigged_nodes[node_index];
+			const auto world_matrix = get_world_matrix(model_transform, node_index);
+
+			for (uint32_t primitive = 0; primitive < primitive_counts[node_index]; primitive++)
+			{
+				const auto center = glm::vec3(world_matrix[3]) + glm::vec3(0.0f, float(primitive), 0.0f);
+				output.push_back({
+					.world_position_min = center - 0.5f,
+					.world_position_max = center + 0.5f,
+					.material_index = primitive,
+					.transform_or_joint_matrix_offset = rigged
+						? TransformOrJointMatrixOffset(node_index % joint_count)
+						: TransformOrJointMatrixOffset(world_matrix),
+					.primitive = {},
+					.emissive_multiplier = rigged ? 1.0f : emissive_multiplier,
+				});
+			}
+		}
+	};
+
+	// State of every instance, laid out as by `Model::generate_instanced_drawdata`
+	struct Instances
+	{
+		size_t count;
+		std::vector<glm::mat4> model_transforms;
+		std::vector<std::vector<std::pair<uint32_t, float>>> emission_overrides;
+		std::vector<std::vector<uint32_t>> hidden_nodes;
+
+		std::vector<uint8_t> visible_nodes;     // Node by node
+		std::vector<float> emission_values;     // Node by node
+		std::vector<graphics::Aabb> node_bounds;  // Node by node, then primitive by primitive
+		std::vector<size_t> node_bound_offsets;
+	};
+
+	// Instances on a grid, a tenth hiding a node and a tenth overriding an emission
+	Instances make_instances(const SyntheticModel& model, size_t count) noexcept
+	{
+		std::uniform_int_distribution<uint32_t> node{0, node_count - 1};
+		std::bernoulli_distribution modified{0.1};
+
+		Instances instances{.count = count};
+		for (size_t index = 0; index < count; index++)
+		{
+			const auto position = glm::vec3(float(index % 100) * 60.0f, 0.0f, float(index / 100) * 10.0f);
+			instances.model_transforms.push_back(glm::translate(glm::mat4(1.0f), position));
+
+			auto& overrides = instances.emission_overrides.emplace_back();
+			if (modified(generator)) overrides.emplace_back(node(generator), 2.0f);
+
+			auto& hidden = instances.hidden_nodes.emplace_back();
+			if (modified(generator)) hidden.push_back(node(generator));
+		}
+
+		instances.visible_nodes.assign(node_count * count, 1);
+		instances.emission_values.assign(node_count * count, 1.0f);
+		for (size_t index = 0; index < count; index++)
+		{
+			for (const auto hidden_node_index : instances.hidden_nodes[index])
+				instances.visible_nodes[hidden_node_index * count + index] = 0;
+			for (const auto& [node_index, emission_value] : instances.emission_overrides[index])
+				instances.emission_values[node_index * count + index] = emission_value;
+		}
+
+		std::vector<gltf::PrimitiveDrawcall> drawcalls;
+		for (uint32_t node_index = 0; node_index < node_count; node_index++)
+		{
+			const size_t offset = instances.node_bounds.size();
+			instances.node_bound_offsets.push_back(offset);
+			instances.node_bounds.resize(offset + model.primitive_counts[node_index] * count);
+
+			for (size_t index = 0; index < count; index++)
+			{
+				drawcalls.clear();
+				model.append(instances.model_transforms[index], node_index, 1.0f, drawcalls);
+
+				for (const auto [primitive, drawcall] : drawcalls | std::views::enumerate)
+					instances.node_bounds[offset + size_t(primitive) * count + index] = {
+						.min = drawcall.world_position_min,
+						.max = drawcall.world_position_max
+					};
+			}
+		}
+
+		return instances;
+	}
+}
+
+int main()
+{
+	const SyntheticModel model;
+
+	for (const size_t instance_count : {10zu, 100zu, 1000zu, 10000zu})
+	{
+		const auto instances = make_instances(model, instance_count);
+		const size_t iterations = std::max(100000 / instance_count, 2zu);
+
+		// One cache per instance, as separate models, warmed so that only dynamic partitions are rebuilt
+		std::vector<gltf::DrawcallCache> caches(instance_count);
+		const auto update_single = [&] {
+			size_t drawcall_count = 0;
+			for (const auto [index, cache] : caches | std::views::enumerate)
+			{
+				const auto& model_transform = instances.model_transforms[index];
+				const auto list = cache.update(
+					model_transform,
+					model.node_order,
+					model.renderable_nodes,
+					model.dynamic_nodes,
+					instances.emission_overrides[index],
+					instances.hidden_nodes[index],
+					[&](uint32_t node_index, float emissive_multiplier, auto& output) {
+						model.append(model_transform, node_index, emissive_multiplier, output);
+					}
+				);
+				drawcall_count += list.size();
+			}
+			return drawcall_count;
+		};
+		update_single();
+
+		test::bench(std::format("single lists, {} instances", instance_count), iterations, [&] {
+			test::keep(update_single());
+		});
+
+		// Grouping and instanced drawcalls, instance evaluation excluded like for the single lists
+		std::vector<gltf::PrimitiveDrawcall> drawcalls;
+		std::vector<gltf::InstanceData> instance_data;
+		std::vector<gltf::PrimitiveDrawcall> primitives;
+		std::vector<uint32_t> instance_indices;
+		std::vector<gltf::InstanceGroup> groups;
+
+		test::bench(std::format("instanced, {} instances", instance_count), iterations, [&] {
+			drawcalls.clear();
+			instance_data.clear();
+
+			for (const auto node_index : model.node_order)
+			{
+				primitives.clear();
+				model.append(glm::mat4(1.0f), node_index, 1.0f, primitives);
+
+				gltf::append_instanced_drawcalls(
+					primitives,
+					std::span(instances.visible_nodes).subspan(node_index * instance_count, instance_count),
+					std::span(instances.emission_values).subspan(node_index * instance_count, instance_count),
+					std::span(instances.node_bounds).subspan(instances.node_bound_offsets[node_index]),
+					joint_count,
+					[&](uint32_t instance_index) {
+						return model.get_world_matrix(instances.model_transforms[instance_index], node_index);
+					},
+					instance_indices,
+					groups,
+					instance_data,
+					drawcalls
+				);
+			}
+
+			test::keep(drawcalls.size() + instance_data.size());
+		});
+	}
+}
@@ -0,0 +1,130 @@
+// Joints per microsecond of `gltf::encode_joint_palette` in every encoding, against the portable glm path
+
+#include "gltf/joint-palette.hpp"
+#include "test/bench.hpp"
+
+#include <array>
+#include <cstring>
+#include <format>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{139};
+	std::uniform_real_distribution<float> unit{-1.0f, 1.0f};
+
+	// Rotation, uniform scale and translation, like animated joints
+	glm::mat4 random_similarity() noexcept
+	{
+		const glm::vec3 axis = {unit(generator), unit(generator), unit(generator) + 0.01f};
+		const glm::vec3 translation = glm::vec3(unit(generator), unit(generator), unit(generator)) * 5.0f;
+		const glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), unit(generator) * 3.1f, glm::normalize(axis));
+		const float scale = 1.0f + unit(generator) * 0.1f;
+		return glm::scale(glm::translate(glm::mat4(1.0f), translation) * rotation, glm::vec3(scale));
+	}
+
+	// Same encodings as the non-AVX2 path of `encode_joint_palette`, one glm product per joint
+	void encode_portable(
+		gltf::JointPalette palette,
+		std::span<const glm::mat4> joint_world_matrices,
+		std::span<const glm::mat4> inverse_bind_matrices,
+		std::span<std::byte> output
+	) noexcept
+	{
+		const size_t stride = gltf::get_joint_palette_stride(palette);
+
+		for (size_t joint = 0; joint < joint_world_matrices.size(); joint++)
+		{
+			const glm::mat4 joint_matrix = joint_world_matrices[joint] * inverse_bind_matrices[joint];
+			std::byte* const destination = output.data() + joint * stride;
+
+			switch (palette)
+			{
+			case gltf::JointPalette::Matrix:
+				std::memcpy(destination, &joint_matrix, sizeof(glm::mat4));
+				break;
+
+			case gltf::JointPalette::Affine:
+			{
+				const glm::mat4 rows = glm::transpose(joint_matrix);
+				std::memcpy(destination, &rows, sizeof(glm::vec4) * 3);
+				break;
+			}
+
+			case gltf::JointPalette::Dual_quaternion:
+			{
+				const glm::mat3 linear = glm::mat3(joint_matrix);
+				const float scale =
+					(glm::length(linear[0]) + glm::length(linear[1]) + glm::length(linear[2])) / 3.0f;
+				const glm::quat rotation = glm::normalize(glm::quat_cast(linear / scale));
+				const glm::quat dual = glm::quat(0.0f, glm::vec3(joint_matrix[3])) * rotation * 0.5f;
+
+				const float norm = std::sqrt(scale);
+				const std::array<glm::vec4, 2> encoded = {
+					glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w) * norm,
+					glm::vec4(dual.x, dual.y, dual.z, dual.w) * norm
+				};
+				std::memcpy(destination, encoded.data(), sizeof(encoded));
+				break;
+			}
+			}
+		}
+	}
+}
+
+int main()
+{
+#ifdef __AVX2__
+	std::println("encode_joint_palette built with AVX2");
+#else
+	std::println("encode_joint_palette built without AVX2, both paths are portable");
+#endif
+
+	const std::array palettes = {
+		std::pair{gltf::JointPalette::Matrix, "mat4"},
+		std::pair{gltf::JointPalette::Affine, "affine"},
+		std::pair{gltf::JointPalette::Dual_quaternion, "dual quaternion"}
+	};
+
+	for (const size_t joint_count : {64zu, 256zu, 4096zu})
+	{
+		std::vector<glm::mat4> world_matrices, inverse_bind_matrices;
+		for (size_t joint = 0; joint < joint_count; joint++)
+		{
+			world_matrices.push_back(random_similarity());
+			inverse_bind_matrices.push_back(glm::inverse(random_similarity()));
+		}
+
+		std::vector<std::byte> output(joint_count * sizeof(glm::mat4));
+		const size_t iterations = std::max(1000000 / joint_count, 10zu);
+
+		for (const auto& [palette, palette_name] : palettes)
+		{
+			const double library_ns = test::bench(
+				std::format("{}, {} joints", palette_name, joint_count),
+				iterations,
+				[&] {
+					gltf::encode_joint_palette(palette, world_matrices, inverse_bind_matrices, output);
+					test::keep(output[0]);
+				}
+			);
+
+			const double portable_ns = test::bench(
+				std::format("{} portable, {} joints", palette_name, joint_count),
+				iterations,
+				[&] {
+					encode_portable(palette, world_matrices, inverse_bind_matrices, output);
+					test::keep(output[0]);
+				}
+			);
+
+			std::println(
+				"{:.1f} joints/us, {:.1f} joints/us portable",
+				double(joint_count) * 1000.0 / library_ns,
+				double(joint_count) * 1000.0 / portable_ns
+			);
+		}
+	}
+}
@@ -0,0 +1,93 @@
+// Light assignment of `graphics::LightCluster` with 10 to 10,000 point and spot lights
+
+#include "graphics/light-cluster.hpp"
+#include "test/bench.hpp"
+
+#include <format>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <thread>
+
+namespace
+{
+	std::mt19937 generator{131};
+	std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+
+	using LightType = graphics::ClusterLight::Type;
+
+	// Lights spread over a 200 x 20 x 200 level around the camera, with ranges of 1 to 10
+	std::vector<graphics::ClusterLight> random_lights(size_t count, LightType type) noexcept
+	{
+		std::vector<graphics::ClusterLight> lights;
+		lights.reserve(count);
+		for (size_t index = 0; index < count; index++)
+		{
+			const glm::vec3 position = {
+				unit(generator) * 200 - 100,
+				unit(generator) * 20,
+				unit(generator) * 200 - 100
+			};
+			const glm::vec3 direction = glm::vec3(unit(generator), unit(generator), unit(generator)) - 0.5f;
+
+			lights.push_back({
+				.type = type,
+				.position = position,
+				.range = 1.0f + unit(generator) * 9.0f,
+				.direction = type == LightType::Spot ? glm::normalize(direction) : glm::vec3(0.0f),
+				.outer_cone_angle = type == LightType::Spot ? 0.2f + unit(generator) * 1.2f : 0.0f
+			});
+		}
+
+		return lights;
+	}
+}
+
+int main()
+{
+	// Renderer's default grid and reversed Z camera, looking across the level
+	const glm::mat4 reverse_z = glm::mat4(
+		glm::vec4(1, 0, 0, 0),
+		glm::vec4(0, 1, 0, 0),
+		glm::vec4(0, 0, -1, 0),
+		glm::vec4(0, 0, 1, 1)
+	);
+	const glm::mat4 proj_matrix =
+		reverse_z * glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+	const glm::mat4 view_matrix = glm::lookAt(glm::vec3(0, 5, 90), glm::vec3(0, 5, 0), glm::vec3(0, 1, 0));
+
+	auto cluster = *graphics::LightCluster::create({});
+	const uint32_t slice_count = cluster.get_config().dimension.z;
+
+	for (const auto type : {LightType::Point, LightType::Spot})
+		for (const size_t count : {10zu, 100zu, 1000zu, 10000zu})
+		{
+			const auto lights = random_lights(count, type);
+			const auto type_name = type == LightType::Point ? "point" : "spot";
+			const size_t iterations = std::max(20000 / count, 10zu);
+
+			test::bench(std::format("build, {} {} lights", count, type_name), iterations, [&] {
+				cluster.build(view_matrix, proj_matrix, lights);
+				test::keep(cluster.get_light_indices().size());
+			});
+
+			// Slices spread over 4 threads, thread startup included as a frame without a pool would
+			test::bench(std::format("build on 4 threads, {} {} lights", count, type_name), iterations, [&] {
+				cluster.begin(view_matrix, proj_matrix, lights);
+				{
+					std::vector<std::jthread> threads;
+					for (uint32_t thread = 0; thread < 4; thread++)
+						threads.emplace_back([&cluster, slice_count, thread] {
+							for (uint32_t slice = thread; slice < slice_count; slice += 4)
+								cluster.build_slice(slice);
+						});
+				}
+				cluster.finish();
+				test::keep(cluster.get_light_indices().size());
+			});
+
+			std::println(
+				"{:.1f} lights per cluster on average",
+				double(cluster.get_light_indices().size()) / double(cluster.get_ranges().size())
+			);
+		}
+}
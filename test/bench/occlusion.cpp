@@ -0,0 +1,69 @@
+// Occluder rasterization and box test throughput of `graphics::OcclusionBuffer`
+
+#include "graphics/occlusion.hpp"
+#include "test/bench.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+namespace
+{
+	// Unit cube, 12 triangles
+	const graphics::OccluderMesh cube = {
+		.vertices = {{-1, -1, -1}, {1, -1, -1}, {1, 1, -1}, {-1, 1, -1},
+					 {-1, -1, 1},  {1, -1, 1},  {1, 1, 1},  {-1, 1, 1}},
+		.indices = {0, 1, 2, 0, 2, 3, 4, 6, 5, 4, 7, 6, 0, 4, 5, 0, 5, 1,
+					3, 2, 6, 3, 6, 7, 0, 3, 7, 0, 7, 4, 1, 5, 6, 1, 6, 2}
+	};
+}
+
+int main()
+{
+	std::mt19937 generator{37};
+	std::uniform_real_distribution<float> lateral{-30.0f, 30.0f};
+	std::uniform_real_distribution<float> depth{-80.0f, -5.0f};
+	std::uniform_real_distribution<float> extent{0.5f, 4.0f};
+
+	// Camera at the origin looking towards -Z, with reversed Z, at the renderer's resolution
+	const glm::mat4 view_projection =
+		glm::mat4(glm::vec4(1, 0, 0, 0), glm::vec4(0, 1, 0, 0), glm::vec4(0, 0, -1, 0), glm::vec4(0, 0, 1, 1))
+		* glm::perspective(glm::radians(60.0f), 320.0f / 192.0f, 0.1f, 500.0f);
+
+	std::vector<glm::mat4> occluders;
+	for (int index = 0; index < 96; index++)
+	{
+		const glm::vec3 position = {lateral(generator), lateral(generator) * 0.3f, depth(generator)};
+		const glm::vec3 scale = {extent(generator), extent(generator), extent(generator) * 0.2f};
+		occluders.push_back(glm::scale(glm::translate(glm::mat4(1.0f), position), scale));
+	}
+
+	std::vector<std::pair<glm::vec3, glm::vec3>> boxes;
+	for (int index = 0; index < 10000; index++)
+	{
+		const glm::vec3 center = {lateral(generator), lateral(generator) * 0.3f, depth(generator) - 20.0f};
+		const float half_size = extent(generator) * 0.3f;
+		boxes.emplace_back(center - half_size, center + half_size);
+	}
+
+	graphics::OcclusionBuffer buffer({320, 192});
+
+	test::bench("setup + rasterize, 96 occluders, 320x192", 200, [&] {
+		buffer.begin(view_projection);
+		for (const auto& transform : occluders) buffer.add_occluder(cube, transform);
+		buffer.rasterize(0, buffer.get_tile_rows());
+		test::keep(buffer.get_triangle_count());
+	});
+
+	test::bench("rasterize in bands of 4 tile rows", 200, [&] {
+		for (uint32_t row = 0; row < buffer.get_tile_rows(); row += 4) buffer.rasterize(row, row + 4);
+	});
+
+	size_t visible = 0;
+	test::bench("test 10000 boxes", 50, [&] {
+		visible = 0;
+		for (const auto& [box_min, box_max] : boxes) visible += buffer.test_box(box_min, box_max) ? 1 : 0;
+		test::keep(visible);
+	});
+
+	std::println("{} of {} boxes visible", visible, boxes.size());
+}
@@ -0,0 +1,195 @@
+// Cell visibility and box tests of `graphics::PortalGraph` on procedurally generated multi-room layouts
+
+#include "graphics/culling.hpp"
+#include "graphics/portal.hpp"
+#include "test/bench.hpp"
+
+#include <format>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{137};
+	std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+
+	constexpr float room_size = 10.0f;
+	constexpr float room_height = 3.0f;
+
+	// Reversed Z like the renderer's camera
+	glm::mat4 make_view_projection(const glm::vec3& eye, const glm::vec3& direction) noexcept
+	{
+		const glm::mat4 reverse_z = glm::mat4(
+			glm::vec4(1, 0, 0, 0),
+			glm::vec4(0, 1, 0, 0),
+			glm::vec4(0, 0, -1, 0),
+			glm::vec4(0, 0, 1, 1)
+		);
+
+		return reverse_z
+			 * glm::perspective(1.2f, 16.0f / 9.0f, 0.1f, 200.0f)
+			 * glm::lookAt(eye, eye + direction, glm::vec3(0.0f, 1.0f, 0.0f));
+	}
+
+	///
+	/// @brief Square grid of rooms, each wall between neighbours has a doorway with 70% chance
+	/// @details Doorways are 2 wide and 2 high, at a random position along the wall.
+	///
+	graphics::PortalGraph make_layout(uint32_t side) noexcept
+	{
+		std::vector<graphics::PortalGraph::Cell> cells;
+		for (uint32_t z = 0; z < side; z++)
+			for (uint32_t x = 0; x < side; x++)
+			{
+				const glm::vec3 min = glm::vec3(float(x), 0.0f, float(z)) * room_size;
+				const glm::vec3 max = min + glm::vec3(room_size, room_height, room_size);
+				cells.push_back({.bounds = graphics::Aabb{.min = min, .max = max}});
+			}
+
+		std::vector<graphics::PortalGraph::Portal> portals;
+		for (uint32_t z = 0; z < side; z++)
+			for (uint32_t x = 0; x < side; x++)
+			{
+				const uint32_t cell = z * side + x;
+				const float offset = 1.0f + unit(generator) * (room_size - 4.0f);
+
+				// Wall towards +X
+				if (x + 1 < side && unit(generator) < 0.7f)
+				{
+					const float wall = float(x + 1) * room_size;
+					const float start = float(z) * room_size + offset;
+					portals.push_back({
+						.corners = {
+							glm::vec3(wall, 0, start),
+							glm::vec3(wall, 0, start + 2),
+							glm::vec3(wall, 2, start + 2),
+							glm::vec3(wall, 2, start)
+						},
+						.cells = {cell, cell + 1}
+					});
+				}
+
+				// Wall towards +Z
+				if (z + 1 < side && unit(generator) < 0.7f)
+				{
+					const float wall = float(z + 1) * room_size;
+					const float start = float(x) * room_size + offset;
+					portals.push_back({
+						.corners = {
+							glm::vec3(start, 0, wall),
+							glm::vec3(start + 2, 0, wall),
+							glm::vec3(start + 2, 2, wall),
+							glm::vec3(start, 2, wall)
+						},
+						.cells = {cell, cell + side}
+					});
+				}
+			}
+
+		return *graphics::PortalGraph::create(std::move(cells), std::move(portals));
+	}
+
+	struct Camera
+	{
+		glm::vec3 eye;
+		glm::mat4 view_projection;
+	};
+
+	// Cameras at head height in random rooms, looking in random horizontal directions
+	std::vector<Camera> make_cameras(uint32_t side, size_t count) noexcept
+	{
+		std::vector<Camera> cameras;
+		for (size_t index = 0; index < count; index++)
+		{
+			const glm::vec3 eye = {
+				(0.5f + unit(generator) * (float(side) - 1.0f)) * room_size,
+				1.7f,
+				(0.5f + unit(generator) * (float(side) - 1.0f)) * room_size
+			};
+			const float angle = unit(generator) * 6.2832f;
+			cameras.push_back({eye, make_view_projection(eye, {std::cos(angle), 0.0f, std::sin(angle)})});
+		}
+
+		return cameras;
+	}
+
+	// Furniture-sized boxes, 20 inside each room
+	std::vector<graphics::Aabb> make_boxes(const graphics::PortalGraph& graph) noexcept
+	{
+		std::vector<graphics::Aabb> boxes;
+		for (const auto& cell : graph.get_cells())
+			for (int index = 0; index < 20; index++)
+			{
+				const glm::vec3 random = {unit(generator), unit(generator), unit(generator)};
+				const glm::vec3 half_size = glm::vec3(0.2f) + random * 0.5f;
+
+				const glm::vec3 min = cell.bounds->min + half_size, max = cell.bounds->max - half_size;
+				const glm::vec3 center =
+					glm::mix(min, max, glm::vec3(unit(generator), unit(generator), unit(generator)));
+				boxes.push_back({.min = center - half_size, .max = center + half_size});
+			}
+
+		return boxes;
+	}
+}
+
+int main()
+{
+	for (const uint32_t side : {2u, 4u, 8u, 16u})
+	{
+		const auto graph = make_layout(side);
+		const auto cameras = make_cameras(side, 64);
+		const auto boxes = make_boxes(graph);
+		const size_t room_count = size_t(side) * side;
+		const size_t iterations = std::max(4096 / room_count, 16zu);
+
+		size_t camera_index = 0;
+		test::bench(std::format("compute_visibility, {} rooms", room_count), iterations * 16, [&] {
+			const auto& camera = cameras[camera_index++ % cameras.size()];
+			test::keep(graph.compute_visibility(camera.eye, camera.view_projection, {}).views.size());
+		});
+
+		const auto visibilities =
+			cameras
+			| std::views::transform([&graph](const Camera& camera) {
+				  return graph.compute_visibility(camera.eye, camera.view_projection, {});
+			  })
+			| std::ranges::to<std::vector>();
+
+		// Box tests of every camera, through portals and against the camera frustum alone
+		size_t portal_visible = 0, frustum_visible = 0;
+
+		test::bench(std::format("test_box, {} boxes x 64 cameras", boxes.size()), iterations, [&] {
+			portal_visible = 0;
+			for (const auto& visibility : visibilities)
+				for (const auto& box : boxes) portal_visible += visibility.test_box(box.min, box.max) ? 1 : 0;
+			test::keep(portal_visible);
+		});
+
+		test::bench(std::format("box_in_frustum, {} boxes x 64 cameras", boxes.size()), iterations, [&] {
+			frustum_visible = 0;
+			for (const auto& camera : cameras)
+			{
+				const auto planes = graphics::compute_frustum_planes(camera.view_projection);
+				for (const auto& box : boxes)
+					frustum_visible += graphics::box_in_frustum(box.min, box.max, planes) ? 1 : 0;
+			}
+			test::keep(frustum_visible);
+		});
+
+		size_t view_count = 0, unrestricted_count = 0;
+		for (const auto& visibility : visibilities)
+		{
+			view_count += visibility.views.size();
+			unrestricted_count += visibility.unrestricted ? 1 : 0;
+		}
+
+		std::println(
+			"{:.1f} views per camera, {} unrestricted, {:.1f}% of boxes kept by portals, {:.1f}% by frustum",
+			double(view_count) / double(cameras.size()),
+			unrestricted_count,
+			100.0 * double(portal_visible) / double(boxes.size() * cameras.size()),
+			100.0 * double(frustum_visible) / double(boxes.size() * cameras.size())
+		);
+	}
+}
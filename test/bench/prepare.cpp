@@ -0,0 +1,188 @@
+// G-buffer and shadow culling of a large scene, serial `append` against chunks on a thread pool
+
+#include "render/const-params.hpp"
+#include "render/drawdata/gbuffer.hpp"
+#include "render/drawdata/shadow.hpp"
+#include "test/bench.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <thread_pool/thread_pool.h>
+
+namespace
+{
+	std::mt19937 generator{5};
+
+	gltf::MaterialGPU make_material(gltf::AlphaMode alpha_mode) noexcept
+	{
+		gltf::MaterialGPU material{};
+		material.params.pipeline = {.alpha_mode = alpha_mode, .double_sided = false};
+		return material;
+	}
+
+	gltf::MaterialCache material_cache(
+		{make_material(gltf::AlphaMode::Mask), make_material(gltf::AlphaMode::Blend)},
+		make_material(gltf::AlphaMode::Opaque)
+	);
+
+	std::shared_ptr<gltf::DrawcallPartition> make_partition(size_t count, bool build_bvh) noexcept
+	{
+		std::uniform_real_distribution<float> position{-150.0f, 150.0f};
+		std::uniform_real_distribution<float> extent{0.2f, 2.0f};
+		std::uniform_int_distribution<uint32_t> material{0, 2};
+
+		auto partition = std::make_shared<gltf::DrawcallPartition>();
+
+		std::vector<graphics::Aabb> bounds;
+		for (size_t index = 0; index < count; index++)
+		{
+			const glm::vec3 center = {position(generator), position(generator) * 0.1f, position(generator)};
+			const glm::vec3 half_size = {extent(generator), extent(generator), extent(generator)};
+			const uint32_t material_index = material(generator);
+
+			gltf::PrimitiveDrawcall drawcall{};
+			drawcall.world_position_min = center - half_size;
+			drawcall.world_position_max = center + half_size;
+			drawcall.material_index = material_index < 2 ? std::optional(material_index) : std::nullopt;
+			drawcall.transform_or_joint_matrix_offset = glm::mat4(1.0f);
+
+			partition->drawcalls.push_back(drawcall);
+			bounds.push_back({.min = drawcall.world_position_min, .max = drawcall.world_position_max});
+		}
+
+		if (build_bvh) partition->bvh = graphics::Bvh::build(bounds);
+		return partition;
+	}
+
+	struct Chunk
+	{
+		size_t drawdata_index;
+		size_t begin;
+		size_t end;
+	};
+}
+
+int main()
+{
+	std::vector<gltf::Drawdata> drawdata_list;
+	for (int model = 0; model < 8; model++)
+		drawdata_list.push_back(
+			gltf::Drawdata{
+				.primitive_drawcalls = {
+					.static_partition = make_partition(6000, true),
+					.dynamic_partition = make_partition(2000, false)
+				},
+				.node_matrices = {},
+				.deferred_skin_resource = nullptr,
+				.deferred_instance_resource = nullptr,
+				.material_cache = material_cache.ref()
+			}
+		);
+
+	// Same split as the renderer
+	std::vector<Chunk> chunks;
+	for (const auto [drawdata_idx, drawdata] : drawdata_list | std::views::enumerate)
+	{
+		const size_t count = drawdata.primitive_drawcalls.size();
+		for (size_t begin = 0; begin < count; begin += render::PREPARE_CHUNK_SIZE)
+			chunks.push_back({
+				.drawdata_index = size_t(drawdata_idx),
+				.begin = begin,
+				.end = std::min(begin + render::PREPARE_CHUNK_SIZE, count)
+			});
+	}
+
+	const glm::vec3 eye = {0.0f, 10.0f, 60.0f};
+	const glm::mat4 reverse_z = glm::mat4(
+		glm::vec4(1, 0, 0, 0),
+		glm::vec4(0, 1, 0, 0),
+		glm::vec4(0, 0, -1, 0),
+		glm::vec4(0, 0, 1, 1)
+	);
+	const auto camera_matrix = reverse_z
+		* glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 300.0f)
+		* glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const glm::vec3 light_direction = glm::normalize(glm::vec3(0.3f, -1.0f, 0.2f));
+
+	test::bench("gbuffer + shadow culling, serial", 20, [&] {
+		render::drawdata::Gbuffer gbuffer(camera_matrix, eye);
+		for (const auto& drawdata : drawdata_list) gbuffer.append(drawdata);
+
+		render::drawdata::Shadow shadow(camera_matrix, light_direction, gbuffer.get_min_z(), 0.5f);
+		for (const auto& drawdata : drawdata_list) shadow.append(drawdata);
+
+		test::keep(gbuffer.drawcalls.size() + shadow.csm_levels[0].drawcalls.size());
+	});
+
+	dp::thread_pool<> thread_pool;
+
+	test::bench("gbuffer + shadow culling, chunked", 20, [&] {
+		std::vector<std::future<void>> tasks;
+
+		render::drawdata::Gbuffer gbuffer(camera_matrix, eye);
+		const auto gbuffer_resource_sets =
+			drawdata_list
+			| std::views::transform([&gbuffer](const auto& drawdata) {
+				  return gbuffer.add_resource_set(drawdata);
+			  })
+			| std::ranges::to<std::vector>();
+
+		std::vector<render::drawdata::Gbuffer::Partial> gbuffer_partials(chunks.size());
+		for (const auto chunk_idx : std::views::iota(0zu, chunks.size()))
+			tasks.push_back(thread_pool.enqueue([&, chunk_idx] {
+				const auto& chunk = chunks[chunk_idx];
+				gbuffer.cull(
+					drawdata_list[chunk.drawdata_index],
+					gbuffer_resource_sets[chunk.drawdata_index],
+					chunk.begin,
+					chunk.end,
+					gbuffer_partials[chunk_idx]
+				);
+			}));
+
+		for (auto& task : tasks) task.wait();
+		tasks.clear();
+		for (const auto& partial : gbuffer_partials) gbuffer.merge(partial);
+
+		render::drawdata::Shadow shadow(camera_matrix, light_direction, gbuffer.get_min_z(), 0.5f);
+		auto& csm_levels = shadow.csm_levels;
+
+		// Indexed by `level * drawdata_list.size() + drawdata index`
+		const auto shadow_resource_sets =
+			std::views::cartesian_product(csm_levels, drawdata_list)
+			| std::views::transform([](const auto& pair) {
+				  auto& [level, drawdata] = pair;
+				  return level.add_resource_set(drawdata);
+			  })
+			| std::ranges::to<std::vector>();
+
+		// Indexed by `level * chunks.size() + chunk index`
+		std::vector<render::drawdata::Shadow::ShadowLevelData::Partial> shadow_partials(
+			csm_levels.size() * chunks.size()
+		);
+		for (const auto [level_idx, chunk_idx] : std::views::cartesian_product(
+				 std::views::iota(0zu, csm_levels.size()),
+				 std::views::iota(0zu, chunks.size())
+			 ))
+			tasks.push_back(thread_pool.enqueue([&, level_idx, chunk_idx] {
+				const auto& chunk = chunks[chunk_idx];
+				csm_levels[level_idx].cull(
+					drawdata_list[chunk.drawdata_index],
+					shadow_resource_sets[level_idx * drawdata_list.size() + chunk.drawdata_index],
+					chunk.begin,
+					chunk.end,
+					shadow_partials[level_idx * chunks.size() + chunk_idx]
+				);
+			}));
+
+		for (auto& task : tasks) task.wait();
+		for (const auto [level_idx, level] : csm_levels | std::views::enumerate)
+		{
+			const auto level_partials =
+				std::span(shadow_partials).subspan(size_t(level_idx) * chunks.size(), chunks.size());
+			for (const auto& partial : level_partials) level.merge(partial);
+		}
+
+		test::keep(gbuffer.drawcalls.size() + csm_levels[0].drawcalls.size());
+	});
+}
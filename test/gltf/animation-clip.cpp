@@ -0,0 +1,348 @@
+// Error bound, size and STEP handling of `gltf::AnimationClip` against the source channels
+
+#include "gltf/animation-clip.hpp"
+#include "test/check.hpp"
+
+#include <random>
+
+namespace
+{
+	using gltf::detail::animation::TargetPath;
+
+	// Linear or STEP keyframes, sampled like `Sampler`
+	template <typename T>
+	class KeyframeChannel : public gltf::detail::animation::Channel
+	{
+		uint32_t target_node;
+		TargetPath path;
+		bool step;
+		std::vector<std::pair<float, T>> keyframes;
+
+	  public:
+
+		KeyframeChannel(
+			uint32_t target_node,
+			TargetPath path,
+			bool step,
+			std::vector<std::pair<float, T>> keyframes
+		) :
+			target_node(target_node),
+			path(path),
+			step(step),
+			keyframes(std::move(keyframes))
+		{}
+
+		T operator[](float time) const noexcept
+		{
+			const auto upper = std::ranges::upper_bound(keyframes, time, {}, &std::pair<float, T>::first);
+			if (upper == keyframes.begin()) return upper->second;
+			if (upper == keyframes.end()) return std::prev(upper)->second;
+
+			const auto lower = std::prev(upper);
+			if (step) return lower->second;
+
+			const float t = (time - lower->first) / (upper->first - lower->first);
+			if constexpr (std::is_same_v<T, glm::quat>)
+				return glm::slerp(lower->second, upper->second, t);
+			else
+				return glm::mix(lower->second, upper->second, t);
+		}
+
+		void apply(std::span<gltf::Node::TransformOverride> overrides, float time) const noexcept override
+		{
+			if constexpr (std::is_same_v<T, glm::quat>)
+				overrides[target_node].rotation = (*this)[time];
+			else if (path == TargetPath::Translation)
+				overrides[target_node].translation = (*this)[time];
+			else
+				overrides[target_node].scale = (*this)[time];
+		}
+
+		uint32_t get_target_node() const noexcept override { return target_node; }
+		TargetPath get_target_path() const noexcept override { return path; }
+		bool is_step() const noexcept override { return step; }
+
+		std::pair<float, float> get_time_range() const noexcept override
+		{
+			return {keyframes.front().first, keyframes.back().first};
+		}
+
+		size_t get_byte_size() const noexcept { return keyframes.size() * sizeof(keyframes[0]); }
+	};
+
+	using Channels = std::vector<std::unique_ptr<gltf::detail::animation::Channel>>;
+
+	constexpr float source_rate = 60.0f;
+
+	// Keys at `source_rate` over `[0, duration]`
+	template <typename T, typename F>
+	std::unique_ptr<KeyframeChannel<T>> make_channel(
+		uint32_t node,
+		TargetPath path,
+		bool step,
+		float duration,
+		F&& function
+	) noexcept
+	{
+		std::vector<std::pair<float, T>> keyframes;
+		for (int key = 0; key <= int(duration * source_rate); key++)
+		{
+			const float time = float(key) / source_rate;
+			keyframes.emplace_back(time, function(time));
+		}
+
+		return std::make_unique<KeyframeChannel<T>>(node, path, step, std::move(keyframes));
+	}
+
+	glm::quat axis_angle(const glm::vec3& axis, float angle) noexcept
+	{
+		return glm::quat(std::cos(angle / 2), axis * std::sin(angle / 2));
+	}
+
+	// Arc travelled by a point at `reach`, rotated from one quaternion to the other
+	float rotation_error(glm::quat a, glm::quat b, float reach) noexcept
+	{
+		if (glm::dot(a, b) < 0) b = -b;
+		const glm::vec4 x = {a.x, a.y, a.z, a.w}, y = {b.x, b.y, b.z, b.w};
+		return 4 * std::atan2(glm::length(x - y), glm::length(x + y)) * reach;
+	}
+
+	// Scale errors are relative to the reference scale
+	float scale_error(const glm::vec3& scale, const glm::vec3& reference, float reach) noexcept
+	{
+		const glm::vec3 difference = glm::abs(scale - reference);
+		const glm::vec3 magnitude = glm::abs(reference);
+		return std::max({difference.x, difference.y, difference.z})
+			 / std::max({magnitude.x, magnitude.y, magnitude.z, 1e-6f}) * reach;
+	}
+
+	// Error of every override against the source channels, as measured by the compressor
+	float max_error(
+		const Channels& channels,
+		const gltf::AnimationClip& clip,
+		std::span<const float> reach,
+		float time
+	) noexcept
+	{
+		std::vector<gltf::Node::TransformOverride> expected(reach.size()), actual(reach.size());
+		for (const auto& channel : channels) channel->apply(expected, time);
+		clip.apply(actual, time);
+
+		float error = 0.0f;
+		for (const auto& channel : channels)
+		{
+			const auto node = channel->get_target_node();
+			const auto& [translation, rotation, scale] = actual[node];
+			const auto& [expected_translation, expected_rotation, expected_scale] = expected[node];
+
+			switch (channel->get_target_path())
+			{
+			case TargetPath::Translation:
+				error = std::max(error, glm::length(*translation - *expected_translation));
+				break;
+			case TargetPath::Rotation:
+				error = std::max(error, rotation_error(*rotation, *expected_rotation, reach[node]));
+				break;
+			case TargetPath::Scale:
+				error = std::max(error, scale_error(*scale, *expected_scale, reach[node]));
+				break;
+			}
+		}
+
+		return error;
+	}
+
+	// Joint chain of smoothly rotating joints, a few translated and one scaled
+	Channels make_walk_cycle(float duration, uint32_t joint_count, size_t& source_bytes) noexcept
+	{
+		std::mt19937 generator{67};
+		std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+
+		Channels channels;
+		source_bytes = 0;
+
+		for (uint32_t joint = 0; joint < joint_count; joint++)
+		{
+			const float frequency = 0.2f + unit(generator), amplitude = 0.5f * unit(generator);
+			const float phase = 6.0f * unit(generator);
+			const glm::vec3 axis = {unit(generator) - 0.4f, unit(generator) - 0.4f, unit(generator) - 0.4f};
+
+			auto rotation =
+				make_channel<glm::quat>(joint, TargetPath::Rotation, false, duration, [=](float time) {
+					return axis_angle(glm::normalize(axis), amplitude * std::sin(frequency * time + phase));
+				});
+			source_bytes += rotation->get_byte_size();
+			channels.push_back(std::move(rotation));
+
+			if (joint % 5 == 0)
+			{
+				auto translation =
+					make_channel<glm::vec3>(joint, TargetPath::Translation, false, duration, [](float time) {
+						return glm::vec3(std::sin(time * 0.7f), 0.2f * std::cos(time * 1.3f), 0.1f);
+					});
+				source_bytes += translation->get_byte_size();
+				channels.push_back(std::move(translation));
+			}
+
+			if (joint == 3)
+			{
+				auto scale =
+					make_channel<glm::vec3>(joint, TargetPath::Scale, false, duration, [](float time) {
+						return glm::vec3(1.0f + 0.2f * std::sin(time));
+					});
+				source_bytes += scale->get_byte_size();
+				channels.push_back(std::move(scale));
+			}
+		}
+
+		return channels;
+	}
+
+	// Joints near the root reach farther
+	std::vector<float> make_reach(uint32_t joint_count) noexcept
+	{
+		std::vector<float> reach;
+		for (uint32_t joint = 0; joint < joint_count; joint++)
+			reach.push_back(float(joint_count - joint) * 0.1f);
+		return reach;
+	}
+}
+
+int main()
+{
+	test::run("Error bound", [] {
+		const float duration = 20.0f;
+		const uint32_t joint_count = 24;
+		const auto reach = make_reach(joint_count);
+
+		size_t source_bytes;
+		const auto channels = make_walk_cycle(duration, joint_count, source_bytes);
+
+		for (const float sample_rate : {30.0f, 60.0f})
+			for (const float bound : {1e-3f, 1e-2f})
+			{
+				const gltf::AnimationClip::Config config = {
+					.sample_rate = sample_rate,
+					.max_position_error = bound,
+					.min_reach = 0.1f
+				};
+				const auto clip = gltf::AnimationClip::compress(channels, reach, config);
+
+				// Every resampled frame within the bound, with some slack for time rounding
+				for (int frame = 0; frame <= int(duration * sample_rate); frame++)
+					TEST_CHECK(max_error(channels, clip, reach, float(frame) / sample_rate) <= bound * 1.05f);
+
+				// Smooth motion stays close between frames
+				std::mt19937 generator{71};
+				std::uniform_real_distribution<float> time{0.0f, duration};
+				for (int sample = 0; sample < 2000; sample++)
+					TEST_CHECK(max_error(channels, clip, reach, time(generator)) <= bound * 2.0f);
+
+				TEST_CHECK(clip.get_byte_size() * 4 < source_bytes);
+			}
+	});
+
+	test::run("Looser bounds are smaller", [] {
+		const uint32_t joint_count = 12;
+		const auto reach = make_reach(joint_count);
+
+		size_t source_bytes;
+		const auto channels = make_walk_cycle(10.0f, joint_count, source_bytes);
+
+		size_t previous_size = std::numeric_limits<size_t>::max();
+		for (const float bound : {1e-4f, 1e-3f, 1e-2f, 1e-1f})
+		{
+			const auto clip = gltf::AnimationClip::compress(
+				channels,
+				reach,
+				{.sample_rate = 30.0f, .max_position_error = bound, .min_reach = 0.1f}
+			);
+			TEST_CHECK(clip.get_byte_size() <= previous_size);
+			previous_size = clip.get_byte_size();
+		}
+	});
+
+	test::run("Clamped time", [] {
+		const std::array reach = {1.0f};
+
+		Channels channels;
+		channels.push_back(make_channel<glm::vec3>(0, TargetPath::Translation, false, 2.0f, [](float time) {
+			return glm::vec3(time + 1.0f, 0.0f, 0.0f);
+		}));
+		const auto clip = gltf::AnimationClip::compress(channels, reach, {});
+
+		std::vector<gltf::Node::TransformOverride> overrides(1);
+		clip.apply(overrides, -5.0f);
+		TEST_CHECK(std::abs(overrides[0].translation->x - 1.0f) < 1e-3f);
+		clip.apply(overrides, 50.0f);
+		TEST_CHECK(std::abs(overrides[0].translation->x - 3.0f) < 1e-3f);
+
+		// Untouched paths stay empty
+		TEST_CHECK(!overrides[0].rotation.has_value() && !overrides[0].scale.has_value());
+	});
+
+	test::run("Single key", [] {
+		const std::array reach = {1.0f, 1.0f};
+
+		Channels channels;
+		channels.push_back(std::make_unique<KeyframeChannel<glm::quat>>(
+			1,
+			TargetPath::Rotation,
+			false,
+			std::vector{std::pair(0.5f, axis_angle({0, 1, 0}, 0.7f))}
+		));
+		const auto clip = gltf::AnimationClip::compress(channels, reach, {});
+
+		for (const float time : {0.0f, 0.5f, 3.0f})
+			TEST_CHECK(max_error(channels, clip, reach, time) <= 1e-3f);
+
+		const auto targets = clip.get_target_nodes();
+		TEST_CHECK(targets.size() == 1 && targets[0] == 1);
+	});
+
+	test::run("Step channel", [] {
+		const std::array reach = {1.0f};
+
+		// Steps every 0.5 seconds, on the resampled frames
+		Channels channels;
+		channels.push_back(make_channel<glm::vec3>(0, TargetPath::Translation, true, 4.0f, [](float time) {
+			return glm::vec3(float(int(time * 2.0f) % 3), 0.0f, 0.0f);
+		}));
+		const auto clip = gltf::AnimationClip::compress(channels, reach, {.sample_rate = 30.0f});
+
+		// Held values, never interpolated across a step
+		std::vector<gltf::Node::TransformOverride> overrides(1);
+		for (int sample = 0; sample < 400; sample++)
+		{
+			const float time = float(sample) * 0.01f + 0.005f;
+			const float expected = float(int(time * 2.0f) % 3);
+
+			clip.apply(overrides, time);
+			const float actual = overrides[0].translation->x;
+			TEST_CHECK(std::abs(actual - std::round(actual)) < 1e-3f);
+
+			// Away from the steps, values match
+			const float to_step = std::abs(time * 2.0f - std::round(time * 2.0f));
+			if (to_step > 0.1f) TEST_CHECK(std::abs(actual - expected) < 1e-3f);
+		}
+	});
+
+	test::run("Later channels override", [] {
+		const std::array reach = {1.0f};
+
+		Channels channels;
+		channels.push_back(make_channel<glm::vec3>(0, TargetPath::Translation, false, 1.0f, [](float) {
+			return glm::vec3(5.0f);
+		}));
+		channels.push_back(make_channel<glm::vec3>(0, TargetPath::Translation, false, 1.0f, [](float time) {
+			return glm::vec3(time);
+		}));
+		const auto clip = gltf::AnimationClip::compress(channels, reach, {});
+
+		std::vector<gltf::Node::TransformOverride> overrides(1);
+		clip.apply(overrides, 0.5f);
+		TEST_CHECK(glm::length(*overrides[0].translation - glm::vec3(0.5f)) < 1e-3f);
+	});
+
+	return test::finish();
+}
@@ -0,0 +1,421 @@
+// Content deduplication of glTF images, meshes and samplers
+
+#include "gltf/dedup.hpp"
+#include "gltf/texture.hpp"
+#include "test/check.hpp"
+
+#include <array>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{113};
+
+	tinygltf::Image make_image(int width, int height, std::vector<unsigned char> pixels) noexcept
+	{
+		tinygltf::Image image;
+		image.width = width;
+		image.height = height;
+		image.component = 1;
+		image.bits = 8;
+		image.pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+		image.image = std::move(pixels);
+		return image;
+	}
+
+	// Add a VEC3 float accessor over its own buffer, elements are `stride` bytes apart (0 = tightly packed)
+	int add_positions(
+		tinygltf::Model& model,
+		const std::vector<glm::vec3>& positions,
+		size_t stride = 0
+	) noexcept
+	{
+		const size_t element_stride = stride == 0 ? sizeof(glm::vec3) : stride;
+
+		tinygltf::Buffer buffer;
+		buffer.data.resize(element_stride * (positions.size() - 1) + sizeof(glm::vec3), 0xCD);
+		for (const auto [index, position] : positions | std::views::enumerate)
+			std::memcpy(buffer.data.data() + index * element_stride, &position, sizeof(glm::vec3));
+
+		tinygltf::BufferView buffer_view;
+		buffer_view.buffer = int(model.buffers.size());
+		buffer_view.byteLength = buffer.data.size();
+		buffer_view.byteStride = stride;
+
+		tinygltf::Accessor accessor;
+		accessor.bufferView = int(model.bufferViews.size());
+		accessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+		accessor.type = TINYGLTF_TYPE_VEC3;
+		accessor.count = positions.size();
+
+		model.buffers.push_back(std::move(buffer));
+		model.bufferViews.push_back(buffer_view);
+		model.accessors.push_back(accessor);
+		return int(model.accessors.size() - 1);
+	}
+
+	tinygltf::Mesh make_mesh(int position_accessor, int material = -1) noexcept
+	{
+		tinygltf::Primitive primitive;
+		primitive.attributes["POSITION"] = position_accessor;
+		primitive.material = material;
+
+		tinygltf::Mesh mesh;
+		mesh.primitives.push_back(primitive);
+		return mesh;
+	}
+
+	const std::vector<glm::vec3> triangle = {
+		{0, 0, 0},
+		{1, 0, 0},
+		{0, 1, 0}
+	};
+
+	// Read back the elements of a VEC3 float accessor
+	std::vector<glm::vec3> read_positions(const tinygltf::Model& model, int accessor_index) noexcept
+	{
+		const auto& accessor = model.accessors[accessor_index];
+		const auto& buffer_view = model.bufferViews[accessor.bufferView];
+		const auto& buffer = model.buffers[buffer_view.buffer];
+		const size_t stride = buffer_view.byteStride == 0 ? sizeof(glm::vec3) : buffer_view.byteStride;
+
+		std::vector<glm::vec3> positions(accessor.count);
+		for (const auto [index, position] : positions | std::views::enumerate)
+			std::memcpy(
+				&position,
+				buffer.data.data() + buffer_view.byteOffset + accessor.byteOffset + index * stride,
+				sizeof(glm::vec3)
+			);
+
+		return positions;
+	}
+
+	///
+	/// @brief Model with images, samplers and meshes picked from small pools of distinct contents
+	/// @details Duplicated meshes read their own accessor, packed or strided, or share one. Textures,
+	/// materials and nodes point at random elements, duplicates included.
+	///
+	tinygltf::Model make_duplicated_model() noexcept
+	{
+		tinygltf::Model model;
+
+		for (int index = 0; index < 10; index++)
+		{
+			const int pixel = int(generator() % 4);
+			model.images.push_back(make_image(2, 1, {(unsigned char)pixel, (unsigned char)(pixel * 3)}));
+		}
+
+		for (int index = 0; index < 6; index++)
+		{
+			tinygltf::Sampler sampler;
+			sampler.magFilter = generator() % 2 == 0 ? 9728 : 9729;
+			sampler.wrapS = generator() % 2 == 0 ? 10497 : 33071;
+			model.samplers.push_back(sampler);
+		}
+
+		for (int index = 0; index < 12; index++)
+		{
+			tinygltf::Texture texture;
+			texture.source = int(generator() % model.images.size());
+			texture.sampler = int(generator() % (model.samplers.size() + 1)) - 1;
+			model.textures.push_back(texture);
+		}
+
+		const auto pick_texture = [&model] {
+			return int(generator() % (model.textures.size() + 1)) - 1;
+		};
+
+		for (int index = 0; index < 4; index++)
+		{
+			tinygltf::Material material;
+			material.pbrMetallicRoughness.baseColorTexture.index = pick_texture();
+			material.pbrMetallicRoughness.metallicRoughnessTexture.index = pick_texture();
+			material.normalTexture.index = pick_texture();
+			material.occlusionTexture.index = pick_texture();
+			material.emissiveTexture.index = pick_texture();
+			model.materials.push_back(material);
+		}
+
+		// Mesh designs as (geometry, material) per primitive
+		const std::array<std::vector<glm::vec3>, 3> geometries = {
+			triangle,
+			std::vector<glm::vec3>{{0, 0, 0}, {2, 0, 0}, {0, 2, 0}},
+			std::vector<glm::vec3>{{0, 0, 1}, {1, 0, 1}, {0, 1, 1}, {1, 1, 1}, {0, 1, 1}, {1, 0, 1}}
+		};
+
+		std::vector<std::vector<std::pair<uint32_t, int>>> designs(5);
+		for (auto& design : designs)
+			for (uint32_t primitive = 0; primitive < 1 + generator() % 3; primitive++)
+				design.emplace_back(generator() % geometries.size(), int(generator() % 5) - 1);
+
+		std::vector<std::pair<uint32_t, int>> shared_accessors;  // (geometry, accessor) reused by meshes
+		for (int index = 0; index < 14; index++)
+		{
+			tinygltf::Mesh mesh;
+			for (const auto& [geometry, material] : designs[generator() % designs.size()])
+			{
+				int accessor = -1;
+				const auto shared = std::ranges::find(shared_accessors, geometry, [](const auto& entry) {
+					return entry.first;
+				});
+				if (shared != shared_accessors.end() && generator() % 2 == 0)
+					accessor = shared->second;
+				else
+				{
+					accessor = add_positions(model, geometries[geometry], generator() % 2 == 0 ? 0 : 16);
+					shared_accessors.emplace_back(geometry, accessor);
+				}
+
+				mesh.primitives.push_back(make_mesh(accessor, material).primitives[0]);
+			}
+			model.meshes.push_back(mesh);
+		}
+
+		for (int index = 0; index < 24; index++)
+		{
+			tinygltf::Node node;
+			node.mesh = int(generator() % (model.meshes.size() + 1)) - 1;
+			model.nodes.push_back(node);
+		}
+
+		return model;
+	}
+
+	using SamplerDescriptor = std::array<int, 4>;
+
+	SamplerDescriptor get_descriptor(const tinygltf::Sampler& sampler) noexcept
+	{
+		return {sampler.minFilter, sampler.magFilter, sampler.wrapS, sampler.wrapT};
+	}
+
+	// Content a drawcall resolves to: node, geometry, material, then pixels and sampler of each texture
+	struct ResolvedDrawcall
+	{
+		uint32_t node;
+		std::vector<glm::vec3> positions;
+		int material;
+		std::vector<std::pair<std::vector<unsigned char>, SamplerDescriptor>> textures;
+
+		bool operator==(const ResolvedDrawcall&) const = default;
+	};
+
+	// Texture indices of a material, -1 when absent
+	std::array<int, 5> get_texture_indices(const tinygltf::Material& material) noexcept
+	{
+		return {
+			material.pbrMetallicRoughness.baseColorTexture.index,
+			material.pbrMetallicRoughness.metallicRoughnessTexture.index,
+			material.normalTexture.index,
+			material.occlusionTexture.index,
+			material.emissiveTexture.index
+		};
+	}
+
+	// Resolve the drawcalls of every node from the source lists, without deduplication
+	std::vector<ResolvedDrawcall> resolve_source(const tinygltf::Model& model) noexcept
+	{
+		std::vector<ResolvedDrawcall> drawcalls;
+		for (const auto [node_index, node] : model.nodes | std::views::enumerate)
+		{
+			if (node.mesh < 0) continue;
+
+			for (const auto& primitive : model.meshes[node.mesh].primitives)
+			{
+				auto& drawcall = drawcalls.emplace_back(ResolvedDrawcall{
+					.node = uint32_t(node_index),
+					.positions = read_positions(model, primitive.attributes.at("POSITION")),
+					.material = primitive.material,
+					.textures = {}
+				});
+				if (primitive.material < 0) continue;
+
+				for (const int texture_index : get_texture_indices(model.materials[primitive.material]))
+				{
+					if (texture_index < 0)
+					{
+						drawcall.textures.emplace_back();
+						continue;
+					}
+
+					const auto& texture = model.textures[texture_index];
+					const auto sampler = texture.sampler < 0
+						? SamplerDescriptor{}
+						: get_descriptor(model.samplers[texture.sampler]);
+					drawcall.textures.emplace_back(model.images[texture.source].image, sampler);
+				}
+			}
+		}
+
+		return drawcalls;
+	}
+
+	///
+	/// @brief Resolve the drawcalls of every node as loaded by `Model` and `MaterialList`
+	/// @details Meshes and samplers are compacted lists of canonical elements, images keep their slots but
+	/// duplicates are never loaded. Reaching an unloaded image fails the check.
+	///
+	std::vector<ResolvedDrawcall> resolve_deduplicated(const tinygltf::Model& model) noexcept
+	{
+		const auto mesh_dedup = gltf::dedup_meshes(model);
+		const auto image_dedup = gltf::dedup_images(model);
+		const auto sampler_dedup = gltf::dedup_samplers(model);
+
+		const auto meshes = mesh_dedup.canonical_indices()
+			| std::views::transform([&model](uint32_t index) { return model.meshes[index]; })
+			| std::ranges::to<std::vector>();
+		const auto mesh_remap = mesh_dedup.compact_remap();
+
+		std::vector<std::optional<std::vector<unsigned char>>> images(model.images.size());
+		for (const auto index : image_dedup.canonical_indices()) images[index] = model.images[index].image;
+
+		const auto samplers = sampler_dedup.canonical_indices()
+			| std::views::transform([&model](uint32_t index) {
+				  return get_descriptor(model.samplers[index]);
+			  })
+			| std::ranges::to<std::vector>();
+		const auto sampler_slots = sampler_dedup.compact_remap();
+
+		const auto textures = model.textures
+			| std::views::transform([&](const tinygltf::Texture& texture) {
+				  const auto source = gltf::Texture::from_tinygltf(model, texture);
+				  return source->remap(image_dedup.remap, sampler_slots);
+			  })
+			| std::ranges::to<std::vector>();
+
+		std::vector<ResolvedDrawcall> drawcalls;
+		for (const auto [node_index, node] : model.nodes | std::views::enumerate)
+		{
+			if (node.mesh < 0) continue;
+
+			for (const auto& primitive : meshes[mesh_remap[node.mesh]].primitives)
+			{
+				auto& drawcall = drawcalls.emplace_back(ResolvedDrawcall{
+					.node = uint32_t(node_index),
+					.positions = read_positions(model, primitive.attributes.at("POSITION")),
+					.material = primitive.material,
+					.textures = {}
+				});
+				if (primitive.material < 0) continue;
+
+				for (const int texture_index : get_texture_indices(model.materials[primitive.material]))
+				{
+					if (texture_index < 0)
+					{
+						drawcall.textures.emplace_back();
+						continue;
+					}
+
+					const auto& texture = textures[texture_index];
+					const auto& image = images[texture.image_index];
+					if (!TEST_CHECK(image.has_value())) continue;
+
+					const auto sampler = texture.sampler_index.transform([&samplers](uint32_t slot) {
+						return samplers[slot];
+					});
+					drawcall.textures.emplace_back(*image, sampler.value_or(SamplerDescriptor{}));
+				}
+			}
+		}
+
+		return drawcalls;
+	}
+}
+
+int main()
+{
+	test::run("dedup_images", [] {
+		tinygltf::Model model;
+		model.images = {
+			make_image(2, 2, {1, 2, 3, 4}),
+			make_image(2, 2, {1, 2, 3, 5}),  // Different pixels
+			make_image(4, 1, {1, 2, 3, 4}),  // Same bytes, different size
+			make_image(2, 2, {1, 2, 3, 4}),  // Duplicate of 0
+			make_image(2, 2, {}),            // Not decoded, kept unique
+			make_image(2, 2, {}),
+			make_image(2, 2, {1, 2, 3, 5})   // Duplicate of 1
+		};
+
+		const auto dedup = gltf::dedup_images(model);
+		TEST_CHECK(dedup.remap == std::vector<uint32_t>({0, 1, 2, 0, 4, 5, 1}));
+		TEST_CHECK(dedup.summary.duplicates == 2);
+		TEST_CHECK(dedup.summary.saved_bytes == 8);
+		TEST_CHECK(dedup.is_canonical(2) && !dedup.is_canonical(3));
+		TEST_CHECK(dedup.compact_remap() == std::vector<uint32_t>({0, 1, 2, 0, 3, 4, 1}));
+	});
+
+	test::run("dedup_meshes", [] {
+		tinygltf::Model model;
+		const int packed = add_positions(model, triangle);
+		const int strided = add_positions(model, triangle, 16);  // Same content, padding between elements
+		const int moved = add_positions(model, {triangle[0], triangle[1], {0, 2, 0}});
+
+		auto morphed = make_mesh(packed);
+		morphed.primitives[0].targets.push_back({{"POSITION", moved}});
+
+		model.meshes = {
+			make_mesh(packed),
+			make_mesh(moved),      // Different content
+			make_mesh(strided),    // Duplicate of 0 through another accessor
+			make_mesh(packed, 0),  // Different material
+			morphed,               // Morph targets are never merged
+			make_mesh(packed)      // Duplicate of 0 through the same accessor
+		};
+
+		const auto dedup = gltf::dedup_meshes(model);
+		TEST_CHECK(dedup.remap == std::vector<uint32_t>({0, 1, 0, 3, 4, 0}));
+		TEST_CHECK(dedup.summary.duplicates == 2);
+		TEST_CHECK(dedup.summary.saved_bytes == 2 * sizeof(glm::vec3) * triangle.size());
+		TEST_CHECK(dedup.compact_remap() == std::vector<uint32_t>({0, 1, 0, 2, 3, 0}));
+	});
+
+	test::run("dedup_meshes invalid accessors", [] {
+		tinygltf::Model model;
+		const int sparse = add_positions(model, triangle);
+		model.accessors[sparse].sparse.isSparse = true;
+
+		const int out_of_range = add_positions(model, triangle);
+		model.accessors[out_of_range].count = 4;
+
+		model.meshes =
+			{make_mesh(sparse), make_mesh(sparse), make_mesh(out_of_range), make_mesh(out_of_range)};
+
+		const auto dedup = gltf::dedup_meshes(model);
+		TEST_CHECK(dedup.remap == std::vector<uint32_t>({0, 1, 2, 3}));
+		TEST_CHECK(dedup.summary.duplicates == 0 && dedup.summary.saved_bytes == 0);
+	});
+
+	test::run("dedup_samplers", [] {
+		tinygltf::Model model;
+		model.samplers.resize(4);
+		model.samplers[1].magFilter = 9728;
+		model.samplers[3].magFilter = 9728;
+
+		const auto dedup = gltf::dedup_samplers(model);
+		TEST_CHECK(dedup.remap == std::vector<uint32_t>({0, 1, 0, 1}));
+		TEST_CHECK(dedup.summary.duplicates == 2);
+		TEST_CHECK(dedup.compact_remap() == std::vector<uint32_t>({0, 1, 0, 1}));
+	});
+
+	test::run("Draw output equivalence", [] {
+		gltf::DedupSummary total_meshes, total_images, total_samplers;
+
+		for (int iteration = 0; iteration < 200; iteration++)
+		{
+			const auto model = make_duplicated_model();
+			TEST_CHECK(resolve_deduplicated(model) == resolve_source(model));
+
+			total_meshes.duplicates += gltf::dedup_meshes(model).summary.duplicates;
+			total_images.duplicates += gltf::dedup_images(model).summary.duplicates;
+			total_samplers.duplicates += gltf::dedup_samplers(model).summary.duplicates;
+		}
+
+		// Every kind of element was deduplicated along the way
+		TEST_CHECK(total_meshes.duplicates > 200);
+		TEST_CHECK(total_images.duplicates > 200);
+		TEST_CHECK(total_samplers.duplicates > 200);
+	});
+
+	return test::finish();
+}
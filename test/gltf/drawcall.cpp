@@ -0,0 +1,485 @@
+// Cached drawcall partitions, handles and hierarchical culling of the static partition
+
+#include "gltf/model.hpp"
+#include "graphics/culling.hpp"
+#include "test/check.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <glm/gtc/matrix_transform.hpp>
+#include <new>
+#include <random>
+
+// Global allocations, counted to check that steady-state frames do not allocate
+static size_t allocation_count = 0;
+
+void* operator new(size_t size)
+{
+	allocation_count++;
+	if (void* pointer = std::malloc(std::max(size, 1zu))) return pointer;
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	allocation_count++;
+	const auto align = size_t(alignment);
+	if (void* pointer = std::aligned_alloc(align, (std::max(size, 1zu) + align - 1) / align * align))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
+
+namespace
+{
+	std::mt19937 generator{3};
+
+	std::shared_ptr<gltf::DrawcallPartition> make_partition(size_t count, uint32_t generation) noexcept
+	{
+		std::uniform_real_distribution<float> position{-50.0f, 50.0f};
+		std::uniform_real_distribution<float> extent{0.1f, 4.0f};
+
+		auto partition = std::make_shared<gltf::DrawcallPartition>();
+		partition->generation = generation;
+
+		std::vector<graphics::Aabb> bounds;
+		for (size_t index = 0; index < count; index++)
+		{
+			const glm::vec3 center = {position(generator), position(generator), position(generator)};
+			const glm::vec3 half_size = {extent(generator), extent(generator), extent(generator)};
+
+			gltf::PrimitiveDrawcall drawcall{};
+			drawcall.world_position_min = center - half_size;
+			drawcall.world_position_max = center + half_size;
+			drawcall.transform_or_joint_matrix_offset = glm::mat4(1.0f);
+			partition->drawcalls.push_back(drawcall);
+
+			bounds.push_back({.min = drawcall.world_position_min, .max = drawcall.world_position_max});
+		}
+
+		partition->bvh = graphics::Bvh::build(bounds);
+		return partition;
+	}
+
+	using Partition = gltf::DrawcallHandle::Partition;
+	using Visit = std::pair<gltf::DrawcallHandle, const gltf::PrimitiveDrawcall*>;
+
+	bool same_visit(const Visit& a, const Visit& b) noexcept
+	{
+		return a.first.partition == b.first.partition
+			&& a.first.index == b.first.index
+			&& a.first.generation == b.first.generation
+			&& a.second == b.second;
+	}
+
+	bool same_drawcall(const gltf::PrimitiveDrawcall& a, const gltf::PrimitiveDrawcall& b) noexcept
+	{
+		return a.world_position_min == b.world_position_min
+			&& a.world_position_max == b.world_position_max
+			&& a.material_index == b.material_index
+			&& a.transform_or_joint_matrix_offset == b.transform_or_joint_matrix_offset
+			&& a.emissive_multiplier == b.emissive_multiplier;
+	}
+
+	///
+	/// @brief Node hierarchy standing in for a model, emitting synthetic drawcalls
+	/// @details Each node emits up to 3 drawcalls, placed by the model transform and a node offset.
+	/// Offsets of dynamic nodes change on `animate`, like animated or rigged nodes.
+	///
+	struct SyntheticModel
+	{
+		std::vector<uint32_t> node_order;
+		std::vector<bool> renderable_nodes;
+		std::vector<bool> dynamic_nodes;
+		std::vector<uint32_t> primitive_counts;
+		std::vector<glm::vec3> node_offsets;
+		glm::mat4 model_transform = glm::mat4(1.0f);
+
+		explicit SyntheticModel(size_t node_count) noexcept
+		{
+			std::bernoulli_distribution renderable{0.9};
+			std::bernoulli_distribution dynamic{0.3};
+
+			node_order = std::views::iota(0u, uint32_t(node_count)) | std::ranges::to<std::vector>();
+			std::ranges::shuffle(node_order, generator);
+
+			for (size_t node = 0; node < node_count; node++)
+			{
+				renderable_nodes.push_back(renderable(generator));
+				dynamic_nodes.push_back(dynamic(generator));
+				primitive_counts.push_back(generator() % 4);
+				node_offsets.emplace_back(float(node), 0.0f, 0.0f);
+			}
+		}
+
+		void animate() noexcept
+		{
+			std::uniform_real_distribution<float> offset{-10.0f, 10.0f};
+			for (const auto [offset_value, dynamic] : std::views::zip(node_offsets, dynamic_nodes))
+				if (dynamic) offset_value = {offset(generator), offset(generator), offset(generator)};
+		}
+
+		// Append drawcalls of a node, as `Model::append_node_drawcalls` does
+		void append(
+			uint32_t node_index,
+			float emissive_multiplier,
+			std::vector<gltf::PrimitiveDrawcall>& output
+		) const noexcept
+		{
+			const auto world_matrix = glm::translate(model_transform, node_offsets[node_index]);
+			for (uint32_t primitive = 0; primitive < primitive_counts[node_index]; primitive++)
+			{
+				const auto center = glm::vec3(world_matrix[3]) + glm::vec3(0.0f, float(primitive), 0.0f);
+				output.push_back({
+					.world_position_min = center - 0.5f,
+					.world_position_max = center + 0.5f,
+					.material_index = node_index * 4 + primitive,
+					.transform_or_joint_matrix_offset = world_matrix,
+					.primitive = {},
+					.emissive_multiplier = emissive_multiplier,
+				});
+			}
+		}
+
+		gltf::DrawcallList update(
+			gltf::DrawcallCache& cache,
+			std::span<const std::pair<uint32_t, float>> emission_overrides,
+			std::span<const uint32_t> hidden_nodes
+		) const noexcept
+		{
+			return cache.update(
+				model_transform,
+				node_order,
+				renderable_nodes,
+				dynamic_nodes,
+				emission_overrides,
+				hidden_nodes,
+				[this](uint32_t node_index, float emissive_multiplier, auto& output) {
+					append(node_index, emissive_multiplier, output);
+				}
+			);
+		}
+
+		// Visibility and emission value of every node
+		std::pair<std::vector<bool>, std::vector<float>> resolve(
+			std::span<const std::pair<uint32_t, float>> emission_overrides,
+			std::span<const uint32_t> hidden_nodes
+		) const noexcept
+		{
+			auto visible_nodes = renderable_nodes;
+			for (const auto hidden_node_index : hidden_nodes) visible_nodes[hidden_node_index] = false;
+
+			std::vector<float> emission_values(renderable_nodes.size(), 1.0f);
+			for (const auto& [node_index, emission_value] : emission_overrides)
+				emission_values[node_index] = emission_value;
+
+			return {std::move(visible_nodes), std::move(emission_values)};
+		}
+
+		// Drawcalls of every visible node in node order, as one list like before partitioning
+		std::vector<gltf::PrimitiveDrawcall> reference(
+			std::span<const std::pair<uint32_t, float>> emission_overrides,
+			std::span<const uint32_t> hidden_nodes
+		) const noexcept
+		{
+			const auto [visible_nodes, emission_values] = resolve(emission_overrides, hidden_nodes);
+
+			std::vector<gltf::PrimitiveDrawcall> drawcalls;
+			for (const auto node_index : node_order)
+				if (visible_nodes[node_index]) append(node_index, emission_values[node_index], drawcalls);
+
+			return drawcalls;
+		}
+
+		bool is_dynamic(const gltf::PrimitiveDrawcall& drawcall) const noexcept
+		{
+			return dynamic_nodes[*drawcall.material_index / 4];
+		}
+	};
+
+	// Copy the drawcalls of a list, in `for_each` order
+	std::vector<gltf::PrimitiveDrawcall> collect(const gltf::DrawcallList& list) noexcept
+	{
+		std::vector<gltf::PrimitiveDrawcall> drawcalls;
+		list.for_each([&drawcalls](gltf::DrawcallHandle, const gltf::PrimitiveDrawcall& drawcall) {
+			drawcalls.push_back(drawcall);
+		});
+		return drawcalls;
+	}
+}
+
+int main()
+{
+	test::run("DrawcallList::resolve", [] {
+		const gltf::DrawcallList list{
+			.static_partition = make_partition(5, 3),
+			.dynamic_partition = make_partition(2, 4)
+		};
+
+		std::vector<Visit> visits;
+		list.for_each([&](gltf::DrawcallHandle handle, const gltf::PrimitiveDrawcall& drawcall) {
+			visits.emplace_back(handle, &drawcall);
+		});
+
+		// Static partition first, every handle resolves to the visited drawcall
+		if (!TEST_CHECK(visits.size() == 7 && list.size() == 7)) return;
+		for (const auto [index, visit] : visits | std::views::enumerate)
+		{
+			const auto expected_partition = index < 5 ? Partition::Static : Partition::Dynamic;
+			TEST_CHECK(visit.first.partition == expected_partition);
+			TEST_CHECK(list.resolve(visit.first) == visit.second);
+		}
+
+		// Out of range and wrong generation
+		TEST_CHECK(list.resolve({.partition = Partition::Static, .index = 5, .generation = 3}) == nullptr);
+		TEST_CHECK(list.resolve({.partition = Partition::Dynamic, .index = 0, .generation = 3}) == nullptr);
+
+		// A rebuilt static partition makes its old handles stale, dynamic handles stay valid
+		const gltf::DrawcallList rebuilt{
+			.static_partition = make_partition(5, 5),
+			.dynamic_partition = list.dynamic_partition
+		};
+		TEST_CHECK(rebuilt.resolve(visits[0].first) == nullptr);
+		TEST_CHECK(rebuilt.resolve(visits[6].first) == visits[6].second);
+
+		// Missing partitions resolve nothing
+		const gltf::DrawcallList empty{.static_partition = nullptr, .dynamic_partition = nullptr};
+		TEST_CHECK(empty.size() == 0);
+		TEST_CHECK(empty.resolve(visits[0].first) == nullptr);
+	});
+
+	test::run("DrawcallList::for_each_in_range", [] {
+		const gltf::DrawcallList list{
+			.static_partition = make_partition(11, 1),
+			.dynamic_partition = make_partition(6, 2)
+		};
+
+		std::vector<Visit> all;
+		list.for_each([&](gltf::DrawcallHandle handle, const gltf::PrimitiveDrawcall& drawcall) {
+			all.emplace_back(handle, &drawcall);
+		});
+
+		// Chunks of any size, including ones straddling both partitions, visit the same sequence
+		for (const size_t chunk_size : {1zu, 2zu, 3zu, 5zu, 11zu, 16zu, 40zu})
+		{
+			std::vector<Visit> chunked;
+			for (size_t begin = 0; begin < list.size(); begin += chunk_size)
+				list.for_each_in_range(
+					begin,
+					begin + chunk_size,
+					[&](gltf::DrawcallHandle handle, const gltf::PrimitiveDrawcall& drawcall) {
+						chunked.emplace_back(handle, &drawcall);
+					}
+				);
+
+			TEST_CHECK(std::ranges::equal(chunked, all, same_visit));
+		}
+	});
+
+	test::run("DrawcallList::cull_static", [] {
+		const gltf::DrawcallList list{
+			.static_partition = make_partition(800, 7),
+			.dynamic_partition = nullptr
+		};
+
+		std::uniform_real_distribution<float> coordinate{-60.0f, 60.0f};
+		std::pmr::vector<uint8_t> visible;
+
+		for (int view = 0; view < 32; view++)
+		{
+			const glm::vec3 eye = {coordinate(generator), coordinate(generator), coordinate(generator)};
+			const glm::vec3 target = {coordinate(generator), coordinate(generator), coordinate(generator)};
+			const auto view_projection = glm::perspective(glm::radians(60.0f), 1.5f, 0.1f, 80.0f)
+				* glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+			const auto planes = graphics::compute_frustum_planes(view_projection);
+
+			list.cull_static(planes, visible);
+			if (!TEST_CHECK(visible.size() == list.static_partition->drawcalls.size())) continue;
+
+			// The hierarchy accepts exactly the drawcalls a linear test accepts
+			for (const auto [flag, drawcall] : std::views::zip(visible, list.static_partition->drawcalls))
+			{
+				const bool expected = graphics::box_in_frustum(
+					drawcall.world_position_min,
+					drawcall.world_position_max,
+					planes
+				);
+				TEST_CHECK((flag != 0) == expected);
+			}
+		}
+
+		// Output and traversal only allocate from the given resources
+		std::array<std::byte, 64 * 1024> buffer;
+		std::pmr::monotonic_buffer_resource arena(
+			buffer.data(),
+			buffer.size(),
+			std::pmr::null_memory_resource()
+		);
+		std::pmr::vector<uint8_t> arena_visible(&arena);
+
+		const size_t allocations_before = allocation_count;
+		list.cull_static(graphics::compute_frustum_planes(glm::mat4(1.0f)), arena_visible, &arena);
+		TEST_CHECK(allocation_count == allocations_before);
+		TEST_CHECK(arena_visible.size() == list.static_partition->drawcalls.size());
+
+		const gltf::DrawcallList empty{.static_partition = nullptr, .dynamic_partition = nullptr};
+		empty.cull_static(graphics::compute_frustum_planes(glm::mat4(1.0f)), visible);
+		TEST_CHECK(visible.empty());
+	});
+
+	test::run("DrawcallCache equivalence", [] {
+		SyntheticModel model(60);
+		gltf::DrawcallCache cache;
+
+		std::bernoulli_distribution toggle{0.2};
+		std::uniform_int_distribution<uint32_t> node{0, 59};
+		std::uniform_real_distribution<float> multiplier{0.0f, 4.0f};
+
+		std::vector<uint32_t> hidden_nodes;
+		std::vector<std::pair<uint32_t, float>> emission_overrides;
+		auto static_inputs = std::make_pair(glm::mat4(1.0f), model.resolve({}, {}));
+		uint32_t static_generation = 0;
+
+		for (int frame = 0; frame < 200; frame++)
+		{
+			model.animate();
+
+			if (toggle(generator))
+			{
+				hidden_nodes.clear();
+				for (int count = generator() % 6; count > 0; count--) hidden_nodes.push_back(node(generator));
+			}
+			if (toggle(generator))
+			{
+				emission_overrides.clear();
+				for (int count = generator() % 4; count > 0; count--)
+					emission_overrides.emplace_back(node(generator), multiplier(generator));
+			}
+			if (frame % 50 == 49)
+				model.model_transform = glm::translate(model.model_transform, glm::vec3(1.0f, 2.0f, 3.0f));
+
+			const auto inputs =
+				std::make_pair(model.model_transform, model.resolve(emission_overrides, hidden_nodes));
+			const bool static_changed = frame == 0 || inputs != static_inputs;
+			static_inputs = inputs;
+
+			const auto list = model.update(cache, emission_overrides, hidden_nodes);
+			if (!TEST_CHECK(list.static_partition != nullptr && list.dynamic_partition != nullptr)) return;
+
+			// Same drawcalls as the unpartitioned list, in its order within each partition
+			auto expected = model.reference(emission_overrides, hidden_nodes);
+			std::ranges::stable_partition(expected, [&model](const gltf::PrimitiveDrawcall& drawcall) {
+				return !model.is_dynamic(drawcall);
+			});
+			TEST_CHECK(std::ranges::equal(collect(list), expected, same_drawcall));
+			TEST_CHECK(
+				std::ranges::none_of(list.static_partition->drawcalls, [&model](const auto& drawcall) {
+					return model.is_dynamic(drawcall);
+				})
+			);
+
+			// The static partition is rebuilt exactly when its resolved inputs change
+			const bool rebuilt = list.static_partition->generation != static_generation;
+			TEST_CHECK(rebuilt == static_changed || frame == 0);
+			static_generation = list.static_partition->generation;
+		}
+	});
+
+	test::run("DrawcallCache frame slots", [] {
+		SyntheticModel model(40);
+		gltf::DrawcallCache cache;
+		cache.set_frame_count(3);
+
+		// Lists of the previous `frame_count - 1` frames, with copies of their drawcalls
+		std::vector<std::pair<gltf::DrawcallList, std::vector<gltf::PrimitiveDrawcall>>> in_flight;
+
+		for (int frame = 0; frame < 30; frame++)
+		{
+			model.animate();
+			const auto list = model.update(cache, {}, {});
+
+			for (const auto& [held, drawcalls] : in_flight)
+			{
+				TEST_CHECK(held.dynamic_partition != list.dynamic_partition);
+				TEST_CHECK(std::ranges::equal(collect(held), drawcalls, same_drawcall));
+			}
+
+			in_flight.emplace_back(list, collect(list));
+			if (in_flight.size() == 3) in_flight.erase(in_flight.begin());
+		}
+
+		// Slots are recycled once `frame_count` frames have passed
+		const auto first = model.update(cache, {}, {}).dynamic_partition.get();
+		model.update(cache, {}, {});
+		model.update(cache, {}, {});
+		TEST_CHECK(model.update(cache, {}, {}).dynamic_partition.get() == first);
+
+		// Instanced partitions rotate through their own slots, each with a new generation
+		std::vector<const gltf::DrawcallPartition*> instanced;
+		std::vector<uint32_t> generations;
+		for (int call = 0; call < 6; call++)
+		{
+			const auto& partition = cache.next_instanced_partition();
+			TEST_CHECK(partition->drawcalls.empty());
+			instanced.push_back(partition.get());
+			generations.push_back(partition->generation);
+		}
+
+		for (int call = 0; call < 3; call++) TEST_CHECK(instanced[call] == instanced[call + 3]);
+		TEST_CHECK(instanced[0] != instanced[1] && instanced[1] != instanced[2]);
+		TEST_CHECK(std::ranges::is_sorted(generations));
+		TEST_CHECK(std::ranges::adjacent_find(generations) == generations.end());
+	});
+
+	test::run("DrawcallCache steady state allocations", [] {
+		SyntheticModel model(80);
+		gltf::DrawcallCache cache;
+		cache.set_frame_count(3);
+
+		const std::vector<uint32_t> hidden_nodes = {3, 17};
+		const std::vector<std::pair<uint32_t, float>> emission_overrides = {{5, 2.0f}, {40, 0.5f}};
+
+		// Fill every slot, and build the static partition
+		for (int frame = 0; frame < 3; frame++)
+		{
+			model.animate();
+			model.update(cache, emission_overrides, hidden_nodes);
+		}
+
+		// Animated frames with unchanged static inputs reuse all storage
+		size_t allocations = 0;
+		size_t drawcall_count = 0;
+		for (int frame = 0; frame < 100; frame++)
+		{
+			model.animate();
+
+			const size_t allocations_before = allocation_count;
+			drawcall_count += model.update(cache, emission_overrides, hidden_nodes).size();
+			allocations += allocation_count - allocations_before;
+		}
+
+		TEST_CHECK(allocations == 0);
+		TEST_CHECK(drawcall_count > 0);
+	});
+
+	return test::finish();
+}
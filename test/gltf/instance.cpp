@@ -0,0 +1,479 @@
+// Grouping of model instances into instanced drawcalls, against per-instance visibility and emission
+
+#include "gltf/instance.hpp"
+#include "gltf/model.hpp"
+#include "test/check.hpp"
+
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{67};
+
+	struct NodeState
+	{
+		std::vector<uint8_t> visible;
+		std::vector<float> emission_values;
+	};
+
+	// Emission drawn from a few multipliers, so instances share groups
+	NodeState make_node_state(size_t instance_count, float hidden_rate, uint32_t multiplier_count) noexcept
+	{
+		std::bernoulli_distribution hidden{hidden_rate};
+
+		NodeState state;
+		for (size_t instance = 0; instance < instance_count; instance++)
+		{
+			const float multiplier =
+				multiplier_count > 1 ? float(generator() % multiplier_count) * 0.5f : 1.0f;
+			state.visible.push_back(hidden(generator) ? 0 : 1);
+			state.emission_values.push_back(multiplier);
+		}
+
+		return state;
+	}
+
+	struct Groups
+	{
+		std::vector<uint32_t> instance_indices;
+		std::vector<gltf::InstanceGroup> groups;
+	};
+
+	Groups group(const NodeState& state, bool rigged) noexcept
+	{
+		Groups result;
+		gltf::group_node_instances(
+			state.visible,
+			state.emission_values,
+			rigged,
+			result.instance_indices,
+			result.groups
+		);
+		return result;
+	}
+
+	// Every visible instance in exactly one group, which matches its multiplier
+	bool check_groups(const NodeState& state, bool rigged, const Groups& result) noexcept
+	{
+		const auto visible_count = size_t(std::ranges::count(state.visible, uint8_t(1)));
+		if (!TEST_CHECK(result.instance_indices.size() == visible_count)) return false;
+
+		std::vector<uint8_t> seen(state.visible.size(), 0);
+		uint32_t next_first = 0;
+
+		for (const auto [index, group] : result.groups | std::views::enumerate)
+		{
+			// Contiguous, non-empty, distinct multipliers in ascending order
+			if (!TEST_CHECK(group.first == next_first && group.count > 0)) return false;
+			if (index > 0)
+				TEST_CHECK(result.groups[index - 1].emissive_multiplier < group.emissive_multiplier);
+			next_first += group.count;
+			if (!TEST_CHECK(next_first <= result.instance_indices.size())) return false;
+
+			const auto members = std::span(result.instance_indices).subspan(group.first, group.count);
+			TEST_CHECK(std::ranges::adjacent_find(members, std::greater_equal()) == members.end());
+
+			for (const auto instance : members)
+			{
+				if (!TEST_CHECK(instance < state.visible.size())) return false;
+				TEST_CHECK(state.visible[instance] != 0);
+				TEST_CHECK(seen[instance] == 0);
+				seen[instance] = 1;
+
+				const float expected = rigged ? 1.0f : state.emission_values[instance];
+				TEST_CHECK(group.emissive_multiplier == expected);
+			}
+		}
+
+		return TEST_CHECK(next_first == result.instance_indices.size());
+	}
+
+	// Joints per instance of the synthetic model
+	constexpr uint32_t joint_count = 24;
+
+	///
+	/// @brief Node hierarchy standing in for a model, emitting synthetic drawcalls
+	/// @details Nodes with a mesh emit 1 to 3 drawcalls, placed by the model transform and a node offset.
+	/// Rigged nodes emit their skin offset and ignore emission, as `Model::append_node_drawcalls`.
+	///
+	struct SyntheticModel
+	{
+		std::vector<uint32_t> node_order;
+		std::vector<bool> renderable_nodes;
+		std::vector<bool> dynamic_nodes;
+		std::vector<bool> rigged_nodes;
+		std::vector<uint32_t> primitive_counts;
+
+		explicit SyntheticModel(size_t node_count) noexcept
+		{
+			std::bernoulli_distribution renderable{0.9};
+			std::bernoulli_distribution rigged{0.2};
+			std::bernoulli_distribution animated{0.2};
+
+			node_order = std::views::iota(0u, uint32_t(node_count)) | std::ranges::to<std::vector>();
+			std::ranges::shuffle(node_order, generator);
+
+			for (size_t node = 0; node < node_count; node++)
+			{
+				const bool node_rigged = rigged(generator);
+				renderable_nodes.push_back(renderable(generator));
+				rigged_nodes.push_back(node_rigged);
+				dynamic_nodes.push_back(node_rigged || animated(generator));
+				primitive_counts.push_back(generator() % 4);
+			}
+		}
+
+		glm::mat4 get_world_matrix(const glm::mat4& model_transform, uint32_t node_index) const noexcept
+		{
+			return glm::translate(model_transform, glm::vec3(float(node_index), 0.0f, 0.0f));
+		}
+
+		void append(
+			const glm::mat4& model_transform,
+			uint32_t node_index,
+			float emissive_multiplier,
+			std::vector<gltf::PrimitiveDrawcall>& output
+		) const noexcept
+		{
+			using TransformOrJointMatrixOffset =
+				decltype(gltf::PrimitiveDrawcall::transform_or_joint_matrix_offset);
+
+			const bool rigged = rigged_nodes[node_index];
+			const auto world_matrix = get_world_matrix(model_transform, node_index);
+
+			for (uint32_t primitive = 0; primitive < primitive_counts[node_index]; primitive++)
+			{
+				const auto center = glm::vec3(world_matrix[3]) + glm::vec3(0.0f, float(primitive), 0.0f);
+				output.push_back({
+					.world_position_min = center - 0.5f,
+					.world_position_max = center + 0.5f,
+					.material_index = node_index * 4 + primitive,
+					.transform_or_joint_matrix_offset = rigged
+						? TransformOrJointMatrixOffset(node_index % joint_count)
+						: TransformOrJointMatrixOffset(world_matrix),
+					.primitive = {},
+					.emissive_multiplier = rigged ? 1.0f : emissive_multiplier,
+				});
+			}
+		}
+	};
+
+	// One instance, instances are spaced along z so that their index reads back from a world matrix
+	struct Instance
+	{
+		glm::mat4 model_transform;
+		std::vector<std::pair<uint32_t, float>> emission_overrides;
+		std::vector<uint32_t> hidden_nodes;
+	};
+
+	std::vector<Instance> make_instances(size_t instance_count, size_t node_count) noexcept
+	{
+		std::uniform_real_distribution<float> offset{-20.0f, 20.0f};
+		std::uniform_int_distribution<uint32_t> node{0, uint32_t(node_count - 1)};
+
+		std::vector<Instance> instances;
+		for (size_t instance_index = 0; instance_index < instance_count; instance_index++)
+		{
+			Instance instance{
+				.model_transform = glm::translate(
+					glm::mat4(1.0f),
+					glm::vec3(offset(generator), offset(generator), 1000.0f * float(instance_index))
+				)
+			};
+
+			// Few distinct multipliers, so instances share groups
+			for (int count = generator() % 4; count > 0; count--)
+				instance.hidden_nodes.push_back(node(generator));
+			for (int count = generator() % 4; count > 0; count--)
+				instance.emission_overrides.emplace_back(node(generator), float(generator() % 3) * 0.5f);
+
+			instances.push_back(std::move(instance));
+		}
+
+		return instances;
+	}
+
+	uint32_t read_instance_index(const glm::mat4& world_matrix) noexcept
+	{
+		return uint32_t(std::lround(world_matrix[3].z / 1000.0f));
+	}
+
+	// Drawcalls of every instance, from one `DrawcallCache::update` per instance as `generate_drawdata`
+	std::vector<std::vector<gltf::PrimitiveDrawcall>> draw_single(
+		const SyntheticModel& model,
+		std::span<const Instance> instances
+	) noexcept
+	{
+		gltf::DrawcallCache cache;
+		std::vector<std::vector<gltf::PrimitiveDrawcall>> result;
+
+		for (const auto& instance : instances)
+		{
+			const auto list = cache.update(
+				instance.model_transform,
+				model.node_order,
+				model.renderable_nodes,
+				model.dynamic_nodes,
+				instance.emission_overrides,
+				instance.hidden_nodes,
+				[&](uint32_t node_index, float emissive_multiplier, auto& output) {
+					model.append(instance.model_transform, node_index, emissive_multiplier, output);
+				}
+			);
+
+			auto& drawcalls = result.emplace_back();
+			list.for_each([&drawcalls](gltf::DrawcallHandle, const gltf::PrimitiveDrawcall& drawcall) {
+				drawcalls.push_back(drawcall);
+			});
+		}
+
+		return result;
+	}
+
+	struct Instanced
+	{
+		std::vector<gltf::PrimitiveDrawcall> drawcalls;
+		std::vector<gltf::InstanceData> instance_data;
+	};
+
+	// Instanced drawcalls of all instances, with the state layout of `generate_instanced_drawdata`
+	Instanced draw_instanced(const SyntheticModel& model, std::span<const Instance> instances) noexcept
+	{
+		const size_t instance_count = instances.size();
+		const size_t node_count = model.node_order.size();
+
+		std::vector<uint8_t> visible_nodes(node_count * instance_count);
+		std::vector<float> emission_values(node_count * instance_count);
+
+		for (const auto [instance_index, instance] : instances | std::views::enumerate)
+		{
+			for (size_t node_index = 0; node_index < node_count; node_index++)
+			{
+				const size_t state_index = node_index * instance_count + size_t(instance_index);
+				visible_nodes[state_index] = model.renderable_nodes[node_index];
+				emission_values[state_index] = 1.0f;
+			}
+
+			for (const auto hidden_node_index : instance.hidden_nodes)
+				visible_nodes[hidden_node_index * instance_count + instance_index] = 0;
+			for (const auto& [node_index, emission_value] : instance.emission_overrides)
+				emission_values[node_index * instance_count + instance_index] = emission_value;
+		}
+
+		Instanced result;
+		std::vector<uint32_t> instance_indices;
+		std::vector<gltf::InstanceGroup> groups;
+		std::vector<gltf::PrimitiveDrawcall> primitives;
+		std::vector<graphics::Aabb> primitive_bounds;
+
+		for (const auto node_index : model.node_order)
+		{
+			if (!model.renderable_nodes[node_index]) continue;
+
+			primitives.clear();
+			model.append(glm::mat4(1.0f), node_index, 1.0f, primitives);
+
+			// Bounds are computed exactly as for single drawcalls
+			primitive_bounds.resize(primitives.size() * instance_count);
+			for (const auto [instance_index, instance] : instances | std::views::enumerate)
+			{
+				std::vector<gltf::PrimitiveDrawcall> drawcalls;
+				model.append(instance.model_transform, node_index, 1.0f, drawcalls);
+
+				for (const auto [primitive_index, drawcall] : drawcalls | std::views::enumerate)
+					primitive_bounds[size_t(primitive_index) * instance_count + size_t(instance_index)] = {
+						.min = drawcall.world_position_min,
+						.max = drawcall.world_position_max
+					};
+			}
+
+			gltf::append_instanced_drawcalls(
+				primitives,
+				std::span(visible_nodes).subspan(node_index * instance_count, instance_count),
+				std::span(emission_values).subspan(node_index * instance_count, instance_count),
+				primitive_bounds,
+				joint_count,
+				[&](uint32_t instance_index) {
+					return model.get_world_matrix(instances[instance_index].model_transform, node_index);
+				},
+				instance_indices,
+				groups,
+				result.instance_data,
+				result.drawcalls
+			);
+		}
+
+		return result;
+	}
+
+	// One drawcall of an instance, expanded from an instanced drawcall
+	struct Expanded
+	{
+		gltf::PrimitiveDrawcall drawcall;
+		size_t source;  // Index of the instanced drawcall
+	};
+
+	// Expand instanced drawcalls to the drawcalls of every instance, in instanced drawcall order
+	std::vector<std::vector<Expanded>> expand(const Instanced& instanced, size_t instance_count) noexcept
+	{
+		std::vector<std::vector<Expanded>> result(instance_count);
+
+		for (const auto [source, drawcall] : instanced.drawcalls | std::views::enumerate)
+		{
+			const auto instance_data =
+				std::span(instanced.instance_data).subspan(drawcall.instance_offset, drawcall.instance_count);
+
+			for (const auto& data : instance_data)
+			{
+				auto single = drawcall;
+				single.instance_offset = 0;
+				single.instance_count = 0;
+
+				uint32_t instance_index;
+				if (drawcall.is_rigged())
+				{
+					const uint32_t palette_offset = data.joint_offset - drawcall.get_joint_matrix_offset();
+					instance_index = palette_offset / joint_count;
+					TEST_CHECK(palette_offset % joint_count == 0);
+				}
+				else
+				{
+					TEST_CHECK(drawcall.get_world_transform() == glm::mat4(1.0f));
+					single.transform_or_joint_matrix_offset = data.transform;
+					instance_index = read_instance_index(data.transform);
+				}
+
+				if (!TEST_CHECK(instance_index < instance_count)) continue;
+				result[instance_index].push_back({.drawcall = single, .source = size_t(source)});
+			}
+		}
+
+		return result;
+	}
+}
+
+int main()
+{
+	test::run("Empty", [] {
+		const auto result = group({}, false);
+		TEST_CHECK(result.groups.empty() && result.instance_indices.empty());
+
+		// Every instance hidden
+		const NodeState hidden = {.visible = {0, 0, 0}, .emission_values = {1.0f, 2.0f, 1.0f}};
+		const auto hidden_result = group(hidden, false);
+		TEST_CHECK(hidden_result.groups.empty() && hidden_result.instance_indices.empty());
+	});
+
+	test::run("Single multiplier", [] {
+		// One group in instance order, as drawn without overrides
+		const auto state = make_node_state(1000, 0.1f, 1);
+		const auto result = group(state, false);
+		if (!check_groups(state, false, result)) return;
+
+		TEST_CHECK(result.groups.size() == 1 && result.groups[0].emissive_multiplier == 1.0f);
+	});
+
+	test::run("Emission overrides", [] {
+		const NodeState state = {
+			.visible = {1, 1, 0, 1, 1, 1},
+			.emission_values = {2.0f, 1.0f, 0.5f, 2.0f, 0.0f, 1.0f}
+		};
+
+		const auto result = group(state, false);
+		if (!check_groups(state, false, result)) return;
+
+		// Hidden instance 2 is dropped, its multiplier has no group
+		if (!TEST_CHECK(result.groups.size() == 3)) return;
+		TEST_CHECK(std::ranges::equal(result.instance_indices, std::array{4u, 1u, 5u, 0u, 3u}));
+		TEST_CHECK(result.groups[0].emissive_multiplier == 0.0f && result.groups[0].count == 1);
+		TEST_CHECK(result.groups[1].emissive_multiplier == 1.0f && result.groups[1].count == 2);
+		TEST_CHECK(result.groups[2].emissive_multiplier == 2.0f && result.groups[2].count == 2);
+	});
+
+	test::run("Rigged", [] {
+		// Emission overrides are ignored, one group of every visible instance
+		const auto state = make_node_state(500, 0.3f, 4);
+		const auto result = group(state, true);
+		if (!check_groups(state, true, result)) return;
+
+		TEST_CHECK(result.groups.size() == 1);
+		TEST_CHECK(std::ranges::is_sorted(result.instance_indices));
+	});
+
+	test::run("Random", [] {
+		Groups result;
+		for (int trial = 0; trial < 200; trial++)
+		{
+			const auto state =
+				make_node_state(generator() % 700, float(generator() % 4) * 0.25f, 1 + generator() % 6);
+			const bool rigged = trial % 5 == 0;
+
+			// Outputs are reused from trial to trial, as by the model
+			gltf::group_node_instances(
+				state.visible,
+				state.emission_values,
+				rigged,
+				result.instance_indices,
+				result.groups
+			);
+			check_groups(state, rigged, result);
+		}
+	});
+
+	test::run("Instanced drawcalls", [] {
+		const SyntheticModel model(40);
+
+		for (const size_t instance_count : {1zu, 2zu, 7zu, 64zu, 300zu})
+		{
+			const auto instances = make_instances(instance_count, 40);
+			const auto single = draw_single(model, instances);
+			const auto instanced = draw_instanced(model, instances);
+			const auto expanded = expand(instanced, instance_count);
+
+			// Union of the single bounds of the instances drawn by each instanced drawcall
+			std::vector<graphics::Aabb> unions(
+				instanced.drawcalls.size(),
+				{.min = glm::vec3(std::numeric_limits<float>::max()),
+				 .max = glm::vec3(std::numeric_limits<float>::lowest())}
+			);
+
+			for (const auto [instance_drawcalls, expected] : std::views::zip(expanded, single))
+			{
+				// Static partition first in the single list, node order within each partition
+				auto actual = instance_drawcalls;
+				std::ranges::stable_partition(actual, [&model](const Expanded& entry) {
+					return !model.dynamic_nodes[*entry.drawcall.material_index / 4];
+				});
+
+				if (!TEST_CHECK(actual.size() == expected.size())) continue;
+
+				for (const auto& [entry, drawcall] : std::views::zip(actual, expected))
+				{
+					// Same drawcall, emission and visibility included, except for the bound
+					const auto& [instance_drawcall, source] = entry;
+					TEST_CHECK(instance_drawcall.material_index == drawcall.material_index);
+					TEST_CHECK(
+						instance_drawcall.transform_or_joint_matrix_offset
+						== drawcall.transform_or_joint_matrix_offset
+					);
+					TEST_CHECK(instance_drawcall.emissive_multiplier == drawcall.emissive_multiplier);
+
+					auto& bound = unions[source];
+					bound.min = glm::min(bound.min, drawcall.world_position_min);
+					bound.max = glm::max(bound.max, drawcall.world_position_max);
+				}
+			}
+
+			// Bounds are exactly the union of the instance bounds
+			for (const auto [drawcall, bound] : std::views::zip(instanced.drawcalls, unions))
+			{
+				TEST_CHECK(drawcall.world_position_min == bound.min);
+				TEST_CHECK(drawcall.world_position_max == bound.max);
+			}
+		}
+	});
+
+	return test::finish();
+}
@@ -0,0 +1,251 @@
+// Encode error of `gltf::encode_joint_palette`, decoded as in `joint-palette.glsl`
+
+#include "gltf/joint-palette.hpp"
+#include "test/check.hpp"
+
+#include <cstring>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{61};
+	std::uniform_real_distribution<float> unit{-1.0f, 1.0f};
+
+	glm::vec3 random_axis() noexcept
+	{
+		const glm::vec3 axis = {unit(generator), unit(generator), unit(generator) + 0.01f};
+		return glm::normalize(axis);
+	}
+
+	// Rotation, uniform scale and translation
+	glm::mat4 random_similarity(float scale) noexcept
+	{
+		const glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), unit(generator) * 3.1f, random_axis());
+		const glm::vec3 translation = glm::vec3(unit(generator), unit(generator), unit(generator)) * 5.0f;
+		return glm::scale(glm::translate(glm::mat4(1.0f), translation) * rotation, glm::vec3(scale));
+	}
+
+	// Any affine matrix, with shear and non-uniform scale
+	glm::mat4 random_affine() noexcept
+	{
+		glm::mat4 matrix(1.0f);
+		for (int column = 0; column < 4; column++)
+			for (int row = 0; row < 3; row++) matrix[column][row] = unit(generator) * 3.0f;
+		return matrix;
+	}
+
+	float max_difference(const glm::mat4& a, const glm::mat4& b) noexcept
+	{
+		float difference = 0.0f;
+		for (int column = 0; column < 4; column++)
+			for (int row = 0; row < 4; row++)
+				difference = std::max(difference, std::abs(a[column][row] - b[column][row]));
+		return difference;
+	}
+
+	// Rounding tolerance, relative to the translation
+	bool close_to(const glm::mat4& decoded, const glm::mat4& expected) noexcept
+	{
+		return max_difference(decoded, expected) <= 1e-4f * (1.0f + glm::length(glm::vec3(expected[3])));
+	}
+
+	std::vector<std::byte> encode(
+		gltf::JointPalette palette,
+		std::span<const glm::mat4> world,
+		std::span<const glm::mat4> inverse_bind
+	) noexcept
+	{
+		std::vector<std::byte> output(world.size() * gltf::get_joint_palette_stride(palette));
+		gltf::encode_joint_palette(palette, world, inverse_bind, output);
+		return output;
+	}
+
+	// Port of `blend_joint_dual_quaternions` in `joint-palette.glsl`
+	glm::mat4 blend_dual_quaternions(
+		std::span<const std::byte> palette,
+		glm::uvec4 joints,
+		glm::vec4 weights
+	) noexcept
+	{
+		glm::vec4 real_sum(0.0f), dual_sum(0.0f), first_real(0.0f, 0.0f, 0.0f, 1.0f);
+		float scale = 0.0f;
+
+		for (int slot = 0; slot < 4; slot++)
+		{
+			glm::vec4 real, dual;
+			std::memcpy(&real, palette.data() + joints[slot] * 32, sizeof(real));
+			std::memcpy(&dual, palette.data() + joints[slot] * 32 + 16, sizeof(dual));
+
+			const float joint_scale = std::max(glm::dot(real, real), 1e-20f);
+			const float inv_norm = 1.0f / std::sqrt(joint_scale);
+			real *= inv_norm;
+			dual *= inv_norm;
+
+			if (slot == 0) first_real = real;
+			const float weight = glm::dot(real, first_real) < 0.0f ? -weights[slot] : weights[slot];
+
+			real_sum += real * weight;
+			dual_sum += dual * weight;
+			scale += joint_scale * weights[slot];
+		}
+
+		const float inv_length = 1.0f / glm::length(real_sum);
+		real_sum *= inv_length;
+		dual_sum *= inv_length;
+
+		const glm::vec3 r = glm::vec3(real_sum);
+		const float w = real_sum.w;
+		const glm::vec3 d = glm::vec3(dual_sum);
+
+		const glm::vec3 rotation_x = {
+			1 - 2 * (r.y * r.y + r.z * r.z),
+			2 * (r.x * r.y + w * r.z),
+			2 * (r.x * r.z - w * r.y)
+		};
+		const glm::vec3 rotation_y = {
+			2 * (r.x * r.y - w * r.z),
+			1 - 2 * (r.x * r.x + r.z * r.z),
+			2 * (r.y * r.z + w * r.x)
+		};
+		const glm::vec3 rotation_z = {
+			2 * (r.x * r.z + w * r.y),
+			2 * (r.y * r.z - w * r.x),
+			1 - 2 * (r.x * r.x + r.y * r.y)
+		};
+
+		glm::mat4 result(1.0f);
+		result[0] = glm::vec4(rotation_x * scale, 0.0f);
+		result[1] = glm::vec4(rotation_y * scale, 0.0f);
+		result[2] = glm::vec4(rotation_z * scale, 0.0f);
+		result[3] = glm::vec4((d * w - r * dual_sum.w + glm::cross(r, d)) * 2.0f, 1.0f);
+
+		return result;
+	}
+}
+
+int main()
+{
+	test::run("Strides", [] {
+		TEST_CHECK(gltf::get_joint_palette_stride(gltf::JointPalette::Matrix) == 64);
+		TEST_CHECK(gltf::get_joint_palette_stride(gltf::JointPalette::Affine) == 48);
+		TEST_CHECK(gltf::get_joint_palette_stride(gltf::JointPalette::Dual_quaternion) == 32);
+	});
+
+	test::run("Matrix and affine", [] {
+		// Joint counts around the SIMD batch sizes
+		for (size_t joint_count = 0; joint_count < 20; joint_count++)
+		{
+			std::vector<glm::mat4> world, inverse_bind;
+			for (size_t joint = 0; joint < joint_count; joint++)
+			{
+				world.push_back(random_affine());
+				inverse_bind.push_back(random_affine());
+			}
+
+			const auto matrices = encode(gltf::JointPalette::Matrix, world, inverse_bind);
+			const auto affine = encode(gltf::JointPalette::Affine, world, inverse_bind);
+
+			for (size_t joint = 0; joint < joint_count; joint++)
+			{
+				const glm::mat4 expected = world[joint] * inverse_bind[joint];
+				const float tolerance = 1e-5f * (1.0f + max_difference(expected, glm::mat4(0.0f)));
+
+				glm::mat4 matrix;
+				std::memcpy(&matrix, matrices.data() + joint * 64, sizeof(matrix));
+				TEST_CHECK(max_difference(matrix, expected) <= tolerance);
+
+				// Rows of the upper 3x4 part
+				std::array<glm::vec4, 3> rows;
+				std::memcpy(rows.data(), affine.data() + joint * 48, sizeof(rows));
+				const glm::mat4 from_rows =
+					glm::transpose(glm::mat4(rows[0], rows[1], rows[2], glm::vec4(0, 0, 0, 1)));
+				TEST_CHECK(max_difference(from_rows, expected) <= tolerance);
+			}
+		}
+	});
+
+	test::run("Output bounds", [] {
+		// Nothing written past the joints
+		const std::vector<glm::mat4> world(5, random_affine()), inverse_bind(5, random_affine());
+
+		for (const auto palette :
+			 {gltf::JointPalette::Matrix, gltf::JointPalette::Affine, gltf::JointPalette::Dual_quaternion})
+		{
+			const size_t size = world.size() * gltf::get_joint_palette_stride(palette);
+			std::vector<std::byte> output(size + 64, std::byte{0xAB});
+			gltf::encode_joint_palette(palette, world, inverse_bind, output);
+
+			TEST_CHECK(std::ranges::all_of(output | std::views::drop(size), [](std::byte value) {
+				return value == std::byte{0xAB};
+			}));
+		}
+	});
+
+	test::run("Dual quaternion, single joint", [] {
+		std::vector<glm::mat4> world, inverse_bind;
+		for (int joint = 0; joint < 67; joint++)
+		{
+			world.push_back(random_similarity(1.0f + 0.3f * unit(generator)));
+			inverse_bind.push_back(random_similarity(1.0f));
+		}
+
+		// Rigid joints with uniform scale are exact, up to rounding
+		const auto palette = encode(gltf::JointPalette::Dual_quaternion, world, inverse_bind);
+		for (uint32_t joint = 0; joint < world.size(); joint++)
+		{
+			const glm::mat4 expected = world[joint] * inverse_bind[joint];
+			const auto decoded = blend_dual_quaternions(palette, glm::uvec4(joint), glm::vec4(1, 0, 0, 0));
+			TEST_CHECK(close_to(decoded, expected));
+		}
+	});
+
+	test::run("Dual quaternion, non-uniform scale", [] {
+		const glm::vec3 axis_scale = {0.5f, 1.0f, 3.0f};
+		const std::array world = {glm::scale(random_similarity(1.0f), axis_scale)};
+		const std::array inverse_bind = {glm::mat4(1.0f)};
+
+		// Scale averaged over the axes, translation kept
+		const auto palette = encode(gltf::JointPalette::Dual_quaternion, world, inverse_bind);
+		const auto decoded = blend_dual_quaternions(palette, glm::uvec4(0), glm::vec4(1, 0, 0, 0));
+
+		const float mean_scale = (axis_scale.x + axis_scale.y + axis_scale.z) / 3.0f;
+		for (int column = 0; column < 3; column++)
+			TEST_CHECK(std::abs(glm::length(glm::vec3(decoded[column])) - mean_scale) < 1e-4f);
+		TEST_CHECK(glm::length(glm::vec3(decoded[3]) - glm::vec3(world[0][3])) < 1e-4f);
+	});
+
+	test::run("Dual quaternion, blending", [] {
+		// Half way between no rotation and a quarter turn, a point keeps its distance to the axis
+		const std::array world = {
+			glm::mat4(1.0f),
+			glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), glm::vec3(0, 0, 1))
+		};
+		const std::array inverse_bind = {glm::mat4(1.0f), glm::mat4(1.0f)};
+		const auto palette = encode(gltf::JointPalette::Dual_quaternion, world, inverse_bind);
+
+		const auto blended =
+			blend_dual_quaternions(palette, glm::uvec4(0, 1, 0, 0), glm::vec4(0.5f, 0.5f, 0, 0));
+		const glm::vec3 point = glm::vec3(blended * glm::vec4(1, 0, 0, 1));
+		const float half_angle = glm::radians(45.0f);
+		TEST_CHECK(glm::length(point - glm::vec3(std::cos(half_angle), std::sin(half_angle), 0)) < 1e-4f);
+
+		// Same joint in every slot, any weights
+		for (int sample = 0; sample < 100; sample++)
+		{
+			const std::array joint_world = {random_similarity(1.0f + 0.3f * unit(generator))};
+			const std::array joint_bind = {random_similarity(1.0f)};
+			const auto joint_palette = encode(gltf::JointPalette::Dual_quaternion, joint_world, joint_bind);
+
+			glm::vec4 weights = {unit(generator), unit(generator), unit(generator), unit(generator)};
+			weights = glm::abs(weights);
+			weights /= weights.x + weights.y + weights.z + weights.w;
+
+			const glm::mat4 expected = joint_world[0] * joint_bind[0];
+			const auto decoded = blend_dual_quaternions(joint_palette, glm::uvec4(0), weights);
+			TEST_CHECK(close_to(decoded, expected));
+		}
+	});
+
+	return test::finish();
+}
@@ -0,0 +1,148 @@
+// Packing of occlusion and metallic-roughness into shared ORM textures
+
+#include "gltf/image.hpp"
+#include "gltf/material.hpp"
+#include "test/check.hpp"
+
+#include <cstring>
+
+namespace
+{
+	tinygltf::Image rgba8_image(int width, int height, const std::vector<glm::u8vec4>& pixels) noexcept
+	{
+		tinygltf::Image image;
+		image.width = width;
+		image.height = height;
+		image.component = 4;
+		image.bits = 8;
+		image.pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+		image.image.resize(pixels.size() * sizeof(glm::u8vec4));
+		std::memcpy(image.image.data(), pixels.data(), image.image.size());
+		return image;
+	}
+
+	// Image with only a size, enough for planning
+	tinygltf::Image sized_image(int width, int height) noexcept
+	{
+		tinygltf::Image image;
+		image.width = width;
+		image.height = height;
+		return image;
+	}
+
+	struct MaterialDesc
+	{
+		std::optional<uint32_t> occlusion, metallic_roughness;
+		int occlusion_tex_coord = 0;
+	};
+
+	struct Scene
+	{
+		tinygltf::Model model;
+		std::vector<gltf::Texture> textures;
+		std::vector<gltf::MaterialIndexed> materials;
+	};
+
+	Scene make_scene(std::vector<gltf::Texture> textures, const std::vector<MaterialDesc>& descs) noexcept
+	{
+		Scene scene{.model = {}, .textures = std::move(textures), .materials = {}};
+
+		// Images 0~2 share a size, image 3 does not
+		scene.model.images = {sized_image(4, 4), sized_image(4, 4), sized_image(4, 4), sized_image(8, 8)};
+
+		for (const auto& desc : descs)
+		{
+			tinygltf::Material material;
+			material.occlusionTexture.texCoord = desc.occlusion_tex_coord;
+			scene.model.materials.push_back(material);
+
+			gltf::MaterialIndexed indexed;
+			indexed.occlusion = desc.occlusion;
+			indexed.metallic_roughness = desc.metallic_roughness;
+			scene.materials.push_back(indexed);
+		}
+
+		return scene;
+	}
+
+	// Textures as (image, sampler) pairs
+	const std::vector<gltf::Texture> scene_textures = {
+		{.image_index = 0, .sampler_index = 0           },
+		{.image_index = 1, .sampler_index = 0           },
+		{.image_index = 2, .sampler_index = 0           },
+		{.image_index = 3, .sampler_index = 0           },
+		{.image_index = 0, .sampler_index = 1           },
+		{.image_index = 0, .sampler_index = 0           },
+		{.image_index = 0, .sampler_index = std::nullopt},
+		{.image_index = 1, .sampler_index = std::nullopt}
+	};
+
+	const std::vector<MaterialDesc> scene_materials = {
+		{.occlusion = 0, .metallic_roughness = 1},                            // New pack
+		{.occlusion = 5, .metallic_roughness = 1},                            // Same sources, another texture
+		{.occlusion = 2, .metallic_roughness = 1},                            // Another occlusion image
+		{.occlusion = 0, .metallic_roughness = 5},                            // Already one image
+		{.occlusion = 0, .metallic_roughness = 3},                            // Size mismatch
+		{.occlusion = 4, .metallic_roughness = 1},                            // Sampler mismatch
+		{.occlusion = 0, .metallic_roughness = 1, .occlusion_tex_coord = 1},  // UV set mismatch
+		{.occlusion = std::nullopt, .metallic_roughness = 1},                 // No occlusion
+		{.occlusion = 6, .metallic_roughness = 7}                             // Default sampler on both
+	};
+}
+
+int main()
+{
+	test::run("pack_orm_image", [] {
+		const auto occlusion = rgba8_image(2, 1, {{10, 11, 12, 13}, {20, 21, 22, 23}});
+		const auto metallic_roughness = rgba8_image(2, 1, {{30, 31, 32, 33}, {40, 41, 42, 43}});
+
+		const auto packed = gltf::pack_orm_image(occlusion, metallic_roughness);
+		if (!TEST_CHECK(packed.has_value() && packed->size == glm::u32vec2(2, 1))) return;
+
+		// R from occlusion, G and B from metallic-roughness, opaque
+		TEST_CHECK(packed->pixels[0] == glm::u8vec4(10, 31, 32, 255));
+		TEST_CHECK(packed->pixels[1] == glm::u8vec4(20, 41, 42, 255));
+
+		const auto mismatched = rgba8_image(1, 2, {{0, 0, 0, 0}, {0, 0, 0, 0}});
+		TEST_CHECK(!gltf::pack_orm_image(occlusion, mismatched).has_value());
+	});
+
+	test::run("plan_orm_packs merge", [] {
+		auto scene = make_scene(scene_textures, scene_materials);
+		const auto packs = gltf::plan_orm_packs(scene.model, scene.textures, scene.materials, true);
+
+		// Packs are keyed by source images and sampler, not by texture index
+		const std::vector<gltf::OrmPackSource> expected = {
+			{.occlusion_image = 0, .metallic_roughness_image = 1, .sampler_index = 0           },
+			{.occlusion_image = 2, .metallic_roughness_image = 1, .sampler_index = 0           },
+			{.occlusion_image = 0, .metallic_roughness_image = 1, .sampler_index = std::nullopt}
+		};
+		TEST_CHECK(packs == expected);
+
+		const std::vector<std::optional<uint32_t>> expected_pack =
+			{0, 0, 1, std::nullopt, std::nullopt, std::nullopt, std::nullopt, std::nullopt, 2};
+		const std::vector<bool> expected_flag = {true, true, true, true, false, false, false, false, true};
+
+		for (const auto [material, pack, flag] :
+			 std::views::zip(scene.materials, expected_pack, expected_flag))
+		{
+			TEST_CHECK(material.orm_pack == pack);
+			TEST_CHECK(material.params.factor.orm_packed == flag);
+		}
+	});
+
+	test::run("plan_orm_packs without merge", [] {
+		auto scene = make_scene(scene_textures, scene_materials);
+		const auto packs = gltf::plan_orm_packs(scene.model, scene.textures, scene.materials, false);
+		TEST_CHECK(packs.empty());
+
+		// Only the material already storing ORM in one image is flagged
+		for (const auto [index, material] : scene.materials | std::views::enumerate)
+		{
+			TEST_CHECK(!material.orm_pack.has_value());
+			TEST_CHECK(material.params.factor.orm_packed == (index == 3));
+		}
+	});
+
+	return test::finish();
+}
@@ -0,0 +1,193 @@
+// Release timing of `gpu::DeletionQueue` against a mock GPU completing submissions in order
+
+#include "gpu/deletion-queue.hpp"
+#include "test/check.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{83};
+
+	// Completes submissions in order, fences of completed submissions are signaled
+	struct MockGpu
+	{
+		uint64_t completed = 0;
+
+		gpu::DeletionQueue::FencePoll fence(uint64_t submission) const noexcept
+		{
+			return [this, submission] { return submission <= completed; };
+		}
+	};
+
+	// Deleters recording the release order of resources
+	struct Released
+	{
+		std::vector<uint32_t> ids;
+
+		gpu::DeletionQueue::Deleter deleter(uint32_t id) noexcept
+		{
+			return [this, id] { ids.push_back(id); };
+		}
+	};
+}
+
+int main()
+{
+	test::run("Fences", [] {
+		MockGpu gpu;
+		Released released;
+		gpu::DeletionQueue queue(0);
+
+		// Submission 1, fenced
+		queue.release(released.deleter(1), 100);
+		queue.release(released.deleter(2), 200);
+		queue.submit(gpu.fence(queue.get_recording_index()));
+		queue.collect();
+		TEST_CHECK(released.ids.empty());
+		TEST_CHECK(queue.get_stats().pending_resources == 2 && queue.get_stats().pending_bytes == 300);
+
+		// Submission 2, without fence
+		queue.release(released.deleter(3), 10);
+		queue.submit(gpu::DeletionQueue::FencePoll());
+
+		// Submission 3, fenced, submission 1 completes
+		queue.release(released.deleter(4), 1);
+		queue.submit(gpu.fence(queue.get_recording_index()));
+		gpu.completed = 1;
+		queue.collect();
+		TEST_CHECK(std::ranges::equal(released.ids, std::array{1u, 2u}));
+		TEST_CHECK(queue.get_completed_index() == 1);
+		TEST_CHECK(queue.get_stats().released_resources == 2 && queue.get_stats().released_bytes == 300);
+		TEST_CHECK(queue.get_stats().pending_resources == 2 && queue.get_stats().pending_submissions == 2);
+
+		// Submission 2 has no fence, it is only known to be completed with submission 3
+		gpu.completed = 2;
+		queue.collect();
+		TEST_CHECK(released.ids.size() == 2 && queue.get_completed_index() == 1);
+		TEST_CHECK(queue.get_stats().released_resources == 0);
+
+		gpu.completed = 3;
+		queue.collect();
+		TEST_CHECK(std::ranges::equal(released.ids, std::array{1u, 2u, 3u, 4u}));
+		TEST_CHECK(queue.get_completed_index() == 3);
+		TEST_CHECK(queue.get_stats().pending_resources == 0 && queue.get_stats().pending_bytes == 0);
+		TEST_CHECK(queue.get_stats().pending_submissions == 0);
+	});
+
+	test::run("Budget", [] {
+		MockGpu gpu;
+		Released released;
+		gpu::DeletionQueue queue(3);
+
+		for (uint32_t id = 0; id < 7; id++) queue.release(released.deleter(id), 1);
+		queue.submit(gpu.fence(queue.get_recording_index()));
+		queue.release(released.deleter(7), 1);
+		queue.submit(gpu.fence(queue.get_recording_index()));
+
+		// Over budget resources are kept for the next collect, in release order
+		gpu.completed = 2;
+		queue.collect();
+		TEST_CHECK(released.ids.size() == 3 && queue.get_stats().pending_resources == 5);
+		queue.collect();
+		TEST_CHECK(released.ids.size() == 6 && queue.get_stats().released_resources == 3);
+		queue.collect();
+		TEST_CHECK(released.ids.size() == 8 && queue.get_stats().released_resources == 2);
+		TEST_CHECK(std::ranges::is_sorted(released.ids));
+	});
+
+	test::run("Empty resources", [] {
+		gpu::DeletionQueue queue;
+		queue.release(gpu::DeletionQueue::Deleter(), 16);
+		TEST_CHECK(queue.get_stats().pending_resources == 0 && queue.get_stats().pending_bytes == 0);
+	});
+
+	test::run("Flush", [] {
+		MockGpu gpu;
+		Released released;
+		gpu::DeletionQueue queue(1);
+
+		queue.release(released.deleter(0), 8);
+		queue.submit(gpu.fence(queue.get_recording_index()));
+		queue.release(released.deleter(1), 8);
+		queue.release(released.deleter(2), 8);
+		queue.submit(gpu::DeletionQueue::FencePoll());
+
+		// Releases everything regardless of fences and budget
+		queue.flush();
+		TEST_CHECK(std::ranges::equal(released.ids, std::array{0u, 1u, 2u}));
+		TEST_CHECK(queue.get_completed_index() == 2);
+		TEST_CHECK(queue.get_stats().released_resources == 3 && queue.get_stats().released_bytes == 24);
+		TEST_CHECK(queue.get_stats().pending_resources == 0 && queue.get_stats().pending_submissions == 0);
+	});
+
+	test::run("Random frames", [] {
+		for (int trial = 0; trial < 50; trial++)
+		{
+			MockGpu gpu;
+			Released released;
+			gpu::DeletionQueue queue(generator() % 6);
+
+			std::vector<uint64_t> submission_of;
+			std::vector<uint64_t> bytes_of;
+			uint64_t last_fenced = 0;
+
+			for (int frame = 0; frame < 200; frame++)
+			{
+				const uint64_t submission = queue.get_recording_index();
+				for (uint32_t release = generator() % 5; release > 0; release--)
+				{
+					const auto id = uint32_t(submission_of.size());
+					submission_of.push_back(submission);
+					bytes_of.push_back(generator() % 1000);
+					queue.release(released.deleter(id), bytes_of.back());
+				}
+
+				if (generator() % 4 == 0)
+					queue.submit(gpu::DeletionQueue::FencePoll());
+				else
+				{
+					queue.submit(gpu.fence(submission));
+					last_fenced = submission;
+				}
+
+				// The GPU lags a few submissions behind
+				const uint64_t lag = std::min<uint64_t>(submission, generator() % 4);
+				gpu.completed = std::max(gpu.completed, submission - lag);
+
+				const size_t released_before = released.ids.size();
+				queue.collect();
+
+				// Only resources of completed submissions, in release order
+				TEST_CHECK(queue.get_completed_index() <= gpu.completed);
+				for (const auto id : std::span(released.ids).subspan(released_before))
+					TEST_CHECK(submission_of[id] <= queue.get_completed_index());
+
+				uint64_t released_bytes = 0;
+				for (const auto id : std::span(released.ids).subspan(released_before))
+					released_bytes += bytes_of[id];
+				TEST_CHECK(queue.get_stats().released_bytes == released_bytes);
+				TEST_CHECK(queue.get_stats().released_resources == released.ids.size() - released_before);
+
+				const auto pending = std::span(bytes_of).subspan(released.ids.size());
+				const uint64_t pending_bytes = std::reduce(pending.begin(), pending.end(), uint64_t(0));
+				TEST_CHECK(queue.get_stats().pending_bytes == pending_bytes);
+			}
+
+			TEST_CHECK(std::ranges::equal(released.ids, std::views::iota(0u, uint32_t(released.ids.size()))));
+
+			// Everything up to the last fenced submission is released once the GPU catches up
+			gpu.completed = queue.get_recording_index() - 1;
+			for (int collect = 0; collect < 1000 && queue.get_stats().pending_resources > 0; collect++)
+				queue.collect();
+
+			TEST_CHECK(queue.get_completed_index() == last_fenced);
+			for (const auto [id, submission] : submission_of | std::views::enumerate)
+				TEST_CHECK((submission <= last_fenced) == (size_t(id) < released.ids.size()));
+		}
+	});
+
+	return test::finish();
+}
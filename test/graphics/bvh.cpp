@@ -0,0 +1,211 @@
+// Structure, queries and refitting of `graphics::Bvh` against linear tests over every box
+
+#include "graphics/bvh.hpp"
+#include "graphics/culling.hpp"
+#include "test/check.hpp"
+
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{17};
+	std::uniform_real_distribution<float> coordinate{-100.0f, 100.0f};
+
+	std::vector<graphics::Aabb> random_boxes(size_t count) noexcept
+	{
+		std::uniform_real_distribution<float> extent{0.1f, 5.0f};
+
+		std::vector<graphics::Aabb> boxes;
+		for (size_t index = 0; index < count; index++)
+		{
+			const glm::vec3 center = {coordinate(generator), coordinate(generator), coordinate(generator)};
+			const glm::vec3 half_size = {extent(generator), extent(generator), extent(generator)};
+			boxes.push_back({.min = center - half_size, .max = center + half_size});
+		}
+
+		return boxes;
+	}
+
+	std::array<glm::vec4, 6> random_frustum() noexcept
+	{
+		const glm::vec3 eye = {coordinate(generator), coordinate(generator), coordinate(generator)};
+		const glm::vec3 target = {coordinate(generator), coordinate(generator), coordinate(generator)};
+
+		return graphics::compute_frustum_planes(
+			glm::perspective(glm::radians(50.0f), 1.5f, 0.5f, 150.0f)
+			* glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f))
+		);
+	}
+
+	graphics::Aabb random_query_box() noexcept
+	{
+		std::uniform_real_distribution<float> extent{0.0f, 40.0f};
+
+		const glm::vec3 center = {coordinate(generator), coordinate(generator), coordinate(generator)};
+		const glm::vec3 half_size = {extent(generator), extent(generator), extent(generator)};
+		return {.min = center - half_size, .max = center + half_size};
+	}
+
+	std::vector<uint32_t> sorted(std::span<const uint32_t> indices) noexcept
+	{
+		auto result = indices | std::ranges::to<std::vector>();
+		std::ranges::sort(result);
+		return result;
+	}
+
+	std::vector<uint32_t> linear_frustum(
+		std::span<const graphics::Aabb> boxes,
+		std::span<const glm::vec4> planes
+	) noexcept
+	{
+		std::vector<uint32_t> result;
+		for (const auto [index, box] : boxes | std::views::enumerate)
+			if (graphics::box_in_frustum(box.min, box.max, planes)) result.push_back(uint32_t(index));
+		return result;
+	}
+
+	std::vector<uint32_t> linear_overlap(
+		std::span<const graphics::Aabb> boxes,
+		const graphics::Aabb& query
+	) noexcept
+	{
+		std::vector<uint32_t> result;
+		for (const auto [index, box] : boxes | std::views::enumerate)
+		{
+			const bool overlap = glm::all(glm::lessThanEqual(box.min, query.max))
+							  && glm::all(glm::lessThanEqual(query.min, box.max));
+			if (overlap) result.push_back(uint32_t(index));
+		}
+		return result;
+	}
+
+	// Both query types on random regions give the same primitives as the linear tests
+	bool queries_match(
+		const graphics::Bvh& bvh,
+		std::span<const graphics::Aabb> boxes,
+		int query_count
+	) noexcept
+	{
+		bool match = true;
+
+		for (int query = 0; query < query_count; query++)
+		{
+			const auto planes = random_frustum();
+
+			// Subsets of planes are allowed, e.g. shadow frusta without near and far planes
+			const size_t plane_count = 4 + size_t(query % 3);
+			const auto used_planes = std::span(planes).first(plane_count);
+
+			std::pmr::vector<uint32_t> frustum_result;
+			bvh.query_frustum(used_planes, frustum_result);
+			match &= sorted(frustum_result) == linear_frustum(boxes, used_planes);
+
+			const auto query_box = random_query_box();
+
+			std::pmr::vector<uint32_t> overlap_result;
+			bvh.query_overlap(query_box, overlap_result);
+			match &= sorted(overlap_result) == linear_overlap(boxes, query_box);
+		}
+
+		return match;
+	}
+
+	void move_box(graphics::Aabb& box, const glm::vec3& offset) noexcept
+	{
+		box.min += offset;
+		box.max += offset;
+	}
+}
+
+int main()
+{
+	test::run("Bvh structure", [] {
+		for (const size_t count : {1zu, 5zu, 9zu, 100zu, 3000zu})
+		{
+			const auto boxes = random_boxes(count);
+			const auto bvh = graphics::Bvh::build(boxes, {.bin_count = 16, .max_leaf_size = 4});
+			const auto nodes = bvh.get_nodes();
+
+			if (!TEST_CHECK(bvh.size() == count && !nodes.empty())) continue;
+
+			std::vector<uint32_t> leaf_positions;
+			for (const auto [node_index, node] : nodes | std::views::enumerate)
+				for (uint32_t slot = 0; slot < graphics::Bvh::node_width; slot++)
+				{
+					if (node.count[slot] == 0) continue;
+
+					if (node.child[slot] == graphics::Bvh::leaf_child)
+					{
+						// Leaves hold a bounded number of primitives, each leaf-order position exactly once
+						TEST_CHECK(node.count[slot] <= 4);
+						for (uint32_t offset = 0; offset < node.count[slot]; offset++)
+							leaf_positions.push_back(node.first[slot] + offset);
+						continue;
+					}
+
+					// Children come after their parent, and cover the same primitive range
+					const auto child_index = node.child[slot];
+					if (!TEST_CHECK(child_index > uint32_t(node_index) && child_index < nodes.size()))
+						continue;
+
+					const auto& child = nodes[child_index];
+					uint32_t child_count = 0;
+					for (uint32_t child_slot = 0; child_slot < graphics::Bvh::node_width; child_slot++)
+						child_count += child.count[child_slot];
+					TEST_CHECK(child_count == node.count[slot]);
+				}
+
+			std::ranges::sort(leaf_positions);
+			TEST_CHECK(std::ranges::equal(leaf_positions, std::views::iota(0u, uint32_t(count))));
+		}
+
+		const auto empty = graphics::Bvh::build(std::span<const graphics::Aabb>());
+		TEST_CHECK(empty.empty());
+
+		std::pmr::vector<uint32_t> result;
+		empty.query_frustum(random_frustum(), result);
+		empty.query_overlap(random_query_box(), result);
+		TEST_CHECK(result.empty());
+	});
+
+	test::run("Bvh queries", [] {
+		for (const size_t count : {1zu, 3zu, 8zu, 9zu, 100zu, 1000zu, 20000zu})
+		{
+			const auto boxes = random_boxes(count);
+			TEST_CHECK(queries_match(graphics::Bvh::build(boxes), boxes, 40));
+		}
+
+		// Identical boxes cannot be split by position
+		const std::vector<graphics::Aabb> identical(50, random_boxes(1)[0]);
+		TEST_CHECK(queries_match(graphics::Bvh::build(identical), identical, 20));
+
+		// Large leaves and few bins
+		const auto boxes = random_boxes(2000);
+		const auto coarse = graphics::Bvh::build(boxes, {.bin_count = 2, .max_leaf_size = 16});
+		TEST_CHECK(queries_match(coarse, boxes, 20));
+	});
+
+	test::run("Bvh refit", [] {
+		auto boxes = random_boxes(5000);
+		auto bvh = graphics::Bvh::build(boxes);
+
+		// Few primitives moved, only their ancestors are refitted
+		std::vector<uint32_t> changed;
+		for (uint32_t index = 0; index < boxes.size(); index += 37)
+		{
+			move_box(boxes[index], {coordinate(generator) * 0.3f, 0.0f, coordinate(generator) * 0.3f});
+			changed.push_back(index);
+		}
+		bvh.refit(boxes, changed);
+		TEST_CHECK(queries_match(bvh, boxes, 30));
+
+		// Every primitive moved
+		for (auto& box : boxes) move_box(box, {0.0f, coordinate(generator) * 0.2f, 0.0f});
+		bvh.refit(boxes);
+		TEST_CHECK(queries_match(bvh, boxes, 30));
+	});
+
+	return test::finish();
+}
@@ -0,0 +1,329 @@
+// Plane merging, containment and frustum tests of `graphics::ConvexHull` on analytic solids
+
+#include "graphics/convex-hull.hpp"
+#include "graphics/culling.hpp"
+#include "test/check.hpp"
+#include "wavefront.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <glm/gtc/matrix_transform.hpp>
+#include <limits>
+#include <random>
+#include <ranges>
+#include <sstream>
+
+namespace
+{
+	std::mt19937 generator{53};
+	std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+
+	glm::vec3 random_point(float extent) noexcept
+	{
+		return (glm::vec3(unit(generator), unit(generator), unit(generator)) * 2.0f - 1.0f) * extent;
+	}
+
+	// Triangulated mesh vertices of a box, each face split in 2 triangles along a random diagonal
+	std::vector<glm::vec3> make_box_triangles(const glm::vec3& half_size) noexcept
+	{
+		std::vector<glm::vec3> triangles;
+		for (int axis = 0; axis < 3; axis++)
+			for (const float side : {-1.0f, 1.0f})
+			{
+				const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+
+				std::array<glm::vec3, 4> corners;
+				for (int corner = 0; corner < 4; corner++)
+				{
+					corners[corner][axis] = side * half_size[axis];
+					corners[corner][u] = (corner == 1 || corner == 2 ? 1.0f : -1.0f) * half_size[u];
+					corners[corner][v] = (corner >= 2 ? 1.0f : -1.0f) * half_size[v];
+				}
+
+				const int first = unit(generator) < 0.5f ? 0 : 1;
+				const auto& a = corners[first];
+				const auto& b = corners[first + 1];
+				const auto& c = corners[(first + 2) % 4];
+				const auto& d = corners[(first + 3) % 4];
+				triangles.append_range(std::array{a, b, c, a, c, d});
+			}
+
+		return triangles;
+	}
+
+	// Points on the unit sphere
+	std::vector<glm::vec3> make_sphere_points(size_t count) noexcept
+	{
+		std::vector<glm::vec3> points;
+		while (points.size() < count)
+		{
+			const glm::vec3 point = random_point(1.0f);
+			const float length = glm::length(point);
+			if (length > 0.1f && length <= 1.0f) points.push_back(point / length);
+		}
+
+		return points;
+	}
+
+	// Containment by the planes of every mesh triangle, as light volumes tested the camera before hulls
+	struct TrianglePlaneVolume
+	{
+		std::vector<glm::vec3> positions;  // First vertex of each triangle
+		std::vector<glm::vec3> normals;
+		glm::vec3 min{std::numeric_limits<float>::max()}, max{std::numeric_limits<float>::lowest()};
+
+		explicit TrianglePlaneVolume(std::span<const glm::vec3> triangles) noexcept
+		{
+			for (size_t index = 0; index + 2 < triangles.size(); index += 3)
+			{
+				const auto& p0 = triangles[index];
+				const auto& p1 = triangles[index + 1];
+				const auto& p2 = triangles[index + 2];
+				positions.push_back(p0);
+				normals.push_back(glm::normalize(glm::cross(p1 - p0, p2 - p0)));
+			}
+
+			for (const auto& point : triangles)
+			{
+				min = glm::min(min, point);
+				max = glm::max(max, point);
+			}
+		}
+
+		bool contains(const glm::vec3& point) const noexcept
+		{
+			if (glm::any(glm::lessThan(point, min)) || glm::any(glm::greaterThan(point, max))) return false;
+
+			for (const auto [position, normal] : std::views::zip(positions, normals))
+				if (glm::dot(normal, point - position) >= 0.0f) return false;
+
+			return true;
+		}
+
+		// Distance to the nearest triangle plane, infinite planes included
+		float get_plane_distance(const glm::vec3& point) const noexcept
+		{
+			float distance = std::numeric_limits<float>::max();
+			for (const auto [position, normal] : std::views::zip(positions, normals))
+				distance = std::min(distance, std::abs(glm::dot(normal, point - position)));
+			return distance;
+		}
+	};
+
+	// Shipped light volume meshes, sorted by name
+	std::vector<std::filesystem::path> list_light_volumes() noexcept
+	{
+		std::vector<std::filesystem::path> paths;
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(ASSET_DIR, error))
+			if (entry.path().extension() == ".obj") paths.push_back(entry.path());
+
+		std::ranges::sort(paths);
+		return paths;
+	}
+}
+
+int main()
+{
+	test::run("Invalid inputs", [] {
+		TEST_CHECK(!graphics::ConvexHull::from_points({}));
+
+		const std::array triangle = {glm::vec3(0, 0, 0), glm::vec3(1, 0, 0), glm::vec3(0, 1, 0)};
+		TEST_CHECK(!graphics::ConvexHull::from_points(triangle));
+
+		// Many points, all on a plane
+		std::vector<glm::vec3> coplanar;
+		for (int index = 0; index < 100; index++)
+			coplanar.push_back({unit(generator), 2.0f, unit(generator)});
+		TEST_CHECK(!graphics::ConvexHull::from_points(coplanar));
+	});
+
+	test::run("Box", [] {
+		const glm::vec3 half_size = {1.0f, 2.0f, 0.5f};
+		auto points = make_box_triangles(half_size);
+
+		// Interior points don't change the hull
+		for (int index = 0; index < 50; index++) points.push_back(random_point(0.4f));
+
+		const auto hull = graphics::ConvexHull::from_points(points);
+		if (!TEST_CHECK(hull.has_value())) return;
+
+		// Coplanar triangles merged to one plane per face
+		TEST_CHECK(hull->get_plane_count() == 6);
+		TEST_CHECK(hull->get_vertex_count() == 8);
+		TEST_CHECK(glm::all(glm::equal(hull->get_min(), -half_size)));
+		TEST_CHECK(glm::all(glm::equal(hull->get_max(), half_size)));
+		TEST_CHECK(hull->get_sphere_radius() >= glm::length(half_size) - 1e-5f);
+
+		// Points near the faces are on the right side, away from a thin band
+		for (int sample = 0; sample < 100000; sample++)
+		{
+			const glm::vec3 point = random_point(2.5f);
+			const glm::vec3 relative = glm::abs(point) / half_size;
+			const float max_relative = std::max({relative.x, relative.y, relative.z});
+			if (std::abs(max_relative - 1.0f) < 1e-4f) continue;
+
+			TEST_CHECK(hull->contains(point) == (max_relative < 1.0f));
+		}
+	});
+
+	test::run("Octahedron", [] {
+		const std::array<glm::vec3, 6> vertices = {
+			glm::vec3(1, 0, 0),
+			glm::vec3(-1, 0, 0),
+			glm::vec3(0, 1, 0),
+			glm::vec3(0, -1, 0),
+			glm::vec3(0, 0, 1),
+			glm::vec3(0, 0, -1)
+		};
+
+		const auto hull = graphics::ConvexHull::from_points(vertices);
+		if (!TEST_CHECK(hull.has_value())) return;
+
+		TEST_CHECK(hull->get_plane_count() == 8);
+		TEST_CHECK(hull->get_vertex_count() == 6);
+
+		for (int sample = 0; sample < 100000; sample++)
+		{
+			const glm::vec3 point = random_point(1.5f);
+			const float l1 = std::abs(point.x) + std::abs(point.y) + std::abs(point.z);
+			if (std::abs(l1 - 1.0f) < 1e-4f) continue;
+
+			TEST_CHECK(hull->contains(point) == (l1 < 1.0f));
+		}
+	});
+
+	test::run("Point cloud", [] {
+		const auto points = make_sphere_points(2000);
+		const auto hull = graphics::ConvexHull::from_points(points);
+		if (!TEST_CHECK(hull.has_value())) return;
+
+		TEST_CHECK(hull->get_vertex_count() > 100 && hull->get_vertex_count() <= points.size());
+
+		// Bounding sphere holds every input point
+		for (const auto& point : points)
+			TEST_CHECK(glm::length(point - hull->get_sphere_center()) <= hull->get_sphere_radius() + 1e-5f);
+
+		// Interior of the hull is contained, anything past the sphere is not
+		for (int sample = 0; sample < 20000; sample++)
+		{
+			const glm::vec3 direction = make_sphere_points(1)[0];
+			TEST_CHECK(hull->contains(direction * 0.8f * unit(generator)));
+			TEST_CHECK(!hull->contains(direction * (1.001f + unit(generator))));
+		}
+
+		// Mean of a few input points is inside, unless they share a face
+		size_t contained = 0;
+		for (int sample = 0; sample < 10000; sample++)
+		{
+			glm::vec3 mean(0.0f);
+			for (int index = 0; index < 6; index++) mean += points[generator() % points.size()];
+			contained += hull->contains(mean / 6.0f) ? 1 : 0;
+		}
+		TEST_CHECK(contained > 9900);
+	});
+
+	test::run("in_frustum", [] {
+		auto box = *graphics::ConvexHull::from_points(make_box_triangles({1.0f, 1.0f, 1.0f}));
+		auto sphere = *graphics::ConvexHull::from_points(make_sphere_points(500));
+
+		size_t culled = 0;
+		for (int view = 0; view < 3000; view++)
+		{
+			const glm::vec3 eye = random_point(15.0f);
+			const glm::mat4 view_projection =
+				glm::perspective(0.8f, 1.6f, 0.15f, 100.0f)
+				* glm::lookAt(eye, eye + random_point(1.0f), glm::vec3(0, 1, 0));
+			const auto planes = graphics::compute_frustum_planes(view_projection);
+
+			const glm::mat4 world_matrix = glm::scale(
+				glm::rotate(
+					glm::translate(glm::mat4(1.0f), random_point(3.0f)),
+					unit(generator) * 6.0f,
+					glm::normalize(random_point(1.0f) + glm::vec3(0, 0, 0.01f))
+				),
+				glm::vec3(0.5f + unit(generator))
+			);
+
+			// A hull with any point inside the frustum is never culled
+			for (const auto* hull : {&box, &sphere})
+			{
+				const bool visible = hull->in_frustum(planes, world_matrix);
+				culled += visible ? 0 : 1;
+				if (visible) continue;
+
+				for (int sample = 0; sample < 200; sample++)
+				{
+					const glm::vec3 local = random_point(1.0f);
+					if (!hull->contains(local)) continue;
+
+					const glm::vec3 world = glm::vec3(world_matrix * glm::vec4(local, 1.0f));
+					TEST_CHECK(!graphics::box_in_frustum(world, world, planes));
+				}
+			}
+		}
+
+		TEST_CHECK(culled > 1000);
+
+		// Past the far plane, kept by the side planes alone
+		const auto planes = graphics::compute_frustum_planes(glm::perspective(0.8f, 1.6f, 0.15f, 100.0f));
+		const glm::mat4 far_away = glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, -200));
+		TEST_CHECK(!box.in_frustum(planes, far_away));
+		TEST_CHECK(box.in_frustum(std::span(planes).first(4), far_away));
+
+		// Behind the camera
+		const glm::mat4 behind = glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, 10));
+		TEST_CHECK(!box.in_frustum(std::span(planes).first(4), behind));
+	});
+
+	test::run("Shipped light volumes", [] {
+		const auto paths = list_light_volumes();
+		if (!TEST_CHECK(!paths.empty())) return;
+
+		for (const auto& path : paths)
+		{
+			std::ifstream file(path);
+			std::stringstream content;
+			content << file.rdbuf();
+
+			const auto object = wavefront::parse_string(content.str());
+			if (!TEST_CHECK(object.has_value() && !object->vertices.empty())) continue;
+
+			const auto triangles = object->vertices
+				| std::views::transform(&wavefront::Vertex::pos)
+				| std::ranges::to<std::vector>();
+			const TrianglePlaneVolume volume(triangles);
+			const auto hull = graphics::ConvexHull::from_points(triangles);
+			if (!TEST_CHECK(hull.has_value())) continue;
+
+			// The bed volume is concave, its triangle planes cut the hull down
+			const bool concave = path.stem() == "BedLightVolume";
+
+			const glm::vec3 extent = volume.max - volume.min;
+			const float epsilon = 1e-3f * std::max({extent.x, extent.y, extent.z});
+
+			size_t inside = 0, hull_only = 0;
+			for (int sample = 0; sample < 50000; sample++)
+			{
+				const glm::vec3 offset = glm::vec3(unit(generator), unit(generator), unit(generator));
+				const glm::vec3 point = volume.min + extent * (offset * 1.5f - 0.25f);
+				if (volume.get_plane_distance(point) < epsilon) continue;
+
+				const bool triangle_inside = volume.contains(point);
+				const bool hull_inside = hull->contains(point);
+				inside += triangle_inside ? 1 : 0;
+				hull_only += hull_inside && !triangle_inside ? 1 : 0;
+
+				// Anything the triangle planes accept is inside the hull
+				if (triangle_inside) TEST_CHECK(hull_inside);
+			}
+
+			// Both tests agree on convex volumes, the hull only adds to the concave one
+			TEST_CHECK(inside > 1000);
+			TEST_CHECK(concave ? hull_only > 0 : hull_only == 0);
+		}
+	});
+
+	return test::finish();
+}
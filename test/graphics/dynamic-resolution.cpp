@@ -0,0 +1,309 @@
+// Convergence, stability and overshoot of `graphics::DynamicResolution`, on synthetic frame time traces
+
+#include "graphics/util/dynamic-resolution.hpp"
+#include "test/check.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace
+{
+	std::mt19937 generator{101};
+
+	using Controller = graphics::DynamicResolution;
+
+	constexpr float milliseconds = 0.001f;
+
+	// Tolerance of scale comparisons, scales are multiples of a float step
+	constexpr float epsilon = 1e-4f;
+
+	///
+	/// @brief GPU bound workload, the frame time is `base + pixel_cost * scale²`
+	/// @details A scale is seen `latency` frames after it is output, like a renderer with frames in flight.
+	/// Noise scales the frame time by a uniform factor in `[1 - noise, 1 + noise]`, from its own generator
+	/// so that copies replay the same trace.
+	///
+	struct Workload
+	{
+		float base;
+		float pixel_cost;
+		float noise = 0.0f;
+		size_t latency = 2;
+
+		std::deque<float> in_flight = {};
+		std::mt19937 noise_generator{generator()};
+
+		float get_frame_time(float scale) const noexcept { return base + pixel_cost * scale * scale; }
+
+		float frame(float scale) noexcept
+		{
+			in_flight.push_back(scale);
+			if (in_flight.size() <= latency) scale = 1.0f;
+			else
+			{
+				in_flight.pop_front();
+				scale = in_flight.front();
+			}
+
+			const float factor = std::uniform_real_distribution(1.0f - noise, 1.0f + noise)(noise_generator);
+			return get_frame_time(scale) * factor;
+		}
+	};
+
+	struct Trace
+	{
+		std::vector<float> frame_times;
+		std::vector<float> scales;
+	};
+
+	// Run frames of a workload, appending to the trace
+	void run(Controller& controller, Workload& workload, size_t frames, Trace& trace) noexcept
+	{
+		for (size_t frame = 0; frame < frames; frame++)
+		{
+			const float frame_time = workload.frame(controller.get_scale());
+			trace.frame_times.push_back(frame_time);
+			trace.scales.push_back(controller.update(frame_time));
+		}
+	}
+
+	// Count output scale changes from a frame on
+	size_t count_changes(const Trace& trace, size_t from) noexcept
+	{
+		size_t changes = 0;
+		for (size_t frame = from + 1; frame < trace.scales.size(); frame++)
+			changes += trace.scales[frame] != trace.scales[frame - 1];
+		return changes;
+	}
+
+	// Get the frame, relative to `from`, after which the output scale stays at its final value
+	size_t get_settle_frames(const Trace& trace, size_t from) noexcept
+	{
+		size_t settled = from;
+		for (size_t frame = from; frame < trace.scales.size(); frame++)
+			if (trace.scales[frame] != trace.scales.back()) settled = frame + 1;
+		return settled - from;
+	}
+
+	float get_min_scale(const Trace& trace, size_t from, size_t to) noexcept
+	{
+		return *std::ranges::min_element(trace.scales.begin() + from, trace.scales.begin() + to);
+	}
+}
+
+int main()
+{
+	const Controller::Config config;
+	const float band_low = config.target_frame_time * (1.0f - config.headroom);
+
+	test::run("Convergence", [&] {
+		// 25 ms at full scale against a 16.7 ms budget
+		Controller controller(config);
+		Workload workload{.base = 3.0f * milliseconds, .pixel_cost = 22.0f * milliseconds};
+		Trace trace;
+		run(controller, workload, 600, trace);
+
+		// Settles inside the band within a second and a half
+		const float scale = trace.scales.back();
+		const float frame_time = workload.get_frame_time(scale);
+		TEST_CHECK(frame_time <= config.target_frame_time && frame_time >= band_low);
+		TEST_CHECK(get_settle_frames(trace, 0) <= 90);
+
+		// Undershoots the settled scale by one step at most
+		TEST_CHECK(scale - get_min_scale(trace, 0, 600) <= config.scale_step + epsilon);
+
+		// Output scales are steps within the bounds
+		for (const float output : trace.scales)
+		{
+			const float steps = output / config.scale_step;
+			TEST_CHECK(std::abs(steps - std::round(steps)) < epsilon);
+			TEST_CHECK(output >= config.min_scale - epsilon && output <= config.max_scale + epsilon);
+		}
+	});
+
+	test::run("Stability", [&] {
+		// Steady load with 5% frame time noise
+		{
+			Controller controller(config);
+			Workload workload{
+				.base = 3.0f * milliseconds,
+				.pixel_cost = 22.0f * milliseconds,
+				.noise = 0.05f
+			};
+			Trace trace;
+			run(controller, workload, 3000, trace);
+			TEST_CHECK(count_changes(trace, 300) == 0);
+		}
+
+		// One step costs more than the band: under it at 0.50, over budget at 0.55
+		for (const float noise : {0.0f, 0.05f})
+		{
+			Controller controller(config);
+			Workload workload{
+				.base = 1.0f * milliseconds,
+				.pixel_cost = 52.3f * milliseconds,
+				.noise = noise
+			};
+			Trace trace;
+			run(controller, workload, 3000, trace);
+			TEST_CHECK(count_changes(trace, 300) == 0);
+			TEST_CHECK(workload.get_frame_time(trace.scales.back()) <= config.target_frame_time);
+		}
+
+		// Loads from 5 to 80 ms at full scale settle without oscillating, and within budget when possible
+		size_t worst_changes = 0;
+		size_t over_budget = 0;
+		for (float cost = 5.0f; cost <= 80.0f; cost += 0.25f)
+		{
+			Controller controller(config);
+			Workload workload{.base = 1.0f * milliseconds, .pixel_cost = cost * milliseconds, .noise = 0.05f};
+			Trace trace;
+			run(controller, workload, 1500, trace);
+
+			const float scale = trace.scales.back();
+			worst_changes = std::max(worst_changes, count_changes(trace, 300));
+			const bool reducible = scale > config.min_scale;
+			over_budget += reducible && workload.get_frame_time(scale) > config.target_frame_time;
+		}
+
+		TEST_CHECK(worst_changes <= 2);
+		TEST_CHECK(over_budget == 0);
+	});
+
+	test::run("Load steps", [&] {
+		// Light scene, stays at full scale
+		Controller controller(config);
+		Workload workload{.base = 3.0f * milliseconds, .pixel_cost = 9.0f * milliseconds};
+		Trace trace;
+		run(controller, workload, 300, trace);
+		TEST_CHECK(trace.scales.back() == config.max_scale && count_changes(trace, 0) == 0);
+
+		// Heavy scene, 33 ms at full scale
+		workload.pixel_cost = 30.0f * milliseconds;
+		run(controller, workload, 600, trace);
+
+		const float heavy_scale = trace.scales.back();
+		TEST_CHECK(heavy_scale < config.max_scale);
+		TEST_CHECK(get_settle_frames(trace, 300) <= 90);
+		TEST_CHECK(heavy_scale - get_min_scale(trace, 300, 900) <= config.scale_step + epsilon);
+
+		const size_t over_budget_frames = std::ranges::count_if(
+			trace.frame_times.begin() + 300,
+			trace.frame_times.end(),
+			[&config](float frame_time) { return frame_time > config.target_frame_time; }
+		);
+		TEST_CHECK(over_budget_frames <= 30);
+
+		// Light again, back to full scale without overshooting above it
+		workload.pixel_cost = 9.0f * milliseconds;
+		run(controller, workload, 300, trace);
+		TEST_CHECK(trace.scales.back() == config.max_scale);
+		TEST_CHECK(get_settle_frames(trace, 900) <= 60);
+		TEST_CHECK(controller.get_stats().raw_scale <= config.max_scale);
+	});
+
+	test::run("Bounds", [&] {
+		// Over budget even at the lowest scale, pinned there without winding up
+		Controller controller(config);
+		Workload workload{.base = 20.0f * milliseconds, .pixel_cost = 20.0f * milliseconds};
+		Trace trace;
+		run(controller, workload, 600, trace);
+		TEST_CHECK(trace.scales.back() == config.min_scale);
+		TEST_CHECK(controller.get_stats().raw_scale == config.min_scale);
+
+		// Recovers as fast as from any other scale
+		workload.base = 2.0f * milliseconds;
+		workload.pixel_cost = 8.0f * milliseconds;
+		run(controller, workload, 200, trace);
+		TEST_CHECK(trace.scales.back() == config.max_scale);
+		TEST_CHECK(get_settle_frames(trace, 600) <= 60);
+
+		// Custom bounds and step
+		Controller::Config narrow = config;
+		narrow.min_scale = 0.7f;
+		narrow.max_scale = 0.9f;
+		narrow.scale_step = 0.1f;
+
+		Controller narrow_controller(narrow);
+		TEST_CHECK(std::abs(narrow_controller.get_scale() - 0.9f) < epsilon);
+
+		Trace narrow_trace;
+		workload.base = 30.0f * milliseconds;
+		run(narrow_controller, workload, 300, narrow_trace);
+		TEST_CHECK(std::abs(narrow_trace.scales.back() - 0.7f) < epsilon);
+	});
+
+	test::run("Rate limits", [&] {
+		// Far over budget, the continuous scale drops by the largest change per frame
+		Controller controller(config);
+		float raw_scale = controller.get_stats().raw_scale;
+		for (int frame = 0; frame < 20; frame++)
+		{
+			controller.update(10.0f * config.target_frame_time);
+			const float change = raw_scale - controller.get_stats().raw_scale;
+			TEST_CHECK(change <= config.max_change + epsilon);
+			TEST_CHECK(change >= config.max_change - epsilon || controller.get_scale() == config.min_scale);
+			raw_scale = controller.get_stats().raw_scale;
+		}
+
+		// Far under budget, the output only steps once the continuous scale is past the hysteresis
+		const float threshold = config.scale_step * (0.5f + config.hysteresis);
+		size_t steps = 0;
+		for (int frame = 0; frame < 200; frame++)
+		{
+			const float scale = controller.get_scale();
+			if (controller.update(0.3f * config.target_frame_time) == scale) continue;
+
+			const float continuous = controller.get_stats().raw_scale;
+			TEST_CHECK(continuous - scale >= threshold - epsilon || continuous == config.max_scale);
+			steps++;
+		}
+
+		TEST_CHECK(controller.get_scale() == config.max_scale && steps > 0);
+	});
+
+	test::run("Determinism", [&] {
+		// Identical traces replay identical scales
+		Controller controller(config);
+		Controller replay(config);
+		Workload workload{.base = 3.0f * milliseconds, .pixel_cost = 22.0f * milliseconds, .noise = 0.1f};
+		Workload replay_workload = workload;
+
+		Trace trace;
+		Trace replay_trace;
+		run(controller, workload, 500, trace);
+		run(replay, replay_workload, 500, replay_trace);
+		TEST_CHECK(trace.scales == replay_trace.scales);
+		TEST_CHECK(controller.get_stats().scale_changes == replay.get_stats().scale_changes);
+
+		// Non-positive frame times are ignored
+		const auto stats = controller.get_stats();
+		TEST_CHECK(controller.update(0.0f) == stats.scale && controller.update(-1.0f) == stats.scale);
+		TEST_CHECK(controller.get_stats().raw_scale == stats.raw_scale);
+
+		// Reset drops the state of a transient and replays from the start
+		for (int frame = 0; frame < 3; frame++) controller.update(3.0f * config.target_frame_time);
+		controller.reset();
+		TEST_CHECK(controller.get_scale() == config.max_scale && controller.get_stats().scale_changes == 0);
+
+		Trace reset_trace;
+		Workload reset_workload{.base = 3.0f * milliseconds, .pixel_cost = 22.0f * milliseconds};
+		Workload fresh_workload = reset_workload;
+		Controller fresh(config);
+		Trace fresh_trace;
+		run(controller, reset_workload, 300, reset_trace);
+		run(fresh, fresh_workload, 300, fresh_trace);
+		TEST_CHECK(reset_trace.scales == fresh_trace.scales);
+	});
+
+	test::run("Scale size", [] {
+		TEST_CHECK((Controller::scale_size({1920, 1080}, 0.75f) == glm::u32vec2(1440, 810)));
+		TEST_CHECK((Controller::scale_size({1001, 3}, 0.5f) == glm::u32vec2(501, 2)));
+		TEST_CHECK((Controller::scale_size({1, 1}, 0.5f) == glm::u32vec2(1, 1)));
+	});
+
+	return test::finish();
+}
@@ -0,0 +1,308 @@
+// Light lists of `graphics::LightCluster` against per-point and per-froxel brute force
+
+#include "graphics/light-cluster.hpp"
+#include "test/check.hpp"
+
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <thread>
+
+namespace
+{
+	std::mt19937 generator{47};
+	std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+
+	// Reversed Z like the renderer's camera
+	glm::mat4 make_projection(float aspect) noexcept
+	{
+		const glm::mat4 reverse_z = glm::mat4(
+			glm::vec4(1, 0, 0, 0),
+			glm::vec4(0, 1, 0, 0),
+			glm::vec4(0, 0, -1, 0),
+			glm::vec4(0, 0, 1, 1)
+		);
+
+		return reverse_z * glm::perspective(0.9f, aspect, 0.1f, 1000.0f);
+	}
+
+	glm::mat4 random_view() noexcept
+	{
+		const glm::vec3 eye = {unit(generator) * 10 - 5, unit(generator) * 4, unit(generator) * 10 - 5};
+		const glm::vec3 target = {unit(generator) * 10 - 5, unit(generator) * 4, unit(generator) * 10 - 5};
+		return glm::lookAt(eye, target, glm::vec3(0, 1, 0));
+	}
+
+	std::vector<graphics::ClusterLight> random_lights(size_t count) noexcept
+	{
+		std::vector<graphics::ClusterLight> lights;
+		for (size_t index = 0; index < count; index++)
+		{
+			const glm::vec3 position = {
+				unit(generator) * 60 - 30,
+				unit(generator) * 10 - 2,
+				unit(generator) * 60 - 30
+			};
+
+			// Some lights reach everywhere
+			const float range =
+				index % 17 == 3 ? std::numeric_limits<float>::infinity() : 0.2f + unit(generator) * 8;
+
+			if (index % 2 == 0)
+			{
+				lights.push_back({
+					.type = graphics::ClusterLight::Type::Point,
+					.position = position,
+					.range = range,
+					.direction = glm::vec3(0.0f),
+					.outer_cone_angle = 0.0f
+				});
+				continue;
+			}
+
+			const glm::vec3 direction = glm::vec3(unit(generator), unit(generator), unit(generator)) - 0.5f;
+			lights.push_back({
+				.type = graphics::ClusterLight::Type::Spot,
+				.position = position,
+				.range = range,
+				.direction = glm::normalize(direction),
+				.outer_cone_angle = unit(generator) * 1.57f
+			});
+		}
+
+		return lights;
+	}
+
+	// Whether a light reaches a world-space point
+	bool light_reaches(const graphics::ClusterLight& light, const glm::vec3& point) noexcept
+	{
+		const glm::vec3 offset = point - light.position;
+		const float distance = glm::length(offset);
+		if (!(distance < light.range)) return false;
+
+		return light.type == graphics::ClusterLight::Type::Point
+			|| glm::dot(offset / distance, light.direction) > std::cos(light.outer_cone_angle);
+	}
+
+	std::span<const uint32_t> get_cluster_lights(const graphics::LightCluster& cluster, size_t index) noexcept
+	{
+		const auto range = cluster.get_ranges()[index];
+		return cluster.get_light_indices().subspan(range.offset, range.count);
+	}
+
+	// View distance range of a depth slice, from the scale and bias mapping
+	std::pair<float, float> get_slice_range(const graphics::LightCluster& cluster, uint32_t slice) noexcept
+	{
+		const auto scale_bias = cluster.get_slice_scale_bias();
+		const float slice_near = slice == 0 ? 0.0f : std::exp((float(slice) - scale_bias.y) / scale_bias.x);
+		const float slice_far = std::exp((float(slice) + 1 - scale_bias.y) / scale_bias.x);
+		return {slice_near, slice_far};
+	}
+}
+
+int main()
+{
+	test::run("LightCluster::create", [] {
+		TEST_CHECK(graphics::LightCluster::create({}).has_value());
+		TEST_CHECK(!graphics::LightCluster::create({.dimension = {0, 9, 24}, .near = 0.1f, .far = 100.0f}));
+		TEST_CHECK(!graphics::LightCluster::create({.dimension = {16, 9, 1}, .near = 0.1f, .far = 100.0f}));
+		TEST_CHECK(!graphics::LightCluster::create({.dimension = {16, 9, 24}, .near = 0.0f, .far = 100.0f}));
+		TEST_CHECK(!graphics::LightCluster::create({.dimension = {16, 9, 24}, .near = 10.0f, .far = 5.0f}));
+	});
+
+	test::run("Lights reach their clusters", [] {
+		for (int trial = 0; trial < 30; trial++)
+		{
+			const graphics::LightCluster::Config config = {
+				.dimension = {4 + generator() % 16, 3 + generator() % 10, 2 + generator() % 24},
+				.near = 0.1f + unit(generator),
+				.far = 20 + 60 * unit(generator)
+			};
+			auto cluster = graphics::LightCluster::create(config);
+			if (!TEST_CHECK(cluster.has_value())) continue;
+
+			const auto view = random_view();
+			const auto projection = make_projection(1.3f + unit(generator));
+			const auto lights = random_lights(1 + generator() % 300);
+			cluster->build(view, projection, lights);
+
+			const auto cluster_count = size_t(config.dimension.x) * config.dimension.y * config.dimension.z;
+			if (!TEST_CHECK(cluster->get_ranges().size() == cluster_count)) continue;
+
+			// Ascending light indices in every list
+			for (size_t index = 0; index < cluster_count; index++)
+			{
+				const auto list = get_cluster_lights(*cluster, index);
+				TEST_CHECK(std::ranges::adjacent_find(list, std::greater_equal()) == list.end());
+				TEST_CHECK(list.empty() || list.back() < lights.size());
+			}
+
+			// Every light reaching a point in the frustum is listed by the point's cluster
+			const auto inverse_view = glm::inverse(view);
+			const auto scale_bias = cluster->get_slice_scale_bias();
+			for (int sample = 0; sample < 3000; sample++)
+			{
+				const glm::vec2 ndc = {unit(generator) * 2 - 1, unit(generator) * 2 - 1};
+				const float distance = config.far * unit(generator) * unit(generator) * 0.999f + 1e-3f;
+
+				const glm::vec3 view_point = {
+					distance * ndc.x / projection[0][0],
+					distance * ndc.y / projection[1][1],
+					-distance
+				};
+				const glm::vec3 world_point = glm::vec3(inverse_view * glm::vec4(view_point, 1.0f));
+
+				// Row 0 at the top of the screen
+				const auto column =
+					std::min(uint32_t((ndc.x + 1) / 2 * float(config.dimension.x)), config.dimension.x - 1);
+				const auto row =
+					std::min(uint32_t((1 - ndc.y) / 2 * float(config.dimension.y)), config.dimension.y - 1);
+				const auto slice =
+					uint32_t(std::max(0.0f, std::floor(std::log(distance) * scale_bias.x + scale_bias.y)));
+				if (!TEST_CHECK(slice < config.dimension.z)) continue;
+
+				const auto list = get_cluster_lights(
+					*cluster,
+					(size_t(slice) * config.dimension.y + row) * config.dimension.x + column
+				);
+
+				for (const auto [light_index, light] : lights | std::views::enumerate)
+					if (light_reaches(light, world_point))
+						TEST_CHECK(std::ranges::binary_search(list, uint32_t(light_index)));
+			}
+		}
+	});
+
+	test::run("Lists are close to froxel bounds", [] {
+		const graphics::LightCluster::Config config = {.dimension = {16, 9, 24}, .near = 0.1f, .far = 100.0f};
+		auto cluster = *graphics::LightCluster::create(config);
+
+		// Finite point lights only, against the view-space bounding box of every froxel
+		std::vector<graphics::ClusterLight> lights;
+		for (int index = 0; index < 400; index++)
+			lights.push_back({
+				.type = graphics::ClusterLight::Type::Point,
+				.position = {unit(generator) * 80 - 40, unit(generator) * 20 - 10, -unit(generator) * 110},
+				.range = 0.5f + unit(generator) * 6,
+				.direction = glm::vec3(0.0f),
+				.outer_cone_angle = 0.0f
+			});
+
+		const auto projection = make_projection(16.0f / 9.0f);
+		cluster.build(glm::mat4(1.0f), projection, lights);
+
+		size_t listed = 0, brute_force = 0;
+		for (uint32_t slice = 0; slice < config.dimension.z; slice++)
+		{
+			const auto [slice_near, slice_far] = get_slice_range(cluster, slice);
+
+			for (uint32_t row = 0; row < config.dimension.y; row++)
+				for (uint32_t column = 0; column < config.dimension.x; column++)
+				{
+					const glm::vec2 ndc_min = {
+						float(column) / float(config.dimension.x) * 2 - 1,
+						1 - float(row + 1) / float(config.dimension.y) * 2
+					};
+					const glm::vec2 ndc_max = {
+						float(column + 1) / float(config.dimension.x) * 2 - 1,
+						1 - float(row) / float(config.dimension.y) * 2
+					};
+					const glm::vec2 slope_min = ndc_min / glm::vec2(projection[0][0], projection[1][1]);
+					const glm::vec2 slope_max = ndc_max / glm::vec2(projection[0][0], projection[1][1]);
+
+					const glm::vec3 box_min = {
+						glm::min(slope_min * slice_near, slope_min * slice_far),
+						-slice_far
+					};
+					const glm::vec3 box_max = {
+						glm::max(slope_max * slice_near, slope_max * slice_far),
+						-slice_near
+					};
+
+					const auto list = get_cluster_lights(
+						cluster,
+						(size_t(slice) * config.dimension.y + row) * config.dimension.x + column
+					);
+					listed += list.size();
+
+					for (const auto [light_index, light] : lights | std::views::enumerate)
+					{
+						const glm::vec3 closest = glm::clamp(light.position, box_min, box_max);
+						if (glm::length(closest - light.position) >= light.range) continue;
+						brute_force++;
+
+						// Lights centered in the froxel are always listed
+						const float distance = -light.position.z;
+						const glm::vec2 slope = glm::vec2(light.position) / distance;
+						const bool centered = distance > slice_near && distance < slice_far
+										   && glm::all(glm::greaterThan(slope, slope_min))
+										   && glm::all(glm::lessThan(slope, slope_max));
+						if (centered) TEST_CHECK(std::ranges::binary_search(list, uint32_t(light_index)));
+					}
+				}
+		}
+
+		// Conservative, but not far beyond the froxel boxes
+		TEST_CHECK(listed > brute_force / 2 && listed <= brute_force * 5 / 4);
+	});
+
+	test::run("Infinite range", [] {
+		auto cluster = *graphics::LightCluster::create({});
+		const std::array lights = {
+			graphics::ClusterLight{
+				.type = graphics::ClusterLight::Type::Point,
+				.position = {0, 0, 5},
+				.range = std::numeric_limits<float>::infinity(),
+				.direction = glm::vec3(0.0f),
+				.outer_cone_angle = 0.0f
+			},
+			graphics::ClusterLight{
+				.type = graphics::ClusterLight::Type::Point,
+				.position = {0, 0, 500},
+				.range = 1,
+				.direction = glm::vec3(0.0f),
+				.outer_cone_angle = 0.0f
+			}
+		};
+
+		cluster.build(glm::mat4(1.0f), make_projection(16.0f / 9.0f), lights);
+		for (size_t index = 0; index < cluster.get_ranges().size(); index++)
+		{
+			const auto list = get_cluster_lights(cluster, index);
+			TEST_CHECK(list.size() == 1 && list[0] == 0);
+		}
+	});
+
+	test::run("Threaded build", [] {
+		const graphics::LightCluster::Config config = {.dimension = {12, 7, 16}, .near = 0.2f, .far = 60.0f};
+		auto serial = *graphics::LightCluster::create(config);
+		auto threaded = *graphics::LightCluster::create(config);
+
+		for (int frame = 0; frame < 4; frame++)
+		{
+			const auto view = random_view();
+			const auto projection = make_projection(1.5f);
+			const auto lights = random_lights(100 + generator() % 400);
+
+			serial.build(view, projection, lights);
+
+			// Slices on separate threads, started in reverse order
+			threaded.begin(view, projection, lights);
+			{
+				std::vector<std::jthread> threads;
+				for (uint32_t slice = config.dimension.z; slice-- > 0;)
+					threads.emplace_back([&threaded, slice] { threaded.build_slice(slice); });
+			}
+			threaded.finish();
+
+			if (!TEST_CHECK(serial.get_ranges().size() == threaded.get_ranges().size())) continue;
+			for (size_t index = 0; index < serial.get_ranges().size(); index++)
+				TEST_CHECK(std::ranges::equal(
+					get_cluster_lights(serial, index),
+					get_cluster_lights(threaded, index)
+				));
+		}
+	});
+
+	return test::finish();
+}
@@ -0,0 +1,218 @@
+// Occlusion of boxes behind analytic occluders in `graphics::OcclusionBuffer`
+
+#include "graphics/occlusion.hpp"
+#include "test/check.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <thread>
+
+namespace
+{
+	constexpr glm::u32vec2 resolution = {320, 192};
+	constexpr float fov_y = glm::radians(60.0f);
+	constexpr float aspect = float(resolution.x) / float(resolution.y);
+
+	// Camera at the origin looking towards -Z, with reversed Z
+	const glm::mat4 view_projection =
+		glm::mat4(glm::vec4(1, 0, 0, 0), glm::vec4(0, 1, 0, 0), glm::vec4(0, 0, -1, 0), glm::vec4(0, 0, 1, 1))
+		* glm::perspective(fov_y, aspect, 0.1f, 500.0f);
+
+	// Square of half-size `half_size` facing the camera, at distance `distance`
+	graphics::OccluderMesh make_wall(float half_size, float distance) noexcept
+	{
+		return {
+			.vertices = {
+				{-half_size, -half_size, -distance},
+				{half_size,  -half_size, -distance},
+				{half_size,  half_size,  -distance},
+				{-half_size, half_size,  -distance}
+			},
+			.indices = {0, 1, 2, 0, 2, 3}
+		};
+	}
+
+	graphics::OcclusionBuffer make_buffer(const graphics::OccluderMesh& mesh) noexcept
+	{
+		graphics::OcclusionBuffer buffer(resolution);
+		buffer.begin(view_projection);
+		buffer.add_occluder(mesh, glm::mat4(1.0f));
+		buffer.rasterize(0, buffer.get_tile_rows());
+		return buffer;
+	}
+
+	// Whether every corner of a box projects inside the wall, grown by `margin` on the wall plane
+	bool hidden_by_wall(
+		const glm::vec3& box_min,
+		const glm::vec3& box_max,
+		float half_size,
+		float distance,
+		float margin
+	) noexcept
+	{
+		for (uint32_t corner = 0; corner < 8; corner++)
+		{
+			const glm::vec3 point = {
+				(corner & 1) != 0 ? box_max.x : box_min.x,
+				(corner & 2) != 0 ? box_max.y : box_min.y,
+				(corner & 4) != 0 ? box_max.z : box_min.z
+			};
+
+			if (point.z > -distance) return false;
+
+			const glm::vec2 projected = glm::vec2(point) * distance / -point.z;
+			if (glm::any(glm::greaterThan(glm::abs(projected), glm::vec2(half_size + margin)))) return false;
+		}
+
+		return true;
+	}
+}
+
+int main()
+{
+	const float wall_size = 3.0f;
+	const float wall_distance = 10.0f;
+	const auto wall = make_wall(wall_size, wall_distance);
+
+	test::run("Box behind a wall", [&] {
+		const auto buffer = make_buffer(wall);
+		TEST_CHECK(buffer.get_triangle_count() == 2);
+
+		// Hidden: entirely behind the wall, including one near its edge
+		TEST_CHECK(!buffer.test_box({-0.5f, -0.5f, -20.0f}, {0.5f, 0.5f, -19.0f}));
+		TEST_CHECK(!buffer.test_box({2.0f, -0.5f, -12.0f}, {2.8f, 0.5f, -11.0f}));
+
+		// Visible: in front, crossing the wall, partially outside its silhouette, or behind the camera
+		TEST_CHECK(buffer.test_box({-0.5f, -0.5f, -6.0f}, {0.5f, 0.5f, -5.0f}));
+		TEST_CHECK(buffer.test_box({-0.5f, -0.5f, -11.0f}, {0.5f, 0.5f, -9.0f}));
+		TEST_CHECK(buffer.test_box({-0.5f, -0.5f, -20.0f}, {10.0f, 0.5f, -19.0f}));
+		TEST_CHECK(buffer.test_box({-1.0f, -1.0f, 1.0f}, {1.0f, 1.0f, 2.0f}));
+		TEST_CHECK(buffer.test_box({-1.0f, -1.0f, -20.0f}, {1.0f, 1.0f, 2.0f}));
+	});
+
+	test::run("Random boxes behind a wall", [&] {
+		const auto buffer = make_buffer(wall);
+
+		// A pixel on the wall plane, silhouettes are exact to half a pixel
+		const float pixel_size = 2.0f * wall_distance * std::tan(fov_y * 0.5f) / float(resolution.y);
+
+		std::mt19937 generator{23};
+		std::uniform_real_distribution<float> lateral{-8.0f, 8.0f};
+		std::uniform_real_distribution<float> depth{-40.0f, -10.5f};
+		std::uniform_real_distribution<float> extent{0.05f, 1.5f};
+
+		size_t culled = 0, analytic_hidden = 0;
+		for (int box = 0; box < 20000; box++)
+		{
+			const glm::vec3 center = {lateral(generator), lateral(generator), depth(generator)};
+			const glm::vec3 box_min = center - extent(generator);
+			const glm::vec3 box_max = center + extent(generator);
+
+			const bool visible = buffer.test_box(box_min, box_max);
+			const bool hidden = hidden_by_wall(box_min, box_max, wall_size, wall_distance, pixel_size);
+			const bool well_hidden = hidden_by_wall(box_min, box_max, wall_size, wall_distance, -pixel_size);
+
+			// Culled boxes are hidden, up to half a pixel on the silhouette
+			if (!visible) TEST_CHECK(hidden);
+
+			culled += visible ? 0 : 1;
+			analytic_hidden += well_hidden ? 1 : 0;
+		}
+
+		// Most boxes well inside the silhouette are culled
+		TEST_CHECK(culled > analytic_hidden * 9 / 10 && analytic_hidden > 100);
+	});
+
+	test::run("Sloped occluder", [] {
+		// Floor going away from the camera, boxes resting on top of it are never hidden by it
+		const graphics::OccluderMesh floor = {
+			.vertices = {{-50, -1, -1}, {50, -1, -1}, {50, -1, -100}, {-50, -1, -100}},
+			.indices = {0, 1, 2, 0, 2, 3}
+		};
+		const auto buffer = make_buffer(floor);
+
+		std::mt19937 generator{29};
+		std::uniform_real_distribution<float> lateral{-8.0f, 8.0f};
+		std::uniform_real_distribution<float> depth{-60.0f, -2.0f};
+		std::uniform_real_distribution<float> height{0.0f, 0.5f};
+
+		for (int box = 0; box < 20000; box++)
+		{
+			const glm::vec3 center = {lateral(generator), 0.0f, depth(generator)};
+			const glm::vec3 box_min = {center.x - 0.1f, -0.99f, center.z - 0.1f};
+			TEST_CHECK(buffer.test_box(box_min, center + height(generator)));
+		}
+
+		// Boxes below the floor are hidden
+		TEST_CHECK(!buffer.test_box({-1.0f, -5.0f, -30.0f}, {1.0f, -4.0f, -28.0f}));
+	});
+
+	test::run("Occluder crossing the near plane", [] {
+		// Triangles reaching behind the camera are dropped, nothing is culled
+		const graphics::OccluderMesh crossing = {
+			.vertices = {{-5, -5, 1}, {5, -5, 1}, {0, 5, -20}},
+			.indices = {0, 1, 2}
+		};
+		const auto buffer = make_buffer(crossing);
+
+		TEST_CHECK(buffer.get_triangle_count() == 0);
+		TEST_CHECK(buffer.test_box({-0.1f, -0.1f, -100.0f}, {0.1f, 0.1f, -99.0f}));
+	});
+
+	test::run("Banded rasterization", [&] {
+		// Several walls at different depths and offsets
+		std::vector<std::pair<graphics::OccluderMesh, glm::mat4>> occluders;
+		for (int index = 0; index < 12; index++)
+		{
+			const glm::vec3 offset = {float(index % 4) * 4.0f - 6.0f, float(index / 4) * 3.0f - 3.0f, 0.0f};
+			occluders.emplace_back(
+				make_wall(1.5f + float(index % 3), 8.0f + float(index)),
+				glm::rotate(glm::translate(glm::mat4(1.0f), offset), float(index) * 0.2f, glm::vec3(0, 1, 0))
+			);
+		}
+
+		graphics::OcclusionBuffer whole(resolution), banded(resolution);
+		whole.begin(view_projection);
+		banded.begin(view_projection);
+		for (const auto& [mesh, transform] : occluders)
+		{
+			whole.add_occluder(mesh, transform);
+			banded.add_occluder(mesh, transform);
+		}
+
+		whole.rasterize(0, whole.get_tile_rows());
+
+		// Bands of 3 tile rows on separate threads, the last one clamped
+		{
+			std::vector<std::jthread> threads;
+			for (uint32_t row = 0; row < banded.get_tile_rows(); row += 3)
+				threads.emplace_back([&banded, row] { banded.rasterize(row, row + 3); });
+		}
+
+		std::mt19937 generator{31};
+		std::uniform_real_distribution<float> lateral{-15.0f, 15.0f};
+		std::uniform_real_distribution<float> depth{-60.0f, -5.0f};
+		std::uniform_real_distribution<float> extent{0.1f, 2.0f};
+
+		size_t culled = 0;
+		for (int box = 0; box < 20000; box++)
+		{
+			const glm::vec3 center = {lateral(generator), lateral(generator) * 0.5f, depth(generator)};
+			const float half_size = extent(generator);
+
+			const bool visible = whole.test_box(center - half_size, center + half_size);
+			TEST_CHECK(visible == banded.test_box(center - half_size, center + half_size));
+			culled += visible ? 0 : 1;
+		}
+
+		TEST_CHECK(culled > 0);
+
+		// A new frame drops the occluders
+		whole.begin(view_projection);
+		whole.rasterize(0, whole.get_tile_rows());
+		TEST_CHECK(whole.get_triangle_count() == 0);
+		TEST_CHECK(whole.test_box({-0.1f, -0.1f, -50.0f}, {0.1f, 0.1f, -49.0f}));
+	});
+
+	return test::finish();
+}
@@ -0,0 +1,283 @@
+// Polygon clipping, portal frusta and cell visibility of `graphics::PortalGraph`
+
+#include "graphics/portal.hpp"
+#include "test/check.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+namespace
+{
+	// Reversed Z like the renderer's camera
+	glm::mat4 make_view_projection(const glm::vec3& eye, const glm::vec3& direction) noexcept
+	{
+		const glm::mat4 reverse_z = glm::mat4(
+			glm::vec4(1, 0, 0, 0),
+			glm::vec4(0, 1, 0, 0),
+			glm::vec4(0, 0, -1, 0),
+			glm::vec4(0, 0, 1, 1)
+		);
+
+		return reverse_z
+			 * glm::perspective(1.2f, 1.0f, 0.1f, 100.0f)
+			 * glm::lookAt(eye, eye + direction, glm::vec3(0.0f, 1.0f, 0.0f));
+	}
+
+	float polygon_area(std::span<const glm::vec3> polygon) noexcept
+	{
+		glm::vec3 sum(0.0f);
+		for (size_t index = 1; index + 1 < polygon.size(); index++)
+			sum += glm::cross(polygon[index] - polygon[0], polygon[index + 1] - polygon[0]);
+		return glm::length(sum) * 0.5f;
+	}
+
+	bool inside_planes(std::span<const glm::vec4> planes, const glm::vec3& point) noexcept
+	{
+		return std::ranges::all_of(planes, [&point](const glm::vec4& plane) {
+			return glm::dot(glm::vec3(plane), point) + plane.w >= -1e-4f;
+		});
+	}
+
+	// Doorway in the plane `x = wall_x`, 2 high and spanning z in [4, 6]
+	std::array<glm::vec3, 4> make_door(float wall_x) noexcept
+	{
+		return {
+			glm::vec3(wall_x, 0, 4),
+			glm::vec3(wall_x, 0, 6),
+			glm::vec3(wall_x, 2, 6),
+			glm::vec3(wall_x, 2, 4)
+		};
+	}
+
+	// Three rooms in a row along X, 10 wide each, joined by doorways at x = 10 and x = 20
+	graphics::PortalGraph make_rooms() noexcept
+	{
+		return *graphics::PortalGraph::create(
+			{
+				{.bounds = graphics::Aabb{.min = {0, 0, 0}, .max = {10, 3, 10}}},
+				{.bounds = graphics::Aabb{.min = {10, 0, 0}, .max = {20, 3, 10}}},
+				{.bounds = graphics::Aabb{.min = {20, 0, 0}, .max = {30, 3, 10}}}
+			},
+			{
+				{.corners = make_door(10), .cells = {0, 1}},
+				{.corners = make_door(20), .cells = {1, 2}}
+			}
+		);
+	}
+}
+
+int main()
+{
+	test::run("clip_polygon", [] {
+		const std::array<glm::vec3, 4> square = {
+			glm::vec3(0, 0, 0),
+			glm::vec3(2, 0, 0),
+			glm::vec3(2, 2, 0),
+			glm::vec3(0, 2, 0)
+		};
+
+		// Half-space `x <= 1` keeps half of the square
+		const std::array half_plane = {glm::vec4(-1, 0, 0, 1)};
+		const auto half = graphics::clip_polygon(square, half_plane);
+		TEST_CHECK(half.size() == 4);
+		TEST_CHECK(std::abs(polygon_area(half) - 2.0f) < 1e-4f);
+		TEST_CHECK(std::ranges::all_of(half, [](const glm::vec3& vertex) {
+			return vertex.x <= 1.0f + 1e-5f;
+		}));
+
+		// Cutting a corner adds a vertex
+		const std::array corner_plane = {glm::normalize(glm::vec4(-1, -1, 0, 3))};
+		const auto cut = graphics::clip_polygon(square, corner_plane);
+		TEST_CHECK(cut.size() == 5);
+		TEST_CHECK(std::abs(polygon_area(cut) - 3.5f) < 1e-4f);
+
+		// Entirely inside, or entirely outside
+		const std::array keep_plane = {glm::vec4(1, 0, 0, 5)};
+		TEST_CHECK(graphics::clip_polygon(square, keep_plane).size() == 4);
+
+		const std::array drop_plane = {glm::vec4(1, 0, 0, -5)};
+		TEST_CHECK(graphics::clip_polygon(square, drop_plane).size() < 3);
+	});
+
+	test::run("compute_portal_planes", [] {
+		const glm::vec3 eye = {5, 1, 5};
+		const auto door = make_door(10);
+		const auto planes = graphics::compute_portal_planes(eye, door);
+		if (!TEST_CHECK(planes.size() == 4)) return;
+
+		// Points seen through the doorway are inside, points beside it are not
+		const glm::vec3 door_center = {10, 1, 5};
+		TEST_CHECK(inside_planes(planes, eye + (door_center - eye) * 2.0f));
+		TEST_CHECK(inside_planes(planes, eye + (glm::vec3(10, 0.1f, 4.1f) - eye) * 3.0f));
+		TEST_CHECK(!inside_planes(planes, eye + (glm::vec3(10, 1, 7) - eye) * 2.0f));
+		TEST_CHECK(!inside_planes(planes, eye + (glm::vec3(10, 2.5f, 5) - eye) * 2.0f));
+
+		// Every door corner lies on the boundary
+		for (const auto& corner : door) TEST_CHECK(inside_planes(planes, corner));
+	});
+
+	test::run("PortalGraph::create", [] {
+		using graphics::PortalGraph;
+
+		const PortalGraph::Cell room = {.bounds = graphics::Aabb{.min = {0, 0, 0}, .max = {1, 1, 1}}};
+		const PortalGraph::Cell outside = {.bounds = std::nullopt};
+
+		TEST_CHECK(PortalGraph::create({room, outside}, {{.corners = {}, .cells = {0, 1}}}).has_value());
+
+		// Missing cell, portal to itself, several unbounded cells
+		TEST_CHECK(!PortalGraph::create({room, outside}, {{.corners = {}, .cells = {0, 2}}}));
+		TEST_CHECK(!PortalGraph::create({room, outside}, {{.corners = {}, .cells = {1, 1}}}));
+		TEST_CHECK(!PortalGraph::create({room, outside, outside}, {}));
+	});
+
+	test::run("Rooms in a row", [] {
+		const auto graph = make_rooms();
+		const glm::vec3 eye = {5, 1.5f, 5};
+		const auto forward = make_view_projection(eye, {1, 0, 0});
+		const std::array<uint8_t, 2> all_open = {1, 1};
+
+		// Looking down the doorways, a box aligned with them is visible, one in a corner is not
+		const auto visibility = graph.compute_visibility(eye, forward, all_open);
+		TEST_CHECK(!visibility.unrestricted);
+		TEST_CHECK(visibility.is_cell_visible(0) && visibility.is_cell_visible(1));
+		TEST_CHECK(visibility.is_cell_visible(2));
+		TEST_CHECK(visibility.test_box({25, 0.5f, 4.8f}, {25.5f, 1, 5.2f}));
+		TEST_CHECK(!visibility.test_box({25, 0.5f, 0.2f}, {25.5f, 1, 0.6f}));
+
+		// A closed door hides the last room
+		const std::array<uint8_t, 2> second_closed = {1, 0};
+		const auto closed = graph.compute_visibility(eye, forward, second_closed);
+		TEST_CHECK(closed.is_cell_visible(1) && !closed.is_cell_visible(2));
+		TEST_CHECK(!closed.test_box({25, 0.5f, 4.8f}, {25.5f, 1, 5.2f}));
+
+		// Missing entries count as open
+		const auto missing = graph.compute_visibility(eye, forward, {});
+		TEST_CHECK(missing.is_cell_visible(2));
+
+		// Looking away from the doorways
+		const auto away = graph.compute_visibility(eye, make_view_projection(eye, {-1, 0, 0}), all_open);
+		TEST_CHECK(away.is_cell_visible(0) && !away.is_cell_visible(1));
+
+		// Standing in a doorway, both rooms hold the eye
+		const glm::vec3 doorway = {10.02f, 1, 5};
+		const auto through =
+			graph.compute_visibility(doorway, make_view_projection(doorway, {1, 0, 0}), all_open);
+		TEST_CHECK(through.is_cell_visible(1) && through.is_cell_visible(2));
+
+		// Outside every cell, with no outside cell, visibility is unknown
+		const glm::vec3 outside = {50, 1, 5};
+		const auto unknown =
+			graph.compute_visibility(outside, make_view_projection(outside, {-1, 0, 0}), all_open);
+		TEST_CHECK(unknown.unrestricted);
+		TEST_CHECK(unknown.test_box({25, 0.5f, 0.2f}, {25.5f, 1, 0.6f}));
+
+		// Too many views make the visibility unrestricted
+		const auto limited = graph.compute_visibility(
+			eye,
+			forward,
+			all_open,
+			{.max_depth = 8, .max_views = 1, .eye_margin = 0.05f}
+		);
+		TEST_CHECK(limited.unrestricted);
+	});
+
+	test::run("Culled boxes are hidden", [] {
+		const auto graph = make_rooms();
+		const std::array<uint8_t, 2> all_open = {1, 1};
+
+		std::mt19937 generator{41};
+		std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+
+		size_t culled = 0;
+		for (int view = 0; view < 200; view++)
+		{
+			const glm::vec3 eye = {
+				0.5f + 9 * unit(generator),
+				0.2f + 2.6f * unit(generator),
+				0.5f + 9 * unit(generator)
+			};
+			const float angle = (unit(generator) - 0.5f) * 2.5f;
+			const glm::vec3 direction = {std::cos(angle), (unit(generator) - 0.5f) * 0.5f, std::sin(angle)};
+
+			const auto view_projection = make_view_projection(eye, direction);
+			const auto visibility = graph.compute_visibility(eye, view_projection, all_open);
+
+			for (int box = 0; box < 100; box++)
+			{
+				const glm::vec3 center = {
+					10.5f + 19 * unit(generator),
+					0.3f + 2.4f * unit(generator),
+					0.3f + 9.4f * unit(generator)
+				};
+				const float half_size = 0.05f + 0.4f * unit(generator);
+				const glm::vec3 box_min = center - half_size, box_max = center + half_size;
+
+				if (visibility.test_box(box_min, box_max)) continue;
+				culled++;
+
+				// No sampled point of a culled box is in the camera frustum and seen through the doorways
+				for (int sample = 0; sample < 200; sample++)
+				{
+					const glm::vec3 point = glm::mix(
+						box_min,
+						box_max,
+						glm::vec3(unit(generator), unit(generator), unit(generator))
+					);
+
+					const glm::vec4 clip = view_projection * glm::vec4(point, 1.0f);
+					if (clip.w <= 0 || std::abs(clip.x) > clip.w || std::abs(clip.y) > clip.w) continue;
+
+					bool through_doors = true;
+					for (const float wall_x : {10.0f, 20.0f})
+					{
+						if (point.x <= wall_x) continue;
+
+						const float t = (wall_x - eye.x) / (point.x - eye.x);
+						const glm::vec3 crossing = eye + (point - eye) * t;
+						through_doors &=
+							crossing.y >= 0 && crossing.y <= 2 && crossing.z >= 4 && crossing.z <= 6;
+					}
+
+					if (!TEST_CHECK(!through_doors)) break;
+				}
+			}
+		}
+
+		TEST_CHECK(culled > 1000);
+	});
+
+	test::run("Outside cell", [] {
+		// One room with a window on its +X wall, everything else is the outside cell
+		const std::array<glm::vec3, 4> window = {
+			glm::vec3(10, 1, 4),
+			glm::vec3(10, 1, 6),
+			glm::vec3(10, 2, 6),
+			glm::vec3(10, 2, 4)
+		};
+		const auto graph = *graphics::PortalGraph::create(
+			{
+				{.bounds = graphics::Aabb{.min = {0, 0, 0}, .max = {10, 3, 10}}},
+				{.bounds = std::nullopt}
+			},
+			{{.corners = window, .cells = {0, 1}}}
+		);
+
+		const glm::vec3 eye = {5, 1.5f, 5};
+		const auto visibility = graph.compute_visibility(eye, make_view_projection(eye, {1, 0, 0}), {});
+		TEST_CHECK(visibility.has_outside_cell && visibility.is_cell_visible(1));
+
+		// Outside boxes are only seen through the window
+		TEST_CHECK(visibility.test_box({20, 1.4f, 4.9f}, {21, 1.6f, 5.1f}));
+		TEST_CHECK(!visibility.test_box({20, 8.0f, 4.9f}, {21, 9.0f, 5.1f}));
+
+		// From outside, the room is seen through the window only
+		const glm::vec3 outside_eye = {20, 1.5f, 5};
+		const auto from_outside =
+			graph.compute_visibility(outside_eye, make_view_projection(outside_eye, {-1, 0, 0}), {});
+		TEST_CHECK(!from_outside.unrestricted && from_outside.is_cell_visible(0));
+		TEST_CHECK(from_outside.test_box({4, 1.4f, 4.9f}, {5, 1.6f, 5.1f}));
+		TEST_CHECK(!from_outside.test_box({4, 0.1f, 0.1f}, {5, 0.3f, 0.3f}));
+	});
+
+	return test::finish();
+}
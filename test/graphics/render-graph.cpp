@@ -0,0 +1,792 @@
+// Ordering, culling, lifetimes and aliasing of `graphics::RenderGraph` on hand-built and random frames
+
+#include "graphics/util/render-graph.hpp"
+#include "test/check.hpp"
+
+#include <algorithm>
+#include <format>
+#include <map>
+#include <memory>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{79};
+
+	using RenderGraph = graphics::RenderGraph;
+	using Handle = RenderGraph::Handle;
+
+	RenderGraph::BufferDesc buffer(uint32_t size) noexcept
+	{
+		return {.usage = {.compute_storage_read = true, .compute_storage_write = true}, .size = size};
+	}
+
+	/* Frame of the renderer */
+
+	// Formats of the render targets, see `render::target`
+	const gpu::Texture::Format depth_format = {
+		.type = SDL_GPU_TEXTURETYPE_2D,
+		.format = SDL_GPU_TEXTUREFORMAT_D32_FLOAT_S8_UINT,
+		.usage = {.sampler = true, .depth_stencil_target = true}
+	};
+
+	const gpu::Texture::Format albedo_format = {
+		.type = SDL_GPU_TEXTURETYPE_2D,
+		.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB,
+		.usage = {.sampler = true, .color_target = true}
+	};
+
+	const gpu::Texture::Format lighting_info_format = {
+		.type = SDL_GPU_TEXTURETYPE_2D,
+		.format = SDL_GPU_TEXTUREFORMAT_R32G32_UINT,
+		.usage = {.sampler = true, .color_target = true}
+	};
+
+	const gpu::Texture::Format radiance_format = {
+		.type = SDL_GPU_TEXTURETYPE_2D,
+		.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT,
+		.usage = {.sampler = true, .compute_storage_read = true, .compute_storage_write = true}
+	};
+
+	const gpu::Texture::Format bloom_format = {
+		.type = SDL_GPU_TEXTURETYPE_2D,
+		.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT,
+		.usage = {
+			.sampler = true,
+			.color_target = true,
+			.compute_storage_read = true,
+			.compute_storage_write = true
+		}
+	};
+
+	const gpu::Texture::Format composite_format = {
+		.type = SDL_GPU_TEXTURETYPE_2D,
+		.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+		.usage = {.sampler = true, .color_target = true}
+	};
+
+	constexpr uint32_t bloom_mip_count = 9;
+
+	struct RendererFrame
+	{
+		RenderGraph graph;
+		Handle ssgi_diffuse, ssgi_radiance, composite;
+		std::vector<Handle> bloom_downsample, bloom_upsample;
+	};
+
+	// Passes and transient targets declared like `render::Renderer::build_frame_graph`
+	RendererFrame make_renderer_frame(glm::u32vec2 size, bool ssgi) noexcept
+	{
+		RendererFrame frame;
+		auto& graph = frame.graph;
+
+		const RenderGraph::TextureDesc history_desc = {.format = radiance_format, .size = size};
+		auto depth_value = graph.import_texture("Depth Value", history_desc, false);
+		auto light_buffer = graph.import_texture("Light Buffer", history_desc, false);
+		auto ao = graph.import_texture("AO", history_desc, false);
+		auto ssgi_history = graph.import_texture("SSGI Reservoirs", history_desc, false);
+		auto exposure = graph.import_buffer("Exposure", buffer(8), false);
+		auto swapchain = graph.import_texture("Swapchain", {.format = composite_format, .size = size}, true);
+		auto shadow_map =
+			graph.import_texture("Shadow Map", {.format = depth_format, .size = {1024, 1024}}, false);
+
+		const auto half_size = (size + 1u) / 2u;
+
+		auto depth = graph.create_texture("Depth", {.format = depth_format, .size = size});
+		auto albedo = graph.create_texture("Albedo", {.format = albedo_format, .size = size});
+		auto lighting_info =
+			graph.create_texture("Lighting Info", {.format = lighting_info_format, .size = size});
+		auto ssgi_diffuse = frame.ssgi_diffuse =
+			graph.create_texture("SSGI Blurred Diffuse", {.format = radiance_format, .size = half_size});
+		auto ssgi_radiance = frame.ssgi_radiance =
+			graph.create_texture("SSGI Radiance", {.format = radiance_format, .size = size});
+		auto bloom_filter = graph.create_texture(
+			"Bloom Filter",
+			{.format = bloom_format, .size = size, .mip_levels = bloom_mip_count}
+		);
+		auto composite = frame.composite =
+			graph.create_texture("Composite", {.format = composite_format, .size = size});
+
+		auto mip_size = size / 2u;
+		for (uint32_t mip = 0; mip < bloom_mip_count; mip++)
+		{
+			const RenderGraph::TextureDesc desc = {.format = bloom_format, .size = mip_size};
+			const auto downsample = graph.create_texture(std::format("Bloom Downsample {}", mip), desc);
+			frame.bloom_downsample.push_back(downsample);
+
+			if (mip + 1 < bloom_mip_count)
+			{
+				const auto upsample = graph.create_texture(std::format("Bloom Upsample {}", mip), desc);
+				frame.bloom_upsample.push_back(upsample);
+			}
+
+			mip_size /= 2u;
+		}
+
+		auto bloom_downsample = frame.bloom_downsample;
+		auto bloom_upsample = frame.bloom_upsample;
+
+		{
+			auto pass = graph.add_pass("G-buffer");
+			depth = pass.write(depth);
+			albedo = pass.write(albedo);
+			lighting_info = pass.write(lighting_info);
+			depth_value = pass.write(depth_value);
+			light_buffer = pass.write(light_buffer);
+		}
+
+		{
+			auto pass = graph.add_pass("Hi-Z");
+			depth_value = pass.write(depth_value);
+		}
+
+		{
+			auto pass = graph.add_pass("Shadow");
+			shadow_map = pass.write(shadow_map);
+		}
+
+		{
+			auto pass = graph.add_pass("AO");
+			pass.read(depth_value);
+			pass.read(lighting_info);
+			ao = pass.write(ao);
+		}
+
+		{
+			auto pass = graph.add_pass("Lighting");
+			pass.read(albedo);
+			pass.read(lighting_info);
+			pass.read(depth_value);
+			pass.read(ao);
+			pass.read(shadow_map);
+			depth = pass.write(depth);
+			light_buffer = pass.write(light_buffer);
+		}
+
+		{
+			auto pass = graph.add_pass("Lights");
+			pass.read(albedo);
+			pass.read(lighting_info);
+			pass.read(depth_value);
+			light_buffer = pass.write(light_buffer);
+		}
+
+		{
+			auto pass = graph.add_pass("SSGI");
+			pass.read(light_buffer);
+			pass.read(albedo);
+			pass.read(lighting_info);
+			pass.read(depth_value);
+			ssgi_history = pass.write(ssgi_history);
+			ssgi_diffuse = pass.write(ssgi_diffuse);
+			ssgi_radiance = pass.write(ssgi_radiance);
+		}
+
+		if (ssgi)
+		{
+			auto pass = graph.add_pass("SSGI Add");
+			pass.read(ssgi_radiance);
+			light_buffer = pass.write(light_buffer);
+		}
+
+		{
+			auto pass = graph.add_pass("Auto Exposure");
+			pass.read(light_buffer);
+			exposure = pass.write(exposure);
+		}
+
+		{
+			auto pass = graph.add_pass("Bloom");
+			pass.read(light_buffer);
+			pass.read(exposure);
+			bloom_filter = pass.write(bloom_filter);
+			for (auto& mip : bloom_downsample) mip = pass.write(mip);
+			for (auto& mip : bloom_upsample) mip = pass.write(mip);
+		}
+
+		{
+			auto pass = graph.add_pass("Composite");
+			pass.read(light_buffer);
+			pass.read(exposure);
+			for (const auto& mip : bloom_downsample) pass.read(mip);
+			for (const auto& mip : bloom_upsample) pass.read(mip);
+			composite = pass.write(composite);
+			swapchain = pass.write(swapchain);
+		}
+
+		graph.add_pass("ImGui").write(swapchain);
+
+		return frame;
+	}
+
+	// Creates numbered textures, evicted textures are dropped when the deletion queue releases them
+	class MockDevice
+	{
+	  public:
+
+		using Texture = std::unique_ptr<uint32_t>;
+
+		std::expected<Texture, util::Error> create(
+			const gpu::Texture::Format& format [[maybe_unused]],
+			glm::u32vec2 size [[maybe_unused]],
+			uint32_t mip_levels [[maybe_unused]],
+			const std::string& name [[maybe_unused]]
+		) noexcept
+		{
+			return std::make_unique<uint32_t>(created++);
+		}
+
+		void set_name(const Texture& texture [[maybe_unused]], const std::string& name [[maybe_unused]])
+			const noexcept
+		{}
+
+		static bool is_empty(const Texture& texture) noexcept { return texture == nullptr; }
+
+		static void release(gpu::DeletionQueue& deletion_queue, Texture texture, uint64_t bytes) noexcept
+		{
+			deletion_queue.release([texture = std::move(texture)] {}, bytes);
+		}
+
+	  private:
+
+		uint32_t created = 0;
+	};
+
+	using MockPool = graphics::BasicTexturePool<MockDevice>;
+	using MockTransientTextures = graphics::BasicTransientTextures<MockPool>;
+
+	// Position of every pass in the compiled order, UINT32_MAX if culled
+	std::vector<uint32_t> get_positions(const RenderGraph::Compiled& compiled) noexcept
+	{
+		std::vector<uint32_t> positions(compiled.culled.size(), UINT32_MAX);
+		for (const auto [position, pass] : compiled.order | std::views::enumerate)
+			positions[pass] = uint32_t(position);
+		return positions;
+	}
+
+	// Pass declarations of a random frame, mirrored for checking
+	struct Declaration
+	{
+		std::vector<Handle> reads, writes;
+		bool side_effect;
+	};
+
+	struct Frame
+	{
+		RenderGraph graph;
+		std::vector<Declaration> passes;
+		std::vector<uint32_t> sizes;
+		std::vector<uint8_t> imported, preserved;
+	};
+
+	// Passes read and write the latest versions, so declaration order is a valid order
+	Frame make_frame(uint32_t resource_count, uint32_t pass_count) noexcept
+	{
+		Frame frame;
+		std::vector<uint32_t> version_counts;
+
+		for (uint32_t resource = 0; resource < resource_count; resource++)
+		{
+			const uint32_t size = 256 * (1 + generator() % 16);
+			const bool imported = generator() % 4 == 0;
+			const bool preserve = imported && generator() % 2 == 0;
+
+			const auto name = std::format("r{}", resource);
+			if (imported)
+				frame.graph.import_buffer(name, buffer(size), preserve);
+			else
+				frame.graph.create_buffer(name, buffer(size));
+
+			frame.sizes.push_back(size);
+			frame.imported.push_back(imported ? 1 : 0);
+			frame.preserved.push_back(preserve ? 1 : 0);
+			version_counts.push_back(1);
+		}
+
+		for (uint32_t pass = 0; pass < pass_count; pass++)
+		{
+			Declaration declaration{.reads = {}, .writes = {}, .side_effect = generator() % 8 == 0};
+			auto builder = frame.graph.add_pass(std::format("p{}", pass));
+
+			// Transient resources are readable once written
+			for (uint32_t read = generator() % 4; read > 0; read--)
+			{
+				const uint32_t resource = generator() % resource_count;
+				if (frame.imported[resource] == 0 && version_counts[resource] == 1) continue;
+
+				const Handle handle = {.resource = resource, .version = version_counts[resource] - 1};
+				builder.read(handle);
+				declaration.reads.push_back(handle);
+			}
+
+			for (uint32_t write = 1 + generator() % 2; write > 0; write--)
+			{
+				const uint32_t resource = generator() % resource_count;
+				const Handle latest = {.resource = resource, .version = version_counts[resource] - 1};
+				declaration.writes.push_back(builder.write(latest));
+				version_counts[resource]++;
+			}
+
+			if (declaration.side_effect) builder.side_effect();
+			frame.passes.push_back(declaration);
+		}
+
+		return frame;
+	}
+
+	// Writer of every version, UINT32_MAX for the content at the start of the frame
+	std::map<std::pair<uint32_t, uint32_t>, uint32_t> get_writers(const Frame& frame) noexcept
+	{
+		std::map<std::pair<uint32_t, uint32_t>, uint32_t> writers;
+		for (const auto [pass, declaration] : frame.passes | std::views::enumerate)
+			for (const auto& handle : declaration.writes)
+				writers[{handle.resource, handle.version}] = uint32_t(pass);
+		return writers;
+	}
+
+	uint32_t find_writer(
+		const std::map<std::pair<uint32_t, uint32_t>, uint32_t>& writers,
+		uint32_t resource,
+		uint32_t version
+	) noexcept
+	{
+		const auto it = writers.find({resource, version});
+		return it == writers.end() ? UINT32_MAX : it->second;
+	}
+}
+
+int main()
+{
+	test::run("Declaration errors", [] {
+		{
+			RenderGraph graph;
+			const auto transient = graph.create_buffer("transient", buffer(64));
+			graph.add_pass("early").read(transient);
+			TEST_CHECK(!graph.compile().has_value());
+		}
+
+		{
+			// Writing an overwritten version would fork the content
+			RenderGraph graph;
+			const auto target = graph.create_buffer("target", buffer(64));
+			const auto written = graph.add_pass("first").write(target);
+			graph.add_pass("second").write(written);
+			graph.add_pass("fork").write(written);
+			TEST_CHECK(!graph.compile().has_value());
+		}
+
+		{
+			RenderGraph graph;
+			graph.add_pass("invalid write").write({});
+			TEST_CHECK(!graph.compile().has_value());
+
+			RenderGraph read_graph;
+			read_graph.add_pass("invalid read").read({.resource = 3, .version = 0});
+			TEST_CHECK(!read_graph.compile().has_value());
+		}
+
+		{
+			// A version read before the pass writing it is declared, which depends on the reader
+			RenderGraph graph;
+			const auto a = graph.create_buffer("a", buffer(64));
+			const auto b = graph.create_buffer("b", buffer(64));
+
+			auto first = graph.add_pass("first");
+			first.read({.resource = a.resource, .version = 1});
+			const auto b1 = first.write(b);
+
+			auto second = graph.add_pass("second");
+			second.read(b1);
+			second.write(a);
+			second.side_effect();
+
+			TEST_CHECK(!graph.compile().has_value());
+		}
+	});
+
+	test::run("Frame", [] {
+		RenderGraph graph;
+
+		const auto swapchain = graph.import_buffer("swapchain", buffer(4096), true);
+		const auto history = graph.import_buffer("history", buffer(4096), false);
+		const auto depth = graph.create_buffer("depth", buffer(1024));
+		const auto color = graph.create_buffer("color", buffer(2048));
+		const auto debug = graph.create_buffer("debug", buffer(512));
+
+		auto depth_pass = graph.add_pass("depth");
+		const auto depth1 = depth_pass.write(depth);
+
+		auto lighting = graph.add_pass("lighting");
+		lighting.read(depth1);
+		lighting.read(history);
+		const auto color1 = lighting.write(color);
+
+		// Reads the content before the history is overwritten, declared after its writer
+		auto history_pass = graph.add_pass("history");
+		history_pass.read(color1);
+		history_pass.write(history);
+
+		auto debug_pass = graph.add_pass("debug");
+		debug_pass.read(depth1);
+		debug_pass.write(debug);
+
+		auto taa = graph.add_pass("taa");
+		taa.read(color1);
+		taa.read(history);
+		const auto color2 = taa.write(color1);
+
+		auto present = graph.add_pass("present");
+		present.read(color2);
+		present.write(swapchain);
+
+		auto readback = graph.add_pass("readback");
+		readback.read(depth1);
+		readback.side_effect();
+
+		const auto compiled = graph.compile();
+		if (!TEST_CHECK(compiled.has_value())) return;
+
+		// Unread debug output and unpreserved history are culled
+		const std::array<uint32_t, 5> expected_order = {0, 1, 4, 5, 6};
+		TEST_CHECK(std::ranges::equal(compiled->order, expected_order));
+		TEST_CHECK(std::ranges::equal(compiled->culled, std::array<uint8_t, 7>{0, 0, 1, 1, 0, 0, 0}));
+
+		TEST_CHECK(compiled->stats.passes == 5 && compiled->stats.culled_passes == 2);
+		TEST_CHECK(compiled->stats.transient_resources == 2);
+		TEST_CHECK(compiled->stats.transient_bytes == 1024 + 2048);
+		TEST_CHECK(compiled->stats.allocations == 2 && compiled->stats.allocated_bytes == 1024 + 2048);
+
+		// Positions in the order, unused resources have an empty span
+		const auto& lifetimes = compiled->lifetimes;
+		TEST_CHECK(lifetimes[depth.resource].first == 0 && lifetimes[depth.resource].last == 4);
+		TEST_CHECK(lifetimes[color.resource].first == 1 && lifetimes[color.resource].last == 3);
+		TEST_CHECK(lifetimes[swapchain.resource].first == 3 && lifetimes[swapchain.resource].last == 3);
+		TEST_CHECK(lifetimes[debug.resource].first == UINT32_MAX);
+		TEST_CHECK(lifetimes[color.resource].overlaps(lifetimes[depth.resource]));
+		TEST_CHECK(!lifetimes[swapchain.resource].overlaps(lifetimes[history.resource]));
+
+		const auto dot = graph.to_graphviz(*compiled);
+		TEST_CHECK(dot.contains("debug (culled)") && dot.contains("4: readback"));
+	});
+
+	test::run("Write after read", [] {
+		// A pass declared after the overwrite reads the older version, so it runs first
+		RenderGraph graph;
+		const auto target = graph.import_buffer("target", buffer(64), true);
+		const auto output = graph.create_buffer("output", buffer(64));
+
+		const auto target1 = graph.add_pass("produce").write(target);
+		graph.add_pass("overwrite").write(target1);
+
+		auto late_reader = graph.add_pass("late reader");
+		late_reader.read(target1);
+		late_reader.write(output);
+		late_reader.side_effect();
+
+		const auto compiled = graph.compile();
+		if (!TEST_CHECK(compiled.has_value())) return;
+		TEST_CHECK(std::ranges::equal(compiled->order, std::array{0u, 2u, 1u}));
+	});
+
+	test::run("Random frames", [] {
+		for (int trial = 0; trial < 300; trial++)
+		{
+			const auto frame = make_frame(2 + generator() % 12, 1 + generator() % 40);
+			const auto compiled = frame.graph.compile();
+			if (!TEST_CHECK(compiled.has_value())) continue;
+
+			const auto writers = get_writers(frame);
+			const auto positions = get_positions(*compiled);
+
+			// Kept passes: side effects, preserved writes, and producers of what kept passes consume
+			std::vector<uint8_t> kept(frame.passes.size(), 0);
+			for (uint32_t pass = uint32_t(frame.passes.size()); pass-- > 0;)
+			{
+				const auto& declaration = frame.passes[pass];
+				if (declaration.side_effect) kept[pass] = 1;
+				for (const auto& handle : declaration.writes)
+					if (frame.preserved[handle.resource] != 0) kept[pass] = 1;
+			}
+
+			for (bool changed = true; changed;)
+			{
+				changed = false;
+				for (const auto [pass, declaration] : frame.passes | std::views::enumerate)
+				{
+					if (kept[pass] == 0) continue;
+
+					std::vector<uint32_t> producers;
+					for (const auto& handle : declaration.reads)
+						producers.push_back(find_writer(writers, handle.resource, handle.version));
+					for (const auto& handle : declaration.writes)
+						producers.push_back(find_writer(writers, handle.resource, handle.version - 1));
+
+					for (const auto producer : producers)
+						if (producer != UINT32_MAX && kept[producer] == 0)
+						{
+							kept[producer] = 1;
+							changed = true;
+						}
+				}
+			}
+
+			for (const auto [pass, is_kept] : kept | std::views::enumerate)
+			{
+				TEST_CHECK(compiled->culled[pass] == (is_kept == 0 ? 1 : 0));
+				TEST_CHECK((positions[pass] != UINT32_MAX) == (is_kept != 0));
+			}
+
+			// Every dependency between kept passes is respected
+			for (const auto [pass, declaration] : frame.passes | std::views::enumerate)
+			{
+				if (kept[pass] == 0) continue;
+
+				const auto before = [&](uint32_t other) {
+					if (other != UINT32_MAX && other != uint32_t(pass) && kept[other] != 0)
+						TEST_CHECK(positions[other] < positions[pass]);
+				};
+
+				for (const auto& handle : declaration.reads)
+					before(find_writer(writers, handle.resource, handle.version));
+
+				for (const auto& handle : declaration.writes)
+				{
+					before(find_writer(writers, handle.resource, handle.version - 1));
+
+					for (const auto [reader, reader_declaration] : frame.passes | std::views::enumerate)
+						for (const auto& read : reader_declaration.reads)
+							if (read.resource == handle.resource && read.version == handle.version - 1)
+								before(uint32_t(reader));
+				}
+			}
+
+			// Lifetimes span the kept uses, stats count the transient resources used
+			std::vector<RenderGraph::Lifetime> lifetimes(frame.sizes.size());
+			for (const auto [pass, declaration] : frame.passes | std::views::enumerate)
+			{
+				if (kept[pass] == 0) continue;
+
+				for (const auto& handles : {declaration.reads, declaration.writes})
+					for (const auto& handle : handles)
+					{
+						auto& lifetime = lifetimes[handle.resource];
+						lifetime.first = std::min(lifetime.first, positions[pass]);
+						lifetime.last = std::max(lifetime.last, positions[pass]);
+					}
+			}
+
+			uint32_t transient_count = 0;
+			uint64_t transient_bytes = 0;
+			for (const auto [resource, lifetime] : lifetimes | std::views::enumerate)
+			{
+				const auto& compiled_lifetime = compiled->lifetimes[resource];
+				TEST_CHECK(compiled_lifetime.first == lifetime.first);
+				TEST_CHECK(compiled_lifetime.last == lifetime.last);
+
+				if (frame.imported[resource] != 0 || lifetime.first == UINT32_MAX) continue;
+				transient_count++;
+				transient_bytes += frame.sizes[resource];
+			}
+
+			TEST_CHECK(compiled->stats.transient_resources == transient_count);
+			TEST_CHECK(compiled->stats.transient_bytes == transient_bytes);
+
+			// Imported and unused resources have no allocation, aliased ones are compatible and disjoint
+			std::map<uint32_t, std::vector<uint32_t>> aliased;
+			for (const auto [resource, lifetime] : lifetimes | std::views::enumerate)
+			{
+				const uint32_t allocation = compiled->allocation[resource];
+				const bool transient = frame.imported[resource] == 0 && lifetime.first != UINT32_MAX;
+				TEST_CHECK((allocation != RenderGraph::no_allocation) == transient);
+				if (!transient) continue;
+
+				const auto& desc = std::get<RenderGraph::BufferDesc>(compiled->allocations[allocation]);
+				TEST_CHECK(desc.size == frame.sizes[resource]);
+
+				for (const auto other : aliased[allocation])
+				{
+					const auto& other_lifetime = lifetimes[other];
+					TEST_CHECK(other_lifetime.last < lifetime.first || lifetime.last < other_lifetime.first);
+				}
+
+				aliased[allocation].push_back(uint32_t(resource));
+			}
+
+			uint64_t allocated_bytes = 0;
+			for (const auto& desc : compiled->allocations)
+				allocated_bytes += std::get<RenderGraph::BufferDesc>(desc).size;
+
+			TEST_CHECK(compiled->stats.allocations == compiled->allocations.size());
+			TEST_CHECK(compiled->stats.allocated_bytes == allocated_bytes);
+			TEST_CHECK(allocated_bytes <= transient_bytes);
+
+			// Per size, as many allocations as transient resources alive at once
+			std::map<uint32_t, uint32_t> max_alive, allocations;
+			for (const auto& desc : compiled->allocations)
+				allocations[std::get<RenderGraph::BufferDesc>(desc).size]++;
+
+			for (const auto position : std::views::iota(0u, uint32_t(compiled->order.size())))
+			{
+				std::map<uint32_t, uint32_t> alive;
+				for (const auto [resource, lifetime] : lifetimes | std::views::enumerate)
+				{
+					const bool transient = frame.imported[resource] == 0;
+					if (transient && lifetime.first <= position && position <= lifetime.last)
+						alive[frame.sizes[resource]]++;
+				}
+
+				for (const auto [size, count] : alive) max_alive[size] = std::max(max_alive[size], count);
+			}
+
+			TEST_CHECK(allocations == max_alive);
+		}
+	});
+
+	test::run("Frame aliasing", [] {
+		// Even size, SSGI blurred diffuse and the first bloom downsample are identical half size targets
+		{
+			auto frame = make_renderer_frame({1920, 1088}, true);
+			const auto compiled = frame.graph.compile();
+			if (!TEST_CHECK(compiled.has_value())) return;
+
+			const auto& stats = compiled->stats;
+			TEST_CHECK(stats.transient_resources == 7 + 2 * bloom_mip_count - 1);
+			TEST_CHECK(stats.allocations == stats.transient_resources - 1);
+
+			const uint32_t diffuse = compiled->allocation[frame.ssgi_diffuse.resource];
+			const uint32_t downsample = compiled->allocation[frame.bloom_downsample[0].resource];
+			if (!TEST_CHECK(diffuse != RenderGraph::no_allocation && diffuse == downsample)) return;
+
+			// Shared allocation is a color target for bloom, and storage for SSGI
+			const auto& merged = std::get<RenderGraph::TextureDesc>(compiled->allocations[diffuse]);
+			TEST_CHECK(merged.format.usage.color_target && merged.format.usage.compute_storage_write);
+			TEST_CHECK(merged.size == glm::u32vec2(960, 544));
+
+			const RenderGraph::TextureDesc diffuse_desc = {.format = radiance_format, .size = {960, 544}};
+			TEST_CHECK(stats.transient_bytes - stats.allocated_bytes == diffuse_desc.get_bytes());
+
+			// Every other transient has its own allocation
+			std::map<uint32_t, uint32_t> users;
+			for (const auto allocation : compiled->allocation)
+				if (allocation != RenderGraph::no_allocation) users[allocation]++;
+			for (const auto [allocation, count] : users) TEST_CHECK(count == (allocation == diffuse ? 2 : 1));
+		}
+
+		// Without SSGI its passes are culled, nothing left to share
+		{
+			auto frame = make_renderer_frame({1920, 1088}, false);
+			const auto compiled = frame.graph.compile();
+			if (!TEST_CHECK(compiled.has_value())) return;
+
+			TEST_CHECK(compiled->allocation[frame.ssgi_diffuse.resource] == RenderGraph::no_allocation);
+			TEST_CHECK(compiled->stats.allocations == compiled->stats.transient_resources);
+			TEST_CHECK(compiled->stats.allocated_bytes == compiled->stats.transient_bytes);
+		}
+
+		// Odd size, the half sizes round differently
+		{
+			auto frame = make_renderer_frame({1919, 1079}, true);
+			const auto compiled = frame.graph.compile();
+			if (!TEST_CHECK(compiled.has_value())) return;
+
+			TEST_CHECK(compiled->stats.allocations == compiled->stats.transient_resources);
+			TEST_CHECK(
+				compiled->allocation[frame.ssgi_diffuse.resource]
+				!= compiled->allocation[frame.bloom_downsample[0].resource]
+			);
+		}
+	});
+
+	test::run("Transient textures", [] {
+		MockPool pool(MockDevice(), {});
+		MockTransientTextures transient_textures;
+
+		auto frame = make_renderer_frame({1920, 1088}, true);
+		const auto compiled = frame.graph.compile();
+		if (!TEST_CHECK(compiled.has_value())) return;
+
+		if (!TEST_CHECK(transient_textures.realize(pool, *compiled).has_value())) return;
+		TEST_CHECK(transient_textures.get_texture_count() == compiled->stats.allocations);
+		TEST_CHECK(pool.get_stats().misses == compiled->stats.allocations);
+
+		// Aliased resources are bound to the same texture, distinct allocations to distinct textures
+		const auto* diffuse = transient_textures.get(frame.ssgi_diffuse);
+		TEST_CHECK(diffuse != nullptr && diffuse == transient_textures.get(frame.bloom_downsample[0]));
+		TEST_CHECK(transient_textures.get(frame.ssgi_radiance) != diffuse);
+		TEST_CHECK(transient_textures.get(frame.composite) != nullptr);
+
+		std::map<uint32_t, uint32_t> texture_ids;
+		for (const auto [resource, allocation] : compiled->allocation | std::views::enumerate)
+		{
+			const auto* texture = transient_textures.get({.resource = uint32_t(resource), .version = 0});
+
+			// Imported resources are bound by their owners
+			TEST_CHECK((texture == nullptr) == (allocation == RenderGraph::no_allocation));
+			if (texture == nullptr) continue;
+
+			const auto [it, inserted] = texture_ids.emplace(allocation, **texture);
+			TEST_CHECK(it->second == **texture);
+		}
+
+		// Realizing the next identical frame reuses every texture
+		if (!TEST_CHECK(transient_textures.realize(pool, *compiled).has_value())) return;
+		TEST_CHECK(pool.get_stats().misses == compiled->stats.allocations);
+		TEST_CHECK(pool.get_stats().hits == compiled->stats.allocations);
+		TEST_CHECK(pool.get_stats().live_textures == compiled->stats.allocations);
+
+		// Culled resources are not bound
+		auto culled_frame = make_renderer_frame({1920, 1088}, false);
+		const auto culled_compiled = culled_frame.graph.compile();
+		if (!TEST_CHECK(culled_compiled.has_value())) return;
+
+		if (!TEST_CHECK(transient_textures.realize(pool, *culled_compiled).has_value())) return;
+		TEST_CHECK(transient_textures.get(culled_frame.ssgi_diffuse) == nullptr);
+		TEST_CHECK(transient_textures.get(culled_frame.bloom_downsample[0]) != nullptr);
+
+		transient_textures.release(pool);
+		TEST_CHECK(transient_textures.get_texture_count() == 0 && pool.get_stats().live_textures == 0);
+	});
+
+	test::run("Execute", [] {
+		RenderGraph graph;
+		std::vector<std::string> executed;
+
+		const auto record = [&executed](std::string name) -> RenderGraph::Execute {
+			return [&executed, name]() -> std::expected<void, util::Error> {
+				executed.push_back(name);
+				return {};
+			};
+		};
+
+		const auto target = graph.import_buffer("target", buffer(64), true);
+		const auto scratch = graph.create_buffer("scratch", buffer(64));
+
+		auto culled = graph.add_pass("culled", record("culled"));
+		culled.write(scratch);
+
+		auto no_commands = graph.add_pass("no commands");
+		const auto target1 = no_commands.write(target);
+
+		auto draw = graph.add_pass("draw", record("draw"));
+		const auto target2 = draw.write(target1);
+
+		auto failing = graph.add_pass("failing", [] -> std::expected<void, util::Error> {
+			return util::Error("Out of memory");
+		});
+		const auto target3 = failing.write(target2);
+
+		graph.add_pass("after failure", record("after failure")).write(target3);
+
+		const auto compiled = graph.compile();
+		if (!TEST_CHECK(compiled.has_value())) return;
+
+		// Stops at the first failing pass, naming it
+		const auto result = graph.execute(*compiled);
+		if (!TEST_CHECK(!result.has_value())) return;
+		TEST_CHECK(std::ranges::equal(executed, std::array<std::string, 1>{"draw"}));
+		TEST_CHECK(result.error()->front().message == "Out of memory");
+		TEST_CHECK(result.error()->back().message.contains("failing"));
+	});
+
+	return test::finish();
+}
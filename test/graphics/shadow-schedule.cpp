@@ -0,0 +1,372 @@
+// Receiver culling of `graphics::ShadowReceiverMask` and refresh decisions of `graphics::ShadowCascadeCache`
+
+#include "graphics/shadow-schedule.hpp"
+#include "test/check.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <ranges>
+#include <vector>
+
+namespace
+{
+	std::mt19937 generator{103};
+
+	using Cache = graphics::ShadowCascadeCache;
+	using Action = Cache::Action;
+
+	const glm::vec3 light_direction = glm::normalize(glm::vec3(-1.0f, -3.0f, -0.5f));
+
+	struct Box
+	{
+		glm::vec3 min, max;
+	};
+
+	Box random_box(float extent, float max_size) noexcept
+	{
+		std::uniform_real_distribution<float> position(-extent, extent);
+		std::uniform_real_distribution<float> size(0.1f, max_size);
+
+		const glm::vec3 min = {position(generator), position(generator), position(generator)};
+		return {.min = min, .max = min + glm::vec3(size(generator), size(generator), size(generator))};
+	}
+
+	// Light-space rectangle and depth range of a box, computed from its 8 corners
+	struct LightRect
+	{
+		glm::vec2 min, max;
+		float depth_min, depth_max;
+	};
+
+	LightRect to_light_rect(const Box& box, const glm::mat4& view_matrix) noexcept
+	{
+		LightRect rect{
+			.min = glm::vec2(std::numeric_limits<float>::max()),
+			.max = glm::vec2(std::numeric_limits<float>::lowest()),
+			.depth_min = std::numeric_limits<float>::max(),
+			.depth_max = std::numeric_limits<float>::lowest()
+		};
+
+		for (const auto corner : std::views::iota(0, 8))
+		{
+			const glm::vec3 point = {
+				(corner & 1) != 0 ? box.max.x : box.min.x,
+				(corner & 2) != 0 ? box.max.y : box.min.y,
+				(corner & 4) != 0 ? box.max.z : box.min.z
+			};
+			const glm::vec3 light = view_matrix * glm::vec4(point, 1.0f);
+
+			rect.min = glm::min(rect.min, glm::vec2(light));
+			rect.max = glm::max(rect.max, glm::vec2(light));
+			rect.depth_min = std::min(rect.depth_min, -light.z);
+			rect.depth_max = std::max(rect.depth_max, -light.z);
+		}
+
+		return rect;
+	}
+
+	// Axis-aligned slice of a camera frustum, centered at `center`
+	std::array<glm::vec3, 8> make_slice(const glm::vec3& center, const glm::vec3& half_extent) noexcept
+	{
+		std::array<glm::vec3, 8> corners;
+		for (const auto corner : std::views::iota(0, 8))
+		{
+			const glm::vec3 sign = {
+				(corner & 1) != 0 ? 1.0f : -1.0f,
+				(corner & 2) != 0 ? 1.0f : -1.0f,
+				(corner & 4) != 0 ? 1.0f : -1.0f
+			};
+			corners[corner] = center + sign * half_extent;
+		}
+		return corners;
+	}
+
+	// Rotate the light direction by `angle` radians around a perpendicular axis
+	glm::vec3 rotate_direction(const glm::vec3& direction, float angle) noexcept
+	{
+		const glm::vec3 axis = glm::normalize(glm::cross(direction, glm::vec3(0.0f, 0.0f, 1.0f)));
+		const glm::vec3 side = glm::cross(axis, direction);
+		return glm::normalize(direction * std::cos(angle) + side * std::sin(angle));
+	}
+
+	constexpr uint32_t shadow_resolution = 2048;
+
+	const Cache::DepthRange caster_range = {.near = -20.0f, .far = 20.0f};
+	const Cache::DepthRange dynamic_range = {.near = -5.0f, .far = 5.0f};
+
+	// Cascade with a committed static layer, at a fixed slice
+	struct CachedCascade
+	{
+		Cache cache;
+		Cache::Config config;
+		std::array<glm::vec3, 8> slice = make_slice(glm::vec3(0.0f), glm::vec3(10.0f));
+		graphics::SmallestBound bound{};
+
+		explicit CachedCascade(const Cache::Config& config = {}) noexcept :
+			config(config)
+		{
+			bound = cache.fit(slice, light_direction, shadow_resolution, config);
+			cache.decide(frame(0), config);
+			cache.commit_rebuild(caster_range, config);
+		}
+
+		Cache::FrameInfo frame(
+			uint64_t frame_index,
+			bool has_dynamic_casters = true,
+			uint64_t static_signature = 1
+		) const noexcept
+		{
+			return {
+				.dynamic_range = dynamic_range,
+				.has_dynamic_casters = has_dynamic_casters,
+				.static_signature = static_signature,
+				.frame_index = frame_index
+			};
+		}
+
+		Action step(const Cache::FrameInfo& info, const glm::vec3& direction = light_direction) noexcept
+		{
+			bound = cache.fit(slice, direction, shadow_resolution, config);
+			const auto action = cache.decide(info, config);
+			if (action == Action::Rebuild) cache.commit_rebuild(caster_range, config);
+			return action;
+		}
+	};
+}
+
+int main()
+{
+	test::run("Receiver mask", [] {
+		size_t rejected = 0;
+		size_t tested = 0;
+
+		for (int scene = 0; scene < 50; scene++)
+		{
+			const auto slice = make_slice(glm::vec3(0.0f), glm::vec3(20.0f, 5.0f, 20.0f));
+			const auto bound = graphics::find_smallest_bound(slice, light_direction);
+			const glm::vec2 rect_min = {bound.left, bound.top};
+			const glm::vec2 rect_max = {bound.right, bound.bottom};
+			const glm::vec2 cell_size =
+				(rect_max - rect_min) / float(graphics::ShadowReceiverMask::resolution);
+
+			graphics::ShadowReceiverMask mask;
+			mask.begin(bound);
+
+			std::vector<LightRect> receivers;
+			for (int receiver = 0; receiver < 20; receiver++)
+			{
+				const auto box = random_box(30.0f, 4.0f);
+				mask.add_receiver(box.min, box.max);
+
+				auto rect = to_light_rect(box, bound.view_matrix);
+				const bool inside = glm::all(glm::lessThan(rect.min, rect_max))
+					&& glm::all(glm::greaterThan(rect.max, rect_min));
+				if (inside) receivers.push_back(rect);
+			}
+
+			// Receivers outside the cascade rectangle are dropped
+			TEST_CHECK(mask.get_receiver_count() >= receivers.size());
+
+			for (int caster = 0; caster < 200; caster++)
+			{
+				const auto box = random_box(30.0f, 4.0f);
+				const auto rect = to_light_rect(box, bound.view_matrix);
+				const bool kept = mask.test_caster(box.min, box.max);
+
+				// Brute force: a receiver under the caster, inside the cascade, reaches below its depth
+				const bool shadows = std::ranges::any_of(receivers, [&](const LightRect& receiver) {
+					const glm::vec2 overlap_min = glm::max(glm::max(rect.min, receiver.min), rect_min);
+					const glm::vec2 overlap_max = glm::min(glm::min(rect.max, receiver.max), rect_max);
+					return glm::all(glm::lessThan(overlap_min, overlap_max))
+						&& receiver.depth_min <= rect.depth_max;
+				});
+
+				// Never rejects a caster shadowing a receiver
+				if (shadows) TEST_CHECK(kept);
+
+				// Keeps casters only for receivers within a cell of them
+				const bool near_receiver = std::ranges::any_of(receivers, [&](const LightRect& receiver) {
+					const glm::vec2 overlap_min = glm::max(rect.min, receiver.min - cell_size);
+					const glm::vec2 overlap_max = glm::min(rect.max, receiver.max + cell_size);
+					return glm::all(glm::lessThanEqual(overlap_min, overlap_max))
+						&& receiver.depth_min <= rect.depth_max;
+				});
+				if (kept) TEST_CHECK(near_receiver);
+
+				// Rejects whatever is entirely outside the cascade or below every receiver
+				const bool outside = glm::any(glm::greaterThanEqual(rect.min, rect_max))
+					|| glm::any(glm::lessThan(rect.max, rect_min));
+				const bool below_all = std::ranges::all_of(receivers, [&rect](const LightRect& receiver) {
+					return receiver.depth_min > rect.depth_max;
+				});
+				if (outside || below_all) TEST_CHECK(!kept);
+
+				rejected += kept ? 0 : 1;
+				tested++;
+			}
+		}
+
+		// The mask does reject casters of random scenes
+		TEST_CHECK(rejected > tested / 10);
+
+		// An empty mask rejects every caster, `begin` drops previous receivers
+		graphics::ShadowReceiverMask mask;
+		const auto slice = make_slice(glm::vec3(0.0f), glm::vec3(10.0f));
+		const auto bound = graphics::find_smallest_bound(slice, light_direction);
+		mask.begin(bound);
+		mask.add_receiver(glm::vec3(-10.0f), glm::vec3(10.0f));
+		TEST_CHECK(mask.test_caster(glm::vec3(-1.0f), glm::vec3(1.0f)));
+
+		mask.begin(bound);
+		TEST_CHECK(mask.get_receiver_count() == 0);
+		TEST_CHECK(!mask.test_caster(glm::vec3(-1.0f), glm::vec3(1.0f)));
+	});
+
+	test::run("Cascade reuse", [] {
+		CachedCascade cascade;
+		const auto initial_bound = cascade.bound;
+
+		// Dynamic casters are refreshed over the static layer every frame
+		TEST_CHECK(cascade.step(cascade.frame(1)) == Action::Refresh);
+		TEST_CHECK(cascade.step(cascade.frame(2)) == Action::Refresh);
+
+		// Once they are gone, one refresh clears them, then the shadow map is kept
+		TEST_CHECK(cascade.step(cascade.frame(3, false)) == Action::Refresh);
+		TEST_CHECK(cascade.step(cascade.frame(4, false)) == Action::Skip);
+		TEST_CHECK(cascade.step(cascade.frame(5, false)) == Action::Skip);
+
+		// Small camera moves keep the bound and the static layer
+		for (int frame = 6; frame < 16; frame++)
+		{
+			cascade.slice = make_slice(glm::vec3(0.05f * float(frame), 0.0f, 0.0f), glm::vec3(10.0f));
+			TEST_CHECK(cascade.step(cascade.frame(frame)) == Action::Refresh);
+			TEST_CHECK(cascade.bound.left == initial_bound.left && cascade.bound.top == initial_bound.top);
+		}
+
+		// Light direction changes below the threshold keep it too
+		const auto direction = rotate_direction(light_direction, 0.002f);
+		TEST_CHECK(cascade.step(cascade.frame(16), direction) == Action::Refresh);
+
+		// Padded depth range of the rebuilt layer
+		const auto depth_range = cascade.cache.get_depth_range();
+		TEST_CHECK(depth_range.near < caster_range.near && depth_range.far > caster_range.far);
+	});
+
+	test::run("Cascade rebuild", [] {
+		// Camera moving out of the bound refits it on whole texels
+		{
+			CachedCascade cascade;
+			const auto initial_bound = cascade.bound;
+
+			cascade.slice = make_slice(glm::vec3(8.0f, 0.0f, 3.0f), glm::vec3(10.0f));
+			TEST_CHECK(cascade.step(cascade.frame(1)) == Action::Rebuild);
+			TEST_CHECK(cascade.bound.left != initial_bound.left || cascade.bound.top != initial_bound.top);
+
+			const float texel_size = (initial_bound.right - initial_bound.left) / float(shadow_resolution);
+			const float texels = (cascade.bound.left - initial_bound.left) / texel_size;
+			TEST_CHECK(std::abs(texels - std::round(texels)) < 0.01f);
+
+			TEST_CHECK(cascade.step(cascade.frame(2)) == Action::Refresh);
+		}
+
+		// Slice shrinking well inside the bound refits it
+		{
+			CachedCascade cascade;
+			cascade.slice = make_slice(glm::vec3(0.0f), glm::vec3(4.0f));
+			TEST_CHECK(cascade.step(cascade.frame(1)) == Action::Rebuild);
+			TEST_CHECK(cascade.step(cascade.frame(2)) == Action::Refresh);
+		}
+
+		// Light direction moving past the threshold
+		{
+			CachedCascade cascade;
+			const auto direction = rotate_direction(light_direction, 0.05f);
+			TEST_CHECK(cascade.step(cascade.frame(1), direction) == Action::Rebuild);
+			TEST_CHECK(cascade.step(cascade.frame(2), direction) == Action::Refresh);
+		}
+
+		// Static set changes, the signature is bumped
+		{
+			CachedCascade cascade;
+			TEST_CHECK(cascade.step(cascade.frame(1, false, 1)) == Action::Refresh);
+			TEST_CHECK(cascade.step(cascade.frame(2, false, 2)) == Action::Rebuild);
+			TEST_CHECK(cascade.step(cascade.frame(3, false, 2)) == Action::Skip);
+			TEST_CHECK(cascade.step(cascade.frame(4, false, 3)) == Action::Rebuild);
+		}
+
+		// Dynamic casters leaving the depth range
+		{
+			CachedCascade cascade;
+			auto info = cascade.frame(1);
+			info.dynamic_range = {.near = -5.0f, .far = 40.0f};
+			TEST_CHECK(cascade.step(info) == Action::Rebuild);
+
+			// Without dynamic casters, the range is empty and always covered
+			info = cascade.frame(2, false);
+			info.dynamic_range = {};
+			TEST_CHECK(cascade.step(info) == Action::Refresh);
+			info.frame_index = 3;
+			TEST_CHECK(cascade.step(info) == Action::Skip);
+		}
+
+		// Updates that didn't reach the GPU are invalidated
+		{
+			CachedCascade cascade;
+			TEST_CHECK(cascade.step(cascade.frame(1, false)) == Action::Refresh);
+			TEST_CHECK(cascade.step(cascade.frame(2, false)) == Action::Skip);
+			cascade.cache.invalidate();
+			TEST_CHECK(cascade.step(cascade.frame(3, false)) == Action::Rebuild);
+			TEST_CHECK(cascade.step(cascade.frame(4, false)) == Action::Skip);
+		}
+
+		// Empty caster range falls back to the unit range
+		{
+			Cache cache;
+			cache.commit_rebuild({}, {});
+			TEST_CHECK(cache.get_depth_range().near == 0.0f && cache.get_depth_range().far == 1.0f);
+		}
+	});
+
+	test::run("Stagger", [] {
+		// Three cascades refreshed every third frame, at different phases
+		constexpr uint32_t cascade_count = 3;
+		std::vector<CachedCascade> cascades;
+		for (const auto cascade : std::views::iota(0u, cascade_count))
+			cascades.emplace_back(Cache::Config{.refresh_interval = cascade_count, .refresh_phase = cascade});
+
+		for (uint64_t frame = 1; frame < 60; frame++)
+		{
+			uint32_t refreshed = 0;
+			for (auto [cascade_idx, cascade] : cascades | std::views::enumerate)
+			{
+				const auto action = cascade.step(cascade.frame(frame));
+				const bool due = (frame + uint64_t(cascade_idx)) % cascade_count == 0;
+
+				TEST_CHECK(action == (due ? Action::Refresh : Action::Skip));
+				refreshed += action == Action::Refresh ? 1 : 0;
+			}
+
+			// One cascade per frame
+			TEST_CHECK(refreshed == 1);
+		}
+
+		// Per cascade intervals, each refreshed at its own rate
+		for (const uint32_t interval : {1u, 2u, 4u, 8u})
+		{
+			CachedCascade cascade(Cache::Config{.refresh_interval = interval, .refresh_phase = 1});
+
+			uint32_t refreshes = 0;
+			for (uint64_t frame = 1; frame <= 64; frame++)
+				refreshes += cascade.step(cascade.frame(frame)) == Action::Refresh ? 1 : 0;
+			TEST_CHECK(refreshes == 64 / interval);
+		}
+
+		// Rebuilds are never delayed by the interval
+		CachedCascade cascade(Cache::Config{.refresh_interval = 4, .refresh_phase = 0});
+		TEST_CHECK(cascade.step(cascade.frame(1)) == Action::Skip);
+		TEST_CHECK(cascade.step(cascade.frame(2, true, 2)) == Action::Rebuild);
+	});
+
+	return test::finish();
+}
@@ -0,0 +1,191 @@
+// Bounds of `graphics::SkinBound` against CPU-skinned vertices of random rigs
+
+#include "graphics/skin-bound.hpp"
+#include "test/check.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{59};
+	std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+
+	glm::vec3 random_vec3() noexcept
+	{
+		return glm::vec3(unit(generator), unit(generator), unit(generator)) - 0.5f;
+	}
+
+	struct Mesh
+	{
+		std::vector<glm::vec3> positions;
+		std::vector<glm::uvec4> joint_indices;
+		std::vector<glm::vec4> joint_weights;
+	};
+
+	// Joint tree with random parents, bind-pose world matrices
+	std::vector<glm::mat4> make_bind_pose(std::span<const uint32_t> parents) noexcept
+	{
+		std::vector<glm::mat4> bind_pose;
+		for (const auto [joint, parent] : parents | std::views::enumerate)
+		{
+			const glm::vec3 offset = {
+				unit(generator) - 0.5f,
+				0.3f + unit(generator) * 0.5f,
+				unit(generator) - 0.5f
+			};
+			bind_pose.push_back(joint == 0 ? glm::mat4(1.0f) : glm::translate(bind_pose[parent], offset));
+		}
+
+		return bind_pose;
+	}
+
+	// Vertices around their main joint, influenced by up to `max_influences` joints
+	Mesh make_mesh(
+		std::span<const glm::mat4> bind_pose,
+		size_t vertex_count,
+		uint32_t max_influences
+	) noexcept
+	{
+		Mesh mesh;
+		for (size_t vertex = 0; vertex < vertex_count; vertex++)
+		{
+			const auto main_joint = uint32_t(generator() % bind_pose.size());
+			mesh.positions.push_back(glm::vec3(bind_pose[main_joint][3]) + random_vec3() * 0.4f);
+
+			const auto influences = 1 + generator() % max_influences;
+			glm::uvec4 indices(0u);
+			glm::vec4 weights(0.0f);
+			for (uint32_t slot = 0; slot < influences; slot++)
+			{
+				indices[slot] = slot == 0 ? main_joint : uint32_t(generator() % bind_pose.size());
+				weights[slot] = unit(generator) + 0.01f;
+			}
+
+			mesh.joint_indices.push_back(indices);
+			mesh.joint_weights.push_back(weights / (weights.x + weights.y + weights.z + weights.w));
+		}
+
+		return mesh;
+	}
+
+	// Linear blend skinning, as done by the vertex shader
+	glm::vec3 skin_vertex(const Mesh& mesh, size_t vertex, std::span<const glm::mat4> joint_matrices) noexcept
+	{
+		glm::vec3 result(0.0f);
+		for (uint32_t slot = 0; slot < 4; slot++)
+		{
+			const auto transformed = joint_matrices[mesh.joint_indices[vertex][slot]]
+								   * glm::vec4(mesh.positions[vertex], 1.0f);
+			result += glm::vec3(transformed) * mesh.joint_weights[vertex][slot];
+		}
+
+		return result;
+	}
+
+	bool bound_contains(const std::pair<glm::vec3, glm::vec3>& bound, const glm::vec3& point) noexcept
+	{
+		const float epsilon = 1e-4f * (1.0f + glm::length(point));
+		return glm::all(glm::greaterThanEqual(point + epsilon, bound.first))
+			&& glm::all(glm::lessThanEqual(point - epsilon, bound.second));
+	}
+}
+
+int main()
+{
+	test::run("Empty skin", [] {
+		const std::array positions = {glm::vec3(0, 0, 0), glm::vec3(1, 1, 1)};
+		const std::array indices = {glm::uvec4(3, 0, 0, 0), glm::uvec4(5, 0, 0, 0)};
+		const std::array weights = {glm::vec4(0.0f), glm::vec4(0.0f)};
+
+		TEST_CHECK(graphics::SkinBound::build(positions, indices, weights).empty());
+		TEST_CHECK(graphics::SkinBound::build({}, {}, {}).empty());
+	});
+
+	test::run("Joint count", [] {
+		// Zero-weight slots don't count, even with large joint indices
+		const std::array positions = {glm::vec3(0, 0, 0), glm::vec3(1, 1, 1)};
+		const std::array indices = {glm::uvec4(2, 40, 0, 0), glm::uvec4(6, 1, 0, 0)};
+		const std::array weights = {glm::vec4(1, 0, 0, 0), glm::vec4(0.5f, 0.5f, 0, 0)};
+
+		const auto bound = graphics::SkinBound::build(positions, indices, weights);
+		TEST_CHECK(!bound.empty());
+		TEST_CHECK(bound.get_joint_count() == 7);
+	});
+
+	test::run("Rigid joints", [] {
+		// Single influences and translated joints, the bound is exact
+		const std::vector<uint32_t> parents = {0, 0, 1, 1, 2, 0, 5, 6, 6};
+		const auto bind_pose = make_bind_pose(parents);
+		const auto mesh = make_mesh(bind_pose, 3000, 1);
+		const auto bound = graphics::SkinBound::build(mesh.positions, mesh.joint_indices, mesh.joint_weights);
+
+		for (int pose = 0; pose < 20; pose++)
+		{
+			std::vector<glm::mat4> joint_matrices;
+			for (size_t joint = 0; joint < parents.size(); joint++)
+				joint_matrices.push_back(glm::translate(glm::mat4(1.0f), random_vec3() * 10.0f));
+
+			glm::vec3 skinned_min(std::numeric_limits<float>::max());
+			glm::vec3 skinned_max(std::numeric_limits<float>::lowest());
+			for (size_t vertex = 0; vertex < mesh.positions.size(); vertex++)
+			{
+				const auto skinned = skin_vertex(mesh, vertex, joint_matrices);
+				skinned_min = glm::min(skinned_min, skinned);
+				skinned_max = glm::max(skinned_max, skinned);
+			}
+
+			const auto [bound_min, bound_max] = bound.compute_world_bound(joint_matrices);
+			TEST_CHECK(glm::all(glm::lessThan(glm::abs(bound_min - skinned_min), glm::vec3(1e-4f))));
+			TEST_CHECK(glm::all(glm::lessThan(glm::abs(bound_max - skinned_max), glm::vec3(1e-4f))));
+		}
+	});
+
+	test::run("Random rigs", [] {
+		for (int rig = 0; rig < 30; rig++)
+		{
+			// Joint counts around the SIMD width
+			const auto joint_count = 1 + generator() % 40;
+			std::vector<uint32_t> parents = {0};
+			for (uint32_t joint = 1; joint < joint_count; joint++)
+				parents.push_back(uint32_t(generator() % joint));
+
+			const auto bind_pose = make_bind_pose(parents);
+			const auto mesh = make_mesh(bind_pose, 500 + generator() % 2000, 4);
+			const auto bound =
+				graphics::SkinBound::build(mesh.positions, mesh.joint_indices, mesh.joint_weights);
+			if (!TEST_CHECK(bound.get_joint_count() <= joint_count)) continue;
+
+			for (int pose = 0; pose < 20; pose++)
+			{
+				// Rotated joints under a moving root
+				const glm::mat4 root = glm::rotate(
+					glm::translate(glm::mat4(1.0f), random_vec3() * 10.0f),
+					unit(generator) * 6.28f,
+					glm::normalize(random_vec3() + glm::vec3(0, 0.01f, 0))
+				);
+
+				std::vector<glm::mat4> world(joint_count), joint_matrices;
+				for (uint32_t joint = 0; joint < joint_count; joint++)
+				{
+					const auto& parent_bind = bind_pose[parents[joint]];
+					const glm::mat4 bind_local =
+						joint == 0 ? glm::mat4(1.0f) : glm::inverse(parent_bind) * bind_pose[joint];
+					const glm::mat4 local = glm::rotate(
+						bind_local,
+						(unit(generator) - 0.5f) * 2.0f,
+						glm::normalize(random_vec3() + glm::vec3(0.01f, 0, 0))
+					);
+					world[joint] = (joint == 0 ? root : world[parents[joint]]) * local;
+					joint_matrices.push_back(world[joint] * glm::inverse(bind_pose[joint]));
+				}
+
+				const auto world_bound = bound.compute_world_bound(joint_matrices);
+				for (size_t vertex = 0; vertex < mesh.positions.size(); vertex++)
+					TEST_CHECK(bound_contains(world_bound, skin_vertex(mesh, vertex, joint_matrices)));
+			}
+		}
+	});
+
+	return test::finish();
+}
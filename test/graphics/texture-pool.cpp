@@ -0,0 +1,366 @@
+// Buckets, reuse, eviction and resize hysteresis of `graphics::TexturePool`, against a mock device
+
+#include "graphics/util/texture-pool.hpp"
+#include "test/check.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{97};
+
+	struct MockLog
+	{
+		uint32_t created = 0;
+		bool fail = false;
+		std::vector<uint32_t> destroyed;
+	};
+
+	struct MockTexture
+	{
+		uint32_t id;
+		glm::u32vec2 size;
+		uint32_t mip_levels;
+		std::string name;
+		MockLog* log;
+	};
+
+	// Creates numbered textures, evicted textures are destroyed when the deletion queue releases them
+	class MockDevice
+	{
+	  public:
+
+		using Texture = std::unique_ptr<MockTexture>;
+
+		explicit MockDevice(MockLog& log) noexcept :
+			log(&log)
+		{}
+
+		std::expected<Texture, util::Error> create(
+			const gpu::Texture::Format& format [[maybe_unused]],
+			glm::u32vec2 size,
+			uint32_t mip_levels,
+			const std::string& name
+		) const noexcept
+		{
+			if (log->fail) return util::Error("Out of memory");
+
+			return std::make_unique<MockTexture>(MockTexture{
+				.id = log->created++,
+				.size = size,
+				.mip_levels = mip_levels,
+				.name = name,
+				.log = log
+			});
+		}
+
+		void set_name(const Texture& texture, const std::string& name) const noexcept
+		{
+			texture->name = name;
+		}
+
+		static bool is_empty(const Texture& texture) noexcept { return texture == nullptr; }
+
+		static void release(gpu::DeletionQueue& deletion_queue, Texture texture, uint64_t bytes) noexcept
+		{
+			deletion_queue.release(
+				[texture = std::move(texture)] { texture->log->destroyed.push_back(texture->id); },
+				bytes
+			);
+		}
+
+	  private:
+
+		MockLog* log;
+	};
+
+	using Pool = graphics::BasicTexturePool<MockDevice>;
+
+	const gpu::Texture::Format color_format = {
+		.type = SDL_GPU_TEXTURETYPE_2D,
+		.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+		.usage = {.sampler = true, .color_target = true}
+	};
+
+	const gpu::Texture::Format storage_format = {
+		.type = SDL_GPU_TEXTURETYPE_2D,
+		.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+		.usage = {.sampler = true, .compute_storage_write = true}
+	};
+
+	// Complete every submission, releasing the textures evicted so far
+	void complete(gpu::DeletionQueue& deletion_queue) noexcept
+	{
+		deletion_queue.submit([] { return true; });
+		deletion_queue.collect();
+	}
+}
+
+int main()
+{
+	test::run("Buckets", [] {
+		MockLog log;
+		const Pool pool(MockDevice(log), {.size_granularity = 64});
+		TEST_CHECK(pool.get_bucket({100, 50}) == glm::u32vec2(128, 64));
+		TEST_CHECK(pool.get_bucket({128, 64}) == glm::u32vec2(128, 64));
+		TEST_CHECK(pool.get_bucket({1, 129}) == glm::u32vec2(64, 192));
+
+		// Granularity 0 behaves as 1, exact sizes
+		for (const uint32_t granularity : {0u, 1u})
+		{
+			const Pool exact(MockDevice(log), {.size_granularity = granularity});
+			TEST_CHECK(exact.get_bucket({101, 53}) == glm::u32vec2(101, 53));
+		}
+
+		for (int sample = 0; sample < 1000; sample++)
+		{
+			const uint32_t granularity = 1 + generator() % 256;
+			const glm::u32vec2 size = {1 + generator() % 4096, 1 + generator() % 4096};
+			const auto bucket = Pool(MockDevice(log), {.size_granularity = granularity}).get_bucket(size);
+
+			// Smallest multiple covering the size
+			TEST_CHECK(bucket.x % granularity == 0 && bucket.y % granularity == 0);
+			TEST_CHECK(glm::all(glm::greaterThanEqual(bucket, size)));
+			TEST_CHECK(glm::all(glm::lessThan(bucket - size, glm::u32vec2(granularity))));
+		}
+	});
+
+	test::run("Reuse", [] {
+		MockLog log;
+		Pool pool(MockDevice(log), {.size_granularity = 64});
+		const uint64_t bucket_bytes = color_format.get_size(128, 64);
+
+		// Created with the size of its bucket
+		auto first = pool.acquire(color_format, {100, 50}, 1, "first");
+		if (!TEST_CHECK(first.has_value())) return;
+		TEST_CHECK((*first)->size == glm::u32vec2(128, 64) && (*first)->name == "first");
+		TEST_CHECK(pool.get_stats().misses == 1 && pool.get_stats().live_bytes == bucket_bytes);
+
+		// Another size of the same bucket reuses it, renamed
+		const uint32_t first_id = (*first)->id;
+		pool.release(std::move(*first), color_format, {100, 50}, 1);
+		TEST_CHECK(pool.get_stats().idle_textures == 1 && pool.get_stats().idle_bytes == bucket_bytes);
+
+		auto reused = pool.acquire(color_format, {120, 60}, 1, "reused");
+		if (!TEST_CHECK(reused.has_value())) return;
+		TEST_CHECK((*reused)->id == first_id && (*reused)->name == "reused");
+		TEST_CHECK(pool.get_stats().hits == 1 && pool.get_stats().idle_textures == 0);
+
+		// Other usages, mip levels and buckets do not share it
+		pool.release(std::move(*reused), color_format, {120, 60}, 1);
+		const auto storage = pool.acquire(storage_format, {100, 50}, 1, "storage");
+		const auto mipmapped = pool.acquire(color_format, {100, 50}, 2, "mipmapped");
+		const auto larger = pool.acquire(color_format, {129, 50}, 1, "larger");
+		if (!TEST_CHECK(storage && mipmapped && larger)) return;
+		TEST_CHECK((*storage)->id != first_id && (*mipmapped)->id != first_id && (*larger)->id != first_id);
+		TEST_CHECK(pool.get_stats().misses == 4 && pool.get_stats().idle_textures == 1);
+
+		// The most recently released texture of a key is reused first
+		auto second = pool.acquire(color_format, {100, 50}, 1, "second");
+		auto third = pool.acquire(color_format, {100, 50}, 1, "third");
+		if (!TEST_CHECK(second && third)) return;
+		const uint32_t third_id = (*third)->id;
+		pool.release(std::move(*second), color_format, {100, 50}, 1);
+		pool.release(std::move(*third), color_format, {100, 50}, 1);
+		const auto last = pool.acquire(color_format, {100, 50}, 1, "last");
+		TEST_CHECK(last && (*last)->id == third_id);
+
+		// Empty textures are ignored
+		const auto stats = pool.get_stats();
+		pool.release(nullptr, color_format, {100, 50}, 1);
+		TEST_CHECK(pool.get_stats().idle_textures == stats.idle_textures);
+		TEST_CHECK(pool.get_stats().live_textures == stats.live_textures);
+
+		// Failed creation leaves the pool untouched
+		log.fail = true;
+		TEST_CHECK(!pool.acquire(color_format, {512, 512}, 1, "failed").has_value());
+		TEST_CHECK(pool.get_stats().misses == stats.misses);
+		TEST_CHECK(pool.get_stats().live_bytes == stats.live_bytes);
+	});
+
+	test::run("Idle expiry", [] {
+		MockLog log;
+		Pool pool(MockDevice(log), {.size_granularity = 1, .max_idle_frames = 3});
+		gpu::DeletionQueue deletion_queue;
+
+		auto kept = pool.acquire(color_format, {64, 64}, 1, "kept");
+		auto expiring = pool.acquire(color_format, {32, 32}, 1, "expiring");
+		if (!TEST_CHECK(kept && expiring)) return;
+		const uint32_t expiring_id = (*expiring)->id;
+
+		pool.release(std::move(*expiring), color_format, {32, 32}, 1);
+		for (int frame = 0; frame < 3; frame++)
+		{
+			pool.collect(deletion_queue);
+			TEST_CHECK(pool.get_stats().idle_textures == 1 && pool.get_stats().evictions == 0);
+		}
+
+		// Evicted after `max_idle_frames` frames, destroyed through the deletion queue only
+		pool.collect(deletion_queue);
+		TEST_CHECK(pool.get_stats().idle_textures == 0 && pool.get_stats().evictions == 1);
+		TEST_CHECK(log.destroyed.empty() && deletion_queue.get_stats().pending_resources == 1);
+
+		complete(deletion_queue);
+		TEST_CHECK(std::ranges::equal(log.destroyed, std::array{expiring_id}));
+
+		// Reuse restarts the idle time
+		pool.release(std::move(*kept), color_format, {64, 64}, 1);
+		for (int frame = 0; frame < 20; frame++)
+		{
+			pool.collect(deletion_queue);
+
+			auto texture = pool.acquire(color_format, {64, 64}, 1, "kept");
+			if (!TEST_CHECK(texture.has_value())) return;
+			pool.release(std::move(*texture), color_format, {64, 64}, 1);
+		}
+
+		TEST_CHECK(pool.get_stats().evictions == 1 && pool.get_stats().misses == 2);
+	});
+
+	test::run("Budget", [] {
+		MockLog log;
+		const uint64_t bytes = color_format.get_size(64, 64);
+		Pool pool(
+			MockDevice(log),
+			{.size_granularity = 1, .budget_bytes = bytes * 8, .max_idle_frames = 1000}
+		);
+		gpu::DeletionQueue deletion_queue;
+
+		// Keys of equal memory size
+		struct Key
+		{
+			const gpu::Texture::Format* format;
+			glm::u32vec2 size;
+		};
+
+		const std::array<Key, 3> keys = {
+			Key{.format = &color_format, .size = {64, 64}},
+			Key{.format = &storage_format, .size = {64, 64}},
+			Key{.format = &color_format, .size = {32, 128}}
+		};
+
+		std::vector<std::pair<Pool::Texture, Key>> textures;
+		for (uint32_t index = 0; index < 6; index++)
+		{
+			const auto key = keys[index % keys.size()];
+			auto texture = pool.acquire(*key.format, key.size, 1, "idle");
+			if (!TEST_CHECK(texture.has_value())) return;
+			textures.emplace_back(std::move(*texture), key);
+		}
+
+		// Released over several frames in a shuffled order, within budget
+		std::ranges::shuffle(textures, generator);
+		std::vector<uint32_t> release_order;
+		for (auto& [texture, key] : textures)
+		{
+			release_order.push_back(texture->id);
+			pool.release(std::move(texture), *key.format, key.size, 1);
+			pool.collect(deletion_queue);
+		}
+		TEST_CHECK(pool.get_stats().idle_textures == 6 && pool.get_stats().evictions == 0);
+
+		// New live textures push the pool over budget, the least recently released idle ones are evicted
+		std::vector<Pool::Texture> live;
+		for (uint32_t count = 1; count <= 10; count++)
+		{
+			auto texture = pool.acquire(color_format, {16, 256}, 1, "live");
+			if (!TEST_CHECK(texture.has_value())) return;
+			live.push_back(std::move(*texture));
+
+			pool.collect(deletion_queue);
+			complete(deletion_queue);
+
+			const size_t evicted = std::clamp<size_t>(count, 2, 8) - 2;
+			TEST_CHECK(pool.get_stats().evictions == evicted);
+			TEST_CHECK(std::ranges::equal(log.destroyed, release_order | std::views::take(evicted)));
+		}
+
+		// Live textures alone exceed the budget, they are never evicted
+		TEST_CHECK(pool.get_stats().live_textures == 10 && pool.get_stats().idle_textures == 0);
+		TEST_CHECK(pool.get_stats().live_bytes == bytes * 10 && pool.get_stats().idle_bytes == 0);
+	});
+
+	test::run("Resize hysteresis", [] {
+		graphics::ResizeHysteresis hysteresis(4);
+		TEST_CHECK(hysteresis.get_size() == glm::u32vec2(0));
+
+		// The first size is committed immediately
+		TEST_CHECK(hysteresis.update({1280, 720}) == glm::u32vec2(1280, 720));
+		TEST_CHECK(!hysteresis.is_pending());
+
+		// Sizes changing every frame are never committed
+		for (uint32_t frame = 0; frame < 30; frame++)
+		{
+			TEST_CHECK(hysteresis.update({1300 + frame * 7, 700 + frame * 3}) == glm::u32vec2(1280, 720));
+			TEST_CHECK(hysteresis.is_pending());
+		}
+
+		// A stable size is committed on its `stable_frames`th frame
+		for (int frame = 0; frame < 3; frame++)
+			TEST_CHECK(hysteresis.update({1600, 900}) == glm::u32vec2(1280, 720));
+		TEST_CHECK(hysteresis.update({1600, 900}) == glm::u32vec2(1600, 900));
+		TEST_CHECK(!hysteresis.is_pending());
+
+		// Going back to the committed size cancels the pending one
+		hysteresis.update({800, 600});
+		hysteresis.update({800, 600});
+		hysteresis.update({1600, 900});
+		TEST_CHECK(!hysteresis.is_pending());
+		for (int frame = 0; frame < 3; frame++) hysteresis.update({800, 600});
+		TEST_CHECK(hysteresis.get_size() == glm::u32vec2(1600, 900));
+		hysteresis.update({800, 600});
+		TEST_CHECK(hysteresis.get_size() == glm::u32vec2(800, 600));
+
+		// With one stable frame, every size is committed
+		graphics::ResizeHysteresis immediate(1);
+		immediate.update({640, 480});
+		TEST_CHECK(immediate.update({641, 480}) == glm::u32vec2(641, 480));
+	});
+
+	test::run("Interactive resize", [] {
+		// Targets follow the committed size, as the renderer does
+		const auto run = [](uint32_t stable_frames) {
+			MockLog log;
+			Pool pool(MockDevice(log), {.size_granularity = 64});
+			graphics::ResizeHysteresis hysteresis(stable_frames);
+			gpu::DeletionQueue deletion_queue;
+
+			glm::u32vec2 size = {0, 0};
+			Pool::Texture target;
+
+			for (uint32_t frame = 0; frame < 200; frame++)
+			{
+				// Dragged for 120 frames, then released
+				const glm::u32vec2 requested =
+					frame < 120 ? glm::u32vec2(1000 + frame * 5, 600 + frame * 2) : glm::u32vec2(1600, 840);
+				const auto committed = hysteresis.update(requested);
+
+				if (committed != size)
+				{
+					auto texture = pool.acquire(color_format, committed, 1, "target");
+					if (!texture) return pool.get_stats();
+					pool.release(std::move(target), color_format, size, 1);
+					target = std::move(*texture);
+					size = committed;
+				}
+
+				pool.collect(deletion_queue);
+				complete(deletion_queue);
+			}
+
+			return pool.get_stats();
+		};
+
+		// Created for the first and the final size only
+		const auto delayed = run(8);
+		TEST_CHECK(delayed.misses == 2 && delayed.hits == 0);
+
+		// Without hysteresis, one texture per bucket crossed
+		const auto immediate = run(1);
+		TEST_CHECK(immediate.misses > 10);
+	});
+
+	return test::finish();
+}
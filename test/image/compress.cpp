@@ -0,0 +1,373 @@
+// BC1/BC4 encoders checked by decoding their blocks back, and compress mode selection of color images
+
+#include "gltf/image.hpp"
+#include "image/algo/analyze.hpp"
+#include "image/compress.hpp"
+#include "test/check.hpp"
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <variant>
+
+namespace
+{
+	using Rgba8_image = image::Image<image::Precision::U8, image::Format::RGBA>;
+
+	template <typename F>
+	Rgba8_image make_image(glm::u32vec2 size, F pixel_at) noexcept
+	{
+		Rgba8_image result{.size = size, .pixels = std::vector<glm::u8vec4>(size_t(size.x) * size.y)};
+
+		for (uint32_t y = 0; y < size.y; y++)
+			for (uint32_t x = 0; x < size.x; x++) result[x, y] = pixel_at(x, y);
+
+		return result;
+	}
+
+	// Colors along a line in RGB, which BC1 endpoints can represent
+	Rgba8_image gradient_image(glm::u32vec2 size) noexcept
+	{
+		const glm::vec3 start = {20.0f, 200.0f, 90.0f};
+		const glm::vec3 end = {240.0f, 60.0f, 160.0f};
+
+		return make_image(size, [=](uint32_t x, uint32_t y) {
+			const float t = float(x + y) / float(std::max(size.x + size.y - 2, 1u));
+			return glm::u8vec4(glm::round(glm::mix(start, end, t)), 255);
+		});
+	}
+
+	Rgba8_image noise_image(glm::u32vec2 size) noexcept
+	{
+		std::mt19937 generator{7};
+		return make_image(size, [&generator](uint32_t, uint32_t) {
+			return glm::u8vec4(generator() % 256, generator() % 256, generator() % 256, 255);
+		});
+	}
+
+	// Largest error of one channel between two images of the same size
+	int max_error(const Rgba8_image& a, const Rgba8_image& b, int channel) noexcept
+	{
+		int result = 0;
+		for (const auto [pixel_a, pixel_b] : std::views::zip(a.pixels, b.pixels))
+			result = std::max(result, std::abs(int(pixel_a[channel]) - int(pixel_b[channel])));
+		return result;
+	}
+
+	// Range of the R channel in the 4x4 block containing a pixel, edge blocks are clamped to the image
+	int block_range(const Rgba8_image& image, uint32_t x, uint32_t y) noexcept
+	{
+		const uint32_t block_x = x / 4 * 4;
+		const uint32_t block_y = y / 4 * 4;
+
+		int min_value = 255;
+		int max_value = 0;
+		for (uint32_t by = block_y; by < std::min(block_y + 4, image.size.y); by++)
+			for (uint32_t bx = block_x; bx < std::min(block_x + 4, image.size.x); bx++)
+			{
+				min_value = std::min(min_value, int(image[bx, by].r));
+				max_value = std::max(max_value, int(image[bx, by].r));
+			}
+
+		return max_value - min_value;
+	}
+
+	// Two values per 4x4 block in a checker, different in every block: exact in BC4 and BC5
+	Rgba8_image block_checker_image(glm::u32vec2 size) noexcept
+	{
+		return make_image(size, [](uint32_t x, uint32_t y) {
+			const uint32_t block = x / 4 + y / 4 * 4;
+			const uint8_t low = uint8_t(10 + block * 12), high = uint8_t(245 - block * 9);
+			const uint8_t value = (x + y) % 2 == 0 ? low : high;
+			return glm::u8vec4(value, 255 - value, value, 255);
+		});
+	}
+
+	// Decode a compressed image with its size rounded up to whole blocks, exposing the padded texels
+	template <typename Block>
+	auto decode_padded(image::ImageContainer<Block> compressed, const auto& decode) noexcept
+	{
+		compressed.size = (compressed.size + 3u) / 4u * 4u;
+		return decode(compressed);
+	}
+
+	using Mode = gltf::ColorCompressMode;
+
+	constexpr glm::bvec4 rgb_used = {true, true, true, false};
+	constexpr glm::bvec4 rgba_used = {true, true, true, true};
+
+	// Smooth grayscale gradient, BC4 keeps it within a level of the source
+	Rgba8_image gray_image(glm::u32vec2 size, uint8_t alpha = 255) noexcept
+	{
+		return make_image(size, [alpha](uint32_t x, uint32_t y) {
+			const uint8_t value = uint8_t((x * 2 + y * 3) % 256);
+			return glm::u8vec4(value, value, value, alpha);
+		});
+	}
+
+	// R and G alternate between two values in every block, off any line of RGB colors: BC4 channels are
+	// exact, BC1 is not
+	Rgba8_image checker_rg_image(glm::u32vec2 size, uint8_t blue) noexcept
+	{
+		return make_image(size, [blue](uint32_t x, uint32_t y) {
+			return glm::u8vec4(x % 2 == 0 ? 20 : 220, y % 2 == 0 ? 50 : 200, blue, 255);
+		});
+	}
+
+	std::expected<Mode, util::Error> select(
+		const Rgba8_image& source,
+		glm::bvec4 used_channels,
+		bool srgb,
+		float min_psnr,
+		Mode fallback = Mode::RGBA8_BC7
+	) noexcept
+	{
+		return gltf::select_color_compress_mode(source, used_channels, srgb, fallback, min_psnr)
+			.transform([](const gltf::ColorCompressSelection& selection) { return selection.mode; });
+	}
+}
+
+int main()
+{
+	test::run("analyze_channels", [] {
+		const auto gray = make_image({8, 8}, [](uint32_t x, uint32_t y) {
+			return glm::u8vec4(x * 16 + y, x * 16 + y, x * 16 + y, 255);
+		});
+		const auto gray_analysis = image::analyze_channels(gray);
+		TEST_CHECK(gray_analysis.grayscale);
+		TEST_CHECK(gray_analysis.opaque());
+		TEST_CHECK(gray_analysis.constant() == glm::bvec4(false, false, false, true));
+
+		const auto color_analysis = image::analyze_channels(gradient_image({8, 8}));
+		TEST_CHECK(!color_analysis.grayscale);
+		TEST_CHECK(color_analysis.min_value.r == 20 && color_analysis.max_value.r == 240);
+	});
+
+	test::run("compute_psnr", [] {
+		const auto reference = gradient_image({16, 16});
+
+		const auto identical = image::compute_psnr(reference, reference, glm::bvec4(true));
+		TEST_CHECK(identical.has_value() && std::isinf(*identical));
+
+		// A uniform error of 1 on RGB is 20 * log10(255) ~ 48.13 dB
+		const auto off_by_one = make_image(reference.size, [&reference](uint32_t x, uint32_t y) {
+			const auto pixel = reference[x, y];
+			return glm::u8vec4(pixel.r ^ 1, pixel.g ^ 1, pixel.b ^ 1, pixel.a);
+		});
+		const auto psnr = image::compute_psnr(reference, off_by_one, glm::bvec4(true, true, true, false));
+		TEST_CHECK(psnr.has_value() && std::abs(*psnr - 48.13f) < 0.01f);
+
+		TEST_CHECK(!image::compute_psnr(reference, reference, glm::bvec4(false)).has_value());
+		TEST_CHECK(!image::compute_psnr(reference, gradient_image({8, 8}), glm::bvec4(true)).has_value());
+	});
+
+	test::run("BC1 error bounds", [] {
+		for (const auto size : {glm::u32vec2(64, 64), glm::u32vec2(37, 21)})
+		{
+			const auto source = gradient_image(size);
+
+			const auto compressed = image::compress_to_bc1(source);
+			if (!TEST_CHECK(compressed.has_value())) continue;
+			TEST_CHECK(compressed->size == size);
+			TEST_CHECK(compressed->pixels.size() == size_t((size.x + 3) / 4) * ((size.y + 3) / 4));
+
+			const auto decoded = image::decode_bc1(*compressed);
+			if (!TEST_CHECK(decoded.has_value() && decoded->size == size)) continue;
+
+			// Blocks of a smooth gradient are within RGB565 precision of their interpolated palette
+			const auto psnr = image::compute_psnr(source, *decoded, glm::bvec4(true, true, true, false));
+			TEST_CHECK(psnr.has_value() && *psnr >= 36.0f);
+			for (const int channel : {0, 1, 2}) TEST_CHECK(max_error(source, *decoded, channel) <= 10);
+			TEST_CHECK(max_error(source, *decoded, 3) == 0);
+		}
+
+		// A single color is matched within RGB565 precision
+		const auto flat = make_image({13, 9}, [](uint32_t, uint32_t) {
+			return glm::u8vec4(200, 37, 90, 255);
+		});
+		const auto flat_decoded = image::compress_to_bc1(flat).and_then(image::decode_bc1);
+		if (TEST_CHECK(flat_decoded.has_value()))
+			for (const int channel : {0, 1, 2}) TEST_CHECK(max_error(flat, *flat_decoded, channel) <= 4);
+
+		// Noise has no bound but still round-trips in size
+		const auto noise = noise_image({16, 16});
+		const auto noise_decoded = image::compress_to_bc1(noise).and_then(image::decode_bc1);
+		TEST_CHECK(noise_decoded.has_value() && noise_decoded->size == noise.size);
+	});
+
+	test::run("BC4 error bounds", [] {
+		for (const auto& source : {gradient_image({64, 64}), noise_image({32, 32}), gradient_image({11, 6})})
+		{
+			const auto compressed = image::compress_to_bc4(source);
+			if (!TEST_CHECK(compressed.has_value())) continue;
+			TEST_CHECK(
+				compressed->pixels.size() == size_t((source.size.x + 3) / 4) * ((source.size.y + 3) / 4)
+			);
+
+			const auto decoded = image::decode_bc4(*compressed);
+			if (!TEST_CHECK(decoded.has_value() && decoded->size == source.size)) continue;
+
+			// 8 levels between the block extremes, the error is a fraction of the block range
+			for (uint32_t y = 0; y < source.size.y; y++)
+				for (uint32_t x = 0; x < source.size.x; x++)
+				{
+					const auto pixel = (*decoded)[x, y];
+					const int error = std::abs(int(source[x, y].r) - int(pixel.r));
+					TEST_CHECK(error <= block_range(source, x, y) / 14 + 2);
+					TEST_CHECK(pixel.g == 0 && pixel.b == 0 && pixel.a == 255);
+				}
+		}
+	});
+
+	test::run("Padded blocks", [] {
+		// Padded in x, in y, in both, and a single texel
+		const std::array sizes = {
+			glm::u32vec2(5, 4),
+			glm::u32vec2(4, 3),
+			glm::u32vec2(5, 3),
+			glm::u32vec2(9, 7),
+			glm::u32vec2(1, 1)
+		};
+
+		for (const auto size : sizes)
+		{
+			const auto source = block_checker_image(size);
+			const auto padded_size = (size + 3u) / 4u * 4u;
+
+			// Compare the first `channels` channels, decoded at the image size and at the padded size
+			const auto check = [&](const auto& decoded, const auto& padded, int channels, int tolerance) {
+				if (!TEST_CHECK(decoded.has_value() && padded.has_value())) return;
+				if (!TEST_CHECK(decoded->size == size && padded->size == padded_size)) return;
+
+				for (uint32_t y = 0; y < padded_size.y; y++)
+					for (uint32_t x = 0; x < padded_size.x; x++)
+					{
+						const uint32_t edge_x = std::min(x, size.x - 1), edge_y = std::min(y, size.y - 1);
+
+						// Padded texels replicate the nearest edge texel, so they share its block index
+						const auto padded_pixel = (*padded)[x, y];
+						const auto edge_pixel = (*padded)[edge_x, edge_y];
+						TEST_CHECK(padded_pixel == edge_pixel);
+						if (x != edge_x || y != edge_y) continue;
+
+						// Valid texels hold the source, whatever the decoded size
+						const auto pixel = (*decoded)[x, y];
+						const auto source_pixel = source[x, y];
+						TEST_CHECK(pixel == padded_pixel);
+						for (int channel = 0; channel < channels; channel++)
+						{
+							const int error = std::abs(int(source_pixel[channel]) - int(pixel[channel]));
+							TEST_CHECK(error <= tolerance);
+						}
+					}
+			};
+
+			const auto bc1 = image::compress_to_bc1(source);
+			const auto bc4 = image::compress_to_bc4(source);
+			const auto bc5 = image::compress_to_bc5(source);
+			if (!TEST_CHECK(bc1.has_value() && bc4.has_value() && bc5.has_value())) continue;
+
+			check(image::decode_bc1(*bc1), decode_padded(*bc1, image::decode_bc1), 3, 8);
+			check(image::decode_bc4(*bc4), decode_padded(*bc4, image::decode_bc4), 1, 0);
+			check(image::decode_bc5(*bc5), decode_padded(*bc5, image::decode_bc5), 2, 0);
+		}
+	});
+
+	test::run("Compress mode selection", [] {
+		// Grayscale without alpha is a single channel
+		const auto gray = gray_image({32, 32});
+		TEST_CHECK(select(gray, rgb_used, false, 40.0f) == Mode::R8_BC4);
+		TEST_CHECK(select(gray, rgba_used, false, 40.0f) == Mode::R8_BC4);
+
+		// The evaluated base level is kept for the texture
+		const auto gray_selection =
+			gltf::select_color_compress_mode(gray, rgb_used, false, Mode::RGBA8_BC7, 40.0f);
+		if (TEST_CHECK(gray_selection.has_value()))
+		{
+			const auto* base_level = std::get_if<image::BCImage4bpp>(&gray_selection->base_level);
+			TEST_CHECK(base_level != nullptr && base_level->size == gray.size);
+		}
+
+		// Opaque color, BC1 when it reaches the PSNR, the fallback otherwise
+		const auto color = gradient_image({64, 64});
+		TEST_CHECK(select(color, rgb_used, false, 35.0f) == Mode::RGB8_BC1);
+		TEST_CHECK(select(color, rgba_used, true, 35.0f) == Mode::RGB8_BC1);
+		TEST_CHECK(select(color, rgb_used, false, 80.0f) == Mode::RGBA8_BC7);
+
+		// Alpha that is read and varies keeps the fallback, unread alpha is dropped
+		const auto translucent = make_image({32, 32}, [](uint32_t x, uint32_t y) {
+			const uint8_t value = uint8_t(x * 2 + y * 3);
+			return glm::u8vec4(value, value, value, uint8_t(x * 8));
+		});
+		const auto translucent_selection =
+			gltf::select_color_compress_mode(translucent, rgba_used, false, Mode::RGBA8_BC3, 20.0f);
+		if (TEST_CHECK(translucent_selection.has_value()))
+		{
+			TEST_CHECK(translucent_selection->mode == Mode::RGBA8_BC3);
+			TEST_CHECK(std::holds_alternative<std::monostate>(translucent_selection->base_level));
+		}
+		TEST_CHECK(select(translucent, rgb_used, false, 40.0f) == Mode::R8_BC4);
+
+		// Constant alpha below 255 is lost by BC1 and BC4 too
+		const auto half_transparent = gray_image({32, 32}, 128);
+		TEST_CHECK(select(half_transparent, rgba_used, false, 20.0f) == Mode::RGBA8_BC7);
+		TEST_CHECK(select(half_transparent, rgb_used, false, 40.0f) == Mode::R8_BC4);
+
+		// Raw fallback is never replaced
+		TEST_CHECK(select(gray, rgb_used, false, 0.0f, Mode::RGBA8_raw) == Mode::RGBA8_raw);
+
+		// Unread G and B make any image single channel
+		TEST_CHECK(select(color, {true, false, false, false}, false, 40.0f) == Mode::R8_BC4);
+	});
+
+	test::run("Constant channels", [] {
+		// A constant gray image is exact in BC4
+		const auto flat = make_image({16, 16}, [](uint32_t, uint32_t) {
+			return glm::u8vec4(77, 77, 77, 255);
+		});
+		TEST_CHECK(select(flat, rgb_used, false, 100.0f) == Mode::R8_BC4);
+
+		// B constantly 0 is decoded exactly by BC5, which then keeps R and G exact where BC1 can't
+		const auto zero_blue = checker_rg_image({16, 16}, 0);
+		TEST_CHECK(select(zero_blue, rgb_used, false, 100.0f) == Mode::RG8_BC5);
+
+		const auto zero_blue_selection =
+			gltf::select_color_compress_mode(zero_blue, rgb_used, false, Mode::RGBA8_BC7, 100.0f);
+		if (TEST_CHECK(zero_blue_selection.has_value()))
+			TEST_CHECK(std::holds_alternative<image::BCImage>(zero_blue_selection->base_level));
+
+		// B constant but not 0 is lost by BC5, unless B is unread
+		const auto gray_blue = checker_rg_image({16, 16}, 128);
+		TEST_CHECK(select(gray_blue, rgb_used, false, 100.0f) == Mode::RGBA8_BC7);
+		TEST_CHECK(select(gray_blue, {true, true, false, false}, false, 100.0f) == Mode::RG8_BC5);
+	});
+
+	test::run("sRGB selection", [] {
+		// BC4 and BC5 are linear only, sRGB images take BC1 or the fallback
+		const auto gray = gray_image({32, 32});
+		TEST_CHECK(select(gray, rgb_used, true, 30.0f) == Mode::RGB8_BC1);
+		TEST_CHECK(select(checker_rg_image({16, 16}, 0), rgb_used, true, 100.0f) == Mode::RGBA8_BC7);
+
+		std::mt19937 generator{107};
+		const std::array<Rgba8_image, 5> images = {
+			gray,
+			gradient_image({24, 16}),
+			checker_rg_image({16, 16}, 0),
+			checker_rg_image({16, 16}, 128),
+			noise_image({16, 16})
+		};
+
+		for (int sample = 0; sample < 100; sample++)
+		{
+			const auto& source = images[generator() % images.size()];
+			const glm::bvec4 used(generator() % 2, generator() % 2, generator() % 2, generator() % 2);
+			const float min_psnr = float(generator() % 60);
+
+			const auto mode = select(source, used, true, min_psnr);
+			if (!TEST_CHECK(mode.has_value())) continue;
+			TEST_CHECK(*mode != Mode::R8_BC4 && *mode != Mode::RG8_BC5);
+		}
+	});
+
+	return test::finish();
+}
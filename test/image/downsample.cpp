@@ -0,0 +1,92 @@
+// SIMD 2x2 downsample kernels against the scalar `ImageContainer::shrink_half`
+
+#include "image/algo/colorspace.hpp"
+#include "image/algo/downsample.hpp"
+#include "test/check.hpp"
+
+#include <cstring>
+#include <random>
+
+namespace
+{
+	constexpr auto widths = std::to_array<uint32_t>({1, 2, 3, 7, 8, 15, 16, 17, 33, 64, 129, 200});
+	constexpr auto heights = std::to_array<uint32_t>({1, 2, 5, 16});
+
+	std::mt19937 generator{1};
+
+	template <typename T>
+	image::ImageContainer<T> random_image(glm::u32vec2 size) noexcept
+	{
+		using Comp = typename T::value_type;
+		constexpr glm::length_t len = sizeof(T) / sizeof(Comp);
+
+		image::ImageContainer<T> result{.size = size, .pixels = std::vector<T>(size_t(size.x) * size.y)};
+
+		for (auto& pixel : result.pixels)
+			for (glm::length_t channel = 0; channel < len; channel++)
+			{
+				if constexpr (std::is_floating_point_v<Comp>)
+					pixel[channel] = std::uniform_real_distribution<Comp>(-10.0f, 10.0f)(generator);
+				else
+					pixel[channel] = Comp(generator());
+			}
+
+		return result;
+	}
+
+	// Bit-exact, the SIMD path must round like the scalar path
+	template <typename T>
+	bool same_pixels(const image::ImageContainer<T>& a, const image::ImageContainer<T>& b) noexcept
+	{
+		return a.size == b.size
+			&& std::memcmp(a.pixels.data(), b.pixels.data(), a.pixels.size() * sizeof(T)) == 0;
+	}
+
+	template <typename T>
+	void check_downsample() noexcept
+	{
+		for (const auto width : widths)
+			for (const auto height : heights)
+			{
+				const auto source = random_image<T>({width, height});
+				TEST_CHECK(same_pixels(image::downsample_half(source), source.shrink_half()));
+			}
+	}
+
+	template <typename Comp>
+	void check_channels() noexcept
+	{
+		check_downsample<glm::vec<1, Comp>>();
+		check_downsample<glm::vec<2, Comp>>();
+		check_downsample<glm::vec<3, Comp>>();
+		check_downsample<glm::vec<4, Comp>>();
+	}
+}
+
+int main()
+{
+	test::run("downsample_half u8", check_channels<uint8_t>);
+	test::run("downsample_half u16", check_channels<uint16_t>);
+	test::run("downsample_half f32", check_channels<float>);
+
+	test::run("downsample_half_to_ycbcr", [] {
+		for (const auto width : widths)
+			for (const auto height : heights)
+			{
+				const auto source = random_image<glm::u8vec4>({width, height});
+
+				image::ImageContainer<glm::vec4> ycbcr{.size = source.size, .pixels = {}};
+				for (const auto& pixel : source.pixels)
+					ycbcr.pixels.push_back(image::colorspace::rgba_to_ycbcr_alpha(glm::vec4(pixel) / 255.0f));
+
+				const image::Image<image::Precision::U8, image::Format::RGBA> rgba{
+					.size = source.size,
+					.pixels = source.pixels
+				};
+
+				TEST_CHECK(same_pixels(image::downsample_half_to_ycbcr(rgba), ycbcr.shrink_half()));
+			}
+	});
+
+	return test::finish();
+}
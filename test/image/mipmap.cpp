@@ -0,0 +1,143 @@
+// Mipmap chains of non-power-of-two images
+
+#include "image/algo/mipmap.hpp"
+#include "test/check.hpp"
+
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace
+{
+	constexpr auto sizes = std::to_array<glm::u32vec2>({
+		{1,    1  },
+		{3,    1  },
+		{5,    7  },
+		{6,    9  },
+		{100,  75 },
+		{129,  257},
+		{1000, 600}
+	});
+
+	glm::vec4 mean(const image::ImageContainer<glm::vec4>& image) noexcept
+	{
+		const auto sum = std::accumulate(image.pixels.begin(), image.pixels.end(), glm::vec4(0.0f));
+		return sum / float(image.pixels.size());
+	}
+
+	image::ImageContainer<glm::vec4> random_image(glm::u32vec2 size) noexcept
+	{
+		std::mt19937 generator{size.x * 4099 + size.y};
+		std::uniform_real_distribution<float> distribution{0.0f, 1.0f};
+
+		image::ImageContainer<glm::vec4> result{
+			.size = size,
+			.pixels = std::vector<glm::vec4>(size_t(size.x) * size.y)
+		};
+
+		for (auto& pixel : result.pixels)
+			pixel = glm::vec4(
+				distribution(generator),
+				distribution(generator),
+				distribution(generator),
+				distribution(generator)
+			);
+
+		return result;
+	}
+}
+
+int main()
+{
+	test::run("calc_mipmap_levels", [] {
+		TEST_CHECK(image::calc_mipmap_levels({1, 1}) == 1);
+		TEST_CHECK(image::calc_mipmap_levels({3, 1}) == 2);
+		TEST_CHECK(image::calc_mipmap_levels({5, 7}) == 3);
+		TEST_CHECK(image::calc_mipmap_levels({1000, 600}) == 10);
+		TEST_CHECK(image::calc_mipmap_levels({1024, 1024}) == 11);
+		TEST_CHECK(image::calc_mipmap_levels({1000, 600}, {4, 4}) == 8);
+		TEST_CHECK(image::calc_mipmap_levels({3, 3}, {4, 4}) == 1);
+	});
+
+	test::run("polyphase_taps", [] {
+		for (const uint32_t src_size : {1u, 2u, 3u, 7u, 8u, 33u, 257u})
+		{
+			const auto taps = image::polyphase_taps(src_size);
+			if (!TEST_CHECK(taps.size() == std::max(src_size / 2, 1u))) continue;
+
+			std::vector<float> contribution(src_size, 0.0f);
+			for (const auto& tap : taps)
+			{
+				TEST_CHECK(tap.count >= 1 && tap.count <= 3);
+				TEST_CHECK(tap.first + tap.count <= src_size);
+				TEST_CHECK(std::abs(tap.weights[0] + tap.weights[1] + tap.weights[2] - 1.0f) < 1e-6f);
+
+				for (uint32_t i = 0; i < tap.count; i++) contribution[tap.first + i] += tap.weights[i];
+			}
+
+			// Every source sample contributes equally, none is dropped at odd sizes
+			const float expected = float(taps.size()) / float(src_size);
+			for (const float weight : contribution) TEST_CHECK(std::abs(weight - expected) < 1e-5f);
+		}
+	});
+
+	test::run("generate_mipmap sizes and means", [] {
+		for (const auto size : sizes)
+		{
+			const auto base = random_image(size);
+			const auto chain = image::generate_mipmap(base);
+
+			if (!TEST_CHECK(chain.size() == image::calc_mipmap_levels(size))) continue;
+			TEST_CHECK(chain.back().size == glm::u32vec2(1));
+
+			for (size_t level = 1; level < chain.size(); level++)
+			{
+				const auto& prev = chain[level - 1];
+				const auto& current = chain[level];
+
+				TEST_CHECK(current.size == image::next_mip_size(prev.size));
+				TEST_CHECK(current.pixels.size() == size_t(current.size.x) * current.size.y);
+
+				// The polyphase filter keeps the mean, the box filter drops nothing at even sizes
+				const auto difference = glm::abs(mean(current) - mean(prev));
+				TEST_CHECK(glm::all(glm::lessThan(difference, glm::vec4(1e-4f))));
+			}
+		}
+	});
+
+	test::run("generate_mipmap constant image", [] {
+		const glm::vec4 color = {0.25f, 0.5f, 0.75f, 1.0f};
+		const image::ImageContainer<glm::vec4> base{
+			.size = {37, 11},
+			.pixels = std::vector<glm::vec4>(37 * 11, color)
+		};
+
+		for (const auto& level : image::generate_mipmap(base))
+			for (const auto& pixel : level.pixels)
+				TEST_CHECK(glm::all(glm::lessThan(glm::abs(pixel - color), glm::vec4(1e-5f))));
+	});
+
+	test::run("generate_perceptual_mipmap sizes", [] {
+		for (const auto size : sizes)
+		{
+			const image::Image<image::Precision::U8, image::Format::RGBA> base{
+				.size = size,
+				.pixels = std::vector<glm::u8vec4>(size_t(size.x) * size.y, glm::u8vec4(200, 100, 50, 255))
+			};
+			const auto chain = image::generate_perceptual_mipmap(base);
+
+			if (!TEST_CHECK(chain.size() == image::calc_mipmap_levels(size))) continue;
+			for (size_t level = 1; level < chain.size(); level++)
+				TEST_CHECK(chain[level].size == image::next_mip_size(chain[level - 1].size));
+
+			// A constant image stays within rounding of the YCbCr round trip
+			for (const auto& pixel : chain.back().pixels)
+			{
+				const auto difference = glm::abs(glm::ivec4(pixel) - glm::ivec4(200, 100, 50, 255));
+				TEST_CHECK(glm::all(glm::lessThanEqual(difference, glm::ivec4(1))));
+			}
+		}
+	});
+
+	return test::finish();
+}
@@ -0,0 +1,52 @@
+///
+/// @file bench.hpp
+/// @brief Provides a minimal timer for the benchmark executables
+///
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <print>
+#include <string_view>
+
+namespace test
+{
+	///
+	/// @brief Keep a value alive, so the computation producing it is not optimized out
+	///
+	template <typename T>
+	void keep(const T& value) noexcept
+	{
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+
+	///
+	/// @brief Time a function, printing the best time per iteration over several rounds
+	///
+	/// @param name Name of the benchmark
+	/// @param iterations Calls per round
+	/// @param body Benchmarked function
+	/// @return Best time per iteration, in nanoseconds
+	///
+	template <typename F>
+	double bench(std::string_view name, size_t iterations, F&& body) noexcept
+	{
+		constexpr size_t rounds = 5;
+
+		double best = std::numeric_limits<double>::max();
+		for (size_t round = 0; round < rounds; round++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < iterations; i++) body();
+			const auto end = std::chrono::steady_clock::now();
+
+			const double elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+			best = std::min(best, elapsed / double(iterations));
+		}
+
+		std::println("{:<48} {:>14.1f} ns", name, best);
+		return best;
+	}
+}
@@ -0,0 +1,70 @@
+///
+/// @file check.hpp
+/// @brief Provides minimal checks for the test executables
+///
+
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+#include <print>
+#include <source_location>
+#include <string_view>
+
+namespace test
+{
+	// Failed checks of the executable, turned into the exit code by `finish`
+	inline int failures = 0;
+
+	///
+	/// @brief Check a condition, printing the expression and its location on failure
+	///
+	/// @param condition Checked condition
+	/// @param expression Source text of the condition
+	/// @param location Location of the check
+	/// @return `condition`, to guard checks depending on it
+	///
+	inline bool check(
+		bool condition,
+		std::string_view expression,
+		const std::source_location& location = std::source_location::current()
+	) noexcept
+	{
+		if (!condition)
+		{
+			std::println(
+				std::cerr,
+				"\033[91m[Failed]\033[0m {} ({}:{})",
+				expression,
+				location.file_name(),
+				location.line()
+			);
+			failures++;
+		}
+
+		return condition;
+	}
+
+	///
+	/// @brief Run a test case, printing its name
+	///
+	/// @param name Name of the case
+	/// @param body Case body, using `TEST_CHECK`
+	///
+	template <typename F>
+	void run(std::string_view name, F&& body) noexcept
+	{
+		const int failures_before = failures;
+		body();
+		std::println("{} {}", failures == failures_before ? "[  OK  ]" : "[FAILED]", name);
+	}
+
+	// Get the exit code of the executable
+	inline int finish() noexcept
+	{
+		if (failures != 0) std::println(std::cerr, "{} check(s) failed", failures);
+		return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+}
+
+#define TEST_CHECK(expr) ::test::check(static_cast<bool>(expr), #expr)
@@ -0,0 +1,331 @@
+// Batches and commands of `render::drawdata::IndirectDraws`, replayed against the drawcall bins
+
+#include "render/drawdata/indirect.hpp"
+#include "render/drawdata/object.hpp"
+#include "test/check.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+namespace
+{
+	std::mt19937 generator{73};
+	std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+
+	using IndirectDraws = render::drawdata::IndirectDraws;
+
+	gltf::MaterialGPU make_material(gltf::AlphaMode alpha_mode, bool double_sided) noexcept
+	{
+		gltf::MaterialGPU material{};
+		material.params.pipeline = {.alpha_mode = alpha_mode, .double_sided = double_sided};
+		return material;
+	}
+
+	gltf::MaterialCache material_cache(
+		{make_material(gltf::AlphaMode::Opaque, false),
+		 make_material(gltf::AlphaMode::Opaque, false),
+		 make_material(gltf::AlphaMode::Mask, true)},
+		make_material(gltf::AlphaMode::Opaque, false)
+	);
+
+	// Never dereferenced, only compared
+	SDL_GPUBuffer* fake_buffer(uint32_t index) noexcept
+	{
+		return reinterpret_cast<SDL_GPUBuffer*>(uintptr_t(0x1000 + index * 16));
+	}
+
+	// Few geometries drawn many times, like a scattered forest
+	std::shared_ptr<gltf::DrawcallPartition> make_partition(
+		size_t count,
+		uint32_t generation,
+		bool build_bvh
+	) noexcept
+	{
+		constexpr uint32_t geometry_count = 40;
+		std::exponential_distribution<float> geometry{0.15f};
+
+		auto partition = std::make_shared<gltf::DrawcallPartition>();
+		partition->generation = generation;
+
+		std::vector<graphics::Aabb> bounds;
+		for (size_t index = 0; index < count; index++)
+		{
+			const auto geometry_index = std::min(uint32_t(geometry(generator)), geometry_count - 1);
+			const glm::vec3 center = {
+				unit(generator) * 120 - 60,
+				unit(generator) * 10,
+				unit(generator) * 120 - 60
+			};
+
+			gltf::PrimitiveDrawcall drawcall{};
+			drawcall.world_position_min = center - 1.0f;
+			drawcall.world_position_max = center + 1.0f;
+			drawcall.material_index =
+				geometry_index % 4 == 3 ? std::nullopt : std::optional(geometry_index % 3);
+			drawcall.transform_or_joint_matrix_offset = glm::translate(glm::mat4(1.0f), center);
+			drawcall.instance_count = index % 97 == 0 ? 8 : 0;
+			drawcall.primitive = {
+				.vertex_buffer_binding = {.buffer = fake_buffer(geometry_index * 4), .offset = 0},
+				.index_buffer_binding = {.buffer = fake_buffer(geometry_index * 4 + 1), .offset = 0},
+				.shadow_vertex_buffer_binding = {.buffer = fake_buffer(geometry_index * 4 + 2), .offset = 0},
+				.shadow_index_buffer_binding = {.buffer = fake_buffer(geometry_index * 4 + 3), .offset = 0},
+				.index_count = 300 + geometry_index * 3,
+				.rigged = false,
+				.occluder = nullptr,
+				.geometry_index = geometry_index
+			};
+
+			partition->drawcalls.push_back(drawcall);
+			bounds.push_back({.min = drawcall.world_position_min, .max = drawcall.world_position_max});
+		}
+
+		if (build_bvh) partition->bvh = graphics::Bvh::build(bounds);
+		return partition;
+	}
+
+	gltf::Drawdata make_drawdata(size_t static_count, size_t dynamic_count) noexcept
+	{
+		return gltf::Drawdata{
+			.primitive_drawcalls = {
+				.static_partition = static_count > 0 ? make_partition(static_count, 1, true) : nullptr,
+				.dynamic_partition = dynamic_count > 0 ? make_partition(dynamic_count, 0, false) : nullptr
+			},
+			.node_matrices = {},
+			.deferred_skin_resource = nullptr,
+			.deferred_instance_resource = nullptr,
+			.material_cache = material_cache.ref()
+		};
+	}
+
+	IndirectDraws::Draw make_draw(uint32_t geometry, uint32_t first_index, uint32_t draw_id) noexcept
+	{
+		return {
+			.material = &material_cache,
+			.resource_set_index = 0,
+			.vertex_buffer = {.buffer = fake_buffer(geometry * 2), .offset = 0},
+			.index_buffer = {.buffer = fake_buffer(geometry * 2 + 1), .offset = 0},
+			.index_count = 36,
+			.first_index = first_index,
+			.vertex_offset = 0,
+			.draw_id = draw_id,
+			.instanced = false
+		};
+	}
+
+	// Replay the batches of a bin: every live drawcall is drawn once, in bin order, with its own state
+	void check_bin(
+		const IndirectDraws& indirect_draws,
+		const auto& bin,
+		const auto& resource_sets,
+		bool shadow,
+		IndirectDraws::Stats& stats
+	) noexcept
+	{
+		const auto batches = indirect_draws.get_batches(bin);
+		const auto commands = indirect_draws.get_commands();
+		const auto draw_ids = indirect_draws.get_draw_ids();
+
+		const auto resolve = [&](size_t position) {
+			const auto& entry = bin[position];
+			return resource_sets[entry.resource_set_index].drawcalls.resolve(entry.drawcall);
+		};
+
+		std::vector<uint32_t> expected;
+		for (const auto& entry : bin)
+			if (resource_sets[entry.resource_set_index].drawcalls.resolve(entry.drawcall) != nullptr)
+				expected.push_back(entry.draw_id);
+
+		std::vector<uint32_t> drawn;
+		size_t position = 0;  // Next bin position to match
+		for (const auto& batch : batches)
+		{
+			if (!TEST_CHECK(batch.first_drawcall < bin.size() && batch.first_drawcall >= position)) return;
+			const auto& first_entry = bin[batch.first_drawcall];
+			const auto* const first = resolve(batch.first_drawcall);
+			if (!TEST_CHECK(first != nullptr)) return;
+
+			stats.commands += batch.command_count;
+			if (batch.command_count > 1)
+				stats.indirect_draws++;
+			else
+				stats.direct_draws++;
+
+			// Instanced drawcalls are drawn alone, with their draw id
+			if (batch.command_count == 0)
+			{
+				TEST_CHECK(first->is_instanced());
+				drawn.push_back(first_entry.draw_id);
+				position = batch.first_drawcall + 1;
+				continue;
+			}
+
+			const auto& first_index_buffer = shadow ? first->primitive.shadow_index_buffer_binding
+													: first->primitive.index_buffer_binding;
+
+			for (const auto& command : commands.subspan(batch.first_command, batch.command_count))
+			{
+				TEST_CHECK(command.num_instances > 0);
+				TEST_CHECK(command.num_indices == first->primitive.index_count);
+
+				for (const auto draw_id : draw_ids.subspan(command.first_instance, command.num_instances))
+				{
+					// Skip stale drawcalls of the bin, which are not drawn
+					while (position < bin.size() && resolve(position) == nullptr) position++;
+					if (!TEST_CHECK(position < bin.size())) return;
+
+					const auto& entry = bin[position];
+					const auto* const drawcall = resolve(position);
+					position++;
+
+					// Drawn with the state bound for the batch
+					TEST_CHECK(draw_id == entry.draw_id);
+					TEST_CHECK(!drawcall->is_instanced());
+					TEST_CHECK(entry.resource_set_index == first_entry.resource_set_index);
+					TEST_CHECK(drawcall->material_index == first->material_index);
+
+					const auto& index_buffer = shadow ? drawcall->primitive.shadow_index_buffer_binding
+													  : drawcall->primitive.index_buffer_binding;
+					TEST_CHECK(index_buffer.buffer == first_index_buffer.buffer);
+					drawn.push_back(draw_id);
+				}
+			}
+		}
+
+		TEST_CHECK(drawn == expected);
+		stats.drawcalls += expected.size();
+	}
+
+	// Reversed Z like the renderer's camera
+	glm::mat4 make_camera(const glm::vec3& eye) noexcept
+	{
+		const glm::mat4 reverse_z = glm::mat4(
+			glm::vec4(1, 0, 0, 0),
+			glm::vec4(0, 1, 0, 0),
+			glm::vec4(0, 0, -1, 0),
+			glm::vec4(0, 0, 1, 1)
+		);
+
+		return reverse_z
+			* glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f)
+			* glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	}
+}
+
+int main()
+{
+	test::run("Merging", [] {
+		const std::pmr::vector<int> bin, other_bin, unknown_bin;
+		IndirectDraws indirect_draws;
+
+		indirect_draws.begin_bin(&bin);
+		indirect_draws.add(0, make_draw(0, 0, 10));
+		indirect_draws.add(1, make_draw(0, 0, 11));  // Same range, one more instance
+		indirect_draws.add(2, make_draw(0, 36, 12));  // Other range, same batch
+		indirect_draws.add(3, make_draw(0, 0, 13));   // Not merged with the first command
+		indirect_draws.add(4, make_draw(1, 0, 14));   // Other geometry, new batch
+
+		auto instanced = make_draw(1, 0, 15);
+		instanced.instanced = true;
+		indirect_draws.add(5, instanced);
+		indirect_draws.add(6, make_draw(1, 0, 16));  // Not merged across the instanced drawcall
+
+		indirect_draws.begin_bin(&other_bin);
+		indirect_draws.add(0, make_draw(1, 0, 17));  // Not merged across bins
+		indirect_draws.end_bin();
+
+		const auto batches = indirect_draws.get_batches(bin);
+		const auto commands = indirect_draws.get_commands();
+		if (!TEST_CHECK(batches.size() == 4 && commands.size() == 6)) return;
+
+		TEST_CHECK(batches[0].first_drawcall == 0 && batches[0].command_count == 3);
+		TEST_CHECK(batches[1].first_drawcall == 4 && batches[1].command_count == 1);
+		TEST_CHECK(batches[2].first_drawcall == 5 && batches[2].command_count == 0);
+		TEST_CHECK(batches[3].first_drawcall == 6 && batches[3].command_count == 1);
+
+		TEST_CHECK(commands[0].num_instances == 2 && commands[0].first_index == 0);
+		TEST_CHECK(commands[1].num_instances == 1 && commands[1].first_index == 36);
+		TEST_CHECK(commands[2].num_instances == 1 && commands[2].first_index == 0);
+
+		// Instances of a command read consecutive draw ids, the instanced one has none
+		const std::array expected_ids = {10u, 11u, 12u, 13u, 14u, 16u, 17u};
+		TEST_CHECK(std::ranges::equal(indirect_draws.get_draw_ids(), expected_ids));
+		const std::array expected_first_instances = {0u, 2u, 3u, 4u, 5u, 6u};
+		TEST_CHECK(std::ranges::equal(commands, expected_first_instances, {}, [](const auto& command) {
+			return command.first_instance;
+		}));
+
+		const auto other_batches = indirect_draws.get_batches(other_bin);
+		TEST_CHECK(other_batches.size() == 1 && other_batches[0].first_command == 5);
+		TEST_CHECK(indirect_draws.get_batches(unknown_bin).empty());
+
+		const auto stats = indirect_draws.get_stats();
+		TEST_CHECK(stats.drawcalls == 8 && stats.commands == 6);
+		TEST_CHECK(stats.indirect_draws == 1 && stats.direct_draws == 4);
+	});
+
+	test::run("Drawdata", [] {
+		const auto rebuilt_partition = make_partition(800, 0, false);
+
+		std::vector<gltf::Drawdata> drawdata_list;
+		drawdata_list.push_back(make_drawdata(6000, 1500));
+		drawdata_list.push_back(make_drawdata(0, 0));
+		drawdata_list.push_back(make_drawdata(2000, 0));
+		drawdata_list[1].primitive_drawcalls.dynamic_partition = rebuilt_partition;
+
+		const glm::vec3 eye = {0.0f, 30.0f, 90.0f};
+		const auto camera_matrix = make_camera(eye);
+		const glm::vec3 light_direction = glm::normalize(glm::vec3(0.3f, -1.0f, 0.2f));
+
+		render::drawdata::Gbuffer gbuffer(camera_matrix, eye);
+		for (const auto& drawdata : drawdata_list) gbuffer.append(drawdata);
+
+		render::drawdata::Shadow shadow(camera_matrix, light_direction, gbuffer.get_min_z(), 0.5f);
+		for (const auto& drawdata : drawdata_list) shadow.append(drawdata);
+
+		gbuffer.sort();
+		shadow.sort();
+
+		// A rebuilt partition leaves stale handles in the bins
+		rebuilt_partition->generation++;
+
+		render::drawdata::ObjectData object_data;
+		object_data.assign(gbuffer);
+		object_data.assign(shadow);
+
+		IndirectDraws indirect_draws;
+		indirect_draws.build(gbuffer);
+		indirect_draws.build(shadow);
+
+		IndirectDraws::Stats stats;
+		size_t gbuffer_entries = 0;
+		for (const auto& bin : gbuffer.drawcalls | std::views::values)
+		{
+			check_bin(indirect_draws, bin, gbuffer.resource_sets, false, stats);
+			gbuffer_entries += bin.size();
+		}
+		TEST_CHECK(stats.drawcalls < gbuffer_entries);
+
+		IndirectDraws::Stats shadow_stats;
+		for (const auto& level : shadow.csm_levels)
+		{
+			for (const auto& bin : level.drawcalls | std::views::values)
+				check_bin(indirect_draws, bin, level.resource_sets, true, shadow_stats);
+			for (const auto& bin : level.static_drawcalls | std::views::values)
+				check_bin(indirect_draws, bin, level.resource_sets, true, shadow_stats);
+		}
+
+		// The replay accounts for every drawcall and batch
+		const auto built_stats = indirect_draws.get_stats();
+		TEST_CHECK(built_stats.drawcalls == stats.drawcalls + shadow_stats.drawcalls);
+		TEST_CHECK(built_stats.commands == stats.commands + shadow_stats.commands);
+		TEST_CHECK(built_stats.direct_draws == stats.direct_draws + shadow_stats.direct_draws);
+		TEST_CHECK(built_stats.indirect_draws == stats.indirect_draws + shadow_stats.indirect_draws);
+
+		// Shadow casters sorted by geometry batch well
+		const size_t shadow_draws = shadow_stats.direct_draws + shadow_stats.indirect_draws;
+		TEST_CHECK(stats.drawcalls > 1000 && shadow_stats.drawcalls > 1000);
+		TEST_CHECK(shadow_draws * 4 < shadow_stats.drawcalls);
+	});
+
+	return test::finish();
+}
@@ -0,0 +1,274 @@
+// Entries and draw ids of `render::drawdata::ObjectData`, shared between G-buffer and shadow views
+
+#include "render/drawdata/object.hpp"
+#include "test/check.hpp"
+
+#include <cstddef>
+#include <glm/gtc/matrix_transform.hpp>
+#include <map>
+#include <random>
+#include <set>
+
+namespace
+{
+	std::mt19937 generator{71};
+	std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+
+	gltf::MaterialCache material_cache({gltf::MaterialGPU{}, gltf::MaterialGPU{}}, gltf::MaterialGPU{});
+
+	glm::vec3 random_vec3() noexcept
+	{
+		return glm::vec3(unit(generator), unit(generator), unit(generator)) - 0.5f;
+	}
+
+	// Rotated, non-uniformly scaled and translated drawcall, or a rigged one
+	gltf::PrimitiveDrawcall make_drawcall(uint32_t index, bool rigged) noexcept
+	{
+		const glm::mat4 transform = glm::scale(
+			glm::rotate(
+				glm::translate(glm::mat4(1.0f), random_vec3() * 100.0f),
+				unit(generator) * 6.0f,
+				glm::normalize(random_vec3() + glm::vec3(0, 0.01f, 0))
+			),
+			glm::vec3(0.5f) + glm::vec3(unit(generator), unit(generator), unit(generator)) * 2.0f
+		);
+
+		gltf::PrimitiveDrawcall drawcall{};
+		drawcall.world_position_min = glm::vec3(transform[3]) - 2.0f;
+		drawcall.world_position_max = glm::vec3(transform[3]) + 2.0f;
+		drawcall.material_index = index % 3 == 0 ? std::nullopt : std::optional(index % 2);
+		drawcall.primitive.geometry_index = index % 13;
+		drawcall.emissive_multiplier = float(index % 4) * 0.5f;
+		drawcall.instance_offset = index % 5 == 0 ? index * 7 : 0;
+		drawcall.instance_count = index % 5 == 0 ? 3 : 0;
+
+		if (rigged)
+			drawcall.transform_or_joint_matrix_offset = index * 24;
+		else
+			drawcall.transform_or_joint_matrix_offset = transform;
+
+		return drawcall;
+	}
+
+	std::shared_ptr<gltf::DrawcallPartition> make_partition(
+		size_t count,
+		uint32_t generation,
+		bool build_bvh
+	) noexcept
+	{
+		auto partition = std::make_shared<gltf::DrawcallPartition>();
+		partition->generation = generation;
+
+		std::vector<graphics::Aabb> bounds;
+		for (size_t index = 0; index < count; index++)
+		{
+			const auto& drawcall =
+				partition->drawcalls.emplace_back(make_drawcall(uint32_t(index), unit(generator) < 0.2f));
+			bounds.push_back({.min = drawcall.world_position_min, .max = drawcall.world_position_max});
+		}
+
+		if (build_bvh) partition->bvh = graphics::Bvh::build(bounds);
+		return partition;
+	}
+
+	gltf::Drawdata make_drawdata(size_t static_count, size_t dynamic_count) noexcept
+	{
+		return gltf::Drawdata{
+			.primitive_drawcalls = {
+				.static_partition = static_count > 0 ? make_partition(static_count, 1, true) : nullptr,
+				.dynamic_partition = dynamic_count > 0 ? make_partition(dynamic_count, 0, false) : nullptr
+			},
+			.node_matrices = {},
+			.deferred_skin_resource = nullptr,
+			.deferred_instance_resource = nullptr,
+			.material_cache = material_cache.ref()
+		};
+	}
+
+	// Reversed Z like the renderer's camera
+	glm::mat4 make_camera(const glm::vec3& eye, float fov, float aspect, float far) noexcept
+	{
+		const glm::mat4 reverse_z = glm::mat4(
+			glm::vec4(1, 0, 0, 0),
+			glm::vec4(0, 1, 0, 0),
+			glm::vec4(0, 0, -1, 0),
+			glm::vec4(0, 0, 1, 1)
+		);
+
+		return reverse_z
+			* glm::perspective(fov, aspect, 0.1f, far)
+			* glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	}
+
+	bool same_entry(
+		const render::drawdata::ObjectData::Entry& a,
+		const render::drawdata::ObjectData::Entry& b
+	) noexcept
+	{
+		return a.model == b.model
+			&& a.normal == b.normal
+			&& a.joint_offset == b.joint_offset
+			&& a.instance_offset == b.instance_offset
+			&& a.emissive_multiplier == b.emissive_multiplier
+			&& a.material_index == b.material_index;
+	}
+
+	// Check the entry of every drawn drawcall, and collect the drawcalls seen
+	void check_bins(
+		const render::drawdata::ObjectData& object_data,
+		const auto& bins,
+		const auto& resource_sets,
+		std::map<const gltf::PrimitiveDrawcall*, uint32_t>& draw_ids
+	) noexcept
+	{
+		for (const auto& drawcalls : bins | std::views::values)
+			for (const auto& entry : drawcalls)
+			{
+				const auto& resource_set = resource_sets[entry.resource_set_index];
+				const auto* const drawcall = resource_set.drawcalls.resolve(entry.drawcall);
+				if (!TEST_CHECK(drawcall != nullptr)) continue;
+				if (!TEST_CHECK(entry.draw_id < object_data.get_entries().size())) continue;
+
+				using Entry = render::drawdata::ObjectData::Entry;
+				TEST_CHECK(same_entry(object_data.get_entries()[entry.draw_id], Entry::from(*drawcall)));
+
+				// Views of one drawcall share its draw id
+				const auto [it, inserted] = draw_ids.try_emplace(drawcall, entry.draw_id);
+				TEST_CHECK(it->second == entry.draw_id);
+			}
+	}
+}
+
+int main()
+{
+	test::run("Entry layout", [] {
+		// std430 offsets of `Object` in `object.glsl`
+		using Entry = render::drawdata::ObjectData::Entry;
+		TEST_CHECK(offsetof(Entry, model) == 0);
+		TEST_CHECK(offsetof(Entry, normal) == 64);
+		TEST_CHECK(offsetof(Entry, joint_offset) == 112);
+		TEST_CHECK(offsetof(Entry, instance_offset) == 116);
+		TEST_CHECK(offsetof(Entry, emissive_multiplier) == 120);
+		TEST_CHECK(offsetof(Entry, material_index) == 124);
+	});
+
+	test::run("Entry::from", [] {
+		using ObjectData = render::drawdata::ObjectData;
+
+		for (uint32_t index = 0; index < 200; index++)
+		{
+			const auto drawcall = make_drawcall(index, index % 4 == 1);
+			const auto entry = ObjectData::Entry::from(drawcall);
+
+			TEST_CHECK(entry.instance_offset == drawcall.instance_offset);
+			TEST_CHECK(entry.emissive_multiplier == drawcall.emissive_multiplier);
+			TEST_CHECK(entry.material_index == drawcall.material_index.value_or(ObjectData::no_material));
+
+			if (drawcall.is_rigged())
+			{
+				TEST_CHECK(entry.model == glm::mat4(1.0f));
+				TEST_CHECK(entry.joint_offset == drawcall.get_joint_matrix_offset());
+				continue;
+			}
+
+			TEST_CHECK(entry.model == drawcall.get_world_transform());
+			TEST_CHECK(entry.joint_offset == 0);
+
+			// Normals stay perpendicular to transformed tangents, the padding row is zero
+			const glm::mat3 normal = glm::mat3(entry.normal);
+			for (int sample = 0; sample < 10; sample++)
+			{
+				const glm::vec3 direction = random_vec3();
+				const glm::vec3 tangent = glm::normalize(glm::cross(direction, glm::vec3(0.3f, 1, 0.1f)));
+				const glm::vec3 world_normal = glm::normalize(normal * direction);
+				const glm::vec3 world_tangent = glm::normalize(glm::mat3(entry.model) * tangent);
+				TEST_CHECK(std::abs(glm::dot(world_normal, world_tangent)) < 1e-4f);
+			}
+
+			for (int column = 0; column < 3; column++) TEST_CHECK(entry.normal[column][3] == 0.0f);
+		}
+	});
+
+	test::run("Shared entries", [] {
+		std::vector<gltf::Drawdata> drawdata_list;
+		drawdata_list.push_back(make_drawdata(1500, 400));
+		drawdata_list.push_back(make_drawdata(0, 700));
+		drawdata_list.push_back(make_drawdata(900, 0));
+		drawdata_list.push_back(make_drawdata(0, 0));
+
+		const glm::vec3 eye = {0.0f, 20.0f, 60.0f};
+		const auto camera_matrix = make_camera(eye, glm::radians(60.0f), 16.0f / 9.0f, 200.0f);
+		const glm::vec3 light_direction = glm::normalize(glm::vec3(0.3f, -1.0f, 0.2f));
+
+		render::drawdata::Gbuffer gbuffer(camera_matrix, eye);
+		for (const auto& drawdata : drawdata_list) gbuffer.append(drawdata);
+
+		render::drawdata::Shadow shadow(camera_matrix, light_direction, gbuffer.get_min_z(), 0.5f);
+		for (const auto& drawdata : drawdata_list) shadow.append(drawdata);
+
+		// Static layer of the first level, culled as for a rebuilt cached level
+		auto& level = shadow.csm_levels[0];
+		level.cached = true;
+		for (const auto [resource_set_index, drawdata] : drawdata_list | std::views::enumerate)
+		{
+			render::drawdata::Shadow::ShadowLevelData::Partial partial;
+			level.cull_static(drawdata, size_t(resource_set_index), partial);
+			level.merge_static(partial);
+		}
+		TEST_CHECK(!level.static_drawcalls.empty());
+
+		render::drawdata::ObjectData object_data;
+		object_data.assign(gbuffer);
+		object_data.assign(shadow);
+
+		std::map<const gltf::PrimitiveDrawcall*, uint32_t> draw_ids;
+		check_bins(object_data, gbuffer.drawcalls, gbuffer.resource_sets, draw_ids);
+		const size_t gbuffer_count = draw_ids.size();
+
+		// G-buffer drawcalls are assigned first
+		for (const auto draw_id : draw_ids | std::views::values) TEST_CHECK(draw_id < gbuffer_count);
+
+		for (const auto& shadow_level : shadow.csm_levels)
+		{
+			check_bins(object_data, shadow_level.drawcalls, shadow_level.resource_sets, draw_ids);
+			check_bins(object_data, shadow_level.static_drawcalls, shadow_level.resource_sets, draw_ids);
+		}
+
+		// One entry per distinct drawcall
+		TEST_CHECK(gbuffer_count > 100 && draw_ids.size() > gbuffer_count);
+		TEST_CHECK(object_data.get_entries().size() == draw_ids.size());
+
+		std::set<uint32_t> unique_ids;
+		for (const auto draw_id : draw_ids | std::views::values) unique_ids.insert(draw_id);
+		TEST_CHECK(unique_ids.size() == draw_ids.size());
+
+		// Adding a drawcall again finds its entry
+		for (const auto [drawcall, draw_id] : draw_ids) TEST_CHECK(object_data.add(*drawcall) == draw_id);
+		TEST_CHECK(object_data.get_entries().size() == draw_ids.size());
+	});
+
+	test::run("Stale drawcalls", [] {
+		const auto partition = make_partition(300, 0, false);
+		auto drawdata = make_drawdata(0, 0);
+		drawdata.primitive_drawcalls.dynamic_partition = partition;
+		const glm::vec3 eye = {0.0f, 0.0f, 150.0f};
+		const auto camera_matrix = make_camera(eye, glm::radians(90.0f), 1.0f, 400.0f);
+
+		render::drawdata::Gbuffer gbuffer(camera_matrix, eye);
+		gbuffer.append(drawdata);
+		if (!TEST_CHECK(!gbuffer.drawcalls.empty())) return;
+
+		// Rebuilt partition, every handle is stale and keeps its draw id
+		partition->generation++;
+		for (auto& drawcalls : gbuffer.drawcalls | std::views::values)
+			for (auto& drawcall : drawcalls) drawcall.draw_id = 12345;
+
+		render::drawdata::ObjectData object_data;
+		object_data.assign(gbuffer);
+		TEST_CHECK(object_data.get_entries().empty());
+		for (const auto& drawcalls : gbuffer.drawcalls | std::views::values)
+			for (const auto& drawcall : drawcalls) TEST_CHECK(drawcall.draw_id == 12345);
+	});
+
+	return test::finish();
+}
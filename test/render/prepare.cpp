@@ -0,0 +1,285 @@
+// Chunked culling of G-buffer and shadow drawdata, merged in order, against the serial `append`
+
+#include "render/drawdata/gbuffer.hpp"
+#include "render/drawdata/shadow.hpp"
+#include "test/check.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <thread>
+
+namespace
+{
+	std::mt19937 generator{11};
+
+	gltf::MaterialGPU make_material(gltf::AlphaMode alpha_mode, bool double_sided) noexcept
+	{
+		gltf::MaterialGPU material{};
+		material.params.pipeline = {.alpha_mode = alpha_mode, .double_sided = double_sided};
+		return material;
+	}
+
+	// One material per pipeline mode, the default material is opaque
+	gltf::MaterialCache material_cache(
+		{make_material(gltf::AlphaMode::Opaque, true),
+		 make_material(gltf::AlphaMode::Mask, false),
+		 make_material(gltf::AlphaMode::Mask, true),
+		 make_material(gltf::AlphaMode::Blend, false)},
+		make_material(gltf::AlphaMode::Opaque, false)
+	);
+
+	std::shared_ptr<gltf::DrawcallPartition> make_partition(
+		size_t count,
+		uint32_t generation,
+		bool build_bvh
+	) noexcept
+	{
+		std::uniform_real_distribution<float> position{-60.0f, 60.0f};
+		std::uniform_real_distribution<float> extent{0.1f, 3.0f};
+		std::uniform_int_distribution<uint32_t> material{0, 4};
+		std::uniform_int_distribution<uint32_t> geometry{0, 15};
+		std::bernoulli_distribution rigged{0.2};
+
+		auto partition = std::make_shared<gltf::DrawcallPartition>();
+		partition->generation = generation;
+
+		std::vector<graphics::Aabb> bounds;
+		for (size_t index = 0; index < count; index++)
+		{
+			const glm::vec3 center = {position(generator), position(generator) * 0.2f, position(generator)};
+			const glm::vec3 half_size = {extent(generator), extent(generator), extent(generator)};
+			const uint32_t material_index = material(generator);
+
+			gltf::PrimitiveDrawcall drawcall{};
+			drawcall.world_position_min = center - half_size;
+			drawcall.world_position_max = center + half_size;
+			drawcall.material_index = material_index < 4 ? std::optional(material_index) : std::nullopt;
+			drawcall.primitive.geometry_index = geometry(generator);
+
+			if (rigged(generator))
+				drawcall.transform_or_joint_matrix_offset = uint32_t(index * 16);
+			else
+				drawcall.transform_or_joint_matrix_offset = glm::mat4(1.0f);
+
+			partition->drawcalls.push_back(drawcall);
+			bounds.push_back({.min = drawcall.world_position_min, .max = drawcall.world_position_max});
+		}
+
+		if (build_bvh) partition->bvh = graphics::Bvh::build(bounds);
+		return partition;
+	}
+
+	gltf::Drawdata make_drawdata(size_t static_count, size_t dynamic_count) noexcept
+	{
+		return gltf::Drawdata{
+			.primitive_drawcalls = {
+				.static_partition = static_count > 0 ? make_partition(static_count, 1, true) : nullptr,
+				.dynamic_partition = dynamic_count > 0 ? make_partition(dynamic_count, 0, false) : nullptr
+			},
+			.node_matrices = {},
+			.deferred_skin_resource = nullptr,
+			.deferred_instance_resource = nullptr,
+			.material_cache = material_cache.ref()
+		};
+	}
+
+	struct Chunk
+	{
+		size_t drawdata_index;
+		size_t begin;
+		size_t end;
+	};
+
+	// Same split as the renderer, with a configurable chunk size
+	std::vector<Chunk> split_chunks(std::span<const gltf::Drawdata> drawdata_list, size_t chunk_size) noexcept
+	{
+		std::vector<Chunk> chunks;
+
+		for (const auto [drawdata_idx, drawdata] : drawdata_list | std::views::enumerate)
+			for (size_t begin = 0; begin < drawdata.primitive_drawcalls.size(); begin += chunk_size)
+				chunks.push_back({
+					.drawdata_index = size_t(drawdata_idx),
+					.begin = begin,
+					.end = std::min(begin + chunk_size, drawdata.primitive_drawcalls.size())
+				});
+
+		return chunks;
+	}
+
+	// Run `task(chunk_index)` for every chunk on several threads, in no particular order
+	template <typename F>
+	void run_chunks(size_t chunk_count, const F& task) noexcept
+	{
+		constexpr size_t thread_count = 4;
+
+		std::vector<std::jthread> threads;
+		for (size_t thread_idx = 0; thread_idx < thread_count; thread_idx++)
+			threads.emplace_back([&task, chunk_count, thread_idx] {
+				for (size_t chunk_idx = thread_idx; chunk_idx < chunk_count; chunk_idx += thread_count)
+					task(chunk_count - 1 - chunk_idx);
+			});
+	}
+
+	bool same_handle(const gltf::DrawcallHandle& a, const gltf::DrawcallHandle& b) noexcept
+	{
+		return a.partition == b.partition && a.index == b.index && a.generation == b.generation;
+	}
+
+	bool same_gbuffer_bins(
+		const render::drawdata::Gbuffer::DrawcallBins& a,
+		const render::drawdata::Gbuffer::DrawcallBins& b
+	) noexcept
+	{
+		using Drawcall = render::drawdata::Gbuffer::Drawcall;
+
+		return std::ranges::equal(a, b, [](const auto& bin_a, const auto& bin_b) {
+			return bin_a.first == bin_b.first
+				&& std::ranges::equal(bin_a.second, bin_b.second, [](const Drawcall& x, const Drawcall& y) {
+					   return same_handle(x.drawcall, y.drawcall)
+						   && x.resource_set_index == y.resource_set_index
+						   && x.max_z == y.max_z;
+				   });
+		});
+	}
+
+	bool same_shadow_bins(
+		const render::drawdata::Shadow::DrawcallBins& a,
+		const render::drawdata::Shadow::DrawcallBins& b
+	) noexcept
+	{
+		using Drawcall = render::drawdata::Shadow::Drawcall;
+
+		return std::ranges::equal(a, b, [](const auto& bin_a, const auto& bin_b) {
+			return bin_a.first == bin_b.first
+				&& std::ranges::equal(bin_a.second, bin_b.second, [](const Drawcall& x, const Drawcall& y) {
+					   return same_handle(x.drawcall, y.drawcall)
+						   && x.resource_set_index == y.resource_set_index
+						   && x.min_z == y.min_z
+						   && x.geometry_index == y.geometry_index;
+				   });
+		});
+	}
+
+	size_t count_drawcalls(const auto& bins) noexcept
+	{
+		size_t count = 0;
+		for (const auto& drawcalls : bins | std::views::values) count += drawcalls.size();
+		return count;
+	}
+}
+
+int main()
+{
+	std::vector<gltf::Drawdata> drawdata_list;
+	drawdata_list.push_back(make_drawdata(1500, 400));
+	drawdata_list.push_back(make_drawdata(0, 700));  // Dynamic only
+	drawdata_list.push_back(make_drawdata(900, 0));  // Static only
+	drawdata_list.push_back(make_drawdata(0, 0));    // Empty
+	drawdata_list.push_back(make_drawdata(3, 2));    // Smaller than a chunk
+
+	const glm::vec3 eye = {0.0f, 8.0f, 30.0f};
+
+	// Reversed Z like the renderer's camera, near plane at depth 1
+	const glm::mat4 reverse_z = glm::mat4(
+		glm::vec4(1, 0, 0, 0),
+		glm::vec4(0, 1, 0, 0),
+		glm::vec4(0, 0, -1, 0),
+		glm::vec4(0, 0, 1, 1)
+	);
+	const auto camera_matrix = reverse_z
+		* glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f)
+		* glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const glm::vec3 light_direction = glm::normalize(glm::vec3(0.3f, -1.0f, 0.2f));
+
+	render::drawdata::Gbuffer serial_gbuffer(camera_matrix, eye);
+	for (const auto& drawdata : drawdata_list) serial_gbuffer.append(drawdata);
+
+	render::drawdata::Shadow serial_shadow(camera_matrix, light_direction, serial_gbuffer.get_min_z(), 0.5f);
+	for (const auto& drawdata : drawdata_list) serial_shadow.append(drawdata);
+
+	test::run("Serial scene", [&] {
+		// Some drawcalls are culled, some kept in several bins
+		const size_t kept = count_drawcalls(serial_gbuffer.drawcalls);
+		TEST_CHECK(kept > 100 && kept < 3500);
+		TEST_CHECK(serial_gbuffer.drawcalls.size() > 4);
+		TEST_CHECK(serial_gbuffer.min_z < 1.0f);
+	});
+
+	test::run("Gbuffer chunked culling", [&] {
+		for (const size_t chunk_size : {1zu, 7zu, 64zu, 512zu, 4096zu})
+		{
+			const auto chunks = split_chunks(drawdata_list, chunk_size);
+
+			render::drawdata::Gbuffer gbuffer(camera_matrix, eye);
+			const auto resource_sets =
+				drawdata_list
+				| std::views::transform([&gbuffer](const auto& drawdata) {
+					  return gbuffer.add_resource_set(drawdata);
+				  })
+				| std::ranges::to<std::vector>();
+
+			std::vector<render::drawdata::Gbuffer::Partial> partials(chunks.size());
+			run_chunks(chunks.size(), [&](size_t chunk_idx) {
+				const auto& chunk = chunks[chunk_idx];
+				gbuffer.cull(
+					drawdata_list[chunk.drawdata_index],
+					resource_sets[chunk.drawdata_index],
+					chunk.begin,
+					chunk.end,
+					partials[chunk_idx]
+				);
+			});
+
+			// Merged in chunk order, the result is identical to the serial one
+			for (const auto& partial : partials) gbuffer.merge(partial);
+			TEST_CHECK(gbuffer.min_z == serial_gbuffer.min_z);
+			TEST_CHECK(same_gbuffer_bins(gbuffer.drawcalls, serial_gbuffer.drawcalls));
+
+			auto sorted_serial = serial_gbuffer;
+			sorted_serial.sort();
+			gbuffer.sort();
+			TEST_CHECK(same_gbuffer_bins(gbuffer.drawcalls, sorted_serial.drawcalls));
+		}
+	});
+
+	test::run("Shadow chunked culling", [&] {
+		for (const size_t chunk_size : {1zu, 7zu, 64zu, 512zu, 4096zu})
+		{
+			const auto chunks = split_chunks(drawdata_list, chunk_size);
+
+			render::drawdata::Shadow shadow(camera_matrix, light_direction, serial_gbuffer.get_min_z(), 0.5f);
+
+			for (const auto level_idx : std::views::iota(0zu, shadow.csm_levels.size()))
+			{
+				auto& level = shadow.csm_levels[level_idx];
+				const auto& serial_level = serial_shadow.csm_levels[level_idx];
+
+				const auto resource_sets =
+					drawdata_list
+					| std::views::transform([&level](const auto& drawdata) {
+						  return level.add_resource_set(drawdata);
+					  })
+					| std::ranges::to<std::vector>();
+
+				std::vector<render::drawdata::Shadow::ShadowLevelData::Partial> partials(chunks.size());
+				run_chunks(chunks.size(), [&](size_t chunk_idx) {
+					const auto& chunk = chunks[chunk_idx];
+					level.cull(
+						drawdata_list[chunk.drawdata_index],
+						resource_sets[chunk.drawdata_index],
+						chunk.begin,
+						chunk.end,
+						partials[chunk_idx]
+					);
+				});
+
+				for (const auto& partial : partials) level.merge(partial);
+				TEST_CHECK(level.near == serial_level.near && level.far == serial_level.far);
+				TEST_CHECK(same_shadow_bins(level.drawcalls, serial_level.drawcalls));
+				TEST_CHECK(!level.drawcalls.empty());
+			}
+		}
+	});
+
+	return test::finish();
+}
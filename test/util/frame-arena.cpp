@@ -0,0 +1,147 @@
+// Slot rotation, poisoning and overflow of `util::FrameArena`
+
+#include "test/check.hpp"
+#include "util/frame-arena.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	// Upstream resource counting live allocations
+	class CountingResource final : public std::pmr::memory_resource
+	{
+	  public:
+
+		size_t live_count = 0;
+		size_t live_bytes = 0;
+
+	  protected:
+
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			live_count++;
+			live_bytes += bytes;
+			return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+		{
+			live_count--;
+			live_bytes -= bytes;
+			std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+	};
+
+	bool all_bytes(const void* ptr, size_t bytes, std::byte value) noexcept
+	{
+		const auto* data = static_cast<const std::byte*>(ptr);
+		return std::all_of(data, data + bytes, [value](std::byte byte) { return byte == value; });
+	}
+}
+
+int main()
+{
+	test::run("FrameArena rotation", [] {
+		util::FrameArena arena({.capacity_per_frame = 1024, .frame_count = 3, .poison = true});
+
+		std::array<std::pmr::memory_resource*, 3> resources;
+		std::array<void*, 3> blocks;
+		for (size_t frame = 0; frame < 3; frame++)
+		{
+			resources[frame] = arena.resource();
+			blocks[frame] = arena.resource()->allocate(64, 16);
+			std::memset(blocks[frame], int(frame + 1), 64);
+			arena.begin_frame();
+		}
+
+		// Slots are distinct and reused in order
+		TEST_CHECK(resources[0] != resources[1] && resources[1] != resources[2]);
+		TEST_CHECK(resources[0] != resources[2]);
+		TEST_CHECK(arena.resource() == resources[0]);
+
+		// The oldest frame is released and poisoned, the previous `frame_count - 1` frames are intact
+		TEST_CHECK(all_bytes(blocks[0], 64, util::FrameArena::poison_byte));
+		TEST_CHECK(all_bytes(blocks[1], 64, std::byte(2)));
+		TEST_CHECK(all_bytes(blocks[2], 64, std::byte(3)));
+
+		// Memory of the released slot is handed out again
+		TEST_CHECK(arena.resource()->allocate(64, 16) == blocks[0]);
+	});
+
+	test::run("FrameArena alignment and stats", [] {
+		util::FrameArena arena({.capacity_per_frame = 4096, .frame_count = 2, .poison = false});
+
+		for (const size_t alignment : {1zu, 2zu, 8zu, 16zu, 64zu, 256zu})
+		{
+			void* const ptr = arena.resource()->allocate(3, alignment);
+			TEST_CHECK(reinterpret_cast<uintptr_t>(ptr) % alignment == 0);
+		}
+
+		const auto stats = arena.get_stats();
+		TEST_CHECK(stats.used_bytes >= 6 * 3 && stats.used_bytes <= 4096);
+		TEST_CHECK(stats.overflow_bytes == 0 && stats.overflow_count == 0);
+
+		// Containers allocate from the current slot
+		std::pmr::vector<uint32_t> values(arena.resource());
+		for (uint32_t value = 0; value < 100; value++) values.push_back(value);
+		TEST_CHECK(arena.get_stats().used_bytes > stats.used_bytes);
+	});
+
+	test::run("FrameArena overflow", [] {
+		CountingResource upstream;
+
+		{
+			util::FrameArena arena({.capacity_per_frame = 256, .frame_count = 2, .poison = true}, &upstream);
+
+			arena.resource()->allocate(200, 8);
+			TEST_CHECK(upstream.live_count == 0);
+
+			// Does not fit the slot, served by upstream and kept alive with the slot
+			void* const overflow = arena.resource()->allocate(300, 8);
+			std::memset(overflow, 1, 300);
+			TEST_CHECK(upstream.live_count == 1 && upstream.live_bytes == 300);
+
+			const auto stats = arena.get_stats();
+			TEST_CHECK(stats.used_bytes == 500);
+			TEST_CHECK(stats.overflow_bytes == 300 && stats.overflow_count == 1);
+
+			// Still valid one frame later, released to upstream when the slot comes around again
+			arena.begin_frame();
+			TEST_CHECK(upstream.live_count == 1);
+			TEST_CHECK(arena.get_stats().overflow_count == 0);
+
+			arena.begin_frame();
+			TEST_CHECK(upstream.live_count == 0);
+
+			const auto later = arena.get_stats();
+			TEST_CHECK(later.high_water_bytes == 500);
+			TEST_CHECK(later.overflow_frame_count == 1);
+
+			// Overflow blocks left at destruction are released too
+			arena.resource()->allocate(1000, 8);
+			TEST_CHECK(upstream.live_count == 1);
+		}
+
+		TEST_CHECK(upstream.live_count == 0 && upstream.live_bytes == 0);
+	});
+
+	test::run("FrameArena move", [] {
+		util::FrameArena arena({.capacity_per_frame = 256, .frame_count = 2, .poison = false});
+		auto* const resource = arena.resource();
+
+		util::FrameArena moved = std::move(arena);
+		TEST_CHECK(moved.resource() == resource);
+
+		moved.begin_frame();
+		moved.begin_frame();
+		TEST_CHECK(moved.resource() == resource);
+	});
+
+	return test::finish();
+}
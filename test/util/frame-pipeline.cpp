@@ -0,0 +1,149 @@
+// Frame order, overlap and shutdown of `util::FramePipeline`, serial and pipelined
+
+#include "test/check.hpp"
+#include "util/frame-pipeline.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace
+{
+	struct Prepared
+	{
+		uint32_t frame;
+		std::thread::id thread;
+	};
+
+	using Pipeline = util::FramePipeline<std::unique_ptr<uint32_t>, Prepared>;
+
+	Prepared prepare(std::unique_ptr<uint32_t> input) noexcept
+	{
+		return {.frame = *input, .thread = std::this_thread::get_id()};
+	}
+
+	// Wait for a condition set by the worker, false on timeout
+	bool wait_for(const auto& condition) noexcept
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (!condition())
+		{
+			if (std::chrono::steady_clock::now() > deadline) return false;
+			std::this_thread::yield();
+		}
+
+		return true;
+	}
+}
+
+int main()
+{
+	test::run("Serial", [] {
+		Pipeline pipeline(prepare, 0);
+		TEST_CHECK(!pipeline.pop().has_value());
+
+		// Runs the stage on the calling thread, in push
+		for (uint32_t frame = 0; frame < 10; frame++)
+		{
+			pipeline.push(std::make_unique<uint32_t>(frame));
+			TEST_CHECK(pipeline.get_frames_in_flight() == 1);
+
+			const auto output = pipeline.pop();
+			if (!TEST_CHECK(output.has_value())) return;
+			TEST_CHECK(output->frame == frame && output->thread == std::this_thread::get_id());
+		}
+
+		TEST_CHECK(pipeline.get_stats().frames == 10 && pipeline.get_stats().consumer_waits == 0);
+	});
+
+	test::run("Pipelined", [] {
+		for (const size_t frames_ahead : {1zu, 2zu, 4zu})
+		{
+			Pipeline pipeline(prepare, frames_ahead);
+
+			// Usage loop of the renderer, then drained
+			uint32_t next_output = 0;
+			for (uint32_t frame = 0; frame < 1000; frame++)
+			{
+				pipeline.push(std::make_unique<uint32_t>(frame));
+				TEST_CHECK(pipeline.get_frames_in_flight() <= frames_ahead + 1);
+
+				if (pipeline.get_frames_in_flight() <= frames_ahead) continue;
+
+				const auto output = pipeline.pop();
+				if (!TEST_CHECK(output.has_value())) return;
+				TEST_CHECK(output->frame == next_output++);
+				TEST_CHECK(output->thread != std::this_thread::get_id());
+			}
+
+			while (const auto output = pipeline.pop()) TEST_CHECK(output->frame == next_output++);
+			TEST_CHECK(next_output == 1000 && pipeline.get_frames_in_flight() == 0);
+			TEST_CHECK(pipeline.get_stats().frames == 1000);
+		}
+	});
+
+	test::run("Running ahead", [] {
+		// Every pushed frame is prepared without waiting for the caller to pop
+		std::atomic<uint32_t> prepared = 0;
+		Pipeline pipeline(
+			[&prepared](std::unique_ptr<uint32_t> input) {
+				prepared++;
+				return prepare(std::move(input));
+			},
+			2
+		);
+
+		for (uint32_t frame = 0; frame < 3; frame++) pipeline.push(std::make_unique<uint32_t>(frame));
+		TEST_CHECK(wait_for([&prepared] { return prepared == 3; }));
+
+		// Outputs ready, popping does not wait
+		for (uint32_t frame = 0; frame < 3; frame++) TEST_CHECK(pipeline.pop()->frame == frame);
+		TEST_CHECK(pipeline.get_stats().consumer_waits == 0);
+	});
+
+	test::run("Consumer waits", [] {
+		// The stage is held until the gate opens, so popping waits for it
+		std::atomic<bool> gate = false;
+		Pipeline pipeline(
+			[&gate](std::unique_ptr<uint32_t> input) {
+				gate.wait(false);
+				return prepare(std::move(input));
+			},
+			1
+		);
+
+		pipeline.push(std::make_unique<uint32_t>(7));
+		std::jthread opener([&gate] {
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			gate = true;
+			gate.notify_all();
+		});
+
+		const auto output = pipeline.pop();
+		TEST_CHECK(output.has_value() && output->frame == 7);
+		TEST_CHECK(pipeline.get_stats().consumer_waits == 1);
+	});
+
+	test::run("Shutdown", [] {
+		// Destroyed with frames in flight, finished or not, without popping them
+		std::atomic<uint32_t> prepared = 0;
+		{
+			Pipeline pipeline(
+				[&prepared](std::unique_ptr<uint32_t> input) {
+					std::this_thread::sleep_for(std::chrono::milliseconds(5));
+					prepared++;
+					return prepare(std::move(input));
+				},
+				3
+			);
+
+			for (uint32_t frame = 0; frame < 4; frame++) pipeline.push(std::make_unique<uint32_t>(frame));
+		}
+
+		// The worker stops after its current frame
+		TEST_CHECK(prepared >= 1 && prepared <= 4);
+	});
+
+	return test::finish();
+}
@@ -0,0 +1,179 @@
+// Order, capacity, closing and element lifetime of `util::SpscQueue`, on one and two threads
+
+#include "test/check.hpp"
+#include "util/spsc-queue.hpp"
+
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	std::mt19937 generator{89};
+
+	// Counts live instances, to find leaked or doubly destroyed elements
+	struct Counted
+	{
+		static inline int live = 0;
+
+		uint32_t value;
+
+		explicit Counted(uint32_t value) noexcept :
+			value(value)
+		{
+			live++;
+		}
+
+		Counted(Counted&& other) noexcept :
+			value(other.value)
+		{
+			live++;
+		}
+
+		Counted(const Counted&) = delete;
+		Counted& operator=(const Counted&) = delete;
+		Counted& operator=(Counted&&) = delete;
+
+		~Counted() noexcept { live--; }
+	};
+}
+
+int main()
+{
+	test::run("Capacity", [] {
+		util::SpscQueue<std::unique_ptr<int>> queue(3);
+		TEST_CHECK(queue.get_capacity() == 3);
+
+		for (int value = 0; value < 3; value++) TEST_CHECK(queue.try_push(std::make_unique<int>(value)));
+		TEST_CHECK(queue.size() == 3);
+
+		// A failed push leaves the value untouched
+		auto rejected = std::make_unique<int>(3);
+		TEST_CHECK(!queue.try_push(std::move(rejected)));
+		TEST_CHECK(rejected != nullptr && *rejected == 3);
+
+		for (int value = 0; value < 3; value++)
+		{
+			const auto popped = queue.try_pop();
+			if (!TEST_CHECK(popped.has_value() && *popped != nullptr)) return;
+			TEST_CHECK(**popped == value);
+		}
+
+		TEST_CHECK(!queue.try_pop().has_value() && queue.size() == 0);
+
+		// Clamped to one element
+		util::SpscQueue<int> single(0);
+		TEST_CHECK(single.get_capacity() == 1);
+		TEST_CHECK(single.try_push(1) && !single.try_push(2));
+	});
+
+	test::run("Wrap around", [] {
+		// Random pushes and pops against a reference, over many laps of the storage
+		util::SpscQueue<uint32_t> queue(5);
+		std::vector<uint32_t> reference;
+		size_t reference_head = 0;
+		uint32_t next = 0;
+
+		for (int step = 0; step < 10000; step++)
+		{
+			const size_t size = reference.size() - reference_head;
+			TEST_CHECK(queue.size() == size);
+
+			if (generator() % 2 == 0)
+			{
+				TEST_CHECK(queue.try_push(uint32_t(next)) == (size < 5));
+				if (size < 5) reference.push_back(next);
+				next++;
+			}
+			else
+			{
+				const auto popped = queue.try_pop();
+				if (!TEST_CHECK(popped.has_value() == (size > 0)) || !popped) continue;
+				TEST_CHECK(*popped == reference[reference_head++]);
+			}
+		}
+	});
+
+	test::run("Element lifetime", [] {
+		{
+			util::SpscQueue<Counted> queue(4);
+			for (uint32_t value = 0; value < 4; value++) queue.try_push(Counted(value));
+			TEST_CHECK(Counted::live == 4);
+
+			// Popped slots are emptied
+			queue.try_pop();
+			queue.try_pop();
+			TEST_CHECK(Counted::live == 2);
+		}
+
+		// Remaining elements are destroyed with the queue
+		TEST_CHECK(Counted::live == 0);
+	});
+
+	test::run("Close", [] {
+		util::SpscQueue<int> queue(4);
+		queue.push(1);
+		queue.push(2);
+		queue.close();
+
+		// Pushing fails, popping drains the remaining elements
+		TEST_CHECK(!queue.push(3));
+		TEST_CHECK(queue.pop() == 1);
+		TEST_CHECK(queue.pop() == 2);
+		TEST_CHECK(!queue.pop().has_value());
+
+		// Close wakes a consumer waiting on an empty queue
+		util::SpscQueue<int> empty(4);
+		std::optional<int> popped = 0;
+		{
+			std::jthread consumer([&] { popped = empty.pop(); });
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			empty.close();
+		}
+		TEST_CHECK(!popped.has_value());
+
+		// And a producer waiting on a full queue
+		util::SpscQueue<int> full(1);
+		full.push(1);
+		bool pushed = true;
+		{
+			std::jthread producer([&] { pushed = full.push(2); });
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			full.close();
+		}
+		TEST_CHECK(!pushed);
+	});
+
+	test::run("Two threads", [] {
+		for (const size_t capacity : {1zu, 3zu, 64zu})
+		{
+			constexpr uint32_t count = 200000;
+			util::SpscQueue<uint32_t> queue(capacity);
+
+			// Blocking and non-blocking calls mixed on both sides
+			std::jthread producer([&queue] {
+				for (uint32_t value = 0; value < count; value++)
+					if (value % 3 != 0 || !queue.try_push(uint32_t(value))) queue.push(uint32_t(value));
+				queue.close();
+			});
+
+			uint32_t expected = 0;
+			bool in_order = true;
+			while (true)
+			{
+				auto value = expected % 2 == 0 ? queue.try_pop() : std::nullopt;
+				if (!value) value = queue.pop();
+				if (!value) break;
+
+				in_order = in_order && *value == expected;
+				expected++;
+			}
+
+			TEST_CHECK(in_order);
+			TEST_CHECK(expected == count);
+		}
+	});
+
+	return test::finish();
+}
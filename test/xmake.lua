@@ -0,0 +1,94 @@
+-- Unit tests, run with `xmake test`
+-- Benchmarks, run with `xmake run bench.<name>` in release mode
+
+-- Check and timing helpers
+target("test.common")
+	set_kind("headeronly")
+	set_languages("c++23", {public=true})
+
+	add_includedirs("include", {public=true})
+	add_headerfiles("include/(**.hpp)")
+
+-- Declare a test executable built from one source, registered to `xmake test`
+local function test_target(name, source, deps, defines)
+	target("test." .. name)
+		set_kind("binary")
+		set_default(false)
+		set_group("test")
+
+		add_files(source)
+		add_deps("test.common", table.unpack(deps))
+		add_tests("default")
+
+		if defines then
+			add_defines(table.unpack(defines))
+		end
+	target_end()
+end
+
+-- Declare a benchmark executable built from one source
+local function bench_target(name, source, deps)
+	target("bench." .. name)
+		set_kind("binary")
+		set_default(false)
+		set_group("bench")
+
+		add_files(source)
+		add_deps("test.common", table.unpack(deps))
+	target_end()
+end
+
+-- Image
+test_target("image.downsample", "image/downsample.cpp", {"lib::image.algo"})
+test_target("image.mipmap", "image/mipmap.cpp", {"lib::image.algo"})
+test_target("image.compress", "image/compress.cpp", {"lib::image.compress", "lib::image.algo", "lib::gltf"})
+
+-- glTF
+test_target("gltf.animation-clip", "gltf/animation-clip.cpp", {"lib::gltf"})
+test_target("gltf.dedup", "gltf/dedup.cpp", {"lib::gltf"})
+test_target("gltf.drawcall", "gltf/drawcall.cpp", {"lib::gltf"})
+test_target("gltf.instance", "gltf/instance.cpp", {"lib::gltf"})
+test_target("gltf.joint-palette", "gltf/joint-palette.cpp", {"lib::gltf"})
+test_target("gltf.material", "gltf/material.cpp", {"lib::gltf"})
+
+-- GPU
+test_target("gpu.deletion-queue", "gpu/deletion-queue.cpp", {"lib::gpu"})
+
+-- Graphics
+test_target("graphics.bvh", "graphics/bvh.cpp", {"lib::graphics.geometry"})
+test_target(
+	"graphics.convex-hull",
+	"graphics/convex-hull.cpp",
+	{"lib::graphics.geometry", "lib::wavefront"},
+	{'ASSET_DIR="$(projectdir)/project/asset"'}
+)
+test_target("graphics.dynamic-resolution", "graphics/dynamic-resolution.cpp", {"lib::graphics.util"})
+test_target("graphics.light-cluster", "graphics/light-cluster.cpp", {"lib::graphics.geometry"})
+test_target("graphics.occlusion", "graphics/occlusion.cpp", {"lib::graphics.geometry"})
+test_target("graphics.portal", "graphics/portal.cpp", {"lib::graphics.geometry"})
+test_target("graphics.render-graph", "graphics/render-graph.cpp", {"lib::graphics.util"})
+test_target("graphics.shadow-schedule", "graphics/shadow-schedule.cpp", {"lib::graphics.geometry"})
+test_target("graphics.skin-bound", "graphics/skin-bound.cpp", {"lib::graphics.geometry"})
+test_target("graphics.texture-pool", "graphics/texture-pool.cpp", {"lib::graphics.util"})
+
+-- Render
+test_target("render.indirect", "render/indirect.cpp", {"render"})
+test_target("render.object-data", "render/object-data.cpp", {"render"})
+test_target("render.prepare", "render/prepare.cpp", {"render"})
+
+-- Util
+test_target("util.frame-arena", "util/frame-arena.cpp", {"lib::util"})
+test_target("util.frame-pipeline", "util/frame-pipeline.cpp", {"lib::util"})
+test_target("util.spsc-queue", "util/spsc-queue.cpp", {"lib::util"})
+
+-- Benchmarks
+bench_target("image.downsample", "bench/downsample.cpp", {"lib::image.algo"})
+bench_target("gltf.animation-clip", "bench/animation-clip.cpp", {"lib::gltf"})
+bench_target("gltf.instance", "bench/instance.cpp", {"lib::gltf"})
+bench_target("gltf.joint-palette", "bench/joint-palette.cpp", {"lib::gltf"})
+bench_target("graphics.bvh", "bench/bvh.cpp", {"lib::graphics.geometry"})
+bench_target("graphics.light-cluster", "bench/light-cluster.cpp", {"lib::graphics.geometry"})
+bench_target("graphics.occlusion", "bench/occlusion.cpp", {"lib::graphics.geometry"})
+bench_target("graphics.portal", "bench/portal.cpp", {"lib::graphics.geometry"})
+bench_target("render.prepare", "bench/prepare.cpp", {"render"})
+bench_target("util.frame-arena", "bench/frame-arena.cpp", {"lib::util"})